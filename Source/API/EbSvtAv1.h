@@ -81,6 +81,14 @@ typedef struct EbBufferHeaderType
 
     // pic flags
     uint32_t flags;
+
+    // pic quality, filled in when stat_report is set
+    uint64_t luma_sse;
+    uint64_t cr_sse;
+    uint64_t cb_sse;
+    double   luma_ssim;
+    double   cr_ssim;
+    double   cb_ssim;
 } EbBufferHeaderType;
 
 typedef struct EbComponentType
@@ -29,8 +29,28 @@ extern "C" {
 #define EB_BUFFERFLAG_TG            0x00000004  // signals that the packet contains Tile Group header
 #endif
 
+/* Piece of an output packet. The packet payload is spread over a chain of
+ * segments taken from a pool in the library, so the memory held by a packet
+ * follows the size of the coded frame. */
+typedef struct EbOutputSegment
+{
+    uint8_t                 *data;
+    uint32_t                 filled_len;
+    struct EbOutputSegment  *next;
+} EbOutputSegment;
+
 // Will contain the EbEncApi which will live in the EncHandle class
 // Only modifiable during config-time.
+/* Fixed size buffer owned by its producer, used to exchange rate control
+ * statistics between the application and the library. */
+typedef struct EbSvtAv1FixedBuf
+{
+    void                    *buf;
+    uint64_t                 sz;
+} EbSvtAv1FixedBuf;
+
+#define EB_STREAM_INFO_FIRST_PASS_STATS_OUT 1
+
 typedef struct EbSvtAv1EncConfiguration
 {
     // Encoding preset
@@ -141,6 +161,14 @@ typedef struct EbSvtAv1EncConfiguration
      *
      * Default is 0. */
     uint32_t                 compressed_ten_bit_format;
+    /* Native 16 bit pipeline: for encoder_bit_depth > 8 with the unpacked 16
+     * bit input, keeps the input in 16 bit instead of splitting it into its 8
+     * bit and 2 bit parts, and runs the mode decision on the 16 bit planes.
+     * Picture analysis and motion estimation work on an 8 bit copy of the
+     * most significant bits. Not supported with film grain.
+     *
+     * Default is 0. */
+    uint32_t                 native_16bit_pipeline;
     /* Number of frames of sequence to be encoded. If number of frames is greater
      * than the number of frames in file, the encoder will loop to the beginning
      * and continue the encode.
@@ -206,6 +234,15 @@ typedef struct EbSvtAv1EncConfiguration
     * Default is 0. */
     uint32_t                 film_grain_denoise_strength;
 
+    /* Film grain update period
+    * Number of pictures between two film grain estimations; the pictures in
+    * between are still denoised but reuse the last estimated grain parameters.
+    * A scene change re-estimates the grain without waiting for the period.
+    * 0 or 1 re-estimates the grain on every picture.
+    *
+    * Default is 0. */
+    uint32_t                 film_grain_update_period;
+
     /* Warped motion
     *
     * Default is 0. */
@@ -283,6 +320,21 @@ typedef struct EbSvtAv1EncConfiguration
      *
      * Default is 0. */
     uint32_t                 min_qp_allowed;
+    /* Flag to run the fast analysis (first) pass: the encoder runs at the
+     * fastest preset in constant QP and records the per-picture distortion
+     * histograms used by the rate control. The stats are retrieved with
+     * eb_svt_enc_get_stream_info() once the last packet has been received.
+     *
+     * Default is 0. */
+    uint32_t                 rc_firstpass_stats_out;
+    /* Stats produced by a previous analysis pass of the same sequence, only
+     * applicable when rate control mode is set to 2. The rate control reads
+     * the picture complexity from the stats instead of the look ahead, so a
+     * short look_ahead_distance can be used. The buffer is copied by
+     * eb_init_encoder().
+     *
+     * Default is NULL (no stats). */
+    EbSvtAv1FixedBuf         rc_twopass_stats_in;
 
     // Tresholds
     /* Flag to signal that the input yuv is HDR10 BT2020 using SMPTE ST2048, requires
@@ -338,6 +390,14 @@ typedef struct EbSvtAv1EncConfiguration
     * Default is 60. */
     int32_t                  injector_frame_rate;
 
+    /* Flag to enable the Deadline mode: the preset is kept, and the per-stage
+    * encoding time is measured to reduce (or restore) the ME search area, the
+    * NSQ shapes, the NFL count and the MD budget of upcoming pictures so that
+    * every picture is output within the frame period defined by -fps.
+    *
+    * Default is 0. */
+    uint32_t                 deadline_mode;
+
     // Threads management
 
     /* The number of logical processor which encoder threads run on. If
@@ -357,8 +417,13 @@ typedef struct EbSvtAv1EncConfiguration
 
     // Debug tools
 
-    /* Output reconstructed yuv used for debug purposes. The value is set through
-     * ReconFile token (-o) and using the feature will affect the speed of encoder.
+    /* Output reconstructed yuv. The value is set through ReconFile token (-o).
+     *
+     * 0 = OFF.
+     * 1 = Copy each picture into the buffer passed to eb_svt_get_recon(), which
+     *     affects the speed of the encoder.
+     * 2 = Zero-copy, eb_svt_get_recon_view() hands out read-only views of the
+     *     encoder's own recon buffers.
      *
      * Default is 0. */
     uint32_t                 recon_enabled;
@@ -370,11 +435,18 @@ typedef struct EbSvtAv1EncConfiguration
     int32_t                  tile_rows;
 #endif
 
+    /* Per-picture quality report. The sum of squared errors of each plane, and
+    * with 2 the SSIM as well, is computed against the source after the loop
+    * filters and returned in the output buffer of the picture.
+    *
+    * 0 = off, 1 = SSE, 2 = SSE and SSIM.
+    *
+    * Default is 0. */
+    uint32_t                 stat_report;
+
 /* To be deprecated.
  * Encoder configuration parameters below this line are to be deprecated. */
 
-    uint32_t                 stat_report;
-
     /* Flag to enable Hierarchical Motion Estimation 1/16th of the picture
     *
     * Default is 1. */
@@ -466,7 +538,9 @@ typedef struct EbSvtAv1EncConfiguration
         EbComponentType      *svt_enc_component,
         EbBufferHeaderType   *p_buffer);
 
-    /* STEP 5: Receive packet.
+    /* STEP 5: Receive packet. The returned header's p_buffer points to the
+     * first EbOutputSegment of the packet and n_filled_len is the size of the
+     * whole chain. The segments stay valid until the packet is released.
      * Parameter:
     * @ *svt_enc_component  Encoder handler.
      * @ **p_buffer          Header pointer to return packet with.
@@ -477,7 +551,7 @@ typedef struct EbSvtAv1EncConfiguration
         EbBufferHeaderType  **p_buffer,
         uint8_t                pic_send_done);
 
-    /* STEP 5-1: Release output buffer back into the pool.
+    /* STEP 5-1: Release output buffer and its segments back into the pool.
      *
      * Parameter:
      * @ **p_buffer          Header pointer that contains the output packet to be released. */
@@ -493,6 +567,43 @@ typedef struct EbSvtAv1EncConfiguration
         EbComponentType      *svt_enc_component,
         EbBufferHeaderType   *p_buffer);
 
+    /* OPTIONAL: Get a read-only view of the next reconstructed picture, when
+     * recon_enabled is 2. The returned header's p_buffer points to an
+     * EbSvtIOFormat describing the planes in place: luma, cb and cr start at
+     * the first visible sample, strides are in samples and samples are 16 bit
+     * for bit depths above 8. n_filled_len is the size of the picture once
+     * packed. The picture stays valid until the view is released; a held view
+     * holds back the encoder's reference or picture pool, so release it as
+     * soon as possible.
+     *
+     * Parameter:
+     * @ *svt_enc_component  Encoder handler.
+     * @ **p_buffer          Header pointer to return the view with.
+     * Non-locking call, returns EB_NoErrorEmptyQueue when no picture is ready. */
+    EB_API EbErrorType eb_svt_get_recon_view(
+        EbComponentType      *svt_enc_component,
+        EbBufferHeaderType  **p_buffer);
+
+    /* OPTIONAL: Release a view returned by eb_svt_get_recon_view().
+     *
+     * Parameter:
+     * @ **p_buffer          Header pointer that contains the view to be released,
+     *                       set to NULL on return. */
+    EB_API void eb_svt_release_recon_view(
+        EbBufferHeaderType  **p_buffer);
+
+    /* OPTIONAL: Get stream level information once the encode is done.
+     *
+     * Parameter:
+     * @ *svt_enc_component  Encoder handler.
+     * @ stream_info_id      EB_STREAM_INFO_* identifier of the requested information.
+     * @ *info               Output, an EbSvtAv1FixedBuf for EB_STREAM_INFO_FIRST_PASS_STATS_OUT
+     *                       pointing to a buffer owned by the library until eb_deinit_encoder(). */
+    EB_API EbErrorType eb_svt_enc_get_stream_info(
+        EbComponentType      *svt_enc_component,
+        uint32_t              stream_info_id,
+        void                 *info);
+
     /* STEP 6: Deinitialize encoder library.
      *
      * Parameter:
@@ -95,6 +95,7 @@ extern "C" {
         EB_ENC_EC_ERROR27 = 0x0720,
         EB_ENC_EC_ERROR28 = 0x0721,
         EB_ENC_EC_ERROR29 = 0x0722,
+        EB_ENC_EC_ERROR30 = 0x0723,
 
         //EB_ENC_INTER_PRED_ERRORS          = 0x0800,
         EB_ENC_INTER_PRED_ERROR0 = 0x0800,
@@ -0,0 +1,427 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "EbAppChunk.h"
+
+/***************************************
+ * Macros
+ ***************************************/
+#define CHUNK_SUBSAMPLE                 4       // Luma grid of the scene cut score
+#define IVF_STREAM_HEADER_SIZE          32
+#define IVF_FRAME_HEADER_SIZE_BYTES     12
+#define STITCH_TOKEN                    "-stitch"
+#define STITCH_SEQUENCE_HEADER_SIZE     256     // Largest sequence header OBU that is deduplicated
+#define OBU_TYPE_SEQUENCE_HEADER        1
+
+static uint64_t chunk_frame_size(const EbConfig *config)
+{
+    uint64_t frame_size = (uint64_t)config->input_padded_width * config->input_padded_height;
+    frame_size += 2 * (frame_size >> (3 - config->encoder_color_format));
+    return frame_size << ((config->encoder_bit_depth == 10) ? 1 : 0);
+}
+
+// Reads the subsampled luma of one frame, 16-bit samples are scaled to 8 bits
+static EbBool chunk_read_luma(
+    const EbConfig *config,
+    FILE           *file,
+    int64_t         frame,
+    uint8_t        *row_buffer,
+    uint8_t        *samples)
+{
+    const uint32_t bytes_per_sample = (config->encoder_bit_depth == 10) ? 2 : 1;
+    const uint32_t row_size = config->input_padded_width * bytes_per_sample;
+    uint32_t count = 0;
+    uint32_t y, x;
+
+    for (y = 0; y < config->input_padded_height; y += CHUNK_SUBSAMPLE) {
+        if (fseeko64(file, frame * (int64_t)chunk_frame_size(config) + (int64_t)y * row_size, SEEK_SET) != 0 ||
+            fread(row_buffer, 1, row_size, file) != row_size)
+            return EB_FALSE;
+        for (x = 0; x < config->input_padded_width; x += CHUNK_SUBSAMPLE) {
+            samples[count++] = (bytes_per_sample == 2) ?
+                (uint8_t)((row_buffer[2 * x] | (row_buffer[2 * x + 1] << 8)) >> 2) :
+                row_buffer[x];
+        }
+    }
+    return EB_TRUE;
+}
+
+// Places the start of a segment on the frame that differs the most from its
+// predecessor, within a quarter segment of the even split. The windows of two
+// boundaries never overlap, so each boundary is found on its own.
+static EbErrorType chunk_boundary(
+    const EbConfig *config,
+    FILE           *file,
+    int64_t         total_frames,
+    uint32_t        index,
+    int64_t        *boundary)
+{
+    const uint32_t chunk_count = config->chunk_count;
+    const int64_t ideal = total_frames * index / chunk_count;
+    const int64_t radius = total_frames / chunk_count / 4;
+    const uint32_t sample_count = ((config->input_padded_width + CHUNK_SUBSAMPLE - 1) / CHUNK_SUBSAMPLE) *
+        ((config->input_padded_height + CHUNK_SUBSAMPLE - 1) / CHUNK_SUBSAMPLE);
+    uint8_t *row_buffer;
+    uint8_t *prev_samples;
+    uint8_t *curr_samples;
+    uint64_t best_score = 0;
+    int64_t frame;
+    EbErrorType return_error = EB_ErrorNone;
+
+    *boundary = ideal;
+    if (index == 0 || index == chunk_count || radius == 0)
+        return EB_ErrorNone;
+
+    row_buffer = (uint8_t*)malloc(config->input_padded_width * 2);
+    prev_samples = (uint8_t*)malloc(sample_count);
+    curr_samples = (uint8_t*)malloc(sample_count);
+
+    if (!row_buffer || !prev_samples || !curr_samples)
+        return_error = EB_ErrorInsufficientResources;
+    else if (!chunk_read_luma(config, file, ideal - radius - 1, row_buffer, prev_samples))
+        return_error = EB_ErrorBadParameter;
+
+    for (frame = ideal - radius; return_error == EB_ErrorNone && frame <= ideal + radius; ++frame) {
+        uint64_t score = 0;
+        uint8_t *swap;
+        uint32_t i;
+
+        if (!chunk_read_luma(config, file, frame, row_buffer, curr_samples)) {
+            return_error = EB_ErrorBadParameter;
+            break;
+        }
+        for (i = 0; i < sample_count; ++i)
+            score += (uint64_t)abs((int32_t)curr_samples[i] - (int32_t)prev_samples[i]);
+        if (score > best_score) {
+            best_score = score;
+            *boundary = frame;
+        }
+        swap = prev_samples;
+        prev_samples = curr_samples;
+        curr_samples = swap;
+    }
+
+    free(row_buffer);
+    free(prev_samples);
+    free(curr_samples);
+    return return_error;
+}
+
+EbErrorType chunk_setup(
+    EbConfig       **configs,
+    EbAppContext   **app_callbacks,
+    uint32_t        *num_channels,
+    EbErrorType     *return_errors)
+{
+    EbConfig *config = configs[0];
+    const uint32_t chunk_count = config->chunk_count;
+    const uint32_t first = (config->chunk_id == -1) ? 0 : (uint32_t)config->chunk_id;
+    const uint32_t last = (config->chunk_id == -1) ? chunk_count - 1 : (uint32_t)config->chunk_id;
+    const int64_t total_frames = config->frames_to_be_encoded;
+    int64_t boundaries[MAX_CHANNEL_NUMBER + 1];
+    uint32_t chunk_index;
+    uint32_t channel_count = 1;
+    EbErrorType return_error = EB_ErrorNone;
+
+    if (*num_channels != 1) {
+        fprintf(config->error_log_file, "Error: Chunked encoding needs a single channel\n");
+        return EB_ErrorBadParameter;
+    }
+    if (total_frames > ComputeFramesToBeEncoded(config) || total_frames < (int64_t)chunk_count) {
+        fprintf(config->error_log_file, "Error: Chunked encoding needs the %d frames to encode, and at least ChunkCount, in the input file\n", (int32_t)total_frames);
+        return EB_ErrorBadParameter;
+    }
+
+    for (chunk_index = first; chunk_index <= last + 1 && return_error == EB_ErrorNone; ++chunk_index)
+        return_error = chunk_boundary(config, config->input_file, total_frames, chunk_index, &boundaries[chunk_index - first]);
+    if (return_error != EB_ErrorNone) {
+        fprintf(config->error_log_file, "Error: Could not read the input file to place the chunks\n");
+        return return_error;
+    }
+
+    // The in-process channels write temporary segments, stitched into the -b file
+    if (config->chunk_id == -1) {
+        config->stitch_file = config->bitstream_file;
+        config->bitstream_file = (FILE*)NULL;
+        for (chunk_index = 1; chunk_index < chunk_count; ++chunk_index) {
+            EbConfig *clone = (EbConfig*)malloc(sizeof(EbConfig));
+            EbAppContext *app_callback = (EbAppContext*)malloc(sizeof(EbAppContext));
+            if (!clone || !app_callback) {
+                free(clone);
+                free(app_callback);
+                return_error = EB_ErrorInsufficientResources;
+                break;
+            }
+            memcpy(clone, config, sizeof(EbConfig));
+            clone->config_file = (FILE*)NULL;
+            clone->stitch_file = (FILE*)NULL;
+            FOPEN(clone->input_file, config->input_file_name, "rb");
+            configs[chunk_index] = clone;
+            app_callbacks[chunk_index] = app_callback;
+            return_errors[chunk_index] = EB_ErrorNone;
+            channel_count = chunk_index + 1;
+            if (!clone->input_file) {
+                return_error = EB_ErrorBadParameter;
+                break;
+            }
+        }
+    }
+
+    for (chunk_index = 0; chunk_index < channel_count && return_error == EB_ErrorNone; ++chunk_index) {
+        EbConfig *channel_config = configs[chunk_index];
+        const int64_t start = boundaries[chunk_index];
+        const int64_t end = boundaries[chunk_index + 1];
+
+        if (config->chunk_id == -1 && (channel_config->bitstream_file = tmpfile()) == NULL)
+            return_error = EB_ErrorInsufficientResources;
+        else if (fseeko64(channel_config->input_file, start * (int64_t)chunk_frame_size(config), SEEK_SET) != 0)
+            return_error = EB_ErrorBadParameter;
+        channel_config->frames_to_be_encoded = end - start;
+        printf("Chunk %u: frames %d to %d\n", first + chunk_index, (int32_t)start, (int32_t)(end - 1));
+    }
+
+    *num_channels = channel_count;
+    if (return_error != EB_ErrorNone) {
+        fprintf(config->error_log_file, "Error: Could not set up the chunk channels\n");
+        chunk_finish(configs, channel_count, EB_FALSE);
+    }
+    return return_error;
+}
+
+typedef struct StitchContext {
+    unsigned char   stream_header[IVF_STREAM_HEADER_SIZE];
+    unsigned char   sequence_header[STITCH_SEQUENCE_HEADER_SIZE];  // Whole OBU, from the first segment
+    size_t          sequence_header_size;
+    uint64_t        frame_count;
+} StitchContext;
+
+// Locates the sequence header OBU of a temporal unit, returns 0 when there is none
+static size_t find_sequence_header(
+    const unsigned char *data,
+    size_t               size,
+    size_t              *offset)
+{
+    size_t position = 0;
+
+    while (position < size) {
+        const unsigned char obu_header = data[position];
+        size_t header_size = 1 + ((obu_header & 0x4) ? 1 : 0);
+        uint64_t obu_size = 0;
+
+        if (position + header_size > size)
+            return 0;
+        if (obu_header & 0x2) {
+            // leb128 payload size
+            uint32_t shift = 0;
+            for (;;) {
+                if (position + header_size >= size || shift > 56)
+                    return 0;
+                obu_size |= (uint64_t)(data[position + header_size] & 0x7f) << shift;
+                shift += 7;
+                if (!(data[position + header_size++] & 0x80))
+                    break;
+            }
+        }
+        else
+            obu_size = size - position - header_size;
+        if (position + header_size + obu_size > size)
+            return 0;
+        if (((obu_header >> 3) & 0xf) == OBU_TYPE_SEQUENCE_HEADER) {
+            *offset = position;
+            return header_size + (size_t)obu_size;
+        }
+        position += header_size + (size_t)obu_size;
+    }
+    return 0;
+}
+
+// Keeps the sequence header of the first segment, and drops the identical
+// copies that start the other segments. A differing header is kept as it
+// starts a new coded video sequence.
+static void stitch_sequence_header(
+    StitchContext  *context,
+    EbBool          first_segment,
+    unsigned char  *payload,
+    size_t         *frame_size)
+{
+    size_t offset = 0;
+    const size_t obu_size = find_sequence_header(payload, *frame_size, &offset);
+
+    if (obu_size == 0)
+        return;
+    if (first_segment) {
+        context->sequence_header_size = obu_size <= STITCH_SEQUENCE_HEADER_SIZE ? obu_size : 0;
+        memcpy(context->sequence_header, payload + offset, context->sequence_header_size);
+    }
+    else if (obu_size == context->sequence_header_size && memcmp(payload + offset, context->sequence_header, obu_size) == 0) {
+        memmove(payload + offset, payload + offset + obu_size, *frame_size - offset - obu_size);
+        *frame_size -= obu_size;
+    }
+}
+
+// Appends the frames of one IVF file, with the frame numbers continued
+static EbErrorType stitch_segment(
+    FILE           *out,
+    FILE           *segment,
+    EbBool          first_segment,
+    StitchContext  *context)
+{
+    unsigned char header[IVF_STREAM_HEADER_SIZE];
+    unsigned char *payload = NULL;
+    size_t payload_capacity = 0;
+    EbBool first_frame = EB_TRUE;
+    EbErrorType return_error = EB_ErrorNone;
+
+    if (fread(header, 1, IVF_STREAM_HEADER_SIZE, segment) != IVF_STREAM_HEADER_SIZE || memcmp(header, "DKIF", 4) != 0)
+        return EB_ErrorBadParameter;
+    if (first_segment) {
+        memcpy(context->stream_header, header, IVF_STREAM_HEADER_SIZE);
+        if (fwrite(header, 1, IVF_STREAM_HEADER_SIZE, out) != IVF_STREAM_HEADER_SIZE)
+            return EB_ErrorBadParameter;
+    }
+    // The fourcc and the frame size must match the first segment
+    else if (memcmp(header + 8, context->stream_header + 8, 8) != 0)
+        return EB_ErrorBadParameter;
+
+    for (;;) {
+        unsigned char frame_header[IVF_FRAME_HEADER_SIZE_BYTES];
+        size_t frame_size;
+        size_t read_size = fread(frame_header, 1, IVF_FRAME_HEADER_SIZE_BYTES, segment);
+
+        if (read_size == 0)
+            break;
+        if (read_size != IVF_FRAME_HEADER_SIZE_BYTES) {
+            return_error = EB_ErrorBadParameter;
+            break;
+        }
+        frame_size = (size_t)frame_header[0] | ((size_t)frame_header[1] << 8) | ((size_t)frame_header[2] << 16) | ((size_t)frame_header[3] << 24);
+        if (frame_size > payload_capacity) {
+            unsigned char *grown = (unsigned char*)realloc(payload, frame_size);
+            if (!grown) {
+                return_error = EB_ErrorInsufficientResources;
+                break;
+            }
+            payload = grown;
+            payload_capacity = frame_size;
+        }
+        if (fread(payload, 1, frame_size, segment) != frame_size) {
+            return_error = EB_ErrorBadParameter;
+            break;
+        }
+        if (first_frame) {
+            stitch_sequence_header(context, first_segment, payload, &frame_size);
+            for (read_size = 0; read_size < 4; ++read_size)
+                frame_header[read_size] = (unsigned char)(frame_size >> (8 * read_size));
+            first_frame = EB_FALSE;
+        }
+        for (read_size = 0; read_size < 8; ++read_size)
+            frame_header[4 + read_size] = (unsigned char)(context->frame_count >> (8 * read_size));
+        if (fwrite(frame_header, 1, IVF_FRAME_HEADER_SIZE_BYTES, out) != IVF_FRAME_HEADER_SIZE_BYTES ||
+            fwrite(payload, 1, frame_size, out) != frame_size) {
+            return_error = EB_ErrorBadParameter;
+            break;
+        }
+        ++context->frame_count;
+    }
+
+    free(payload);
+    return return_error;
+}
+
+static EbErrorType stitch_segments(
+    FILE           *out,
+    FILE          **segments,
+    uint32_t        segment_count)
+{
+    StitchContext context;
+    uint32_t index;
+    EbErrorType return_error = EB_ErrorNone;
+
+    context.sequence_header_size = 0;
+    context.frame_count = 0;
+    for (index = 0; index < segment_count && return_error == EB_ErrorNone; ++index)
+        return_error = stitch_segment(out, segments[index], (EbBool)(index == 0), &context);
+    fflush(out);
+    return return_error;
+}
+
+EbErrorType chunk_finish(
+    EbConfig       **configs,
+    uint32_t         num_channels,
+    EbBool           encode_done)
+{
+    FILE *segments[MAX_CHANNEL_NUMBER];
+    uint32_t index;
+    EbErrorType return_error = EB_ErrorNone;
+
+    if (configs[0]->stitch_file && encode_done) {
+        for (index = 0; index < num_channels; ++index) {
+            segments[index] = configs[index]->bitstream_file;
+            fflush(segments[index]);
+            rewind(segments[index]);
+        }
+        return_error = stitch_segments(configs[0]->stitch_file, segments, num_channels);
+    }
+
+    // The error log is shared with the first channel, which closes it
+    for (index = 1; index < num_channels; ++index)
+        configs[index]->error_log_file = (FILE*)NULL;
+
+    return return_error;
+}
+
+uint32_t get_stitch(
+    int32_t          argc,
+    char *const      argv[],
+    EbErrorType     *return_error)
+{
+    FILE *out = (FILE*)NULL;
+    FILE **segments;
+    int32_t index;
+
+    if (argc < 2 || EB_STRCMP(argv[1], STITCH_TOKEN) != 0)
+        return 0;
+
+    *return_error = EB_ErrorBadParameter;
+    if (argc < 4) {
+        fprintf(stderr, "Error: %s needs the output and at least one segment file\n", STITCH_TOKEN);
+        return 1;
+    }
+
+    segments = (FILE**)calloc((size_t)(argc - 3), sizeof(FILE*));
+    if (!segments) {
+        *return_error = EB_ErrorInsufficientResources;
+        return 1;
+    }
+    for (index = 3; index < argc; ++index) {
+        FOPEN(segments[index - 3], argv[index], "rb");
+        if (!segments[index - 3]) {
+            fprintf(stderr, "Error: Could not open the segment %s\n", argv[index]);
+            break;
+        }
+    }
+    if (index == argc) {
+        FOPEN(out, argv[2], "wb");
+        if (!out)
+            fprintf(stderr, "Error: Could not open the output %s\n", argv[2]);
+        else if ((*return_error = stitch_segments(out, segments, (uint32_t)(argc - 3))) != EB_ErrorNone)
+            fprintf(stderr, "Error: The segments are not IVF streams of the same format\n");
+        else
+            printf("Stitched %d segments into %s\n", argc - 3, argv[2]);
+    }
+
+    if (out)
+        fclose(out);
+    for (index = 0; index < argc - 3; ++index) {
+        if (segments[index])
+            fclose(segments[index]);
+    }
+    free(segments);
+    return 1;
+}
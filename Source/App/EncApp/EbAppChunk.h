@@ -0,0 +1,42 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#ifndef EbAppChunk_h
+#define EbAppChunk_h
+
+#include "EbAppConfig.h"
+#include "EbAppContext.h"
+
+/***************************************
+ * Chunked Encoding
+ *   The input is cut into ChunkCount segments, each starting at the frame with
+ *   the largest luma change around its ideal position. Every segment is a closed
+ *   sequence (key frame first), so segments encoded by separate channels,
+ *   processes or hosts are concatenated into one valid IVF stream.
+ ***************************************/
+
+// Seeks the input to the segment of ChunkId, or clones the channel into one
+// channel per segment and redirects their bitstreams to temporary files
+extern EbErrorType chunk_setup(
+    EbConfig       **configs,
+    EbAppContext   **app_callbacks,
+    uint32_t        *num_channels,
+    EbErrorType     *return_errors);
+
+// Stitches the segments of an in-process chunked encode into the -b file,
+// and detaches the clones from the files of the first channel
+extern EbErrorType chunk_finish(
+    EbConfig       **configs,
+    uint32_t         num_channels,
+    EbBool           encode_done);
+
+// SvtAv1EncApp -stitch out.ivf seg0.ivf seg1.ivf ...
+// Returns 1 when the command line is a stitch request
+extern uint32_t get_stitch(
+    int32_t          argc,
+    char *const      argv[],
+    EbErrorType     *return_error);
+
+#endif // EbAppChunk_h
@@ -27,6 +27,8 @@
 #define OUTPUT_RECON_TOKEN              "-o"
 #define ERROR_FILE_TOKEN                "-errlog"
 #define QP_FILE_TOKEN                   "-qp-file"
+#define OUTPUT_STAT_FILE_TOKEN          "-output-stat-file"
+#define INPUT_STAT_FILE_TOKEN           "-input-stat-file"
 #define WIDTH_TOKEN                     "-w"
 #define HEIGHT_TOKEN                    "-h"
 #define NUMBER_OF_PICTURES_TOKEN        "-n"
@@ -40,6 +42,7 @@
 #define ENCODER_BIT_DEPTH               "-bit-depth"
 #define ENCODER_COLOR_FORMAT            "-color-format"
 #define INPUT_COMPRESSED_TEN_BIT_FORMAT "-compressed-ten-bit-format"
+#define NATIVE_16BIT_PIPELINE_TOKEN     "-native-16bit"
 #define ENCMODE_TOKEN                   "-enc-mode"
 #define HIERARCHICAL_LEVELS_TOKEN       "-hierarchical-levels" // no Eval
 #define PRED_STRUCT_TOKEN               "-pred-struct"
@@ -49,6 +52,7 @@
 #define LEVEL_TOKEN                     "-level"
 #define LATENCY_MODE                    "-latency-mode" // no Eval
 #define FILM_GRAIN_TOKEN                "-film-grain"
+#define FILM_GRAIN_PERIOD_TOKEN         "-film-grain-period"
 #define INTERLACED_VIDEO_TOKEN          "-interlaced-video"
 #define SEPERATE_FILDS_TOKEN            "-separate-fields"
 #define INTRA_REFRESH_TYPE_TOKEN        "-irefresh-type" // no Eval
@@ -90,9 +94,13 @@
 #define INJECTOR_TOKEN                  "-inj"  // no Eval
 #define INJECTOR_FRAMERATE_TOKEN        "-inj-frm-rt" // no Eval
 #define SPEED_CONTROL_TOKEN             "-speed-ctrl"
+#define DEADLINE_MODE_TOKEN             "-deadline"
 #define ASM_TYPE_TOKEN                  "-asm"
+#define STAT_REPORT_TOKEN               "-stat-report"
 #define THREAD_MGMNT                    "-lp"
 #define TARGET_SOCKET                   "-ss"
+#define CHUNK_COUNT_TOKEN               "-chunks"
+#define CHUNK_ID_TOKEN                  "-chunk-id"
 #define CONFIG_FILE_COMMENT_CHAR    '#'
 #define CONFIG_FILE_NEWLINE_CHAR    '\n'
 #define CONFIG_FILE_RETURN_CHAR     '\r'
@@ -122,6 +130,7 @@ static void SetCfgInputFile                     (const char *value, EbConfig *cf
     }
     else {
         FOPEN(cfg->input_file, value, "rb");
+        EB_STRCPY(cfg->input_file_name, sizeof(cfg->input_file_name), value);
     }
 
     /* if input is a YUV4MPEG2 (y4m) file, read header and parse parameters */
@@ -156,6 +165,36 @@ static void SetCfgQpFile                        (const char *value, EbConfig *cf
     if (cfg->qp_file) { fclose(cfg->qp_file); }
     FOPEN(cfg->qp_file,value, "r");
 };
+static void SetCfgOutputStatFile                (const char *value, EbConfig *cfg)
+{
+    if (cfg->output_stat_file) { fclose(cfg->output_stat_file); }
+    FOPEN(cfg->output_stat_file, value, "wb");
+    cfg->rc_firstpass_stats_out = cfg->output_stat_file ? 1 : 0;
+};
+static void SetCfgInputStatFile                 (const char *value, EbConfig *cfg)
+{
+    FILE    *stat_file = NULL;
+    long     stat_file_size;
+
+    if (cfg->rc_twopass_stats_in.buf) { free(cfg->rc_twopass_stats_in.buf); }
+    cfg->rc_twopass_stats_in.buf = NULL;
+    cfg->rc_twopass_stats_in.sz = 0;
+
+    // The whole stats file is handed to the library
+    FOPEN(stat_file, value, "rb");
+    if (stat_file == NULL)
+        return;
+    fseek(stat_file, 0, SEEK_END);
+    stat_file_size = ftell(stat_file);
+    fseek(stat_file, 0, SEEK_SET);
+    if (stat_file_size > 0) {
+        cfg->rc_twopass_stats_in.buf = malloc((size_t)stat_file_size);
+        if (cfg->rc_twopass_stats_in.buf) {
+            cfg->rc_twopass_stats_in.sz = fread(cfg->rc_twopass_stats_in.buf, 1, (size_t)stat_file_size, stat_file);
+        }
+    }
+    fclose(stat_file);
+};
 static void SetCfgSourceWidth                   (const char *value, EbConfig *cfg) {cfg->source_width = strtoul(value, NULL, 0);};
 static void SetInterlacedVideo                  (const char *value, EbConfig *cfg) {cfg->interlaced_video  = (EbBool) strtoul(value, NULL, 0);};
 static void SetSeperateFields                   (const char *value, EbConfig *cfg) {cfg->separate_fields = (EbBool) strtoul(value, NULL, 0);};
@@ -176,6 +215,7 @@ static void SetFrameRateDenominator             (const char *value, EbConfig *cf
 static void SetEncoderBitDepth                  (const char *value, EbConfig *cfg) {cfg->encoder_bit_depth = strtoul(value, NULL, 0);}
 static void SetEncoderColorFormat               (const char *value, EbConfig *cfg) {cfg->encoder_color_format = strtoul(value, NULL, 0);}
 static void SetcompressedTenBitFormat            (const char *value, EbConfig *cfg) {cfg->compressed_ten_bit_format = strtoul(value, NULL, 0);}
+static void SetNative16bitPipeline              (const char *value, EbConfig *cfg) {cfg->native_16bit_pipeline = strtoul(value, NULL, 0);}
 static void SetBaseLayerSwitchMode              (const char *value, EbConfig *cfg) {cfg->base_layer_switch_mode = (EbBool) strtoul(value, NULL, 0);};
 static void SetencMode                          (const char *value, EbConfig *cfg) {cfg->enc_mode = (uint8_t)strtoul(value, NULL, 0);};
 static void SetCfgIntraPeriod                   (const char *value, EbConfig *cfg) {cfg->intra_period = strtol(value,  NULL, 0);};
@@ -184,7 +224,8 @@ static void SetHierarchicalLevels                (const char *value, EbConfig *c
 static void SetCfgPredStructure                    (const char *value, EbConfig *cfg) { cfg->pred_structure = strtol(value, NULL, 0); };
 static void SetCfgQp                            (const char *value, EbConfig *cfg) {cfg->qp = strtoul(value, NULL, 0);};
 static void SetCfgUseQpFile                     (const char *value, EbConfig *cfg) {cfg->use_qp_file = (EbBool)strtol(value, NULL, 0); };
-//static void SetCfgFilmGrain(const char *value, EbConfig *cfg) { cfg->film_grain_denoise_strength = strtol(value, NULL, 0); };  //not bool to enable possible algorithm extension in the future
+static void SetCfgFilmGrain                     (const char *value, EbConfig *cfg) { cfg->film_grain_denoise_strength = strtol(value, NULL, 0); };  //not bool to enable possible algorithm extension in the future
+static void SetCfgFilmGrainUpdatePeriod         (const char *value, EbConfig *cfg) { cfg->film_grain_update_period = strtoul(value, NULL, 0); };
 static void SetDisableDlfFlag                   (const char *value, EbConfig *cfg) {cfg->disable_dlf_flag = (EbBool)strtoul(value, NULL, 0);};
 static void SetEnableLocalWarpedMotionFlag      (const char *value, EbConfig *cfg) {cfg->enable_warped_motion = (EbBool)strtoul(value, NULL, 0);};
 static void SetEnableHmeFlag                    (const char *value, EbConfig *cfg) {cfg->enable_hme_flag = (EbBool)strtoul(value, NULL, 0);};
@@ -228,6 +269,8 @@ static void SetLevel                            (const char *value, EbConfig *cf
 };
 static void SetInjector                         (const char *value, EbConfig *cfg) {cfg->injector                         = strtol(value,  NULL, 0);};
 static void SpeedControlFlag                    (const char *value, EbConfig *cfg) { cfg->speed_control_flag = strtol(value, NULL, 0); };
+static void SetDeadlineMode                     (const char *value, EbConfig *cfg) { cfg->deadline_mode = strtol(value, NULL, 0); };
+static void SetStatReport                       (const char *value, EbConfig *cfg) { cfg->stat_report = strtol(value, NULL, 0); };
 static void SetInjectorFrameRate                (const char *value, EbConfig *cfg) {
     cfg->injector_frame_rate = strtoul(value, NULL, 0);
     if (cfg->injector_frame_rate > 1000 ){
@@ -241,6 +284,8 @@ static void SetLatencyMode                      (const char *value, EbConfig *cf
 static void SetAsmType                          (const char *value, EbConfig *cfg)  {cfg->asm_type                   = (uint32_t)strtoul(value, NULL, 0);};
 static void SetLogicalProcessors                (const char *value, EbConfig *cfg)  {cfg->logical_processors         = (uint32_t)strtoul(value, NULL, 0);};
 static void SetTargetSocket                     (const char *value, EbConfig *cfg)  {cfg->target_socket              = (int32_t)strtol(value, NULL, 0);};
+static void SetChunkCount                       (const char *value, EbConfig *cfg)  {cfg->chunk_count                = (uint32_t)strtoul(value, NULL, 0);};
+static void SetChunkId                          (const char *value, EbConfig *cfg)  {cfg->chunk_id                   = (int32_t)strtol(value, NULL, 0);};
 
 enum cfg_type{
     SINGLE_INPUT,   // Configuration parameters that have only 1 value input
@@ -268,6 +313,8 @@ config_entry_t config_entry[] = {
     { SINGLE_INPUT, ERROR_FILE_TOKEN, "ErrorFile", SetCfgErrorFile },
     { SINGLE_INPUT, OUTPUT_RECON_TOKEN, "recon_file", SetCfgReconFile },
     { SINGLE_INPUT, QP_FILE_TOKEN, "qp_file", SetCfgQpFile },
+    { SINGLE_INPUT, OUTPUT_STAT_FILE_TOKEN, "OutputStatFile", SetCfgOutputStatFile },
+    { SINGLE_INPUT, INPUT_STAT_FILE_TOKEN, "InputStatFile", SetCfgInputStatFile },
 
     // Interlaced Video
     { SINGLE_INPUT, INTERLACED_VIDEO_TOKEN , "interlaced_video" , SetInterlacedVideo },
@@ -290,6 +337,7 @@ config_entry_t config_entry[] = {
     { SINGLE_INPUT, ENCODER_BIT_DEPTH, "EncoderBitDepth", SetEncoderBitDepth },
     { SINGLE_INPUT, ENCODER_COLOR_FORMAT, "EncoderColorFormat", SetEncoderColorFormat},
     { SINGLE_INPUT, INPUT_COMPRESSED_TEN_BIT_FORMAT, "CompressedTenBitFormat", SetcompressedTenBitFormat },
+    { SINGLE_INPUT, NATIVE_16BIT_PIPELINE_TOKEN, "Native16bitPipeline", SetNative16bitPipeline },
     { SINGLE_INPUT, HIERARCHICAL_LEVELS_TOKEN, "HierarchicalLevels", SetHierarchicalLevels },
     { SINGLE_INPUT, PRED_STRUCT_TOKEN, "PredStructure", SetCfgPredStructure },
 
@@ -338,16 +386,24 @@ config_entry_t config_entry[] = {
     { SINGLE_INPUT, THREAD_MGMNT, "logical_processors", SetLogicalProcessors },
     { SINGLE_INPUT, TARGET_SOCKET, "target_socket", SetTargetSocket },
 
+    // Chunked Encoding
+    { SINGLE_INPUT, CHUNK_COUNT_TOKEN, "ChunkCount", SetChunkCount },
+    { SINGLE_INPUT, CHUNK_ID_TOKEN, "ChunkId", SetChunkId },
+
     // Optional Features
 
 //    { SINGLE_INPUT, BITRATE_REDUCTION_TOKEN, "bit_rate_reduction", SetBitRateReduction },
     { SINGLE_INPUT, IMPROVE_SHARPNESS_TOKEN,"ImproveSharpness", SetImproveSharpness},
     { SINGLE_INPUT, HDR_INPUT_TOKEN, "HighDynamicRangeInput", SetHighDynamicRangeInput },
+    { SINGLE_INPUT, FILM_GRAIN_TOKEN, "FilmGrain", SetCfgFilmGrain },
+    { SINGLE_INPUT, FILM_GRAIN_PERIOD_TOKEN, "FilmGrainUpdatePeriod", SetCfgFilmGrainUpdatePeriod },
 
     // Latency
     { SINGLE_INPUT, INJECTOR_TOKEN, "Injector", SetInjector },
     { SINGLE_INPUT, INJECTOR_FRAMERATE_TOKEN, "InjectorFrameRate", SetInjectorFrameRate },
     { SINGLE_INPUT, SPEED_CONTROL_TOKEN, "SpeedControlFlag", SpeedControlFlag },
+    { SINGLE_INPUT, DEADLINE_MODE_TOKEN, "DeadlineMode", SetDeadlineMode },
+    { SINGLE_INPUT, STAT_REPORT_TOKEN, "StatReport", SetStatReport },
 
     // Annex A parameters
     { SINGLE_INPUT, PROFILE_TOKEN, "Profile", SetProfile },
@@ -380,6 +436,12 @@ void eb_config_ctor(EbConfig *config_ptr)
     config_ptr->recon_file                            = NULL;
     config_ptr->error_log_file                         = stderr;
     config_ptr->qp_file                               = NULL;
+    config_ptr->output_stat_file                      = NULL;
+    config_ptr->stitch_file                           = NULL;
+    config_ptr->input_file_name[0]                    = '\0';
+    config_ptr->rc_twopass_stats_in.buf               = NULL;
+    config_ptr->rc_twopass_stats_in.sz                = 0;
+    config_ptr->rc_firstpass_stats_out                = 0;
 
     config_ptr->frame_rate                            = 30 << 16;
     config_ptr->frame_rate_numerator                   = 0;
@@ -387,6 +449,7 @@ void eb_config_ctor(EbConfig *config_ptr)
     config_ptr->encoder_bit_depth                      = 8;
     config_ptr->encoder_color_format                   = 1; //EB_YUV420
     config_ptr->compressed_ten_bit_format               = 0;
+    config_ptr->native_16bit_pipeline                   = 0;
     config_ptr->source_width                          = 0;
     config_ptr->source_height                         = 0;
     config_ptr->input_padded_width                     = 0;
@@ -412,6 +475,8 @@ void eb_config_ctor(EbConfig *config_ptr)
 #else
     config_ptr->min_qp_allowed                       = 0;
 #endif
+    config_ptr->chunk_count                          = 0;
+    config_ptr->chunk_id                             = -1;
     config_ptr->base_layer_switch_mode               = 0;
     config_ptr->enc_mode                              = MAX_ENC_PRESET;
     config_ptr->intra_period                          = -2;
@@ -453,6 +518,7 @@ void eb_config_ctor(EbConfig *config_ptr)
     config_ptr->hme_level2_search_area_in_height_array[1]  = 1;
     config_ptr->constrained_intra                    = 0;
     config_ptr->film_grain_denoise_strength          = 0;
+    config_ptr->film_grain_update_period             = 0;
 
     // Thresholds
     config_ptr->high_dynamic_range_input             = 0;
@@ -468,6 +534,8 @@ void eb_config_ctor(EbConfig *config_ptr)
     config_ptr->injector                             = 0;
     config_ptr->injector_frame_rate                    = 60 << 16;
     config_ptr->speed_control_flag                     = 0;
+    config_ptr->deadline_mode                          = 0;
+    config_ptr->stat_report                            = 0;
 
 
     // Testing
@@ -490,6 +558,12 @@ void eb_config_ctor(EbConfig *config_ptr)
     config_ptr->performance_context.max_latency        = 0;
     config_ptr->performance_context.total_latency      = 0;
     config_ptr->performance_context.byte_count         = 0;
+    config_ptr->performance_context.sum_luma_psnr      = 0;
+    config_ptr->performance_context.sum_cb_psnr        = 0;
+    config_ptr->performance_context.sum_cr_psnr        = 0;
+    config_ptr->performance_context.sum_luma_ssim      = 0;
+    config_ptr->performance_context.sum_cb_ssim        = 0;
+    config_ptr->performance_context.sum_cr_ssim        = 0;
 
     // ASM Type
     config_ptr->asm_type                              = 1;
@@ -544,6 +618,22 @@ void eb_config_dtor(EbConfig *config_ptr)
         config_ptr->qp_file = (FILE *)NULL;
     }
 
+    if (config_ptr->output_stat_file) {
+        fclose(config_ptr->output_stat_file);
+        config_ptr->output_stat_file = (FILE *)NULL;
+    }
+
+    if (config_ptr->stitch_file) {
+        fclose(config_ptr->stitch_file);
+        config_ptr->stitch_file = (FILE *)NULL;
+    }
+
+    if (config_ptr->rc_twopass_stats_in.buf) {
+        free(config_ptr->rc_twopass_stats_in.buf);
+        config_ptr->rc_twopass_stats_in.buf = NULL;
+        config_ptr->rc_twopass_stats_in.sz = 0;
+    }
+
     return;
 }
 
@@ -830,6 +920,35 @@ static EbErrorType VerifySettings(EbConfig *config, uint32_t channelNumber)
         return_error = EB_ErrorBadParameter;
     }
 
+    // Chunked Encoding
+    if (config->chunk_count) {
+        if (config->chunk_id < -1 || config->chunk_id >= (int32_t)config->chunk_count) {
+            fprintf(config->error_log_file, "Error instance %u: Invalid ChunkId [-1 - %u], your input: %d\n", channelNumber + 1, config->chunk_count - 1, config->chunk_id);
+            return_error = EB_ErrorBadParameter;
+        }
+        if (config->chunk_id == -1 && config->chunk_count > MAX_CHANNEL_NUMBER) {
+            fprintf(config->error_log_file, "Error instance %u: At most %u chunks are encoded by one process, use ChunkId to encode each chunk separately\n", channelNumber + 1, MAX_CHANNEL_NUMBER);
+            return_error = EB_ErrorBadParameter;
+        }
+        if (config->input_file == stdin || config->y4m_input || config->separate_fields || config->buffered_input != -1 ||
+            (config->encoder_bit_depth == 10 && config->compressed_ten_bit_format == 1)) {
+            fprintf(config->error_log_file, "Error instance %u: Chunked encoding needs a yuv input file, without buffered input, separate fields or compressed 10-bit format\n", channelNumber + 1);
+            return_error = EB_ErrorBadParameter;
+        }
+        if (config->qp_file || config->output_stat_file || config->rc_twopass_stats_in.buf) {
+            fprintf(config->error_log_file, "Error instance %u: Qp and stat files are not supported by chunked encoding\n", channelNumber + 1);
+            return_error = EB_ErrorBadParameter;
+        }
+        if (config->chunk_id == -1 && config->recon_file) {
+            fprintf(config->error_log_file, "Error instance %u: Recon is not supported when all the chunks are encoded by one process\n", channelNumber + 1);
+            return_error = EB_ErrorBadParameter;
+        }
+    }
+    else if (config->chunk_id != -1) {
+        fprintf(config->error_log_file, "Error instance %u: ChunkId needs ChunkCount\n", channelNumber + 1);
+        return_error = EB_ErrorBadParameter;
+    }
+
 
     return return_error;
 }
@@ -193,6 +193,14 @@ typedef struct EbPerformanceContext {
 
     uint64_t                  byte_count;
 
+    // Per-frame quality sums, when stat_report is set
+    double                    sum_luma_psnr;
+    double                    sum_cb_psnr;
+    double                    sum_cr_psnr;
+    double                    sum_luma_ssim;
+    double                    sum_cb_ssim;
+    double                    sum_cr_ssim;
+
 }EbPerformanceContext;
 
 typedef struct EbConfig
@@ -208,6 +216,10 @@ typedef struct EbConfig
     FILE                    *buffer_file;
 
     FILE                    *qp_file;
+    FILE                    *output_stat_file;
+    FILE                    *stitch_file;       // Output of a chunked encode, the channels write its segments
+    char                     input_file_name[FILENAME_MAX];
+    EbSvtAv1FixedBuf         rc_twopass_stats_in;
 
     EbBool                  y4m_input;
     unsigned char           y4m_buf[9];
@@ -220,9 +232,13 @@ typedef struct EbConfig
     uint32_t                 injector_frame_rate;
     uint32_t                 injector;
     uint32_t                 speed_control_flag;
+    uint32_t                 deadline_mode;
+    uint32_t                 stat_report;
+    uint32_t                 rc_firstpass_stats_out;
     uint32_t                 encoder_bit_depth;
     uint32_t                 encoder_color_format;
     uint32_t                 compressed_ten_bit_format;
+    uint32_t                 native_16bit_pipeline;
     uint32_t                 source_width;
     uint32_t                 source_height;
 
@@ -262,6 +278,7 @@ typedef struct EbConfig
      * Film Grain
      ****************************************/
     uint32_t                film_grain_denoise_strength;
+    uint32_t                film_grain_update_period;
      /****************************************
      * DLF
      ****************************************/
@@ -328,6 +345,12 @@ typedef struct EbConfig
     uint32_t                 max_qp_allowed;
     uint32_t                 min_qp_allowed;
 
+    /****************************************
+     * Chunked Encoding
+     ****************************************/
+    uint32_t                 chunk_count;
+    int32_t                  chunk_id;
+
     /****************************************
      * Optional Features
      ****************************************/
@@ -380,5 +403,6 @@ extern void eb_config_dtor(EbConfig *config_ptr);
 extern EbErrorType    read_command_line(int32_t argc, char *const argv[], EbConfig **config, uint32_t  num_channels,    EbErrorType *return_errors);
 extern uint32_t     get_help(int32_t argc, char *const argv[]);
 extern uint32_t        get_number_of_channels(int32_t argc, char *const argv[]);
+extern int32_t         ComputeFramesToBeEncoded(EbConfig *config);
 
 #endif //EbAppConfig_h
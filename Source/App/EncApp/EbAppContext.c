@@ -19,7 +19,6 @@
 #define INPUT_SIZE_4K_TH                0x29F630    // 2.75 Million
 
 #define IS_16_BIT(bit_depth) (bit_depth==10?1:0)
-#define EB_OUTPUTSTREAMBUFFERSIZE_MACRO(ResolutionSize)                ((ResolutionSize) < (INPUT_SIZE_1080i_TH) ? 0x1E8480 : (ResolutionSize) < (INPUT_SIZE_1080p_TH) ? 0x2DC6C0 : (ResolutionSize) < (INPUT_SIZE_4K_TH) ? 0x2DC6C0 : 0x2DC6C0  )
 
  /***************************************
  * Variables Defining a memory table
@@ -206,15 +205,22 @@ EbErrorType CopyConfigurationParameters(
     callback_data->eb_enc_parameters.encoder_bit_depth = config->encoder_bit_depth;
     callback_data->eb_enc_parameters.encoder_color_format = config->encoder_color_format;
     callback_data->eb_enc_parameters.compressed_ten_bit_format = config->compressed_ten_bit_format;
+    callback_data->eb_enc_parameters.native_16bit_pipeline = config->native_16bit_pipeline;
     callback_data->eb_enc_parameters.profile = config->profile;
     callback_data->eb_enc_parameters.tier = config->tier;
     callback_data->eb_enc_parameters.level = config->level;
     callback_data->eb_enc_parameters.injector_frame_rate = config->injector_frame_rate;
     callback_data->eb_enc_parameters.speed_control_flag = config->speed_control_flag;
+    callback_data->eb_enc_parameters.deadline_mode = config->deadline_mode;
+    callback_data->eb_enc_parameters.stat_report = config->stat_report;
+    callback_data->eb_enc_parameters.film_grain_denoise_strength = config->film_grain_denoise_strength;
+    callback_data->eb_enc_parameters.film_grain_update_period = config->film_grain_update_period;
+    callback_data->eb_enc_parameters.rc_firstpass_stats_out = config->rc_firstpass_stats_out;
+    callback_data->eb_enc_parameters.rc_twopass_stats_in = config->rc_twopass_stats_in;
     callback_data->eb_enc_parameters.asm_type = config->asm_type;
     callback_data->eb_enc_parameters.logical_processors = config->logical_processors;
     callback_data->eb_enc_parameters.target_socket = config->target_socket;
-    callback_data->eb_enc_parameters.recon_enabled = config->recon_file ? EB_TRUE : EB_FALSE;
+    callback_data->eb_enc_parameters.recon_enabled = config->recon_file ? 2 : 0; // zero-copy recon views
 
     for (hmeRegionIndex = 0; hmeRegionIndex < callback_data->eb_enc_parameters.number_hme_search_region_in_width; ++hmeRegionIndex) {
         callback_data->eb_enc_parameters.hme_level0_search_area_in_width_array[hmeRegionIndex] = config->hme_level0_search_area_in_width_array[hmeRegionIndex];
@@ -332,55 +338,6 @@ EbErrorType AllocateInputBuffers(
 
     return return_error;
 }
-EbErrorType AllocateOutputReconBuffers(
-    EbConfig                *config,
-    EbAppContext            *callback_data)
-{
-
-    EbErrorType   return_error = EB_ErrorNone;
-    const size_t lumaSize =
-        config->input_padded_width    *
-        config->input_padded_height;
-    // both u and v
-    const size_t chromaSize = lumaSize >> (3 - config->encoder_color_format);
-    const size_t tenBit = (config->encoder_bit_depth > 8);
-    const size_t frameSize = (lumaSize + 2 * chromaSize) << tenBit;
-
-// ... Recon Port
-    EB_APP_MALLOC(EbBufferHeaderType*, callback_data->recon_buffer, sizeof(EbBufferHeaderType), EB_N_PTR, EB_ErrorInsufficientResources);
-
-    // Initialize Header
-    callback_data->recon_buffer->size = sizeof(EbBufferHeaderType);
-
-    EB_APP_MALLOC(uint8_t*, callback_data->recon_buffer->p_buffer, frameSize, EB_N_PTR, EB_ErrorInsufficientResources);
-
-    callback_data->recon_buffer->n_alloc_len = (uint32_t)frameSize;
-    callback_data->recon_buffer->p_app_private = NULL;
-    return return_error;
-}
-
-EbErrorType AllocateOutputBuffers(
-    EbConfig                *config,
-    EbAppContext            *callback_data)
-{
-
-    EbErrorType   return_error = EB_ErrorNone;
-    uint32_t           outputStreamBufferSize = (uint32_t)(EB_OUTPUTSTREAMBUFFERSIZE_MACRO(config->input_padded_height * config->input_padded_width));;
-    {
-        EB_APP_MALLOC(EbBufferHeaderType*, callback_data->stream_buffer_pool, sizeof(EbBufferHeaderType), EB_N_PTR, EB_ErrorInsufficientResources);
-
-        // Initialize Header
-        callback_data->stream_buffer_pool->size = sizeof(EbBufferHeaderType);
-
-        EB_APP_MALLOC(uint8_t*, callback_data->stream_buffer_pool->p_buffer, outputStreamBufferSize, EB_N_PTR, EB_ErrorInsufficientResources);
-
-        callback_data->stream_buffer_pool->n_alloc_len = outputStreamBufferSize;
-        callback_data->stream_buffer_pool->p_app_private = NULL;
-        callback_data->stream_buffer_pool->pic_type = EB_AV1_INVALID_PICTURE;
-    }
-    return return_error;
-}
-
 EbErrorType PreloadFramesIntoRam(
     EbConfig                *config)
 {
@@ -612,24 +569,6 @@ EbErrorType init_encoder(
         return return_error;
     }
 
-    // STEP 7: Allocate output buffers carrying the bitstream out
-    return_error = AllocateOutputBuffers(
-        config,
-        callback_data);
-
-    if (return_error != EB_ErrorNone) {
-        return return_error;
-    }
-
-    // STEP 8: Allocate output Recon Buffer
-    return_error = AllocateOutputReconBuffers(
-        config,
-        callback_data);
-
-    if (return_error != EB_ErrorNone) {
-        return return_error;
-    }
-
     // Allocate the Sequence Buffer
     if (config->buffered_input != -1) {
 
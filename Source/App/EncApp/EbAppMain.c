@@ -22,6 +22,7 @@
 #include <stdint.h>
 #include "EbAppConfig.h"
 #include "EbAppContext.h"
+#include "EbAppChunk.h"
 #include "EbSvtAv1Time.h"
 #ifdef _WIN32
 #include <Windows.h>
@@ -106,6 +107,8 @@ int32_t main(int32_t argc, char* argv[])
     signal(SIGINT, EventHandler);
     printf("-------------------------------------------\n");
     printf("SVT-AV1 Encoder\n");
+    if (get_stitch(argc, argv, &return_error))
+        return (return_error == 0) ? 0 : 1;
     if (!get_help(argc, argv)) {
 
         // Get num_channels
@@ -141,6 +144,10 @@ int32_t main(int32_t argc, char* argv[])
         // Read all configuration files.
         return_error = read_command_line(argc, argv, configs, num_channels, return_errors);
 
+        // Split the input into segments, in-process chunks take one channel each
+        if (return_error == EB_ErrorNone && configs[0]->chunk_count)
+            return_error = chunk_setup(configs, appCallbacks, &num_channels, return_errors);
+
         // Process any command line options, including the configuration file
 
         if (return_error == EB_ErrorNone) {
@@ -257,6 +264,19 @@ int32_t main(int32_t argc, char* argv[])
                                 (double)frame_rate,
                                 (double)configs[instanceCount]->performance_context.byte_count,
                                 ((double)(configs[instanceCount]->performance_context.byte_count << 3) * frame_rate / (configs[instanceCount]->frames_encoded * 1000)));
+                            if (configs[instanceCount]->stat_report) {
+                                const double frame_count = (double)configs[instanceCount]->performance_context.frame_count;
+                                printf("Average PSNR\t\tY %.4f dB\t\tU %.4f dB\t\tV %.4f dB\n",
+                                    configs[instanceCount]->performance_context.sum_luma_psnr / frame_count,
+                                    configs[instanceCount]->performance_context.sum_cb_psnr / frame_count,
+                                    configs[instanceCount]->performance_context.sum_cr_psnr / frame_count);
+                                if (configs[instanceCount]->stat_report > 1) {
+                                    printf("Average SSIM\t\tY %.6f\t\tU %.6f\t\tV %.6f\n",
+                                        configs[instanceCount]->performance_context.sum_luma_ssim / frame_count,
+                                        configs[instanceCount]->performance_context.sum_cb_ssim / frame_count,
+                                        configs[instanceCount]->performance_context.sum_cr_ssim / frame_count);
+                                }
+                            }
                             fflush(stdout);
                         }
                     }
@@ -301,6 +321,26 @@ int32_t main(int32_t argc, char* argv[])
                     printf("Error encoding at channel %u! Check error log file for more details ... \n", instanceCount + 1);
                 }
             }
+            // Write the analysis pass stats once the last packet has been received
+            for (instanceCount = 0; instanceCount < num_channels; ++instanceCount) {
+                if (exitConditions[instanceCount] == APP_ExitConditionFinished && return_errors[instanceCount] == EB_ErrorNone && configs[instanceCount]->output_stat_file) {
+                    EbSvtAv1FixedBuf first_pass_stats;
+                    if (eb_svt_enc_get_stream_info(appCallbacks[instanceCount]->svt_encoder_handle, EB_STREAM_INFO_FIRST_PASS_STATS_OUT, &first_pass_stats) == EB_ErrorNone)
+                        fwrite(first_pass_stats.buf, 1, (size_t)first_pass_stats.sz, configs[instanceCount]->output_stat_file);
+                }
+            }
+            // Stitch the chunk segments once every channel is done
+            if (configs[0]->chunk_count) {
+                EbBool encode_done = EB_TRUE;
+                for (instanceCount = 0; instanceCount < num_channels; ++instanceCount) {
+                    if (exitConditions[instanceCount] != APP_ExitConditionFinished || return_errors[instanceCount] != EB_ErrorNone || configs[instanceCount]->stop_encoder)
+                        encode_done = EB_FALSE;
+                }
+                if (chunk_finish(configs, num_channels, encode_done) != EB_ErrorNone) {
+                    printf("Error stitching the chunks! ... \n");
+                    return_error = EB_ErrorBadParameter;
+                }
+            }
             // DeInit Encoder
             for (instanceCount = num_channels; instanceCount > 0; --instanceCount) {
                 if (return_errors[instanceCount - 1] == EB_ErrorNone)
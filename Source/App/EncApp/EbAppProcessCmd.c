@@ -9,6 +9,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
 
 #include "EbAppContext.h"
 #include "EbAppConfig.h"
@@ -195,7 +196,7 @@ void LogErrorOutput(
         break;
 
     case EB_ENC_EC_ERROR2:
-        fprintf(error_log_file, "Error: CopyRbspBitstreamToPayload: output buffer too small!\n");
+        fprintf(error_log_file, "Error: Packetization: out of memory for the output segments!\n");
         break;
 
     case EB_ENC_EC_ERROR3:
@@ -242,6 +243,10 @@ void LogErrorOutput(
         fprintf(error_log_file, "Error: No more than 6 SAO types\n");
         break;
 
+    case EB_ENC_EC_ERROR30:
+        fprintf(error_log_file, "Error: EncDec: out of memory for the SB symbol streams!\n");
+        break;
+
         // EB_ENC_FL_ERRORS:
     case EB_ENC_FL_ERROR1:
         fprintf(error_log_file, "Error: Uncovered area inside Cu!\n");
@@ -1137,6 +1142,31 @@ static void write_ivf_frame_header(EbConfig *config, uint32_t byte_count){
         fwrite(header, 1, IVF_FRAME_HEADER_SIZE, config->bitstream_file);
 }
 
+// Writes size bytes of an output packet, starting offset bytes into its segment chain
+static void write_output_segments(const EbOutputSegment *segment, uint32_t offset, uint32_t size, FILE *file)
+{
+    for (; segment && size; segment = segment->next) {
+        if (offset >= segment->filled_len) {
+            offset -= segment->filled_len;
+            continue;
+        }
+        const uint32_t write_size = (segment->filled_len - offset < size) ? segment->filled_len - offset : size;
+        fwrite(segment->data + offset, 1, write_size, file);
+        size -= write_size;
+        offset = 0;
+    }
+}
+
+#define MAX_PSNR 100.0
+static double sse_to_psnr(double samples, double peak, double sse)
+{
+    if (sse > 0.0) {
+        const double psnr = 10.0 * log10(samples * peak * peak / sse);
+        return psnr > MAX_PSNR ? MAX_PSNR : psnr;
+    }
+    return MAX_PSNR;
+}
+
 AppExitConditionType ProcessOutputStreamBuffer(
     EbConfig             *config,
     EbAppContext         *appCallBack,
@@ -1210,11 +1240,11 @@ AppExitConditionType ProcessOutputStreamBuffer(
 
                     // Write a new IVF frame header to file as a TD is in the packet
                     write_ivf_frame_header(config, headerPtr->n_filled_len - (obu_frame_header_size + TD_SIZE));
-                    fwrite(headerPtr->p_buffer, 1, headerPtr->n_filled_len - (obu_frame_header_size + TD_SIZE), streamFile);
+                    write_output_segments((EbOutputSegment*)headerPtr->p_buffer, 0, headerPtr->n_filled_len - (obu_frame_header_size + TD_SIZE), streamFile);
 
                     // An EB_BUFFERFLAG_SHOW_EXT means that another TD has been added to the packet to show another frame, a new IVF is needed
                     write_ivf_frame_header(config, (obu_frame_header_size + TD_SIZE));
-                    fwrite(headerPtr->p_buffer + headerPtr->n_filled_len - (obu_frame_header_size + TD_SIZE), 1, (obu_frame_header_size + TD_SIZE), streamFile);
+                    write_output_segments((EbOutputSegment*)headerPtr->p_buffer, headerPtr->n_filled_len - (obu_frame_header_size + TD_SIZE), (obu_frame_header_size + TD_SIZE), streamFile);
 
 
                     break;
@@ -1226,14 +1256,14 @@ AppExitConditionType ProcessOutputStreamBuffer(
 
                     // Write a new IVF frame header to file as a TD is in the packet
                     write_ivf_frame_header(config, headerPtr->n_filled_len);
-                    fwrite(headerPtr->p_buffer, 1, headerPtr->n_filled_len, streamFile);
+                    write_output_segments((EbOutputSegment*)headerPtr->p_buffer, 0, headerPtr->n_filled_len, streamFile);
 
                     break;
 
                 case (EB_BUFFERFLAG_SHOW_EXT):
 
                     // this case means that there's only one TD in this packet and is relater
-                    fwrite(headerPtr->p_buffer, 1, headerPtr->n_filled_len - (obu_frame_header_size + TD_SIZE), streamFile);
+                    write_output_segments((EbOutputSegment*)headerPtr->p_buffer, 0, headerPtr->n_filled_len - (obu_frame_header_size + TD_SIZE), streamFile);
                     // this packet will be part of the previous IVF header
                     config->byte_count_since_ivf += (headerPtr->n_filled_len - (obu_frame_header_size + TD_SIZE));
 
@@ -1242,14 +1272,14 @@ AppExitConditionType ProcessOutputStreamBuffer(
 
                     // An EB_BUFFERFLAG_SHOW_EXT means that another TD has been added to the packet to show another frame, a new IVF is needed
                     write_ivf_frame_header(config, (obu_frame_header_size + TD_SIZE));
-                    fwrite(headerPtr->p_buffer + headerPtr->n_filled_len - (obu_frame_header_size + TD_SIZE), 1, (obu_frame_header_size + TD_SIZE), streamFile);
+                    write_output_segments((EbOutputSegment*)headerPtr->p_buffer, headerPtr->n_filled_len - (obu_frame_header_size + TD_SIZE), (obu_frame_header_size + TD_SIZE), streamFile);
 
                     break;
 
                 default:
 
                     // This is a packet without a TD, write it straight to file
-                    fwrite(headerPtr->p_buffer, 1, headerPtr->n_filled_len, streamFile);
+                    write_output_segments((EbOutputSegment*)headerPtr->p_buffer, 0, headerPtr->n_filled_len, streamFile);
 
                     // this packet will be part of the previous IVF header
                     config->byte_count_since_ivf += (headerPtr->n_filled_len);
@@ -1258,6 +1288,18 @@ AppExitConditionType ProcessOutputStreamBuffer(
         }
         config->performance_context.byte_count += headerPtr->n_filled_len;
 
+        if (config->stat_report) {
+            const double luma_samples = (double)config->source_width * config->source_height;
+            const double chroma_samples = (double)((config->source_width + 1) >> 1) * ((config->source_height + 1) >> 1);
+            const double peak = (double)((1 << config->encoder_bit_depth) - 1);
+            config->performance_context.sum_luma_psnr += sse_to_psnr(luma_samples, peak, (double)headerPtr->luma_sse);
+            config->performance_context.sum_cb_psnr += sse_to_psnr(chroma_samples, peak, (double)headerPtr->cb_sse);
+            config->performance_context.sum_cr_psnr += sse_to_psnr(chroma_samples, peak, (double)headerPtr->cr_sse);
+            config->performance_context.sum_luma_ssim += headerPtr->luma_ssim;
+            config->performance_context.sum_cb_ssim += headerPtr->cb_ssim;
+            config->performance_context.sum_cr_ssim += headerPtr->cr_ssim;
+        }
+
         // Update Output Port Activity State
         *portState = (headerPtr->flags & EB_BUFFERFLAG_EOS) ? APP_PortInactive : *portState;
         return_value = (headerPtr->flags & EB_BUFFERFLAG_EOS) ? APP_ExitConditionFinished : APP_ExitConditionNone;
@@ -1293,22 +1335,29 @@ AppExitConditionType ProcessOutputReconBuffer(
     EbConfig             *config,
     EbAppContext         *appCallBack)
 {
-    EbBufferHeaderType    *headerPtr = appCallBack->recon_buffer; // needs to change for buffered input
+    EbBufferHeaderType    *headerPtr = NULL;
     EbComponentType       *componentHandle = (EbComponentType*)appCallBack->svt_encoder_handle;
     AppExitConditionType    return_value = APP_ExitConditionNone;
     EbErrorType            recon_status = EB_ErrorNone;
     int32_t fseekReturnVal;
     // non-blocking call until all input frames are sent
-    recon_status = eb_svt_get_recon(componentHandle, headerPtr);
+    recon_status = eb_svt_get_recon_view(componentHandle, &headerPtr);
 
     if (recon_status == EB_ErrorMax) {
         printf("\n");
         LogErrorOutput(
             config->error_log_file,
-            headerPtr->flags);
+            headerPtr ? headerPtr->flags : 0);
+        // An errored view still holds its picture
+        eb_svt_release_recon_view(&headerPtr);
         return APP_ExitConditionError;
     }
     else if (recon_status != EB_NoErrorEmptyQueue) {
+        // The view points into the encoder's own buffers, write it out row by row
+        EbSvtIOFormat *reconPtr = (EbSvtIOFormat*)headerPtr->p_buffer;
+        const uint32_t sampleSize = (config->encoder_bit_depth > 8) ? 2 : 1;
+        uint32_t rowIndex;
+
         //Sets the File position to the beginning of the file.
         rewind(config->recon_file);
         uint64_t frameNum = headerPtr->pts;
@@ -1317,15 +1366,23 @@ AppExitConditionType ProcessOutputReconBuffer(
 
             if (fseekReturnVal != 0) {
                 printf("Error in fseeko64  returnVal %i\n", fseekReturnVal);
+                eb_svt_release_recon_view(&headerPtr);
                 return APP_ExitConditionError;
             }
             frameNum = frameNum - 1;
         }
 
-        fwrite(headerPtr->p_buffer, 1, headerPtr->n_filled_len, config->recon_file);
+        for (rowIndex = 0; rowIndex < reconPtr->height; ++rowIndex)
+            fwrite(reconPtr->luma + rowIndex * reconPtr->y_stride * sampleSize, sampleSize, reconPtr->width, config->recon_file);
+        for (rowIndex = 0; rowIndex < reconPtr->height >> 1; ++rowIndex)
+            fwrite(reconPtr->cb + rowIndex * reconPtr->cb_stride * sampleSize, sampleSize, reconPtr->width >> 1, config->recon_file);
+        for (rowIndex = 0; rowIndex < reconPtr->height >> 1; ++rowIndex)
+            fwrite(reconPtr->cr + rowIndex * reconPtr->cr_stride * sampleSize, sampleSize, reconPtr->width >> 1, config->recon_file);
 
         // Update Output Port Activity State
         return_value = (headerPtr->flags & EB_BUFFERFLAG_EOS) ? APP_ExitConditionFinished : APP_ExitConditionNone;
+
+        eb_svt_release_recon_view(&headerPtr);
     }
     return return_value;
 }
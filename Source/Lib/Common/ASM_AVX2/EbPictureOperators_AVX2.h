@@ -146,6 +146,15 @@ extern "C" {
         uint32_t  area_width,
         uint32_t  area_height);
 
+    void decimation_2d_avx2_intrin(
+        uint8_t  *input_samples,
+        uint32_t  input_stride,
+        uint32_t  input_area_width,
+        uint32_t  input_area_height,
+        uint8_t  *decim_samples,
+        uint32_t  decim_stride,
+        uint32_t  decim_step);
+
 
 #ifdef __cplusplus
 }
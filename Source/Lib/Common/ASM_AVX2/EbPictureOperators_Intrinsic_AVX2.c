@@ -2831,3 +2831,51 @@ void ResidualKernel_avx2(
         }
     }
 }
+
+/********************************************
+ * decimation_2d_avx2_intrin
+ *      keeps one sample out of decim_step (2 or 4) in both
+ *      directions, 64 input samples per iteration
+ ********************************************/
+void decimation_2d_avx2_intrin(
+    uint8_t  *input_samples,
+    uint32_t  input_stride,
+    uint32_t  input_area_width,
+    uint32_t  input_area_height,
+    uint8_t  *decim_samples,
+    uint32_t  decim_stride,
+    uint32_t  decim_step)
+{
+    const uint32_t decim_shift = decim_step >> 1;
+    const uint32_t simd_width = input_area_width & ~63u;
+    const __m256i mask_2 = _mm256_set1_epi16(0x00FF);
+    const __m256i mask_4 = _mm256_set1_epi32(0x000000FF);
+    const __m256i order_4 = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    uint32_t horizontal_index;
+    uint32_t vertical_index;
+
+    for (vertical_index = 0; vertical_index < input_area_height; vertical_index += decim_step) {
+        for (horizontal_index = 0; horizontal_index < simd_width; horizontal_index += 64) {
+            const __m256i in0 = _mm256_loadu_si256((const __m256i *)(input_samples + horizontal_index));
+            const __m256i in1 = _mm256_loadu_si256((const __m256i *)(input_samples + horizontal_index + 32));
+
+            if (decim_step == 2) {
+                // lanes come out as in0.lo in1.lo in0.hi in1.hi
+                const __m256i out = _mm256_packus_epi16(_mm256_and_si256(in0, mask_2), _mm256_and_si256(in1, mask_2));
+                _mm256_storeu_si256((__m256i *)(decim_samples + (horizontal_index >> 1)), _mm256_permute4x64_epi64(out, 0xD8));
+            }
+            else {
+                // dwords come out as in0.lo in1.lo x x in0.hi in1.hi x x
+                __m256i out = _mm256_packs_epi32(_mm256_and_si256(in0, mask_4), _mm256_and_si256(in1, mask_4));
+                out = _mm256_packus_epi16(out, out);
+                out = _mm256_permutevar8x32_epi32(out, order_4);
+                _mm_storeu_si128((__m128i *)(decim_samples + (horizontal_index >> 2)), _mm256_castsi256_si128(out));
+            }
+        }
+        for (; horizontal_index < input_area_width; horizontal_index += decim_step)
+            decim_samples[horizontal_index >> decim_shift] = input_samples[horizontal_index];
+
+        input_samples += (input_stride << decim_shift);
+        decim_samples += decim_stride;
+    }
+}
@@ -860,6 +860,97 @@ void SIMD_FUNC(cdef_filter_block_8x8_16)(uint16_t *dst, int32_t dstride,
     }
 }
 
+// Loads the taps at +offset and -offset for two rows and folds them into min/max
+SIMD_INLINE void load_tap_pair(const uint16_t *in, int32_t offset, v256 *p0, v256 *p1,
+    v256 *min, v256 *max, v256 large) {
+    *p0 = v256_from_v128(v128_load_unaligned(&in[offset]),
+        v128_load_unaligned(&in[CDEF_BSTRIDE + offset]));
+    *p1 = v256_from_v128(v128_load_unaligned(&in[-offset]),
+        v128_load_unaligned(&in[CDEF_BSTRIDE - offset]));
+    *max = v256_max_s16(v256_max_s16(*max, v256_andn(*p0, v256_cmpeq_16(*p0, large))),
+        v256_andn(*p1, v256_cmpeq_16(*p1, large)));
+    *min = v256_min_s16(v256_min_s16(*min, *p0), *p1);
+}
+
+// The taps, min/max and primary sum are computed once per row pair and shared
+// by the secondary strengths, only the secondary constrain is done per strength.
+void SIMD_FUNC(cdef_filter_block_8x8_16_sec4)(uint16_t *dst, const uint16_t *in,
+    int32_t pri_strength, const int32_t *sec_strength, int32_t dir,
+    int32_t pri_damping, int32_t sec_damping, int32_t coeff_shift) {
+    int32_t i, k;
+    v256 pri_sum, sum, row, res, max, min;
+    v256 p0, p1, p2, p3;
+    v256 sec[8];
+    const v256 large = v256_dup_16(CDEF_VERY_LARGE);
+    const int32_t po1 = cdef_directions[dir][0];
+    const int32_t po2 = cdef_directions[dir][1];
+    const int32_t s1o1 = cdef_directions[(dir + 2) & 7][0];
+    const int32_t s1o2 = cdef_directions[(dir + 2) & 7][1];
+    const int32_t s2o1 = cdef_directions[(dir + 6) & 7][0];
+    const int32_t s2o2 = cdef_directions[(dir + 6) & 7][1];
+    const int32_t *pri_taps = cdef_pri_taps[(pri_strength >> coeff_shift) & 1];
+    const int32_t *sec_taps = cdef_sec_taps[(pri_strength >> coeff_shift) & 1];
+    int32_t sec_dampings[CDEF_SEC_STRENGTHS];
+
+    if (pri_strength)
+        pri_damping = AOMMAX(0, pri_damping - get_msb(pri_strength));
+    for (k = 0; k < CDEF_SEC_STRENGTHS; k++)
+        sec_dampings[k] = sec_strength[k] ? AOMMAX(0, sec_damping - get_msb(sec_strength[k])) : sec_damping;
+
+    for (i = 0; i < 8; i += 2) {
+        const uint16_t *in_row = &in[i * CDEF_BSTRIDE];
+        row = v256_from_v128(v128_load_aligned(&in_row[0]),
+            v128_load_aligned(&in_row[CDEF_BSTRIDE]));
+        min = max = row;
+
+        // Primary taps
+        load_tap_pair(in_row, po1, &p0, &p1, &min, &max, large);
+        p0 = constrain16(p0, row, pri_strength, pri_damping);
+        p1 = constrain16(p1, row, pri_strength, pri_damping);
+        pri_sum = v256_mullo_s16(v256_dup_16(pri_taps[0]), v256_add_16(p0, p1));
+        load_tap_pair(in_row, po2, &p0, &p1, &min, &max, large);
+        p0 = constrain16(p0, row, pri_strength, pri_damping);
+        p1 = constrain16(p1, row, pri_strength, pri_damping);
+        pri_sum = v256_add_16(pri_sum,
+            v256_mullo_s16(v256_dup_16(pri_taps[1]), v256_add_16(p0, p1)));
+
+        // Secondary taps, near ones first
+        load_tap_pair(in_row, s1o1, &sec[0], &sec[1], &min, &max, large);
+        load_tap_pair(in_row, s2o1, &sec[2], &sec[3], &min, &max, large);
+        load_tap_pair(in_row, s1o2, &sec[4], &sec[5], &min, &max, large);
+        load_tap_pair(in_row, s2o2, &sec[6], &sec[7], &min, &max, large);
+
+        for (k = 0; k < CDEF_SEC_STRENGTHS; k++) {
+            const int32_t strength = sec_strength[k];
+            const int32_t damping = sec_dampings[k];
+            sum = pri_sum;
+            if (strength) {
+                p0 = constrain16(sec[0], row, strength, damping);
+                p1 = constrain16(sec[1], row, strength, damping);
+                p2 = constrain16(sec[2], row, strength, damping);
+                p3 = constrain16(sec[3], row, strength, damping);
+                sum = v256_add_16(sum, v256_mullo_s16(v256_dup_16(sec_taps[0]),
+                    v256_add_16(v256_add_16(p0, p1), v256_add_16(p2, p3))));
+                p0 = constrain16(sec[4], row, strength, damping);
+                p1 = constrain16(sec[5], row, strength, damping);
+                p2 = constrain16(sec[6], row, strength, damping);
+                p3 = constrain16(sec[7], row, strength, damping);
+                sum = v256_add_16(sum, v256_mullo_s16(v256_dup_16(sec_taps[1]),
+                    v256_add_16(v256_add_16(p0, p1), v256_add_16(p2, p3))));
+            }
+
+            // res = row + ((sum - (sum < 0) + 8) >> 4)
+            sum = v256_add_16(sum, v256_cmplt_s16(sum, v256_zero()));
+            res = v256_add_16(sum, v256_dup_16(8));
+            res = v256_shr_n_s16(res, 4);
+            res = v256_add_16(row, res);
+            res = v256_min_s16(v256_max_s16(res, min), max);
+            v128_store_aligned(&dst[(k << 6) + i * 8], v256_high_v128(res));
+            v128_store_aligned(&dst[(k << 6) + (i + 1) * 8], v256_low_v128(res));
+        }
+    }
+}
+
 void SIMD_FUNC(cdef_filter_block)(uint8_t *dst8, uint16_t *dst16, int32_t dstride,
     const uint16_t *in, int32_t pri_strength,
     int32_t sec_strength, int32_t dir, int32_t pri_damping,
@@ -15,6 +15,7 @@
 #include <immintrin.h>  /* AVX2 */
 
 #include "EbDefinitions.h"
+#include "EbMdRateEstimation.h"
 #include "synonyms.h"
 #include "synonyms_avx2.h"
 
@@ -125,3 +126,160 @@ void av1_txb_init_levels_avx2(const tran_low_t *const coeff, const int32_t width
     } while (i < height);
   }
 }
+
+static INLINE int32_t get_br_ctx_scalar(const uint8_t *const levels,
+    const int32_t c, const int32_t bwl, const TX_CLASS tx_class) {
+  const int32_t row = c >> bwl;
+  const int32_t col = c - (row << bwl);
+  const int32_t stride = (1 << bwl) + TX_PAD_HOR;
+  const int32_t pos = row * stride + col;
+  int32_t mag = levels[pos + 1] + levels[pos + stride];
+  int32_t near_dc;
+  if (tx_class == TX_CLASS_2D) {
+    mag += levels[pos + stride + 1];
+    near_dc = (row < 2) && (col < 2);
+  } else if (tx_class == TX_CLASS_HORIZ) {
+    mag += levels[pos + 2];
+    near_dc = (col == 0);
+  } else {
+    mag += levels[pos + (stride << 1)];
+    near_dc = (row == 0);
+  }
+  mag = AOMMIN((mag + 1) >> 1, 6);
+  if (c == 0) return mag;
+  return mag + (near_dc ? 7 : 14);
+}
+
+static INLINE int32_t get_golomb_cost_scalar(const int32_t level) {
+  if (level >= 1 + NUM_BASE_LEVELS + COEFF_BASE_RANGE) {
+    const int32_t r = level - COEFF_BASE_RANGE - NUM_BASE_LEVELS;
+    const int32_t length = get_msb(r) + 1;
+    return av1_cost_literal(2 * length - 1);
+  }
+  return 0;
+}
+
+// Cost of the coefficient at scan index c, as in av1_cost_coeffs_levels_c()
+static INLINE int32_t coeff_cost_scalar(const tran_low_t *const qcoeff,
+    const uint8_t *const levels, const int16_t *const scan,
+    const int8_t *const coeff_contexts, const int32_t c, const int32_t last,
+    const int32_t bwl, const TX_CLASS tx_class, const int16_t dc_sign_ctx,
+    const LV_MAP_COEFF_COST *const coeff_costs) {
+  const int32_t pos = scan[c];
+  const tran_low_t v = qcoeff[pos];
+  const int32_t level = abs(v);
+  const int32_t coeff_ctx = coeff_contexts[pos];
+  int32_t cost;
+
+  if (c == last)
+    cost = coeff_costs->base_eob_cost[coeff_ctx][AOMMIN(level, 3) - 1];
+  else
+    cost = coeff_costs->base_cost[coeff_ctx][AOMMIN(level, 3)];
+  if (level) {
+    cost += c ? av1_cost_literal(1) : coeff_costs->dc_sign_cost[dc_sign_ctx][v < 0];
+    if (level > NUM_BASE_LEVELS) {
+      const int32_t ctx = get_br_ctx_scalar(levels, pos, bwl, tx_class);
+      cost += coeff_costs->lps_cost[ctx][AOMMIN(level - 1 - NUM_BASE_LEVELS, COEFF_BASE_RANGE)];
+      cost += get_golomb_cost_scalar(level);
+    }
+  }
+  return cost;
+}
+
+static INLINE __m256i gather_levels(const uint8_t *const levels,
+    const __m256i lpos) {
+  return _mm256_and_si256(
+      _mm256_i32gather_epi32((const int *)levels, lpos, 1),
+      _mm256_set1_epi32(0xff));
+}
+
+// The last and the DC coefficients are costed with the scalar code, the
+// scan positions in between 8 at a time.
+int32_t av1_cost_coeffs_levels_avx2(const tran_low_t *const qcoeff,
+    const uint8_t *const levels, const int16_t *const scan,
+    const int8_t *const coeff_contexts, const uint16_t eob, const int32_t bwl,
+    const TX_CLASS tx_class, const int16_t dc_sign_ctx,
+    const LV_MAP_COEFF_COST *const coeff_costs) {
+  const int32_t last = eob - 1;
+  const int32_t stride = (1 << bwl) + TX_PAD_HOR;
+  const int32_t third_offset = (tx_class == TX_CLASS_2D) ? stride + 1 :
+      (tx_class == TX_CLASS_HORIZ) ? 2 : (stride << 1);
+  const __m128i bwl_shift = _mm_cvtsi32_si128(bwl);
+  const __m256i one = _mm256_set1_epi32(1);
+  const __m256i two = _mm256_set1_epi32(2);
+  const __m256i three = _mm256_set1_epi32(3);
+  const __m256i six = _mm256_set1_epi32(6);
+  const __m256i seven = _mm256_set1_epi32(7);
+  const __m256i fourteen = _mm256_set1_epi32(14);
+  const __m256i range = _mm256_set1_epi32(COEFF_BASE_RANGE);
+  const __m256i lps_stride = _mm256_set1_epi32(COEFF_BASE_RANGE + 1);
+  const __m256i golomb_min = _mm256_set1_epi32(NUM_BASE_LEVELS + COEFF_BASE_RANGE);
+  const __m256i sign_cost = _mm256_set1_epi32(av1_cost_literal(1));
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i sum = zero;
+  int32_t cost;
+  int32_t c;
+
+  cost = coeff_cost_scalar(qcoeff, levels, scan, coeff_contexts, last, last,
+      bwl, tx_class, dc_sign_ctx, coeff_costs);
+  if (last == 0) return cost;
+  cost += coeff_cost_scalar(qcoeff, levels, scan, coeff_contexts, 0, last,
+      bwl, tx_class, dc_sign_ctx, coeff_costs);
+
+  for (c = 1; c + 8 <= last; c += 8) {
+    const __m256i pos =
+        _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)(scan + c)));
+    const __m256i v = _mm256_i32gather_epi32(qcoeff, pos, 4);
+    const __m256i level = _mm256_abs_epi32(v);
+    const __m256i ctx = _mm256_srai_epi32(_mm256_slli_epi32(
+        _mm256_i32gather_epi32((const int *)coeff_contexts, pos, 1), 24), 24);
+    const __m256i base_idx =
+        _mm256_add_epi32(_mm256_slli_epi32(ctx, 2), _mm256_min_epi32(level, three));
+    sum = _mm256_add_epi32(sum, _mm256_i32gather_epi32(
+        &coeff_costs->base_cost[0][0], base_idx, 4));
+    sum = _mm256_add_epi32(sum,
+        _mm256_and_si256(_mm256_cmpgt_epi32(level, zero), sign_cost));
+
+    const __m256i br_mask = _mm256_cmpgt_epi32(level, two);
+    if (_mm256_movemask_epi8(br_mask)) {
+      const __m256i row = _mm256_srl_epi32(pos, bwl_shift);
+      const __m256i col = _mm256_sub_epi32(pos, _mm256_sll_epi32(row, bwl_shift));
+      const __m256i lpos = _mm256_add_epi32(pos, _mm256_slli_epi32(row, 2));
+      __m256i mag = gather_levels(levels, _mm256_add_epi32(lpos, one));
+      mag = _mm256_add_epi32(mag,
+          gather_levels(levels, _mm256_add_epi32(lpos, _mm256_set1_epi32(stride))));
+      mag = _mm256_add_epi32(mag,
+          gather_levels(levels, _mm256_add_epi32(lpos, _mm256_set1_epi32(third_offset))));
+      mag = _mm256_min_epi32(_mm256_srli_epi32(_mm256_add_epi32(mag, one), 1), six);
+      __m256i near_dc;
+      if (tx_class == TX_CLASS_2D)
+        near_dc = _mm256_and_si256(_mm256_cmpgt_epi32(two, row),
+                                   _mm256_cmpgt_epi32(two, col));
+      else if (tx_class == TX_CLASS_HORIZ)
+        near_dc = _mm256_cmpeq_epi32(col, zero);
+      else
+        near_dc = _mm256_cmpeq_epi32(row, zero);
+      const __m256i br_ctx = _mm256_add_epi32(mag,
+          _mm256_sub_epi32(fourteen, _mm256_and_si256(near_dc, seven)));
+      const __m256i br_idx = _mm256_add_epi32(
+          _mm256_mullo_epi32(br_ctx, lps_stride),
+          _mm256_min_epi32(_mm256_sub_epi32(level, three), range));
+      sum = _mm256_add_epi32(sum, _mm256_mask_i32gather_epi32(zero,
+          &coeff_costs->lps_cost[0][0], br_idx, br_mask, 4));
+
+      if (_mm256_movemask_epi8(_mm256_cmpgt_epi32(level, golomb_min))) {
+        DECLARE_ALIGNED(32, int32_t, lvl[8]);
+        _mm256_store_si256((__m256i *)lvl, level);
+        for (int32_t i = 0; i < 8; i++) cost += get_golomb_cost_scalar(lvl[i]);
+      }
+    }
+  }
+  for (; c < last; c++)
+    cost += coeff_cost_scalar(qcoeff, levels, scan, coeff_contexts, c, last,
+        bwl, tx_class, dc_sign_ctx, coeff_costs);
+
+  const __m128i sum128 = _mm_add_epi32(_mm256_castsi256_si128(sum),
+                                       _mm256_extracti128_si256(sum, 1));
+  const __m128i sum64 = _mm_add_epi32(sum128, _mm_srli_si128(sum128, 8));
+  return cost + _mm_cvtsi128_si32(_mm_add_epi32(sum64, _mm_srli_si128(sum64, 4)));
+}
@@ -1213,13 +1213,40 @@ static INLINE void iadst8_col_avx2(__m256i *in, __m256i *out, int8_t cos_bit) {
     out[7] = _mm256_sign_epi32(tmp[1], negative);
 }
 
+static void highbd_inv_txfm2d_add_no_identity_avx2(const int32_t *input,
+    uint16_t *output, int32_t stride,
+    TxType tx_type,
+    TxSize tx_size, int32_t eob,
+    const int32_t bd);
+
+// Tells whether the eob leaves a square block of the 2D types within the
+// reduced kernels of the no identity path (DC only for 8x8, low8 and low16
+// for 16x16 and 32x32), which then also skips the all zero row groups
+static INLINE int32_t highbd_inv_txfm_is_reduced(TxType tx_type, TxSize tx_size,
+    int32_t eob) {
+    int32_t eobx, eoby;
+    if (tx_type >= IDTX || eob == 0)
+        return 0;
+    if (eob == 1)
+        return 1;
+    get_eobx_eoby_scan_default(&eobx, &eoby, tx_size, eob);
+    return lowbd_txfm_all_1d_zeros_idx[AOMMIN(eobx, eoby)] <
+        lowbd_txfm_all_1d_zeros_idx[AOMMIN(tx_size_wide[tx_size], 32) - 1];
+}
+
 void av1_inv_txfm2d_add_8x8_avx2(const int32_t *coeff, uint16_t *output,
-    int32_t stride, TxType tx_type, int32_t bd) {
+    int32_t stride, TxType tx_type, TxSize tx_size, int32_t eob, int32_t bd) {
     __m256i in[8], out[8];
     const int8_t *shift = inv_txfm_shift_ls[TX_8X8];
     const int32_t txw_idx = get_txw_idx(TX_8X8);
     const int32_t txh_idx = get_txh_idx(TX_8X8);
 
+    if (highbd_inv_txfm_is_reduced(tx_type, TX_8X8, eob)) {
+        highbd_inv_txfm2d_add_no_identity_avx2(coeff, output, stride, tx_type,
+            TX_8X8, eob, bd);
+        return;
+    }
+
     switch (tx_type) {
     case IDTX:
         load_buffer_8x8(coeff, in);
@@ -1286,7 +1313,7 @@ void av1_inv_txfm2d_add_8x8_avx2(const int32_t *coeff, uint16_t *output,
         write_buffer_8x8(out, output, stride, 1, 0, bd);
         break;
     default:
-        av1_inv_txfm2d_add_8x8_sse4_1(coeff, output, stride, tx_type, bd);
+        av1_inv_txfm2d_add_8x8_sse4_1(coeff, output, stride, tx_type, tx_size, eob, bd);
         break;
     }
 }
@@ -1731,12 +1758,18 @@ static INLINE void iadst16_col_avx2(__m256i *in, __m256i *out,
 }
 
 void av1_inv_txfm2d_add_16x16_avx2(const int32_t *coeff, uint16_t *output,
-    int32_t stride, TxType tx_type, int32_t bd) {
+    int32_t stride, TxType tx_type, TxSize tx_size, int32_t eob, int32_t bd) {
     __m256i in[32], out[32];
     const int8_t *shift = inv_txfm_shift_ls[TX_16X16];
     const int32_t txw_idx = get_txw_idx(TX_16X16);
     const int32_t txh_idx = get_txh_idx(TX_16X16);
 
+    if (highbd_inv_txfm_is_reduced(tx_type, TX_16X16, eob)) {
+        highbd_inv_txfm2d_add_no_identity_avx2(coeff, output, stride, tx_type,
+            TX_16X16, eob, bd);
+        return;
+    }
+
     switch (tx_type) {
     case IDTX:
         load_buffer_16x16(coeff, in);
@@ -1793,7 +1826,7 @@ void av1_inv_txfm2d_add_16x16_avx2(const int32_t *coeff, uint16_t *output,
         write_buffer_16x16(out, output, stride, 1, 0, bd);
         break;
     default:
-        av1_inv_txfm2d_add_16x16_sse4_1(coeff, output, stride, tx_type, bd);
+        av1_inv_txfm2d_add_16x16_sse4_1(coeff, output, stride, tx_type, tx_size, eob, bd);
         break;
     }
 }
@@ -2370,11 +2403,18 @@ static void idct32_avx2(__m256i *in, __m256i *out, int32_t bit) {
 }
 
 void av1_inv_txfm2d_add_32x32_avx2(const int32_t *coeff, uint16_t *output,
-    int32_t stride, TxType tx_type, int32_t bd) {
+    int32_t stride, TxType tx_type, TxSize tx_size, int32_t eob, int32_t bd) {
     __m256i in[128], out[128];
     const int8_t *shift = inv_txfm_shift_ls[TX_32X32];
     const int32_t txw_idx = get_txw_idx(TX_32X32);
     const int32_t txh_idx = get_txh_idx(TX_32X32);
+    (void)tx_size;
+
+    if (highbd_inv_txfm_is_reduced(tx_type, TX_32X32, eob)) {
+        highbd_inv_txfm2d_add_no_identity_avx2(coeff, output, stride, tx_type,
+            TX_32X32, eob, bd);
+        return;
+    }
 
     switch (tx_type) {
     case DCT_DCT:
@@ -6543,6 +6583,16 @@ void av1_highbd_inv_txfm2d_add_universe_avx2(const int32_t *input,
     default: break;
     }
 }
+// Only the top-left 32x32 coefficients are coded, the no identity path never
+// processes more and further reduces with the eob
+void av1_inv_txfm2d_add_64x64_avx2(const int32_t *input, uint16_t *output,
+    int32_t stride, TxType tx_type, TxSize tx_size, int32_t eob, int32_t bd) {
+    (void)tx_size;
+    assert(tx_type == DCT_DCT);
+    highbd_inv_txfm2d_add_no_identity_avx2(input, output, stride, tx_type,
+        TX_64X64, eob, bd);
+}
+
 void av1_highbd_inv_txfm_add_avx2(const int32_t *input, uint16_t *dest,
     int32_t stride, TxType tx_type, TxSize tx_size, int32_t eob, int32_t bd) {
     //assert(av1_ext_tx_used[txfm_param->tx_set_type][txfm_param->tx_type]);
@@ -214,10 +214,11 @@ static __m256i compute_p(__m256i sum1, __m256i sum2, int32_t bit_depth, int32_t
 
 // Assumes that C, D are integral images for the original buffer which has been
 // extended to have a padding of SGRPROJ_BORDER_VERT/SGRPROJ_BORDER_HORZ pixels
-// on the sides. A, B, C, D point at logical position (0, 0).
+// on the sides. A, B, C, D point at logical position (0, 0). C and D have
+// stride ii_stride, A and B have stride buf_stride.
 static void calc_ab(int32_t *A, int32_t *B, const int32_t *C, const int32_t *D,
-    int32_t width, int32_t height, int32_t buf_stride, int32_t bit_depth,
-    int32_t sgr_params_idx, int32_t radius_idx) {
+    int32_t width, int32_t height, int32_t buf_stride, int32_t ii_stride,
+    int32_t bit_depth, int32_t sgr_params_idx, int32_t radius_idx) {
     const sgr_params_type *const params = &sgr_params[sgr_params_idx];
     const int32_t r = params->r[radius_idx];
     const int32_t n = (2 * r + 1) * (2 * r + 1);
@@ -238,11 +239,11 @@ static void calc_ab(int32_t *A, int32_t *B, const int32_t *C, const int32_t *D,
 
     for (int32_t i = -1; i < height + 1; ++i) {
         for (int32_t j = -1; j < width + 1; j += 8) {
-            const int32_t *Cij = C + i * buf_stride + j;
-            const int32_t *Dij = D + i * buf_stride + j;
+            const int32_t *Cij = C + i * ii_stride + j;
+            const int32_t *Dij = D + i * ii_stride + j;
 
-            __m256i sum1 = boxsum_from_ii(Dij, buf_stride, r);
-            __m256i sum2 = boxsum_from_ii(Cij, buf_stride, r);
+            __m256i sum1 = boxsum_from_ii(Dij, ii_stride, r);
+            __m256i sum2 = boxsum_from_ii(Cij, ii_stride, r);
 
             // When width + 2 isn't a multiple of 8, sum1 and sum2 will contain
             // some uninitialised data in their upper words. We use a mask to
@@ -350,11 +351,12 @@ static void final_filter(int32_t *dst, int32_t dst_stride, const int32_t *A,
 
 // Assumes that C, D are integral images for the original buffer which has been
 // extended to have a padding of SGRPROJ_BORDER_VERT/SGRPROJ_BORDER_HORZ pixels
-// on the sides. A, B, C, D point at logical position (0, 0).
+// on the sides. A, B, C, D point at logical position (0, 0). C and D have
+// stride ii_stride, A and B have stride buf_stride.
 static void calc_ab_fast(int32_t *A, int32_t *B, const int32_t *C,
     const int32_t *D, int32_t width, int32_t height,
-    int32_t buf_stride, int32_t bit_depth, int32_t sgr_params_idx,
-    int32_t radius_idx) {
+    int32_t buf_stride, int32_t ii_stride, int32_t bit_depth,
+    int32_t sgr_params_idx, int32_t radius_idx) {
     const sgr_params_type *const params = &sgr_params[sgr_params_idx];
     const int32_t r = params->r[radius_idx];
     const int32_t n = (2 * r + 1) * (2 * r + 1);
@@ -375,11 +377,11 @@ static void calc_ab_fast(int32_t *A, int32_t *B, const int32_t *C,
 
     for (int32_t i = -1; i < height + 1; i += 2) {
         for (int32_t j = -1; j < width + 1; j += 8) {
-            const int32_t *Cij = C + i * buf_stride + j;
-            const int32_t *Dij = D + i * buf_stride + j;
+            const int32_t *Cij = C + i * ii_stride + j;
+            const int32_t *Dij = D + i * ii_stride + j;
 
-            __m256i sum1 = boxsum_from_ii(Dij, buf_stride, r);
-            __m256i sum2 = boxsum_from_ii(Cij, buf_stride, r);
+            __m256i sum1 = boxsum_from_ii(Dij, ii_stride, r);
+            __m256i sum2 = boxsum_from_ii(Cij, ii_stride, r);
 
             // When width + 2 isn't a multiple of 8, sum1 and sum2 will contain
             // some uninitialised data in their upper words. We use a mask to
@@ -615,15 +617,76 @@ void av1_selfguided_restoration_avx2(const uint8_t *dgd8, int32_t width, int32_t
     assert(params->r[1] < AOMMIN(SGRPROJ_BORDER_VERT, SGRPROJ_BORDER_HORZ));
 
     if (params->r[0] > 0) {
-        calc_ab_fast(A, B, C, D, width, height, buf_stride, bit_depth,
-            sgr_params_idx, 0);
+        calc_ab_fast(A, B, C, D, width, height, buf_stride, buf_stride,
+            bit_depth, sgr_params_idx, 0);
+        final_filter_fast(flt0, flt_stride, A, B, buf_stride, dgd8, dgd_stride,
+            width, height, highbd);
+    }
+
+    if (params->r[1] > 0) {
+        calc_ab(A, B, C, D, width, height, buf_stride, buf_stride, bit_depth,
+            sgr_params_idx, 1);
+        final_filter(flt1, flt_stride, A, B, buf_stride, dgd8, dgd_stride, width,
+            height, highbd);
+    }
+}
+
+void av1_selfguided_integral_images_avx2(const uint8_t *dgd8, int32_t width,
+    int32_t height, int32_t dgd_stride, int32_t *ii_sum, int32_t *ii_sq,
+    int32_t ii_stride, int32_t highbd) {
+    const int32_t width_ext = width + 2 * SGRPROJ_BORDER_HORZ;
+    const int32_t height_ext = height + 2 * SGRPROJ_BORDER_VERT;
+    const int32_t dgd_diag_border =
+        SGRPROJ_BORDER_HORZ + dgd_stride * SGRPROJ_BORDER_VERT;
+    const uint8_t *dgd0 = dgd8 - dgd_diag_border;
+
+    assert(!((uintptr_t)(ii_sum + 1) & 31) && !((uintptr_t)(ii_sq + 1) & 31));
+    assert(!(ii_stride & 7));
+
+    // The images can exceed 2^31 over a whole restoration unit; the adds wrap,
+    // which leaves every box sum taken from them exact.
+    if (highbd)
+        integral_images_highbd(CONVERT_TO_SHORTPTR(dgd0), dgd_stride, width_ext,
+            height_ext, ii_sq, ii_sum, ii_stride);
+    else
+        integral_images(dgd0, dgd_stride, width_ext, height_ext, ii_sq, ii_sum,
+            ii_stride);
+}
+
+void av1_selfguided_restoration_from_ii_avx2(const uint8_t *dgd8, int32_t width,
+    int32_t height, int32_t dgd_stride, const int32_t *ii_sum,
+    const int32_t *ii_sq, int32_t ii_stride, int32_t *flt0, int32_t *flt1,
+    int32_t flt_stride, int32_t sgr_params_idx, int32_t bit_depth,
+    int32_t highbd) {
+    const int32_t buf_elts = ALIGN_POWER_OF_TWO(RESTORATION_PROC_UNIT_PELS, 3);
+
+    DECLARE_ALIGNED(32, int32_t,
+    buf[2 * ALIGN_POWER_OF_TWO(RESTORATION_PROC_UNIT_PELS, 3)]);
+    memset(buf, 0, sizeof(buf));
+
+    const int32_t width_ext = width + 2 * SGRPROJ_BORDER_HORZ;
+    int32_t buf_stride = ALIGN_POWER_OF_TWO(width_ext + 16, 3);
+    const int32_t buf_diag_border =
+        SGRPROJ_BORDER_HORZ + buf_stride * SGRPROJ_BORDER_VERT;
+
+    // Same layout as in av1_selfguided_restoration_avx2; only A and B are
+    // local, the integral images come from the caller.
+    int32_t *A = buf + 0 * buf_elts + 7 + 1 + buf_stride + buf_diag_border;
+    int32_t *B = buf + 1 * buf_elts + 7 + 1 + buf_stride + buf_diag_border;
+
+    const sgr_params_type *const params = &sgr_params[sgr_params_idx];
+    assert(!(params->r[0] == 0 && params->r[1] == 0));
+
+    if (params->r[0] > 0) {
+        calc_ab_fast(A, B, ii_sq, ii_sum, width, height, buf_stride, ii_stride,
+            bit_depth, sgr_params_idx, 0);
         final_filter_fast(flt0, flt_stride, A, B, buf_stride, dgd8, dgd_stride,
             width, height, highbd);
     }
 
     if (params->r[1] > 0) {
-        calc_ab(A, B, C, D, width, height, buf_stride, bit_depth, sgr_params_idx,
-            1);
+        calc_ab(A, B, ii_sq, ii_sum, width, height, buf_stride, ii_stride,
+            bit_depth, sgr_params_idx, 1);
         final_filter(flt1, flt_stride, A, B, buf_stride, dgd8, dgd_stride, width,
             height, highbd);
     }
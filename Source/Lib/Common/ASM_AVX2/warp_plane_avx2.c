@@ -0,0 +1,113 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+/*
+* Copyright (c) 2019, Alliance for Open Media. All rights reserved
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at www.aomedia.org/license/software. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+*/
+
+#include <immintrin.h>
+
+#include "EbDefinitions.h"
+#include "aom_dsp_rtcd.h"
+#include "EbWarpedMotion.h"
+
+static INLINE int64_t hadd_epi32_to_64(const __m256i sum) {
+    const __m256i sum64 = _mm256_add_epi64(
+        _mm256_cvtepi32_epi64(_mm256_castsi256_si128(sum)),
+        _mm256_cvtepi32_epi64(_mm256_extracti128_si256(sum, 1)));
+    const __m128i sum128 = _mm_add_epi64(_mm256_castsi256_si128(sum64),
+                                         _mm256_extracti128_si256(sum64, 1));
+    return _mm_cvtsi128_si64(_mm_add_epi64(sum128, _mm_srli_si128(sum128, 8)));
+}
+
+int64_t av1_calc_frame_error_avx2(const uint8_t *const ref, int stride,
+                                  const uint8_t *const dst, int p_width,
+                                  int p_height, int p_stride) {
+    const __m256i lut_center = _mm256_set1_epi32(255);
+    int64_t sum_error = 0;
+
+    for (int i = 0; i < p_height; ++i) {
+        const uint8_t *const ref_row = ref + i * stride;
+        const uint8_t *const dst_row = dst + i * p_stride;
+        // A row of 8 lanes stays far from 32 bit overflow (16384 per pixel)
+        __m256i row_error = _mm256_setzero_si256();
+        int j = 0;
+
+        for (; j + 16 <= p_width; j += 16) {
+            const __m128i r = _mm_loadu_si128((const __m128i *)(ref_row + j));
+            const __m128i d = _mm_loadu_si128((const __m128i *)(dst_row + j));
+            const __m256i diff_lo = _mm256_sub_epi32(_mm256_cvtepu8_epi32(d),
+                                                     _mm256_cvtepu8_epi32(r));
+            const __m256i diff_hi = _mm256_sub_epi32(
+                _mm256_cvtepu8_epi32(_mm_srli_si128(d, 8)),
+                _mm256_cvtepu8_epi32(_mm_srli_si128(r, 8)));
+            row_error = _mm256_add_epi32(row_error, _mm256_i32gather_epi32(
+                error_measure_lut, _mm256_add_epi32(diff_lo, lut_center), 4));
+            row_error = _mm256_add_epi32(row_error, _mm256_i32gather_epi32(
+                error_measure_lut, _mm256_add_epi32(diff_hi, lut_center), 4));
+        }
+        for (; j + 8 <= p_width; j += 8) {
+            const __m256i diff = _mm256_sub_epi32(
+                _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(dst_row + j))),
+                _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(ref_row + j))));
+            row_error = _mm256_add_epi32(row_error, _mm256_i32gather_epi32(
+                error_measure_lut, _mm256_add_epi32(diff, lut_center), 4));
+        }
+        sum_error += hadd_epi32_to_64(row_error);
+        for (; j < p_width; ++j)
+            sum_error += error_measure_lut[255 + dst_row[j] - ref_row[j]];
+    }
+    return sum_error;
+}
+
+int64_t av1_calc_highbd_frame_error_avx2(const uint16_t *const ref, int stride,
+                                         const uint16_t *const dst, int p_width,
+                                         int p_height, int p_stride, int bd) {
+    const int b = bd - 8;
+    const int bmask = (1 << b) - 1;
+    const int v = (1 << b);
+    const __m128i shift = _mm_cvtsi32_si128(b);
+    const __m256i mask = _mm256_set1_epi32(bmask);
+    const __m256i weight = _mm256_set1_epi32(v);
+    int64_t sum_error = 0;
+
+    for (int i = 0; i < p_height; ++i) {
+        const uint16_t *const ref_row = ref + i * stride;
+        const uint16_t *const dst_row = dst + i * p_stride;
+        // Each pixel contributes at most 16384 << b, which keeps a row of
+        // 8 lanes within 32 bits for any supported frame width
+        __m256i row_error = _mm256_setzero_si256();
+        int j = 0;
+
+        for (; j + 8 <= p_width; j += 8) {
+            const __m256i err = _mm256_abs_epi32(_mm256_sub_epi32(
+                _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)(dst_row + j))),
+                _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)(ref_row + j)))));
+            const __m256i e1 = _mm256_srl_epi32(err, shift);
+            const __m256i e2 = _mm256_and_si256(err, mask);
+            const __m256i lut_0 = _mm256_i32gather_epi32(error_measure_lut + 255, e1, 4);
+            const __m256i lut_1 = _mm256_i32gather_epi32(error_measure_lut + 256, e1, 4);
+            row_error = _mm256_add_epi32(row_error, _mm256_add_epi32(
+                _mm256_mullo_epi32(lut_0, _mm256_sub_epi32(weight, e2)),
+                _mm256_mullo_epi32(lut_1, e2)));
+        }
+        sum_error += hadd_epi32_to_64(row_error);
+        for (; j < p_width; ++j) {
+            const int err = abs(dst_row[j] - ref_row[j]);
+            const int e1 = err >> b;
+            const int e2 = err & bmask;
+            sum_error += error_measure_lut[255 + e1] * (v - e2) +
+                         error_measure_lut[256 + e1] * e2;
+        }
+    }
+    return sum_error;
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2016, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <emmintrin.h>
+
+#include "EbDefinitions.h"
+#include "aom_dsp_rtcd.h"
+
+static INLINE uint32_t hadd_epi32_sse2(__m128i v) {
+    v = _mm_add_epi32(v, _mm_srli_si128(v, 8));
+    v = _mm_add_epi32(v, _mm_srli_si128(v, 4));
+    return (uint32_t)_mm_cvtsi128_si32(v);
+}
+
+void aom_ssim_parms_8x8_sse2(const uint8_t *s, int32_t sp, const uint8_t *r,
+    int32_t rp, uint32_t *sum_s, uint32_t *sum_r, uint32_t *sum_sq_s,
+    uint32_t *sum_sq_r, uint32_t *sum_sxr) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi16(1);
+    __m128i s_sum = zero, r_sum = zero;
+    __m128i ss_sum = zero, rr_sum = zero, sr_sum = zero;
+
+    // 8 rows of at most 255 fit the 16-bit lanes of the plain sums
+    for (int32_t i = 0; i < 8; i++, s += sp, r += rp) {
+        const __m128i s16 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)s), zero);
+        const __m128i r16 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)r), zero);
+        s_sum = _mm_add_epi16(s_sum, s16);
+        r_sum = _mm_add_epi16(r_sum, r16);
+        ss_sum = _mm_add_epi32(ss_sum, _mm_madd_epi16(s16, s16));
+        rr_sum = _mm_add_epi32(rr_sum, _mm_madd_epi16(r16, r16));
+        sr_sum = _mm_add_epi32(sr_sum, _mm_madd_epi16(s16, r16));
+    }
+
+    *sum_s += hadd_epi32_sse2(_mm_madd_epi16(s_sum, one));
+    *sum_r += hadd_epi32_sse2(_mm_madd_epi16(r_sum, one));
+    *sum_sq_s += hadd_epi32_sse2(ss_sum);
+    *sum_sq_r += hadd_epi32_sse2(rr_sum);
+    *sum_sxr += hadd_epi32_sse2(sr_sum);
+}
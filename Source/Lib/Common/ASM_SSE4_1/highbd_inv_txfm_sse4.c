@@ -893,8 +893,10 @@ static void write_buffer_8x8(__m128i *in, uint16_t *output, int32_t stride,
 }
 
 void av1_inv_txfm2d_add_8x8_sse4_1(const int32_t *coeff, uint16_t *output,
-    int32_t stride, TxType tx_type, int32_t bd) {
+    int32_t stride, TxType tx_type, TxSize tx_size, int32_t eob, int32_t bd) {
     __m128i in[16], out[16];
+    (void)tx_size;
+    (void)eob;
     const int8_t *shift = inv_txfm_shift_ls[TX_8X8];
     const int32_t txw_idx = get_txw_idx(TX_8X8);
     const int32_t txh_idx = get_txh_idx(TX_8X8);
@@ -1625,8 +1627,10 @@ static void round_shift_16x16(__m128i *in, int32_t shift) {
 }
 
 void av1_inv_txfm2d_add_16x16_sse4_1(const int32_t *coeff, uint16_t *output,
-    int32_t stride, TxType tx_type, int32_t bd) {
+    int32_t stride, TxType tx_type, TxSize tx_size, int32_t eob, int32_t bd) {
     __m128i in[64], out[64];
+    (void)tx_size;
+    (void)eob;
     const int8_t *shift = inv_txfm_shift_ls[TX_16X16];
     const int32_t txw_idx = get_txw_idx(TX_16X16);
     const int32_t txh_idx = get_txh_idx(TX_16X16);
@@ -2323,7 +2327,7 @@ static void idct64x64_sse4_1(__m128i *in, __m128i *out, int32_t bit, int32_t do_
 }
 
 void av1_inv_txfm2d_add_64x64_sse4_1(const int32_t *coeff, uint16_t *output,
-    int32_t stride, TxType tx_type, int32_t bd) {
+    int32_t stride, TxType tx_type, TxSize tx_size, int32_t eob, int32_t bd) {
     __m128i in[64 * 64 / 4], out[64 * 64 / 4];
     const int8_t *shift = inv_txfm_shift_ls[TX_64X64];
     const int32_t txw_idx = tx_size_wide_log2[TX_64X64] - tx_size_wide_log2[0];
@@ -2342,7 +2346,7 @@ void av1_inv_txfm2d_add_64x64_sse4_1(const int32_t *coeff, uint16_t *output,
         break;
 
     default:
-        av1_inv_txfm2d_add_64x64_c(coeff, output, stride, tx_type, bd);
+        av1_inv_txfm2d_add_64x64_c(coeff, output, stride, tx_type, tx_size, eob, bd);
         break;
     }
 }
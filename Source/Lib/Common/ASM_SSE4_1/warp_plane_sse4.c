@@ -0,0 +1,423 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+/*
+* Copyright (c) 2017, Alliance for Open Media. All rights reserved
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at www.aomedia.org/license/software. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+*/
+
+#include <assert.h>
+#include <string.h>
+#include <smmintrin.h> /* SSE4.1 */
+
+#include "EbDefinitions.h"
+#include "aom_dsp_rtcd.h"
+#include "EbWarpedMotion.h"
+
+/* The kernels below follow av1_warp_affine_c / av1_highbd_warp_affine_c
+   exactly: the horizontal pass produces 15 rows of 8 values per 8x8 block,
+   each row stored in the column order 0, 2, 4, 6, 1, 3, 5, 7 so that the
+   vertical pass can pair consecutive rows with a single unpack, then the
+   vertical pass produces up to 8x8 output pixels.
+
+   The filter phases are selected with the rounding and the table offset
+   folded into sx4 / sy4, i.e. (sx >> WARPEDDIFF_PREC_BITS) equals
+   ROUND_POWER_OF_TWO(sx_c, WARPEDDIFF_PREC_BITS) + WARPEDPIXEL_PREC_SHIFTS
+   of the C code. */
+
+// Transposes the 8 filters selected by s, s + step, ..., s + 7 * step so that
+// coeff[2n] / coeff[2n + 1] hold taps (2n, 2n + 1) of the even / odd columns
+static INLINE void prepare_warp_coeffs(const int s, const int step,
+                                       __m128i *coeff) {
+    const __m128i tmp_0 = _mm_loadu_si128(
+        (const __m128i *)warped_filter[(s + 0 * step) >> WARPEDDIFF_PREC_BITS]);
+    const __m128i tmp_1 = _mm_loadu_si128(
+        (const __m128i *)warped_filter[(s + 1 * step) >> WARPEDDIFF_PREC_BITS]);
+    const __m128i tmp_2 = _mm_loadu_si128(
+        (const __m128i *)warped_filter[(s + 2 * step) >> WARPEDDIFF_PREC_BITS]);
+    const __m128i tmp_3 = _mm_loadu_si128(
+        (const __m128i *)warped_filter[(s + 3 * step) >> WARPEDDIFF_PREC_BITS]);
+    const __m128i tmp_4 = _mm_loadu_si128(
+        (const __m128i *)warped_filter[(s + 4 * step) >> WARPEDDIFF_PREC_BITS]);
+    const __m128i tmp_5 = _mm_loadu_si128(
+        (const __m128i *)warped_filter[(s + 5 * step) >> WARPEDDIFF_PREC_BITS]);
+    const __m128i tmp_6 = _mm_loadu_si128(
+        (const __m128i *)warped_filter[(s + 6 * step) >> WARPEDDIFF_PREC_BITS]);
+    const __m128i tmp_7 = _mm_loadu_si128(
+        (const __m128i *)warped_filter[(s + 7 * step) >> WARPEDDIFF_PREC_BITS]);
+
+    // coeffs 0 1 0 1 2 3 2 3 for columns 0, 2 (resp. 1, 3)
+    const __m128i tmp_8 = _mm_unpacklo_epi32(tmp_0, tmp_2);
+    const __m128i tmp_9 = _mm_unpacklo_epi32(tmp_1, tmp_3);
+    // coeffs 0 1 0 1 2 3 2 3 for columns 4, 6 (resp. 5, 7)
+    const __m128i tmp_10 = _mm_unpacklo_epi32(tmp_4, tmp_6);
+    const __m128i tmp_11 = _mm_unpacklo_epi32(tmp_5, tmp_7);
+    // coeffs 4 5 4 5 6 7 6 7 for columns 0, 2 (resp. 1, 3)
+    const __m128i tmp_12 = _mm_unpackhi_epi32(tmp_0, tmp_2);
+    const __m128i tmp_13 = _mm_unpackhi_epi32(tmp_1, tmp_3);
+    // coeffs 4 5 4 5 6 7 6 7 for columns 4, 6 (resp. 5, 7)
+    const __m128i tmp_14 = _mm_unpackhi_epi32(tmp_4, tmp_6);
+    const __m128i tmp_15 = _mm_unpackhi_epi32(tmp_5, tmp_7);
+
+    coeff[0] = _mm_unpacklo_epi64(tmp_8, tmp_10);
+    coeff[2] = _mm_unpackhi_epi64(tmp_8, tmp_10);
+    coeff[4] = _mm_unpacklo_epi64(tmp_12, tmp_14);
+    coeff[6] = _mm_unpackhi_epi64(tmp_12, tmp_14);
+    coeff[1] = _mm_unpacklo_epi64(tmp_9, tmp_11);
+    coeff[3] = _mm_unpackhi_epi64(tmp_9, tmp_11);
+    coeff[5] = _mm_unpacklo_epi64(tmp_13, tmp_15);
+    coeff[7] = _mm_unpackhi_epi64(tmp_13, tmp_15);
+}
+
+// src holds the pixels ix4 - 7 .. ix4 and src2 the pixels ix4 + 1 .. ix4 + 8
+static INLINE __m128i warp_horizontal_filter(const __m128i src,
+                                             const __m128i src2,
+                                             const __m128i *coeff,
+                                             const __m128i round_const,
+                                             const __m128i shift) {
+    const __m128i res_0 = _mm_madd_epi16(src, coeff[0]);
+    const __m128i res_2 = _mm_madd_epi16(_mm_alignr_epi8(src2, src, 4), coeff[2]);
+    const __m128i res_4 = _mm_madd_epi16(_mm_alignr_epi8(src2, src, 8), coeff[4]);
+    const __m128i res_6 = _mm_madd_epi16(_mm_alignr_epi8(src2, src, 12), coeff[6]);
+    const __m128i res_1 = _mm_madd_epi16(_mm_alignr_epi8(src2, src, 2), coeff[1]);
+    const __m128i res_3 = _mm_madd_epi16(_mm_alignr_epi8(src2, src, 6), coeff[3]);
+    const __m128i res_5 = _mm_madd_epi16(_mm_alignr_epi8(src2, src, 10), coeff[5]);
+    const __m128i res_7 = _mm_madd_epi16(_mm_alignr_epi8(src2, src, 14), coeff[7]);
+
+    __m128i res_even = _mm_add_epi32(_mm_add_epi32(res_0, res_4),
+                                     _mm_add_epi32(res_2, res_6));
+    __m128i res_odd = _mm_add_epi32(_mm_add_epi32(res_1, res_5),
+                                    _mm_add_epi32(res_3, res_7));
+    res_even = _mm_sra_epi32(_mm_add_epi32(res_even, round_const), shift);
+    res_odd = _mm_sra_epi32(_mm_add_epi32(res_odd, round_const), shift);
+
+    // The horizontal output fits in bd + FILTER_BITS + 1 - reduce_bits_horiz
+    // <= 15 bits, so the saturating pack is lossless
+    return _mm_packs_epi32(res_even, res_odd);
+}
+
+// Filters the rows tmp[0] .. tmp[7] vertically, returning the rounded sums of
+// the columns 0 .. 3 in res_lo and 4 .. 7 in res_hi
+static INLINE void warp_vertical_filter(const __m128i *tmp, const int sy,
+                                        const int gamma,
+                                        const __m128i round_const,
+                                        const __m128i shift, __m128i *res_lo,
+                                        __m128i *res_hi) {
+    __m128i coeff[8];
+    prepare_warp_coeffs(sy, gamma, coeff);
+
+    // Pairs of consecutive rows in the column order 0 0 2 2 4 4 6 6 and
+    // 1 1 3 3 5 5 7 7
+    const __m128i src_0 = _mm_unpacklo_epi16(tmp[0], tmp[1]);
+    const __m128i src_2 = _mm_unpacklo_epi16(tmp[2], tmp[3]);
+    const __m128i src_4 = _mm_unpacklo_epi16(tmp[4], tmp[5]);
+    const __m128i src_6 = _mm_unpacklo_epi16(tmp[6], tmp[7]);
+    const __m128i src_1 = _mm_unpackhi_epi16(tmp[0], tmp[1]);
+    const __m128i src_3 = _mm_unpackhi_epi16(tmp[2], tmp[3]);
+    const __m128i src_5 = _mm_unpackhi_epi16(tmp[4], tmp[5]);
+    const __m128i src_7 = _mm_unpackhi_epi16(tmp[6], tmp[7]);
+
+    const __m128i res_even = _mm_add_epi32(
+        _mm_add_epi32(_mm_madd_epi16(src_0, coeff[0]), _mm_madd_epi16(src_2, coeff[2])),
+        _mm_add_epi32(_mm_madd_epi16(src_4, coeff[4]), _mm_madd_epi16(src_6, coeff[6])));
+    const __m128i res_odd = _mm_add_epi32(
+        _mm_add_epi32(_mm_madd_epi16(src_1, coeff[1]), _mm_madd_epi16(src_3, coeff[3])),
+        _mm_add_epi32(_mm_madd_epi16(src_5, coeff[5]), _mm_madd_epi16(src_7, coeff[7])));
+
+    // Rearrange the columns back into the order 0 .. 7
+    *res_lo = _mm_sra_epi32(
+        _mm_add_epi32(_mm_unpacklo_epi32(res_even, res_odd), round_const), shift);
+    *res_hi = _mm_sra_epi32(
+        _mm_add_epi32(_mm_unpackhi_epi32(res_even, res_odd), round_const), shift);
+}
+
+static INLINE __m128i load_u16_n(const uint16_t *src, const int n) {
+    if (n == 8)
+        return _mm_loadu_si128((const __m128i *)src);
+    uint16_t buf[8] = { 0 };
+    memcpy(buf, src, n * sizeof(*src));
+    return _mm_loadu_si128((const __m128i *)buf);
+}
+
+static INLINE void store_u16_n(uint16_t *dst, const __m128i val, const int n) {
+    if (n == 8) {
+        _mm_storeu_si128((__m128i *)dst, val);
+        return;
+    }
+    uint16_t buf[8];
+    _mm_storeu_si128((__m128i *)buf, val);
+    memcpy(dst, buf, n * sizeof(*dst));
+}
+
+static INLINE void store_u8_n(uint8_t *dst, const __m128i val, const int n) {
+    if (n == 8) {
+        _mm_storel_epi64((__m128i *)dst, val);
+        return;
+    }
+    uint8_t buf[16];
+    _mm_storeu_si128((__m128i *)buf, val);
+    memcpy(dst, buf, n);
+}
+
+// Blends the vertical output with the first prediction held in the compound
+// buffer and removes the intermediate offsets, before the final clipping
+static INLINE void warp_compound_average(const ConvolveParams *conv_params,
+                                         const CONV_BUF_TYPE *dst, const int n,
+                                         const int offset_bits,
+                                         __m128i *res_lo, __m128i *res_hi) {
+    const int round_bits =
+        2 * FILTER_BITS - conv_params->round_0 - conv_params->round_1;
+    const __m128i offset = _mm_set1_epi32(
+        (1 << (offset_bits - conv_params->round_1)) +
+        (1 << (offset_bits - conv_params->round_1 - 1)));
+    const __m128i round_const = _mm_set1_epi32((1 << round_bits) >> 1);
+    const __m128i round_shift = _mm_cvtsi32_si128(round_bits);
+    const __m128i first = load_u16_n(dst, n);
+    __m128i first_lo = _mm_cvtepu16_epi32(first);
+    __m128i first_hi = _mm_cvtepu16_epi32(_mm_srli_si128(first, 8));
+
+    if (conv_params->use_jnt_comp_avg) {
+        const __m128i fwd = _mm_set1_epi32(conv_params->fwd_offset);
+        const __m128i bck = _mm_set1_epi32(conv_params->bck_offset);
+        first_lo = _mm_srai_epi32(_mm_add_epi32(_mm_mullo_epi32(first_lo, fwd),
+            _mm_mullo_epi32(*res_lo, bck)), DIST_PRECISION_BITS);
+        first_hi = _mm_srai_epi32(_mm_add_epi32(_mm_mullo_epi32(first_hi, fwd),
+            _mm_mullo_epi32(*res_hi, bck)), DIST_PRECISION_BITS);
+    }
+    else {
+        first_lo = _mm_srai_epi32(_mm_add_epi32(first_lo, *res_lo), 1);
+        first_hi = _mm_srai_epi32(_mm_add_epi32(first_hi, *res_hi), 1);
+    }
+
+    first_lo = _mm_add_epi32(_mm_sub_epi32(first_lo, offset), round_const);
+    first_hi = _mm_add_epi32(_mm_sub_epi32(first_hi, offset), round_const);
+    *res_lo = _mm_sra_epi32(first_lo, round_shift);
+    *res_hi = _mm_sra_epi32(first_hi, round_shift);
+}
+
+void av1_warp_affine_sse4_1(const int32_t *mat, const uint8_t *ref, int width,
+                            int height, int stride, uint8_t *pred, int p_col,
+                            int p_row, int p_width, int p_height, int p_stride,
+                            int subsampling_x, int subsampling_y,
+                            ConvolveParams *conv_params, int16_t alpha,
+                            int16_t beta, int16_t gamma, int16_t delta) {
+    __m128i tmp[15];
+    const int bd = 8;
+    const int reduce_bits_horiz = conv_params->round_0;
+    const int reduce_bits_vert = conv_params->is_compound
+                                     ? conv_params->round_1
+                                     : 2 * FILTER_BITS - reduce_bits_horiz;
+    const int offset_bits_horiz = bd + FILTER_BITS - 1;
+    const int offset_bits_vert = bd + 2 * FILTER_BITS - reduce_bits_horiz;
+    const int offset_bits = bd + 2 * FILTER_BITS - conv_params->round_0;
+    const __m128i round_const_horiz = _mm_set1_epi32(
+        (1 << offset_bits_horiz) + ((1 << reduce_bits_horiz) >> 1));
+    const __m128i shift_horiz = _mm_cvtsi32_si128(reduce_bits_horiz);
+    const __m128i round_const_vert = _mm_set1_epi32(
+        (1 << offset_bits_vert) + ((1 << reduce_bits_vert) >> 1));
+    const __m128i shift_vert = _mm_cvtsi32_si128(reduce_bits_vert);
+    const __m128i pixel_offset = _mm_set1_epi32((1 << (bd - 1)) + (1 << bd));
+    const __m128i zero = _mm_setzero_si128();
+    assert(IMPLIES(conv_params->is_compound, conv_params->dst != NULL));
+    assert(IMPLIES(conv_params->do_average, conv_params->is_compound));
+
+    for (int i = p_row; i < p_row + p_height; i += 8) {
+        for (int j = p_col; j < p_col + p_width; j += 8) {
+            const int32_t src_x = (j + 4) << subsampling_x;
+            const int32_t src_y = (i + 4) << subsampling_y;
+            const int32_t dst_x = mat[2] * src_x + mat[3] * src_y + mat[0];
+            const int32_t dst_y = mat[4] * src_x + mat[5] * src_y + mat[1];
+            const int32_t x4 = dst_x >> subsampling_x;
+            const int32_t y4 = dst_y >> subsampling_y;
+
+            const int32_t ix4 = x4 >> WARPEDMODEL_PREC_BITS;
+            int32_t sx4 = x4 & ((1 << WARPEDMODEL_PREC_BITS) - 1);
+            const int32_t iy4 = y4 >> WARPEDMODEL_PREC_BITS;
+            int32_t sy4 = y4 & ((1 << WARPEDMODEL_PREC_BITS) - 1);
+
+            sx4 += alpha * (-4) + beta * (-4) +
+                   (1 << (WARPEDDIFF_PREC_BITS - 1)) +
+                   (WARPEDPIXEL_PREC_SHIFTS << WARPEDDIFF_PREC_BITS);
+            sy4 += gamma * (-4) + delta * (-4) +
+                   (1 << (WARPEDDIFF_PREC_BITS - 1)) +
+                   (WARPEDPIXEL_PREC_SHIFTS << WARPEDDIFF_PREC_BITS);
+
+            sx4 &= ~((1 << WARP_PARAM_REDUCE_BITS) - 1);
+            sy4 &= ~((1 << WARP_PARAM_REDUCE_BITS) - 1);
+
+            // Horizontal filter
+            for (int k = -7; k < 8; ++k) {
+                // Clamp to top/bottom edge of the frame
+                const int iy = clamp(iy4 + k, 0, height - 1);
+                const uint8_t *const row = ref + iy * stride;
+                __m128i coeff[8];
+                __m128i pixels;
+
+                if (ix4 - 7 >= 0 && ix4 + 8 < width)
+                    pixels = _mm_loadu_si128((const __m128i *)(row + ix4 - 7));
+                else {
+                    // Clamp to left/right edge of the frame
+                    uint8_t buf[16];
+                    for (int m = 0; m < 16; ++m)
+                        buf[m] = row[clamp(ix4 - 7 + m, 0, width - 1)];
+                    pixels = _mm_loadu_si128((const __m128i *)buf);
+                }
+
+                prepare_warp_coeffs(sx4 + beta * (k + 4), alpha, coeff);
+                tmp[k + 7] = warp_horizontal_filter(
+                    _mm_unpacklo_epi8(pixels, zero),
+                    _mm_unpackhi_epi8(pixels, zero), coeff, round_const_horiz,
+                    shift_horiz);
+            }
+
+            // Vertical filter
+            const int n = AOMMIN(8, p_col + p_width - j);
+            for (int k = -4; k < AOMMIN(4, p_row + p_height - i - 4); ++k) {
+                __m128i res_lo, res_hi;
+                warp_vertical_filter(tmp + k + 4, sy4 + delta * (k + 4), gamma,
+                                     round_const_vert, shift_vert, &res_lo,
+                                     &res_hi);
+
+                if (conv_params->is_compound) {
+                    CONV_BUF_TYPE *p =
+                        &conv_params->dst[(i - p_row + k + 4) * conv_params->dst_stride +
+                                          (j - p_col)];
+                    if (conv_params->do_average) {
+                        uint8_t *dst8 = &pred[(i - p_row + k + 4) * p_stride + (j - p_col)];
+                        warp_compound_average(conv_params, p, n, offset_bits,
+                                              &res_lo, &res_hi);
+                        const __m128i res16 = _mm_packs_epi32(res_lo, res_hi);
+                        store_u8_n(dst8, _mm_packus_epi16(res16, res16), n);
+                    }
+                    else
+                        store_u16_n(p, _mm_packus_epi32(res_lo, res_hi), n);
+                }
+                else {
+                    uint8_t *p = &pred[(i - p_row + k + 4) * p_stride + (j - p_col)];
+                    const __m128i res16 =
+                        _mm_packs_epi32(_mm_sub_epi32(res_lo, pixel_offset),
+                                        _mm_sub_epi32(res_hi, pixel_offset));
+                    store_u8_n(p, _mm_packus_epi16(res16, res16), n);
+                }
+            }
+        }
+    }
+}
+
+void av1_highbd_warp_affine_sse4_1(const int32_t *mat, const uint16_t *ref,
+                                   int width, int height, int stride,
+                                   uint16_t *pred, int p_col, int p_row,
+                                   int p_width, int p_height, int p_stride,
+                                   int subsampling_x, int subsampling_y, int bd,
+                                   ConvolveParams *conv_params, int16_t alpha,
+                                   int16_t beta, int16_t gamma, int16_t delta) {
+    __m128i tmp[15];
+    const int reduce_bits_horiz =
+        conv_params->round_0 +
+        AOMMAX(bd + FILTER_BITS - conv_params->round_0 - 14, 0);
+    const int reduce_bits_vert = conv_params->is_compound
+                                     ? conv_params->round_1
+                                     : 2 * FILTER_BITS - reduce_bits_horiz;
+    const int offset_bits_horiz = bd + FILTER_BITS - 1;
+    const int offset_bits_vert = bd + 2 * FILTER_BITS - reduce_bits_horiz;
+    const int offset_bits = bd + 2 * FILTER_BITS - conv_params->round_0;
+    const __m128i round_const_horiz = _mm_set1_epi32(
+        (1 << offset_bits_horiz) + ((1 << reduce_bits_horiz) >> 1));
+    const __m128i shift_horiz = _mm_cvtsi32_si128(reduce_bits_horiz);
+    const __m128i round_const_vert = _mm_set1_epi32(
+        (1 << offset_bits_vert) + ((1 << reduce_bits_vert) >> 1));
+    const __m128i shift_vert = _mm_cvtsi32_si128(reduce_bits_vert);
+    const __m128i pixel_offset = _mm_set1_epi32((1 << (bd - 1)) + (1 << bd));
+    const __m128i max_pixel = _mm_set1_epi16((int16_t)((1 << bd) - 1));
+    assert(IMPLIES(conv_params->is_compound, conv_params->dst != NULL));
+
+    for (int i = p_row; i < p_row + p_height; i += 8) {
+        for (int j = p_col; j < p_col + p_width; j += 8) {
+            const int32_t src_x = (j + 4) << subsampling_x;
+            const int32_t src_y = (i + 4) << subsampling_y;
+            const int32_t dst_x = mat[2] * src_x + mat[3] * src_y + mat[0];
+            const int32_t dst_y = mat[4] * src_x + mat[5] * src_y + mat[1];
+            const int32_t x4 = dst_x >> subsampling_x;
+            const int32_t y4 = dst_y >> subsampling_y;
+
+            const int32_t ix4 = x4 >> WARPEDMODEL_PREC_BITS;
+            int32_t sx4 = x4 & ((1 << WARPEDMODEL_PREC_BITS) - 1);
+            const int32_t iy4 = y4 >> WARPEDMODEL_PREC_BITS;
+            int32_t sy4 = y4 & ((1 << WARPEDMODEL_PREC_BITS) - 1);
+
+            sx4 += alpha * (-4) + beta * (-4) +
+                   (1 << (WARPEDDIFF_PREC_BITS - 1)) +
+                   (WARPEDPIXEL_PREC_SHIFTS << WARPEDDIFF_PREC_BITS);
+            sy4 += gamma * (-4) + delta * (-4) +
+                   (1 << (WARPEDDIFF_PREC_BITS - 1)) +
+                   (WARPEDPIXEL_PREC_SHIFTS << WARPEDDIFF_PREC_BITS);
+
+            sx4 &= ~((1 << WARP_PARAM_REDUCE_BITS) - 1);
+            sy4 &= ~((1 << WARP_PARAM_REDUCE_BITS) - 1);
+
+            // Horizontal filter
+            for (int k = -7; k < 8; ++k) {
+                const int iy = clamp(iy4 + k, 0, height - 1);
+                const uint16_t *const row = ref + iy * stride;
+                __m128i coeff[8];
+                __m128i src, src2;
+
+                if (ix4 - 7 >= 0 && ix4 + 8 < width) {
+                    src = _mm_loadu_si128((const __m128i *)(row + ix4 - 7));
+                    src2 = _mm_loadu_si128((const __m128i *)(row + ix4 + 1));
+                }
+                else {
+                    uint16_t buf[16];
+                    for (int m = 0; m < 16; ++m)
+                        buf[m] = row[clamp(ix4 - 7 + m, 0, width - 1)];
+                    src = _mm_loadu_si128((const __m128i *)buf);
+                    src2 = _mm_loadu_si128((const __m128i *)(buf + 8));
+                }
+
+                prepare_warp_coeffs(sx4 + beta * (k + 4), alpha, coeff);
+                tmp[k + 7] = warp_horizontal_filter(src, src2, coeff,
+                                                    round_const_horiz,
+                                                    shift_horiz);
+            }
+
+            // Vertical filter
+            const int n = AOMMIN(8, p_col + p_width - j);
+            for (int k = -4; k < AOMMIN(4, p_row + p_height - i - 4); ++k) {
+                __m128i res_lo, res_hi;
+                warp_vertical_filter(tmp + k + 4, sy4 + delta * (k + 4), gamma,
+                                     round_const_vert, shift_vert, &res_lo,
+                                     &res_hi);
+
+                if (conv_params->is_compound) {
+                    CONV_BUF_TYPE *p =
+                        &conv_params->dst[(i - p_row + k + 4) * conv_params->dst_stride +
+                                          (j - p_col)];
+                    if (conv_params->do_average) {
+                        uint16_t *dst16 = &pred[(i - p_row + k + 4) * p_stride + (j - p_col)];
+                        warp_compound_average(conv_params, p, n, offset_bits,
+                                              &res_lo, &res_hi);
+                        store_u16_n(dst16, _mm_min_epu16(
+                            _mm_packus_epi32(res_lo, res_hi), max_pixel), n);
+                    }
+                    else
+                        store_u16_n(p, _mm_packus_epi32(res_lo, res_hi), n);
+                }
+                else {
+                    uint16_t *p = &pred[(i - p_row + k + 4) * p_stride + (j - p_col)];
+                    const __m128i res16 =
+                        _mm_packus_epi32(_mm_sub_epi32(res_lo, pixel_offset),
+                                         _mm_sub_epi32(res_hi, pixel_offset));
+                    store_u16_n(p, _mm_min_epu16(res16, max_pixel), n);
+                }
+            }
+        }
+    }
+}
@@ -17,6 +17,14 @@ extern "C" {
         uint32_t  ref_stride,           // input parameter, reference stride
         uint32_t  height,               // input parameter, block height (M)
         uint32_t  width);               // input parameter, block width (N)
+
+    uint32_t fast_loop_nx_m_sad_kernel16bit(
+        const uint16_t *src,            // input parameter, source samples Ptr
+        uint32_t  src_stride,           // input parameter, source stride
+        const uint16_t *ref,            // input parameter, reference samples Ptr
+        uint32_t  ref_stride,           // input parameter, reference stride
+        uint32_t  height,               // input parameter, block height (M)
+        uint32_t  width);               // input parameter, block width (N)
                                         
     uint32_t combined_averaging_sad(    
         uint8_t  *src,                  
@@ -65,6 +65,34 @@ uint64_t spatial_full_distortion_kernel(
     return spatialDistortion;
 }
 
+uint64_t spatial_full_distortion_kernel16bit(
+    uint16_t  *input,
+    uint32_t   input_stride,
+    uint16_t  *recon,
+    uint32_t   recon_stride,
+    uint32_t   area_width,
+    uint32_t   area_height)
+{
+    uint32_t  columnIndex;
+    uint32_t  row_index = 0;
+
+    uint64_t  spatialDistortion = 0;
+
+    while (row_index < area_height) {
+
+        columnIndex = 0;
+        while (columnIndex < area_width) {
+            spatialDistortion += (int64_t)SQR((int64_t)(input[columnIndex]) - (recon[columnIndex]));
+            ++columnIndex;
+        }
+
+        input += input_stride;
+        recon += recon_stride;
+        ++row_index;
+    }
+    return spatialDistortion;
+}
+
 
 
 
@@ -27,6 +27,14 @@ extern "C" {
         uint32_t area_width,
         uint32_t area_height);
 
+    uint64_t spatial_full_distortion_kernel16bit(
+        uint16_t *input,
+        uint32_t  input_stride,
+        uint16_t *recon,
+        uint32_t  recon_stride,
+        uint32_t  area_width,
+        uint32_t  area_height);
+
     extern void picture_addition_kernel(
         uint8_t *pred_ptr,
         uint32_t pred_stride,
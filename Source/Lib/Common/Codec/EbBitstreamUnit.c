@@ -59,50 +59,6 @@ EbErrorType output_bitstream_reset(
     return return_error;
 }
 
-/**********************************
- * Output RBSP to payload
- *   Intended to be used in CABAC
- **********************************/
-EbErrorType output_bitstream_rbsp_to_payload(
-    OutputBitstreamUnit_t   *bitstream_ptr,
-    EbByte                  output_buffer,
-    uint32_t                *output_buffer_index,
-    uint32_t                *output_buffer_size,
-    uint32_t                 start_location)
-{
-    EbErrorType return_error = EB_ErrorNone;
-    uint32_t  buffer_written_bytes_count = (uint32_t)(bitstream_ptr->bufferAv1 - bitstream_ptr->bufferBeginAv1);
-    uint32_t  write_location = start_location;
-    uint32_t  read_location = start_location;
-    EbByte read_byte_ptr;
-    EbByte write_byte_ptr;
-#if IVF_FRAME_HEADER_IN_LIB
-    static uint64_t frame_count = 0;
-
-#endif
-    // IVF data
-    read_byte_ptr = (EbByte)bitstream_ptr->bufferBeginAv1;
-    write_byte_ptr = &output_buffer[*output_buffer_index];
-#if IVF_FRAME_HEADER_IN_LIB
-    mem_put_le32(&write_byte_ptr[write_location], (int32_t)buffer_written_bytes_count);
-    write_location = write_location + 4;
-    mem_put_le32(&write_byte_ptr[write_location], (int32_t)(frame_count & 0xFFFFFFFF));
-    write_location = write_location + 4;
-    mem_put_le32(&write_byte_ptr[write_location], (int32_t)(frame_count >> 32));
-    write_location = write_location + 4;
-    *output_buffer_index += 12;
-#endif
-    //frame_count++;
-    while ((read_location < buffer_written_bytes_count)) {
-        if ((*output_buffer_index) < (*output_buffer_size)) {
-            write_byte_ptr[write_location++] = read_byte_ptr[read_location];
-            *output_buffer_index += 1;
-        }
-        read_location++;
-    }
-
-    return return_error;
-}
 /********************************************************************************************************************************/
 /********************************************************************************************************************************/
 /********************************************************************************************************************************/
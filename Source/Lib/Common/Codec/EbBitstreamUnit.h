@@ -36,19 +36,11 @@ extern "C" {
 
     extern EbErrorType output_bitstream_reset(OutputBitstreamUnit_t *bitstreamPtr);
 
-
-
-    extern EbErrorType output_bitstream_rbsp_to_payload(
-        OutputBitstreamUnit_t *bitstreamPtr,
-        EbByte                outputBuffer,
-        uint32_t                *outputBufferIndex,
-        uint32_t                *outputBufferSize,
-        uint32_t                 startLocation);
-
     /********************************************************************************************************************************/
     /********************************************************************************************************************************/
     /********************************************************************************************************************************/
 #include "EbCabacContextModel.h"
+#include "EbSymbolStream.h"
 /********************************************************************************************************************************/
 // bitops.h
 // These versions of get_msb() are only valid when n != 0 because all
@@ -247,6 +239,7 @@ on a larger type, you can speed up the decoder by using it here.*/
         uint8_t *buffer;
         od_ec_enc ec;
         uint8_t allow_update_cdf;
+        SymbolStream_t *symbol_stream;  // When set, symbols are recorded instead of coded
     };
 
     typedef struct daala_writer daala_writer;
@@ -321,6 +314,10 @@ on a larger type, you can speed up the decoder by using it here.*/
     }
 
     static INLINE void aom_write(aom_writer *br, int32_t bit, int32_t probability) {
+        if (br->symbol_stream) {
+            symbol_stream_put_bool(br->symbol_stream, bit, probability);
+            return;
+        }
         aom_daala_write(br, bit, probability);
     }
 
@@ -341,6 +338,10 @@ on a larger type, you can speed up the decoder by using it here.*/
 
     static INLINE void aom_write_symbol(aom_writer *w, int32_t symb, aom_cdf_prob *cdf,
         int32_t nsymbs) {
+        if (w->symbol_stream) {
+            symbol_stream_put_cdf(w->symbol_stream, symb, cdf, nsymbs);
+            return;
+        }
         aom_write_cdf(w, symb, cdf, nsymbs);
         if (w->allow_update_cdf) update_cdf(cdf, symb, nsymbs);
     }
@@ -253,6 +253,17 @@ void cdef_filter_block_c(uint8_t *dst8, uint16_t *dst16, int32_t dstride,
         }
     }
 }
+
+/* Filters an 8x8 block with one primary strength and CDEF_SEC_STRENGTHS
+secondary strengths. The outputs are stored one after the other, 8x8 each. */
+void cdef_filter_block_8x8_16_sec4_c(uint16_t *dst, const uint16_t *in,
+    int32_t pri_strength, const int32_t *sec_strength, int32_t dir,
+    int32_t pri_damping, int32_t sec_damping, int32_t coeff_shift) {
+    int32_t k;
+    for (k = 0; k < CDEF_SEC_STRENGTHS; k++)
+        cdef_filter_block_c(NULL, &dst[k << 6], 8, in, pri_strength, sec_strength[k],
+            dir, pri_damping, sec_damping, BLOCK_8X8, (256 << coeff_shift) - 1, coeff_shift);
+}
 int32_t get_cdef_gi_step(
     int8_t   cdef_filter_mode) {
         int32_t gi_step = cdef_filter_mode == 1 ? 1 : cdef_filter_mode == 2 ? 4 : cdef_filter_mode == 3 ? 8 : cdef_filter_mode == 4 ? 16 : 64;
@@ -357,6 +368,55 @@ void cdef_filter_fb(uint8_t *dst8, uint16_t *dst16, int32_t dstride, uint16_t *i
     }
 }
 
+/* Strength search for the luma 8x8 blocks: gives the distortion of the
+CDEF_SEC_STRENGTHS strengths gi = level * CDEF_SEC_STRENGTHS + k at once, as
+cdef_filter_fb followed by compute_cdef_dist would for each gi. The taps and
+the primary part of the filter are shared by the secondary strengths. */
+void cdef_search_fb_luma_sec4(uint64_t mse[CDEF_SEC_STRENGTHS], uint16_t *ref,
+    int32_t rstride, uint16_t *in, int32_t dir[CDEF_NBLOCKS][CDEF_NBLOCKS],
+    int32_t *dirinit, int32_t var[CDEF_NBLOCKS][CDEF_NBLOCKS],
+    cdef_list *dlist, int32_t cdef_count, int32_t level,
+    int32_t pri_damping, int32_t sec_damping, int32_t coeff_shift) {
+    DECLARE_ALIGNED(32, uint16_t, dst[CDEF_SEC_STRENGTHS << 6]);
+    const int32_t zero_strengths[CDEF_SEC_STRENGTHS] = { 0 };
+    int32_t sec_strengths[CDEF_SEC_STRENGTHS];
+    const int32_t pri_strength = level << coeff_shift;
+    int32_t bi, bx, by, k;
+
+    for (k = 0; k < CDEF_SEC_STRENGTHS; k++) {
+        sec_strengths[k] = (k + (k == 3)) << coeff_shift;
+        mse[k] = 0;
+    }
+    sec_damping += coeff_shift;
+    pri_damping += coeff_shift;
+
+    if (!*dirinit) {
+        for (bi = 0; bi < cdef_count; bi++) {
+            by = dlist[bi].by;
+            bx = dlist[bi].bx;
+            dir[by][bx] = cdef_find_dir(&in[8 * by * CDEF_BSTRIDE + 8 * bx],
+                CDEF_BSTRIDE, &var[by][bx], coeff_shift);
+        }
+        *dirinit = 1;
+    }
+
+    for (bi = 0; bi < cdef_count; bi++) {
+        const int32_t t = dlist[bi].skip ? 0 : pri_strength;
+        by = dlist[bi].by;
+        bx = dlist[bi].bx;
+        cdef_filter_block_8x8_16_sec4(dst, &in[(by * CDEF_BSTRIDE << 3) + (bx << 3)],
+            adjust_strength(t, var[by][bx]),
+            dlist[bi].skip ? zero_strengths : sec_strengths,
+            t ? dir[by][bx] : 0, pri_damping, sec_damping, coeff_shift);
+        for (k = 0; k < CDEF_SEC_STRENGTHS; k++)
+            mse[k] += dist_8x8_16bit(&ref[(by << 3) * rstride + (bx << 3)], rstride,
+                &dst[k << 6], 8, coeff_shift);
+    }
+
+    for (k = 0; k < CDEF_SEC_STRENGTHS; k++)
+        mse[k] >>= 2 * coeff_shift;
+}
+
 int32_t sb_all_skip(PictureControlSet_t   *picture_control_set_ptr, const Av1Common *const cm, int32_t mi_row, int32_t mi_col) {
     int32_t maxc, maxr;
     int32_t skip = 1;
@@ -1231,6 +1291,16 @@ uint64_t search_one_dual_c(int *lev0, int *lev1, int nb_strengths,
     return best_tot_mse;
 }
 
+/* Rotate the selected options left, as that many more refinement passes
+that keep re-picking the dropped option would. */
+static void rotate_strengths(int32_t *lev, int32_t nb_strengths, int32_t shift) {
+    int32_t tmp[CDEF_MAX_STRENGTHS];
+    int32_t j;
+    shift %= nb_strengths;
+    for (j = 0; j < nb_strengths; j++) tmp[j] = lev[(j + shift) % nb_strengths];
+    for (j = 0; j < nb_strengths; j++) lev[j] = tmp[j];
+}
+
 /* Search for the set of strengths that minimizes mse. */
 static uint64_t joint_strength_search(int32_t *best_lev, int32_t nb_strengths,
     uint64_t mse[][TOTAL_STRENGTHS],
@@ -1245,11 +1315,20 @@ static uint64_t joint_strength_search(int32_t *best_lev, int32_t nb_strengths,
     /* Trying to refine the greedy search by reconsidering each
     already-selected option. */
     if (!fast) {
+        int32_t unchanged = 0;
         for (i = 0; i < 4 * nb_strengths; i++) {
             int32_t j;
+            const int32_t dropped = best_lev[0];
             for (j = 0; j < nb_strengths - 1; j++) best_lev[j] = best_lev[j + 1];
             best_tot_mse =
                 search_one(best_lev, nb_strengths - 1, mse, sb_count, fast, start_gi, end_gi);
+            /* Once a whole cycle re-picks every dropped option the set is a
+            fixed point: the remaining passes would only rotate it. */
+            unchanged = (best_lev[nb_strengths - 1] == dropped) ? unchanged + 1 : 0;
+            if (unchanged == nb_strengths) {
+                rotate_strengths(best_lev, nb_strengths, 4 * nb_strengths - (i + 1));
+                break;
+            }
         }
     }
     return best_tot_mse;
@@ -1269,13 +1348,22 @@ static uint64_t joint_strength_search_dual(int32_t *best_lev0, int32_t *best_lev
     }
     /* Trying to refine the greedy search by reconsidering each
     already-selected option. */
+    int32_t unchanged = 0;
     for (i = 0; i < 4 * nb_strengths; i++) {
         int32_t j;
+        const int32_t dropped0 = best_lev0[0];
+        const int32_t dropped1 = best_lev1[0];
         for (j = 0; j < nb_strengths - 1; j++) {
             best_lev0[j] = best_lev0[j + 1];
             best_lev1[j] = best_lev1[j + 1];
         }
         best_tot_mse = search_one_dual(best_lev0, best_lev1, nb_strengths - 1, mse, sb_count, fast, start_gi, end_gi);
+        unchanged = (best_lev0[nb_strengths - 1] == dropped0 && best_lev1[nb_strengths - 1] == dropped1) ? unchanged + 1 : 0;
+        if (unchanged == nb_strengths) {
+            rotate_strengths(best_lev0, nb_strengths, 4 * nb_strengths - (i + 1));
+            rotate_strengths(best_lev1, nb_strengths, 4 * nb_strengths - (i + 1));
+            break;
+        }
     }
     return best_tot_mse;
 }
@@ -76,6 +76,12 @@ extern "C" {
         int32_t sec_strength, int32_t pri_damping, int32_t sec_damping,
         int32_t coeff_shift);
 
+    void cdef_search_fb_luma_sec4(uint64_t mse[CDEF_SEC_STRENGTHS], uint16_t *ref,
+        int32_t rstride, uint16_t *in, int32_t dir[CDEF_NBLOCKS][CDEF_NBLOCKS],
+        int32_t *dirinit, int32_t var[CDEF_NBLOCKS][CDEF_NBLOCKS],
+        cdef_list *dlist, int32_t cdef_count, int32_t level,
+        int32_t pri_damping, int32_t sec_damping, int32_t coeff_shift);
+
 
     int32_t get_cdef_gi_step(
         int8_t   cdef_filter_mode);
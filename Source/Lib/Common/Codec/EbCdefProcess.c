@@ -230,6 +230,22 @@ void cdef_seg_search(
                     average are outside the frame. We could change the filter instead, but it would add special cases for any future vectorization. */
                     sec_strength = gi % CDEF_SEC_STRENGTHS;
 
+                    // Luma takes the secondary strengths of a primary strength in one pass
+                    if (pli == 0 && sec_strength == 0 && gi + CDEF_SEC_STRENGTHS <= end_gi) {
+                        uint64_t sec_mse[CDEF_SEC_STRENGTHS];
+                        int32_t k;
+                        cdef_search_fb_luma_sec4(sec_mse,
+                            ref_coeff[0] +
+                            (fbr * MI_SIZE_64X64 << mi_high_l2[0]) * stride[0] +
+                            (fbc * MI_SIZE_64X64 << mi_wide_l2[0]),
+                            stride[0], in, dir, &dirinit, var, dlist, cdef_count, threshold,
+                            pri_damping, sec_damping, coeff_shift);
+                        for (k = 0; k < CDEF_SEC_STRENGTHS; k++)
+                            picture_control_set_ptr->mse_seg[0][fbr*nhfb + fbc][gi + k] = sec_mse[k];
+                        gi += CDEF_SEC_STRENGTHS - 1;
+                        continue;
+                    }
+
                     cdef_filter_fb(NULL, tmp_dst, CDEF_BSTRIDE, in, xdec[pli], ydec[pli],
                         dir, &dirinit, var, pli, dlist, cdef_count, threshold,
                         sec_strength + (sec_strength == 3), pri_damping,
@@ -405,6 +421,22 @@ void cdef_seg_search16bit(
                     average are outside the frame. We could change the filter instead, but it would add special cases for any future vectorization. */
                     sec_strength = gi % CDEF_SEC_STRENGTHS;
 
+                    // Luma takes the secondary strengths of a primary strength in one pass
+                    if (pli == 0 && sec_strength == 0 && gi + CDEF_SEC_STRENGTHS <= end_gi) {
+                        uint64_t sec_mse[CDEF_SEC_STRENGTHS];
+                        int32_t k;
+                        cdef_search_fb_luma_sec4(sec_mse,
+                            ref_coeff[0] +
+                            (fbr * MI_SIZE_64X64 << mi_high_l2[0]) * stride_ref[0] +
+                            (fbc * MI_SIZE_64X64 << mi_wide_l2[0]),
+                            stride_ref[0], in, dir, &dirinit, var, dlist, cdef_count, threshold,
+                            pri_damping, sec_damping, coeff_shift);
+                        for (k = 0; k < CDEF_SEC_STRENGTHS; k++)
+                            picture_control_set_ptr->mse_seg[0][fbr*nhfb + fbc][gi + k] = sec_mse[k];
+                        gi += CDEF_SEC_STRENGTHS - 1;
+                        continue;
+                    }
+
                     cdef_filter_fb(NULL, tmp_dst, CDEF_BSTRIDE, in, xdec[pli], ydec[pli],
                         dir, &dirinit, var, pli, dlist, cdef_count, threshold,
                         sec_strength + (sec_strength == 3), pri_damping,
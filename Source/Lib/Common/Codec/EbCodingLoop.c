@@ -54,12 +54,14 @@ extern void av1_predict_intra_block(
     uint32_t bl_org_x_pict,
     uint32_t bl_org_y_pict,
     uint32_t bl_org_x_mb,
-    uint32_t bl_org_y_mb);
+    uint32_t bl_org_y_mb,
+    IntraEdgeCache_t *edge_cache_ptr);
 
 void av1_predict_intra_block_16bit(
     TileInfo               *tile,
 
-    EncDecContext_t         *context_ptr,
+    STAGE       stage,
+    const BlockGeom            * blk_geom,
     const Av1Common *cm,
     int32_t wpx,
     int32_t hpx,
@@ -76,7 +78,9 @@ void av1_predict_intra_block_16bit(
     int32_t plane,
     block_size bsize,
     uint32_t bl_org_x_pict,
-    uint32_t bl_org_y_pict);
+    uint32_t bl_org_y_pict,
+    uint32_t bl_org_x_mb,
+    uint32_t bl_org_y_mb);
 
 
 /*******************************************
@@ -1051,13 +1055,16 @@ static void Av1EncodeLoop16bit(
     //    uint32_t                 temporal_layer_index = sb_ptr->picture_control_set_ptr->temporal_layer_index;
     uint32_t                 qp = cu_ptr->qp;
 
-    EbPictureBufferDesc_t *inputSamples16bit = context_ptr->input_sample16bit_buffer;
+    // The 16 bit source is packed in place in the picture level buffer
+    EbPictureBufferDesc_t *inputSamples16bit = picture_control_set_ptr->input_frame16bit;
     EbPictureBufferDesc_t *predSamples16bit = predSamples;
     uint32_t                 round_origin_x = (origin_x >> 3) << 3;// for Chroma blocks with size of 4
     uint32_t                 round_origin_y = (origin_y >> 3) << 3;// for Chroma blocks with size of 4
-    const uint32_t           inputLumaOffset = context_ptr->blk_geom->tx_org_x[context_ptr->txb_itr] + context_ptr->blk_geom->tx_org_y[context_ptr->txb_itr] * SB_STRIDE_Y;
-    const uint32_t           inputCbOffset = ROUND_UV(context_ptr->blk_geom->tx_org_x[context_ptr->txb_itr]) / 2 + ROUND_UV(context_ptr->blk_geom->tx_org_y[context_ptr->txb_itr]) / 2 * SB_STRIDE_UV;
-    const uint32_t           inputCrOffset = ROUND_UV(context_ptr->blk_geom->tx_org_x[context_ptr->txb_itr]) / 2 + ROUND_UV(context_ptr->blk_geom->tx_org_y[context_ptr->txb_itr]) / 2 * SB_STRIDE_UV;
+    const uint32_t           input_org_x = inputSamples16bit->origin_x + sb_ptr->origin_x;
+    const uint32_t           input_org_y = inputSamples16bit->origin_y + sb_ptr->origin_y;
+    const uint32_t           inputLumaOffset = (input_org_y + context_ptr->blk_geom->tx_org_y[context_ptr->txb_itr]) * inputSamples16bit->stride_y + input_org_x + context_ptr->blk_geom->tx_org_x[context_ptr->txb_itr];
+    const uint32_t           inputCbOffset = ((input_org_y >> 1) + ROUND_UV(context_ptr->blk_geom->tx_org_y[context_ptr->txb_itr]) / 2) * inputSamples16bit->strideCb + (input_org_x >> 1) + ROUND_UV(context_ptr->blk_geom->tx_org_x[context_ptr->txb_itr]) / 2;
+    const uint32_t           inputCrOffset = ((input_org_y >> 1) + ROUND_UV(context_ptr->blk_geom->tx_org_y[context_ptr->txb_itr]) / 2) * inputSamples16bit->strideCr + (input_org_x >> 1) + ROUND_UV(context_ptr->blk_geom->tx_org_x[context_ptr->txb_itr]) / 2;
     const uint32_t           predLumaOffset = ((predSamples16bit->origin_y + origin_y)        * predSamples16bit->stride_y) + (predSamples16bit->origin_x + origin_x);
     const uint32_t           predCbOffset = (((predSamples16bit->origin_y + round_origin_y) >> 1)  * predSamples16bit->strideCb) + ((predSamples16bit->origin_x + round_origin_x) >> 1);
     const uint32_t           predCrOffset = (((predSamples16bit->origin_y + round_origin_y) >> 1)  * predSamples16bit->strideCr) + ((predSamples16bit->origin_x + round_origin_x) >> 1);
@@ -1638,6 +1645,59 @@ EB_AV1_GENERATE_RECON_FUNC_PTR   Av1EncodeGenerateReconFunctionPtr[2] =
     Av1EncodeGenerateRecon16bit
 };
 
+/*******************************************
+* Encode Pass - Commit MD Output
+*   Copies the quantized coefficients and the recon MD kept
+*   for an inter block (md_output_reuse) in place of the
+*   encode pass prediction, transform and recon
+*******************************************/
+static void EncodePassCommitMdOutput(
+    EncDecContext_t         *context_ptr,
+    MdEncPassCuData_t       *md_ep_pipe,
+    EbPictureBufferDesc_t   *recon_buffer,
+    EbPictureBufferDesc_t   *coeff_buffer_sb,
+    EbBool                   do_recon)
+{
+    CodingUnit_t    *cu_ptr = context_ptr->cu_ptr;
+    const BlockGeom *blk_geom = context_ptr->blk_geom;
+    uint32_t         txb_itr;
+    uint32_t         j;
+
+    // A skip block keeps the prediction MD stored as recon, and no coefficients
+    if (cu_ptr->skip_flag == EB_FALSE) {
+        memcpy(((int32_t*)coeff_buffer_sb->buffer_y) + context_ptr->coded_area_sb, md_ep_pipe->quant_coeff[0], blk_geom->bwidth * blk_geom->bheight * sizeof(int32_t));
+        memcpy(((int32_t*)coeff_buffer_sb->bufferCb) + context_ptr->coded_area_sb_uv, md_ep_pipe->quant_coeff[1], blk_geom->bwidth_uv * blk_geom->bheight_uv * sizeof(int32_t));
+        memcpy(((int32_t*)coeff_buffer_sb->bufferCr) + context_ptr->coded_area_sb_uv, md_ep_pipe->quant_coeff[2], blk_geom->bwidth_uv * blk_geom->bheight_uv * sizeof(int32_t));
+
+        for (txb_itr = 0; txb_itr < blk_geom->txb_count; txb_itr++) {
+            TransformUnit *txb_ptr = &cu_ptr->transform_unit_array[txb_itr];
+
+            txb_ptr->nz_coef_count[0] = txb_ptr->y_has_coeff ? md_ep_pipe->eob[0][txb_itr] : 0;
+            txb_ptr->nz_coef_count[1] = txb_ptr->u_has_coeff ? md_ep_pipe->eob[1][txb_itr] : 0;
+            txb_ptr->nz_coef_count[2] = txb_ptr->v_has_coeff ? md_ep_pipe->eob[2][txb_itr] : 0;
+
+            // Chroma follows Luma in transform type
+            if (txb_ptr->y_has_coeff == EB_FALSE) {
+                txb_ptr->transform_type[PLANE_TYPE_Y] = DCT_DCT;
+                txb_ptr->transform_type[PLANE_TYPE_UV] = DCT_DCT;
+            }
+        }
+    }
+
+    if (do_recon) {
+        uint32_t reconLumaOffset = (recon_buffer->origin_y + context_ptr->cu_origin_y) * recon_buffer->stride_y + (recon_buffer->origin_x + context_ptr->cu_origin_x);
+        uint32_t reconCbOffset = ((recon_buffer->origin_y + context_ptr->cu_origin_y) >> 1) * recon_buffer->strideCb + ((recon_buffer->origin_x + context_ptr->cu_origin_x) >> 1);
+        uint32_t reconCrOffset = ((recon_buffer->origin_y + context_ptr->cu_origin_y) >> 1) * recon_buffer->strideCr + ((recon_buffer->origin_x + context_ptr->cu_origin_x) >> 1);
+
+        for (j = 0; j < blk_geom->bheight; j++)
+            memcpy(recon_buffer->buffer_y + reconLumaOffset + j * recon_buffer->stride_y, md_ep_pipe->recon[0] + j * blk_geom->bwidth, blk_geom->bwidth);
+        for (j = 0; j < blk_geom->bheight_uv; j++) {
+            memcpy(recon_buffer->bufferCb + reconCbOffset + j * recon_buffer->strideCb, md_ep_pipe->recon[1] + j * blk_geom->bwidth_uv, blk_geom->bwidth_uv);
+            memcpy(recon_buffer->bufferCr + reconCrOffset + j * recon_buffer->strideCr, md_ep_pipe->recon[2] + j * blk_geom->bwidth_uv, blk_geom->bwidth_uv);
+        }
+    }
+}
+
 /*******************************************
 * Encode Pass - Assign Delta Qp
 *******************************************/
@@ -2172,50 +2232,6 @@ EbErrorType EncQpmDeriveDeltaQPForEachLeafLcu(
     return return_error;
 }
 
-void Store16bitInputSrc(
-    EncDecContext_t         *context_ptr,
-    PictureControlSet_t     *picture_control_set_ptr,
-    uint32_t                 lcuX,
-    uint32_t                 lcuY,
-    uint32_t                 lcuW,
-    uint32_t                 lcuH ){
-
-    uint32_t rowIt;
-    uint16_t* fromPtr;
-    uint16_t* toPtr;
-
-    fromPtr = (uint16_t*)context_ptr->input_sample16bit_buffer->buffer_y;
-    toPtr = (uint16_t*)picture_control_set_ptr->input_frame16bit->buffer_y + (lcuX + picture_control_set_ptr->input_frame16bit->origin_x) + (lcuY + picture_control_set_ptr->input_frame16bit->origin_y)*picture_control_set_ptr->input_frame16bit->stride_y;
-
-    for (rowIt = 0; rowIt < lcuH; rowIt++)
-    {
-        memcpy(toPtr + rowIt * picture_control_set_ptr->input_frame16bit->stride_y, fromPtr + rowIt * context_ptr->input_sample16bit_buffer->stride_y, lcuW * 2);
-    }
-
-    lcuX = lcuX / 2;
-    lcuY = lcuY / 2;
-    lcuW = lcuW / 2;
-    lcuH = lcuH / 2;
-
-    fromPtr = (uint16_t*)context_ptr->input_sample16bit_buffer->bufferCb;
-    toPtr = (uint16_t*)picture_control_set_ptr->input_frame16bit->bufferCb + (lcuX + picture_control_set_ptr->input_frame16bit->origin_x / 2) + (lcuY + picture_control_set_ptr->input_frame16bit->origin_y / 2)*picture_control_set_ptr->input_frame16bit->strideCb;
-
-    for (rowIt = 0; rowIt < lcuH; rowIt++)
-    {
-        memcpy(toPtr + rowIt * picture_control_set_ptr->input_frame16bit->strideCb, fromPtr + rowIt * context_ptr->input_sample16bit_buffer->strideCb, lcuW * 2);
-    }
-
-    fromPtr = (uint16_t*)context_ptr->input_sample16bit_buffer->bufferCr;
-    toPtr = (uint16_t*)picture_control_set_ptr->input_frame16bit->bufferCr + (lcuX + picture_control_set_ptr->input_frame16bit->origin_x / 2) + (lcuY + picture_control_set_ptr->input_frame16bit->origin_y / 2)*picture_control_set_ptr->input_frame16bit->strideCb;
-
-    for (rowIt = 0; rowIt < lcuH; rowIt++)
-    {
-        memcpy(toPtr + rowIt * picture_control_set_ptr->input_frame16bit->strideCr, fromPtr + rowIt * context_ptr->input_sample16bit_buffer->strideCr, lcuW * 2);
-    }
-
-
-}
-
 void update_av1_mi_map(
     CodingUnit_t                   *cu_ptr,
     uint32_t                          cu_origin_x,
@@ -2403,11 +2419,20 @@ EB_EXTERN void AV1EncodePass(
     EbBool  highIntraRef = EB_FALSE;
     EbBool  checkZeroLumaCbf = EB_FALSE;
 
-    if (is16bit) {
+    // The native 16 bit pipeline input is already the 16 bit source
+    if (is16bit && !picture_control_set_ptr->parent_pcs_ptr->native_input_picture_ptr) {
 
 
         //SB128_TODO change 10bit SB creation
 
+        // Merge the 8 bit and the n bit parts of the SB straight into the picture
+        // level 16 bit source, which is what the encode pass, DLF, CDEF and
+        // restoration read from
+        EbPictureBufferDesc_t *input16bitPicture = picture_control_set_ptr->input_frame16bit;
+        const uint32_t output16bitLumaOffset = ((sb_origin_y + input16bitPicture->origin_y)         * input16bitPicture->stride_y) + (sb_origin_x + input16bitPicture->origin_x);
+        const uint32_t output16bitCbOffset = (((sb_origin_y + input16bitPicture->origin_y) >> 1)  * input16bitPicture->strideCb) + ((sb_origin_x + input16bitPicture->origin_x) >> 1);
+        const uint32_t output16bitCrOffset = (((sb_origin_y + input16bitPicture->origin_y) >> 1)  * input16bitPicture->strideCr) + ((sb_origin_x + input16bitPicture->origin_x) >> 1);
+
         if ((sequence_control_set_ptr->static_config.ten_bit_format == 1) || (sequence_control_set_ptr->static_config.compressed_ten_bit_format == 1))
         {
 
@@ -2423,8 +2448,8 @@ EB_EXTERN void AV1EncodePass(
                 inputPicture->stride_y,
                 inputPicture->bufferBitIncY + sb_origin_y * luma2BitWidth + (sb_origin_x / 4)*sb_height,
                 sb_width / 4,
-                (uint16_t *)context_ptr->input_sample16bit_buffer->buffer_y,
-                context_ptr->input_sample16bit_buffer->stride_y,
+                (uint16_t *)input16bitPicture->buffer_y + output16bitLumaOffset,
+                input16bitPicture->stride_y,
                 sb_width,
                 sb_height,
                 asm_type);
@@ -2434,8 +2459,8 @@ EB_EXTERN void AV1EncodePass(
                 inputPicture->strideCb,
                 inputPicture->bufferBitIncCb + sb_origin_y / 2 * chroma2BitWidth + (sb_origin_x / 8)*(sb_height / 2),
                 sb_width / 8,
-                (uint16_t *)context_ptr->input_sample16bit_buffer->bufferCb,
-                context_ptr->input_sample16bit_buffer->strideCb,
+                (uint16_t *)input16bitPicture->bufferCb + output16bitCbOffset,
+                input16bitPicture->strideCb,
                 sb_width >> 1,
                 sb_height >> 1,
                 asm_type);
@@ -2445,8 +2470,8 @@ EB_EXTERN void AV1EncodePass(
                 inputPicture->strideCr,
                 inputPicture->bufferBitIncCr + sb_origin_y / 2 * chroma2BitWidth + (sb_origin_x / 8)*(sb_height / 2),
                 sb_width / 8,
-                (uint16_t *)context_ptr->input_sample16bit_buffer->bufferCr,
-                context_ptr->input_sample16bit_buffer->strideCr,
+                (uint16_t *)input16bitPicture->bufferCr + output16bitCrOffset,
+                input16bitPicture->strideCr,
                 sb_width >> 1,
                 sb_height >> 1,
                 asm_type);
@@ -2466,8 +2491,8 @@ EB_EXTERN void AV1EncodePass(
                 inputPicture->stride_y,
                 inputPicture->bufferBitIncY + inputBitIncLumaOffset,
                 inputPicture->strideBitIncY,
-                (uint16_t *)context_ptr->input_sample16bit_buffer->buffer_y,
-                context_ptr->input_sample16bit_buffer->stride_y,
+                (uint16_t *)input16bitPicture->buffer_y + output16bitLumaOffset,
+                input16bitPicture->stride_y,
                 sb_width,
                 sb_height,
                 asm_type);
@@ -2478,8 +2503,8 @@ EB_EXTERN void AV1EncodePass(
                 inputPicture->strideCr,
                 inputPicture->bufferBitIncCb + inputBitIncCbOffset,
                 inputPicture->strideBitIncCr,
-                (uint16_t *)context_ptr->input_sample16bit_buffer->bufferCb,
-                context_ptr->input_sample16bit_buffer->strideCb,
+                (uint16_t *)input16bitPicture->bufferCb + output16bitCbOffset,
+                input16bitPicture->strideCb,
                 sb_width >> 1,
                 sb_height >> 1,
                 asm_type);
@@ -2490,17 +2515,14 @@ EB_EXTERN void AV1EncodePass(
                 inputPicture->strideCr,
                 inputPicture->bufferBitIncCr + inputBitIncCrOffset,
                 inputPicture->strideBitIncCr,
-                (uint16_t *)context_ptr->input_sample16bit_buffer->bufferCr,
-                context_ptr->input_sample16bit_buffer->strideCr,
+                (uint16_t *)input16bitPicture->bufferCr + output16bitCrOffset,
+                input16bitPicture->strideCr,
                 sb_width >> 1,
                 sb_height >> 1,
                 asm_type);
 
         }
 
-        Store16bitInputSrc(context_ptr, picture_control_set_ptr, sb_origin_x, sb_origin_y, sb_width, sb_height);
-
-
     }
 
     if ((sequence_control_set_ptr->input_resolution == INPUT_SIZE_4K_RANGE) && !picture_control_set_ptr->parent_pcs_ptr->is_used_as_reference_flag) {
@@ -2827,7 +2849,8 @@ EB_EXTERN void AV1EncodePass(
 
                                     av1_predict_intra_block_16bit(
                                         &sb_ptr->tile_info,
-                                        context_ptr,
+                                        ED_STAGE,
+                                        context_ptr->blk_geom,
                                         picture_control_set_ptr->parent_pcs_ptr->av1_cm,                  //const Av1Common *cm,
                                         plane ? blk_geom->bwidth_uv : blk_geom->bwidth,                  //int32_t wpx,
                                         plane ? blk_geom->bheight_uv : blk_geom->bheight,                  //int32_t hpx,
@@ -2845,7 +2868,9 @@ EB_EXTERN void AV1EncodePass(
                                         plane,                                                      //int32_t plane,
                                         blk_geom->bsize,                  //uint32_t puSize,
                                         context_ptr->cu_origin_x,  //uint32_t cuOrgX,
-                                        context_ptr->cu_origin_y);   //uint32_t cuOrgY
+                                        context_ptr->cu_origin_y,  //uint32_t cuOrgY
+                                        0,                          //uint32_t cuOrgX used only for prediction Ptr
+                                        0);                         //uint32_t cuOrgY used only for prediction Ptr
 
 
                                 }
@@ -2922,7 +2947,8 @@ EB_EXTERN void AV1EncodePass(
                                         context_ptr->cu_origin_x,
                                         context_ptr->cu_origin_y,
                                         0,  // MD ONLY - NOT USED BY ENCDEC
-                                        0);
+                                        0,
+                                        (IntraEdgeCache_t*)EB_NULL);
                                 }
                                 }
                             }
@@ -3077,6 +3103,13 @@ EB_EXTERN void AV1EncodePass(
                         }
                     }
 
+                    // Commit the MD coefficients and recon when MD encoded the block as EP would
+                    MdEncPassCuData_t *md_ep_pipe = &mdcontextPtr->md_ep_pipe_sb[cu_ptr->mds_idx];
+                    EbBool commitMdOutput = (EbBool)(mdcontextPtr->md_output_reuse &&
+                        md_ep_pipe->md_output_valid &&
+                        cu_ptr->qp == mdcontextPtr->qp &&
+                        (cu_ptr->prediction_unit_array[0].merge_flag == EB_TRUE || cu_ptr->skip_flag == EB_FALSE));
+
                     //MC could be avoided in some cases below
                     if (isFirstCUinRow == EB_FALSE) {
 
@@ -3145,7 +3178,7 @@ EB_EXTERN void AV1EncodePass(
                         context_ptr->mv_unit.mv[REF_LIST_1].mvUnion = pu_ptr->mv[REF_LIST_1].mvUnion;
 
                         // Inter Prediction
-                        if (doMC &&
+                        if (doMC && !commitMdOutput &&
                             pu_ptr->motion_mode == WARPED_CAUSAL)
                         {
                             warped_motion_prediction(
@@ -3164,7 +3197,7 @@ EB_EXTERN void AV1EncodePass(
                                 asm_type);
                         }
 
-                        if (doMC &&
+                        if (doMC && !commitMdOutput &&
                             pu_ptr->motion_mode != WARPED_CAUSAL)
                         {
                             if (is16bit) {
@@ -3210,9 +3243,11 @@ EB_EXTERN void AV1EncodePass(
 
                     context_ptr->txb_itr = 0;
                     // Transform Loop
-                    cu_ptr->transform_unit_array[0].y_has_coeff = EB_FALSE;
-                    cu_ptr->transform_unit_array[0].u_has_coeff = EB_FALSE;
-                    cu_ptr->transform_unit_array[0].v_has_coeff = EB_FALSE;
+                    if (commitMdOutput == EB_FALSE) {
+                        cu_ptr->transform_unit_array[0].y_has_coeff = EB_FALSE;
+                        cu_ptr->transform_unit_array[0].u_has_coeff = EB_FALSE;
+                        cu_ptr->transform_unit_array[0].v_has_coeff = EB_FALSE;
+                    }
 
                     // initialize TU Split
                     y_full_distortion[DIST_CALC_RESIDUAL] = 0;
@@ -3228,7 +3263,7 @@ EB_EXTERN void AV1EncodePass(
                     uint8_t    cbQp = cu_ptr->qp;
                     uint32_t  component_mask = context_ptr->blk_geom->has_uv ? PICTURE_BUFFER_DESC_FULL_MASK : PICTURE_BUFFER_DESC_LUMA_MASK;
 
-                    if (cu_ptr->prediction_unit_array[0].merge_flag == EB_FALSE) {
+                    if (cu_ptr->prediction_unit_array[0].merge_flag == EB_FALSE && commitMdOutput == EB_FALSE) {
 
                         for (tuIt = 0; tuIt < totTu; tuIt++) {
                             context_ptr->txb_itr = tuIt;
@@ -3405,6 +3440,15 @@ EB_EXTERN void AV1EncodePass(
                     //reset coeff buffer offsets at the start of a new Tx loop
                     context_ptr->coded_area_sb = coded_area_org;
                     context_ptr->coded_area_sb_uv = coded_area_org_uv;
+
+                    if (commitMdOutput)
+                        EncodePassCommitMdOutput(
+                            context_ptr,
+                            md_ep_pipe,
+                            recon_buffer,
+                            coeff_buffer_sb,
+                            doRecon);
+
                     for (tuIt = 0; tuIt < totTu; tuIt++)
                     {
                         context_ptr->txb_itr = tuIt;
@@ -3417,7 +3461,7 @@ EB_EXTERN void AV1EncodePass(
 
 
                         }
-                        else if ((&cu_ptr->prediction_unit_array[0])->merge_flag == EB_TRUE) {
+                        else if (commitMdOutput == EB_FALSE && (&cu_ptr->prediction_unit_array[0])->merge_flag == EB_TRUE) {
 
                             //inter mode  2
 
@@ -3461,7 +3505,7 @@ EB_EXTERN void AV1EncodePass(
                         }
 
                         //inter mode
-                        if (doRecon)
+                        if (doRecon && commitMdOutput == EB_FALSE)
 
                             Av1EncodeGenerateReconFunctionPtr[is16bit](
                                 context_ptr,
@@ -88,5 +88,10 @@ EbErrorType largest_coding_unit_ctor(
         return EB_ErrorInsufficientResources;
     }
 
+    symbol_stream_start(
+        &largestCodingUnitPtr->symbol_stream,
+        (SymbolChunkPool_t*)EB_NULL,
+        (const aom_cdf_prob*)EB_NULL);
+
     return EB_ErrorNone;
 }
@@ -14,6 +14,7 @@
 #include "EbPredictionUnit.h"
 #include "EbTransformUnit.h"
 #include "EbCabacContextModel.h"
+#include "EbSymbolStream.h"
 #include "hash.h"
 
 #ifdef __cplusplus
@@ -436,6 +437,9 @@ extern "C" {
         EbPictureBufferDesc_t          *quantized_coeff;
         TileInfo tile_info;
 
+        // Symbols recorded in EncDec, coded by Entropy Coding
+        SymbolStream_t                  symbol_stream;
+
     } LargestCodingUnit_t;
 
     extern EbErrorType largest_coding_unit_ctor(
@@ -23,6 +23,8 @@
 #include "EbSequenceControlSet.h"
 #include "EbReferenceObject.h"
 #include "EbDeblockingFilter.h"
+#include "EbPsnr.h"
+#include "EbThreads.h"
 
 #define   convertToChromaQp(iQpY)  ( ((iQpY) < 0) ? (iQpY) : (((iQpY) > 57) ? ((iQpY)-6) : (int32_t)(map_chroma_qp((uint32_t)iQpY))) )
 
@@ -1348,43 +1350,48 @@ void loop_filter_sb(
     }
 }
 
+static void loop_filter_sb_row(
+    EbPictureBufferDesc_t *frame_buffer,
+    PictureControlSet_t   *picture_control_set_ptr,
+    uint32_t               yLcuIndex,
+    int32_t plane_start, int32_t plane_end) {
+
+    SequenceControlSet *scsPtr = (SequenceControlSet*)picture_control_set_ptr->parent_pcs_ptr->sequence_control_set_wrapper_ptr->object_ptr;
+    uint8_t   sb_size_Log2 = (uint8_t)Log2f(scsPtr->sb_size_pix);
+    uint32_t  picture_width_in_sb = (scsPtr->luma_width + scsPtr->sb_size_pix - 1) / scsPtr->sb_size_pix;
+    uint32_t  xLcuIndex;
+
+    for (xLcuIndex = 0; xLcuIndex < picture_width_in_sb; ++xLcuIndex) {
+        loop_filter_sb(
+            frame_buffer,
+            picture_control_set_ptr,
+            NULL,
+            (yLcuIndex << sb_size_Log2) >> 2,
+            (xLcuIndex << sb_size_Log2) >> 2,
+            plane_start,
+            plane_end,
+            (xLcuIndex == picture_width_in_sb - 1) ? EB_TRUE : EB_FALSE);
+    }
+}
+
 void av1_loop_filter_frame(
     EbPictureBufferDesc_t *frame_buffer,
     PictureControlSet_t *picture_control_set_ptr,
     int32_t plane_start, int32_t plane_end) {
 
     SequenceControlSet *scsPtr = (SequenceControlSet*)picture_control_set_ptr->parent_pcs_ptr->sequence_control_set_wrapper_ptr->object_ptr;
-    //LargestCodingUnit_t                     *sb_ptr;
-    //uint16_t                                   sb_index;
-    uint8_t                                   sb_size_Log2 = (uint8_t)Log2f(scsPtr->sb_size_pix);
-    uint32_t                                   xLcuIndex;
     uint32_t                                   yLcuIndex;
-    uint32_t                                   sb_origin_x;
-    uint32_t                                   sb_origin_y;
-    EbBool                                  endOfRowFlag;
 
-    uint32_t picture_width_in_sb = (scsPtr->luma_width + scsPtr->sb_size_pix - 1) / scsPtr->sb_size_pix;
     uint32_t picture_height_in_sb = (scsPtr->luma_height + scsPtr->sb_size_pix - 1) / scsPtr->sb_size_pix;
     av1_loop_filter_frame_init(picture_control_set_ptr, plane_start, plane_end);
 
     for (yLcuIndex = 0; yLcuIndex < picture_height_in_sb; ++yLcuIndex) {
-        for (xLcuIndex = 0; xLcuIndex < picture_width_in_sb; ++xLcuIndex) {
-            //sb_index        = (uint16_t)(yLcuIndex * picture_width_in_sb + xLcuIndex);
-            //sb_ptr          = picture_control_set_ptr->sb_ptr_array[sb_index];
-            sb_origin_x = xLcuIndex << sb_size_Log2;
-            sb_origin_y = yLcuIndex << sb_size_Log2;
-            endOfRowFlag = (xLcuIndex == picture_width_in_sb - 1) ? EB_TRUE : EB_FALSE;
-
-            loop_filter_sb(
-                frame_buffer,
-                picture_control_set_ptr,
-                NULL,
-                sb_origin_y >> 2,
-                sb_origin_x >> 2,
-                plane_start,
-                plane_end,
-                endOfRowFlag);
-        }
+        loop_filter_sb_row(
+            frame_buffer,
+            picture_control_set_ptr,
+            yLcuIndex,
+            plane_start,
+            plane_end);
     }
 
 }
@@ -1467,166 +1474,234 @@ void EbCopyBuffer(
 //    }
 //}
 
-uint64_t PictureSseCalculations(
-    PictureControlSet_t    *picture_control_set_ptr,
-    EbPictureBufferDesc_t *recon_ptr,
-    int32_t plane)
-
-{
-    SequenceControlSet   *sequence_control_set_ptr = picture_control_set_ptr->parent_pcs_ptr->sequence_control_set_ptr;
-    EbBool is16bit = (sequence_control_set_ptr->static_config.encoder_bit_depth > EB_8BIT);
-
-    if (!is16bit) {
+// Lines above an SB row that its top horizontal edge may modify (filters up to 13 taps)
+#define LF_SEARCH_ROW_MARGIN    8
 
-        EbPictureBufferDesc_t *input_picture_ptr = (EbPictureBufferDesc_t*)picture_control_set_ptr->parent_pcs_ptr->enhanced_picture_ptr;
-
-        uint32_t   columnIndex;
-        uint32_t   row_index = 0;
-        uint64_t   residualDistortion = 0;
-        EbByte  inputBuffer;
-        EbByte  reconCoeffBuffer;
-        if (plane == 0) {
-            reconCoeffBuffer = &((recon_ptr->buffer_y)[recon_ptr->origin_x + recon_ptr->origin_y * recon_ptr->stride_y]);
-            inputBuffer = &((input_picture_ptr->buffer_y)[input_picture_ptr->origin_x + input_picture_ptr->origin_y * input_picture_ptr->stride_y]);
+static void copy_buffer_rows(
+    EbPictureBufferDesc_t  *srcBuffer,
+    EbPictureBufferDesc_t  *dstBuffer,
+    PictureControlSet_t    *pcsPtr,
+    int32_t                 plane,
+    int32_t                 row_start,
+    int32_t                 row_end) {
+
+    SequenceControlSet *scsPtr = pcsPtr->parent_pcs_ptr->sequence_control_set_ptr;
+    EbBool   is16bit = (EbBool)(scsPtr->static_config.encoder_bit_depth > EB_8BIT);
+    uint32_t ss = plane ? 1 : 0;
+    uint32_t stride = plane == 0 ? srcBuffer->stride_y : plane == 1 ? srcBuffer->strideCb : srcBuffer->strideCr;
+    uint32_t width = (plane ? scsPtr->chroma_width : scsPtr->luma_width) << is16bit;
+    uint32_t offset = ((srcBuffer->origin_x >> ss) + (srcBuffer->origin_y >> ss) * stride) << is16bit;
+    EbByte   src = (plane == 0 ? srcBuffer->buffer_y : plane == 1 ? srcBuffer->bufferCb : srcBuffer->bufferCr) + offset;
+    EbByte   dst = (plane == 0 ? dstBuffer->buffer_y : plane == 1 ? dstBuffer->bufferCb : dstBuffer->bufferCr) + offset;
+
+    for (int32_t row_index = row_start; row_index < row_end; row_index++)
+        EB_MEMCPY(dst + ((row_index * stride) << is16bit), src + ((row_index * stride) << is16bit), width);
+}
 
-            residualDistortion = 0;
+static int64_t picture_sse_rows(
+    PictureControlSet_t    *pcsPtr,
+    EbPictureBufferDesc_t  *recon_ptr,
+    int32_t                 plane,
+    int32_t                 row_start,
+    int32_t                 row_end) {
+
+    SequenceControlSet *scsPtr = pcsPtr->parent_pcs_ptr->sequence_control_set_ptr;
+    EbBool   is16bit = (EbBool)(scsPtr->static_config.encoder_bit_depth > EB_8BIT);
+    EbPictureBufferDesc_t *input_picture_ptr = is16bit ?
+        (EbPictureBufferDesc_t*)pcsPtr->input_frame16bit :
+        (EbPictureBufferDesc_t*)pcsPtr->parent_pcs_ptr->enhanced_picture_ptr;
+    uint32_t ss = plane ? 1 : 0;
+    int32_t  width = (int32_t)(plane ? scsPtr->chroma_width : scsPtr->luma_width);
+    int32_t  reconStride = plane == 0 ? recon_ptr->stride_y : plane == 1 ? recon_ptr->strideCb : recon_ptr->strideCr;
+    int32_t  inputStride = plane == 0 ? input_picture_ptr->stride_y : plane == 1 ? input_picture_ptr->strideCb : input_picture_ptr->strideCr;
+    EbByte   recon = (plane == 0 ? recon_ptr->buffer_y : plane == 1 ? recon_ptr->bufferCb : recon_ptr->bufferCr) +
+        (((recon_ptr->origin_x >> ss) + ((recon_ptr->origin_y >> ss) + row_start) * reconStride) << is16bit);
+    EbByte   input = (plane == 0 ? input_picture_ptr->buffer_y : plane == 1 ? input_picture_ptr->bufferCb : input_picture_ptr->bufferCr) +
+        (((input_picture_ptr->origin_x >> ss) + ((input_picture_ptr->origin_y >> ss) + row_start) * inputStride) << is16bit);
+
+    if (is16bit)
+        return aom_highbd_get_sse(CONVERT_TO_BYTEPTR(input), inputStride, CONVERT_TO_BYTEPTR(recon), reconStride, width, row_end - row_start);
+
+    return aom_get_sse(input, inputStride, recon, reconStride, width, row_end - row_start);
+}
 
-            while (row_index < sequence_control_set_ptr->luma_height) {
+#define LF_SEARCH_MAX_BANDS     16
 
-                columnIndex = 0;
-                while (columnIndex < sequence_control_set_ptr->luma_width) {
-                    residualDistortion += (int64_t)SQR((int64_t)(inputBuffer[columnIndex]) - (reconCoeffBuffer[columnIndex]));
-                    ++columnIndex;
-                }
-                inputBuffer += input_picture_ptr->stride_y;
-                reconCoeffBuffer += recon_ptr->stride_y;
-                ++row_index;
+/*
+ * A band of SB rows of the loop filter level search. In the full search the bands are filtered
+ * together as a wavefront: the first row of a band filters an SB once the row above has filtered
+ * that SB and the next one, which is all the sequential order guarantees. In the sampled search
+ * the band holds every row_step-th SB row, and the rows do not overlap.
+ */
+typedef struct LfSearchBand {
+    EbPictureBufferDesc_t  *tempLfReconBuffer;
+    EbPictureBufferDesc_t  *recon_buffer;
+    PictureControlSet_t    *pcsPtr;
+    int32_t                 plane;
+    uint32_t                sb_row_start;
+    uint32_t                sb_row_end;
+    uint32_t                row_step;
+    EbHandle                above_semaphore;    // posted by the band above once per SB of its last row
+    EbHandle                below_semaphore;    // posted once per SB of the band's last row
+    int64_t                 filt_err;
+} LfSearchBand;
+
+static void lf_search_band_filter(void *context_ptr) {
+
+    LfSearchBand       *band = (LfSearchBand*)context_ptr;
+    SequenceControlSet *scsPtr = (SequenceControlSet*)band->pcsPtr->parent_pcs_ptr->sequence_control_set_wrapper_ptr->object_ptr;
+    uint8_t   sb_size_Log2 = (uint8_t)Log2f(scsPtr->sb_size_pix);
+    uint32_t  picture_width_in_sb = (scsPtr->luma_width + scsPtr->sb_size_pix - 1) / scsPtr->sb_size_pix;
+    uint32_t  above_done = 0;
+
+    for (uint32_t yLcuIndex = band->sb_row_start; yLcuIndex < band->sb_row_end; ++yLcuIndex) {
+        for (uint32_t xLcuIndex = 0; xLcuIndex < picture_width_in_sb; ++xLcuIndex) {
+            if (yLcuIndex == band->sb_row_start && band->above_semaphore) {
+                for (; above_done < MIN(xLcuIndex + 2, picture_width_in_sb); ++above_done)
+                    eb_block_on_semaphore(band->above_semaphore);
             }
-
-            return residualDistortion;
+            loop_filter_sb(
+                band->recon_buffer,
+                band->pcsPtr,
+                NULL,
+                (yLcuIndex << sb_size_Log2) >> 2,
+                (xLcuIndex << sb_size_Log2) >> 2,
+                band->plane,
+                band->plane + 1,
+                (xLcuIndex == picture_width_in_sb - 1) ? EB_TRUE : EB_FALSE);
+            if (yLcuIndex == band->sb_row_end - 1 && band->below_semaphore)
+                eb_post_semaphore(band->below_semaphore);
         }
+    }
+}
 
-        else if (plane == 1) {
-
-            reconCoeffBuffer = &((recon_ptr->bufferCb)[recon_ptr->origin_x / 2 + recon_ptr->origin_y / 2 * recon_ptr->strideCb]);
-            inputBuffer = &((input_picture_ptr->bufferCb)[input_picture_ptr->origin_x / 2 + input_picture_ptr->origin_y / 2 * input_picture_ptr->strideCb]);
-
-            residualDistortion = 0;
-            row_index = 0;
-            while (row_index < sequence_control_set_ptr->chroma_height) {
+// Once every band is filtered: measures the band's rows and restores them from the unfiltered copy
+static void lf_search_band_measure(void *context_ptr) {
 
-                columnIndex = 0;
-                while (columnIndex < sequence_control_set_ptr->chroma_width) {
-                    residualDistortion += (int64_t)SQR((int64_t)(inputBuffer[columnIndex]) - (reconCoeffBuffer[columnIndex]));
-                    ++columnIndex;
-                }
-
-                inputBuffer += input_picture_ptr->strideCb;
-                reconCoeffBuffer += recon_ptr->strideCb;
-                ++row_index;
-            }
+    LfSearchBand       *band = (LfSearchBand*)context_ptr;
+    SequenceControlSet *scsPtr = band->pcsPtr->parent_pcs_ptr->sequence_control_set_ptr;
+    uint32_t ss = band->plane ? 1 : 0;
+    int32_t  plane_height = (int32_t)(band->plane ? scsPtr->chroma_height : scsPtr->luma_height);
+    int32_t  row_start = (int32_t)((band->sb_row_start * scsPtr->sb_size_pix) >> ss);
+    int32_t  row_end = MIN((int32_t)((band->sb_row_end * scsPtr->sb_size_pix) >> ss), plane_height);
 
-            return residualDistortion;
-        }
-        else if (plane == 2) {
-            reconCoeffBuffer = &((recon_ptr->bufferCr)[recon_ptr->origin_x / 2 + recon_ptr->origin_y / 2 * recon_ptr->strideCr]);
-            inputBuffer = &((input_picture_ptr->bufferCr)[input_picture_ptr->origin_x / 2 + input_picture_ptr->origin_y / 2 * input_picture_ptr->strideCr]);
-            residualDistortion = 0;
-            row_index = 0;
-
-            while (row_index < sequence_control_set_ptr->chroma_height) {
-
-                columnIndex = 0;
-                while (columnIndex < sequence_control_set_ptr->chroma_width) {
-                    residualDistortion += (int64_t)SQR((int64_t)(inputBuffer[columnIndex]) - (reconCoeffBuffer[columnIndex]));
-                    ++columnIndex;
-                }
-
-                inputBuffer += input_picture_ptr->strideCr;
-                reconCoeffBuffer += recon_ptr->strideCr;
-                ++row_index;
-            }
+    band->filt_err = picture_sse_rows(band->pcsPtr, band->recon_buffer, band->plane, row_start, row_end);
+    copy_buffer_rows(band->tempLfReconBuffer, band->recon_buffer, band->pcsPtr, band->plane, row_start, row_end);
+}
 
-            return residualDistortion;
-        }
-        return 0;
+/*
+ * Each sampled row is restored from the unfiltered copy right after its SSE is taken, together
+ * with the lines above it that its top edge touched, so the rows are independent and the
+ * estimate is deterministic.
+ */
+static void lf_search_band_sampled(void *context_ptr) {
+
+    LfSearchBand       *band = (LfSearchBand*)context_ptr;
+    SequenceControlSet *scsPtr = band->pcsPtr->parent_pcs_ptr->sequence_control_set_ptr;
+    uint32_t ss = band->plane ? 1 : 0;
+    int32_t  plane_height = (int32_t)(band->plane ? scsPtr->chroma_height : scsPtr->luma_height);
+
+    band->filt_err = 0;
+    for (uint32_t yLcuIndex = band->sb_row_start; yLcuIndex < band->sb_row_end; yLcuIndex += band->row_step) {
+        int32_t row_start = (int32_t)((yLcuIndex * scsPtr->sb_size_pix) >> ss);
+        int32_t row_end = MIN((int32_t)(((yLcuIndex + 1) * scsPtr->sb_size_pix) >> ss), plane_height);
+
+        loop_filter_sb_row(band->recon_buffer, band->pcsPtr, yLcuIndex, band->plane, band->plane + 1);
+        band->filt_err += picture_sse_rows(band->pcsPtr, band->recon_buffer, band->plane, row_start, row_end);
+        copy_buffer_rows(band->tempLfReconBuffer, band->recon_buffer, band->pcsPtr, band->plane, MAX(row_start - LF_SEARCH_ROW_MARGIN, 0), row_end);
     }
-    else {
-        EbPictureBufferDesc_t *input_picture_ptr = (EbPictureBufferDesc_t*)picture_control_set_ptr->input_frame16bit;
-
-        uint32_t   columnIndex;
-        uint32_t   row_index = 0;
-        uint64_t   residualDistortion = 0;
-        uint16_t*  inputBuffer;
-        uint16_t*  reconCoeffBuffer;
-        if (plane == 0) {
-            reconCoeffBuffer = (uint16_t*)&((recon_ptr->buffer_y)[(recon_ptr->origin_x + recon_ptr->origin_y * recon_ptr->stride_y) << is16bit]);
-            inputBuffer = (uint16_t*)&((input_picture_ptr->buffer_y)[(input_picture_ptr->origin_x + input_picture_ptr->origin_y * input_picture_ptr->stride_y) << is16bit]);
-
-            residualDistortion = 0;
+}
 
-            while (row_index < sequence_control_set_ptr->luma_height) {
+/*
+ * Filters the plane at the current level, measures it against the source and restores it. The
+ * SB rows are split in bands that run on the encoder's worker pool, the search filters only
+ * every loop_filter_search_row_step-th SB row when the step is above 1.
+ */
+static int64_t try_filter_frame_bands(
+    EbPictureBufferDesc_t  *tempLfReconBuffer,
+    EbPictureBufferDesc_t  *recon_buffer,
+    PictureControlSet_t    *pcsPtr,
+    int32_t                 plane) {
 
-                columnIndex = 0;
-                while (columnIndex < sequence_control_set_ptr->luma_width) {
-                    residualDistortion += (int64_t)SQR(((int64_t)inputBuffer[columnIndex]) - (int64_t)(reconCoeffBuffer[columnIndex]));
-                    ++columnIndex;
-                }
+    SequenceControlSet *scsPtr = pcsPtr->parent_pcs_ptr->sequence_control_set_ptr;
+    WorkerPool_t *pool_ptr = scsPtr->encode_context_ptr->worker_pool;
+    uint32_t row_step = pcsPtr->parent_pcs_ptr->loop_filter_search_row_step;
+    uint32_t picture_width_in_sb = (scsPtr->luma_width + scsPtr->sb_size_pix - 1) / scsPtr->sb_size_pix;
+    uint32_t picture_height_in_sb = (scsPtr->luma_height + scsPtr->sb_size_pix - 1) / scsPtr->sb_size_pix;
+    // Centre the samples in their band so neither picture border is over-represented
+    uint32_t first_row = row_step >> 1;
+    uint32_t row_count = picture_height_in_sb > first_row ? (picture_height_in_sb - first_row + row_step - 1) / row_step : 0;
+    uint32_t band_count = pool_ptr ? MIN(MIN(pool_ptr->thread_count + 1, row_count), LF_SEARCH_MAX_BANDS) : 1;
+    LfSearchBand bands[LF_SEARCH_MAX_BANDS];
+    WorkerTask_t tasks[LF_SEARCH_MAX_BANDS];
+    EbHandle     boundary_semaphores[LF_SEARCH_MAX_BANDS];
+    EbHandle     done_semaphore = (EbHandle)EB_NULL;
+    int64_t      filt_err = 0;
+    uint32_t     band_index;
+
+    av1_loop_filter_frame_init(pcsPtr, plane, plane + 1);
+
+    if (row_count == 0)
+        return 0;
 
-                inputBuffer += input_picture_ptr->stride_y;
-                reconCoeffBuffer += recon_ptr->stride_y;
-                ++row_index;
+    if (band_count > 1) {
+        EbBool semaphores_created;
+        done_semaphore = eb_create_semaphore(0, band_count);
+        semaphores_created = (EbBool)(done_semaphore != EB_NULL);
+        for (band_index = 0; band_index < band_count - 1; ++band_index) {
+            boundary_semaphores[band_index] = row_step > 1 ? (EbHandle)EB_NULL : eb_create_semaphore(0, picture_width_in_sb);
+            if (row_step == 1 && !boundary_semaphores[band_index])
+                semaphores_created = EB_FALSE;
+        }
+        // Filter on the calling thread only when the semaphores are not available
+        if (!semaphores_created) {
+            for (band_index = 0; band_index < band_count - 1; ++band_index) {
+                if (boundary_semaphores[band_index])
+                    eb_destroy_semaphore(boundary_semaphores[band_index]);
             }
-
-            return residualDistortion;
+            if (done_semaphore)
+                eb_destroy_semaphore(done_semaphore);
+            done_semaphore = (EbHandle)EB_NULL;
+            band_count = 1;
         }
+    }
 
-        else if (plane == 1) {
-
-            reconCoeffBuffer = (uint16_t*)&((recon_ptr->bufferCb)[(recon_ptr->origin_x / 2 + recon_ptr->origin_y / 2 * recon_ptr->strideCb) << is16bit]);
-            inputBuffer = (uint16_t*)&((input_picture_ptr->bufferCb)[(input_picture_ptr->origin_x / 2 + input_picture_ptr->origin_y / 2 * input_picture_ptr->strideCb) << is16bit]);
-
-            residualDistortion = 0;
-            row_index = 0;
-            while (row_index < sequence_control_set_ptr->chroma_height) {
-
-                columnIndex = 0;
-                while (columnIndex < sequence_control_set_ptr->chroma_width) {
-                    residualDistortion += (int64_t)SQR(((int64_t)inputBuffer[columnIndex]) - (int64_t)(reconCoeffBuffer[columnIndex]));
-                    ++columnIndex;
-                }
-
-                inputBuffer += input_picture_ptr->strideCb;
-                reconCoeffBuffer += recon_ptr->strideCb;
-                ++row_index;
-            }
+    for (band_index = 0; band_index < band_count; ++band_index) {
+        LfSearchBand *band = &bands[band_index];
+        band->tempLfReconBuffer = tempLfReconBuffer;
+        band->recon_buffer = recon_buffer;
+        band->pcsPtr = pcsPtr;
+        band->plane = plane;
+        band->sb_row_start = first_row + row_count * band_index / band_count * row_step;
+        band->sb_row_end = MIN(first_row + row_count * (band_index + 1) / band_count * row_step, picture_height_in_sb);
+        band->row_step = row_step;
+        band->above_semaphore = (row_step == 1 && band_index > 0) ? boundary_semaphores[band_index - 1] : (EbHandle)EB_NULL;
+        band->below_semaphore = (row_step == 1 && band_index < band_count - 1) ? boundary_semaphores[band_index] : (EbHandle)EB_NULL;
+        band->filt_err = 0;
+        tasks[band_index].run = row_step > 1 ? lf_search_band_sampled : lf_search_band_filter;
+        tasks[band_index].context_ptr = band;
+        tasks[band_index].done_semaphore = done_semaphore;
+    }
 
-            return residualDistortion;
-        }
-        else if (plane == 2) {
-            reconCoeffBuffer = (uint16_t*)&((recon_ptr->bufferCr)[(recon_ptr->origin_x / 2 + recon_ptr->origin_y / 2 * recon_ptr->strideCr) << is16bit]);
-            inputBuffer = (uint16_t*)&((input_picture_ptr->bufferCr)[(input_picture_ptr->origin_x / 2 + input_picture_ptr->origin_y / 2 * input_picture_ptr->strideCr) << is16bit]);
-            residualDistortion = 0;
-            row_index = 0;
-
-            while (row_index < sequence_control_set_ptr->chroma_height) {
-
-                columnIndex = 0;
-                while (columnIndex < sequence_control_set_ptr->chroma_width) {
-                    residualDistortion += (int64_t)SQR(((int64_t)inputBuffer[columnIndex]) - (int64_t)(reconCoeffBuffer[columnIndex]));
-                    ++columnIndex;
-                }
+    worker_pool_run(pool_ptr, tasks, band_count);
 
-                inputBuffer += input_picture_ptr->strideCr;
-                reconCoeffBuffer += recon_ptr->strideCr;
-                ++row_index;
-            }
+    // A band's last rows are final only once the band below has filtered its first row
+    if (row_step == 1) {
+        for (band_index = 0; band_index < band_count; ++band_index)
+            tasks[band_index].run = lf_search_band_measure;
+        worker_pool_run(pool_ptr, tasks, band_count);
+    }
 
-            return residualDistortion;
-        }
+    for (band_index = 0; band_index < band_count; ++band_index)
+        filt_err += bands[band_index].filt_err;
 
-        return 0;
+    if (band_count > 1) {
+        for (band_index = 0; row_step == 1 && band_index < band_count - 1; ++band_index)
+            eb_destroy_semaphore(boundary_semaphores[band_index]);
+        eb_destroy_semaphore(done_semaphore);
     }
+
+    return filt_err;
 }
 
 static int64_t try_filter_frame(
@@ -1673,14 +1748,8 @@ static int64_t try_filter_frame(
     case 2: pcsPtr->parent_pcs_ptr->lf.filter_level_v = filter_level[0]; break;
     }
 
-    av1_loop_filter_frame(recon_buffer, pcsPtr, plane, plane + 1);
-
-    filt_err = PictureSseCalculations(pcsPtr, recon_buffer, plane);
-
-
-
-    // Re-instate the unfiltered frame
-    EbCopyBuffer(tempLfReconBuffer/*cpi->last_frame_uf*/, recon_buffer /*cm->frame_to_show*/, pcsPtr, (uint8_t)plane);
+    // Filter, measure, and re-instate the unfiltered frame
+    filt_err = try_filter_frame_bands(tempLfReconBuffer, recon_buffer, pcsPtr, plane);
 
     return filt_err;
 }
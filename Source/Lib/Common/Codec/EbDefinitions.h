@@ -1765,6 +1765,13 @@ static const EbWarpedMotionParams default_warp_params = {
 
 #define SC_SPEED_T2             1250 // speed level thershold. If speed is higher than target speed x SC_SPEED_T2, a slower mode is selected (+25% x 1000 (for precision))
 #define SC_SPEED_T1              750 // speed level thershold. If speed is less than target speed x SC_SPEED_T1, a fast mode is selected (-25% x 1000 (for precision))
+
+#define DL_MAX_SPEED_LEVEL         6 // Deadline mode: maximum number of speed-up steps applied on top of the preset per stage (ME / MD)
+#define DL_FRAMES_INTERVAL         4 // Deadline mode: number of output pictures between two speed level updates
+#define DL_FRAMES_TO_IGNORE        8 // Deadline mode: the speed level is not updated before DL_FRAMES_TO_IGNORE pictures are output (pipeline fill)
+#define DL_EMA_SHIFT               3 // Deadline mode: smoothing of the measured times (weight of the new sample = 1 / (1 << DL_EMA_SHIFT))
+#define DL_SPEED_UP_TH          1050 // Deadline mode: if the time per picture is higher than the frame period x DL_SPEED_UP_TH, the next pictures are made faster (+5% x 1000 (for precision))
+#define DL_SLOW_DOWN_TH          850 // Deadline mode: if the time per picture is less than the frame period x DL_SLOW_DOWN_TH, the next pictures are made slower (-15% x 1000 (for precision))
 #define EB_CMPLX_CLASS           uint8_t
 #define CMPLX_LOW                0
 #define CMPLX_MEDIUM             1
@@ -20,9 +20,11 @@
 #include "EbEncDecResults.h"
 #include "EbPictureDemuxResults.h"
 #include "EbCodingLoop.h"
+#include "EbEntropyCoding.h"
 #include "EbSvtAv1ErrorCodes.h"
 #include "EbDeblockingFilter.h"
 #include "grainSynthesis.h"
+#include "EbSvtAv1Time.h"
 
 void av1_cdef_search(
     EncDecContext_t                *context_ptr,
@@ -84,7 +86,9 @@ EbErrorType enc_dec_context_ctor(
     EbFifo                *feedback_fifo_ptr,
     EbFifo                *picture_demux_fifo_ptr,
     EbBool                  is16bit,
+    EbBool                  hbd_mode_decision,
     EbColorFormat           color_format,
+    uint16_t                sb_size,
     uint32_t                max_input_luma_width,
     uint32_t                max_input_luma_height){
 
@@ -110,35 +114,6 @@ EbErrorType enc_dec_context_ctor(
     EB_MALLOC(MdRateEstimationContext_t*, context_ptr->md_rate_estimation_ptr, sizeof(MdRateEstimationContext_t), EB_N_PTR);
 
 
-    // Prediction Buffer
-    {
-        EbPictureBufferDescInitData_t initData;
-
-        initData.bufferEnableMask = PICTURE_BUFFER_DESC_FULL_MASK;
-        initData.maxWidth = SB_STRIDE_Y;
-        initData.maxHeight = SB_STRIDE_Y;
-        initData.bit_depth = EB_8BIT;
-        initData.left_padding = 0;
-        initData.right_padding = 0;
-        initData.top_padding = 0;
-        initData.bot_padding = 0;
-        initData.splitMode = EB_FALSE;
-        initData.color_format = color_format;
-
-        context_ptr->input_sample16bit_buffer = (EbPictureBufferDesc_t *)EB_NULL;
-        if (is16bit) {
-            initData.bit_depth = EB_16BIT;
-
-            return_error = eb_picture_buffer_desc_ctor(
-                (EbPtr*)&context_ptr->input_sample16bit_buffer,
-                (EbPtr)&initData);
-            if (return_error == EB_ErrorInsufficientResources) {
-                return EB_ErrorInsufficientResources;
-            }
-        }
-
-    }
-
     // Scratch Coeff Buffer
     {
         EbPictureBufferDescInitData_t initData;
@@ -202,7 +177,7 @@ EbErrorType enc_dec_context_ctor(
         }
     }
     // Mode Decision Context
-    return_error = mode_decision_context_ctor(&context_ptr->md_context, color_format, 0, 0);
+    return_error = mode_decision_context_ctor(&context_ptr->md_context, color_format, is16bit, hbd_mode_decision, sb_size, 0, 0);
 
     if (return_error == EB_ErrorInsufficientResources) {
         return EB_ErrorInsufficientResources;
@@ -275,7 +250,7 @@ static void ResetEncDec(
         &context_ptr->full_lambda,
         &context_ptr->fast_chroma_lambda,
         &context_ptr->full_chroma_lambda,
-        (uint8_t)picture_control_set_ptr->parent_pcs_ptr->enhanced_picture_ptr->bit_depth,
+        (uint8_t)sequence_control_set_ptr->static_config.encoder_bit_depth,
         context_ptr->qp_index);
 
     // Slice Type
@@ -302,6 +277,7 @@ static void ResetEncDec(
         context_ptr->reference_object_write_ptr = (EbReferenceObject*)EB_NULL;
     if (segment_index == 0) {
         ResetEncodePassNeighborArrays(picture_control_set_ptr);
+        EntropyCodingResetNeighborArrays(picture_control_set_ptr);
     }
 
 
@@ -340,7 +316,7 @@ static void EncDecConfigureLcu(
         &context_ptr->full_lambda,
         &context_ptr->fast_chroma_lambda,
         &context_ptr->full_chroma_lambda,
-        (uint8_t)picture_control_set_ptr->parent_pcs_ptr->enhanced_picture_ptr->bit_depth,
+        (uint8_t)sequence_control_set_ptr->static_config.encoder_bit_depth,
         context_ptr->qp_index);
 
     return;
@@ -523,6 +499,7 @@ EbBool AssignEncDecSegments(
 }
 void ReconOutput(
     PictureControlSet_t    *picture_control_set_ptr,
+    EbObjectWrapper        *picture_control_set_wrapper_ptr,
     SequenceControlSet   *sequence_control_set_ptr) {
 
     EbObjectWrapper             *outputReconWrapperPtr;
@@ -595,436 +572,114 @@ void ReconOutput(
         }
 
         // End running the film grain
-        // Y Recon Samples
-        sampleTotalCount = ((recon_ptr->maxWidth - sequence_control_set_ptr->max_input_pad_right) * (recon_ptr->maxHeight - sequence_control_set_ptr->max_input_pad_bottom)) << is16bit;
-        reconReadPtr = recon_ptr->buffer_y + (recon_ptr->origin_y << is16bit) * recon_ptr->stride_y + (recon_ptr->origin_x << is16bit);
-        reconWritePtr = &(outputReconPtr->p_buffer[outputReconPtr->n_filled_len]);
-
-        CHECK_REPORT_ERROR(
-            (outputReconPtr->n_filled_len + sampleTotalCount <= outputReconPtr->n_alloc_len),
-            encode_context_ptr->app_callback_ptr,
-            EB_ENC_ROB_OF_ERROR);
-
-        // Initialize Y recon buffer
-        picture_copy_kernel(
-            reconReadPtr,
-            recon_ptr->stride_y,
-            reconWritePtr,
-            recon_ptr->maxWidth - sequence_control_set_ptr->max_input_pad_right,
-            recon_ptr->width - sequence_control_set_ptr->pad_right,
-            recon_ptr->height - sequence_control_set_ptr->pad_bottom,
-            1 << is16bit);
-
-        outputReconPtr->n_filled_len += sampleTotalCount;
-
-        // U Recon Samples
-        sampleTotalCount = ((recon_ptr->maxWidth - sequence_control_set_ptr->max_input_pad_right) * (recon_ptr->maxHeight - sequence_control_set_ptr->max_input_pad_bottom) >> 2) << is16bit;
-        reconReadPtr = recon_ptr->bufferCb + ((recon_ptr->origin_y << is16bit) >> 1) * recon_ptr->strideCb + ((recon_ptr->origin_x << is16bit) >> 1);
-        reconWritePtr = &(outputReconPtr->p_buffer[outputReconPtr->n_filled_len]);
-
-        CHECK_REPORT_ERROR(
-            (outputReconPtr->n_filled_len + sampleTotalCount <= outputReconPtr->n_alloc_len),
-            encode_context_ptr->app_callback_ptr,
-            EB_ENC_ROB_OF_ERROR);
-
-        // Initialize U recon buffer
-        picture_copy_kernel(
-            reconReadPtr,
-            recon_ptr->strideCb,
-            reconWritePtr,
-            (recon_ptr->maxWidth - sequence_control_set_ptr->max_input_pad_right) >> 1,
-            (recon_ptr->width - sequence_control_set_ptr->pad_right) >> 1,
-            (recon_ptr->height - sequence_control_set_ptr->pad_bottom) >> 1,
-            1 << is16bit);
-        outputReconPtr->n_filled_len += sampleTotalCount;
-
-        // V Recon Samples
-        sampleTotalCount = ((recon_ptr->maxWidth - sequence_control_set_ptr->max_input_pad_right) * (recon_ptr->maxHeight - sequence_control_set_ptr->max_input_pad_bottom) >> 2) << is16bit;
-        reconReadPtr = recon_ptr->bufferCr + ((recon_ptr->origin_y << is16bit) >> 1) * recon_ptr->strideCr + ((recon_ptr->origin_x << is16bit) >> 1);
-        reconWritePtr = &(outputReconPtr->p_buffer[outputReconPtr->n_filled_len]);
-
-        CHECK_REPORT_ERROR(
-            (outputReconPtr->n_filled_len + sampleTotalCount <= outputReconPtr->n_alloc_len),
-            encode_context_ptr->app_callback_ptr,
-            EB_ENC_ROB_OF_ERROR);
-
-        // Initialize V recon buffer
-
-        picture_copy_kernel(
-            reconReadPtr,
-            recon_ptr->strideCr,
-            reconWritePtr,
-            (recon_ptr->maxWidth - sequence_control_set_ptr->max_input_pad_right) >> 1,
-            (recon_ptr->width - sequence_control_set_ptr->pad_right) >> 1,
-            (recon_ptr->height - sequence_control_set_ptr->pad_bottom) >> 1,
-            1 << is16bit);
-        outputReconPtr->n_filled_len += sampleTotalCount;
-        outputReconPtr->pts = picture_control_set_ptr->picture_number;
-    }
-
-    // Post the Recon object
-    eb_post_full_object(outputReconWrapperPtr);
-    eb_release_mutex(encode_context_ptr->total_number_of_recon_frame_mutex);
-}
-
-void PsnrCalculations(
-    PictureControlSet_t    *picture_control_set_ptr,
-    SequenceControlSet   *sequence_control_set_ptr){
-
-    EbBool is16bit = (sequence_control_set_ptr->static_config.encoder_bit_depth > EB_8BIT);
-
-    if (!is16bit) {
-
-        EbPictureBufferDesc_t *recon_ptr;
-
-        if (picture_control_set_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE)
-            recon_ptr = ((EbReferenceObject*)picture_control_set_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)->reference_picture;
-        else
-            recon_ptr = picture_control_set_ptr->recon_picture_ptr;
-
-        EbPictureBufferDesc_t *input_picture_ptr = (EbPictureBufferDesc_t*)picture_control_set_ptr->parent_pcs_ptr->enhanced_picture_ptr;
-
-        uint64_t sseTotal[3] = { 0 };
-        uint32_t   columnIndex;
-        uint32_t   row_index = 0;
-        uint64_t   residualDistortion = 0;
-        EbByte  inputBuffer;
-        EbByte  reconCoeffBuffer;
-
-        reconCoeffBuffer = &((recon_ptr->buffer_y)[recon_ptr->origin_x + recon_ptr->origin_y * recon_ptr->stride_y]);
-        inputBuffer = &((input_picture_ptr->buffer_y)[input_picture_ptr->origin_x + input_picture_ptr->origin_y * input_picture_ptr->stride_y]);
-
-        residualDistortion = 0;
-
-        while (row_index < sequence_control_set_ptr->luma_height) {
-
-            columnIndex = 0;
-            while (columnIndex < sequence_control_set_ptr->luma_width) {
-                residualDistortion += (int64_t)SQR((int64_t)(inputBuffer[columnIndex]) - (reconCoeffBuffer[columnIndex]));
-                ++columnIndex;
+        if (sequence_control_set_ptr->static_config.recon_enabled == 2) {
+            // Hand out the planes in place and hold whichever object owns them
+            ReconView_t *recon_view = (ReconView_t*)outputReconPtr->p_buffer;
+            const uint32_t width = recon_ptr->width - sequence_control_set_ptr->pad_right;
+            const uint32_t height = recon_ptr->height - sequence_control_set_ptr->pad_bottom;
+
+            recon_view->planes.luma = recon_ptr->buffer_y + ((recon_ptr->origin_y * recon_ptr->stride_y + recon_ptr->origin_x) << is16bit);
+            recon_view->planes.cb = recon_ptr->bufferCb + (((recon_ptr->origin_y >> 1) * recon_ptr->strideCb + (recon_ptr->origin_x >> 1)) << is16bit);
+            recon_view->planes.cr = recon_ptr->bufferCr + (((recon_ptr->origin_y >> 1) * recon_ptr->strideCr + (recon_ptr->origin_x >> 1)) << is16bit);
+            recon_view->planes.luma_ext = recon_view->planes.cb_ext = recon_view->planes.cr_ext = (uint8_t*)EB_NULL;
+            recon_view->planes.y_stride = recon_ptr->stride_y;
+            recon_view->planes.cb_stride = recon_ptr->strideCb;
+            recon_view->planes.cr_stride = recon_ptr->strideCr;
+            recon_view->planes.width = width;
+            recon_view->planes.height = height;
+            recon_view->planes.origin_x = 0;
+            recon_view->planes.origin_y = 0;
+
+            recon_view->picture_control_set_wrapper_ptr = (EbObjectWrapper*)EB_NULL;
+            recon_view->reference_picture_wrapper_ptr = (EbObjectWrapper*)EB_NULL;
+            if (picture_control_set_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE && !sequence_control_set_ptr->film_grain_params_present) {
+                recon_view->reference_picture_wrapper_ptr = picture_control_set_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr;
+                eb_object_inc_live_count(
+                    recon_view->reference_picture_wrapper_ptr,
+                    1);
             }
-
-            inputBuffer += input_picture_ptr->stride_y;
-            reconCoeffBuffer += recon_ptr->stride_y;
-            ++row_index;
-        }
-
-        sseTotal[0] = residualDistortion;
-
-        reconCoeffBuffer = &((recon_ptr->bufferCb)[recon_ptr->origin_x / 2 + recon_ptr->origin_y / 2 * recon_ptr->strideCb]);
-        inputBuffer = &((input_picture_ptr->bufferCb)[input_picture_ptr->origin_x / 2 + input_picture_ptr->origin_y / 2 * input_picture_ptr->strideCb]);
-
-        residualDistortion = 0;
-        row_index = 0;
-        while (row_index < sequence_control_set_ptr->chroma_height) {
-
-            columnIndex = 0;
-            while (columnIndex < sequence_control_set_ptr->chroma_width) {
-                residualDistortion += (int64_t)SQR((int64_t)(inputBuffer[columnIndex]) - (reconCoeffBuffer[columnIndex]));
-                ++columnIndex;
-            }
-
-            inputBuffer += input_picture_ptr->strideCb;
-            reconCoeffBuffer += recon_ptr->strideCb;
-            ++row_index;
-        }
-
-        sseTotal[1] = residualDistortion;
-
-        reconCoeffBuffer = &((recon_ptr->bufferCr)[recon_ptr->origin_x / 2 + recon_ptr->origin_y / 2 * recon_ptr->strideCr]);
-        inputBuffer = &((input_picture_ptr->bufferCr)[input_picture_ptr->origin_x / 2 + input_picture_ptr->origin_y / 2 * input_picture_ptr->strideCr]);
-        residualDistortion = 0;
-        row_index = 0;
-
-        while (row_index < sequence_control_set_ptr->chroma_height) {
-
-            columnIndex = 0;
-            while (columnIndex < sequence_control_set_ptr->chroma_width) {
-                residualDistortion += (int64_t)SQR((int64_t)(inputBuffer[columnIndex]) - (reconCoeffBuffer[columnIndex]));
-                ++columnIndex;
-            }
-
-            inputBuffer += input_picture_ptr->strideCr;
-            reconCoeffBuffer += recon_ptr->strideCr;
-            ++row_index;
-        }
-
-        sseTotal[2] = residualDistortion;
-        picture_control_set_ptr->parent_pcs_ptr->luma_sse = (uint32_t)sseTotal[0];
-        picture_control_set_ptr->parent_pcs_ptr->cr_sse = (uint32_t)sseTotal[1];
-        picture_control_set_ptr->parent_pcs_ptr->cb_sse = (uint32_t)sseTotal[2];
-    }
-    else {
-
-        EbPictureBufferDesc_t *recon_ptr;
-
-        if (picture_control_set_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE)
-            recon_ptr = ((EbReferenceObject*)picture_control_set_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)->reference_picture16bit;
-        else
-            recon_ptr = picture_control_set_ptr->recon_picture16bit_ptr;
-        EbPictureBufferDesc_t *input_picture_ptr = (EbPictureBufferDesc_t*)picture_control_set_ptr->parent_pcs_ptr->enhanced_picture_ptr;
-
-        uint64_t sseTotal[3] = { 0 };
-        uint32_t   columnIndex;
-        uint32_t   row_index = 0;
-        uint64_t   residualDistortion = 0;
-        EbByte  inputBuffer;
-        EbByte  inputBufferBitInc;
-        uint16_t*  reconCoeffBuffer;
-
-        if (sequence_control_set_ptr->static_config.ten_bit_format == 1) {
-
-            const uint32_t luma_width = sequence_control_set_ptr->luma_width;
-            const uint32_t luma_height = sequence_control_set_ptr->luma_height;
-            const uint32_t chroma_width = sequence_control_set_ptr->chroma_width;
-            const uint32_t picture_width_in_sb = (luma_width + 64 - 1) / 64;
-            const uint32_t pictureHeighInLcu = (luma_height + 64 - 1) / 64;
-            const uint32_t luma2BitWidth = luma_width / 4;
-            const uint32_t chroma_height = luma_height / 2;
-            const uint32_t chroma2BitWidth = luma_width / 8;
-            uint32_t lcuNumberInHeight, lcuNumberInWidth;
-
-            EbByte  inputBufferOrg = &((input_picture_ptr->buffer_y)[input_picture_ptr->origin_x + input_picture_ptr->origin_y * input_picture_ptr->stride_y]);
-            uint16_t*  reconBufferOrg = (uint16_t*)(&((recon_ptr->buffer_y)[(recon_ptr->origin_x << is16bit) + (recon_ptr->origin_y << is16bit) * recon_ptr->stride_y]));;
-
-            EbByte  inputBufferOrgU = &((input_picture_ptr->bufferCb)[input_picture_ptr->origin_x / 2 + input_picture_ptr->origin_y / 2 * input_picture_ptr->strideCb]);;
-            uint16_t*  reconBufferOrgU = reconCoeffBuffer = (uint16_t*)(&((recon_ptr->bufferCb)[(recon_ptr->origin_x << is16bit) / 2 + (recon_ptr->origin_y << is16bit) / 2 * recon_ptr->strideCb]));;
-
-            EbByte  inputBufferOrgV = &((input_picture_ptr->bufferCr)[input_picture_ptr->origin_x / 2 + input_picture_ptr->origin_y / 2 * input_picture_ptr->strideCr]);;
-            uint16_t*  reconBufferOrgV = reconCoeffBuffer = (uint16_t*)(&((recon_ptr->bufferCr)[(recon_ptr->origin_x << is16bit) / 2 + (recon_ptr->origin_y << is16bit) / 2 * recon_ptr->strideCr]));;
-
-            residualDistortion = 0;
-            uint64_t residualDistortionU = 0;
-            uint64_t residualDistortionV = 0;
-
-            for (lcuNumberInHeight = 0; lcuNumberInHeight < pictureHeighInLcu; ++lcuNumberInHeight)
-            {
-                for (lcuNumberInWidth = 0; lcuNumberInWidth < picture_width_in_sb; ++lcuNumberInWidth)
-                {
-
-                    uint32_t tbOriginX = lcuNumberInWidth * 64;
-                    uint32_t tbOriginY = lcuNumberInHeight * 64;
-                    uint32_t sb_width = (luma_width - tbOriginX) < 64 ? (luma_width - tbOriginX) : 64;
-                    uint32_t sb_height = (luma_height - tbOriginY) < 64 ? (luma_height - tbOriginY) : 64;
-
-                    inputBuffer = inputBufferOrg + tbOriginY * input_picture_ptr->stride_y + tbOriginX;
-                    inputBufferBitInc = input_picture_ptr->bufferBitIncY + tbOriginY * luma2BitWidth + (tbOriginX / 4)*sb_height;
-                    reconCoeffBuffer = reconBufferOrg + tbOriginY * recon_ptr->stride_y + tbOriginX;
-
-                    uint64_t   j, k;
-                    uint16_t   outPixel;
-                    uint8_t    nBitPixel;
-                    uint8_t   four2bitPels;
-                    uint32_t     inn_stride = sb_width / 4;
-
-                    for (j = 0; j < sb_height; j++)
-                    {
-                        for (k = 0; k < sb_width / 4; k++)
-                        {
-
-                            four2bitPels = inputBufferBitInc[k + j * inn_stride];
-
-                            nBitPixel = (four2bitPels >> 6) & 3;
-                            outPixel = inputBuffer[k * 4 + 0 + j * input_picture_ptr->stride_y] << 2;
-                            outPixel = outPixel | nBitPixel;
-                            residualDistortion += (int64_t)SQR((int64_t)outPixel - (int64_t)reconCoeffBuffer[k * 4 + 0 + j * recon_ptr->stride_y]);
-
-
-                            nBitPixel = (four2bitPels >> 4) & 3;
-                            outPixel = inputBuffer[k * 4 + 1 + j * input_picture_ptr->stride_y] << 2;
-                            outPixel = outPixel | nBitPixel;
-                            residualDistortion += (int64_t)SQR((int64_t)outPixel - (int64_t)reconCoeffBuffer[k * 4 + 1 + j * recon_ptr->stride_y]);
-
-
-                            nBitPixel = (four2bitPels >> 2) & 3;
-                            outPixel = inputBuffer[k * 4 + 2 + j * input_picture_ptr->stride_y] << 2;
-                            outPixel = outPixel | nBitPixel;
-                            residualDistortion += (int64_t)SQR((int64_t)outPixel - (int64_t)reconCoeffBuffer[k * 4 + 2 + j * recon_ptr->stride_y]);
-
-                            nBitPixel = (four2bitPels >> 0) & 3;
-                            outPixel = inputBuffer[k * 4 + 3 + j * input_picture_ptr->stride_y] << 2;
-                            outPixel = outPixel | nBitPixel;
-                            residualDistortion += (int64_t)SQR((int64_t)outPixel - (int64_t)reconCoeffBuffer[k * 4 + 3 + j * recon_ptr->stride_y]);
-
-                        }
-                    }
-
-                    //U+V
-
-                    tbOriginX = lcuNumberInWidth * 32;
-                    tbOriginY = lcuNumberInHeight * 32;
-                    sb_width = (chroma_width - tbOriginX) < 32 ? (chroma_width - tbOriginX) : 32;
-                    sb_height = (chroma_height - tbOriginY) < 32 ? (chroma_height - tbOriginY) : 32;
-
-                    inn_stride = sb_width / 4;
-
-                    inputBuffer = inputBufferOrgU + tbOriginY * input_picture_ptr->strideCb + tbOriginX;
-
-                    inputBufferBitInc = input_picture_ptr->bufferBitIncCb + tbOriginY * chroma2BitWidth + (tbOriginX / 4)*sb_height;
-
-                    reconCoeffBuffer = reconBufferOrgU + tbOriginY * recon_ptr->strideCb + tbOriginX;
-
-
-
-                    for (j = 0; j < sb_height; j++)
-                    {
-                        for (k = 0; k < sb_width / 4; k++)
-                        {
-
-                            four2bitPels = inputBufferBitInc[k + j * inn_stride];
-
-                            nBitPixel = (four2bitPels >> 6) & 3;
-                            outPixel = inputBuffer[k * 4 + 0 + j * input_picture_ptr->strideCb] << 2;
-                            outPixel = outPixel | nBitPixel;
-                            residualDistortionU += (int64_t)SQR((int64_t)outPixel - (int64_t)reconCoeffBuffer[k * 4 + 0 + j * recon_ptr->strideCb]);
-
-
-                            nBitPixel = (four2bitPels >> 4) & 3;
-                            outPixel = inputBuffer[k * 4 + 1 + j * input_picture_ptr->strideCb] << 2;
-                            outPixel = outPixel | nBitPixel;
-                            residualDistortionU += (int64_t)SQR((int64_t)outPixel - (int64_t)reconCoeffBuffer[k * 4 + 1 + j * recon_ptr->strideCb]);
-
-
-                            nBitPixel = (four2bitPels >> 2) & 3;
-                            outPixel = inputBuffer[k * 4 + 2 + j * input_picture_ptr->strideCb] << 2;
-                            outPixel = outPixel | nBitPixel;
-                            residualDistortionU += (int64_t)SQR((int64_t)outPixel - (int64_t)reconCoeffBuffer[k * 4 + 2 + j * recon_ptr->strideCb]);
-
-                            nBitPixel = (four2bitPels >> 0) & 3;
-                            outPixel = inputBuffer[k * 4 + 3 + j * input_picture_ptr->strideCb] << 2;
-                            outPixel = outPixel | nBitPixel;
-                            residualDistortionU += (int64_t)SQR((int64_t)outPixel - (int64_t)reconCoeffBuffer[k * 4 + 3 + j * recon_ptr->strideCb]);
-
-                        }
-                    }
-
-
-                    inputBuffer = inputBufferOrgV + tbOriginY * input_picture_ptr->strideCr + tbOriginX;
-                    inputBufferBitInc = input_picture_ptr->bufferBitIncCr + tbOriginY * chroma2BitWidth + (tbOriginX / 4)*sb_height;
-                    reconCoeffBuffer = reconBufferOrgV + tbOriginY * recon_ptr->strideCr + tbOriginX;
-
-
-                    for (j = 0; j < sb_height; j++)
-                    {
-                        for (k = 0; k < sb_width / 4; k++)
-                        {
-
-                            four2bitPels = inputBufferBitInc[k + j * inn_stride];
-
-                            nBitPixel = (four2bitPels >> 6) & 3;
-                            outPixel = inputBuffer[k * 4 + 0 + j * input_picture_ptr->strideCr] << 2;
-                            outPixel = outPixel | nBitPixel;
-                            residualDistortionV += (int64_t)SQR((int64_t)outPixel - (int64_t)reconCoeffBuffer[k * 4 + 0 + j * recon_ptr->strideCr]);
-
-
-                            nBitPixel = (four2bitPels >> 4) & 3;
-                            outPixel = inputBuffer[k * 4 + 1 + j * input_picture_ptr->strideCr] << 2;
-                            outPixel = outPixel | nBitPixel;
-                            residualDistortionV += (int64_t)SQR((int64_t)outPixel - (int64_t)reconCoeffBuffer[k * 4 + 1 + j * recon_ptr->strideCr]);
-
-
-                            nBitPixel = (four2bitPels >> 2) & 3;
-                            outPixel = inputBuffer[k * 4 + 2 + j * input_picture_ptr->strideCr] << 2;
-                            outPixel = outPixel | nBitPixel;
-                            residualDistortionV += (int64_t)SQR((int64_t)outPixel - (int64_t)reconCoeffBuffer[k * 4 + 2 + j * recon_ptr->strideCr]);
-
-                            nBitPixel = (four2bitPels >> 0) & 3;
-                            outPixel = inputBuffer[k * 4 + 3 + j * input_picture_ptr->strideCr] << 2;
-                            outPixel = outPixel | nBitPixel;
-                            residualDistortionV += (int64_t)SQR((int64_t)outPixel - (int64_t)reconCoeffBuffer[k * 4 + 3 + j * recon_ptr->strideCr]);
-
-                        }
-                    }
-
-
-
-
-                }
+            else {
+                recon_view->picture_control_set_wrapper_ptr = picture_control_set_wrapper_ptr;
+                eb_object_inc_live_count(
+                    recon_view->picture_control_set_wrapper_ptr,
+                    1);
             }
 
-
-            sseTotal[0] = residualDistortion;
-            sseTotal[1] = residualDistortionU;
-            sseTotal[2] = residualDistortionV;
+            // Size of the picture once packed, as the copy path reports it
+            outputReconPtr->n_filled_len = ((width * height * 3) >> 1) << is16bit;
         }
         else {
-
-
-            reconCoeffBuffer = (uint16_t*)(&((recon_ptr->buffer_y)[(recon_ptr->origin_x << is16bit) + (recon_ptr->origin_y << is16bit) * recon_ptr->stride_y]));
-            inputBuffer = &((input_picture_ptr->buffer_y)[input_picture_ptr->origin_x + input_picture_ptr->origin_y * input_picture_ptr->stride_y]);
-            inputBufferBitInc = &((input_picture_ptr->bufferBitIncY)[input_picture_ptr->origin_x + input_picture_ptr->origin_y * input_picture_ptr->strideBitIncY]);
-
-            residualDistortion = 0;
-
-            while (row_index < sequence_control_set_ptr->luma_height) {
-
-                columnIndex = 0;
-                while (columnIndex < sequence_control_set_ptr->luma_width) {
-                    residualDistortion += (int64_t)SQR((int64_t)((((inputBuffer[columnIndex]) << 2) | ((inputBufferBitInc[columnIndex] >> 6) & 3))) - (reconCoeffBuffer[columnIndex]));
-
-                    ++columnIndex;
-                }
-
-                inputBuffer += input_picture_ptr->stride_y;
-                inputBufferBitInc += input_picture_ptr->strideBitIncY;
-                reconCoeffBuffer += recon_ptr->stride_y;
-                ++row_index;
-            }
-
-            sseTotal[0] = residualDistortion;
-
-            reconCoeffBuffer = (uint16_t*)(&((recon_ptr->bufferCb)[(recon_ptr->origin_x << is16bit) / 2 + (recon_ptr->origin_y << is16bit) / 2 * recon_ptr->strideCb]));
-            inputBuffer = &((input_picture_ptr->bufferCb)[input_picture_ptr->origin_x / 2 + input_picture_ptr->origin_y / 2 * input_picture_ptr->strideCb]);
-            inputBufferBitInc = &((input_picture_ptr->bufferBitIncCb)[input_picture_ptr->origin_x / 2 + input_picture_ptr->origin_y / 2 * input_picture_ptr->strideBitIncCb]);
-
-            residualDistortion = 0;
-            row_index = 0;
-            while (row_index < sequence_control_set_ptr->chroma_height) {
-
-                columnIndex = 0;
-                while (columnIndex < sequence_control_set_ptr->chroma_width) {
-                    residualDistortion += (int64_t)SQR((int64_t)((((inputBuffer[columnIndex]) << 2) | ((inputBufferBitInc[columnIndex] >> 6) & 3))) - (reconCoeffBuffer[columnIndex]));
-                    ++columnIndex;
-                }
-
-                inputBuffer += input_picture_ptr->strideCb;
-                inputBufferBitInc += input_picture_ptr->strideBitIncCb;
-                reconCoeffBuffer += recon_ptr->strideCb;
-                ++row_index;
-            }
-
-            sseTotal[1] = residualDistortion;
-
-            reconCoeffBuffer = (uint16_t*)(&((recon_ptr->bufferCr)[(recon_ptr->origin_x << is16bit) / 2 + (recon_ptr->origin_y << is16bit) / 2 * recon_ptr->strideCr]));
-            inputBuffer = &((input_picture_ptr->bufferCr)[input_picture_ptr->origin_x / 2 + input_picture_ptr->origin_y / 2 * input_picture_ptr->strideCr]);
-            inputBufferBitInc = &((input_picture_ptr->bufferBitIncCr)[input_picture_ptr->origin_x / 2 + input_picture_ptr->origin_y / 2 * input_picture_ptr->strideBitIncCr]);
-
-            residualDistortion = 0;
-            row_index = 0;
-
-            while (row_index < sequence_control_set_ptr->chroma_height) {
-
-                columnIndex = 0;
-                while (columnIndex < sequence_control_set_ptr->chroma_width) {
-                    residualDistortion += (int64_t)SQR((int64_t)((((inputBuffer[columnIndex]) << 2) | ((inputBufferBitInc[columnIndex] >> 6) & 3))) - (reconCoeffBuffer[columnIndex]));
-                    ++columnIndex;
-                }
-
-                inputBuffer += input_picture_ptr->strideCr;
-                inputBufferBitInc += input_picture_ptr->strideBitIncCr;
-                reconCoeffBuffer += recon_ptr->strideCr;
-                ++row_index;
-            }
-
-            sseTotal[2] = residualDistortion;
-
+            // Y Recon Samples
+            sampleTotalCount = ((recon_ptr->maxWidth - sequence_control_set_ptr->max_input_pad_right) * (recon_ptr->maxHeight - sequence_control_set_ptr->max_input_pad_bottom)) << is16bit;
+            reconReadPtr = recon_ptr->buffer_y + (recon_ptr->origin_y << is16bit) * recon_ptr->stride_y + (recon_ptr->origin_x << is16bit);
+            reconWritePtr = &(outputReconPtr->p_buffer[outputReconPtr->n_filled_len]);
+
+            CHECK_REPORT_ERROR(
+                (outputReconPtr->n_filled_len + sampleTotalCount <= outputReconPtr->n_alloc_len),
+                encode_context_ptr->app_callback_ptr,
+                EB_ENC_ROB_OF_ERROR);
+
+            // Initialize Y recon buffer
+            picture_copy_kernel(
+                reconReadPtr,
+                recon_ptr->stride_y,
+                reconWritePtr,
+                recon_ptr->maxWidth - sequence_control_set_ptr->max_input_pad_right,
+                recon_ptr->width - sequence_control_set_ptr->pad_right,
+                recon_ptr->height - sequence_control_set_ptr->pad_bottom,
+                1 << is16bit);
+
+            outputReconPtr->n_filled_len += sampleTotalCount;
+
+            // U Recon Samples
+            sampleTotalCount = ((recon_ptr->maxWidth - sequence_control_set_ptr->max_input_pad_right) * (recon_ptr->maxHeight - sequence_control_set_ptr->max_input_pad_bottom) >> 2) << is16bit;
+            reconReadPtr = recon_ptr->bufferCb + ((recon_ptr->origin_y << is16bit) >> 1) * recon_ptr->strideCb + ((recon_ptr->origin_x << is16bit) >> 1);
+            reconWritePtr = &(outputReconPtr->p_buffer[outputReconPtr->n_filled_len]);
+
+            CHECK_REPORT_ERROR(
+                (outputReconPtr->n_filled_len + sampleTotalCount <= outputReconPtr->n_alloc_len),
+                encode_context_ptr->app_callback_ptr,
+                EB_ENC_ROB_OF_ERROR);
+
+            // Initialize U recon buffer
+            picture_copy_kernel(
+                reconReadPtr,
+                recon_ptr->strideCb,
+                reconWritePtr,
+                (recon_ptr->maxWidth - sequence_control_set_ptr->max_input_pad_right) >> 1,
+                (recon_ptr->width - sequence_control_set_ptr->pad_right) >> 1,
+                (recon_ptr->height - sequence_control_set_ptr->pad_bottom) >> 1,
+                1 << is16bit);
+            outputReconPtr->n_filled_len += sampleTotalCount;
+
+            // V Recon Samples
+            sampleTotalCount = ((recon_ptr->maxWidth - sequence_control_set_ptr->max_input_pad_right) * (recon_ptr->maxHeight - sequence_control_set_ptr->max_input_pad_bottom) >> 2) << is16bit;
+            reconReadPtr = recon_ptr->bufferCr + ((recon_ptr->origin_y << is16bit) >> 1) * recon_ptr->strideCr + ((recon_ptr->origin_x << is16bit) >> 1);
+            reconWritePtr = &(outputReconPtr->p_buffer[outputReconPtr->n_filled_len]);
+
+            CHECK_REPORT_ERROR(
+                (outputReconPtr->n_filled_len + sampleTotalCount <= outputReconPtr->n_alloc_len),
+                encode_context_ptr->app_callback_ptr,
+                EB_ENC_ROB_OF_ERROR);
+
+            // Initialize V recon buffer
+
+            picture_copy_kernel(
+                reconReadPtr,
+                recon_ptr->strideCr,
+                reconWritePtr,
+                (recon_ptr->maxWidth - sequence_control_set_ptr->max_input_pad_right) >> 1,
+                (recon_ptr->width - sequence_control_set_ptr->pad_right) >> 1,
+                (recon_ptr->height - sequence_control_set_ptr->pad_bottom) >> 1,
+                1 << is16bit);
+            outputReconPtr->n_filled_len += sampleTotalCount;
         }
-
-
-        picture_control_set_ptr->parent_pcs_ptr->luma_sse = (uint32_t)sseTotal[0];
-        picture_control_set_ptr->parent_pcs_ptr->cr_sse = (uint32_t)sseTotal[1];
-        picture_control_set_ptr->parent_pcs_ptr->cb_sse = (uint32_t)sseTotal[2];
+        outputReconPtr->pts = picture_control_set_ptr->picture_number;
     }
+
+    // Post the Recon object
+    eb_post_full_object(outputReconWrapperPtr);
+    eb_release_mutex(encode_context_ptr->total_number_of_recon_frame_mutex);
 }
 
 void PadRefAndSetFlags(
@@ -1295,6 +950,9 @@ EbErrorType signal_derivation_enc_dec_kernel_oq(
 #if SCENE_CONTENT_SETTINGS
     }
 #endif
+    // Deadline Control: reduce the NFL count by one level per MD speed level
+    context_ptr->nfl_level = (uint8_t)MIN(7, context_ptr->nfl_level + picture_control_set_ptr->parent_pcs_ptr->dl_md_level);
+
     // Set Chroma Mode
     // Level                Settings
     // CHROMA_MODE_0  0     Chroma @ MD
@@ -1434,6 +1092,19 @@ EbErrorType signal_derivation_enc_dec_kernel_oq(
     else        
         context_ptr->interpolation_filter_search_blk_size = 2;
     
+    // Set MD output reuse @ EP
+    // Level                Settings
+    // 0                    OFF: EP re-encodes every block
+    // 1                    EP commits the MD coefficients and recon of the inter blocks
+    // Only when MD and EP encode alike: 8 bit, chroma @ MD, no tx search @ EP, no block level QP, closed loop MD recon
+    if (sequence_control_set_ptr->static_config.encoder_bit_depth == EB_8BIT &&
+        context_ptr->chroma_level == CHROMA_MODE_0 &&
+        picture_control_set_ptr->parent_pcs_ptr->tx_search_level != TX_SEARCH_ENC_DEC &&
+        sequence_control_set_ptr->static_config.improve_sharpness == 0 &&
+        picture_control_set_ptr->intra_md_open_loop_flag == EB_FALSE)
+        context_ptr->md_output_reuse = 1;
+    else
+        context_ptr->md_output_reuse = 0;
 
 
     return return_error;
@@ -1490,12 +1161,20 @@ void* EncDecKernel(void *input_ptr)
     uint32_t                                 segmentBandIndex;
     uint32_t                                 segmentBandSize;
     EncDecSegments_t                        *segmentsPtr;
+
+    // Deadline Control
+    uint64_t                                 start_time_seconds;
+    uint64_t                                 start_time_u_seconds;
+    uint64_t                                 finish_time_seconds;
+    uint64_t                                 finish_time_u_seconds;
+    double                                   task_time;
     for (;;) {
 
         // Get Mode Decision Results
         eb_get_full_object(
             context_ptr->mode_decision_input_fifo_ptr,
             &encDecTasksWrapperPtr);
+        EbStartTime(&start_time_seconds, &start_time_u_seconds);
 
         encDecTasksPtr = (EncDecTasks_t*)encDecTasksWrapperPtr->object_ptr;
         picture_control_set_ptr = (PictureControlSet_t*)encDecTasksPtr->picture_control_set_wrapper_ptr->object_ptr;
@@ -1706,6 +1385,23 @@ void* EncDecKernel(void *input_ptr)
                         context_ptr);
 #endif
 
+                    // Record the SB symbols, Entropy Coding only has to arithmetic code them.
+                    // Once a stream fails the picture is entropy coded with write_sb instead.
+                    if (picture_control_set_ptr->parent_pcs_ptr->av1_cm->tile_cols * picture_control_set_ptr->parent_pcs_ptr->av1_cm->tile_rows == 1 &&
+                        picture_control_set_ptr->sb_symbols_dropped == EB_FALSE) {
+                        EbErrorType return_error = record_sb(
+                            sb_ptr,
+                            picture_control_set_ptr,
+                            sequence_control_set_ptr->encode_context_ptr->symbol_chunk_pool,
+                            sb_origin_x,
+                            sb_origin_y);
+                        if (return_error != EB_ErrorNone) {
+                            SVT_LOG("SVT [WARNING]: EncDec error 0x%x, out of memory for the SB symbol streams of picture %d\n",
+                                EB_ENC_EC_ERROR30, (int32_t)picture_control_set_ptr->picture_number);
+                            picture_control_set_ptr->sb_symbols_dropped = EB_TRUE;
+                        }
+                    }
+
                     if (picture_control_set_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr != NULL) {
                         ((EbReferenceObject*)picture_control_set_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)->intra_coded_area_sb[sb_index] = (uint8_t)((100 * context_ptr->intra_coded_area_sb[sb_index]) / (64 * 64));
                     }
@@ -1717,6 +1413,11 @@ void* EncDecKernel(void *input_ptr)
 
         eb_block_on_mutex(picture_control_set_ptr->intra_mutex);
         picture_control_set_ptr->intra_coded_area += (uint32_t)context_ptr->tot_intra_coded_area;
+        if (sequence_control_set_ptr->static_config.deadline_mode) {
+            EbFinishTime(&finish_time_seconds, &finish_time_u_seconds);
+            EbComputeOverallElapsedTimeMs(start_time_seconds, start_time_u_seconds, finish_time_seconds, finish_time_u_seconds, &task_time);
+            picture_control_set_ptr->parent_pcs_ptr->dl_md_time += task_time;
+        }
         eb_release_mutex(picture_control_set_ptr->intra_mutex);
 
         if (lastLcuFlag) {
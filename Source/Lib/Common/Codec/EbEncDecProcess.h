@@ -35,6 +35,20 @@ extern "C" {
         uint32_t       nz_coeff;
     } EbPmCand_t;
 
+    /**************************************
+     * Recon View
+     *   Zero-copy recon output (recon_enabled 2): the
+     *   planes of the final recon, in place, and the
+     *   objects held until the application releases
+     *   the view
+     **************************************/
+    typedef struct ReconView_s
+    {
+        EbSvtIOFormat                          planes; // the output header p_buffer points here
+        EbObjectWrapper                       *picture_control_set_wrapper_ptr;
+        EbObjectWrapper                       *reference_picture_wrapper_ptr;
+    } ReconView_t;
+
     /**************************************
      * Enc Dec Context
      **************************************/
@@ -64,7 +78,6 @@ extern "C" {
         EbPictureBufferDesc_t                 *residual_buffer;
         EbPictureBufferDesc_t                 *transform_buffer;
         EbPictureBufferDesc_t                 *input_samples;
-        EbPictureBufferDesc_t                 *input_sample16bit_buffer;
         // temporary buffers for decision making of LF (LPF_PICK_FROM_FULL_IMAGE).
         // Since recon switches between reconPtr and referencePtr, the temporary buffers sizes used the referencePtr's which has padding,...
         EbPictureBufferDesc_t                 *inverse_quant_buffer;
@@ -145,7 +158,9 @@ extern "C" {
         EbFifo                *feedback_fifo_ptr,
         EbFifo                *picture_demux_fifo_ptr,
         EbBool                   is16bit,
+        EbBool                   hbd_mode_decision,
         EbColorFormat            color_format,
+        uint16_t                 sb_size,
         uint32_t                 max_input_luma_width,
         uint32_t                 max_input_luma_height);
 
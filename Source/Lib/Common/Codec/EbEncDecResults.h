@@ -44,6 +44,12 @@ extern "C" {
         uint32_t                  completed_lcu_row_count;
 
     } RestResults_t;
+    typedef struct StatTasks_s
+    {
+        EbObjectWrapper      *picture_control_set_wrapper_ptr;
+        EbObjectWrapper      *reference_picture_wrapper_ptr;   // held by Rest until the stats are done, NULL for non-reference pictures
+
+    } StatTasks_t;
 
     typedef struct EncDecResultsInitData_s
     {
@@ -21,6 +21,8 @@ EbErrorType encode_context_ctor(
     EncodeContext_t *encode_context_ptr;
     EB_MALLOC(EncodeContext_t*, encode_context_ptr, sizeof(EncodeContext_t), EB_N_PTR);
     *object_dbl_ptr = (EbPtr)encode_context_ptr;
+    encode_context_ptr->output_segment_pool = (OutputSegmentPool_t*)EB_NULL;
+    encode_context_ptr->symbol_chunk_pool = (SymbolChunkPool_t*)EB_NULL;
 
     object_init_data_ptr = 0;
     CHECK_REPORT_ERROR(
@@ -43,6 +45,9 @@ EbErrorType encode_context_ctor(
     encode_context_ptr->reference_picture_pool_fifo_ptr = (EbFifo*)EB_NULL;
     encode_context_ptr->pa_reference_picture_pool_fifo_ptr = (EbFifo*)EB_NULL;
 
+    // Film Grain Denoise Workers
+    encode_context_ptr->worker_pool = NULL;
+
     // Picture Decision Reordering Queue
     encode_context_ptr->picture_decision_reorder_queue_head_index = 0;
     EB_MALLOC(PictureDecisionReorderEntry_t**, encode_context_ptr->picture_decision_reorder_queue, sizeof(PictureDecisionReorderEntry_t*) * PICTURE_DECISION_REORDER_QUEUE_MAX_DEPTH, EB_N_PTR);
@@ -183,6 +188,21 @@ EbErrorType encode_context_ctor(
     // Signalling the need for a td structure to be written in the bitstream - on when the sequence starts
     encode_context_ptr->td_needed = EB_TRUE;
 
+    // Output Segment Pool
+    return_error = output_segment_pool_ctor(
+        &encode_context_ptr->output_segment_pool,
+        OUTPUT_SEGMENT_SIZE);
+    if (return_error == EB_ErrorInsufficientResources) {
+        return EB_ErrorInsufficientResources;
+    }
+
+    // Symbol Chunk Pool
+    return_error = symbol_chunk_pool_ctor(
+        &encode_context_ptr->symbol_chunk_pool);
+    if (return_error == EB_ErrorInsufficientResources) {
+        return EB_ErrorInsufficientResources;
+    }
+
     // Prediction Structure Group
     encode_context_ptr->prediction_structure_group_ptr = (PredictionStructureGroup_t*)EB_NULL;
 
@@ -217,10 +237,25 @@ EbErrorType encode_context_ctor(
 
     encode_context_ptr->enc_mode = SPEED_CONTROL_INIT_MOD;
 
+    encode_context_ptr->dl_me_level = 0;
+    encode_context_ptr->dl_md_level = 0;
+    encode_context_ptr->dl_frame_out = 0;
+    encode_context_ptr->dl_last_update_frame_out = 0;
+    encode_context_ptr->dl_prev_out_seconds = 0;
+    encode_context_ptr->dl_prev_out_u_seconds = 0;
+    encode_context_ptr->dl_frame_time = 0;
+    encode_context_ptr->dl_me_time = 0;
+    encode_context_ptr->dl_md_time = 0;
+
     encode_context_ptr->previous_selected_ref_qp = 32;
     encode_context_ptr->max_coded_poc = 0;
     encode_context_ptr->max_coded_poc_selected_ref_qp = 32;
 
+    encode_context_ptr->rc_stats_out = (uint8_t*)EB_NULL;
+    encode_context_ptr->rc_stats_out_size = 0;
+    encode_context_ptr->rc_stats_in = (RcStatsEntry_t*)EB_NULL;
+    encode_context_ptr->rc_stats_in_count = 0;
+
     encode_context_ptr->shared_reference_mutex = eb_create_mutex();
     if (encode_context_ptr->shared_reference_mutex == (EbHandle)EB_NULL) {
         return EB_ErrorInsufficientResources;
@@ -15,12 +15,16 @@
 #include "EbPictureDecisionQueue.h"
 #include "EbPictureManagerQueue.h"
 #include "EbPacketizationReorderQueue.h"
+#include "EbOutputSegment.h"
+#include "EbSymbolStream.h"
 #include "EbInitialRateControlReorderQueue.h"
 #include "EbPictureManagerReorderQueue.h"
 #include "EbCabacContextModel.h"
 #include "EbMdRateEstimation.h"
 #include "EbPredictionStructure.h"
 #include "EbRateControlTables.h"
+#include "EbRateControlStats.h"
+#include "EbWorkerPool.h"
 
 // *Note - the queues are small for testing purposes.  They should be increased when they are done.
 #define PRE_ASSIGNMENT_MAX_DEPTH                            128     // should be large enough to hold an entire prediction period
@@ -118,6 +122,12 @@ typedef struct EncodeContext_s
     // Signalling the need for a td structure to be written in the bitstream - only used in the PK process so no need for a mutex
     EbBool                                           td_needed;
 
+    // Segments of the output packets
+    OutputSegmentPool_t                             *output_segment_pool;
+
+    // Chunks of the SB symbol streams, from EncDec to Entropy Coding
+    SymbolChunkPool_t                               *symbol_chunk_pool;
+
     // Prediction Structure
     PredictionStructureGroup_t                       *prediction_structure_group_ptr;
                                                      
@@ -135,11 +145,28 @@ typedef struct EncodeContext_s
     int64_t                                           sc_frame_out;
     EbHandle                                          sc_buffer_mutex;
     EbEncMode                                         enc_mode;
+
+    // Deadline Control (protected by sc_buffer_mutex)
+    uint8_t                                           dl_me_level;
+    uint8_t                                           dl_md_level;
+    uint64_t                                          dl_frame_out;
+    uint64_t                                          dl_last_update_frame_out;
+    uint64_t                                          dl_prev_out_seconds;
+    uint64_t                                          dl_prev_out_u_seconds;
+    double                                            dl_frame_time;   // Smoothed time between two output pictures (ms)
+    double                                            dl_me_time;      // Smoothed ME time per picture, all segments (ms)
+    double                                            dl_md_time;      // Smoothed EncDec time per picture, all segments (ms)
                                                      
     // Rate Control                                  
     uint32_t                                          previous_selected_ref_qp;
     uint64_t                                          max_coded_poc;
     uint32_t                                          max_coded_poc_selected_ref_qp;
+
+    // Analysis Pass Stats
+    uint8_t                                          *rc_stats_out;    // Header followed by one RcStatsEntry_t per picture
+    uint64_t                                          rc_stats_out_size;
+    RcStatsEntry_t                                   *rc_stats_in;     // Stats of a previous analysis pass, indexed by picture number
+    uint64_t                                          rc_stats_in_count;
                                                      
     // Dynamic GOP                                   
     uint32_t                                          previous_mini_gop_hierarchical_levels;
@@ -147,6 +174,10 @@ typedef struct EncodeContext_s
     EbObjectWrapper                                *previous_picture_control_set_wrapper_ptr;
     EbHandle                                          shared_reference_mutex;
 
+    // Band workers, shared by the film grain denoising of the Picture Analysis
+    // processes and the loop filter level search of the DLF processes
+    WorkerPool_t                                     *worker_pool;
+
 } EncodeContext_t;
 
 typedef struct EncodeContextInitData_s {
@@ -986,6 +986,15 @@ static void EncodePartitionAv1(
             partition_cdf_length(bsize));
 
     }
+    else if (ecWriter->symbol_stream) {
+        // The gathered cdf is derived from the adapted partition cdf when coded
+        symbol_stream_put_partition(
+            ecWriter->symbol_stream,
+            p == PARTITION_SPLIT,
+            frameContext->partition_cdf[contextIndex],
+            bsize,
+            !hasRows);
+    }
     else if (!hasRows && hasCols) {
         aom_cdf_prob cdf[CDF_SIZE(2)];
         partition_gather_vert_alike(cdf, frameContext->partition_cdf[contextIndex], bsize);
@@ -1433,35 +1442,6 @@ EbErrorType ResetEntropyCoder(
     return return_error;
 }
 
-EbErrorType CopyRbspBitstreamToPayload(
-    Bitstream_t *bitstreamPtr,
-    EbByte      outputBuffer,
-    uint32_t      *outputBufferIndex,
-    uint32_t      *outputBufferSize,
-    EncodeContext_t         *encode_context_ptr)
-{
-    EbErrorType return_error = EB_ErrorNone;
-    OutputBitstreamUnit_t *outputBitstreamPtr = (OutputBitstreamUnit_t*)bitstreamPtr->outputBitstreamPtr;
-
-
-    CHECK_REPORT_ERROR(
-        ((outputBitstreamPtr->writtenBitsCount >> 3) + (*outputBufferIndex) < (*outputBufferSize)),
-        encode_context_ptr->app_callback_ptr,
-        EB_ENC_EC_ERROR2);
-
-
-
-    output_bitstream_rbsp_to_payload(
-        outputBitstreamPtr,
-        outputBuffer,
-        outputBufferIndex,
-        outputBufferSize,
-        0);
-
-    return return_error;
-}
-
-
 EbErrorType BitstreamCtor(
     Bitstream_t **bitstreamDblPtr,
     uint32_t bufferSize)
@@ -1491,6 +1471,7 @@ EbErrorType EntropyCoderCtor(
     EB_MALLOC(EbPtr, (*entropyCoderDblPtr)->cabacEncodeContextPtr, sizeof(CabacEncodeContext_t), EB_N_PTR);
 
     EB_MALLOC(FRAME_CONTEXT*, (*entropyCoderDblPtr)->fc, sizeof(FRAME_CONTEXT), EB_N_PTR);
+    (*entropyCoderDblPtr)->ecWriter.symbol_stream = (SymbolStream_t*)EB_NULL;
 
     EB_MALLOC(EbPtr, (*entropyCoderDblPtr)->ecOutputBitstreamPtr, sizeof(OutputBitstreamUnit_t), EB_N_PTR);
 
@@ -4273,19 +4254,11 @@ EbErrorType WriteFrameHeaderAv1(
    currDataSize += write_tile_group_header(data + currDataSize,0,
         0, n_log2_tiles, tile_start_and_end_present_flag);
 
-    if (!showExisting) {
-        // Add data from EC stream to Picture Stream.
-        int32_t frameSize = parentPcsPtr->av1_cm->tile_cols*parentPcsPtr->av1_cm->tile_rows==1 ? pcsPtr->entropy_coder_ptr->ecWriter.pos : pcsPtr->entropy_coder_ptr->ec_frame_size;
-
-        OutputBitstreamUnit_t *ecOutputBitstreamPtr = (OutputBitstreamUnit_t*)pcsPtr->entropy_coder_ptr->ecOutputBitstreamPtr;
-        //****************************************************************//
-        // Copy from EC stream to frame stream
-        memcpy(data + currDataSize, ecOutputBitstreamPtr->bufferBeginAv1, frameSize);
-        currDataSize += (frameSize);
-    }
-    const uint32_t obuPayloadSize = currDataSize - obuHeaderSize;
-    const size_t lengthFieldSize =
-        ObuMemMove(obuHeaderSize, obuPayloadSize, data);
+    // The tile data stays in the EC stream, it follows the header in the output packet
+    const uint32_t tileDataSize = showExisting ? 0 : GetTileDataAv1(pcsPtr, NULL);
+    const uint32_t obuPayloadSize = currDataSize - obuHeaderSize + tileDataSize;
+    const size_t lengthFieldSize = aom_uleb_size_in_bytes(obuPayloadSize);
+    memmove(data + obuHeaderSize + lengthFieldSize, data + obuHeaderSize, currDataSize - obuHeaderSize);
     if (WriteUlebObuSize(obuHeaderSize, obuPayloadSize, data) !=
         AOM_CODEC_OK) {
         assert(0);
@@ -4297,6 +4270,23 @@ EbErrorType WriteFrameHeaderAv1(
     return return_error;
 }
 
+/**************************************************
+* GetTileDataAv1
+*   Returns the size of the coded tiles of the frame
+*   and where they sit in the EC stream
+**************************************************/
+uint32_t GetTileDataAv1(
+    PictureControlSet_t *pcsPtr,
+    uint8_t **tileData)
+{
+    PictureParentControlSet_t *parentPcsPtr = pcsPtr->parent_pcs_ptr;
+    OutputBitstreamUnit_t     *ecOutputBitstreamPtr = (OutputBitstreamUnit_t*)pcsPtr->entropy_coder_ptr->ecOutputBitstreamPtr;
+
+    if (tileData)
+        *tileData = ecOutputBitstreamPtr->bufferBeginAv1;
+    return parentPcsPtr->av1_cm->tile_cols*parentPcsPtr->av1_cm->tile_rows == 1 ? pcsPtr->entropy_coder_ptr->ecWriter.pos : pcsPtr->entropy_coder_ptr->ec_frame_size;
+}
+
 /**************************************************
 * EncodeSPSAv1
 **************************************************/
@@ -4397,6 +4387,18 @@ static void write_cdef(
     (void)xd;
     Av1Common *cm = p_pcs_ptr->parent_pcs_ptr->av1_cm;
 
+    // The CDEF strengths are only known once the CDEF search is done
+    if (w->symbol_stream) {
+        symbol_stream_put_marker(
+            w->symbol_stream,
+            SYMBOL_MARKER_CDEF,
+            mi_row & (seqCSetPtr->mib_size - 1),
+            mi_col & (seqCSetPtr->mib_size - 1),
+            BLOCK_4X4,
+            skip);
+        return;
+    }
+
 
     if (p_pcs_ptr->parent_pcs_ptr->coded_lossless || p_pcs_ptr->parent_pcs_ptr->allow_intrabc) {
         // Initialize to indicate no CDEF for safety.
@@ -5288,6 +5290,33 @@ EbErrorType write_modes_b(
     return return_error;
 
 }
+static void write_lr_sb_coeffs(
+    PictureControlSet_t     *picture_control_set_ptr,
+    FRAME_CONTEXT           *frameContext,
+    Av1Common               *cm,
+    aom_writer              *ecWriter,
+    int32_t                  mi_row,
+    int32_t                  mi_col,
+    block_size               bsize)
+{
+    for (int32_t plane = 0; plane < 3; ++plane) {
+        int32_t rcol0, rcol1, rrow0, rrow1, tile_tl_idx;
+        if (av1_loop_restoration_corners_in_sb(cm, plane, mi_row, mi_col, bsize,
+            &rcol0, &rcol1, &rrow0, &rrow1,
+            &tile_tl_idx)) {
+            const int32_t rstride = cm->rst_info[plane].horz_units_per_tile;
+            for (int32_t rrow = rrow0; rrow < rrow1; ++rrow) {
+                for (int32_t rcol = rcol0; rcol < rcol1; ++rcol) {
+                    const int32_t runit_idx = tile_tl_idx + rcol + rrow * rstride;
+                    const RestorationUnitInfo *rui =
+                        &cm->rst_info[plane].unit_info[runit_idx];
+                    loop_restoration_write_sb_coeffs(picture_control_set_ptr, frameContext, cm, /*xd,*/ rui, ecWriter, plane);
+                }
+            }
+        }
+    }
+}
+
 /**********************************************
 * Write sb
 **********************************************/
@@ -5357,22 +5386,19 @@ EB_EXTERN EbErrorType write_sb(
 
             if (bsize >= BLOCK_8X8) {
 
-                for (int32_t plane = 0; plane < 3; ++plane) {
-                    int32_t rcol0, rcol1, rrow0, rrow1, tile_tl_idx;
-                    if (av1_loop_restoration_corners_in_sb(cm, plane, mi_row, mi_col, bsize,
-                        &rcol0, &rcol1, &rrow0, &rrow1,
-                        &tile_tl_idx)) {
-                        const int32_t rstride = cm->rst_info[plane].horz_units_per_tile;
-                        for (int32_t rrow = rrow0; rrow < rrow1; ++rrow) {
-                            for (int32_t rcol = rcol0; rcol < rcol1; ++rcol) {
-                                const int32_t runit_idx = tile_tl_idx + rcol + rrow * rstride;
-                                const RestorationUnitInfo *rui =
-                                    &cm->rst_info[plane].unit_info[runit_idx];
-                                loop_restoration_write_sb_coeffs(picture_control_set_ptr, frameContext, cm, /*xd,*/ rui, ecWriter, plane);
-                            }
-                        }
-                    }
+                // The restoration units are only known once the restoration search is done
+                if (ecWriter->symbol_stream) {
+                    if (sequence_control_set_ptr->enable_restoration)
+                        symbol_stream_put_marker(
+                            ecWriter->symbol_stream,
+                            SYMBOL_MARKER_LR,
+                            mi_row & (sequence_control_set_ptr->mib_size - 1),
+                            mi_col & (sequence_control_set_ptr->mib_size - 1),
+                            bsize,
+                            0);
                 }
+                else
+                    write_lr_sb_coeffs(picture_control_set_ptr, frameContext, cm, ecWriter, mi_row, mi_col, bsize);
 
 
                 // Code Split Flag
@@ -5618,3 +5644,108 @@ EB_EXTERN EbErrorType write_sb(
     } while (cu_index < sequence_control_set_ptr->max_block_cnt);
     return return_error;
 }
+
+/**********************************************
+* Record sb
+*   Runs write_sb with the writer in record mode right after EncDec: the
+*   contexts are derived and the symbols appended to the SB symbol stream,
+*   the cdfs are left untouched
+**********************************************/
+EbErrorType record_sb(
+    LargestCodingUnit_t     *tbPtr,
+    PictureControlSet_t     *picture_control_set_ptr,
+    SymbolChunkPool_t       *pool_ptr,
+    uint32_t                 sb_origin_x,
+    uint32_t                 sb_origin_y)
+{
+    EbErrorType              return_error;
+    EntropyCodingContext_t   context;
+    EntropyCoder_t           recorder;
+
+    context.sb_origin_x = sb_origin_x;
+    context.sb_origin_y = sb_origin_y;
+
+    // The frame context is only used to turn the cdf pointers into ids
+    EB_MEMSET(&recorder, 0, sizeof(EntropyCoder_t));
+    recorder.fc = picture_control_set_ptr->entropy_coder_ptr->fc;
+    recorder.ecWriter.symbol_stream = &tbPtr->symbol_stream;
+    symbol_stream_start(&tbPtr->symbol_stream, pool_ptr, (const aom_cdf_prob*)recorder.fc);
+
+    return_error = write_sb(
+        &context,
+        tbPtr,
+        picture_control_set_ptr,
+        &recorder,
+        tbPtr->quantized_coeff);
+    if (return_error == EB_ErrorNone)
+        return_error = tbPtr->symbol_stream.error;
+
+    return return_error;
+}
+
+/**********************************************
+* Replay sb
+*   Arithmetic codes the symbol stream recorded for the SB, adapting the
+*   cdfs as write_sb would, then returns its chunks to the pool
+**********************************************/
+EbErrorType replay_sb(
+    EntropyCodingContext_t  *context_ptr,
+    LargestCodingUnit_t     *tbPtr,
+    PictureControlSet_t     *picture_control_set_ptr,
+    EntropyCoder_t          *entropy_coder_ptr)
+{
+    SequenceControlSet      *sequence_control_set_ptr = (SequenceControlSet*)picture_control_set_ptr->sequence_control_set_wrapper_ptr->object_ptr;
+    FRAME_CONTEXT           *frameContext = entropy_coder_ptr->fc;
+    aom_cdf_prob            *cdf_base = (aom_cdf_prob*)frameContext;
+    aom_writer              *ecWriter = &entropy_coder_ptr->ecWriter;
+    Av1Common               *cm = picture_control_set_ptr->parent_pcs_ptr->av1_cm;
+    const int32_t            sb_mi_row = context_ptr->sb_origin_y >> MI_SIZE_LOG2;
+    const int32_t            sb_mi_col = context_ptr->sb_origin_x >> MI_SIZE_LOG2;
+    const SymbolChunk_t     *chunk_ptr;
+
+    for (chunk_ptr = tbPtr->symbol_stream.head; chunk_ptr != EB_NULL; chunk_ptr = chunk_ptr->next) {
+        const uint32_t *record_ptr = chunk_ptr->records;
+        const uint32_t *end_ptr = record_ptr + chunk_ptr->count;
+
+        for (; record_ptr < end_ptr; ++record_ptr) {
+            const uint32_t record = *record_ptr;
+
+            switch (record & 3) {
+            case SYMBOL_RECORD_CDF: {
+                aom_cdf_prob *cdf = cdf_base + (record >> 10);
+                const int32_t symb = (record >> 2) & 15;
+                const int32_t nsymbs = ((record >> 6) & 15) + 1;
+                aom_write_cdf(ecWriter, symb, cdf, nsymbs);
+                if (ecWriter->allow_update_cdf) update_cdf(cdf, symb, nsymbs);
+                break;
+            }
+            case SYMBOL_RECORD_BOOL:
+                aom_daala_write(ecWriter, (record >> 2) & 1, (record >> 3) & 0xff);
+                break;
+            case SYMBOL_RECORD_PARTITION: {
+                aom_cdf_prob cdf[CDF_SIZE(2)];
+                const block_size bsize = (block_size)((record >> 4) & 31);
+                if (record & 8)
+                    partition_gather_vert_alike(cdf, cdf_base + (record >> 10), bsize);
+                else
+                    partition_gather_horz_alike(cdf, cdf_base + (record >> 10), bsize);
+                aom_write_symbol(ecWriter, (record >> 2) & 1, cdf, 2);
+                break;
+            }
+            default: {
+                const int32_t mi_row = sb_mi_row + ((record >> 9) & 31);
+                const int32_t mi_col = sb_mi_col + ((record >> 14) & 31);
+                if (((record >> 2) & 1) == SYMBOL_MARKER_LR)
+                    write_lr_sb_coeffs(picture_control_set_ptr, frameContext, cm, ecWriter, mi_row, mi_col, (block_size)((record >> 4) & 31));
+                else
+                    write_cdef(sequence_control_set_ptr, picture_control_set_ptr, (MacroBlockD*)EB_NULL, ecWriter, (record >> 3) & 1, mi_col, mi_row);
+                break;
+            }
+            }
+        }
+    }
+
+    symbol_stream_release(&tbPtr->symbol_stream);
+
+    return EB_ErrorNone;
+}
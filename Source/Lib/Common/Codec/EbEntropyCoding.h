@@ -59,6 +59,19 @@ extern "C" {
         EntropyCoder_t          *entropy_coder_ptr,
         EbPictureBufferDesc_t   *coeffPtr);
 
+    extern EbErrorType record_sb(
+        LargestCodingUnit_t     *tbPtr,
+        PictureControlSet_t     *picture_control_set_ptr,
+        SymbolChunkPool_t       *pool_ptr,
+        uint32_t                 sb_origin_x,
+        uint32_t                 sb_origin_y);
+
+    extern EbErrorType replay_sb(
+        struct EntropyCodingContext_s   *context_ptr,
+        LargestCodingUnit_t     *tbPtr,
+        PictureControlSet_t     *picture_control_set_ptr,
+        EntropyCoder_t          *entropy_coder_ptr);
+
 
     extern EbErrorType EncodeSliceFinish(
         EntropyCoder_t        *entropy_coder_ptr);
@@ -91,13 +104,6 @@ extern "C" {
         COMPONENT_TYPE                          component_type,
         EbAsm                                  asm_type);
 
-    extern EbErrorType CopyRbspBitstreamToPayload(
-        Bitstream_t *bitstreamPtr,
-        EbByte      outputBuffer,
-        uint32_t      *outputBufferIndex,
-        uint32_t      *outputBufferSize,
-        EncodeContext_t         *encode_context_ptr);
-
 
     //**********************************************************************************************************//
     //onyxc_int.h
@@ -295,6 +301,9 @@ extern "C" {
         SequenceControlSet *scsPtr,
         PictureControlSet_t *pcsPtr,
         uint8_t showExisting);
+    extern uint32_t GetTileDataAv1(
+        PictureControlSet_t *pcsPtr,
+        uint8_t **tileData);
     extern EbErrorType encode_td_av1(
         uint8_t *bitstreamPtr);
     extern EbErrorType EncodeSPSAv1(
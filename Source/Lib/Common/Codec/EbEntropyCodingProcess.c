@@ -54,7 +54,7 @@ EbErrorType entropy_coding_context_ctor(
 /***********************************************
  * Entropy Coding Reset Neighbor Arrays
  ***********************************************/
-static void EntropyCodingResetNeighborArrays(PictureControlSet_t *picture_control_set_ptr)
+void EntropyCodingResetNeighborArrays(PictureControlSet_t *picture_control_set_ptr)
 {
     neighbor_array_unit_reset(picture_control_set_ptr->mode_type_neighbor_array);
 
@@ -242,7 +242,10 @@ static void ResetEntropyCodingPicture(
         entropyCodingQp,
         picture_control_set_ptr->slice_type);
 
-    EntropyCodingResetNeighborArrays(picture_control_set_ptr);
+    // The neighbor arrays are reset and used by EncDec, which records the SB symbols,
+    // unless the picture falls back to write_sb
+    if (picture_control_set_ptr->sb_symbols_dropped)
+        EntropyCodingResetNeighborArrays(picture_control_set_ptr);
 
 
     return;
@@ -352,6 +355,34 @@ static void EntropyCodingConfigureLcu(
 
     return;
 }
+
+/******************************************************
+ * Entropy Coding Code SB
+ *   Replays the symbols recorded by EncDec, or codes the SB
+ *   with write_sb when the picture's streams were dropped
+ ******************************************************/
+static void EntropyCodingCodeSb(
+    EntropyCodingContext_t  *context_ptr,
+    LargestCodingUnit_t     *sb_ptr,
+    PictureControlSet_t     *picture_control_set_ptr)
+{
+    if (picture_control_set_ptr->sb_symbols_dropped) {
+        symbol_stream_release(&sb_ptr->symbol_stream);
+        write_sb(
+            context_ptr,
+            sb_ptr,
+            picture_control_set_ptr,
+            picture_control_set_ptr->entropy_coder_ptr,
+            sb_ptr->quantized_coeff);
+    }
+    else {
+        replay_sb(
+            context_ptr,
+            sb_ptr,
+            picture_control_set_ptr,
+            picture_control_set_ptr->entropy_coder_ptr);
+    }
+}
 #if !RC
 /******************************************************
  * Entropy Coding Lcu
@@ -371,8 +402,6 @@ static void EntropyCodingLcu(
     UNUSED(sb_origin_y);
     (void)terminateSliceFlag;
     (void)sequence_control_set_ptr;
-    EbPictureBufferDesc_t *coeffPicturePtr = sb_ptr->quantized_coeff;
-
     //rate Control
     uint32_t                       writtenBitsBeforeQuantizedCoeff;
     uint32_t                       writtenBitsAfterQuantizedCoeff;
@@ -388,12 +417,10 @@ static void EntropyCodingLcu(
     (void)pictureOriginX;
     (void)pictureOriginY;
 
-    write_sb(
+    EntropyCodingCodeSb(
         context_ptr,
         sb_ptr,
-        picture_control_set_ptr,
-        picture_control_set_ptr->entropy_coder_ptr,
-        coeffPicturePtr);
+        picture_control_set_ptr);
 
     //store the number of written bits after coding quantized coeffs (flush is not called yet):
     // The total number of bits is
@@ -594,13 +621,10 @@ void* EntropyCodingKernel(void *input_ptr)
 #if RC            
                     sb_ptr->total_bits = 0;
                     uint32_t prev_pos = sb_index ? picture_control_set_ptr->entropy_coder_ptr->ecWriter.ec.offs : 0;//residual_bc.pos
-                    EbPictureBufferDesc_t *coeff_picture_ptr = sb_ptr->quantized_coeff;
-                    write_sb(
+                    EntropyCodingCodeSb(
                         context_ptr,
                         sb_ptr,
-                        picture_control_set_ptr,
-                        picture_control_set_ptr->entropy_coder_ptr,
-                        coeff_picture_ptr);
+                        picture_control_set_ptr);
                     sb_ptr->total_bits = (picture_control_set_ptr->entropy_coder_ptr->ecWriter.ec.offs - prev_pos) << 3;
                     picture_control_set_ptr->parent_pcs_ptr->quantized_coeff_num_bits += sb_ptr->total_bits;
 #else
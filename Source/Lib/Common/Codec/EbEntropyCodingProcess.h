@@ -83,6 +83,9 @@ extern EbErrorType entropy_coding_context_ctor(
     EbFifo                *rate_control_output_fifo_ptr,
     EbBool                   is16bit);
 
+// Also called by EncDec, which writes the neighbor arrays when recording the SB symbols
+extern void EntropyCodingResetNeighborArrays(PictureControlSet_t *picture_control_set_ptr);
+
 extern void* EntropyCodingKernel(void *input_ptr);
 
 #endif // EbEntropyCodingProcess_h
\ No newline at end of file
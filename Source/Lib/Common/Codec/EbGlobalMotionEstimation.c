@@ -0,0 +1,388 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "EbGlobalMotionEstimation.h"
+#include "EbSequenceControlSet.h"
+#include "EbReferenceObject.h"
+#include "EbMotionEstimationContext.h"
+#include "EbComputeSAD_C.h"
+#include "EbComputeSAD_AVX2.h"
+
+#define GM_BLOCK_SIZE               ((int32_t)BLOCK_SIZE_64 >> 2)  // one SB in the 1/16 decimated picture
+#define GM_MAX_SAMPLE_COUNT         256                    // sparse SB samples per reference list
+#define GM_MIN_INLIER_COUNT         4
+#define GM_INLIER_TH                1.0                    // 1/16 decimated pels
+#define GM_FIT_ITERATIONS           3
+#define GM_MIN_CAMERA_MOTION        1.0                    // 1/16 decimated pels at the picture corners
+#define GM_EXPLAINED_SAD_SCALE      2                      // x mean inlier SAD
+#define GM_EXPLAINED_SAD_MIN        (GM_BLOCK_SIZE * GM_BLOCK_SIZE)
+
+typedef struct GmSample_s {
+    uint32_t    sb_index;
+    double      pos_x;          // SB centre relative to the picture centre, 1/16 decimated pels
+    double      pos_y;
+    int32_t     mv_x;           // 1/16 decimated pels
+    int32_t     mv_y;
+    uint32_t    sad;
+} GmSample_t;
+
+static int32_t compare_int32(const void *a, const void *b)
+{
+    const int32_t x = *(const int32_t *)a;
+    const int32_t y = *(const int32_t *)b;
+    return (x > y) - (x < y);
+}
+
+/***************************************
+* Clamps a displacement so the block stays inside the padded reference
+***************************************/
+static void gm_clamp_mv(
+    EbPictureBufferDesc_t *ref_pic_ptr,
+    int32_t                block_x,
+    int32_t                block_y,
+    int32_t               *mv_x,
+    int32_t               *mv_y)
+{
+    *mv_x = CLIP3(-(int32_t)ref_pic_ptr->origin_x - block_x, (int32_t)(ref_pic_ptr->width + ref_pic_ptr->origin_x) - GM_BLOCK_SIZE - block_x, *mv_x);
+    *mv_y = CLIP3(-(int32_t)ref_pic_ptr->origin_y - block_y, (int32_t)(ref_pic_ptr->height + ref_pic_ptr->origin_y) - GM_BLOCK_SIZE - block_y, *mv_y);
+}
+
+static uint32_t gm_block_sad(
+    EbPictureBufferDesc_t *cur_pic_ptr,
+    EbPictureBufferDesc_t *ref_pic_ptr,
+    int32_t                block_x,
+    int32_t                block_y,
+    int32_t                mv_x,
+    int32_t                mv_y,
+    EbAsm                  asm_type)
+{
+    const uint8_t *src = &cur_pic_ptr->buffer_y[(cur_pic_ptr->origin_y + block_y) * cur_pic_ptr->stride_y + cur_pic_ptr->origin_x + block_x];
+    const uint8_t *ref = &ref_pic_ptr->buffer_y[(ref_pic_ptr->origin_y + block_y + mv_y) * ref_pic_ptr->stride_y + ref_pic_ptr->origin_x + block_x + mv_x];
+
+    return (asm_type == ASM_AVX2) ?
+        compute16x_m_sad_avx2_intrin(src, cur_pic_ptr->stride_y, ref, ref_pic_ptr->stride_y, GM_BLOCK_SIZE, GM_BLOCK_SIZE) :
+        fast_loop_nx_m_sad_kernel(src, cur_pic_ptr->stride_y, ref, ref_pic_ptr->stride_y, GM_BLOCK_SIZE, GM_BLOCK_SIZE);
+}
+
+/***************************************
+* Coarse (2 pel step) then +/-1 pel search of one decimated SB
+***************************************/
+static uint32_t gm_block_search(
+    EbPictureBufferDesc_t *cur_pic_ptr,
+    EbPictureBufferDesc_t *ref_pic_ptr,
+    int32_t                block_x,
+    int32_t                block_y,
+    int32_t                range_x,
+    int32_t                range_y,
+    int32_t               *best_mv_x,
+    int32_t               *best_mv_y,
+    EbAsm                  asm_type)
+{
+    int32_t  min_x = -range_x, min_y = -range_y;
+    int32_t  max_x = range_x, max_y = range_y;
+    int32_t  center_x, center_y;
+    int32_t  mv_x, mv_y;
+    uint32_t sad;
+    uint32_t best_sad;
+
+    gm_clamp_mv(ref_pic_ptr, block_x, block_y, &min_x, &min_y);
+    gm_clamp_mv(ref_pic_ptr, block_x, block_y, &max_x, &max_y);
+
+    *best_mv_x = 0;
+    *best_mv_y = 0;
+    gm_clamp_mv(ref_pic_ptr, block_x, block_y, best_mv_x, best_mv_y);
+    best_sad = gm_block_sad(cur_pic_ptr, ref_pic_ptr, block_x, block_y, *best_mv_x, *best_mv_y, asm_type);
+
+    for (mv_y = min_y; mv_y <= max_y; mv_y += 2) {
+        for (mv_x = min_x; mv_x <= max_x; mv_x += 2) {
+            sad = gm_block_sad(cur_pic_ptr, ref_pic_ptr, block_x, block_y, mv_x, mv_y, asm_type);
+            if (sad < best_sad) {
+                best_sad = sad;
+                *best_mv_x = mv_x;
+                *best_mv_y = mv_y;
+            }
+        }
+    }
+
+    center_x = *best_mv_x;
+    center_y = *best_mv_y;
+    for (mv_y = MAX(min_y, center_y - 1); mv_y <= MIN(max_y, center_y + 1); ++mv_y) {
+        for (mv_x = MAX(min_x, center_x - 1); mv_x <= MIN(max_x, center_x + 1); ++mv_x) {
+            if (mv_x == center_x && mv_y == center_y)
+                continue;
+            sad = gm_block_sad(cur_pic_ptr, ref_pic_ptr, block_x, block_y, mv_x, mv_y, asm_type);
+            if (sad < best_sad) {
+                best_sad = sad;
+                *best_mv_x = mv_x;
+                *best_mv_y = mv_y;
+            }
+        }
+    }
+
+    return best_sad;
+}
+
+/***************************************
+* Least squares ROTZOOM fit on the inliers
+*   mv_x = tx + a * x - b * y
+*   mv_y = ty + b * x + a * y
+* model = { tx, ty, a, b }
+***************************************/
+static void gm_fit_rotzoom(
+    const GmSample_t *sample_array,
+    const uint8_t    *inlier_array,
+    uint32_t          sample_count,
+    double           *model)
+{
+    double   mean_x = 0, mean_y = 0, mean_mv_x = 0, mean_mv_y = 0;
+    double   num_a = 0, num_b = 0, den = 0;
+    uint32_t count = 0;
+    uint32_t i;
+
+    for (i = 0; i < sample_count; ++i) {
+        if (!inlier_array[i])
+            continue;
+        mean_x += sample_array[i].pos_x;
+        mean_y += sample_array[i].pos_y;
+        mean_mv_x += sample_array[i].mv_x;
+        mean_mv_y += sample_array[i].mv_y;
+        ++count;
+    }
+    if (count == 0)
+        return;
+    mean_x /= count;
+    mean_y /= count;
+    mean_mv_x /= count;
+    mean_mv_y /= count;
+
+    for (i = 0; i < sample_count; ++i) {
+        if (!inlier_array[i])
+            continue;
+        const double x = sample_array[i].pos_x - mean_x;
+        const double y = sample_array[i].pos_y - mean_y;
+        const double mv_x = sample_array[i].mv_x - mean_mv_x;
+        const double mv_y = sample_array[i].mv_y - mean_mv_y;
+        num_a += x * mv_x + y * mv_y;
+        num_b += x * mv_y - y * mv_x;
+        den += x * x + y * y;
+    }
+
+    // Samples bunched in one spot only support a translation
+    model[2] = (den > 1.0) ? num_a / den : 0;
+    model[3] = (den > 1.0) ? num_b / den : 0;
+    model[0] = mean_mv_x - model[2] * mean_x + model[3] * mean_y;
+    model[1] = mean_mv_y - model[3] * mean_x - model[2] * mean_y;
+}
+
+static uint32_t gm_mark_inliers(
+    const GmSample_t *sample_array,
+    uint8_t          *inlier_array,
+    uint32_t          sample_count,
+    const double     *model)
+{
+    uint32_t inlier_count = 0;
+    uint32_t i;
+
+    for (i = 0; i < sample_count; ++i) {
+        const double x = sample_array[i].pos_x;
+        const double y = sample_array[i].pos_y;
+        const double err_x = model[0] + model[2] * x - model[3] * y - sample_array[i].mv_x;
+        const double err_y = model[1] + model[3] * x + model[2] * y - sample_array[i].mv_y;
+        inlier_array[i] = (fabs(err_x) <= GM_INLIER_TH && fabs(err_y) <= GM_INLIER_TH);
+        inlier_count += inlier_array[i];
+    }
+
+    return inlier_count;
+}
+
+void global_motion_estimate_mv(
+    const GlobalMotionEstimate_t *gm_estimate_ptr,
+    int32_t                       pos_x,
+    int32_t                       pos_y,
+    int32_t                       picture_width,
+    int32_t                       picture_height,
+    int16_t                      *mv_x,
+    int16_t                      *mv_y)
+{
+    const int64_t x = pos_x - (picture_width >> 1);
+    const int64_t y = pos_y - (picture_height >> 1);
+    const int64_t dx = ((int64_t)gm_estimate_ptr->zoom * x - (int64_t)gm_estimate_ptr->rot * y) * 4;
+    const int64_t dy = ((int64_t)gm_estimate_ptr->rot * x + (int64_t)gm_estimate_ptr->zoom * y) * 4;
+
+    *mv_x = (int16_t)(gm_estimate_ptr->trans_x + ROUND_POWER_OF_TWO_SIGNED_64(dx, WARPEDMODEL_PREC_BITS));
+    *mv_y = (int16_t)(gm_estimate_ptr->trans_y + ROUND_POWER_OF_TWO_SIGNED_64(dy, WARPEDMODEL_PREC_BITS));
+}
+
+EbBool global_motion_is_translational(
+    const GlobalMotionEstimate_t *gm_estimate_ptr,
+    int32_t                       picture_width,
+    int32_t                       picture_height)
+{
+    // Zoom and rotation move the picture corners by less than one pel
+    const int64_t corner_shift =
+        (int64_t)ABS(gm_estimate_ptr->zoom) * (picture_width >> 1) +
+        (int64_t)ABS(gm_estimate_ptr->rot) * (picture_height >> 1);
+
+    return (EbBool)(gm_estimate_ptr->valid && corner_shift < ((int64_t)1 << WARPEDMODEL_PREC_BITS));
+}
+
+void estimate_global_motion(
+    PictureParentControlSet_t   *picture_control_set_ptr,
+    EbAsm                        asm_type)
+{
+    SequenceControlSet    *sequence_control_set_ptr = (SequenceControlSet*)picture_control_set_ptr->sequence_control_set_wrapper_ptr->object_ptr;
+    EbPaReferenceObject   *paReferenceObject = (EbPaReferenceObject*)picture_control_set_ptr->pa_reference_picture_wrapper_ptr->object_ptr;
+    EbPictureBufferDesc_t *cur_pic_ptr = paReferenceObject->sixteenth_decimated_picture_ptr;
+    EbPictureBufferDesc_t *ref_pic_ptr;
+    const uint32_t         picture_width_in_sb = (sequence_control_set_ptr->luma_width + sequence_control_set_ptr->sb_sz - 1) / sequence_control_set_ptr->sb_sz;
+    const uint32_t         complete_sb_width = sequence_control_set_ptr->luma_width / BLOCK_SIZE_64;
+    const uint32_t         complete_sb_height = sequence_control_set_ptr->luma_height / BLOCK_SIZE_64;
+    const int32_t          range_x = sequence_control_set_ptr->static_config.hme_level0_total_search_area_width >> 1;
+    const int32_t          range_y = sequence_control_set_ptr->static_config.hme_level0_total_search_area_height >> 1;
+    const uint32_t         list_count = (picture_control_set_ptr->slice_type == P_SLICE) ? 1 : MAX_NUM_OF_REF_PIC_LIST;
+    const double           picture_half_width = sequence_control_set_ptr->luma_width / 8.0;
+    const double           picture_half_height = sequence_control_set_ptr->luma_height / 8.0;
+    GmSample_t             sample_array[GM_MAX_SAMPLE_COUNT];
+    uint8_t                inlier_array[GM_MAX_SAMPLE_COUNT];
+    int32_t                median_array[GM_MAX_SAMPLE_COUNT];
+    uint32_t               sample_count;
+    uint32_t               inlier_count;
+    uint32_t               sb_step;
+    uint32_t               list_index;
+    uint32_t               x_sb_index, y_sb_index;
+    uint32_t               i;
+
+    // Sample every sb_step-th textured SB in both directions to keep the search sparse
+    sb_step = 1;
+    while ((complete_sb_width / sb_step) * (complete_sb_height / sb_step) > GM_MAX_SAMPLE_COUNT)
+        ++sb_step;
+
+    for (list_index = REF_LIST_0; list_index < MAX_NUM_OF_REF_PIC_LIST; ++list_index) {
+
+        GlobalMotionEstimate_t *gm_estimate_ptr = &picture_control_set_ptr->gm_estimate[list_index];
+        uint8_t                *explained_array = picture_control_set_ptr->gm_explained_sb_array[list_index];
+        double                  model[4] = { 0, 0, 0, 0 };
+        uint64_t                inlier_sad = 0;
+        uint32_t                explained_sad_th;
+        uint32_t                iteration;
+
+        EB_MEMSET(gm_estimate_ptr, 0, sizeof(GlobalMotionEstimate_t));
+        EB_MEMSET(explained_array, 0, sizeof(uint8_t) * picture_control_set_ptr->sb_total_count);
+
+        if (picture_control_set_ptr->gm_level == 0 || picture_control_set_ptr->slice_type == I_SLICE || list_index >= list_count)
+            continue;
+
+        // Both lists point to the same picture
+        if (list_index == REF_LIST_1 && picture_control_set_ptr->ref_pic_poc_array[REF_LIST_0] == picture_control_set_ptr->ref_pic_poc_array[REF_LIST_1]) {
+            *gm_estimate_ptr = picture_control_set_ptr->gm_estimate[REF_LIST_0];
+            EB_MEMCPY(explained_array, picture_control_set_ptr->gm_explained_sb_array[REF_LIST_0], sizeof(uint8_t) * picture_control_set_ptr->sb_total_count);
+            continue;
+        }
+
+        ref_pic_ptr = ((EbPaReferenceObject*)picture_control_set_ptr->ref_pa_pic_ptr_array[list_index]->object_ptr)->sixteenth_decimated_picture_ptr;
+
+        // Sparse block matching on the decimated pictures
+        sample_count = 0;
+        for (y_sb_index = 0; y_sb_index < complete_sb_height; y_sb_index += sb_step) {
+            for (x_sb_index = 0; x_sb_index < complete_sb_width; x_sb_index += sb_step) {
+                const uint32_t sb_index = x_sb_index + y_sb_index * picture_width_in_sb;
+                GmSample_t    *sample_ptr = &sample_array[sample_count];
+
+                // Flat SBs match anywhere
+                if (picture_control_set_ptr->variance[sb_index][ME_TIER_ZERO_PU_64x64] <= IS_COMPLEX_LCU_VARIANCE_TH)
+                    continue;
+
+                sample_ptr->sb_index = sb_index;
+                sample_ptr->pos_x = ((int32_t)(x_sb_index * BLOCK_SIZE_64 + (BLOCK_SIZE_64 >> 1)) - (int32_t)(sequence_control_set_ptr->luma_width >> 1)) / 4.0;
+                sample_ptr->pos_y = ((int32_t)(y_sb_index * BLOCK_SIZE_64 + (BLOCK_SIZE_64 >> 1)) - (int32_t)(sequence_control_set_ptr->luma_height >> 1)) / 4.0;
+                sample_ptr->sad = gm_block_search(
+                    cur_pic_ptr,
+                    ref_pic_ptr,
+                    x_sb_index * GM_BLOCK_SIZE,
+                    y_sb_index * GM_BLOCK_SIZE,
+                    range_x,
+                    range_y,
+                    &sample_ptr->mv_x,
+                    &sample_ptr->mv_y,
+                    asm_type);
+                ++sample_count;
+            }
+        }
+        gm_estimate_ptr->sample_count = sample_count;
+        if (sample_count < GM_MIN_INLIER_COUNT)
+            continue;
+
+        // Robust fit: start from the median translation, then alternate inlier selection and refit
+        for (i = 0; i < sample_count; ++i)
+            median_array[i] = sample_array[i].mv_x;
+        qsort(median_array, sample_count, sizeof(int32_t), compare_int32);
+        model[0] = median_array[sample_count >> 1];
+        for (i = 0; i < sample_count; ++i)
+            median_array[i] = sample_array[i].mv_y;
+        qsort(median_array, sample_count, sizeof(int32_t), compare_int32);
+        model[1] = median_array[sample_count >> 1];
+
+        inlier_count = gm_mark_inliers(sample_array, inlier_array, sample_count, model);
+        for (iteration = 0; iteration < GM_FIT_ITERATIONS && inlier_count >= GM_MIN_INLIER_COUNT; ++iteration) {
+            gm_fit_rotzoom(sample_array, inlier_array, sample_count, model);
+            inlier_count = gm_mark_inliers(sample_array, inlier_array, sample_count, model);
+        }
+        gm_estimate_ptr->inlier_count = inlier_count;
+
+        // The camera model has to explain most of the textured SBs
+        if (inlier_count < GM_MIN_INLIER_COUNT || inlier_count * 4 < sample_count * 3)
+            continue;
+
+        // A still camera is left to HME, which resolves local motion better than the model
+        if (fabs(model[0]) + fabs(model[2]) * picture_half_width + fabs(model[3]) * picture_half_height < GM_MIN_CAMERA_MOTION &&
+            fabs(model[1]) + fabs(model[3]) * picture_half_width + fabs(model[2]) * picture_half_height < GM_MIN_CAMERA_MOTION)
+            continue;
+
+        gm_estimate_ptr->valid = EB_TRUE;
+        gm_estimate_ptr->trans_x = (int32_t)floor(model[0] * 16 + 0.5);
+        gm_estimate_ptr->trans_y = (int32_t)floor(model[1] * 16 + 0.5);
+        gm_estimate_ptr->zoom = (int32_t)floor(model[2] * (1 << WARPEDMODEL_PREC_BITS) + 0.5);
+        gm_estimate_ptr->rot = (int32_t)floor(model[3] * (1 << WARPEDMODEL_PREC_BITS) + 0.5);
+
+        for (i = 0; i < sample_count; ++i)
+            inlier_sad += inlier_array[i] ? sample_array[i].sad : 0;
+        explained_sad_th = MAX(GM_EXPLAINED_SAD_MIN, (uint32_t)(GM_EXPLAINED_SAD_SCALE * inlier_sad / inlier_count));
+
+        // SBs that were not sampled are explained when they match as well as the inliers at the model MV
+        for (y_sb_index = 0; y_sb_index < complete_sb_height; ++y_sb_index) {
+            for (x_sb_index = 0; x_sb_index < complete_sb_width; ++x_sb_index) {
+                int16_t mv_x, mv_y;
+                int32_t block_mv_x, block_mv_y;
+
+                global_motion_estimate_mv(
+                    gm_estimate_ptr,
+                    x_sb_index * BLOCK_SIZE_64 + (BLOCK_SIZE_64 >> 1),
+                    y_sb_index * BLOCK_SIZE_64 + (BLOCK_SIZE_64 >> 1),
+                    sequence_control_set_ptr->luma_width,
+                    sequence_control_set_ptr->luma_height,
+                    &mv_x,
+                    &mv_y);
+                block_mv_x = (mv_x + 8) >> 4;
+                block_mv_y = (mv_y + 8) >> 4;
+                gm_clamp_mv(ref_pic_ptr, x_sb_index * GM_BLOCK_SIZE, y_sb_index * GM_BLOCK_SIZE, &block_mv_x, &block_mv_y);
+
+                explained_array[x_sb_index + y_sb_index * picture_width_in_sb] = (uint8_t)(gm_block_sad(
+                    cur_pic_ptr,
+                    ref_pic_ptr,
+                    x_sb_index * GM_BLOCK_SIZE,
+                    y_sb_index * GM_BLOCK_SIZE,
+                    block_mv_x,
+                    block_mv_y,
+                    asm_type) <= explained_sad_th);
+            }
+        }
+        for (i = 0; i < sample_count; ++i)
+            explained_array[sample_array[i].sb_index] = inlier_array[i];
+    }
+}
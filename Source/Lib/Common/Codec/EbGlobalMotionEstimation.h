@@ -0,0 +1,51 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#ifndef EbGlobalMotionEstimation_h
+#define EbGlobalMotionEstimation_h
+
+#include "EbDefinitions.h"
+#include "EbPictureControlSet.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ME search area around the global motion MV of the SBs the model explains
+#define GM_REFINEMENT_SEARCH_AREA_WIDTH     16
+#define GM_REFINEMENT_SEARCH_AREA_HEIGHT    9
+
+    /***************************************
+    * Estimates a ROTZOOM camera model per reference list from the
+    * 1/16 decimated HME pictures and flags the SBs the model explains
+    ***************************************/
+    extern void estimate_global_motion(
+        PictureParentControlSet_t   *picture_control_set_ptr,
+        EbAsm                        asm_type);
+
+    /***************************************
+    * Quarter-pel MV predicted by the model at a full resolution position
+    ***************************************/
+    extern void global_motion_estimate_mv(
+        const GlobalMotionEstimate_t *gm_estimate_ptr,
+        int32_t                       pos_x,
+        int32_t                       pos_y,
+        int32_t                       picture_width,
+        int32_t                       picture_height,
+        int16_t                      *mv_x,
+        int16_t                      *mv_y);
+
+    /***************************************
+    * True when the model is a pure translation over the whole picture
+    * (AV1 global motion is only signalled as TRANSLATION in this encoder)
+    ***************************************/
+    extern EbBool global_motion_is_translational(
+        const GlobalMotionEstimate_t *gm_estimate_ptr,
+        int32_t                       picture_width,
+        int32_t                       picture_height);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // EbGlobalMotionEstimation_h
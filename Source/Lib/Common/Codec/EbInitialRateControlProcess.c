@@ -1722,6 +1722,12 @@ void* InitialRateControlKernel(void *input_ptr)
                 }
             }
 
+            // Record the analysis pass stats
+            if (sequence_control_set_ptr->static_config.rc_firstpass_stats_out)
+                RcStatsRecord(
+                    encode_context_ptr,
+                    picture_control_set_ptr);
+
             for (temporal_layer_index = 0; temporal_layer_index < EB_MAX_TEMPORAL_LAYERS; temporal_layer_index++) {
                 picture_control_set_ptr->frames_in_interval[temporal_layer_index] = 0;
             }
@@ -1983,16 +1989,25 @@ void* InitialRateControlKernel(void *input_ptr)
                     picture_control_set_ptr->output_stream_wrapper_ptr = output_stream_wrapper_ptr;
 
 
-                    // Get Empty Results Object
-                    eb_get_empty_object(
-                        context_ptr->initialrateControlResultsOutputFifoPtr,
-                        &outputResultsWrapperPtr);
-
-                    outputResultsPtr = (InitialRateControlResults_t*)outputResultsWrapperPtr->object_ptr;
-                    outputResultsPtr->picture_control_set_wrapper_ptr = queueEntryPtr->parentPcsWrapperPtr;
-                    /////////////////////////////
-                    // Post the Full Results Object
-                    eb_post_full_object(outputResultsWrapperPtr);
+                    // Source based operations segments
+                    picture_control_set_ptr->sbo_segments_total_count = (uint16_t)MIN(
+                        sequence_control_set_ptr->sbo_segment_row_count,
+                        sequence_control_set_ptr->picture_height_in_sb);
+                    picture_control_set_ptr->sbo_segments_completion_count = 0;
+
+                    for (uint32_t segment_index = 0; segment_index < picture_control_set_ptr->sbo_segments_total_count; ++segment_index) {
+                        // Get Empty Results Object
+                        eb_get_empty_object(
+                            context_ptr->initialrateControlResultsOutputFifoPtr,
+                            &outputResultsWrapperPtr);
+
+                        outputResultsPtr = (InitialRateControlResults_t*)outputResultsWrapperPtr->object_ptr;
+                        outputResultsPtr->picture_control_set_wrapper_ptr = queueEntryPtr->parentPcsWrapperPtr;
+                        outputResultsPtr->segment_index = segment_index;
+                        /////////////////////////////
+                        // Post the Full Results Object
+                        eb_post_full_object(outputResultsWrapperPtr);
+                    }
 
                     // Reset the Reorder Queue Entry
                     queueEntryPtr->picture_number += INITIAL_RATE_CONTROL_REORDER_QUEUE_MAX_DEPTH;
@@ -15,6 +15,7 @@
 typedef struct InitialRateControlResults_s
 {
     EbObjectWrapper   *picture_control_set_wrapper_ptr;
+    uint32_t           segment_index;
 } InitialRateControlResults_t;
 
 typedef struct InitialRateControlResultInitData_s
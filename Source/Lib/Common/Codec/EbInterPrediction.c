@@ -3569,6 +3569,191 @@ static INLINE int32_t av1_is_interp_needed(
     return 1;
 }
 
+/***************************************************
+* MD inter prediction cache
+***************************************************/
+void md_pred_cache_reset(
+    ModeDecisionContext_t                  *md_context_ptr)
+{
+    uint32_t entry;
+    for (entry = 0; entry < MD_PRED_CACHE_SIZE; ++entry)
+        md_context_ptr->md_pred_cache[entry].valid = EB_FALSE;
+    md_context_ptr->md_pred_cache_next = 0;
+}
+
+// The prediction of a pixel only depends on its position, the reference, the MV and the filter
+// taps, unless the MV gets clamped to the UMV border; such blocks are kept out of the cache.
+static EbBool md_pred_cache_mv_unclamped(
+    const MacroBlockD                      *xd,
+    const MvUnit_t                         *mv_unit,
+    const BlockGeom                        *blk_geom)
+{
+    uint32_t list;
+    for (list = REF_LIST_0; list <= REF_LIST_1; ++list) {
+        if (mv_unit->predDirection != BI_PRED && mv_unit->predDirection != list)
+            continue;
+        MV mv;
+        mv.col = mv_unit->mv[list].x;
+        mv.row = mv_unit->mv[list].y;
+        MV mv_q4 = clamp_mv_to_umv_border_sb(xd, &mv, blk_geom->bwidth, blk_geom->bheight, 0, 0);
+        if (mv_q4.col != mv.col * 2 || mv_q4.row != mv.row * 2)
+            return EB_FALSE;
+        mv_q4 = clamp_mv_to_umv_border_sb(xd, &mv, blk_geom->bwidth_uv, blk_geom->bheight_uv, 1, 1);
+        if (mv_q4.col != mv.col || mv_q4.row != mv.row)
+            return EB_FALSE;
+    }
+    return EB_TRUE;
+}
+
+static void md_pred_cache_copy(
+    uint8_t                                *src,
+    uint32_t                                src_stride,
+    uint8_t                                *dst,
+    uint32_t                                dst_stride,
+    uint32_t                                width,
+    uint32_t                                height)
+{
+    uint32_t row;
+    for (row = 0; row < height; ++row)
+        EB_MEMCPY(dst + row * dst_stride, src + row * src_stride, width);
+}
+
+// av1_inter_prediction for the current MD block, served from / stored into the MD prediction cache
+// for blocks of 8x8 and above (8 bit only)
+static EbErrorType md_inter_prediction(
+    PictureControlSet_t                    *picture_control_set_ptr,
+    ModeDecisionContext_t                  *md_context_ptr,
+    uint32_t                                interp_filters,
+    uint8_t                                 ref_frame_type,
+    MvUnit_t                               *mv_unit,
+    EbPictureBufferDesc_t                  *ref_pic_list0,
+    EbPictureBufferDesc_t                  *ref_pic_list1,
+    EbPictureBufferDesc_t                  *prediction_ptr,
+    EbBool                                  perform_chroma,
+    EbAsm                                   asm_type)
+{
+    EbErrorType return_error = EB_ErrorNone;
+    const BlockGeom *blk_geom = md_context_ptr->blk_geom;
+    const EbBool chroma = perform_chroma && blk_geom->has_uv;
+    const uint8_t uv_4tap = (blk_geom->bwidth_uv <= 4) | ((blk_geom->bheight_uv <= 4) << 1);
+    int16_t mv[MAX_NUM_OF_REF_PIC_LIST][2] = { { 0, 0 }, { 0, 0 } };
+    uint32_t list, entry;
+
+    const EbBool cacheable = blk_geom->bwidth >= 8 && blk_geom->bheight >= 8 &&
+        md_pred_cache_mv_unclamped(md_context_ptr->cu_ptr->av1xd, mv_unit, blk_geom);
+
+    if (cacheable) {
+        for (list = REF_LIST_0; list <= REF_LIST_1; ++list) {
+            if (mv_unit->predDirection == BI_PRED || mv_unit->predDirection == list) {
+                mv[list][0] = mv_unit->mv[list].x;
+                mv[list][1] = mv_unit->mv[list].y;
+            }
+        }
+
+        for (entry = 0; entry < MD_PRED_CACHE_SIZE; ++entry) {
+            MdPredCacheEntry_t *cache_entry = &md_context_ptr->md_pred_cache[entry];
+            if (!cache_entry->valid ||
+                cache_entry->ref_frame_type != ref_frame_type ||
+                cache_entry->pred_direction != mv_unit->predDirection ||
+                cache_entry->interp_filters != interp_filters ||
+                memcmp(cache_entry->mv, mv, sizeof(mv)) ||
+                blk_geom->origin_x < cache_entry->origin_x ||
+                blk_geom->origin_y < cache_entry->origin_y ||
+                blk_geom->origin_x + blk_geom->bwidth > cache_entry->origin_x + cache_entry->bwidth ||
+                blk_geom->origin_y + blk_geom->bheight > cache_entry->origin_y + cache_entry->bheight ||
+                (chroma && (!cache_entry->chroma || cache_entry->uv_4tap != uv_4tap)))
+                continue;
+
+            md_pred_cache_copy(
+                cache_entry->buffer_y + blk_geom->origin_x + blk_geom->origin_y * MAX_SB_SIZE,
+                MAX_SB_SIZE,
+                prediction_ptr->buffer_y + prediction_ptr->origin_x + blk_geom->origin_x + (prediction_ptr->origin_y + blk_geom->origin_y) * prediction_ptr->stride_y,
+                prediction_ptr->stride_y,
+                blk_geom->bwidth,
+                blk_geom->bheight);
+            if (chroma) {
+                md_pred_cache_copy(
+                    cache_entry->buffer_cb + blk_geom->origin_x / 2 + blk_geom->origin_y / 2 * (MAX_SB_SIZE >> 1),
+                    MAX_SB_SIZE >> 1,
+                    prediction_ptr->bufferCb + (prediction_ptr->origin_x + blk_geom->origin_x) / 2 + (prediction_ptr->origin_y + blk_geom->origin_y) / 2 * prediction_ptr->strideCb,
+                    prediction_ptr->strideCb,
+                    blk_geom->bwidth_uv,
+                    blk_geom->bheight_uv);
+                md_pred_cache_copy(
+                    cache_entry->buffer_cr + blk_geom->origin_x / 2 + blk_geom->origin_y / 2 * (MAX_SB_SIZE >> 1),
+                    MAX_SB_SIZE >> 1,
+                    prediction_ptr->bufferCr + (prediction_ptr->origin_x + blk_geom->origin_x) / 2 + (prediction_ptr->origin_y + blk_geom->origin_y) / 2 * prediction_ptr->strideCr,
+                    prediction_ptr->strideCr,
+                    blk_geom->bwidth_uv,
+                    blk_geom->bheight_uv);
+            }
+            return return_error;
+        }
+    }
+
+    av1_inter_prediction(
+        picture_control_set_ptr,
+        interp_filters,
+        md_context_ptr->cu_ptr,
+        ref_frame_type,
+        mv_unit,
+        0,//use_intrabc
+        md_context_ptr->cu_origin_x,
+        md_context_ptr->cu_origin_y,
+        blk_geom->bwidth,
+        blk_geom->bheight,
+        ref_pic_list0,
+        ref_pic_list1,
+        prediction_ptr,
+        blk_geom->origin_x,
+        blk_geom->origin_y,
+        perform_chroma,
+        asm_type);
+
+    if (cacheable) {
+        MdPredCacheEntry_t *cache_entry = &md_context_ptr->md_pred_cache[md_context_ptr->md_pred_cache_next];
+        md_context_ptr->md_pred_cache_next = (md_context_ptr->md_pred_cache_next + 1) % MD_PRED_CACHE_SIZE;
+
+        cache_entry->valid = EB_TRUE;
+        cache_entry->ref_frame_type = ref_frame_type;
+        cache_entry->pred_direction = mv_unit->predDirection;
+        cache_entry->interp_filters = interp_filters;
+        memcpy(cache_entry->mv, mv, sizeof(mv));
+        cache_entry->origin_x = blk_geom->origin_x;
+        cache_entry->origin_y = blk_geom->origin_y;
+        cache_entry->bwidth = blk_geom->bwidth;
+        cache_entry->bheight = blk_geom->bheight;
+        cache_entry->chroma = chroma;
+        cache_entry->uv_4tap = uv_4tap;
+
+        md_pred_cache_copy(
+            prediction_ptr->buffer_y + prediction_ptr->origin_x + blk_geom->origin_x + (prediction_ptr->origin_y + blk_geom->origin_y) * prediction_ptr->stride_y,
+            prediction_ptr->stride_y,
+            cache_entry->buffer_y + blk_geom->origin_x + blk_geom->origin_y * MAX_SB_SIZE,
+            MAX_SB_SIZE,
+            blk_geom->bwidth,
+            blk_geom->bheight);
+        if (chroma) {
+            md_pred_cache_copy(
+                prediction_ptr->bufferCb + (prediction_ptr->origin_x + blk_geom->origin_x) / 2 + (prediction_ptr->origin_y + blk_geom->origin_y) / 2 * prediction_ptr->strideCb,
+                prediction_ptr->strideCb,
+                cache_entry->buffer_cb + blk_geom->origin_x / 2 + blk_geom->origin_y / 2 * (MAX_SB_SIZE >> 1),
+                MAX_SB_SIZE >> 1,
+                blk_geom->bwidth_uv,
+                blk_geom->bheight_uv);
+            md_pred_cache_copy(
+                prediction_ptr->bufferCr + (prediction_ptr->origin_x + blk_geom->origin_x) / 2 + (prediction_ptr->origin_y + blk_geom->origin_y) / 2 * prediction_ptr->strideCr,
+                prediction_ptr->strideCr,
+                cache_entry->buffer_cr + blk_geom->origin_x / 2 + blk_geom->origin_y / 2 * (MAX_SB_SIZE >> 1),
+                MAX_SB_SIZE >> 1,
+                blk_geom->bwidth_uv,
+                blk_geom->bheight_uv);
+        }
+    }
+
+    return return_error;
+}
+
 #define DUAL_FILTER_SET_SIZE (SWITCHABLE_FILTERS * SWITCHABLE_FILTERS)
 static const int32_t filter_sets[DUAL_FILTER_SET_SIZE][2] = {
   { 0, 0 }, { 0, 1 }, { 0, 2 }, { 1, 0 }, { 1, 1 },
@@ -3626,22 +3811,15 @@ static const int32_t filter_sets[DUAL_FILTER_SET_SIZE][2] = {
         //xd
     );
 
-    av1_inter_prediction(
+    md_inter_prediction(
         picture_control_set_ptr,
+        md_context_ptr,
         candidate_buffer_ptr->candidate_ptr->interp_filters,
-        md_context_ptr->cu_ptr,
         candidate_buffer_ptr->candidate_ptr->ref_frame_type,
         &mv_unit,
-        0,
-        md_context_ptr->cu_origin_x,
-        md_context_ptr->cu_origin_y,
-        md_context_ptr->blk_geom->bwidth,
-        md_context_ptr->blk_geom->bheight,
         ref_pic_list0,
         ref_pic_list1,
         prediction_ptr,
-        md_context_ptr->blk_geom->origin_x,
-        md_context_ptr->blk_geom->origin_y,
         use_uv,
         asm_type);
 
@@ -3702,22 +3880,15 @@ static const int32_t filter_sets[DUAL_FILTER_SET_SIZE][2] = {
                     //                              mi_col,
                     //                              orig_dst,
                     //                              bsize);
-                    av1_inter_prediction(
+                    md_inter_prediction(
                         picture_control_set_ptr,
+                        md_context_ptr,
                         candidate_buffer_ptr->candidate_ptr->interp_filters,
-                        md_context_ptr->cu_ptr,
                         candidate_buffer_ptr->candidate_ptr->ref_frame_type,
                         &mv_unit,
-                        0,
-                        md_context_ptr->cu_origin_x,
-                        md_context_ptr->cu_origin_y,
-                        md_context_ptr->blk_geom->bwidth,
-                        md_context_ptr->blk_geom->bheight,
                         ref_pic_list0,
                         ref_pic_list1,
                         prediction_ptr,
-                        md_context_ptr->blk_geom->origin_x,
-                        md_context_ptr->blk_geom->origin_y,
                         use_uv,
                         asm_type);
 
@@ -3775,22 +3946,15 @@ static const int32_t filter_sets[DUAL_FILTER_SET_SIZE][2] = {
                     //                              orig_dst,
                     //                              bsize);
 
-                    av1_inter_prediction(
+                    md_inter_prediction(
                         picture_control_set_ptr,
+                        md_context_ptr,
                         candidate_buffer_ptr->candidate_ptr->interp_filters,
-                        md_context_ptr->cu_ptr,
                         candidate_buffer_ptr->candidate_ptr->ref_frame_type,
                         &mv_unit,
-                        0,
-                        md_context_ptr->cu_origin_x,
-                        md_context_ptr->cu_origin_y,
-                        md_context_ptr->blk_geom->bwidth,
-                        md_context_ptr->blk_geom->bheight,
                         ref_pic_list0,
                         ref_pic_list1,
                         prediction_ptr,
-                        md_context_ptr->blk_geom->origin_x,
-                        md_context_ptr->blk_geom->origin_y,
                         use_uv,
                         asm_type);
 
@@ -3851,22 +4015,15 @@ static const int32_t filter_sets[DUAL_FILTER_SET_SIZE][2] = {
                     //                              orig_dst,
                     //                              bsize);
 
-                    av1_inter_prediction(
+                    md_inter_prediction(
                         picture_control_set_ptr,
+                        md_context_ptr,
                         candidate_buffer_ptr->candidate_ptr->interp_filters,
-                        md_context_ptr->cu_ptr,
                         candidate_buffer_ptr->candidate_ptr->ref_frame_type,
                         &mv_unit,
-                        0,
-                        md_context_ptr->cu_origin_x,
-                        md_context_ptr->cu_origin_y,
-                        md_context_ptr->blk_geom->bwidth,
-                        md_context_ptr->blk_geom->bheight,
                         ref_pic_list0,
                         ref_pic_list1,
                         prediction_ptr,
-                        md_context_ptr->blk_geom->origin_x,
-                        md_context_ptr->blk_geom->origin_y,
                         use_uv,
                         asm_type);
 
@@ -4291,7 +4448,31 @@ EbErrorType inter_pu_prediction_av1(
 
     if (candidate_buffer_ptr->candidate_ptr->use_intrabc)
     {
-        if (is16bit) {
+        if (md_context_ptr->hbd_mode_decision) {
+            ref_pic_list0 = ((EbReferenceObject*)picture_control_set_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)->reference_picture16bit;
+            md_context_ptr->cu_ptr->interp_filters = candidate_buffer_ptr->candidate_ptr->interp_filters;
+
+            av1_inter_prediction_hbd(
+                picture_control_set_ptr,
+                candidate_buffer_ptr->candidate_ptr->ref_frame_type,
+                md_context_ptr->cu_ptr,
+                &mv_unit,
+                1,//use_intrabc
+                md_context_ptr->cu_origin_x,
+                md_context_ptr->cu_origin_y,
+                md_context_ptr->blk_geom->bwidth,
+                md_context_ptr->blk_geom->bheight,
+                ref_pic_list0,
+                0,// ref_pic_list1,
+                candidate_buffer_ptr->prediction_ptr,
+                md_context_ptr->blk_geom->origin_x,
+                md_context_ptr->blk_geom->origin_y,
+                (uint8_t)sequence_control_set_ptr->static_config.encoder_bit_depth,
+                asm_type);
+
+            return return_error;
+        }
+        else if (is16bit) {
 
             ref_pic_list0 = ((EbReferenceObject*)picture_control_set_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr)->reference_picture16bit;
 
@@ -4367,7 +4548,8 @@ EbErrorType inter_pu_prediction_av1(
                 &candidate_ptr->num_proj_ref);
 
     if (candidate_ptr->motion_mode == WARPED_CAUSAL) {
-        if (is16bit) {
+        // hbd mode decision predicts at the encoder bit depth into the 16bit candidate buffer
+        if (is16bit && !md_context_ptr->hbd_mode_decision) {
             warped_motion_prediction_md(
                 &mv_unit,
                 md_context_ptr,
@@ -4403,7 +4585,30 @@ EbErrorType inter_pu_prediction_av1(
 
     uint16_t capped_size = md_context_ptr->interpolation_filter_search_blk_size == 0 ? 4 : 
                            md_context_ptr->interpolation_filter_search_blk_size == 1 ? 8 : 16 ;
-    if (is16bit) {
+    if (md_context_ptr->hbd_mode_decision) {
+        // No interpolation filter search: it models the rate and distortion on the 8bit input
+        candidate_buffer_ptr->candidate_ptr->interp_filters = 0;
+        md_context_ptr->cu_ptr->interp_filters = candidate_buffer_ptr->candidate_ptr->interp_filters;
+
+        av1_inter_prediction_hbd(
+            picture_control_set_ptr,
+            candidate_buffer_ptr->candidate_ptr->ref_frame_type,
+            md_context_ptr->cu_ptr,
+            &mv_unit,
+            0,//use_intrabc
+            md_context_ptr->cu_origin_x,
+            md_context_ptr->cu_origin_y,
+            md_context_ptr->blk_geom->bwidth,
+            md_context_ptr->blk_geom->bheight,
+            ref_pic_list0,
+            ref_pic_list1,
+            candidate_buffer_ptr->prediction_ptr,
+            md_context_ptr->blk_geom->origin_x,
+            md_context_ptr->blk_geom->origin_y,
+            (uint8_t)sequence_control_set_ptr->static_config.encoder_bit_depth,
+            asm_type);
+    }
+    else if (is16bit) {
 #if INTERPOL_FILTER_SEARCH_10BIT_SUPPORT
         candidate_buffer_ptr->candidate_ptr->interp_filters = 0;
         if (!md_context_ptr->skip_interpolation_search) {
@@ -4467,24 +4672,16 @@ EbErrorType inter_pu_prediction_av1(
                     &skip_sse_sb);
         }
 
-        av1_inter_prediction(
+        md_inter_prediction(
             picture_control_set_ptr,
+            md_context_ptr,
             candidate_buffer_ptr->candidate_ptr->interp_filters,
-            md_context_ptr->cu_ptr,
             candidate_buffer_ptr->candidate_ptr->ref_frame_type,
             &mv_unit,
-            candidate_buffer_ptr->candidate_ptr->use_intrabc,
-            md_context_ptr->cu_origin_x,
-            md_context_ptr->cu_origin_y,
-            md_context_ptr->blk_geom->bwidth,
-            md_context_ptr->blk_geom->bheight,
             ref_pic_list0,
             ref_pic_list1,
             candidate_buffer_ptr->prediction_ptr,
-            md_context_ptr->blk_geom->origin_x,
-            md_context_ptr->blk_geom->origin_y,
             md_context_ptr->chroma_level == CHROMA_MODE_0,
-
             asm_type);
     }
 
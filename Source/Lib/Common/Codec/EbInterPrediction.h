@@ -48,6 +48,10 @@ extern "C" {
         EbBool                                  perform_chroma,
         EbAsm                                   asm_type);
 
+    // Invalidates the MD inter prediction cache (at each new SB)
+    extern void md_pred_cache_reset(
+        struct ModeDecisionContext_s           *md_context_ptr);
+
     EbErrorType inter_pu_prediction_av1(
         struct ModeDecisionContext_s           *md_context_ptr,
         PictureControlSet_t                    *picture_control_set_ptr,
@@ -3859,6 +3859,208 @@ static void build_intra_predictors(
         pred[mode][tx_size](dst, dst_stride, above_row, left_col);
     }
 }
+/**************************************
+ * Extends the reference samples of the block once for all the modes: the
+ * left column down to the bottom-left and the above row up to the
+ * above-right, i.e. the most any mode needs. The modes needing fewer
+ * pixels see the same first pixels as with build_intra_predictors().
+ **************************************/
+static void intra_edge_cache_build(
+    IntraEdgeCache_t *edge_cache_ptr,
+    const MacroBlockD *xd,
+    const uint8_t *above_ref, const uint8_t *left_ref,
+    int32_t txwpx, int32_t txhpx,
+    int32_t n_top_px, int32_t n_topright_px,
+    int32_t n_left_px, int32_t n_bottomleft_px,
+    int32_t plane)
+{
+    uint8_t *const above_row = edge_cache_ptr->above_data + 16;
+    uint8_t *const left_col = edge_cache_ptr->left_data + 16;
+    const int32_t num_pixels = txwpx + txhpx;
+    int32_t i = 0;
+
+    if (n_left_px > 0) {
+        for (; i < n_left_px; i++) left_col[i] = left_ref[i];
+        if (n_bottomleft_px > 0) {
+            assert(i == txhpx);
+            for (; i < txhpx + n_bottomleft_px; i++) left_col[i] = left_ref[i];
+        }
+        if (i < num_pixels)
+            memset(&left_col[i], left_col[i - 1], num_pixels - i);
+    }
+    else
+        memset(left_col, (n_top_px > 0) ? above_ref[0] : 129, num_pixels);
+
+    if (n_top_px > 0) {
+        memcpy(above_row, above_ref, n_top_px);
+        i = n_top_px;
+        if (n_topright_px > 0) {
+            assert(n_top_px == txwpx);
+            memcpy(above_row + txwpx, above_ref + txwpx, n_topright_px);
+            i += n_topright_px;
+        }
+        if (i < num_pixels)
+            memset(&above_row[i], above_row[i - 1], num_pixels - i);
+    }
+    else
+        memset(above_row, (n_left_px > 0) ? left_ref[0] : 127, num_pixels);
+
+    if (n_top_px > 0 && n_left_px > 0)
+        above_row[-1] = above_ref[-1];
+    else if (n_top_px > 0)
+        above_row[-1] = above_ref[0];
+    else if (n_left_px > 0)
+        above_row[-1] = left_ref[0];
+    else
+        above_row[-1] = 128;
+    left_col[-1] = above_row[-1];
+
+    edge_cache_ptr->filt_type = get_filt_type(xd, plane);
+    edge_cache_ptr->variant_count = 0;
+    edge_cache_ptr->valid = EB_TRUE;
+}
+
+/**************************************
+ * Same predictions as build_intra_predictors() (no filter intra), from the
+ * edges of the intra edge cache. The directional modes sharing the same
+ * edge processing (corner filter, filter strengths, upsampling) share the
+ * processed edges.
+ **************************************/
+static void build_intra_predictors_cached(
+    IntraEdgeCache_t *edge_cache_ptr,
+    const MacroBlockD *xd,
+    const uint8_t *above_ref, const uint8_t *left_ref,
+    uint8_t *dst, int32_t dst_stride,
+    PredictionMode mode, int32_t angle_delta,
+    TxSize tx_size, int32_t disable_edge_filter,
+    int32_t n_top_px, int32_t n_topright_px,
+    int32_t n_left_px, int32_t n_bottomleft_px,
+    int32_t plane)
+{
+    DECLARE_ALIGNED(16, uint8_t, left_data[MAX_TX_SIZE * 2 + 32]);
+    DECLARE_ALIGNED(16, uint8_t, above_data[MAX_TX_SIZE * 2 + 32]);
+    const uint8_t *above_row = edge_cache_ptr->above_data + 16;
+    const uint8_t *left_col = edge_cache_ptr->left_data + 16;
+    const int32_t txwpx = tx_size_wide[tx_size];
+    const int32_t txhpx = tx_size_high[tx_size];
+    int32_t need_left = extend_modes[mode] & NEED_LEFT;
+    int32_t need_above = extend_modes[mode] & NEED_ABOVE;
+    int32_t p_angle = 0;
+    const int32_t is_dr_mode = av1_is_directional_mode(mode);
+    int32_t i;
+
+    if (is_dr_mode) {
+        p_angle = mode_to_angle_map[mode] + angle_delta * ANGLE_STEP;
+        need_above = p_angle < 180;
+        need_left = p_angle > 90;
+    }
+
+    if ((!need_above && n_left_px == 0) || (!need_left && n_top_px == 0)) {
+        int32_t val;
+        if (need_left)
+            val = (n_top_px > 0) ? above_ref[0] : 129;
+        else
+            val = (n_left_px > 0) ? left_ref[0] : 127;
+        for (i = 0; i < txhpx; ++i) {
+            memset(dst, val, txwpx);
+            dst += dst_stride;
+        }
+        return;
+    }
+
+    if (!edge_cache_ptr->valid) {
+        intra_edge_cache_build(
+            edge_cache_ptr,
+            xd,
+            above_ref, left_ref,
+            txwpx, txhpx,
+            n_top_px, n_topright_px,
+            n_left_px, n_bottomleft_px,
+            plane);
+    }
+
+    if (!is_dr_mode) {
+        if (mode == DC_PRED) {
+            dc_pred[n_left_px > 0][n_top_px > 0][tx_size](dst, dst_stride, above_row,
+                left_col);
+        }
+        else {
+            pred[mode][tx_size](dst, dst_stride, above_row, left_col);
+        }
+        return;
+    }
+
+    int32_t upsample_above = 0;
+    int32_t upsample_left = 0;
+    if (!disable_edge_filter) {
+        const int32_t need_right = p_angle < 90;
+        const int32_t need_bottom = p_angle > 180;
+        const int32_t filt_type = edge_cache_ptr->filt_type;
+        int32_t corner = 0;
+        int32_t strength_above = 0;
+        int32_t strength_left = 0;
+
+        if (p_angle != 90 && p_angle != 180) {
+            corner = need_above && need_left && (txwpx + txhpx >= 24);
+            if (need_above && n_top_px > 0)
+                strength_above = intra_edge_filter_strength(txwpx, txhpx, p_angle - 90, filt_type);
+            if (need_left && n_left_px > 0)
+                strength_left = intra_edge_filter_strength(txhpx, txwpx, p_angle - 180, filt_type);
+        }
+        upsample_above = use_intra_edge_upsample(txwpx, txhpx, p_angle - 90, filt_type);
+        upsample_left = use_intra_edge_upsample(txhpx, txwpx, p_angle - 180, filt_type);
+        const int32_t process_above = need_above && upsample_above;
+        const int32_t process_left = need_left && upsample_left;
+
+        if (corner || strength_above || strength_left || process_above || process_left) {
+            const uint32_t key = 1 | (corner << 1) | (need_right << 2) | (need_bottom << 3) |
+                (strength_above << 4) | (strength_left << 6) | (process_above << 8) | (process_left << 9);
+            IntraEdgeVariant_t *variant_ptr = (IntraEdgeVariant_t*)EB_NULL;
+            uint8_t *above_data_ptr = above_data;
+            uint8_t *left_data_ptr = left_data;
+
+            for (i = 0; i < (int32_t)edge_cache_ptr->variant_count; ++i) {
+                if (edge_cache_ptr->variants[i].key == key) {
+                    variant_ptr = &edge_cache_ptr->variants[i];
+                    break;
+                }
+            }
+
+            if (variant_ptr) {
+                above_data_ptr = variant_ptr->above_data;
+                left_data_ptr = variant_ptr->left_data;
+            }
+            else {
+                // Filtered on the stack once the cache is full
+                if (edge_cache_ptr->variant_count < INTRA_EDGE_VARIANT_COUNT) {
+                    variant_ptr = &edge_cache_ptr->variants[edge_cache_ptr->variant_count++];
+                    variant_ptr->key = key;
+                    above_data_ptr = variant_ptr->above_data;
+                    left_data_ptr = variant_ptr->left_data;
+                }
+                memcpy(above_data_ptr, edge_cache_ptr->above_data, sizeof(edge_cache_ptr->above_data));
+                memcpy(left_data_ptr, edge_cache_ptr->left_data, sizeof(edge_cache_ptr->left_data));
+
+                uint8_t *const above_edge = above_data_ptr + 16;
+                uint8_t *const left_edge = left_data_ptr + 16;
+                if (corner)
+                    filter_intra_edge_corner(above_edge, left_edge);
+                if (strength_above)
+                    av1_filter_intra_edge(above_edge - 1, n_top_px + 1 + (need_right ? txhpx : 0), strength_above);
+                if (strength_left)
+                    av1_filter_intra_edge(left_edge - 1, n_left_px + 1 + (need_bottom ? txwpx : 0), strength_left);
+                if (process_above)
+                    av1_upsample_intra_edge(above_edge, txwpx + (need_right ? txhpx : 0));
+                if (process_left)
+                    av1_upsample_intra_edge(left_edge, txhpx + (need_bottom ? txwpx : 0));
+            }
+            above_row = above_data_ptr + 16;
+            left_col = left_data_ptr + 16;
+        }
+    }
+    dr_predictor(dst, dst_stride, tx_size, above_row, left_col, upsample_above,
+        upsample_left, p_angle);
+}
 static void build_intra_predictors_high(
     const MacroBlockD *xd,
     uint16_t* topNeighArray, // int8_t
@@ -4098,7 +4300,8 @@ extern void av1_predict_intra_block(
     uint32_t bl_org_x_pict,
     uint32_t bl_org_y_pict,
     uint32_t bl_org_x_mb,
-    uint32_t bl_org_y_mb)
+    uint32_t bl_org_y_mb,
+    IntraEdgeCache_t *edge_cache_ptr)
 {
     (void)use_palette;
     MacroBlockD xdS;
@@ -4318,6 +4521,22 @@ extern void av1_predict_intra_block(
     //  return;
     //}
 
+    if (edge_cache_ptr && filter_intra_mode == FILTER_INTRA_MODES) {
+        build_intra_predictors_cached(
+            edge_cache_ptr,
+            xd,
+            topNeighArray,
+            leftNeighArray,
+            dst, dst_stride, mode,
+            angle_delta, tx_size,
+            disable_edge_filter,
+            have_top ? AOMMIN(txwpx, xr + txwpx) : 0,
+            have_top_right ? AOMMIN(txwpx, xr) : 0,
+            have_left ? AOMMIN(txhpx, yd + txhpx) : 0,
+            have_bottom_left ? AOMMIN(txhpx, yd) : 0, plane);
+        return;
+    }
+
     build_intra_predictors(
         xd,
 
@@ -4336,7 +4555,8 @@ extern void av1_predict_intra_block(
 void av1_predict_intra_block_16bit(
     TileInfo * tile,
 
-    EncDecContext_t         *context_ptr,
+    STAGE       stage,
+    const BlockGeom            * blk_geom,
     const Av1Common *cm,
     int32_t wpx,
     int32_t hpx,
@@ -4354,7 +4574,9 @@ void av1_predict_intra_block_16bit(
 
     block_size bsize,
     uint32_t bl_org_x_pict,
-    uint32_t bl_org_y_pict)
+    uint32_t bl_org_y_pict,
+    uint32_t bl_org_x_mb,
+    uint32_t bl_org_y_mb)
 {
     (void)use_palette;
     MacroBlockD xdS;
@@ -4363,8 +4585,14 @@ void av1_predict_intra_block_16bit(
     uint32_t  pred_buf_x_offest;
     uint32_t  pred_buf_y_offest;
 
-    pred_buf_x_offest = plane ? ((bl_org_x_pict >> 3) << 3) >> 1 : bl_org_x_pict;
-    pred_buf_y_offest = plane ? ((bl_org_y_pict >> 3) << 3) >> 1 : bl_org_y_pict;
+    if (stage == ED_STAGE) { // EncDec
+        pred_buf_x_offest = plane ? ((bl_org_x_pict >> 3) << 3) >> 1 : bl_org_x_pict;
+        pred_buf_y_offest = plane ? ((bl_org_y_pict >> 3) << 3) >> 1 : bl_org_y_pict;
+    }
+    else { // MD
+        pred_buf_x_offest = bl_org_x_mb;
+        pred_buf_y_offest = bl_org_y_mb;
+    }
 
     int32_t mirow = bl_org_y_pict >> 2;
     int32_t micol = bl_org_x_pict >> 2;
@@ -4537,7 +4765,7 @@ void av1_predict_intra_block_16bit(
         (yd > 0) &&
         (mi_row + ((row_off + txh) << pd->subsampling_y) < xd->tile.mi_row_end);
 
-    const PartitionType partition = from_shape_to_part[context_ptr->blk_geom->shape]; //cu_ptr->part;// PARTITION_NONE;//CHKN this is good enough as the avail functions need to know if VERT part is used or not mbmi->partition;
+    const PartitionType partition = from_shape_to_part[blk_geom->shape]; //cu_ptr->part;// PARTITION_NONE;//CHKN this is good enough as the avail functions need to know if VERT part is used or not mbmi->partition;
 
     // force 4x4 chroma component block size.
     bsize = scale_chroma_bsize(bsize, pd->subsampling_x, pd->subsampling_y);
@@ -4626,51 +4854,99 @@ EbErrorType AV1IntraPredictionCL(
         (uint32_t)md_context_ptr->intra_chroma_mode_neighbor_array->topArray[intraChromaModeTopNeighborIndex]);       //   use DC. This seems like we could use a LCU-width
     TxSize  tx_size = md_context_ptr->blk_geom->txsize[0]; // Nader - Intra 128x128 not supported
     TxSize  tx_size_Chroma = md_context_ptr->blk_geom->txsize_uv[0]; //Nader - Intra 128x128 not supported
-    uint8_t    topNeighArray[64 * 2 + 1];
-    uint8_t    leftNeighArray[64 * 2 + 1];
     PredictionMode mode;
     uint8_t end_plane = (md_context_ptr->blk_geom->has_uv && md_context_ptr->chroma_level == CHROMA_MODE_0) ? (int) MAX_MB_PLANE : 1;
     for (int32_t plane = 0; plane < end_plane; ++plane) {
+        if (plane)
+            mode = (candidate_buffer_ptr->candidate_ptr->intra_chroma_mode == UV_CFL_PRED) ? (PredictionMode) UV_DC_PRED : (PredictionMode) candidate_buffer_ptr->candidate_ptr->intra_chroma_mode;
+        else
+            mode = candidate_buffer_ptr->candidate_ptr->pred_mode;
 
-        if (plane == 0) {
-            if (md_context_ptr->cu_origin_y != 0)
-                memcpy(topNeighArray + 1, md_context_ptr->luma_recon_neighbor_array->topArray + md_context_ptr->cu_origin_x, md_context_ptr->blk_geom->bwidth * 2);
-            if (md_context_ptr->cu_origin_x != 0)
-                memcpy(leftNeighArray + 1, md_context_ptr->luma_recon_neighbor_array->leftArray + md_context_ptr->cu_origin_y, md_context_ptr->blk_geom->bheight * 2);
-            if (md_context_ptr->cu_origin_y != 0 && md_context_ptr->cu_origin_x != 0)
-                topNeighArray[0] = leftNeighArray[0] = md_context_ptr->luma_recon_neighbor_array->topLeftArray[MAX_PICTURE_HEIGHT_SIZE + md_context_ptr->cu_origin_x - md_context_ptr->cu_origin_y];
+        if (md_context_ptr->hbd_mode_decision) {
+            // 16bit recon neighbors, predicted without the edge cache
+            uint16_t topNeighArray16[64 * 2 + 1];
+            uint16_t leftNeighArray16[64 * 2 + 1];
+            NeighborArrayUnit_t *recon_neighbor_array = plane == 0 ? md_context_ptr->luma_recon_neighbor_array :
+                plane == 1 ? md_context_ptr->cb_recon_neighbor_array : md_context_ptr->cr_recon_neighbor_array;
+            uint32_t origin_x = plane ? md_context_ptr->round_origin_x / 2 : md_context_ptr->cu_origin_x;
+            uint32_t origin_y = plane ? md_context_ptr->round_origin_y / 2 : md_context_ptr->cu_origin_y;
+            uint32_t bwidth = plane ? md_context_ptr->blk_geom->bwidth_uv : md_context_ptr->blk_geom->bwidth;
+            uint32_t bheight = plane ? md_context_ptr->blk_geom->bheight_uv : md_context_ptr->blk_geom->bheight;
+
+            if (origin_y != 0)
+                memcpy(topNeighArray16 + 1, (uint16_t*)(recon_neighbor_array->topArray) + origin_x, bwidth * 2 * sizeof(uint16_t));
+            if (origin_x != 0)
+                memcpy(leftNeighArray16 + 1, (uint16_t*)(recon_neighbor_array->leftArray) + origin_y, bheight * 2 * sizeof(uint16_t));
+            if (origin_y != 0 && origin_x != 0)
+                topNeighArray16[0] = leftNeighArray16[0] = ((uint16_t*)(recon_neighbor_array->topLeftArray) + (plane ? MAX_PICTURE_HEIGHT_SIZE / 2 : MAX_PICTURE_HEIGHT_SIZE) + origin_x - origin_y)[0];
+
+            av1_predict_intra_block_16bit(
+                &md_context_ptr->sb_ptr->tile_info,
+                MD_STAGE,
+                md_context_ptr->blk_geom,
+                picture_control_set_ptr->parent_pcs_ptr->av1_cm,
+                bwidth,
+                bheight,
+                plane ? tx_size_Chroma : tx_size,
+                mode,
+                plane ? 0 : candidate_buffer_ptr->candidate_ptr->angle_delta[PLANE_TYPE_Y],
+                0,
+                FILTER_INTRA_MODES,
+                topNeighArray16 + 1,
+                leftNeighArray16 + 1,
+                candidate_buffer_ptr->prediction_ptr,
+                0,
+                0,
+                plane,
+                md_context_ptr->blk_geom->bsize,
+                md_context_ptr->cu_origin_x,
+                md_context_ptr->cu_origin_y,
+                plane ? ((md_context_ptr->blk_geom->origin_x >> 3) << 3) / 2 : md_context_ptr->blk_geom->origin_x,
+                plane ? ((md_context_ptr->blk_geom->origin_y >> 3) << 3) / 2 : md_context_ptr->blk_geom->origin_y);
+            continue;
         }
 
-        else if (plane == 1) {
-            if (md_context_ptr->round_origin_y != 0)
-                memcpy(topNeighArray + 1, md_context_ptr->cb_recon_neighbor_array->topArray + md_context_ptr->round_origin_x / 2, md_context_ptr->blk_geom->bwidth_uv * 2);
+        // The reference samples are the same for all the intra candidates of the block
+        IntraEdgeCache_t *edge_cache_ptr = &md_context_ptr->intra_edge_cache[plane];
+        uint8_t *topNeighArray = edge_cache_ptr->top_neigh_array;
+        uint8_t *leftNeighArray = edge_cache_ptr->left_neigh_array;
+
+        if (!edge_cache_ptr->valid) {
+            if (plane == 0) {
+                if (md_context_ptr->cu_origin_y != 0)
+                    memcpy(topNeighArray + 1, md_context_ptr->luma_recon_neighbor_array->topArray + md_context_ptr->cu_origin_x, md_context_ptr->blk_geom->bwidth * 2);
+                if (md_context_ptr->cu_origin_x != 0)
+                    memcpy(leftNeighArray + 1, md_context_ptr->luma_recon_neighbor_array->leftArray + md_context_ptr->cu_origin_y, md_context_ptr->blk_geom->bheight * 2);
+                if (md_context_ptr->cu_origin_y != 0 && md_context_ptr->cu_origin_x != 0)
+                    topNeighArray[0] = leftNeighArray[0] = md_context_ptr->luma_recon_neighbor_array->topLeftArray[MAX_PICTURE_HEIGHT_SIZE + md_context_ptr->cu_origin_x - md_context_ptr->cu_origin_y];
+            }
 
-            if (md_context_ptr->round_origin_x != 0)
+            else if (plane == 1) {
+                if (md_context_ptr->round_origin_y != 0)
+                    memcpy(topNeighArray + 1, md_context_ptr->cb_recon_neighbor_array->topArray + md_context_ptr->round_origin_x / 2, md_context_ptr->blk_geom->bwidth_uv * 2);
 
-                memcpy(leftNeighArray + 1, md_context_ptr->cb_recon_neighbor_array->leftArray + md_context_ptr->round_origin_y / 2, md_context_ptr->blk_geom->bheight_uv * 2);
+                if (md_context_ptr->round_origin_x != 0)
 
-            if (md_context_ptr->round_origin_y != 0 && md_context_ptr->round_origin_x != 0)
-                topNeighArray[0] = leftNeighArray[0] = md_context_ptr->cb_recon_neighbor_array->topLeftArray[MAX_PICTURE_HEIGHT_SIZE / 2 + md_context_ptr->round_origin_x / 2 - md_context_ptr->round_origin_y / 2];
-        }
-        else {
-            if (md_context_ptr->round_origin_y != 0)
+                    memcpy(leftNeighArray + 1, md_context_ptr->cb_recon_neighbor_array->leftArray + md_context_ptr->round_origin_y / 2, md_context_ptr->blk_geom->bheight_uv * 2);
 
-                memcpy(topNeighArray + 1, md_context_ptr->cr_recon_neighbor_array->topArray + md_context_ptr->round_origin_x / 2, md_context_ptr->blk_geom->bwidth_uv * 2);
+                if (md_context_ptr->round_origin_y != 0 && md_context_ptr->round_origin_x != 0)
+                    topNeighArray[0] = leftNeighArray[0] = md_context_ptr->cb_recon_neighbor_array->topLeftArray[MAX_PICTURE_HEIGHT_SIZE / 2 + md_context_ptr->round_origin_x / 2 - md_context_ptr->round_origin_y / 2];
+            }
+            else {
+                if (md_context_ptr->round_origin_y != 0)
 
-            if (md_context_ptr->round_origin_x != 0)
+                    memcpy(topNeighArray + 1, md_context_ptr->cr_recon_neighbor_array->topArray + md_context_ptr->round_origin_x / 2, md_context_ptr->blk_geom->bwidth_uv * 2);
 
-                memcpy(leftNeighArray + 1, md_context_ptr->cr_recon_neighbor_array->leftArray + md_context_ptr->round_origin_y / 2, md_context_ptr->blk_geom->bheight_uv * 2);
+                if (md_context_ptr->round_origin_x != 0)
 
-            if (md_context_ptr->round_origin_y != 0 && md_context_ptr->round_origin_x != 0)
-                topNeighArray[0] = leftNeighArray[0] = md_context_ptr->cr_recon_neighbor_array->topLeftArray[MAX_PICTURE_HEIGHT_SIZE / 2 + md_context_ptr->round_origin_x / 2 - md_context_ptr->round_origin_y / 2];
+                    memcpy(leftNeighArray + 1, md_context_ptr->cr_recon_neighbor_array->leftArray + md_context_ptr->round_origin_y / 2, md_context_ptr->blk_geom->bheight_uv * 2);
 
+                if (md_context_ptr->round_origin_y != 0 && md_context_ptr->round_origin_x != 0)
+                    topNeighArray[0] = leftNeighArray[0] = md_context_ptr->cr_recon_neighbor_array->topLeftArray[MAX_PICTURE_HEIGHT_SIZE / 2 + md_context_ptr->round_origin_x / 2 - md_context_ptr->round_origin_y / 2];
 
-        }
 
-        if (plane)
-            mode = (candidate_buffer_ptr->candidate_ptr->intra_chroma_mode == UV_CFL_PRED) ? (PredictionMode) UV_DC_PRED : (PredictionMode) candidate_buffer_ptr->candidate_ptr->intra_chroma_mode;
-        else
-            mode = candidate_buffer_ptr->candidate_ptr->pred_mode;
+            }
+        }
 
         av1_predict_intra_block(
             &md_context_ptr->sb_ptr->tile_info, 
@@ -4696,7 +4972,8 @@ EbErrorType AV1IntraPredictionCL(
             md_context_ptr->cu_origin_x,                  //uint32_t cuOrgX,
             md_context_ptr->cu_origin_y,                  //uint32_t cuOrgY
             plane ? ((md_context_ptr->blk_geom->origin_x >> 3) << 3) / 2 : md_context_ptr->blk_geom->origin_x,  //uint32_t cuOrgX used only for prediction Ptr
-            plane ? ((md_context_ptr->blk_geom->origin_y >> 3) << 3) / 2 : md_context_ptr->blk_geom->origin_y   //uint32_t cuOrgY used only for prediction Ptr
+            plane ? ((md_context_ptr->blk_geom->origin_y >> 3) << 3) / 2 : md_context_ptr->blk_geom->origin_y,  //uint32_t cuOrgY used only for prediction Ptr
+            edge_cache_ptr
         );
     }
 
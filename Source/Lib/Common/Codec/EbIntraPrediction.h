@@ -122,6 +122,32 @@ extern "C" {
 #define SMOOTHING_THRESHOLD_10BIT          32
 
 
+#define INTRA_EDGE_VARIANT_COUNT           16
+
+    typedef struct IntraEdgeVariant_s {
+        uint32_t                  key;
+        DECLARE_ALIGNED(16, uint8_t, above_data[MAX_TX_SIZE * 2 + 32]);
+        DECLARE_ALIGNED(16, uint8_t, left_data[MAX_TX_SIZE * 2 + 32]);
+    } IntraEdgeVariant_t;
+
+    /**************************************
+     * Intra Edge Cache
+     *   Reference samples of the block in MD, shared by all its intra
+     *   candidates: the edges are extended once for all the modes and the
+     *   filtered / upsampled edges of the directional modes are built on
+     *   first use. Invalidated at the start of each block.
+     **************************************/
+    typedef struct IntraEdgeCache_s {
+        EbBool                    valid;
+        uint8_t                   top_neigh_array[64 * 2 + 1];
+        uint8_t                   left_neigh_array[64 * 2 + 1];
+        int32_t                   filt_type;
+        DECLARE_ALIGNED(16, uint8_t, above_data[MAX_TX_SIZE * 2 + 32]);
+        DECLARE_ALIGNED(16, uint8_t, left_data[MAX_TX_SIZE * 2 + 32]);
+        uint32_t                  variant_count;
+        IntraEdgeVariant_t        variants[INTRA_EDGE_VARIANT_COUNT];
+    } IntraEdgeCache_t;
+
     extern EbErrorType AV1IntraPredictionCL(
         struct ModeDecisionContext_s           *context_ptr,
         PictureControlSet_t                    *picture_control_set_ptr,
@@ -316,3 +316,52 @@ void pad_input_picture(
     return;
 }
 
+/** pad_input_picture16bit()
+is the 16 bit version of pad_input_picture(), the stride and sizes are in samples.
+*/
+void pad_input_picture16bit(
+    uint16_t *src_pic,                //output paramter, pointer to the source picture to be padded.
+    uint32_t  src_stride,             //input paramter, the stride of the source picture to be padded.
+    uint32_t  original_src_width,     //input paramter, the width of the source picture which excludes the padding.
+    uint32_t  original_src_height,    //input paramter, the height of the source picture which excludes the padding.
+    uint32_t  pad_right,              //input paramter, the padding right.
+    uint32_t  pad_bottom)             //input paramter, the padding bottom.
+{
+    uint32_t   verticalIdx;
+    uint32_t   horizontalIdx;
+    uint16_t  *tempSrcPic0;
+    uint16_t  *tempSrcPic1;
+
+    if (pad_right) {
+
+        // Add padding @ the right
+        verticalIdx = original_src_height;
+        tempSrcPic0 = src_pic;
+
+        while (verticalIdx)
+        {
+            for (horizontalIdx = 0; horizontalIdx < pad_right; ++horizontalIdx)
+                tempSrcPic0[original_src_width + horizontalIdx] = tempSrcPic0[original_src_width - 1];
+            tempSrcPic0 += src_stride;
+            --verticalIdx;
+        }
+    }
+
+    if (pad_bottom) {
+
+        // Add padding @ the bottom
+        verticalIdx = pad_bottom;
+        tempSrcPic0 = src_pic + (original_src_height - 1) * src_stride;
+        tempSrcPic1 = tempSrcPic0;
+
+        while (verticalIdx)
+        {
+            tempSrcPic1 += src_stride;
+            EB_MEMCPY(tempSrcPic1, tempSrcPic0, sizeof(uint16_t)* (original_src_width + pad_right));
+            --verticalIdx;
+        }
+    }
+
+    return;
+}
+
@@ -132,6 +132,14 @@ extern "C" {
         uint32_t            pad_right,
         uint32_t            pad_bottom);
 
+    extern void pad_input_picture16bit(
+        uint16_t           *src_pic,
+        uint32_t            src_stride,
+        uint32_t            original_src_width,
+        uint32_t            original_src_height,
+        uint32_t            pad_right,
+        uint32_t            pad_bottom);
+
     // Function Tables (Super-long, declared in EbMcpTables.c)
     extern const InterpolationFilterNew     uniPredLumaIFFunctionPtrArrayNew[ASM_TYPE_TOTAL][16];
     extern const InterpolationFilterOutRaw  biPredLumaIFFunctionPtrArrayNew[ASM_TYPE_TOTAL][16];
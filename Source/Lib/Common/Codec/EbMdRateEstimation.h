@@ -31,7 +31,7 @@ extern "C" {
         int32_t eob_cost[2][11];
     } LV_MAP_EOB_COST;
 
-    typedef struct {
+    typedef struct LV_MAP_COEFF_COST {
         int32_t txb_skip_cost[TXB_SKIP_CONTEXTS][2];
         int32_t base_eob_cost[SIG_COEF_CONTEXTS_EOB][3];
         int32_t base_cost[SIG_COEF_CONTEXTS][4];
@@ -132,7 +132,8 @@ EbErrorType mode_decision_candidate_buffer_ctor(
     uint64_t                       *fast_cost_ptr,
     uint64_t                       *full_cost_ptr,
     uint64_t                       *full_cost_skip_ptr,
-    uint64_t                       *full_cost_merge_ptr)
+    uint64_t                       *full_cost_merge_ptr,
+    EbBool                          hbd_mode_decision)
 {
     EbPictureBufferDescInitData_t pictureBufferDescInitData;
     EbPictureBufferDescInitData_t doubleWidthPictureBufferDescInitData;
@@ -149,7 +150,7 @@ EbErrorType mode_decision_candidate_buffer_ctor(
     // Init Picture Data
     pictureBufferDescInitData.maxWidth = MAX_SB_SIZE;
     pictureBufferDescInitData.maxHeight = MAX_SB_SIZE;
-    pictureBufferDescInitData.bit_depth = EB_8BIT;
+    pictureBufferDescInitData.bit_depth = hbd_mode_decision ? EB_16BIT : EB_8BIT;
     pictureBufferDescInitData.color_format = EB_YUV420;
     pictureBufferDescInitData.bufferEnableMask = PICTURE_BUFFER_DESC_FULL_MASK;
     pictureBufferDescInitData.left_padding = 0;
@@ -267,6 +268,107 @@ void RoundMv(
 
 }
 
+/***************************************
+* Injected MV set
+***************************************/
+#define UNI_PRED_MV_KEY(mv_x, mv_y) \
+    (((uint64_t)(uint16_t)(mv_x) << 16) | (uint16_t)(mv_y))
+#define BI_PRED_MV_KEY(mv_x_l0, mv_y_l0, mv_x_l1, mv_y_l1) \
+    ((UNI_PRED_MV_KEY(mv_x_l0, mv_y_l0) << 32) | UNI_PRED_MV_KEY(mv_x_l1, mv_y_l1))
+
+static INLINE void injected_mv_set_init(
+    InjectedMvSet_t *set) {
+
+    memset(set->stamp, 0, sizeof(set->stamp));
+    set->current_stamp = 1;
+}
+
+static INLINE void injected_mv_set_reset(
+    InjectedMvSet_t *set) {
+
+    // Stamps only need clearing once every 65535 blocks
+    if (++set->current_stamp == 0)
+        injected_mv_set_init(set);
+}
+
+static INLINE uint32_t injected_mv_set_slot(
+    uint64_t key) {
+
+    return (uint32_t)((key * 0x9E3779B97F4A7C15ULL) >> (64 - INJECTED_MV_SET_BITS));
+}
+
+static INLINE EbBool injected_mv_set_find(
+    const InjectedMvSet_t *set,
+    uint64_t               key) {
+
+    uint32_t slot = injected_mv_set_slot(key);
+    for (uint32_t probe = 0; probe < INJECTED_MV_SET_SIZE; probe++) {
+        if (set->stamp[slot] != set->current_stamp)
+            return(EB_FALSE);
+        if (set->key[slot] == key)
+            return(EB_TRUE);
+        slot = (slot + 1) & (INJECTED_MV_SET_SIZE - 1);
+    }
+    return(EB_FALSE);
+}
+
+static INLINE void injected_mv_set_insert(
+    InjectedMvSet_t *set,
+    uint64_t         key) {
+
+    uint32_t slot = injected_mv_set_slot(key);
+    for (uint32_t probe = 0; probe < INJECTED_MV_SET_SIZE; probe++) {
+        if (set->stamp[slot] != set->current_stamp) {
+            set->stamp[slot] = set->current_stamp;
+            set->key[slot] = key;
+            return;
+        }
+        if (set->key[slot] == key)
+            return;
+        slot = (slot + 1) & (INJECTED_MV_SET_SIZE - 1);
+    }
+}
+
+static void reset_injected_mvs(
+    ModeDecisionContext_t *context_ptr) {
+
+    context_ptr->injected_mv_count_l0 = 0;
+    context_ptr->injected_mv_count_l1 = 0;
+    context_ptr->injected_mv_count_bipred = 0;
+    injected_mv_set_reset(&context_ptr->injected_mv_set_l0);
+    injected_mv_set_reset(&context_ptr->injected_mv_set_l1);
+    injected_mv_set_reset(&context_ptr->injected_mv_set_bipred);
+}
+
+static INLINE void add_injected_mv_l0(
+    ModeDecisionContext_t *context_ptr,
+    int16_t                mv_x,
+    int16_t                mv_y) {
+
+    injected_mv_set_insert(&context_ptr->injected_mv_set_l0, UNI_PRED_MV_KEY(mv_x, mv_y));
+    ++context_ptr->injected_mv_count_l0;
+}
+
+static INLINE void add_injected_mv_l1(
+    ModeDecisionContext_t *context_ptr,
+    int16_t                mv_x,
+    int16_t                mv_y) {
+
+    injected_mv_set_insert(&context_ptr->injected_mv_set_l1, UNI_PRED_MV_KEY(mv_x, mv_y));
+    ++context_ptr->injected_mv_count_l1;
+}
+
+static INLINE void add_injected_mv_bipred(
+    ModeDecisionContext_t *context_ptr,
+    int16_t                mv_x_l0,
+    int16_t                mv_y_l0,
+    int16_t                mv_x_l1,
+    int16_t                mv_y_l1) {
+
+    injected_mv_set_insert(&context_ptr->injected_mv_set_bipred, BI_PRED_MV_KEY(mv_x_l0, mv_y_l0, mv_x_l1, mv_y_l1));
+    ++context_ptr->injected_mv_count_bipred;
+}
+
 /***************************************
 * return true if the MV candidate is already injected
 ***************************************/
@@ -275,14 +377,7 @@ EbBool is_already_injected_mv_l0(
     int16_t                mv_x,
     int16_t                mv_y) {
 
-    for (int inter_candidate_index = 0; inter_candidate_index < context_ptr->injected_mv_count_l0; inter_candidate_index++) {
-        if (context_ptr->injected_mv_x_l0_array[inter_candidate_index] == mv_x &&
-            context_ptr->injected_mv_y_l0_array[inter_candidate_index] == mv_y) {
-            return(EB_TRUE);
-        }
-    }
-
-    return(EB_FALSE);
+    return injected_mv_set_find(&context_ptr->injected_mv_set_l0, UNI_PRED_MV_KEY(mv_x, mv_y));
 }
 
 EbBool is_already_injected_mv_l1(
@@ -290,14 +385,7 @@ EbBool is_already_injected_mv_l1(
     int16_t                mv_x,
     int16_t                mv_y) {
 
-    for (int inter_candidate_index = 0; inter_candidate_index < context_ptr->injected_mv_count_l1; inter_candidate_index++) {
-        if (context_ptr->injected_mv_x_l1_array[inter_candidate_index] == mv_x &&
-            context_ptr->injected_mv_y_l1_array[inter_candidate_index] == mv_y) {
-            return(EB_TRUE);
-        }
-    }
-
-    return(EB_FALSE);
+    return injected_mv_set_find(&context_ptr->injected_mv_set_l1, UNI_PRED_MV_KEY(mv_x, mv_y));
 }
 
 EbBool is_already_injected_mv_bipred(
@@ -307,15 +395,7 @@ EbBool is_already_injected_mv_bipred(
     int16_t                mv_x_l1,
     int16_t                mv_y_l1) {
 
-    for (int inter_candidate_index = 0; inter_candidate_index < context_ptr->injected_mv_count_bipred; inter_candidate_index++) {
-        if (context_ptr->injected_mv_x_bipred_l0_array[inter_candidate_index] == mv_x_l0 &&
-            context_ptr->injected_mv_y_bipred_l0_array[inter_candidate_index] == mv_y_l0 &&
-            context_ptr->injected_mv_x_bipred_l1_array[inter_candidate_index] == mv_x_l1 &&
-            context_ptr->injected_mv_y_bipred_l1_array[inter_candidate_index] == mv_y_l1) {
-            return(EB_TRUE);
-        }
-    }
-    return(EB_FALSE);
+    return injected_mv_set_find(&context_ptr->injected_mv_set_bipred, BI_PRED_MV_KEY(mv_x_l0, mv_y_l0, mv_x_l1, mv_y_l1));
 }
 
 
@@ -571,9 +651,7 @@ void Unipred3x3CandidatesInjection(
             candidateArray[canTotalCnt].motion_vector_pred_y[REF_LIST_0] = bestPredmv[0].as_mv.row;
 
             ++canTotalCnt;
-            context_ptr->injected_mv_x_l0_array[context_ptr->injected_mv_count_l0] = to_inject_mv_x;
-            context_ptr->injected_mv_y_l0_array[context_ptr->injected_mv_count_l0] = to_inject_mv_y;
-            ++context_ptr->injected_mv_count_l0;
+            add_injected_mv_l0(context_ptr, to_inject_mv_x, to_inject_mv_y);
         }
     }
     // (8 Best_L1 neighbors)
@@ -633,9 +711,7 @@ void Unipred3x3CandidatesInjection(
                 candidateArray[canTotalCnt].motion_vector_pred_y[REF_LIST_1] = bestPredmv[0].as_mv.row;
 
                 ++canTotalCnt;
-                context_ptr->injected_mv_x_l1_array[context_ptr->injected_mv_count_l1] = to_inject_mv_x;
-                context_ptr->injected_mv_y_l1_array[context_ptr->injected_mv_count_l1] = to_inject_mv_y;
-                ++context_ptr->injected_mv_count_l1;
+                add_injected_mv_l1(context_ptr, to_inject_mv_x, to_inject_mv_y);
             }
         }
     }
@@ -730,11 +806,7 @@ void Bipred3x3CandidatesInjection(
             candidateArray[canTotalCnt].motion_vector_pred_y[REF_LIST_1] = bestPredmv[1].as_mv.row;
             
             ++canTotalCnt;
-            context_ptr->injected_mv_x_bipred_l0_array[context_ptr->injected_mv_count_bipred] = to_inject_mv_x_l0;
-            context_ptr->injected_mv_y_bipred_l0_array[context_ptr->injected_mv_count_bipred] = to_inject_mv_y_l0;
-            context_ptr->injected_mv_x_bipred_l1_array[context_ptr->injected_mv_count_bipred] = to_inject_mv_x_l1;
-            context_ptr->injected_mv_y_bipred_l1_array[context_ptr->injected_mv_count_bipred] = to_inject_mv_y_l1;
-            ++context_ptr->injected_mv_count_bipred;
+            add_injected_mv_bipred(context_ptr, to_inject_mv_x_l0, to_inject_mv_y_l0, to_inject_mv_x_l1, to_inject_mv_y_l1);
             }
         }
     }
@@ -801,11 +873,7 @@ void Bipred3x3CandidatesInjection(
             candidateArray[canTotalCnt].motion_vector_pred_y[REF_LIST_1] = bestPredmv[1].as_mv.row;
 
             ++canTotalCnt;
-            context_ptr->injected_mv_x_bipred_l0_array[context_ptr->injected_mv_count_bipred] = to_inject_mv_x_l0;
-            context_ptr->injected_mv_y_bipred_l0_array[context_ptr->injected_mv_count_bipred] = to_inject_mv_y_l0;
-            context_ptr->injected_mv_x_bipred_l1_array[context_ptr->injected_mv_count_bipred] = to_inject_mv_x_l1;
-            context_ptr->injected_mv_y_bipred_l1_array[context_ptr->injected_mv_count_bipred] = to_inject_mv_y_l1;
-            ++context_ptr->injected_mv_count_bipred;
+            add_injected_mv_bipred(context_ptr, to_inject_mv_x_l0, to_inject_mv_y_l0, to_inject_mv_x_l1, to_inject_mv_y_l1);
         }
      }
 
@@ -899,9 +967,7 @@ void InjectAv1MvpCandidates(
     candidateArray[canIdx].transform_type[PLANE_TYPE_Y] = DCT_DCT;
     candidateArray[canIdx].transform_type[PLANE_TYPE_UV] = DCT_DCT;
     ++canIdx;
-    context_ptr->injected_mv_x_l0_array[context_ptr->injected_mv_count_l0] = to_inject_mv_x;
-    context_ptr->injected_mv_y_l0_array[context_ptr->injected_mv_count_l0] = to_inject_mv_y;
-    ++context_ptr->injected_mv_count_l0;
+    add_injected_mv_l0(context_ptr, to_inject_mv_x, to_inject_mv_y);
     }
     //NEAR_L0
     maxDrlIndex = GetMaxDrlIndex(xd->ref_mv_count[LAST_FRAME], NEARMV);
@@ -942,9 +1008,7 @@ void InjectAv1MvpCandidates(
         candidateArray[canIdx].transform_type[PLANE_TYPE_Y] = DCT_DCT;
         candidateArray[canIdx].transform_type[PLANE_TYPE_UV] = DCT_DCT;
         ++canIdx;
-        context_ptr->injected_mv_x_l0_array[context_ptr->injected_mv_count_l0] = to_inject_mv_x;
-        context_ptr->injected_mv_y_l0_array[context_ptr->injected_mv_count_l0] = to_inject_mv_y;
-        ++context_ptr->injected_mv_count_l0;
+        add_injected_mv_l0(context_ptr, to_inject_mv_x, to_inject_mv_y);
         }
     }
 
@@ -974,9 +1038,7 @@ void InjectAv1MvpCandidates(
         candidateArray[canIdx].transform_type[PLANE_TYPE_Y] = DCT_DCT;
         candidateArray[canIdx].transform_type[PLANE_TYPE_UV] = DCT_DCT;
         ++canIdx;
-        context_ptr->injected_mv_x_l1_array[context_ptr->injected_mv_count_l1] = to_inject_mv_x;
-        context_ptr->injected_mv_y_l1_array[context_ptr->injected_mv_count_l1] = to_inject_mv_y;
-        ++context_ptr->injected_mv_count_l1;
+        add_injected_mv_l1(context_ptr, to_inject_mv_x, to_inject_mv_y);
     }
         //NEAR_L1
         maxDrlIndex = GetMaxDrlIndex(xd->ref_mv_count[BWDREF_FRAME], NEARMV);
@@ -1016,9 +1078,7 @@ void InjectAv1MvpCandidates(
             candidateArray[canIdx].transform_type[PLANE_TYPE_Y] = DCT_DCT;
             candidateArray[canIdx].transform_type[PLANE_TYPE_UV] = DCT_DCT;
             ++canIdx;
-            context_ptr->injected_mv_x_l1_array[context_ptr->injected_mv_count_l1] = to_inject_mv_x;
-            context_ptr->injected_mv_y_l1_array[context_ptr->injected_mv_count_l1] = to_inject_mv_y;
-            ++context_ptr->injected_mv_count_l1;
+            add_injected_mv_l1(context_ptr, to_inject_mv_x, to_inject_mv_y);
             }
         }
 
@@ -1053,11 +1113,7 @@ void InjectAv1MvpCandidates(
                 candidateArray[canIdx].transform_type[PLANE_TYPE_Y] = DCT_DCT;
                 candidateArray[canIdx].transform_type[PLANE_TYPE_UV] = DCT_DCT;
                 ++canIdx;
-                context_ptr->injected_mv_x_bipred_l0_array[context_ptr->injected_mv_count_bipred] = to_inject_mv_x_l0;
-                context_ptr->injected_mv_y_bipred_l0_array[context_ptr->injected_mv_count_bipred] = to_inject_mv_y_l0;
-                context_ptr->injected_mv_x_bipred_l1_array[context_ptr->injected_mv_count_bipred] = to_inject_mv_x_l1;
-                context_ptr->injected_mv_y_bipred_l1_array[context_ptr->injected_mv_count_bipred] = to_inject_mv_y_l1;
-                ++context_ptr->injected_mv_count_bipred;
+                add_injected_mv_bipred(context_ptr, to_inject_mv_x_l0, to_inject_mv_y_l0, to_inject_mv_x_l1, to_inject_mv_y_l1);
             }
         }
         //NEAR_NEAR
@@ -1104,11 +1160,7 @@ void InjectAv1MvpCandidates(
                 candidateArray[canIdx].transform_type[PLANE_TYPE_Y] = DCT_DCT;
                 candidateArray[canIdx].transform_type[PLANE_TYPE_UV] = DCT_DCT;
                 ++canIdx;
-                context_ptr->injected_mv_x_bipred_l0_array[context_ptr->injected_mv_count_bipred] = to_inject_mv_x_l0;
-                context_ptr->injected_mv_y_bipred_l0_array[context_ptr->injected_mv_count_bipred] = to_inject_mv_y_l0;
-                context_ptr->injected_mv_x_bipred_l1_array[context_ptr->injected_mv_count_bipred] = to_inject_mv_x_l1;
-                context_ptr->injected_mv_y_bipred_l1_array[context_ptr->injected_mv_count_bipred] = to_inject_mv_y_l1;
-                ++context_ptr->injected_mv_count_bipred;
+                add_injected_mv_bipred(context_ptr, to_inject_mv_x_l0, to_inject_mv_y_l0, to_inject_mv_x_l1, to_inject_mv_y_l1);
                 }
             }
         }
@@ -1174,9 +1226,7 @@ void inject_warped_motion_candidates(
 
         if (candidateArray[canIdx].local_warp_valid)
             ++canIdx;
-        context_ptr->injected_mv_x_l0_array[context_ptr->injected_mv_count_l0] = to_inject_mv_x;
-        context_ptr->injected_mv_y_l0_array[context_ptr->injected_mv_count_l0] = to_inject_mv_y;
-        ++context_ptr->injected_mv_count_l0;
+        add_injected_mv_l0(context_ptr, to_inject_mv_x, to_inject_mv_y);
     }
 
     //NEAR_L0
@@ -1232,9 +1282,7 @@ void inject_warped_motion_candidates(
 
             if (candidateArray[canIdx].local_warp_valid)
                 ++canIdx;
-            context_ptr->injected_mv_x_l0_array[context_ptr->injected_mv_count_l0] = to_inject_mv_x;
-            context_ptr->injected_mv_y_l0_array[context_ptr->injected_mv_count_l0] = to_inject_mv_y;
-            ++context_ptr->injected_mv_count_l0;
+            add_injected_mv_l0(context_ptr, to_inject_mv_x, to_inject_mv_y);
         }
     }
 
@@ -1308,9 +1356,7 @@ void inject_warped_motion_candidates(
 
         if (candidateArray[canIdx].local_warp_valid)
             ++canIdx;
-        context_ptr->injected_mv_x_l0_array[context_ptr->injected_mv_count_l0] = to_inject_mv_x;
-        context_ptr->injected_mv_y_l0_array[context_ptr->injected_mv_count_l0] = to_inject_mv_y;
-        ++context_ptr->injected_mv_count_l0;
+        add_injected_mv_l0(context_ptr, to_inject_mv_x, to_inject_mv_y);
     }
     }
 
@@ -1477,9 +1523,7 @@ void  inject_inter_candidates(
         candidateArray[canTotalCnt].motion_vector_pred_y[REF_LIST_0] = bestPredmv[0].as_mv.row;
 
         ++canTotalCnt;
-        context_ptr->injected_mv_x_l0_array[context_ptr->injected_mv_count_l0] = to_inject_mv_x;
-        context_ptr->injected_mv_y_l0_array[context_ptr->injected_mv_count_l0] = to_inject_mv_y;
-        ++context_ptr->injected_mv_count_l0;
+        add_injected_mv_l0(context_ptr, to_inject_mv_x, to_inject_mv_y);
         }
         if (isCompoundEnabled) {
             /**************
@@ -1532,9 +1576,7 @@ void  inject_inter_candidates(
             candidateArray[canTotalCnt].motion_vector_pred_y[REF_LIST_1] = bestPredmv[0].as_mv.row;
 
             ++canTotalCnt;
-            context_ptr->injected_mv_x_l1_array[context_ptr->injected_mv_count_l1] = to_inject_mv_x;
-            context_ptr->injected_mv_y_l1_array[context_ptr->injected_mv_count_l1] = to_inject_mv_y;
-            ++context_ptr->injected_mv_count_l1;
+            add_injected_mv_l1(context_ptr, to_inject_mv_x, to_inject_mv_y);
             }
             /**************
                NEW_NEWMV
@@ -1595,11 +1637,7 @@ void  inject_inter_candidates(
                 candidateArray[canTotalCnt].motion_vector_pred_y[REF_LIST_1] = bestPredmv[1].as_mv.row;
 
                 ++canTotalCnt;
-                context_ptr->injected_mv_x_bipred_l0_array[context_ptr->injected_mv_count_bipred] = to_inject_mv_x_l0;
-                context_ptr->injected_mv_y_bipred_l0_array[context_ptr->injected_mv_count_bipred] = to_inject_mv_y_l0;
-                context_ptr->injected_mv_x_bipred_l1_array[context_ptr->injected_mv_count_bipred] = to_inject_mv_x_l1;
-                context_ptr->injected_mv_y_bipred_l1_array[context_ptr->injected_mv_count_bipred] = to_inject_mv_y_l1;
-                ++context_ptr->injected_mv_count_bipred;
+                add_injected_mv_bipred(context_ptr, to_inject_mv_x_l0, to_inject_mv_y_l0, to_inject_mv_x_l1, to_inject_mv_y_l1);
                 }
             }
 
@@ -1657,9 +1695,7 @@ void  inject_inter_candidates(
             candidateArray[canTotalCnt].motion_vector_pred_y[REF_LIST_0] = bestPredmv[0].as_mv.row;
 
             ++canTotalCnt;
-            context_ptr->injected_mv_x_l0_array[context_ptr->injected_mv_count_l0] = to_inject_mv_x;
-            context_ptr->injected_mv_y_l0_array[context_ptr->injected_mv_count_l0] = to_inject_mv_y;
-            ++context_ptr->injected_mv_count_l0;
+            add_injected_mv_l0(context_ptr, to_inject_mv_x, to_inject_mv_y);
             }
         }
 #endif
@@ -1700,9 +1736,7 @@ void  inject_inter_candidates(
                 candidateArray[canTotalCnt].motionVector_y_L0 = to_inject_mv_y;
 
                 ++canTotalCnt;
-                context_ptr->injected_mv_x_l0_array[context_ptr->injected_mv_count_l0] = to_inject_mv_x;
-                context_ptr->injected_mv_y_l0_array[context_ptr->injected_mv_count_l0] = to_inject_mv_y;
-                ++context_ptr->injected_mv_count_l0;
+                add_injected_mv_l0(context_ptr, to_inject_mv_x, to_inject_mv_y);
             }
         }
 
@@ -1744,11 +1778,7 @@ void  inject_inter_candidates(
                 candidateArray[canTotalCnt].motionVector_y_L1 = to_inject_mv_y_l1;
 
                 ++canTotalCnt;
-                context_ptr->injected_mv_x_bipred_l0_array[context_ptr->injected_mv_count_bipred] = to_inject_mv_x_l0;
-                context_ptr->injected_mv_y_bipred_l0_array[context_ptr->injected_mv_count_bipred] = to_inject_mv_y_l0;
-                context_ptr->injected_mv_x_bipred_l1_array[context_ptr->injected_mv_count_bipred] = to_inject_mv_x_l1;
-                context_ptr->injected_mv_y_bipred_l1_array[context_ptr->injected_mv_count_bipred] = to_inject_mv_y_l1;
-                ++context_ptr->injected_mv_count_bipred;
+                add_injected_mv_bipred(context_ptr, to_inject_mv_x_l0, to_inject_mv_y_l0, to_inject_mv_x_l1, to_inject_mv_y_l1);
             }
         }
     }
@@ -2172,7 +2202,8 @@ void  intra_bc_search(
     x->mv_limits.col_max = (cm->mi_cols - mi_col) * MI_SIZE + AOM_INTERP_EXTEND;
     //set search paramters
     x->sadperbit16 = sad_per_bit16lut_8[pcs->parent_pcs_ptr->base_qindex];
-    x->errorperbit = context_ptr->full_lambda >> RD_EPB_SHIFT;
+    // The search runs on the 8bit input: undo the 10bit scaling of the hbd mode decision lambda
+    x->errorperbit = (context_ptr->hbd_mode_decision ? context_ptr->full_lambda >> 4 : context_ptr->full_lambda) >> RD_EPB_SHIFT;
     x->errorperbit += (x->errorperbit == 0);
     //temp buffer for hash me
     for (int xi = 0; xi < 2; xi++)
@@ -2571,9 +2602,7 @@ EbErrorType ProductGenerateMdCandidatesCu(
     uint32_t       canTotalCnt;
 
     // Reset duplicates variables
-    context_ptr->injected_mv_count_l0 = 0;
-    context_ptr->injected_mv_count_l1 = 0;
-    context_ptr->injected_mv_count_bipred = 0;
+    reset_injected_mvs(context_ptr);
 
     ProductInitMdCandInjection(
         context_ptr,
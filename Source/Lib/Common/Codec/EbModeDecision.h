@@ -252,7 +252,8 @@ extern "C" {
         uint64_t                       *fast_cost_ptr,
         uint64_t                       *full_cost_ptr,
         uint64_t                       *full_cost_skip_ptr,
-        uint64_t                       *full_cost_merge_ptr
+        uint64_t                       *full_cost_merge_ptr,
+        EbBool                          hbd_mode_decision
     );
     uint8_t product_full_mode_decision(
         struct ModeDecisionContext_s   *context_ptr,
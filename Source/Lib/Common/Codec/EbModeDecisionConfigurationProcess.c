@@ -27,6 +27,7 @@
 #include "EbReferenceObject.h"
 #include "EbModeDecisionProcess.h"
 #include "av1me.h"
+#include "EbGlobalMotionEstimation.h"
 
 
 #define MAX_MESH_SPEED 5  // Max speed setting for mesh motion method
@@ -336,6 +337,8 @@ static INLINE int32_t aom_get_qmlevel(int32_t qindex, int32_t first, int32_t las
 void SetGlobalMotionField(
     PictureControlSet_t                    *picture_control_set_ptr)
 {
+    SequenceControlSet *sequence_control_set_ptr = (SequenceControlSet*)picture_control_set_ptr->sequence_control_set_wrapper_ptr->object_ptr;
+
     // Init Global Motion Vector
     uint8_t frameIndex;
     for (frameIndex = INTRA_FRAME; frameIndex <= ALTREF_FRAME; ++frameIndex) {
@@ -375,6 +378,15 @@ void SetGlobalMotionField(
         picture_control_set_ptr->parent_pcs_ptr->global_motion[LAST_FRAME].wmmat[1] = picture_control_set_ptr->parent_pcs_ptr->tiltMvx << 1 << GM_TRANS_ONLY_PREC_DIFF;
         picture_control_set_ptr->parent_pcs_ptr->global_motion[LAST_FRAME].wmmat[0] = picture_control_set_ptr->parent_pcs_ptr->tiltMvy << 1 << GM_TRANS_ONLY_PREC_DIFF;
 
+    }
+    else if (global_motion_is_translational(&picture_control_set_ptr->parent_pcs_ptr->gm_estimate[REF_LIST_0], sequence_control_set_ptr->luma_width, sequence_control_set_ptr->luma_height) &&
+        (picture_control_set_ptr->parent_pcs_ptr->gm_estimate[REF_LIST_0].trans_x || picture_control_set_ptr->parent_pcs_ptr->gm_estimate[REF_LIST_0].trans_y)) {
+
+        // Camera motion found on the decimated pictures that the pan/tilt detection missed
+        picture_control_set_ptr->parent_pcs_ptr->global_motion[LAST_FRAME].wmtype = TRANSLATION;
+        picture_control_set_ptr->parent_pcs_ptr->global_motion[LAST_FRAME].wmmat[1] = picture_control_set_ptr->parent_pcs_ptr->gm_estimate[REF_LIST_0].trans_x << 1 << GM_TRANS_ONLY_PREC_DIFF;
+        picture_control_set_ptr->parent_pcs_ptr->global_motion[LAST_FRAME].wmmat[0] = picture_control_set_ptr->parent_pcs_ptr->gm_estimate[REF_LIST_0].trans_y << 1 << GM_TRANS_ONLY_PREC_DIFF;
+
     }
 
     picture_control_set_ptr->parent_pcs_ptr->global_motion[LAST_FRAME].wmmat[1] = (int32_t)clamp(picture_control_set_ptr->parent_pcs_ptr->global_motion[LAST_FRAME].wmmat[1], GM_TRANS_MIN*GM_TRANS_DECODE_FACTOR, GM_TRANS_MAX*GM_TRANS_DECODE_FACTOR);
@@ -1851,6 +1863,9 @@ void set_target_budget_oq(
 
     budget_per_sb = CLIP3(SB_PRED_OPEN_LOOP_COST, U_150, budget_per_sb + budget_per_sb_boost[context_ptr->adp_level] + luminosity_change_boost);
 
+    // Deadline Control: lower the picture budget by 1/8 per MD speed level; derive_optimal_budget_per_sb() spreads the cut over the SBs based on their score
+    budget_per_sb = MAX(SB_PRED_OPEN_LOOP_COST, budget_per_sb * (8 - picture_control_set_ptr->parent_pcs_ptr->dl_md_level) / 8);
+
     //printf("picture_number = %d\tsb_average_score = %d\n", picture_control_set_ptr->picture_number, budget_per_sb);
     budget = sequence_control_set_ptr->sb_tot_cnt * budget_per_sb;
 
@@ -2219,7 +2234,7 @@ void* ModeDecisionConfigurationKernel(void *input_ptr)
             &lambdaSse,
             &lambdaSad,
             &lambdaSse,
-            (uint8_t)picture_control_set_ptr->parent_pcs_ptr->enhanced_picture_ptr->bit_depth,
+            (uint8_t)sequence_control_set_ptr->static_config.encoder_bit_depth,
             context_ptr->qp_index);
         context_ptr->lambda = (uint64_t)lambdaSad;
 
@@ -16,6 +16,9 @@
 EbErrorType mode_decision_context_ctor(
     ModeDecisionContext_t  **context_dbl_ptr,
     EbColorFormat         color_format,
+    EbBool                is16bit,
+    EbBool                hbd_mode_decision,
+    uint16_t              sb_size,
     EbFifo                *mode_decision_configuration_input_fifo_ptr,
     EbFifo                *mode_decision_output_fifo_ptr){
 
@@ -26,11 +29,20 @@ EbErrorType mode_decision_context_ctor(
     ModeDecisionContext_t *context_ptr;
     EB_MALLOC(ModeDecisionContext_t*, context_ptr, sizeof(ModeDecisionContext_t), EB_N_PTR);
     *context_dbl_ptr = context_ptr;
+    context_ptr->hbd_mode_decision = hbd_mode_decision;
 
     // Input/Output System Resource Manager FIFOs
     context_ptr->mode_decision_configuration_input_fifo_ptr = mode_decision_configuration_input_fifo_ptr;
     context_ptr->mode_decision_output_fifo_ptr = mode_decision_output_fifo_ptr;
 
+    // Injected MV sets, zeroed stamps are empty slots once the current stamp is 1
+    memset(&context_ptr->injected_mv_set_l0, 0, sizeof(InjectedMvSet_t));
+    memset(&context_ptr->injected_mv_set_l1, 0, sizeof(InjectedMvSet_t));
+    memset(&context_ptr->injected_mv_set_bipred, 0, sizeof(InjectedMvSet_t));
+    context_ptr->injected_mv_set_l0.current_stamp = 1;
+    context_ptr->injected_mv_set_l1.current_stamp = 1;
+    context_ptr->injected_mv_set_bipred.current_stamp = 1;
+
     // Trasform Scratch Memory
     EB_MALLOC(int16_t*, context_ptr->transform_inner_array_ptr, 3120, EB_N_PTR); //refer to EbInvTransform_SSE2.as. case 32x32
 
@@ -54,6 +66,15 @@ EbErrorType mode_decision_context_ctor(
     return_error = eb_trans_quant_buffers_ctor(
         context_ptr->trans_quant_buffers_ptr);
 
+    if (return_error == EB_ErrorInsufficientResources) {
+        return EB_ErrorInsufficientResources;
+    }
+    // Neighbor Array Undo Log
+    return_error = neighbor_array_undo_log_ctor(
+        &context_ptr->neighbor_undo_log,
+        MD_NEIGHBOR_UNDO_LOG_SIZE,
+        MD_NEIGHBOR_UNDO_LOG_ENTRIES);
+
     if (return_error == EB_ErrorInsufficientResources) {
         return EB_ErrorInsufficientResources;
     }
@@ -73,7 +94,8 @@ EbErrorType mode_decision_context_ctor(
             &(context_ptr->fast_cost_array[bufferIndex]),
             &(context_ptr->full_cost_array[bufferIndex]),
             &(context_ptr->full_cost_skip_ptr[bufferIndex]),
-            &(context_ptr->full_cost_merge_ptr[bufferIndex])
+            &(context_ptr->full_cost_merge_ptr[bufferIndex]),
+            hbd_mode_decision
         );
         if (return_error == EB_ErrorInsufficientResources) {
             return EB_ErrorInsufficientResources;
@@ -96,6 +118,8 @@ EbErrorType mode_decision_context_ctor(
         return EB_ErrorInsufficientResources;
     }
     uint32_t codedLeafIndex, tu_index;
+    // The neighbor recon samples are 16bit in hbd mode decision
+    const uint32_t neigh_recon_size = hbd_mode_decision ? 128 * sizeof(uint16_t) : 128;
 
     for (codedLeafIndex = 0; codedLeafIndex < BLOCK_MAX_COUNT_SB_128; ++codedLeafIndex) {
 
@@ -106,13 +130,13 @@ EbErrorType mode_decision_context_ctor(
         const BlockGeom * blk_geom = get_blk_geom_mds(codedLeafIndex);
         UNUSED(blk_geom);
         EB_MALLOC(MacroBlockD*, context_ptr->md_cu_arr_nsq[codedLeafIndex].av1xd, sizeof(MacroBlockD), EB_N_PTR);
-        EB_MALLOC(uint8_t*, context_ptr->md_cu_arr_nsq[codedLeafIndex].neigh_left_recon[0], 128, EB_N_PTR);
-        EB_MALLOC(uint8_t*, context_ptr->md_cu_arr_nsq[codedLeafIndex].neigh_left_recon[1], 128, EB_N_PTR);
-        EB_MALLOC(uint8_t*, context_ptr->md_cu_arr_nsq[codedLeafIndex].neigh_left_recon[2], 128, EB_N_PTR);
+        EB_MALLOC(uint8_t*, context_ptr->md_cu_arr_nsq[codedLeafIndex].neigh_left_recon[0], neigh_recon_size, EB_N_PTR);
+        EB_MALLOC(uint8_t*, context_ptr->md_cu_arr_nsq[codedLeafIndex].neigh_left_recon[1], neigh_recon_size, EB_N_PTR);
+        EB_MALLOC(uint8_t*, context_ptr->md_cu_arr_nsq[codedLeafIndex].neigh_left_recon[2], neigh_recon_size, EB_N_PTR);
 
-        EB_MALLOC(uint8_t*, context_ptr->md_cu_arr_nsq[codedLeafIndex].neigh_top_recon[0], 128, EB_N_PTR);
-        EB_MALLOC(uint8_t*, context_ptr->md_cu_arr_nsq[codedLeafIndex].neigh_top_recon[1], 128, EB_N_PTR);
-        EB_MALLOC(uint8_t*, context_ptr->md_cu_arr_nsq[codedLeafIndex].neigh_top_recon[2], 128, EB_N_PTR);
+        EB_MALLOC(uint8_t*, context_ptr->md_cu_arr_nsq[codedLeafIndex].neigh_top_recon[0], neigh_recon_size, EB_N_PTR);
+        EB_MALLOC(uint8_t*, context_ptr->md_cu_arr_nsq[codedLeafIndex].neigh_top_recon[1], neigh_recon_size, EB_N_PTR);
+        EB_MALLOC(uint8_t*, context_ptr->md_cu_arr_nsq[codedLeafIndex].neigh_top_recon[2], neigh_recon_size, EB_N_PTR);
 
 #if NO_ENCDEC //SB128_TODO to upgrade
         {
@@ -158,6 +182,71 @@ EbErrorType mode_decision_context_ctor(
         }
 #endif
     }
+
+    // MD output kept for EncDec: one slot per block geometry that can be committed (8x8 and larger)
+    // of the configured SB size, only 8 bit encodes can commit the MD output (md_output_reuse)
+    {
+        uint32_t block_count = (sb_size == 128) ? BLOCK_MAX_COUNT_SB_128 : BLOCK_MAX_COUNT_SB_64;
+        uint32_t luma_area = 0;
+        uint32_t chroma_area = 0;
+        int32_t *coeff_pool = (int32_t*)EB_NULL;
+        uint8_t *recon_pool = (uint8_t*)EB_NULL;
+
+        if (!is16bit) {
+            for (codedLeafIndex = 0; codedLeafIndex < block_count; ++codedLeafIndex) {
+                const BlockGeom * blk_geom = get_blk_geom_mds(codedLeafIndex);
+                if (blk_geom->bwidth >= 8 && blk_geom->bheight >= 8) {
+                    luma_area += blk_geom->bwidth * blk_geom->bheight;
+                    chroma_area += blk_geom->bwidth_uv * blk_geom->bheight_uv;
+                }
+            }
+
+            EB_MALLOC(int32_t*, coeff_pool, sizeof(int32_t) * (luma_area + 2 * chroma_area), EB_N_PTR);
+            EB_MALLOC(uint8_t*, recon_pool, sizeof(uint8_t) * (luma_area + 2 * chroma_area), EB_N_PTR);
+        }
+
+        for (codedLeafIndex = 0; codedLeafIndex < BLOCK_MAX_COUNT_SB_128; ++codedLeafIndex) {
+            MdEncPassCuData_t *md_ep_pipe = &context_ptr->md_ep_pipe_sb[codedLeafIndex];
+            uint32_t plane;
+
+            md_ep_pipe->md_output_valid = EB_FALSE;
+            for (plane = 0; plane < 3; ++plane) {
+                md_ep_pipe->quant_coeff[plane] = (int32_t*)EB_NULL;
+                md_ep_pipe->recon[plane] = (uint8_t*)EB_NULL;
+            }
+            if (!is16bit && codedLeafIndex < block_count) {
+                const BlockGeom * blk_geom = get_blk_geom_mds(codedLeafIndex);
+                if (blk_geom->bwidth >= 8 && blk_geom->bheight >= 8) {
+                    for (plane = 0; plane < 3; ++plane) {
+                        uint32_t area = plane ? blk_geom->bwidth_uv * blk_geom->bheight_uv : blk_geom->bwidth * blk_geom->bheight;
+                        md_ep_pipe->quant_coeff[plane] = coeff_pool;
+                        md_ep_pipe->recon[plane] = recon_pool;
+                        coeff_pool += area;
+                        recon_pool += area;
+                    }
+                }
+            }
+        }
+    }
+
+    // MD inter prediction cache
+    {
+        uint8_t *pred_pool;
+        uint32_t entry;
+
+        EB_MALLOC(uint8_t*, pred_pool, sizeof(uint8_t) * MD_PRED_CACHE_SIZE * (MAX_SB_SQUARE + 2 * (MAX_SB_SQUARE >> 2)), EB_N_PTR);
+
+        for (entry = 0; entry < MD_PRED_CACHE_SIZE; ++entry) {
+            MdPredCacheEntry_t *cache_entry = &context_ptr->md_pred_cache[entry];
+            cache_entry->valid = EB_FALSE;
+            cache_entry->buffer_y = pred_pool;
+            cache_entry->buffer_cb = cache_entry->buffer_y + MAX_SB_SQUARE;
+            cache_entry->buffer_cr = cache_entry->buffer_cb + (MAX_SB_SQUARE >> 2);
+            pred_pool = cache_entry->buffer_cr + (MAX_SB_SQUARE >> 2);
+        }
+        context_ptr->md_pred_cache_next = 0;
+    }
+
     return EB_ErrorNone;
 }
 
@@ -351,6 +440,20 @@ const EB_AV1_LAMBDA_ASSIGN_FUNC av1_lambda_assignment_function_table[4] = {
     Av1lambdaAssign,
 };
 
+/******************************************************
+* The 10bit lambda tables are in the 8bit distortion
+* domain: scale them for the distortions of the hbd
+* mode decision, 4x for SAD and 16x for SSE
+******************************************************/
+static void scale_lambda_hbd_mode_decision(
+    ModeDecisionContext_t   *context_ptr)
+{
+    context_ptr->fast_lambda <<= 2;
+    context_ptr->fast_chroma_lambda <<= 2;
+    context_ptr->full_lambda <<= 4;
+    context_ptr->full_chroma_lambda <<= 4;
+}
+
 void reset_mode_decision(
     ModeDecisionContext_t   *context_ptr,
     PictureControlSet_t     *picture_control_set_ptr,
@@ -377,8 +480,10 @@ void reset_mode_decision(
         &context_ptr->full_lambda,
         &context_ptr->fast_chroma_lambda,
         &context_ptr->full_chroma_lambda,
-        (uint8_t)picture_control_set_ptr->parent_pcs_ptr->enhanced_picture_ptr->bit_depth,
+        (uint8_t)sequence_control_set_ptr->static_config.encoder_bit_depth,
         context_ptr->qp_index);
+    if (context_ptr->hbd_mode_decision)
+        scale_lambda_hbd_mode_decision(context_ptr);
     // Slice Type
     slice_type =
         (picture_control_set_ptr->parent_pcs_ptr->idr_flag == EB_TRUE) ? I_SLICE :
@@ -472,8 +577,10 @@ void ModeDecisionConfigureLcu(
         &context_ptr->full_lambda,
         &context_ptr->fast_chroma_lambda,
         &context_ptr->full_chroma_lambda,
-        (uint8_t)picture_control_set_ptr->parent_pcs_ptr->enhanced_picture_ptr->bit_depth,
+        (uint8_t)sequence_control_set_ptr->static_config.encoder_bit_depth,
         context_ptr->qp_index);
+    if (context_ptr->hbd_mode_decision)
+        scale_lambda_hbd_mode_decision(context_ptr);
 
 
 
@@ -16,6 +16,7 @@
 #include "EbTransQuantBuffers.h"
 #include "EbReferenceObject.h"
 #include "EbNeighborArrays.h"
+#include "EbIntraPrediction.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -30,6 +31,15 @@ extern "C" {
 #define DEPTH_TWO_STEP    5
 #define DEPTH_THREE_STEP  1
 
+// Neighbor array undo log: the non-last blocks of a shape (totns is at most 4)
+// each log the MD_NEIGHBOR_UNDO_ARRAYS arrays of save_neighbour_arrays(), in up
+// to NEIGHBOR_ARRAY_UNDO_REGIONS regions spanning 4 * MAX_SB_SIZE units of up
+// to 4 bytes each
+#define MD_NEIGHBOR_UNDO_BLOCKS           (4 - 1)
+#define MD_NEIGHBOR_UNDO_ARRAYS           16
+#define MD_NEIGHBOR_UNDO_LOG_ENTRIES      (MD_NEIGHBOR_UNDO_BLOCKS * MD_NEIGHBOR_UNDO_ARRAYS * NEIGHBOR_ARRAY_UNDO_REGIONS)
+#define MD_NEIGHBOR_UNDO_LOG_SIZE         (MD_NEIGHBOR_UNDO_BLOCKS * MD_NEIGHBOR_UNDO_ARRAYS * 4 * MAX_SB_SIZE * 4)
+
      /**************************************
       * Macros
       **************************************/
@@ -51,6 +61,11 @@ extern "C" {
         uint32_t                    y_has_coeff;
         uint64_t                    fast_luma_rate;
         uint16_t                    y_count_non_zero_coeffs[4];// Store nonzero CoeffNum, per TU. If one TU, stored in 0, otherwise 4 tus stored in 0 to 3
+        // Final candidate output, committed by EncDec instead of re-encoding the block (md_output_reuse)
+        EbBool                      md_output_valid;
+        uint16_t                    eob[3][MAX_TXB_COUNT];
+        int32_t                    *quant_coeff[3];             // Quantized coefficients, in the EncDec 1D TU layout
+        uint8_t                    *recon[3];                   // Recon samples, bwidth (bwidth_uv) stride
 
     } MdEncPassCuData_t;
 
@@ -81,6 +96,38 @@ extern "C" {
     } MdCodingUnit_t;
 
 
+    // Open-addressing set of the MVs already injected for the current block. A slot is
+    // occupied only when its stamp matches current_stamp, so resetting per block is O(1).
+#define INJECTED_MV_SET_BITS            8
+#define INJECTED_MV_SET_SIZE            (1 << INJECTED_MV_SET_BITS)
+    typedef struct InjectedMvSet_s
+    {
+        uint64_t                          key[INJECTED_MV_SET_SIZE];
+        uint16_t                          stamp[INJECTED_MV_SET_SIZE];
+        uint16_t                          current_stamp;
+    } InjectedMvSet_t;
+
+    // Inter predictions already built for the current SB. A request is served from an entry
+    // with the same reference, MVs and filters whose block contains the requested block.
+#define MD_PRED_CACHE_SIZE              16
+    typedef struct MdPredCacheEntry_s
+    {
+        EbBool                            valid;
+        uint8_t                           ref_frame_type;
+        uint8_t                           pred_direction;
+        uint32_t                          interp_filters;
+        int16_t                           mv[MAX_NUM_OF_REF_PIC_LIST][2];
+        uint16_t                          origin_x;               // SB based, as blk_geom
+        uint16_t                          origin_y;
+        uint8_t                           bwidth;
+        uint8_t                           bheight;
+        EbBool                            chroma;
+        uint8_t                           uv_4tap;                // chroma 4-tap filter in x (bit 0) / y (bit 1)
+        uint8_t                          *buffer_y;               // MAX_SB_SIZE stride, at SB based position
+        uint8_t                          *buffer_cb;              // MAX_SB_SIZE / 2 stride
+        uint8_t                          *buffer_cr;
+    } MdPredCacheEntry_t;
+
     typedef struct ModeDecisionContext_s
     {
         EbFifo                       *mode_decision_configuration_input_fifo_ptr;
@@ -112,6 +159,8 @@ extern "C" {
         NeighborArrayUnit_t            *ref_frame_type_neighbor_array;
         NeighborArrayUnit_t            *leaf_partition_neighbor_array;
         NeighborArrayUnit32_t          *interpolation_type_neighbor_array;
+        NeighborArrayUndoLog_t         *neighbor_undo_log;       // Rolls back the neighbor array updates of a non-square shape
+        IntraEdgeCache_t                intra_edge_cache[MAX_MB_PLANE]; // Reference samples of the current block, per plane
 
         // TMVP
         EbReferenceObject            *reference_object_write_ptr;
@@ -190,18 +239,11 @@ extern "C" {
         uint8_t                         intra_chroma_top_mode;
         int16_t                         pred_buf_q3[CFL_BUF_SQUARE]; // Hsan: both MD and EP to use pred_buf_q3 (kept 1, and removed the 2nd)
 
-        int16_t                           injected_mv_x_l0_array[MODE_DECISION_CANDIDATE_MAX_COUNT]; // used to do not inject existing MV
-        int16_t                           injected_mv_y_l0_array[MODE_DECISION_CANDIDATE_MAX_COUNT]; // used to do not inject existing MV
+        InjectedMvSet_t                   injected_mv_set_l0;     // used to do not inject existing MV
         uint8_t                           injected_mv_count_l0;
-                                          
-        int16_t                           injected_mv_x_l1_array[MODE_DECISION_CANDIDATE_MAX_COUNT]; // used to do not inject existing MV
-        int16_t                           injected_mv_y_l1_array[MODE_DECISION_CANDIDATE_MAX_COUNT]; // used to do not inject existing MV
+        InjectedMvSet_t                   injected_mv_set_l1;     // used to do not inject existing MV
         uint8_t                           injected_mv_count_l1;
-                                          
-        int16_t                           injected_mv_x_bipred_l0_array[MODE_DECISION_CANDIDATE_MAX_COUNT]; // used to do not inject existing MV
-        int16_t                           injected_mv_y_bipred_l0_array[MODE_DECISION_CANDIDATE_MAX_COUNT]; // used to do not inject existing MV
-        int16_t                           injected_mv_x_bipred_l1_array[MODE_DECISION_CANDIDATE_MAX_COUNT]; // used to do not inject existing MV
-        int16_t                           injected_mv_y_bipred_l1_array[MODE_DECISION_CANDIDATE_MAX_COUNT]; // used to do not inject existing MV
+        InjectedMvSet_t                   injected_mv_set_bipred; // used to do not inject existing MV
         uint8_t                           injected_mv_count_bipred;
         uint32_t                          fast_candidate_intra_count;
         uint32_t                          fast_candidate_inter_count;
@@ -221,6 +263,11 @@ extern "C" {
         uint8_t                           unipred3x3_injection;
         uint8_t                           bipred3x3_injection;
         uint8_t                           interpolation_filter_search_blk_size;
+        uint8_t                           md_output_reuse;
+        MdPredCacheEntry_t                md_pred_cache[MD_PRED_CACHE_SIZE];
+        uint8_t                           md_pred_cache_next;     // round robin replacement
+        // Native 16bit pipeline: MD predicts, reconstructs and measures on the 16bit planes
+        EbBool                            hbd_mode_decision;
     } ModeDecisionContext_t;
 
     typedef void(*EB_AV1_LAMBDA_ASSIGN_FUNC)(
@@ -247,6 +294,9 @@ extern "C" {
     extern EbErrorType mode_decision_context_ctor(
         ModeDecisionContext_t      **context_dbl_ptr,
         EbColorFormat              color_format,
+        EbBool                     is16bit,
+        EbBool                     hbd_mode_decision,
+        uint16_t                   sb_size,
         EbFifo                    *mode_decision_configuration_input_fifo_ptr,
         EbFifo                    *mode_decision_output_fifo_ptr);
 
@@ -21,6 +21,7 @@
 #include "EbLambdaRateTables.h"
 #include <math.h>
 #include "EbPictureOperators.h"
+#include "EbGlobalMotionEstimation.h"
 #define OIS_TH_COUNT    4
 
 int32_t OisPointTh[3][MAX_TEMPORAL_LAYERS][OIS_TH_COUNT] = {
@@ -6805,7 +6806,7 @@ uint32_t get_in_loop_me_info_index(
 }
 
 #define NSET_CAND(mePuResult, num, dist, dir) \
-     (mePuResult)->distortionDirection[(num)].distortion = (dist); \
+     (mePuResult)->distortionDirection[(num)].distortion = MIN((dist), ME_DISTORTION_MAX); \
      (mePuResult)->distortionDirection[(num)].direction = (dir)  ;
 
 
@@ -7619,6 +7620,7 @@ EbErrorType MotionEstimateLcu(
     EbBool                    enableHalfPel8x8 = EB_FALSE;
     EbBool                    enableQuarterPel = EB_FALSE;
     EbBool                 oneQuadrantHME =  EB_FALSE;
+    EbBool                 gm_explained;
 
     context_ptr->fractional_search64x64 = EB_TRUE;
     oneQuadrantHME = sequence_control_set_ptr->input_resolution < INPUT_SIZE_4K_RANGE ? 0 : oneQuadrantHME;
@@ -7652,14 +7654,28 @@ EbErrorType MotionEstimateLcu(
             refPicPtr = (EbPictureBufferDesc_t*)referenceObject->input_padded_picture_ptr;
             quarterRefPicPtr = (EbPictureBufferDesc_t*)referenceObject->quarter_decimated_picture_ptr;
             sixteenthRefPicPtr = (EbPictureBufferDesc_t*)referenceObject->sixteenth_decimated_picture_ptr;
+            gm_explained = (EbBool)(picture_control_set_ptr->gm_estimate[listIndex].valid && picture_control_set_ptr->gm_explained_sb_array[listIndex][sb_index]);
 #if BASE_LAYER_REF
             if (picture_control_set_ptr->temporal_layer_index > 0 || listIndex == 0 || ((ref0Poc != ref1Poc) && (listIndex == 1))) {
 #else
             if (picture_control_set_ptr->temporal_layer_index > 0 || listIndex == 0) {
 #endif
-                // A - The MV center for Tier0 search could be either (0,0), or HME
+                // A - The MV center for Tier0 search could be either (0,0), HME, or the global motion MV
                 // A - Set HME MV Center
-                if (context_ptr->update_hme_search_center_flag)
+                if (gm_explained) {
+                    int16_t gm_mv_x, gm_mv_y;
+                    global_motion_estimate_mv(
+                        &picture_control_set_ptr->gm_estimate[listIndex],
+                        origin_x + (BLOCK_SIZE_64 >> 1),
+                        origin_y + (BLOCK_SIZE_64 >> 1),
+                        picture_width,
+                        picture_height,
+                        &gm_mv_x,
+                        &gm_mv_y);
+                    x_search_center = (gm_mv_x + 2) >> 2;
+                    y_search_center = (gm_mv_y + 2) >> 2;
+                }
+                else if (context_ptr->update_hme_search_center_flag)
                     hme_mv_center_check(
                         refPicPtr,
                         context_ptr,
@@ -7677,8 +7693,9 @@ EbErrorType MotionEstimateLcu(
                 }
                 // B - NO HME in boundaries
                 // C - Skip HME
+                // D - NO HME when the SB follows the global motion
 
-                if (picture_control_set_ptr->enable_hme_flag && /*B*/sb_height == BLOCK_SIZE_64) {//(searchCenterSad > sequence_control_set_ptr->static_config.skipTier0HmeTh)) {
+                if (picture_control_set_ptr->enable_hme_flag && /*B*/sb_height == BLOCK_SIZE_64 && /*D*/!gm_explained) {//(searchCenterSad > sequence_control_set_ptr->static_config.skipTier0HmeTh)) {
                     while (searchRegionNumberInHeight < context_ptr->number_hme_search_region_in_height) {
                         while (searchRegionNumberInWidth < context_ptr->number_hme_search_region_in_width) {
 
@@ -7960,6 +7977,11 @@ EbErrorType MotionEstimateLcu(
             search_area_width = (int16_t)MIN(context_ptr->search_area_width, 127);
             search_area_height = (int16_t)MIN(context_ptr->search_area_height, 127);
 #endif
+            // Refinement window around the global motion MV
+            if (gm_explained) {
+                search_area_width = (int16_t)MIN(search_area_width, GM_REFINEMENT_SEARCH_AREA_WIDTH);
+                search_area_height = (int16_t)MIN(search_area_height, GM_REFINEMENT_SEARCH_AREA_HEIGHT);
+            }
             if ((x_search_center != 0 || y_search_center != 0) && (picture_control_set_ptr->is_used_as_reference_flag == EB_TRUE)) {
                 CheckZeroZeroCenter(
                     refPicPtr,
@@ -8424,7 +8446,7 @@ EbErrorType MotionEstimateLcu(
 
 
 
-    if (sequence_control_set_ptr->static_config.rate_control_mode) {
+    if (sequence_control_set_ptr->static_config.rate_control_mode || sequence_control_set_ptr->static_config.rc_firstpass_stats_out) {
 
         // Compute the sum of the distortion of all 16 16x16 (best) blocks in the LCU
         picture_control_set_ptr->rc_me_distortion[sb_index] = 0;
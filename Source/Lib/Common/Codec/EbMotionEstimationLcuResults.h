@@ -53,8 +53,12 @@ extern "C" {
 
 
 
+#define ME_DISTORTION_MAX        0x3FFFFFFF
+
+    // Packed into 32 bits so a PU result stays 24 bytes; the SAD of a 64x64 PU fits in 20 bits,
+    // larger values (unsearched PUs) saturate to ME_DISTORTION_MAX.
     typedef struct  DistDir_s {
-        unsigned    distortion : 32; //20bits are enough
+        unsigned    distortion : 30;
         unsigned    direction : 2;
     } DistDir_t;
 
@@ -13,9 +13,11 @@
 #include "EbMotionEstimationResults.h"
 #include "EbReferenceObject.h"
 #include "EbMotionEstimation.h"
+#include "EbGlobalMotionEstimation.h"
 #include "EbIntraPrediction.h"
 #include "EbLambdaRateTables.h"
 #include "EbComputeSAD.h"
+#include "EbSvtAv1Time.h"
 
 #include "emmintrin.h"
 
@@ -181,6 +183,12 @@ EbErrorType signal_derivation_me_kernel_oq(
         set_me_hme_params_from_config(
             sequence_control_set_ptr,
             context_ptr->me_context_ptr);
+
+    // Deadline Control: shrink the ME search area by 1/8 per speed level
+    if (picture_control_set_ptr->dl_me_level) {
+        context_ptr->me_context_ptr->search_area_width = MAX(8, context_ptr->me_context_ptr->search_area_width * (8 - picture_control_set_ptr->dl_me_level) / 8);
+        context_ptr->me_context_ptr->search_area_height = MAX(8, context_ptr->me_context_ptr->search_area_height * (8 - picture_control_set_ptr->dl_me_level) / 8);
+    }
  #if SCENE_CONTENT_SETTINGS   
     if (picture_control_set_ptr->sc_content_detected)
         context_ptr->me_context_ptr->fractionalSearchMethod = FULL_SAD_SEARCH ; 
@@ -422,6 +430,12 @@ void* MotionEstimationKernel(void *input_ptr)
     MdRateEstimationContext_t   *md_rate_estimation_array;
 
 
+    uint64_t                      start_time_seconds;
+    uint64_t                      start_time_u_seconds;
+    uint64_t                      finish_time_seconds;
+    uint64_t                      finish_time_u_seconds;
+    double                        segment_time;
+
     for (;;) {
 
 
@@ -429,6 +443,7 @@ void* MotionEstimationKernel(void *input_ptr)
         eb_get_full_object(
             context_ptr->pictureDecisionResultsInputFifoPtr,
             &inputResultsWrapperPtr);
+        EbStartTime(&start_time_seconds, &start_time_u_seconds);
 
         inputResultsPtr = (PictureDecisionResults_t*)inputResultsWrapperPtr->object_ptr;
         picture_control_set_ptr = (PictureParentControlSet_t*)inputResultsPtr->picture_control_set_wrapper_ptr->object_ptr;
@@ -486,6 +501,17 @@ void* MotionEstimationKernel(void *input_ptr)
             }
         }
 
+        // Camera motion model, used to skip HME on the SBs it explains. The first
+        // segment of the picture fits it, the others wait as their SBs need it
+        eb_block_on_mutex(picture_control_set_ptr->gm_estimation_mutex);
+        if (picture_control_set_ptr->gm_estimated == EB_FALSE) {
+            estimate_global_motion(
+                picture_control_set_ptr,
+                asm_type);
+            picture_control_set_ptr->gm_estimated = EB_TRUE;
+        }
+        eb_release_mutex(picture_control_set_ptr->gm_estimation_mutex);
+
         // *** MOTION ESTIMATION CODE ***
         if (picture_control_set_ptr->slice_type != I_SLICE) {
 
@@ -619,7 +645,7 @@ void* MotionEstimationKernel(void *input_ptr)
 
         eb_block_on_mutex(picture_control_set_ptr->rc_distortion_histogram_mutex);
 
-        if (sequence_control_set_ptr->static_config.rate_control_mode) {
+        if (sequence_control_set_ptr->static_config.rate_control_mode || sequence_control_set_ptr->static_config.rc_firstpass_stats_out) {
             if (picture_control_set_ptr->slice_type != I_SLICE) {
                 uint16_t sadIntervalIndex;
                 for (yLcuIndex = yLcuStartIndex; yLcuIndex < yLcuEndIndex; ++yLcuIndex) {
@@ -735,6 +761,13 @@ void* MotionEstimationKernel(void *input_ptr)
             }
         }
 
+        // Accumulate the ME time of the segment for the Deadline Control
+        if (sequence_control_set_ptr->static_config.deadline_mode) {
+            EbFinishTime(&finish_time_seconds, &finish_time_u_seconds);
+            EbComputeOverallElapsedTimeMs(start_time_seconds, start_time_u_seconds, finish_time_seconds, finish_time_u_seconds, &segment_time);
+            picture_control_set_ptr->dl_me_time += segment_time;
+        }
+
         eb_release_mutex(picture_control_set_ptr->rc_distortion_histogram_mutex);
 
         // Get Empty Results Object
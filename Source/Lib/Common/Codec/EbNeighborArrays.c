@@ -5,6 +5,7 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <assert.h>
 
 #include "EbNeighborArrays.h"
 #include "EbUtility.h"
@@ -261,6 +262,49 @@ void update_recon_neighbor_array(
     return;
 }
 
+void update_recon_neighbor_array16bit(
+    NeighborArrayUnit_t *na_unit_ptr,
+    uint16_t              *src_ptr_top,
+    uint16_t              *src_ptr_left,
+    uint32_t               pic_origin_x,
+    uint32_t               pic_origin_y,
+    uint32_t               block_width,
+    uint32_t               block_height)
+{
+    uint16_t *dst_ptr;
+    uint32_t idx;
+
+    dst_ptr = (uint16_t*)na_unit_ptr->topArray +
+        get_neighbor_array_unit_top_index(
+            na_unit_ptr,
+            pic_origin_x);
+    EB_MEMCPY(dst_ptr, src_ptr_top, block_width * sizeof(uint16_t));
+
+    dst_ptr = (uint16_t*)na_unit_ptr->leftArray +
+        get_neighbor_array_unit_left_index(
+            na_unit_ptr,
+            pic_origin_y);
+    EB_MEMCPY(dst_ptr, src_ptr_left, block_height * sizeof(uint16_t));
+
+    // Top-left: bottom row, then the right column reversed (see update_recon_neighbor_array)
+    dst_ptr = (uint16_t*)na_unit_ptr->topLeftArray +
+        get_neighbor_array_unit_top_left_index(
+            na_unit_ptr,
+            pic_origin_x,
+            pic_origin_y + (block_height - 1));
+    EB_MEMCPY(dst_ptr, src_ptr_top, block_width * sizeof(uint16_t));
+
+    dst_ptr = (uint16_t*)na_unit_ptr->topLeftArray +
+        get_neighbor_array_unit_top_left_index(
+            na_unit_ptr,
+            pic_origin_x + (block_width - 1),
+            pic_origin_y);
+    for (idx = 0; idx < block_height; ++idx)
+        *(dst_ptr - idx) = src_ptr_left[idx];
+
+    return;
+}
+
 /*************************************************
  * Neighbor Array Sample Update
  *************************************************/
@@ -872,164 +916,159 @@ void neighbor_array_unit_mode_write(
     return;
 }
 
-void copy_neigh_arr(
-    NeighborArrayUnit_t   *na_src,
-    NeighborArrayUnit_t   *na_dst,
-    uint32_t               origin_x,
-    uint32_t               origin_y,
-    uint32_t               bw,
-    uint32_t               bh,
-    uint32_t                 neighbor_array_type_mask)
+/*************************************************
+ * Neighbor Array Undo Log Ctor
+ *************************************************/
+EbErrorType neighbor_array_undo_log_ctor(
+    NeighborArrayUndoLog_t **undo_log_dbl_ptr,
+    uint32_t                 buffer_size,
+    uint32_t                 max_entry_count)
 {
+    NeighborArrayUndoLog_t *undo_log_ptr;
+    EB_MALLOC(NeighborArrayUndoLog_t*, undo_log_ptr, sizeof(NeighborArrayUndoLog_t), EB_N_PTR);
+    *undo_log_dbl_ptr = undo_log_ptr;
 
-    uint32_t idx;
-    uint8_t  *dst_ptr, *src_ptr;
+    EB_MALLOC(uint8_t*, undo_log_ptr->buffer, buffer_size, EB_N_PTR);
+    EB_MALLOC(NeighborArrayUndoEntry_t*, undo_log_ptr->entries, sizeof(NeighborArrayUndoEntry_t) * max_entry_count, EB_N_PTR);
+    undo_log_ptr->buffer_size = buffer_size;
+    undo_log_ptr->max_entry_count = max_entry_count;
+    undo_log_ptr->buffer_fill = 0;
+    undo_log_ptr->entry_count = 0;
 
-    uint32_t count;
-    uint32_t naOffset;
-    uint32_t naUnitSize;
-
-    UNUSED(idx);
-    naUnitSize = na_src->unit_size;
+    return EB_ErrorNone;
+}
 
-    if (neighbor_array_type_mask & NEIGHBOR_ARRAY_UNIT_TOP_MASK) {
+static void neighbor_array_undo_push(
+    NeighborArrayUndoLog_t *undo_log_ptr,
+    uint8_t                *dst_ptr,
+    uint32_t                size)
+{
+    NeighborArrayUndoEntry_t *entry_ptr;
+
+    if (size == 0)
+        return;
+
+    // The log is sized for the worst case of its user. Past it, the units are not
+    // logged rather than written out of bounds: the rollback is then partial,
+    // which only affects the MD neighbor contexts, not the bitstream validity.
+    if (undo_log_ptr->entry_count >= undo_log_ptr->max_entry_count ||
+        undo_log_ptr->buffer_fill + size > undo_log_ptr->buffer_size) {
+        assert(0);
+        return;
+    }
 
-        naOffset = get_neighbor_array_unit_top_index(na_src, origin_x);
-        src_ptr = na_src->topArray + naOffset * naUnitSize;
-        dst_ptr = na_dst->topArray + naOffset * naUnitSize;
-        count = bw >> na_src->granularityNormalLog2;
+    entry_ptr = &undo_log_ptr->entries[undo_log_ptr->entry_count++];
+    entry_ptr->dst_ptr = dst_ptr;
+    entry_ptr->size = size;
+    EB_MEMCPY(undo_log_ptr->buffer + undo_log_ptr->buffer_fill, dst_ptr, size);
+    undo_log_ptr->buffer_fill += size;
+}
 
-        EB_MEMCPY(dst_ptr, src_ptr, naUnitSize*count);
+/*************************************************
+ * Neighbor Array Unit Save
+ *   Logs the current content of the units that a
+ *   write of the block is about to overwrite
+ *************************************************/
+void neighbor_array_unit_save(
+    NeighborArrayUndoLog_t *undo_log_ptr,
+    NeighborArrayUnit_t    *na_unit_ptr,
+    uint32_t                origin_x,
+    uint32_t                origin_y,
+    uint32_t                bw,
+    uint32_t                bh,
+    uint32_t                neighbor_array_type_mask)
+{
+    uint32_t naOffset;
+    uint32_t naUnitSize = na_unit_ptr->unit_size;
 
+    if (neighbor_array_type_mask & NEIGHBOR_ARRAY_UNIT_TOP_MASK) {
+        naOffset = get_neighbor_array_unit_top_index(na_unit_ptr, origin_x);
+        neighbor_array_undo_push(
+            undo_log_ptr,
+            na_unit_ptr->topArray + naOffset * naUnitSize,
+            naUnitSize * (bw >> na_unit_ptr->granularityNormalLog2));
     }
 
     if (neighbor_array_type_mask & NEIGHBOR_ARRAY_UNIT_LEFT_MASK) {
-
-        naOffset = get_neighbor_array_unit_left_index(na_src, origin_y);
-        src_ptr = na_src->leftArray + naOffset * naUnitSize;
-        dst_ptr = na_dst->leftArray + naOffset * naUnitSize;
-        count = bh >> na_src->granularityNormalLog2;
-
-        EB_MEMCPY(dst_ptr, src_ptr, naUnitSize*count);
+        naOffset = get_neighbor_array_unit_left_index(na_unit_ptr, origin_y);
+        neighbor_array_undo_push(
+            undo_log_ptr,
+            na_unit_ptr->leftArray + naOffset * naUnitSize,
+            naUnitSize * (bh >> na_unit_ptr->granularityNormalLog2));
     }
 
     if (neighbor_array_type_mask & NEIGHBOR_ARRAY_UNIT_TOPLEFT_MASK) {
-
-        /*
-        //   Top-left Neighbor Array
-        //
-        //    4-5--6--7------------
-        //    3 \      \
-        //    2  \      \
-        //    1   \      \
-        //    |\   xxxxxx7
-        //    | \  x     6
-        //    |  \ x     5
-        //    |   \1x2x3x4
-        //    |
-        //
-        //  The top-left neighbor array is updated with the reversed samples
-        //    from the right column and bottom row of the source block
-        //
-        // Index = origin_x - origin_y
-        */
-
+        // Bottom-row + right-column, starting from the bottom-left corner
         naOffset = get_neighbor_array_unit_top_left_index(
-            na_src,
+            na_unit_ptr,
             origin_x,
             origin_y + (bh - 1));
-
-        // Copy bottom-row + right-column
-        // *Note - start from the bottom-left corner
-        src_ptr = na_src->topLeftArray + naOffset * naUnitSize;
-        dst_ptr = na_dst->topLeftArray + naOffset * naUnitSize;
-
-        count = ((bw + bh) >> na_src->granularityTopLeftLog2) - 1;
-
-        EB_MEMCPY(dst_ptr, src_ptr, naUnitSize*count);
+        neighbor_array_undo_push(
+            undo_log_ptr,
+            na_unit_ptr->topLeftArray + naOffset * naUnitSize,
+            naUnitSize * (((bw + bh) >> na_unit_ptr->granularityTopLeftLog2) - 1));
     }
 
     return;
 }
 
-void copy_neigh_arr_32(
-    NeighborArrayUnit32_t   *na_src,
-    NeighborArrayUnit32_t   *na_dst,
-    uint32_t               origin_x,
-    uint32_t               origin_y,
-    uint32_t               bw,
-    uint32_t               bh,
-    uint32_t                 neighbor_array_type_mask)
+void neighbor_array_unit_save32(
+    NeighborArrayUndoLog_t *undo_log_ptr,
+    NeighborArrayUnit32_t  *na_unit_ptr,
+    uint32_t                origin_x,
+    uint32_t                origin_y,
+    uint32_t                bw,
+    uint32_t                bh,
+    uint32_t                neighbor_array_type_mask)
 {
-
-    uint32_t idx;
-    uint32_t  *dst_ptr, *src_ptr;
-
-    uint32_t count;
     uint32_t naOffset;
-    uint32_t naUnitSize;
-
-    UNUSED(idx);
-
-    naUnitSize = na_src->unit_size;
+    uint32_t naUnitSize = na_unit_ptr->unit_size;
 
     if (neighbor_array_type_mask & NEIGHBOR_ARRAY_UNIT_TOP_MASK) {
-
-        naOffset = get_neighbor_array_unit_top_index32(na_src, origin_x);
-        src_ptr = na_src->topArray + naOffset;
-        dst_ptr = na_dst->topArray + naOffset;
-        count = bw >> na_src->granularityNormalLog2;
-
-        EB_MEMCPY(dst_ptr, src_ptr, naUnitSize*count);
-
+        naOffset = get_neighbor_array_unit_top_index32(na_unit_ptr, origin_x);
+        neighbor_array_undo_push(
+            undo_log_ptr,
+            (uint8_t*)(na_unit_ptr->topArray + naOffset),
+            naUnitSize * (bw >> na_unit_ptr->granularityNormalLog2));
     }
 
     if (neighbor_array_type_mask & NEIGHBOR_ARRAY_UNIT_LEFT_MASK) {
-
-        naOffset = get_neighbor_array_unit_left_index32(na_src, origin_y);
-        src_ptr = na_src->leftArray + naOffset;
-        dst_ptr = na_dst->leftArray + naOffset;
-        count = bh >> na_src->granularityNormalLog2;
-
-        EB_MEMCPY(dst_ptr, src_ptr, naUnitSize*count);
+        naOffset = get_neighbor_array_unit_left_index32(na_unit_ptr, origin_y);
+        neighbor_array_undo_push(
+            undo_log_ptr,
+            (uint8_t*)(na_unit_ptr->leftArray + naOffset),
+            naUnitSize * (bh >> na_unit_ptr->granularityNormalLog2));
     }
-    if (neighbor_array_type_mask & NEIGHBOR_ARRAY_UNIT_TOPLEFT_MASK) {
-
-
-
-        /*
-        //   Top-left Neighbor Array
-        //
-        //    4-5--6--7------------
-        //    3 \      \
-        //    2  \      \
-        //    1   \      \
-        //    |\   xxxxxx7
-        //    | \  x     6
-        //    |  \ x     5
-        //    |   \1x2x3x4
-        //    |
-        //
-        //  The top-left neighbor array is updated with the reversed samples
-        //    from the right column and bottom row of the source block
-        //
-        // Index = origin_x - origin_y
-        */
 
+    if (neighbor_array_type_mask & NEIGHBOR_ARRAY_UNIT_TOPLEFT_MASK) {
         naOffset = GetNeighborArrayUnitTopLeftIndex32(
-            na_src,
+            na_unit_ptr,
             origin_x,
             origin_y + (bh - 1));
+        neighbor_array_undo_push(
+            undo_log_ptr,
+            (uint8_t*)(na_unit_ptr->topLeftArray + naOffset),
+            naUnitSize * (((bw + bh) >> na_unit_ptr->granularityTopLeftLog2) - 1));
+    }
 
-        // Copy bottom-row + right-column
-        // *Note - start from the bottom-left corner
-        src_ptr = na_src->topLeftArray + naOffset;
-        dst_ptr = na_dst->topLeftArray + naOffset;
-
-        count = ((bw + bh) >> na_src->granularityTopLeftLog2) - 1;
+    return;
+}
 
-        EB_MEMCPY(dst_ptr, src_ptr, naUnitSize*count);
+/*************************************************
+ * Neighbor Array Undo
+ *   Restores the logged units, newest first, which
+ *   brings the arrays back to their state when the
+ *   log was empty. The log is emptied.
+ *************************************************/
+void neighbor_array_undo(
+    NeighborArrayUndoLog_t *undo_log_ptr)
+{
+    while (undo_log_ptr->entry_count) {
+        const NeighborArrayUndoEntry_t *entry_ptr = &undo_log_ptr->entries[--undo_log_ptr->entry_count];
+        undo_log_ptr->buffer_fill -= entry_ptr->size;
+        EB_MEMCPY(entry_ptr->dst_ptr, undo_log_ptr->buffer + undo_log_ptr->buffer_fill, entry_ptr->size);
     }
+
     return;
 }
 
@@ -150,24 +150,67 @@ extern "C" {
         uint32_t             block_width,
         uint32_t             block_height);
 
+    void update_recon_neighbor_array16bit(
+        NeighborArrayUnit_t *na_unit_ptr,
+        uint16_t            *src_ptr_top,
+        uint16_t            *src_ptr_left,
+        uint32_t             pic_origin_x,
+        uint32_t             pic_origin_y,
+        uint32_t             block_width,
+        uint32_t             block_height);
 
-    void copy_neigh_arr(
-        NeighborArrayUnit_t *na_src,
-        NeighborArrayUnit_t *na_dst,
-        uint32_t             origin_x,
-        uint32_t             origin_y,
-        uint32_t             bw,
-        uint32_t             bh,
-        uint32_t             neighbor_array_type_mask);
 
-    void copy_neigh_arr_32(
-        NeighborArrayUnit32_t *na_src,
-        NeighborArrayUnit32_t *na_dst,
-        uint32_t               origin_x,
-        uint32_t               origin_y,
-        uint32_t               bw,
-        uint32_t               bh,
-        uint32_t               neighbor_array_type_mask);
+    /**************************************
+     * Neighbor Array Undo Log
+     *   Keeps the overwritten units of a set of
+     *   arrays so that tentative writes can be
+     *   rolled back at the cost of what changed.
+     *   A save logs up to NEIGHBOR_ARRAY_UNDO_REGIONS
+     *   entries (top, left and top-left).
+     **************************************/
+#define NEIGHBOR_ARRAY_UNDO_REGIONS     3
+
+    typedef struct NeighborArrayUndoEntry_s
+    {
+        uint8_t   *dst_ptr;
+        uint32_t   size;
+    } NeighborArrayUndoEntry_t;
+
+    typedef struct NeighborArrayUndoLog_s
+    {
+        uint8_t                   *buffer;
+        uint32_t                   buffer_size;
+        uint32_t                   buffer_fill;
+        NeighborArrayUndoEntry_t  *entries;
+        uint32_t                   max_entry_count;
+        uint32_t                   entry_count;
+    } NeighborArrayUndoLog_t;
+
+    extern EbErrorType neighbor_array_undo_log_ctor(
+        NeighborArrayUndoLog_t **undo_log_dbl_ptr,
+        uint32_t                 buffer_size,
+        uint32_t                 max_entry_count);
+
+    void neighbor_array_unit_save(
+        NeighborArrayUndoLog_t *undo_log_ptr,
+        NeighborArrayUnit_t    *na_unit_ptr,
+        uint32_t                origin_x,
+        uint32_t                origin_y,
+        uint32_t                bw,
+        uint32_t                bh,
+        uint32_t                neighbor_array_type_mask);
+
+    void neighbor_array_unit_save32(
+        NeighborArrayUndoLog_t *undo_log_ptr,
+        NeighborArrayUnit32_t  *na_unit_ptr,
+        uint32_t                origin_x,
+        uint32_t                origin_y,
+        uint32_t                bw,
+        uint32_t                bh,
+        uint32_t                neighbor_array_type_mask);
+
+    void neighbor_array_undo(
+        NeighborArrayUndoLog_t *undo_log_ptr);
 
     extern void neighbor_array_unit16bit_sample_write(
         NeighborArrayUnit_t *na_unit_ptr,
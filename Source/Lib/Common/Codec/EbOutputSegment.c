@@ -0,0 +1,171 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "EbOutputSegment.h"
+#include "EbThreads.h"
+#include "EbUtility.h"
+
+EbErrorType output_segment_pool_ctor(
+    OutputSegmentPool_t **pool_dbl_ptr,
+    uint32_t              segment_size)
+{
+    OutputSegmentPool_t *pool_ptr;
+
+    EB_MALLOC(OutputSegmentPool_t*, pool_ptr, sizeof(OutputSegmentPool_t), EB_N_PTR);
+    *pool_dbl_ptr = pool_ptr;
+
+    pool_ptr->free_list = (OutputSegment_t*)EB_NULL;
+    pool_ptr->alloc_list = (OutputSegment_t*)EB_NULL;
+    pool_ptr->segment_size = segment_size;
+    EB_CREATEMUTEX(EbHandle, pool_ptr->mutex, sizeof(EbHandle), EB_MUTEX);
+
+    return EB_ErrorNone;
+}
+
+void output_segment_pool_dtor(
+    OutputSegmentPool_t  *pool_ptr)
+{
+    OutputSegment_t *segment_ptr;
+
+    while (pool_ptr->alloc_list != EB_NULL) {
+        segment_ptr = pool_ptr->alloc_list;
+        pool_ptr->alloc_list = segment_ptr->alloc_next;
+        free(segment_ptr);
+    }
+    pool_ptr->free_list = (OutputSegment_t*)EB_NULL;
+}
+
+// Called with the pool mutex held. Segments are owned by the pool and freed by
+// output_segment_pool_dtor(), not by the library memory map.
+static EbErrorType output_segment_alloc(
+    OutputSegmentPool_t  *pool_ptr,
+    OutputSegment_t     **segment_dbl_ptr)
+{
+    OutputSegment_t *segment_ptr;
+
+    // The storage follows the descriptor in the same block
+    segment_ptr = (OutputSegment_t*)malloc(sizeof(OutputSegment_t) + OUTPUT_SEGMENT_HEADROOM + pool_ptr->segment_size);
+    if (segment_ptr == EB_NULL)
+        return EB_ErrorInsufficientResources;
+    segment_ptr->buffer = (uint8_t*)(segment_ptr + 1);
+    segment_ptr->pool = pool_ptr;
+    segment_ptr->alloc_next = pool_ptr->alloc_list;
+    pool_ptr->alloc_list = segment_ptr;
+    *segment_dbl_ptr = segment_ptr;
+
+    return EB_ErrorNone;
+}
+
+/**************************************
+ * Takes an empty segment from the pool,
+ * allocating one when none is free
+ **************************************/
+static EbErrorType output_segment_get(
+    OutputSegmentPool_t  *pool_ptr,
+    OutputSegment_t     **segment_dbl_ptr)
+{
+    EbErrorType return_error = EB_ErrorNone;
+
+    eb_block_on_mutex(pool_ptr->mutex);
+    *segment_dbl_ptr = pool_ptr->free_list;
+    if (*segment_dbl_ptr != EB_NULL)
+        pool_ptr->free_list = (OutputSegment_t*)(*segment_dbl_ptr)->segment.next;
+    else
+        return_error = output_segment_alloc(pool_ptr, segment_dbl_ptr);
+    eb_release_mutex(pool_ptr->mutex);
+
+    if (return_error == EB_ErrorNone) {
+        (*segment_dbl_ptr)->segment.data = (*segment_dbl_ptr)->buffer + OUTPUT_SEGMENT_HEADROOM;
+        (*segment_dbl_ptr)->segment.filled_len = 0;
+        (*segment_dbl_ptr)->segment.next = (EbOutputSegment*)EB_NULL;
+    }
+    return return_error;
+}
+
+EbErrorType output_packet_append(
+    OutputSegmentPool_t *pool_ptr,
+    EbBufferHeaderType  *packet_ptr,
+    const uint8_t       *data,
+    uint32_t             size)
+{
+    EbErrorType      return_error = EB_ErrorNone;
+    EbOutputSegment *last_ptr = (EbOutputSegment*)packet_ptr->p_buffer;
+    OutputSegment_t *segment_ptr;
+    uint32_t         room;
+    uint32_t         copy_size;
+
+    while (last_ptr != EB_NULL && last_ptr->next != EB_NULL)
+        last_ptr = last_ptr->next;
+
+    while (size) {
+        segment_ptr = (OutputSegment_t*)last_ptr;
+        room = last_ptr ?
+            (uint32_t)(segment_ptr->buffer + OUTPUT_SEGMENT_HEADROOM + pool_ptr->segment_size - (last_ptr->data + last_ptr->filled_len)) :
+            0;
+        if (room == 0) {
+            return_error = output_segment_get(pool_ptr, &segment_ptr);
+            if (return_error != EB_ErrorNone)
+                return return_error;
+            if (last_ptr)
+                last_ptr->next = &segment_ptr->segment;
+            else
+                packet_ptr->p_buffer = (uint8_t*)&segment_ptr->segment;
+            last_ptr = &segment_ptr->segment;
+            room = pool_ptr->segment_size;
+        }
+        copy_size = MIN(size, room);
+        EB_MEMCPY(last_ptr->data + last_ptr->filled_len, (void*)data, copy_size);
+        last_ptr->filled_len += copy_size;
+        packet_ptr->n_filled_len += copy_size;
+        data += copy_size;
+        size -= copy_size;
+    }
+
+    return return_error;
+}
+
+EbErrorType output_packet_prepend(
+    EbBufferHeaderType  *packet_ptr,
+    const uint8_t       *data,
+    uint32_t             size)
+{
+    EbOutputSegment *first_ptr = (EbOutputSegment*)packet_ptr->p_buffer;
+
+    if (first_ptr == EB_NULL ||
+        first_ptr->data - ((OutputSegment_t*)first_ptr)->buffer < (ptrdiff_t)size)
+        return EB_ErrorInsufficientResources;
+
+    first_ptr->data -= size;
+    first_ptr->filled_len += size;
+    packet_ptr->n_filled_len += size;
+    EB_MEMCPY(first_ptr->data, (void*)data, size);
+
+    return EB_ErrorNone;
+}
+
+void output_packet_release(
+    EbBufferHeaderType  *packet_ptr)
+{
+    OutputSegment_t     *first_ptr = (OutputSegment_t*)packet_ptr->p_buffer;
+    OutputSegment_t     *last_ptr = first_ptr;
+
+    if (first_ptr == EB_NULL)
+        return;
+
+    while (last_ptr->segment.next != EB_NULL)
+        last_ptr = (OutputSegment_t*)last_ptr->segment.next;
+
+    // The whole chain goes back at once
+    eb_block_on_mutex(first_ptr->pool->mutex);
+    last_ptr->segment.next = (EbOutputSegment*)first_ptr->pool->free_list;
+    first_ptr->pool->free_list = first_ptr;
+    eb_release_mutex(first_ptr->pool->mutex);
+
+    packet_ptr->p_buffer = (uint8_t*)EB_NULL;
+    packet_ptr->n_filled_len = 0;
+}
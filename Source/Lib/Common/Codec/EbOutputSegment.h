@@ -0,0 +1,69 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#ifndef EbOutputSegment_h
+#define EbOutputSegment_h
+
+#include "EbDefinitions.h"
+#include "EbSvtAv1Enc.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define OUTPUT_SEGMENT_SIZE             0x4000  // Payload bytes per segment
+#define OUTPUT_SEGMENT_HEADROOM         8       // Room in front of a packet's first segment for a TD
+
+    struct OutputSegmentPool_s;
+
+    typedef struct OutputSegment_s {
+        EbOutputSegment                  segment;   // Public part, handed to the application
+        uint8_t                         *buffer;    // Start of the storage, headroom included
+        struct OutputSegmentPool_s      *pool;
+        struct OutputSegment_s          *alloc_next; // Chains every segment of the pool, free or in use
+    } OutputSegment_t;
+
+    /**************************************
+     * Output Segment Pool
+     *   Segments of all the output packets are taken from a single pool. The
+     *   pool only grows to the number of segments in flight and is shared by
+     *   the Packetization process and the application (on release). The
+     *   segments are freed by output_segment_pool_dtor() at deinit.
+     **************************************/
+    typedef struct OutputSegmentPool_s {
+        EbHandle                         mutex;
+        OutputSegment_t                 *free_list;
+        OutputSegment_t                 *alloc_list;
+        uint32_t                         segment_size;
+    } OutputSegmentPool_t;
+
+    extern EbErrorType output_segment_pool_ctor(
+        OutputSegmentPool_t            **pool_dbl_ptr,
+        uint32_t                         segment_size);
+
+    // Frees every segment of the pool, including the ones of unreleased packets
+    extern void output_segment_pool_dtor(
+        OutputSegmentPool_t             *pool_ptr);
+
+    // Appends size bytes to the packet, chaining new segments as needed
+    extern EbErrorType output_packet_append(
+        OutputSegmentPool_t             *pool_ptr,
+        EbBufferHeaderType              *packet_ptr,
+        const uint8_t                   *data,
+        uint32_t                         size);
+
+    // Inserts size bytes (at most OUTPUT_SEGMENT_HEADROOM) in front of the packet
+    extern EbErrorType output_packet_prepend(
+        EbBufferHeaderType              *packet_ptr,
+        const uint8_t                   *data,
+        uint32_t                         size);
+
+    // Returns the segments of the packet to their pool
+    extern void output_packet_release(
+        EbBufferHeaderType              *packet_ptr);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // EbOutputSegment_h
@@ -14,6 +14,7 @@
 #include "EbEntropyCoding.h"
 #include "EbRateControlTasks.h"
 #include "EbSvtAv1Time.h"
+#include "EbSvtAv1ErrorCodes.h"
 #if RC
 #include "EbModeDecisionProcess.h"
 #endif
@@ -51,38 +52,39 @@ EbErrorType packetization_context_ctor(
     return EB_ErrorNone;
 }
 #define TD_SIZE                     2
-#define OBU_FRAME_HEADER_SIZE       3
-#define TILES_GROUP_SIZE            1
 
-// Write TD after offsetting the stream buffer 
-static void write_td (
+// Appends data to the output packet, which grows by segments as needed
+static void append_payload(
+    EncodeContext_t     *encode_context_ptr,
     EbBufferHeaderType  *out_str_ptr,
-    EbBool               show_ex,
-    EbBool               has_tiles){
-
-    uint8_t  td_buff[TD_SIZE] = { 0,0 };
-    uint8_t  obu_frame_header_size = has_tiles ? OBU_FRAME_HEADER_SIZE + TILES_GROUP_SIZE : OBU_FRAME_HEADER_SIZE;
-    if (out_str_ptr &&
-        (out_str_ptr->n_alloc_len > (out_str_ptr->n_filled_len + 2))) {
-
-        uint8_t *src_address = (show_ex == EB_FALSE) ?  out_str_ptr->p_buffer :
-                out_str_ptr->p_buffer + out_str_ptr->n_filled_len - (obu_frame_header_size);
-
-        uint8_t *dst_address = src_address + TD_SIZE;
-
-        uint32_t move_size   = (show_ex == EB_FALSE) ? out_str_ptr->n_filled_len :
-                               (obu_frame_header_size);
+    const uint8_t       *data,
+    uint32_t             size){
+
+    EbErrorType return_error = output_packet_append(
+        encode_context_ptr->output_segment_pool,
+        out_str_ptr,
+        data,
+        size);
+
+    CHECK_REPORT_ERROR(
+        (return_error == EB_ErrorNone),
+        encode_context_ptr->app_callback_ptr,
+        EB_ENC_EC_ERROR2);
+}
 
-        memmove(dst_address,
-                src_address,
-                move_size);
+// Appends the headers written in the packetization bitstream to the output packet
+static void append_bitstream(
+    EncodeContext_t     *encode_context_ptr,
+    EbBufferHeaderType  *out_str_ptr,
+    Bitstream_t         *bitstream_ptr){
 
-        encode_td_av1((uint8_t*)(&td_buff));
+    OutputBitstreamUnit_t *output_bitstream_ptr = (OutputBitstreamUnit_t*)bitstream_ptr->outputBitstreamPtr;
 
-        EB_MEMCPY(src_address,
-                  &td_buff, 
-                  TD_SIZE);
-    }
+    append_payload(
+        encode_context_ptr,
+        out_str_ptr,
+        output_bitstream_ptr->bufferBeginAv1,
+        (uint32_t)(output_bitstream_ptr->bufferAv1 - output_bitstream_ptr->bufferBeginAv1));
 }
 #if  RC
 
@@ -237,6 +239,83 @@ void update_rc_rate_tables(
     }
 }
 #endif
+
+/******************************************************
+ * Deadline Control
+ * Closed-loop update of the ME and MD speed levels from the
+ * measured time per output picture. The levels are moved by
+ * at most one step every DL_FRAMES_INTERVAL pictures, on the
+ * stage that takes the most (speed up) or the least (slow
+ * down) time, and are sampled by the Resource Coordination
+ * process for the next input pictures.
+ ******************************************************/
+static void DeadlineControl(
+    SequenceControlSet         *sequence_control_set_ptr,
+    PictureParentControlSet_t  *picture_control_set_ptr)
+{
+    EncodeContext_t *encode_context_ptr = sequence_control_set_ptr->encode_context_ptr;
+    uint32_t         frame_rate = sequence_control_set_ptr->static_config.frame_rate;
+    // Target time per picture in ms (frame_rate is in Q16 when higher than 1000)
+    double           frame_period = (frame_rate > 1000) ? 1000.0 * (1 << 16) / frame_rate : 1000.0 / frame_rate;
+    double           frame_time = 0;
+    double           me_load;
+    double           md_load;
+    uint64_t         out_seconds;
+    uint64_t         out_u_seconds;
+
+    EbFinishTime(&out_seconds, &out_u_seconds);
+
+    eb_block_on_mutex(encode_context_ptr->sc_buffer_mutex);
+
+    if (encode_context_ptr->dl_frame_out == 0) {
+        encode_context_ptr->dl_me_time = picture_control_set_ptr->dl_me_time;
+        encode_context_ptr->dl_md_time = picture_control_set_ptr->dl_md_time;
+    }
+    else {
+        EbComputeOverallElapsedTimeMs(
+            encode_context_ptr->dl_prev_out_seconds,
+            encode_context_ptr->dl_prev_out_u_seconds,
+            out_seconds,
+            out_u_seconds,
+            &frame_time);
+
+        encode_context_ptr->dl_frame_time = (encode_context_ptr->dl_frame_out == 1) ?
+            frame_time :
+            encode_context_ptr->dl_frame_time + (frame_time - encode_context_ptr->dl_frame_time) / (1 << DL_EMA_SHIFT);
+        encode_context_ptr->dl_me_time += (picture_control_set_ptr->dl_me_time - encode_context_ptr->dl_me_time) / (1 << DL_EMA_SHIFT);
+        encode_context_ptr->dl_md_time += (picture_control_set_ptr->dl_md_time - encode_context_ptr->dl_md_time) / (1 << DL_EMA_SHIFT);
+    }
+    encode_context_ptr->dl_prev_out_seconds = out_seconds;
+    encode_context_ptr->dl_prev_out_u_seconds = out_u_seconds;
+    encode_context_ptr->dl_frame_out++;
+
+    if (encode_context_ptr->dl_frame_out >= DL_FRAMES_TO_IGNORE &&
+        encode_context_ptr->dl_frame_out >= encode_context_ptr->dl_last_update_frame_out + DL_FRAMES_INTERVAL) {
+
+        // Wall-clock time per picture of each stage, assuming its threads run in parallel
+        me_load = encode_context_ptr->dl_me_time / MAX(1, sequence_control_set_ptr->motion_estimation_process_init_count);
+        md_load = encode_context_ptr->dl_md_time / MAX(1, sequence_control_set_ptr->enc_dec_process_init_count);
+
+        if (encode_context_ptr->dl_frame_time * 1000 > frame_period * DL_SPEED_UP_TH) {
+            // Behind the deadline: speed up the slowest stage
+            if ((me_load >= md_load || encode_context_ptr->dl_md_level == DL_MAX_SPEED_LEVEL) && encode_context_ptr->dl_me_level < DL_MAX_SPEED_LEVEL)
+                encode_context_ptr->dl_me_level++;
+            else if (encode_context_ptr->dl_md_level < DL_MAX_SPEED_LEVEL)
+                encode_context_ptr->dl_md_level++;
+        }
+        else if (MIN(encode_context_ptr->dl_frame_time, MAX(me_load, md_load)) * 1000 < frame_period * DL_SLOW_DOWN_TH) {
+            // Ahead of the deadline (offline: output rate, live: stage load): give back quality to the fastest stage
+            if ((md_load <= me_load || encode_context_ptr->dl_me_level == 0) && encode_context_ptr->dl_md_level > 0)
+                encode_context_ptr->dl_md_level--;
+            else if (encode_context_ptr->dl_me_level > 0)
+                encode_context_ptr->dl_me_level--;
+        }
+        encode_context_ptr->dl_last_update_frame_out = encode_context_ptr->dl_frame_out;
+    }
+
+    eb_release_mutex(encode_context_ptr->sc_buffer_mutex);
+}
+
 void* PacketizationKernel(void *input_ptr)
 {
     // Context
@@ -295,6 +374,7 @@ void* PacketizationKernel(void *input_ptr)
         output_stream_ptr = (EbBufferHeaderType*)output_stream_wrapper_ptr->object_ptr;
         output_stream_ptr->flags = 0;
         output_stream_ptr->flags |= (encode_context_ptr->terminating_sequence_flag_received == EB_TRUE && picture_control_set_ptr->parent_pcs_ptr->decode_order == encode_context_ptr->terminating_picture_number) ? EB_BUFFERFLAG_EOS : 0;
+        output_stream_ptr->p_buffer = (uint8_t*)EB_NULL;
         output_stream_ptr->n_filled_len = 0;
         output_stream_ptr->pts = picture_control_set_ptr->parent_pcs_ptr->input_ptr->pts;
         output_stream_ptr->dts = picture_control_set_ptr->parent_pcs_ptr->decode_order - (uint64_t)(1 << picture_control_set_ptr->parent_pcs_ptr->hierarchical_levels) + 1;
@@ -303,6 +383,25 @@ void* PacketizationKernel(void *input_ptr)
             picture_control_set_ptr->slice_type : EB_AV1_NON_REF_PICTURE;
         output_stream_ptr->p_app_private = picture_control_set_ptr->parent_pcs_ptr->input_ptr->p_app_private;
 
+        // Picture quality, computed by the Stat process while Entropy Coding ran
+        if (sequence_control_set_ptr->static_config.stat_report) {
+            eb_block_on_semaphore(picture_control_set_ptr->parent_pcs_ptr->stat_done_semaphore);
+            output_stream_ptr->luma_sse = picture_control_set_ptr->parent_pcs_ptr->luma_sse;
+            output_stream_ptr->cr_sse = picture_control_set_ptr->parent_pcs_ptr->cr_sse;
+            output_stream_ptr->cb_sse = picture_control_set_ptr->parent_pcs_ptr->cb_sse;
+            output_stream_ptr->luma_ssim = picture_control_set_ptr->parent_pcs_ptr->luma_ssim;
+            output_stream_ptr->cr_ssim = picture_control_set_ptr->parent_pcs_ptr->cr_ssim;
+            output_stream_ptr->cb_ssim = picture_control_set_ptr->parent_pcs_ptr->cb_ssim;
+        }
+        else {
+            output_stream_ptr->luma_sse = 0;
+            output_stream_ptr->cr_sse = 0;
+            output_stream_ptr->cb_sse = 0;
+            output_stream_ptr->luma_ssim = 0;
+            output_stream_ptr->cr_ssim = 0;
+            output_stream_ptr->cb_ssim = 0;
+        }
+
         // Get Empty Rate Control Input Tasks
         eb_get_empty_object(
             context_ptr->rate_control_tasks_output_fifo_ptr,
@@ -329,14 +428,24 @@ void* PacketizationKernel(void *input_ptr)
             picture_control_set_ptr,
             0);
 
-        // Copy Slice Header to the Output Bitstream
-        CopyRbspBitstreamToPayload(
-            picture_control_set_ptr->bitstreamPtr,
-            output_stream_ptr->p_buffer,
-            (uint32_t*) &(output_stream_ptr->n_filled_len),
-            (uint32_t*) &(output_stream_ptr->n_alloc_len),
-            encode_context_ptr);
+        // Copy the headers then the tile data to the output packet. The tile data is taken
+        // from the entropy coder buffer, which is recycled with the picture control set.
+        append_bitstream(
+            encode_context_ptr,
+            output_stream_ptr,
+            picture_control_set_ptr->bitstreamPtr);
+        {
+            uint8_t  *tile_data;
+            uint32_t  tile_data_size = GetTileDataAv1(picture_control_set_ptr, &tile_data);
+            append_payload(
+                encode_context_ptr,
+                output_stream_ptr,
+                tile_data,
+                tile_data_size);
+        }
         if (picture_control_set_ptr->parent_pcs_ptr->hasShowExisting) {
+            uint8_t td_buff[TD_SIZE] = { 0,0 };
+
             // Reset the bitstream before writing to it
             ResetBitstream(
                 picture_control_set_ptr->bitstreamPtr->outputBitstreamPtr);
@@ -346,13 +455,17 @@ void* PacketizationKernel(void *input_ptr)
                 picture_control_set_ptr,
                 1);
 
-            // Copy Slice Header to the Output Bitstream
-            CopyRbspBitstreamToPayload(
-                picture_control_set_ptr->bitstreamPtr,
-                output_stream_ptr->p_buffer,
-                (uint32_t*)&(output_stream_ptr->n_filled_len),
-                (uint32_t*)&(output_stream_ptr->n_alloc_len),
-                encode_context_ptr);
+            // The shown existing frame is a temporal unit of its own
+            encode_td_av1((uint8_t*)(&td_buff));
+            append_payload(
+                encode_context_ptr,
+                output_stream_ptr,
+                td_buff,
+                TD_SIZE);
+            append_bitstream(
+                encode_context_ptr,
+                output_stream_ptr,
+                picture_control_set_ptr->bitstreamPtr);
 
             output_stream_ptr->flags |= EB_BUFFERFLAG_SHOW_EXT;
 
@@ -362,7 +475,7 @@ void* PacketizationKernel(void *input_ptr)
         }
 
         // Send the number of bytes per frame to RC
-        picture_control_set_ptr->parent_pcs_ptr->total_num_bits = output_stream_ptr->n_filled_len << 3;
+        picture_control_set_ptr->parent_pcs_ptr->total_num_bits = (output_stream_ptr->n_filled_len - (picture_control_set_ptr->parent_pcs_ptr->hasShowExisting ? TD_SIZE : 0)) << 3;
 #if  RC
         queueEntryPtr->total_num_bits = picture_control_set_ptr->parent_pcs_ptr->total_num_bits;
         // update the rate tables used in RC based on the encoded bits of each sb
@@ -409,6 +522,12 @@ void* PacketizationKernel(void *input_ptr)
             eb_release_mutex(encode_context_ptr->sc_buffer_mutex);
         }
 
+        if (sequence_control_set_ptr->static_config.deadline_mode) {
+            DeadlineControl(
+                sequence_control_set_ptr,
+                picture_control_set_ptr->parent_pcs_ptr);
+        }
+
         // Post Rate Control Taks
         eb_post_full_object(rateControlTasksWrapperPtr);
 
@@ -426,20 +545,16 @@ void* PacketizationKernel(void *input_ptr)
         queueEntryPtr = encode_context_ptr->packetization_reorder_queue[encode_context_ptr->packetization_reorder_queue_head_index];
 
         while (queueEntryPtr->output_stream_wrapper_ptr != EB_NULL) {
-            EbBool has_tiles = (EbBool)(sequence_control_set_ptr->static_config.tile_columns || sequence_control_set_ptr->static_config.tile_rows);
             output_stream_wrapper_ptr = queueEntryPtr->output_stream_wrapper_ptr;
             output_stream_ptr = (EbBufferHeaderType*)output_stream_wrapper_ptr->object_ptr;
 
-            if (queueEntryPtr->hasShowExisting) {
-                write_td(output_stream_ptr, EB_TRUE, has_tiles);
-                output_stream_ptr->n_filled_len += TD_SIZE;
-            }
-
             if (encode_context_ptr->td_needed == EB_TRUE){
+                uint8_t td_buff[TD_SIZE] = { 0,0 };
                 output_stream_ptr->flags |= (uint32_t)EB_BUFFERFLAG_HAS_TD;
-                write_td(output_stream_ptr, EB_FALSE, has_tiles);
+                encode_td_av1((uint8_t*)(&td_buff));
+                // Goes in the headroom of the first segment
+                output_packet_prepend(output_stream_ptr, td_buff, TD_SIZE);
                 encode_context_ptr->td_needed = EB_FALSE;
-                output_stream_ptr->n_filled_len += TD_SIZE;
             }
 
             if (queueEntryPtr->hasShowExisting || queueEntryPtr->showFrame)
@@ -11,6 +11,7 @@
 #include "EbPictureControlSet.h"
 #include "EbSequenceControlSet.h"
 #include "EbPictureBufferDesc.h"
+#include "EbPictureOperators.h"
 
 #include "EbResourceCoordinationResults.h"
 #include "EbPictureAnalysisProcess.h"
@@ -23,6 +24,7 @@
 #include "EbMeSadCalculation.h"
 #include "EbComputeMean_SSE2.h"
 #include "EbCombinedAveragingSAD_Intrinsic_AVX2.h"
+#include "EbPictureOperators_AVX2.h"
 
 #define VARIANCE_PRECISION        16
 #define  LCU_LOW_VAR_TH                5
@@ -38,6 +40,25 @@
 #define SAMPLE_THRESHOLD_PRECENT_BORDER_LINE      15
 #define SAMPLE_THRESHOLD_PRECENT_TWO_BORDER_LINES 10
 
+typedef void(*EB_DECIMATION_2D_FUNC)(
+    uint8_t  *input_samples,
+    uint32_t  input_stride,
+    uint32_t  input_area_width,
+    uint32_t  input_area_height,
+    uint8_t  *decim_samples,
+    uint32_t  decim_stride,
+    uint32_t  decim_step);
+
+static const EB_DECIMATION_2D_FUNC Decimation2DFunc[ASM_TYPE_TOTAL] = {
+    // NON_AVX2
+    Decimation2D,
+    // AVX2
+    decimation_2d_avx2_intrin
+};
+
+#define SEGMENT_HISTOGRAM(histogram, region_x, region_y, component) \
+    (&(histogram)[(((region_x) * MAX_NUMBER_OF_REGIONS_IN_HEIGHT + (region_y)) * 3 + (component)) * HISTOGRAM_NUMBER_OF_BINS])
+
 /************************************************
 * Picture Analysis Context Constructor
 ************************************************/
@@ -55,6 +76,8 @@ EbErrorType picture_analysis_context_ctor(
     context_ptr->resource_coordination_results_input_fifo_ptr = resource_coordination_results_input_fifo_ptr;
     context_ptr->picture_analysis_results_output_fifo_ptr = picture_analysis_results_output_fifo_ptr;
 
+    EB_MALLOC(uint32_t*, context_ptr->segment_histogram, sizeof(uint32_t) * MAX_NUMBER_OF_REGIONS_IN_WIDTH * MAX_NUMBER_OF_REGIONS_IN_HEIGHT * 3 * HISTOGRAM_NUMBER_OF_BINS, EB_N_PTR);
+
     EbErrorType return_error = EB_ErrorNone;
 
     if (denoise_flag == EB_TRUE) {
@@ -99,7 +122,10 @@ EbErrorType picture_analysis_context_ctor(
 
 }
 
-static void DownSampleChroma(EbPictureBufferDesc_t* input_picture_ptr, EbPictureBufferDesc_t* outputPicturePtr)
+/************************************************
+ * 422/444 => 420 conversion of the luma rows [row_start, row_end)
+ ************************************************/
+static void DownSampleChroma(EbPictureBufferDesc_t* input_picture_ptr, EbPictureBufferDesc_t* outputPicturePtr, uint32_t row_start, uint32_t row_end)
 {
 	uint32_t input_color_format = input_picture_ptr->color_format;
 	const uint16_t input_subsampling_x = (input_color_format == EB_YUV444 ? 1 : 2) - 1;
@@ -129,7 +155,7 @@ static void DownSampleChroma(EbPictureBufferDesc_t* input_picture_ptr, EbPicture
             (outputPicturePtr->origin_y >> output_subsampling_y)  * outputPicturePtr->strideCb;
 		ptrOut = &(outputPicturePtr->bufferCb[outputOriginIndex]);
 
-		for (jj = 0; jj < (uint32_t)(outputPicturePtr->height >> output_subsampling_y); jj++) {
+		for (jj = row_start >> output_subsampling_y; jj < (row_end >> output_subsampling_y); jj++) {
 			for (ii = 0; ii < (uint32_t)(outputPicturePtr->width >> output_subsampling_x); ii++) {
 				ptrOut[ii + jj * strideOut] =
                     ptrIn[(ii << (1 - input_subsampling_x)) +
@@ -149,7 +175,7 @@ static void DownSampleChroma(EbPictureBufferDesc_t* input_picture_ptr, EbPicture
 		outputOriginIndex = (outputPicturePtr->origin_x >> output_subsampling_x) + (outputPicturePtr->origin_y >> output_subsampling_y)  * outputPicturePtr->strideCr;
 		ptrOut = &(outputPicturePtr->bufferCr[outputOriginIndex]);
 
-		for (jj = 0; jj < (uint32_t)(outputPicturePtr->height >> output_subsampling_y); jj++) {
+		for (jj = row_start >> output_subsampling_y; jj < (row_end >> output_subsampling_y); jj++) {
 			for (ii = 0; ii < (uint32_t)(outputPicturePtr->width >> output_subsampling_x); ii++) {
 				ptrOut[ii + jj * strideOut] =
                     ptrIn[(ii << (1 - input_subsampling_x)) +
@@ -3398,14 +3424,95 @@ static int32_t apply_denoise_2d(SequenceControlSet        *scsPtr,
     EbAsm asm_type) {
 
 
+    // Between two estimations the picture is only denoised, Picture Decision
+    // then hands it the grain of the last estimated picture
+    pcsPtr->film_grain_params_estimated = (EbBool)(scsPtr->film_grain_update_period <= 1 ||
+        pcsPtr->picture_number % scsPtr->film_grain_update_period == 0);
+
     if (aom_denoise_and_model_run(pcsPtr->denoise_and_model, inputPicturePointer,
         &pcsPtr->film_grain_params,
-        scsPtr->static_config.encoder_bit_depth > EB_8BIT, asm_type)) {
+        scsPtr->static_config.encoder_bit_depth > EB_8BIT,
+        pcsPtr->film_grain_params_estimated,
+        scsPtr->encode_context_ptr->worker_pool,
+        asm_type)) {
     }
     return 0;
 }
 
 
+/************************************************
+ * Keeps the source the stat report measures against,
+ * the denoise below overwrites the input picture
+ ************************************************/
+static void save_source_picture(
+    SequenceControlSet        *sequence_control_set_ptr,
+    PictureParentControlSet_t   *picture_control_set_ptr,
+    EbAsm asm_type)
+{
+    EbPictureBufferDesc_t *input_picture_ptr = picture_control_set_ptr->enhanced_picture_ptr;
+    EbPictureBufferDesc_t *save_picture_ptr = picture_control_set_ptr->save_source_picture_ptr;
+    const uint32_t width = input_picture_ptr->width;
+    const uint32_t height = input_picture_ptr->height;
+    const uint32_t inputLumaOffset = (input_picture_ptr->origin_y * input_picture_ptr->stride_y) + input_picture_ptr->origin_x;
+    const uint32_t inputCbOffset = ((input_picture_ptr->origin_y >> 1) * input_picture_ptr->strideCb) + (input_picture_ptr->origin_x >> 1);
+    const uint32_t inputCrOffset = ((input_picture_ptr->origin_y >> 1) * input_picture_ptr->strideCr) + (input_picture_ptr->origin_x >> 1);
+    const uint32_t saveLumaOffset = (save_picture_ptr->origin_y * save_picture_ptr->stride_y) + save_picture_ptr->origin_x;
+    const uint32_t saveCbOffset = ((save_picture_ptr->origin_y >> 1) * save_picture_ptr->strideCb) + (save_picture_ptr->origin_x >> 1);
+    const uint32_t saveCrOffset = ((save_picture_ptr->origin_y >> 1) * save_picture_ptr->strideCr) + (save_picture_ptr->origin_x >> 1);
+
+    save_picture_ptr->width = (uint16_t)width;
+    save_picture_ptr->height = (uint16_t)height;
+
+    if (sequence_control_set_ptr->static_config.encoder_bit_depth > EB_8BIT) {
+        // Same packing as the denoise uses on this picture
+        const uint32_t inputBitIncLumaOffset = (input_picture_ptr->origin_y * input_picture_ptr->strideBitIncY) + input_picture_ptr->origin_x;
+        const uint32_t inputBitIncCbOffset = ((input_picture_ptr->origin_y >> 1) * input_picture_ptr->strideBitIncCb) + (input_picture_ptr->origin_x >> 1);
+        const uint32_t inputBitIncCrOffset = ((input_picture_ptr->origin_y >> 1) * input_picture_ptr->strideBitIncCr) + (input_picture_ptr->origin_x >> 1);
+
+        pack2d_src(
+            input_picture_ptr->buffer_y + inputLumaOffset,
+            input_picture_ptr->stride_y,
+            input_picture_ptr->bufferBitIncY + inputBitIncLumaOffset,
+            input_picture_ptr->strideBitIncY,
+            (uint16_t *)save_picture_ptr->buffer_y + saveLumaOffset,
+            save_picture_ptr->stride_y,
+            width,
+            height,
+            asm_type);
+
+        pack2d_src(
+            input_picture_ptr->bufferCb + inputCbOffset,
+            input_picture_ptr->strideCb,
+            input_picture_ptr->bufferBitIncCb + inputBitIncCbOffset,
+            input_picture_ptr->strideBitIncCb,
+            (uint16_t *)save_picture_ptr->bufferCb + saveCbOffset,
+            save_picture_ptr->strideCb,
+            width >> 1,
+            height >> 1,
+            asm_type);
+
+        pack2d_src(
+            input_picture_ptr->bufferCr + inputCrOffset,
+            input_picture_ptr->strideCr,
+            input_picture_ptr->bufferBitIncCr + inputBitIncCrOffset,
+            input_picture_ptr->strideBitIncCr,
+            (uint16_t *)save_picture_ptr->bufferCr + saveCrOffset,
+            save_picture_ptr->strideCr,
+            width >> 1,
+            height >> 1,
+            asm_type);
+    }
+    else {
+        uint32_t row;
+        for (row = 0; row < height; ++row)
+            EB_MEMCPY(save_picture_ptr->buffer_y + saveLumaOffset + row * save_picture_ptr->stride_y, input_picture_ptr->buffer_y + inputLumaOffset + row * input_picture_ptr->stride_y, width);
+        for (row = 0; row < (height >> 1); ++row) {
+            EB_MEMCPY(save_picture_ptr->bufferCb + saveCbOffset + row * save_picture_ptr->strideCb, input_picture_ptr->bufferCb + inputCbOffset + row * input_picture_ptr->strideCb, width >> 1);
+            EB_MEMCPY(save_picture_ptr->bufferCr + saveCrOffset + row * save_picture_ptr->strideCr, input_picture_ptr->bufferCr + inputCrOffset + row * input_picture_ptr->strideCr, width >> 1);
+        }
+    }
+}
+
 EbErrorType denoise_estimate_film_grain(
     SequenceControlSet        *sequence_control_set_ptr,
     PictureParentControlSet_t   *picture_control_set_ptr,
@@ -3417,6 +3524,8 @@ EbErrorType denoise_estimate_film_grain(
     picture_control_set_ptr->film_grain_params.apply_grain = 0;
 
     if (sequence_control_set_ptr->film_grain_denoise_strength) {
+        if (picture_control_set_ptr->save_source_picture_ptr)
+            save_source_picture(sequence_control_set_ptr, picture_control_set_ptr, asm_type);
         if (apply_denoise_2d(sequence_control_set_ptr, picture_control_set_ptr, input_picture_ptr, asm_type) < 0)
             return 1;
     }
@@ -4139,150 +4248,6 @@ void PicturePreProcessingOperations(
 
 }
 
-/**************************************************************
-* Generate picture histogram bins for YUV pixel intensity *
-* Calculation is done on a region based (Set previously, resolution dependent)
-**************************************************************/
-void SubSampleLumaGeneratePixelIntensityHistogramBins(
-    SequenceControlSet            *sequence_control_set_ptr,
-    PictureParentControlSet_t       *picture_control_set_ptr,
-    EbPictureBufferDesc_t           *input_picture_ptr,
-    uint64_t                          *sumAverageIntensityTotalRegionsLuma,
-    EbAsm                           asm_type) {
-
-    uint32_t                          regionWidth;
-    uint32_t                          regionHeight;
-    uint32_t                          regionWidthOffset;
-    uint32_t                          regionHeightOffset;
-    uint32_t                          regionInPictureWidthIndex;
-    uint32_t                          regionInPictureHeightIndex;
-    uint32_t                            histogramBin;
-    uint64_t                          sum;
-
-    regionWidth = input_picture_ptr->width / sequence_control_set_ptr->picture_analysis_number_of_regions_per_width;
-    regionHeight = input_picture_ptr->height / sequence_control_set_ptr->picture_analysis_number_of_regions_per_height;
-
-    // Loop over regions inside the picture
-    for (regionInPictureWidthIndex = 0; regionInPictureWidthIndex < sequence_control_set_ptr->picture_analysis_number_of_regions_per_width; regionInPictureWidthIndex++) {  // loop over horizontal regions
-        for (regionInPictureHeightIndex = 0; regionInPictureHeightIndex < sequence_control_set_ptr->picture_analysis_number_of_regions_per_height; regionInPictureHeightIndex++) { // loop over vertical regions
-
-
-            // Initialize bins to 1
-            InitializeBuffer_32bits_funcPtrArray[asm_type](picture_control_set_ptr->picture_histogram[regionInPictureWidthIndex][regionInPictureHeightIndex][0], 64, 0, 1);
-
-            regionWidthOffset = (regionInPictureWidthIndex == sequence_control_set_ptr->picture_analysis_number_of_regions_per_width - 1) ?
-                input_picture_ptr->width - (sequence_control_set_ptr->picture_analysis_number_of_regions_per_width * regionWidth) :
-                0;
-
-            regionHeightOffset = (regionInPictureHeightIndex == sequence_control_set_ptr->picture_analysis_number_of_regions_per_height - 1) ?
-                input_picture_ptr->height - (sequence_control_set_ptr->picture_analysis_number_of_regions_per_height * regionHeight) :
-                0;
-
-            // Y Histogram
-            CalculateHistogram(
-                &input_picture_ptr->buffer_y[(input_picture_ptr->origin_x + regionInPictureWidthIndex * regionWidth) + ((input_picture_ptr->origin_y + regionInPictureHeightIndex * regionHeight) * input_picture_ptr->stride_y)],
-                regionWidth + regionWidthOffset,
-                regionHeight + regionHeightOffset,
-                input_picture_ptr->stride_y,
-                1,
-                picture_control_set_ptr->picture_histogram[regionInPictureWidthIndex][regionInPictureHeightIndex][0],
-                &sum);
-
-            picture_control_set_ptr->average_intensity_per_region[regionInPictureWidthIndex][regionInPictureHeightIndex][0] = (uint8_t)((sum + (((regionWidth + regionWidthOffset)*(regionHeight + regionHeightOffset)) >> 1)) / ((regionWidth + regionWidthOffset)*(regionHeight + regionHeightOffset)));
-            (*sumAverageIntensityTotalRegionsLuma) += (sum << 4);
-            for (histogramBin = 0; histogramBin < HISTOGRAM_NUMBER_OF_BINS; histogramBin++) { // Loop over the histogram bins
-                picture_control_set_ptr->picture_histogram[regionInPictureWidthIndex][regionInPictureHeightIndex][0][histogramBin] =
-                    picture_control_set_ptr->picture_histogram[regionInPictureWidthIndex][regionInPictureHeightIndex][0][histogramBin] << 4;
-            }
-        }
-    }
-
-    return;
-}
-
-void SubSampleChromaGeneratePixelIntensityHistogramBins(
-    SequenceControlSet            *sequence_control_set_ptr,
-    PictureParentControlSet_t       *picture_control_set_ptr,
-    EbPictureBufferDesc_t           *input_picture_ptr,
-    uint64_t                          *sumAverageIntensityTotalRegionsCb,
-    uint64_t                          *sumAverageIntensityTotalRegionsCr,
-    EbAsm                           asm_type) {
-
-    uint64_t                          sum;
-    uint32_t                          regionWidth;
-    uint32_t                          regionHeight;
-    uint32_t                          regionWidthOffset;
-    uint32_t                          regionHeightOffset;
-    uint32_t                          regionInPictureWidthIndex;
-    uint32_t                          regionInPictureHeightIndex;
-
-    uint16_t                          histogramBin;
-    uint8_t                           decimStep = 4;
-
-    regionWidth = input_picture_ptr->width / sequence_control_set_ptr->picture_analysis_number_of_regions_per_width;
-    regionHeight = input_picture_ptr->height / sequence_control_set_ptr->picture_analysis_number_of_regions_per_height;
-
-    // Loop over regions inside the picture
-    for (regionInPictureWidthIndex = 0; regionInPictureWidthIndex < sequence_control_set_ptr->picture_analysis_number_of_regions_per_width; regionInPictureWidthIndex++) {  // loop over horizontal regions
-        for (regionInPictureHeightIndex = 0; regionInPictureHeightIndex < sequence_control_set_ptr->picture_analysis_number_of_regions_per_height; regionInPictureHeightIndex++) { // loop over vertical regions
-
-
-            // Initialize bins to 1
-            InitializeBuffer_32bits_funcPtrArray[asm_type](picture_control_set_ptr->picture_histogram[regionInPictureWidthIndex][regionInPictureHeightIndex][1], 64, 0, 1);
-            InitializeBuffer_32bits_funcPtrArray[asm_type](picture_control_set_ptr->picture_histogram[regionInPictureWidthIndex][regionInPictureHeightIndex][2], 64, 0, 1);
-
-            regionWidthOffset = (regionInPictureWidthIndex == sequence_control_set_ptr->picture_analysis_number_of_regions_per_width - 1) ?
-                input_picture_ptr->width - (sequence_control_set_ptr->picture_analysis_number_of_regions_per_width * regionWidth) :
-                0;
-
-            regionHeightOffset = (regionInPictureHeightIndex == sequence_control_set_ptr->picture_analysis_number_of_regions_per_height - 1) ?
-                input_picture_ptr->height - (sequence_control_set_ptr->picture_analysis_number_of_regions_per_height * regionHeight) :
-                0;
-
-
-            // U Histogram
-            CalculateHistogram(
-                &input_picture_ptr->bufferCb[((input_picture_ptr->origin_x + regionInPictureWidthIndex * regionWidth) >> 1) + (((input_picture_ptr->origin_y + regionInPictureHeightIndex * regionHeight) >> 1) * input_picture_ptr->strideCb)],
-                (regionWidth + regionWidthOffset) >> 1,
-                (regionHeight + regionHeightOffset) >> 1,
-                input_picture_ptr->strideCb,
-                decimStep,
-                picture_control_set_ptr->picture_histogram[regionInPictureWidthIndex][regionInPictureHeightIndex][1],
-                &sum);
-
-            sum = (sum << decimStep);
-            *sumAverageIntensityTotalRegionsCb += sum;
-            picture_control_set_ptr->average_intensity_per_region[regionInPictureWidthIndex][regionInPictureHeightIndex][1] = (uint8_t)((sum + (((regionWidth + regionWidthOffset)*(regionHeight + regionHeightOffset)) >> 3)) / (((regionWidth + regionWidthOffset)*(regionHeight + regionHeightOffset)) >> 2));
-
-            for (histogramBin = 0; histogramBin < HISTOGRAM_NUMBER_OF_BINS; histogramBin++) { // Loop over the histogram bins
-                picture_control_set_ptr->picture_histogram[regionInPictureWidthIndex][regionInPictureHeightIndex][1][histogramBin] =
-                    picture_control_set_ptr->picture_histogram[regionInPictureWidthIndex][regionInPictureHeightIndex][1][histogramBin] << decimStep;
-            }
-
-            // V Histogram
-            CalculateHistogram(
-                &input_picture_ptr->bufferCr[((input_picture_ptr->origin_x + regionInPictureWidthIndex * regionWidth) >> 1) + (((input_picture_ptr->origin_y + regionInPictureHeightIndex * regionHeight) >> 1) * input_picture_ptr->strideCr)],
-                (regionWidth + regionWidthOffset) >> 1,
-                (regionHeight + regionHeightOffset) >> 1,
-                input_picture_ptr->strideCr,
-                decimStep,
-                picture_control_set_ptr->picture_histogram[regionInPictureWidthIndex][regionInPictureHeightIndex][2],
-                &sum);
-
-            sum = (sum << decimStep);
-            *sumAverageIntensityTotalRegionsCr += sum;
-            picture_control_set_ptr->average_intensity_per_region[regionInPictureWidthIndex][regionInPictureHeightIndex][2] = (uint8_t)((sum + (((regionWidth + regionWidthOffset)*(regionHeight + regionHeightOffset)) >> 3)) / (((regionWidth + regionWidthOffset)*(regionHeight + regionHeightOffset)) >> 2));
-
-            for (histogramBin = 0; histogramBin < HISTOGRAM_NUMBER_OF_BINS; histogramBin++) { // Loop over the histogram bins
-                picture_control_set_ptr->picture_histogram[regionInPictureWidthIndex][regionInPictureHeightIndex][2][histogramBin] =
-                    picture_control_set_ptr->picture_histogram[regionInPictureWidthIndex][regionInPictureHeightIndex][2][histogramBin] << decimStep;
-            }
-        }
-    }
-    return;
-
-}
-
 void EdgeDetectionMeanLumaChroma16x16(
     SequenceControlSet        *sequence_control_set_ptr,
     PictureParentControlSet_t   *picture_control_set_ptr,
@@ -4622,202 +4587,17 @@ void DetermineHomogeneousRegionInPicture(
 
     return;
 }
-/************************************************
- * ComputePictureSpatialStatistics
- ** Compute Block Variance
- ** Compute Picture Variance
- ** Compute Block Mean for all blocks in the picture
- ************************************************/
-void ComputePictureSpatialStatistics(
-    SequenceControlSet            *sequence_control_set_ptr,
-    PictureParentControlSet_t       *picture_control_set_ptr,
-    EbPictureBufferDesc_t           *input_picture_ptr,
-    EbPictureBufferDesc_t           *input_padded_picture_ptr,
-    uint32_t                           sb_total_count,
-    EbAsm                           asm_type)
-{
-    uint32_t sb_index;
-    uint32_t sb_origin_x;        // to avoid using child PCS
-    uint32_t sb_origin_y;
-    uint32_t inputLumaOriginIndex;
-    uint32_t inputCbOriginIndex;
-    uint32_t inputCrOriginIndex;
-    uint64_t picTotVariance;
-
-    // Variance
-    picTotVariance = 0;
-
-    for (sb_index = 0; sb_index < picture_control_set_ptr->sb_total_count; ++sb_index) {
-        SbParams_t   *sb_params = &sequence_control_set_ptr->sb_params_array[sb_index];
-
-        sb_origin_x = sb_params->origin_x;
-        sb_origin_y = sb_params->origin_y;
-        inputLumaOriginIndex = (input_padded_picture_ptr->origin_y + sb_origin_y) * input_padded_picture_ptr->stride_y +
-            input_padded_picture_ptr->origin_x + sb_origin_x;
-
-        inputCbOriginIndex = ((input_picture_ptr->origin_y + sb_origin_y) >> 1) * input_picture_ptr->strideCb + ((input_picture_ptr->origin_x + sb_origin_x) >> 1);
-        inputCrOriginIndex = ((input_picture_ptr->origin_y + sb_origin_y) >> 1) * input_picture_ptr->strideCr + ((input_picture_ptr->origin_x + sb_origin_x) >> 1);
-
-        ComputeBlockMeanComputeVariance(
-            sequence_control_set_ptr,
-            picture_control_set_ptr,
-            input_padded_picture_ptr,
-            sb_index,
-            inputLumaOriginIndex,
-            asm_type);
-
-        if (sb_params->is_complete_sb) {
-
-            ComputeChromaBlockMean(
-                sequence_control_set_ptr,
-                picture_control_set_ptr,
-                input_picture_ptr,
-                sb_index,
-                inputCbOriginIndex,
-                inputCrOriginIndex,
-                asm_type);
-        }
-        else {
-            ZeroOutChromaBlockMean(
-                picture_control_set_ptr,
-                sb_index);
-        }
-
-        picTotVariance += (picture_control_set_ptr->variance[sb_index][RASTER_SCAN_CU_INDEX_64x64]);
-    }
-
-    picture_control_set_ptr->pic_avg_variance = (uint16_t)(picTotVariance / sb_total_count);
-    // Calculate the variance of variance to determine Homogeneous regions. Note: Variance calculation should be on.
-    DetermineHomogeneousRegionInPicture(
-        sequence_control_set_ptr,
-        picture_control_set_ptr);
-
-    EdgeDetectionMeanLumaChroma16x16(
-        sequence_control_set_ptr,
-        picture_control_set_ptr,
-        sequence_control_set_ptr->sb_total_count);
-
-    EdgeDetection(
-        sequence_control_set_ptr,
-        picture_control_set_ptr);
-
-
-    return;
-}
-
-void CalculateInputAverageIntensity(
-    SequenceControlSet            *sequence_control_set_ptr,
-    PictureParentControlSet_t       *picture_control_set_ptr,
-    EbPictureBufferDesc_t           *input_picture_ptr,
-    uint64_t                           sumAverageIntensityTotalRegionsLuma,
-    uint64_t                           sumAverageIntensityTotalRegionsCb,
-    uint64_t                           sumAverageIntensityTotalRegionsCr,
-    EbAsm                           asm_type)
-{
-
-    if (sequence_control_set_ptr->scd_mode == SCD_MODE_0) {
-        uint16_t blockIndexInWidth;
-        uint16_t blockIndexInHeight;
-        uint64_t mean = 0;
-
-        (void)(asm_type);
-        const uint16_t stride_y = input_picture_ptr->stride_y;
-        // Loop over 8x8 blocks and calculates the mean value
-        if (sequence_control_set_ptr->block_mean_calc_prec == BLOCK_MEAN_PREC_FULL) {
-            for (blockIndexInHeight = 0; blockIndexInHeight < input_picture_ptr->height >> 3; ++blockIndexInHeight) {
-                for (blockIndexInWidth = 0; blockIndexInWidth < input_picture_ptr->width >> 3; ++blockIndexInWidth) {
-                    mean += ComputeMeanFunc[0][asm_type](&(input_picture_ptr->buffer_y[(blockIndexInWidth << 3) + (blockIndexInHeight << 3) * input_picture_ptr->stride_y]), input_picture_ptr->stride_y, 8, 8);
-                }
-            }
-        }
-        else {
-            for (blockIndexInHeight = 0; blockIndexInHeight < input_picture_ptr->height >> 3; ++blockIndexInHeight) {
-                for (blockIndexInWidth = 0; blockIndexInWidth < input_picture_ptr->width >> 3; ++blockIndexInWidth) {
-                    mean += compute_sub_mean8x8_sse2_intrin(&(input_picture_ptr->buffer_y[(blockIndexInWidth << 3) + (blockIndexInHeight << 3) * stride_y]), stride_y);
-                }
-            }
-        }
-        mean = ((mean + ((input_picture_ptr->height* input_picture_ptr->width) >> 7)) / ((input_picture_ptr->height* input_picture_ptr->width) >> 6));
-        mean = (mean + (1 << (MEAN_PRECISION - 1))) >> MEAN_PRECISION;
-        picture_control_set_ptr->average_intensity[0] = (uint8_t)mean;
-    }
-
-    else {
-        picture_control_set_ptr->average_intensity[0] = (uint8_t)((sumAverageIntensityTotalRegionsLuma + ((input_picture_ptr->width*input_picture_ptr->height) >> 1)) / (input_picture_ptr->width*input_picture_ptr->height));
-        picture_control_set_ptr->average_intensity[1] = (uint8_t)((sumAverageIntensityTotalRegionsCb + ((input_picture_ptr->width*input_picture_ptr->height) >> 3)) / ((input_picture_ptr->width*input_picture_ptr->height) >> 2));
-        picture_control_set_ptr->average_intensity[2] = (uint8_t)((sumAverageIntensityTotalRegionsCr + ((input_picture_ptr->width*input_picture_ptr->height) >> 3)) / ((input_picture_ptr->width*input_picture_ptr->height) >> 2));
-    }
-
-    return;
-}
-
-/************************************************
- * Gathering statistics per picture
- ** Calculating the pixel intensity histogram bins per picture needed for SCD
- ** Computing Picture Variance
- ************************************************/
-void GatheringPictureStatistics(
-    SequenceControlSet            *sequence_control_set_ptr,
-    PictureParentControlSet_t       *picture_control_set_ptr,
-    EbPictureBufferDesc_t           *input_picture_ptr,
-    EbPictureBufferDesc_t           *input_padded_picture_ptr,
-    EbPictureBufferDesc_t            *sixteenth_decimated_picture_ptr,
-    uint32_t                           sb_total_count,
-    EbAsm                           asm_type)
-{
-
-    uint64_t                          sumAverageIntensityTotalRegionsLuma = 0;
-    uint64_t                          sumAverageIntensityTotalRegionsCb = 0;
-    uint64_t                          sumAverageIntensityTotalRegionsCr = 0;
-
-    // Histogram bins
-        // Use 1/16 Luma for Histogram generation
-        // 1/16 input ready
-    SubSampleLumaGeneratePixelIntensityHistogramBins(
-        sequence_control_set_ptr,
-        picture_control_set_ptr,
-        sixteenth_decimated_picture_ptr,
-        &sumAverageIntensityTotalRegionsLuma,
-        asm_type);
-
-    // Use 1/4 Chroma for Histogram generation
-    // 1/4 input not ready => perform operation on the fly
-    SubSampleChromaGeneratePixelIntensityHistogramBins(
-        sequence_control_set_ptr,
-        picture_control_set_ptr,
-        input_picture_ptr,
-        &sumAverageIntensityTotalRegionsCb,
-        &sumAverageIntensityTotalRegionsCr,
-        asm_type);
-    //
-    // Calculate the LUMA average intensity
-    CalculateInputAverageIntensity(
-        sequence_control_set_ptr,
-        picture_control_set_ptr,
-        input_picture_ptr,
-        sumAverageIntensityTotalRegionsLuma,
-        sumAverageIntensityTotalRegionsCb,
-        sumAverageIntensityTotalRegionsCr,
-        asm_type);
-
-
-    ComputePictureSpatialStatistics(
-        sequence_control_set_ptr,
-        picture_control_set_ptr,
-        input_picture_ptr,
-        input_padded_picture_ptr,
-        sb_total_count,
-        asm_type);
-
-    return;
-}
 /************************************************
  * Pad Picture at the right and bottom sides
  ** To match a multiple of min CU size in width and height
+ ** Pads the luma rows [row_start, row_end) and their chroma,
+ ** the bottom padding is added with the last rows
  ************************************************/
 void PadPictureToMultipleOfMinCuSizeDimensions(
     SequenceControlSet            *sequence_control_set_ptr,
-    EbPictureBufferDesc_t           *input_picture_ptr)
+    EbPictureBufferDesc_t           *input_picture_ptr,
+    uint32_t                         row_start,
+    uint32_t                         row_end)
 {
     EbBool                          is16BitInput = (EbBool)(sequence_control_set_ptr->static_config.encoder_bit_depth > EB_8BIT);
 
@@ -4825,137 +4605,713 @@ void PadPictureToMultipleOfMinCuSizeDimensions(
 	const uint16_t subsampling_x = (color_format == EB_YUV444 ? 1 : 2) - 1;
 	const uint16_t subsampling_y = (color_format >= EB_YUV422 ? 1 : 2) - 1;
 
+    const uint32_t original_row_end = MIN(row_end, input_picture_ptr->height - sequence_control_set_ptr->pad_bottom);
+    const uint32_t pad_bottom = (row_end == input_picture_ptr->height) ? sequence_control_set_ptr->pad_bottom : 0;
+    const uint32_t chroma_row_start = row_start >> subsampling_y;
+
     // Input Picture Padding
     pad_input_picture(
-        &input_picture_ptr->buffer_y[input_picture_ptr->origin_x + (input_picture_ptr->origin_y * input_picture_ptr->stride_y)],
+        &input_picture_ptr->buffer_y[input_picture_ptr->origin_x + ((input_picture_ptr->origin_y + row_start) * input_picture_ptr->stride_y)],
         input_picture_ptr->stride_y,
         (input_picture_ptr->width - sequence_control_set_ptr->pad_right),
-        (input_picture_ptr->height - sequence_control_set_ptr->pad_bottom),
+        original_row_end - row_start,
         sequence_control_set_ptr->pad_right,
-        sequence_control_set_ptr->pad_bottom);
+        pad_bottom);
 
     pad_input_picture(
-        &input_picture_ptr->bufferCb[(input_picture_ptr->origin_x >> subsampling_x) + ((input_picture_ptr->origin_y >> subsampling_y) * input_picture_ptr->strideCb)],
+        &input_picture_ptr->bufferCb[(input_picture_ptr->origin_x >> subsampling_x) + (((input_picture_ptr->origin_y >> subsampling_y) + chroma_row_start) * input_picture_ptr->strideCb)],
         input_picture_ptr->strideCb,
         (input_picture_ptr->width - sequence_control_set_ptr->pad_right) >> subsampling_x,
-        (input_picture_ptr->height - sequence_control_set_ptr->pad_bottom) >> subsampling_y,
+        (original_row_end >> subsampling_y) - chroma_row_start,
         sequence_control_set_ptr->pad_right >> subsampling_x,
-        sequence_control_set_ptr->pad_bottom >> subsampling_y);
+        pad_bottom >> subsampling_y);
 
     pad_input_picture(
-        &input_picture_ptr->bufferCr[(input_picture_ptr->origin_x >> subsampling_x) + ((input_picture_ptr->origin_y >> subsampling_y) * input_picture_ptr->strideCb)],
+        &input_picture_ptr->bufferCr[(input_picture_ptr->origin_x >> subsampling_x) + (((input_picture_ptr->origin_y >> subsampling_y) + chroma_row_start) * input_picture_ptr->strideCb)],
         input_picture_ptr->strideCr,
         (input_picture_ptr->width - sequence_control_set_ptr->pad_right) >> subsampling_x,
-        (input_picture_ptr->height - sequence_control_set_ptr->pad_bottom) >> subsampling_y,
+        (original_row_end >> subsampling_y) - chroma_row_start,
         sequence_control_set_ptr->pad_right >> subsampling_x,
-        sequence_control_set_ptr->pad_bottom >> subsampling_y);
+        pad_bottom >> subsampling_y);
 
     if (is16BitInput)
     {
         pad_input_picture(
-            &input_picture_ptr->bufferBitIncY[input_picture_ptr->origin_x + (input_picture_ptr->origin_y * input_picture_ptr->strideBitIncY)],
+            &input_picture_ptr->bufferBitIncY[input_picture_ptr->origin_x + ((input_picture_ptr->origin_y + row_start) * input_picture_ptr->strideBitIncY)],
             input_picture_ptr->strideBitIncY,
             (input_picture_ptr->width - sequence_control_set_ptr->pad_right),
-            (input_picture_ptr->height - sequence_control_set_ptr->pad_bottom),
+            original_row_end - row_start,
             sequence_control_set_ptr->pad_right,
-            sequence_control_set_ptr->pad_bottom);
+            pad_bottom);
 
         pad_input_picture(
-            &input_picture_ptr->bufferBitIncCb[(input_picture_ptr->origin_x >> subsampling_x) + ((input_picture_ptr->origin_y >> subsampling_y) * input_picture_ptr->strideBitIncCb)],
+            &input_picture_ptr->bufferBitIncCb[(input_picture_ptr->origin_x >> subsampling_x) + (((input_picture_ptr->origin_y >> subsampling_y) + chroma_row_start) * input_picture_ptr->strideBitIncCb)],
             input_picture_ptr->strideBitIncCb,
             (input_picture_ptr->width - sequence_control_set_ptr->pad_right) >> subsampling_x,
-            (input_picture_ptr->height - sequence_control_set_ptr->pad_bottom) >> subsampling_y,
+            (original_row_end >> subsampling_y) - chroma_row_start,
             sequence_control_set_ptr->pad_right >> subsampling_x,
-            sequence_control_set_ptr->pad_bottom >> subsampling_y);
+            pad_bottom >> subsampling_y);
 
         pad_input_picture(
-            &input_picture_ptr->bufferBitIncCr[(input_picture_ptr->origin_x >> subsampling_x) + ((input_picture_ptr->origin_y >> subsampling_y) * input_picture_ptr->strideBitIncCb)],
+            &input_picture_ptr->bufferBitIncCr[(input_picture_ptr->origin_x >> subsampling_x) + (((input_picture_ptr->origin_y >> subsampling_y) + chroma_row_start) * input_picture_ptr->strideBitIncCb)],
             input_picture_ptr->strideBitIncCr,
             (input_picture_ptr->width - sequence_control_set_ptr->pad_right) >> subsampling_x,
-            (input_picture_ptr->height - sequence_control_set_ptr->pad_bottom) >> subsampling_y,
+            (original_row_end >> subsampling_y) - chroma_row_start,
             sequence_control_set_ptr->pad_right >> subsampling_x,
-            sequence_control_set_ptr->pad_bottom >> subsampling_y);
+            pad_bottom >> subsampling_y);
     }
 
     return;
 }
 
 /************************************************
- * Pad Picture at the right and bottom sides
- ** To complete border SB smaller than SB size
+ * Native 16 bit pipeline input of a band of rows
+ ** Pads the luma rows [row_start, row_end) of the 16 bit input and their
+ ** chroma to a multiple of min CU size, then extracts their most
+ ** significant bits into the 8 bit picture
  ************************************************/
-void PadPictureToMultipleOfLcuDimensions(
-    EbPictureBufferDesc_t           *input_padded_picture_ptr
-)
+static void pad_native_input_picture_rows(
+    SequenceControlSet            *sequence_control_set_ptr,
+    EbPictureBufferDesc_t           *input_picture_ptr,
+    EbPictureBufferDesc_t           *msb_picture_ptr,
+    uint32_t                         row_start,
+    uint32_t                         row_end,
+    EbAsm                            asm_type)
 {
+    const uint32_t color_format = input_picture_ptr->color_format;
+    const uint16_t subsampling_x = (color_format == EB_YUV444 ? 1 : 2) - 1;
+    const uint16_t subsampling_y = (color_format >= EB_YUV422 ? 1 : 2) - 1;
+
+    const uint32_t original_row_end = MIN(row_end, input_picture_ptr->height - sequence_control_set_ptr->pad_bottom);
+    const uint32_t pad_bottom = (row_end == input_picture_ptr->height) ? sequence_control_set_ptr->pad_bottom : 0;
+    const uint32_t chroma_row_start = row_start >> subsampling_y;
+    const uint32_t chroma_row_end = row_end >> subsampling_y;
+    const uint32_t chroma_origin_x = input_picture_ptr->origin_x >> subsampling_x;
+    const uint32_t chroma_origin_y = (input_picture_ptr->origin_y >> subsampling_y) + chroma_row_start;
+    uint16_t *input_y = (uint16_t*)input_picture_ptr->buffer_y + input_picture_ptr->origin_x + (input_picture_ptr->origin_y + row_start) * input_picture_ptr->stride_y;
+    uint16_t *input_cb = (uint16_t*)input_picture_ptr->bufferCb + chroma_origin_x + chroma_origin_y * input_picture_ptr->strideCb;
+    uint16_t *input_cr = (uint16_t*)input_picture_ptr->bufferCr + chroma_origin_x + chroma_origin_y * input_picture_ptr->strideCr;
+
+    pad_input_picture16bit(
+        input_y,
+        input_picture_ptr->stride_y,
+        (input_picture_ptr->width - sequence_control_set_ptr->pad_right),
+        original_row_end - row_start,
+        sequence_control_set_ptr->pad_right,
+        pad_bottom);
 
-    // Generate Padding
-    generate_padding(
-        &input_padded_picture_ptr->buffer_y[0],
-        input_padded_picture_ptr->stride_y,
-        input_padded_picture_ptr->width,
-        input_padded_picture_ptr->height,
-        input_padded_picture_ptr->origin_x,
-        input_padded_picture_ptr->origin_y);
-
-    return;
-}
+    pad_input_picture16bit(
+        input_cb,
+        input_picture_ptr->strideCb,
+        (input_picture_ptr->width - sequence_control_set_ptr->pad_right) >> subsampling_x,
+        (original_row_end >> subsampling_y) - chroma_row_start,
+        sequence_control_set_ptr->pad_right >> subsampling_x,
+        pad_bottom >> subsampling_y);
 
-/************************************************
-* 1/4 & 1/16 input picture decimation
-************************************************/
-void DecimateInputPicture(
-    PictureParentControlSet_t       *picture_control_set_ptr,
-    EbPictureBufferDesc_t           *input_padded_picture_ptr,
-    EbPictureBufferDesc_t           *quarter_decimated_picture_ptr,
-    EbPictureBufferDesc_t           *sixteenth_decimated_picture_ptr) {
+    pad_input_picture16bit(
+        input_cr,
+        input_picture_ptr->strideCr,
+        (input_picture_ptr->width - sequence_control_set_ptr->pad_right) >> subsampling_x,
+        (original_row_end >> subsampling_y) - chroma_row_start,
+        sequence_control_set_ptr->pad_right >> subsampling_x,
+        pad_bottom >> subsampling_y);
 
+    extract_8bit_data(
+        input_y,
+        input_picture_ptr->stride_y,
+        msb_picture_ptr->buffer_y + msb_picture_ptr->origin_x + (msb_picture_ptr->origin_y + row_start) * msb_picture_ptr->stride_y,
+        msb_picture_ptr->stride_y,
+        input_picture_ptr->width,
+        row_end - row_start,
+        asm_type);
 
-    // Decimate input picture for HME L0 and L1
-    if (picture_control_set_ptr->enable_hme_flag) {
+    extract_8bit_data(
+        input_cb,
+        input_picture_ptr->strideCb,
+        msb_picture_ptr->bufferCb + (msb_picture_ptr->origin_x >> subsampling_x) + ((msb_picture_ptr->origin_y >> subsampling_y) + chroma_row_start) * msb_picture_ptr->strideCb,
+        msb_picture_ptr->strideCb,
+        input_picture_ptr->width >> subsampling_x,
+        chroma_row_end - chroma_row_start,
+        asm_type);
+
+    extract_8bit_data(
+        input_cr,
+        input_picture_ptr->strideCr,
+        msb_picture_ptr->bufferCr + (msb_picture_ptr->origin_x >> subsampling_x) + ((msb_picture_ptr->origin_y >> subsampling_y) + chroma_row_start) * msb_picture_ptr->strideCr,
+        msb_picture_ptr->strideCr,
+        input_picture_ptr->width >> subsampling_x,
+        chroma_row_end - chroma_row_start,
+        asm_type);
+}
+
+/************************************************
+ * Pad a band of picture rows
+ ** Horizontal padding of the rows [row_start, row_end); the top and
+ ** bottom borders are replicated with the first and the last band.
+ ** Gives the generate_padding() result once all rows went through it
+ ************************************************/
+static void pad_picture_rows(
+    EbByte                           src_pic,
+    uint32_t                         src_stride,
+    uint32_t                         original_src_width,
+    uint32_t                         original_src_height,
+    uint32_t                         padding_width,
+    uint32_t                         padding_height,
+    uint32_t                         row_start,
+    uint32_t                         row_end)
+{
+    EbByte   row_ptr = src_pic + padding_width + (padding_height + row_start) * src_stride;
+    uint32_t row_index;
+
+    for (row_index = row_start; row_index < row_end; ++row_index) {
+        EB_MEMSET(row_ptr - padding_width, *row_ptr, padding_width);
+        EB_MEMSET(row_ptr + original_src_width, *(row_ptr + original_src_width - 1), padding_width);
+        row_ptr += src_stride;
+    }
+
+    if (row_start == 0) {
+        EbByte first_row_ptr = src_pic + padding_height * src_stride;
+        for (row_index = 1; row_index <= padding_height; ++row_index)
+            EB_MEMCPY(first_row_ptr - row_index * src_stride, first_row_ptr, sizeof(uint8_t) * src_stride);
+    }
+
+    if (row_end == original_src_height) {
+        EbByte last_row_ptr = src_pic + (padding_height + original_src_height - 1) * src_stride;
+        for (row_index = 1; row_index <= padding_height; ++row_index)
+            EB_MEMCPY(last_row_ptr + row_index * src_stride, last_row_ptr, sizeof(uint8_t) * src_stride);
+    }
+
+    return;
+}
+
+/************************************************
+ * 1/4 & 1/16 decimation of a band of input rows
+ ************************************************/
+static void decimate_input_picture_rows(
+    PictureParentControlSet_t       *picture_control_set_ptr,
+    EbPictureBufferDesc_t           *input_padded_picture_ptr,
+    EbPictureBufferDesc_t           *quarter_decimated_picture_ptr,
+    EbPictureBufferDesc_t           *sixteenth_decimated_picture_ptr,
+    uint32_t                         row_start,
+    uint32_t                         row_end,
+    EbAsm                            asm_type)
+{
+    const EbBool last_band = (EbBool)(row_end == input_padded_picture_ptr->height);
+    uint8_t     *input_ptr = &input_padded_picture_ptr->buffer_y[input_padded_picture_ptr->origin_x + (input_padded_picture_ptr->origin_y + row_start) * input_padded_picture_ptr->stride_y];
+
+    // Decimate input picture for HME L0 and L1
+    if (picture_control_set_ptr->enable_hme_flag) {
 
         if (picture_control_set_ptr->enable_hme_level1_flag) {
-            Decimation2D(
-                &input_padded_picture_ptr->buffer_y[input_padded_picture_ptr->origin_x + input_padded_picture_ptr->origin_y * input_padded_picture_ptr->stride_y],
+            Decimation2DFunc[asm_type](
+                input_ptr,
                 input_padded_picture_ptr->stride_y,
                 input_padded_picture_ptr->width,
-                input_padded_picture_ptr->height,
-                &quarter_decimated_picture_ptr->buffer_y[quarter_decimated_picture_ptr->origin_x + quarter_decimated_picture_ptr->origin_x*quarter_decimated_picture_ptr->stride_y],
+                row_end - row_start,
+                &quarter_decimated_picture_ptr->buffer_y[quarter_decimated_picture_ptr->origin_x + (quarter_decimated_picture_ptr->origin_y + (row_start >> 1)) * quarter_decimated_picture_ptr->stride_y],
                 quarter_decimated_picture_ptr->stride_y,
                 2);
-            generate_padding(
+            pad_picture_rows(
                 &quarter_decimated_picture_ptr->buffer_y[0],
                 quarter_decimated_picture_ptr->stride_y,
                 quarter_decimated_picture_ptr->width,
                 quarter_decimated_picture_ptr->height,
                 quarter_decimated_picture_ptr->origin_x,
-                quarter_decimated_picture_ptr->origin_y);
-
+                quarter_decimated_picture_ptr->origin_y,
+                row_start >> 1,
+                last_band ? quarter_decimated_picture_ptr->height : row_end >> 1);
         }
 
         if (picture_control_set_ptr->enable_hme_level0_flag) {
-
-            // Sixteenth Input Picture Decimation
-            Decimation2D(
-                &input_padded_picture_ptr->buffer_y[input_padded_picture_ptr->origin_x + input_padded_picture_ptr->origin_y * input_padded_picture_ptr->stride_y],
+            Decimation2DFunc[asm_type](
+                input_ptr,
                 input_padded_picture_ptr->stride_y,
                 input_padded_picture_ptr->width,
-                input_padded_picture_ptr->height,
-                &sixteenth_decimated_picture_ptr->buffer_y[sixteenth_decimated_picture_ptr->origin_x + sixteenth_decimated_picture_ptr->origin_x*sixteenth_decimated_picture_ptr->stride_y],
+                row_end - row_start,
+                &sixteenth_decimated_picture_ptr->buffer_y[sixteenth_decimated_picture_ptr->origin_x + (sixteenth_decimated_picture_ptr->origin_y + (row_start >> 2)) * sixteenth_decimated_picture_ptr->stride_y],
                 sixteenth_decimated_picture_ptr->stride_y,
                 4);
-
-            generate_padding(
+            pad_picture_rows(
                 &sixteenth_decimated_picture_ptr->buffer_y[0],
                 sixteenth_decimated_picture_ptr->stride_y,
                 sixteenth_decimated_picture_ptr->width,
                 sixteenth_decimated_picture_ptr->height,
                 sixteenth_decimated_picture_ptr->origin_x,
-                sixteenth_decimated_picture_ptr->origin_y);
+                sixteenth_decimated_picture_ptr->origin_y,
+                row_start >> 2,
+                last_band ? sixteenth_decimated_picture_ptr->height : row_end >> 2);
+        }
+    }
+
+    return;
+}
 
+/************************************************
+ * Accumulate the histogram bins of the part of a region
+ ** that lies in the plane rows [band_start, band_end)
+ ************************************************/
+static void accumulate_region_histogram(
+    uint8_t                         *plane_ptr,
+    uint32_t                         stride,
+    uint32_t                         region_origin_x,
+    uint32_t                         region_origin_y,
+    uint32_t                         region_width,
+    uint32_t                         region_height,
+    uint8_t                          decim_step,
+    uint32_t                         band_start,
+    uint32_t                         band_end,
+    uint32_t                        *histogram,
+    uint64_t                        *sum)
+{
+    const uint32_t sampled_rows = (region_height + decim_step - 1) / decim_step;
+    const uint32_t first_row = band_start > region_origin_y ? (band_start - region_origin_y + decim_step - 1) / decim_step : 0;
+    const uint32_t end_row = band_end > region_origin_y ? MIN(sampled_rows, (band_end - region_origin_y + decim_step - 1) / decim_step) : 0;
+    uint64_t       band_sum;
+
+    if (first_row >= end_row)
+        return;
+
+    CalculateHistogram(
+        &plane_ptr[region_origin_x + (region_origin_y + first_row * decim_step) * stride],
+        region_width,
+        (end_row - first_row - 1) * decim_step + 1,
+        stride,
+        decim_step,
+        histogram,
+        &band_sum);
+
+    *sum += band_sum;
+
+    return;
+}
+
+/************************************************
+ * Reset the segment statistics before its first SB row
+ ************************************************/
+static void init_segment_statistics(
+    SequenceControlSet            *sequence_control_set_ptr,
+    EbPictureBufferDesc_t           *input_padded_picture_ptr,
+    PictureStatistics_t             *statistics_ptr,
+    uint32_t                        *histogram_ptr,
+    uint32_t                         sb_row_start)
+{
+    uint32_t regionInPictureWidthIndex;
+    uint32_t regionInPictureHeightIndex;
+
+    EB_MEMSET(statistics_ptr, 0, sizeof(PictureStatistics_t));
+
+    for (regionInPictureWidthIndex = 0; regionInPictureWidthIndex < sequence_control_set_ptr->picture_analysis_number_of_regions_per_width; regionInPictureWidthIndex++) {
+        for (regionInPictureHeightIndex = 0; regionInPictureHeightIndex < sequence_control_set_ptr->picture_analysis_number_of_regions_per_height; regionInPictureHeightIndex++) {
+            EB_MEMSET(SEGMENT_HISTOGRAM(histogram_ptr, regionInPictureWidthIndex, regionInPictureHeightIndex, 0), 0, sizeof(uint32_t) * 3 * HISTOGRAM_NUMBER_OF_BINS);
         }
     }
+
+    // The 8x8 block rows across the segment top are done with the picture statistics
+    if (sb_row_start)
+        statistics_ptr->block_mean_rows = (input_padded_picture_ptr->origin_y + sb_row_start * sequence_control_set_ptr->sb_sz + 7) >> 3;
+
+    return;
+}
+
+/************************************************
+ * Sum of the 8x8 block means of an 8x8 block row
+ ************************************************/
+static uint64_t compute_block_mean_row_sum(
+    SequenceControlSet            *sequence_control_set_ptr,
+    EbPictureBufferDesc_t           *input_picture_ptr,
+    uint32_t                         blockIndexInHeight,
+    EbAsm                            asm_type)
+{
+    const uint16_t stride_y = input_picture_ptr->stride_y;
+    uint64_t       block_mean_sum = 0;
+    uint16_t       blockIndexInWidth;
+
+    for (blockIndexInWidth = 0; blockIndexInWidth < input_picture_ptr->width >> 3; ++blockIndexInWidth) {
+        if (sequence_control_set_ptr->block_mean_calc_prec == BLOCK_MEAN_PREC_FULL)
+            block_mean_sum += ComputeMeanFunc[0][asm_type](&(input_picture_ptr->buffer_y[(blockIndexInWidth << 3) + (blockIndexInHeight << 3) * input_picture_ptr->stride_y]), input_picture_ptr->stride_y, 8, 8);
+        else
+            block_mean_sum += compute_sub_mean8x8_sse2_intrin(&(input_picture_ptr->buffer_y[(blockIndexInWidth << 3) + (blockIndexInHeight << 3) * stride_y]), stride_y);
+    }
+
+    return block_mean_sum;
 }
+
+/************************************************
+ * Picture analysis of one SB row
+ ** Works on one band of input rows while it is in cache:
+ ***** Padding of the input and decimated pictures
+ ***** 422/444 => 420 chroma conversion
+ ***** 1/4 & 1/16 decimation
+ ***** 8x8 to 64x64 luma mean & variance, chroma block mean
+ ***** Luma (1/16) & chroma (1/4) histogram bins
+ ***** Input average intensity sums
+ ************************************************/
+static void picture_analysis_sb_row(
+    SequenceControlSet            *sequence_control_set_ptr,
+    PictureParentControlSet_t       *picture_control_set_ptr,
+    EbPictureBufferDesc_t           *input_picture_ptr,
+    EbPictureBufferDesc_t           *input_padded_picture_ptr,
+    EbPictureBufferDesc_t           *quarter_decimated_picture_ptr,
+    EbPictureBufferDesc_t           *sixteenth_decimated_picture_ptr,
+    PictureStatistics_t             *statistics_ptr,
+    uint32_t                        *histogram_ptr,
+    uint32_t                         sb_row_index,
+    uint32_t                         picture_width_in_sb,
+    EbAsm                            asm_type)
+{
+    const uint32_t row_start = sb_row_index * sequence_control_set_ptr->sb_sz;
+    const uint32_t row_end = MIN(row_start + sequence_control_set_ptr->sb_sz, input_padded_picture_ptr->height);
+    const EbBool   last_band = (EbBool)(row_end == input_padded_picture_ptr->height);
+    uint32_t       sb_index;
+    uint32_t       regionWidth;
+    uint32_t       regionHeight;
+    uint32_t       regionWidthOffset;
+    uint32_t       regionHeightOffset;
+    uint32_t       regionInPictureWidthIndex;
+    uint32_t       regionInPictureHeightIndex;
+    uint32_t       band_start;
+    uint32_t       band_end;
+
+    // Pad input picture to multiple min cu size, the film grain denoising pads the whole picture beforehand
+    if (picture_control_set_ptr->native_input_picture_ptr) {
+        pad_native_input_picture_rows(
+            sequence_control_set_ptr,
+            picture_control_set_ptr->native_input_picture_ptr,
+            picture_control_set_ptr->enhanced_picture_ptr,
+            row_start,
+            row_end,
+            asm_type);
+    }
+    else if (!sequence_control_set_ptr->film_grain_denoise_strength) {
+        PadPictureToMultipleOfMinCuSizeDimensions(
+            sequence_control_set_ptr,
+            picture_control_set_ptr->enhanced_picture_ptr,
+            row_start,
+            row_end);
+    }
+
+    if (picture_control_set_ptr->enhanced_picture_ptr->color_format >= EB_YUV422) {
+        DownSampleChroma(
+            picture_control_set_ptr->enhanced_picture_ptr,
+            picture_control_set_ptr->chroma_downsampled_picture_ptr,
+            row_start,
+            row_end);
+    }
+
+    // Pad input picture to complete border SBs
+    pad_picture_rows(
+        &input_padded_picture_ptr->buffer_y[0],
+        input_padded_picture_ptr->stride_y,
+        input_padded_picture_ptr->width,
+        input_padded_picture_ptr->height,
+        input_padded_picture_ptr->origin_x,
+        input_padded_picture_ptr->origin_y,
+        row_start,
+        row_end);
+
+    decimate_input_picture_rows(
+        picture_control_set_ptr,
+        input_padded_picture_ptr,
+        quarter_decimated_picture_ptr,
+        sixteenth_decimated_picture_ptr,
+        row_start,
+        row_end,
+        asm_type);
+
+    // Block mean & variance
+    for (sb_index = sb_row_index * picture_width_in_sb; sb_index < MIN((sb_row_index + 1) * picture_width_in_sb, picture_control_set_ptr->sb_total_count); ++sb_index) {
+        SbParams_t   *sb_params = &sequence_control_set_ptr->sb_params_array[sb_index];
+        uint32_t      inputLumaOriginIndex = (input_padded_picture_ptr->origin_y + sb_params->origin_y) * input_padded_picture_ptr->stride_y +
+            input_padded_picture_ptr->origin_x + sb_params->origin_x;
+
+        ComputeBlockMeanComputeVariance(
+            sequence_control_set_ptr,
+            picture_control_set_ptr,
+            input_padded_picture_ptr,
+            sb_index,
+            inputLumaOriginIndex,
+            asm_type);
+
+        if (sb_params->is_complete_sb) {
+            uint32_t inputCbOriginIndex = ((input_picture_ptr->origin_y + sb_params->origin_y) >> 1) * input_picture_ptr->strideCb + ((input_picture_ptr->origin_x + sb_params->origin_x) >> 1);
+            uint32_t inputCrOriginIndex = ((input_picture_ptr->origin_y + sb_params->origin_y) >> 1) * input_picture_ptr->strideCr + ((input_picture_ptr->origin_x + sb_params->origin_x) >> 1);
+
+            ComputeChromaBlockMean(
+                sequence_control_set_ptr,
+                picture_control_set_ptr,
+                input_picture_ptr,
+                sb_index,
+                inputCbOriginIndex,
+                inputCrOriginIndex,
+                asm_type);
+        }
+        else {
+            ZeroOutChromaBlockMean(
+                picture_control_set_ptr,
+                sb_index);
+        }
+
+        statistics_ptr->pic_tot_variance += (picture_control_set_ptr->variance[sb_index][RASTER_SCAN_CU_INDEX_64x64]);
+    }
+
+    // Luma histogram bins on the 1/16 decimated rows of the band
+    regionWidth = sixteenth_decimated_picture_ptr->width / sequence_control_set_ptr->picture_analysis_number_of_regions_per_width;
+    regionHeight = sixteenth_decimated_picture_ptr->height / sequence_control_set_ptr->picture_analysis_number_of_regions_per_height;
+    band_start = row_start ? sixteenth_decimated_picture_ptr->origin_y + (row_start >> 2) : 0;
+    band_end = last_band ? (uint32_t)~0 : sixteenth_decimated_picture_ptr->origin_y + (row_end >> 2);
+
+    for (regionInPictureWidthIndex = 0; regionInPictureWidthIndex < sequence_control_set_ptr->picture_analysis_number_of_regions_per_width; regionInPictureWidthIndex++) {
+        for (regionInPictureHeightIndex = 0; regionInPictureHeightIndex < sequence_control_set_ptr->picture_analysis_number_of_regions_per_height; regionInPictureHeightIndex++) {
+
+            regionWidthOffset = (regionInPictureWidthIndex == sequence_control_set_ptr->picture_analysis_number_of_regions_per_width - 1) ?
+                sixteenth_decimated_picture_ptr->width - (sequence_control_set_ptr->picture_analysis_number_of_regions_per_width * regionWidth) :
+                0;
+
+            regionHeightOffset = (regionInPictureHeightIndex == sequence_control_set_ptr->picture_analysis_number_of_regions_per_height - 1) ?
+                sixteenth_decimated_picture_ptr->height - (sequence_control_set_ptr->picture_analysis_number_of_regions_per_height * regionHeight) :
+                0;
+
+            accumulate_region_histogram(
+                sixteenth_decimated_picture_ptr->buffer_y,
+                sixteenth_decimated_picture_ptr->stride_y,
+                sixteenth_decimated_picture_ptr->origin_x + regionInPictureWidthIndex * regionWidth,
+                sixteenth_decimated_picture_ptr->origin_y + regionInPictureHeightIndex * regionHeight,
+                regionWidth + regionWidthOffset,
+                regionHeight + regionHeightOffset,
+                1,
+                band_start,
+                band_end,
+                SEGMENT_HISTOGRAM(histogram_ptr, regionInPictureWidthIndex, regionInPictureHeightIndex, 0),
+                &statistics_ptr->region_sum[regionInPictureWidthIndex][regionInPictureHeightIndex][0]);
+        }
+    }
+
+    // Chroma histogram bins, 1/4 of the chroma rows of the band
+    regionWidth = input_picture_ptr->width / sequence_control_set_ptr->picture_analysis_number_of_regions_per_width;
+    regionHeight = input_picture_ptr->height / sequence_control_set_ptr->picture_analysis_number_of_regions_per_height;
+    band_start = row_start ? (input_picture_ptr->origin_y + row_start) >> 1 : 0;
+    band_end = last_band ? (uint32_t)~0 : (input_picture_ptr->origin_y + row_end) >> 1;
+
+    for (regionInPictureWidthIndex = 0; regionInPictureWidthIndex < sequence_control_set_ptr->picture_analysis_number_of_regions_per_width; regionInPictureWidthIndex++) {
+        for (regionInPictureHeightIndex = 0; regionInPictureHeightIndex < sequence_control_set_ptr->picture_analysis_number_of_regions_per_height; regionInPictureHeightIndex++) {
+
+            regionWidthOffset = (regionInPictureWidthIndex == sequence_control_set_ptr->picture_analysis_number_of_regions_per_width - 1) ?
+                input_picture_ptr->width - (sequence_control_set_ptr->picture_analysis_number_of_regions_per_width * regionWidth) :
+                0;
+
+            regionHeightOffset = (regionInPictureHeightIndex == sequence_control_set_ptr->picture_analysis_number_of_regions_per_height - 1) ?
+                input_picture_ptr->height - (sequence_control_set_ptr->picture_analysis_number_of_regions_per_height * regionHeight) :
+                0;
+
+            accumulate_region_histogram(
+                input_picture_ptr->bufferCb,
+                input_picture_ptr->strideCb,
+                (input_picture_ptr->origin_x + regionInPictureWidthIndex * regionWidth) >> 1,
+                (input_picture_ptr->origin_y + regionInPictureHeightIndex * regionHeight) >> 1,
+                (regionWidth + regionWidthOffset) >> 1,
+                (regionHeight + regionHeightOffset) >> 1,
+                4,
+                band_start,
+                band_end,
+                SEGMENT_HISTOGRAM(histogram_ptr, regionInPictureWidthIndex, regionInPictureHeightIndex, 1),
+                &statistics_ptr->region_sum[regionInPictureWidthIndex][regionInPictureHeightIndex][1]);
+
+            accumulate_region_histogram(
+                input_picture_ptr->bufferCr,
+                input_picture_ptr->strideCr,
+                (input_picture_ptr->origin_x + regionInPictureWidthIndex * regionWidth) >> 1,
+                (input_picture_ptr->origin_y + regionInPictureHeightIndex * regionHeight) >> 1,
+                (regionWidth + regionWidthOffset) >> 1,
+                (regionHeight + regionHeightOffset) >> 1,
+                4,
+                band_start,
+                band_end,
+                SEGMENT_HISTOGRAM(histogram_ptr, regionInPictureWidthIndex, regionInPictureHeightIndex, 2),
+                &statistics_ptr->region_sum[regionInPictureWidthIndex][regionInPictureHeightIndex][2]);
+        }
+    }
+
+    // 8x8 block means of the luma rows that are final, for the SCD_MODE_0 average intensity
+    if (sequence_control_set_ptr->scd_mode == SCD_MODE_0) {
+        const uint32_t block_rows = last_band ?
+            (uint32_t)(input_picture_ptr->height >> 3) :
+            MIN((uint32_t)(input_picture_ptr->height >> 3), (input_padded_picture_ptr->origin_y + row_end) >> 3);
+
+        for (; statistics_ptr->block_mean_rows < block_rows; ++statistics_ptr->block_mean_rows) {
+            statistics_ptr->block_mean_sum += compute_block_mean_row_sum(
+                sequence_control_set_ptr,
+                input_picture_ptr,
+                statistics_ptr->block_mean_rows,
+                asm_type);
+        }
+    }
+
+    return;
+}
+
+/************************************************
+ * Add the segment statistics to the picture ones
+ ** Returns EB_TRUE for the last segment of the picture
+ ************************************************/
+static EbBool merge_picture_statistics(
+    SequenceControlSet            *sequence_control_set_ptr,
+    PictureParentControlSet_t       *picture_control_set_ptr,
+    PictureStatistics_t             *statistics_ptr,
+    uint32_t                        *histogram_ptr,
+    EbAsm                            asm_type)
+{
+    PictureStatistics_t *picture_statistics_ptr = &picture_control_set_ptr->pa_statistics;
+    uint32_t             regionInPictureWidthIndex;
+    uint32_t             regionInPictureHeightIndex;
+    uint32_t             histogramBin;
+    uint32_t             component;
+    EbBool               last_segment;
+
+    eb_block_on_mutex(picture_control_set_ptr->analysis_segments_mutex);
+
+    if (picture_control_set_ptr->pa_segments_completion_count == 0) {
+        EB_MEMSET(picture_statistics_ptr, 0, sizeof(PictureStatistics_t));
+
+        // Initialize bins to 1
+        for (regionInPictureWidthIndex = 0; regionInPictureWidthIndex < sequence_control_set_ptr->picture_analysis_number_of_regions_per_width; regionInPictureWidthIndex++) {
+            for (regionInPictureHeightIndex = 0; regionInPictureHeightIndex < sequence_control_set_ptr->picture_analysis_number_of_regions_per_height; regionInPictureHeightIndex++) {
+                InitializeBuffer_32bits_funcPtrArray[asm_type](picture_control_set_ptr->picture_histogram[regionInPictureWidthIndex][regionInPictureHeightIndex][0], 64, 0, 1);
+                InitializeBuffer_32bits_funcPtrArray[asm_type](picture_control_set_ptr->picture_histogram[regionInPictureWidthIndex][regionInPictureHeightIndex][1], 64, 0, 1);
+                InitializeBuffer_32bits_funcPtrArray[asm_type](picture_control_set_ptr->picture_histogram[regionInPictureWidthIndex][regionInPictureHeightIndex][2], 64, 0, 1);
+            }
+        }
+    }
+
+    for (regionInPictureWidthIndex = 0; regionInPictureWidthIndex < sequence_control_set_ptr->picture_analysis_number_of_regions_per_width; regionInPictureWidthIndex++) {
+        for (regionInPictureHeightIndex = 0; regionInPictureHeightIndex < sequence_control_set_ptr->picture_analysis_number_of_regions_per_height; regionInPictureHeightIndex++) {
+            for (component = 0; component < 3; component++) {
+                uint32_t *segment_histogram = SEGMENT_HISTOGRAM(histogram_ptr, regionInPictureWidthIndex, regionInPictureHeightIndex, component);
+                uint32_t *picture_histogram = picture_control_set_ptr->picture_histogram[regionInPictureWidthIndex][regionInPictureHeightIndex][component];
+
+                for (histogramBin = 0; histogramBin < HISTOGRAM_NUMBER_OF_BINS; histogramBin++)
+                    picture_histogram[histogramBin] += segment_histogram[histogramBin];
+
+                picture_statistics_ptr->region_sum[regionInPictureWidthIndex][regionInPictureHeightIndex][component] += statistics_ptr->region_sum[regionInPictureWidthIndex][regionInPictureHeightIndex][component];
+            }
+        }
+    }
+
+    picture_statistics_ptr->pic_tot_variance += statistics_ptr->pic_tot_variance;
+    picture_statistics_ptr->block_mean_sum += statistics_ptr->block_mean_sum;
+    picture_statistics_ptr->screen_content_count += statistics_ptr->screen_content_count;
+
+    last_segment = (EbBool)(++picture_control_set_ptr->pa_segments_completion_count == picture_control_set_ptr->pa_segments_total_count);
+
+    eb_release_mutex(picture_control_set_ptr->analysis_segments_mutex);
+
+    return last_segment;
+}
+
+/************************************************
+ * Finalize the picture statistics after the last segment
+ ** Histogram scaling, average intensities, picture variance,
+ ** homogeneous regions and edge detection
+ ************************************************/
+static void finalize_picture_statistics(
+    SequenceControlSet            *sequence_control_set_ptr,
+    PictureParentControlSet_t       *picture_control_set_ptr,
+    EbPictureBufferDesc_t           *input_picture_ptr,
+    EbPictureBufferDesc_t           *input_padded_picture_ptr,
+    EbPictureBufferDesc_t           *sixteenth_decimated_picture_ptr,
+    uint32_t                         picture_height_in_sb,
+    uint32_t                         sb_total_count,
+    EbAsm                            asm_type)
+{
+    PictureStatistics_t *statistics_ptr = &picture_control_set_ptr->pa_statistics;
+    uint64_t sumAverageIntensityTotalRegionsLuma = 0;
+    uint64_t sumAverageIntensityTotalRegionsCb = 0;
+    uint64_t sumAverageIntensityTotalRegionsCr = 0;
+    uint32_t regionInPictureWidthIndex;
+    uint32_t regionInPictureHeightIndex;
+    uint32_t histogramBin;
+    uint32_t component;
+    uint32_t segment_index;
+
+    for (regionInPictureWidthIndex = 0; regionInPictureWidthIndex < sequence_control_set_ptr->picture_analysis_number_of_regions_per_width; regionInPictureWidthIndex++) {
+        for (regionInPictureHeightIndex = 0; regionInPictureHeightIndex < sequence_control_set_ptr->picture_analysis_number_of_regions_per_height; regionInPictureHeightIndex++) {
+            // Luma regions are on the 1/16 picture, chroma regions on the input picture
+            const uint32_t lumaRegionWidth = sixteenth_decimated_picture_ptr->width / sequence_control_set_ptr->picture_analysis_number_of_regions_per_width;
+            const uint32_t lumaRegionHeight = sixteenth_decimated_picture_ptr->height / sequence_control_set_ptr->picture_analysis_number_of_regions_per_height;
+            const uint32_t lumaRegionArea =
+                (lumaRegionWidth + ((regionInPictureWidthIndex == sequence_control_set_ptr->picture_analysis_number_of_regions_per_width - 1) ? sixteenth_decimated_picture_ptr->width - sequence_control_set_ptr->picture_analysis_number_of_regions_per_width * lumaRegionWidth : 0)) *
+                (lumaRegionHeight + ((regionInPictureHeightIndex == sequence_control_set_ptr->picture_analysis_number_of_regions_per_height - 1) ? sixteenth_decimated_picture_ptr->height - sequence_control_set_ptr->picture_analysis_number_of_regions_per_height * lumaRegionHeight : 0));
+            const uint32_t regionWidth = input_picture_ptr->width / sequence_control_set_ptr->picture_analysis_number_of_regions_per_width;
+            const uint32_t regionHeight = input_picture_ptr->height / sequence_control_set_ptr->picture_analysis_number_of_regions_per_height;
+            const uint32_t regionArea =
+                (regionWidth + ((regionInPictureWidthIndex == sequence_control_set_ptr->picture_analysis_number_of_regions_per_width - 1) ? input_picture_ptr->width - sequence_control_set_ptr->picture_analysis_number_of_regions_per_width * regionWidth : 0)) *
+                (regionHeight + ((regionInPictureHeightIndex == sequence_control_set_ptr->picture_analysis_number_of_regions_per_height - 1) ? input_picture_ptr->height - sequence_control_set_ptr->picture_analysis_number_of_regions_per_height * regionHeight : 0));
+            const uint64_t lumaSum = statistics_ptr->region_sum[regionInPictureWidthIndex][regionInPictureHeightIndex][0];
+            const uint64_t cbSum = statistics_ptr->region_sum[regionInPictureWidthIndex][regionInPictureHeightIndex][1] << 4;
+            const uint64_t crSum = statistics_ptr->region_sum[regionInPictureWidthIndex][regionInPictureHeightIndex][2] << 4;
+
+            picture_control_set_ptr->average_intensity_per_region[regionInPictureWidthIndex][regionInPictureHeightIndex][0] = (uint8_t)((lumaSum + (lumaRegionArea >> 1)) / lumaRegionArea);
+            picture_control_set_ptr->average_intensity_per_region[regionInPictureWidthIndex][regionInPictureHeightIndex][1] = (uint8_t)((cbSum + (regionArea >> 3)) / (regionArea >> 2));
+            picture_control_set_ptr->average_intensity_per_region[regionInPictureWidthIndex][regionInPictureHeightIndex][2] = (uint8_t)((crSum + (regionArea >> 3)) / (regionArea >> 2));
+            sumAverageIntensityTotalRegionsLuma += (lumaSum << 4);
+            sumAverageIntensityTotalRegionsCb += cbSum;
+            sumAverageIntensityTotalRegionsCr += crSum;
+
+            // Luma bins are on 1/16 of the samples, chroma bins on 1/16 of the chroma samples
+            for (component = 0; component < 3; component++) {
+                for (histogramBin = 0; histogramBin < HISTOGRAM_NUMBER_OF_BINS; histogramBin++) {
+                    picture_control_set_ptr->picture_histogram[regionInPictureWidthIndex][regionInPictureHeightIndex][component][histogramBin] =
+                        picture_control_set_ptr->picture_histogram[regionInPictureWidthIndex][regionInPictureHeightIndex][component][histogramBin] << 4;
+                }
+            }
+        }
+    }
+
+    // Input average intensity
+    if (sequence_control_set_ptr->scd_mode == SCD_MODE_0) {
+        uint64_t mean;
+
+        // 8x8 block rows across the segment boundaries
+        for (segment_index = 1; segment_index < picture_control_set_ptr->pa_segments_total_count; ++segment_index) {
+            const uint32_t boundary = input_padded_picture_ptr->origin_y + SEGMENT_START_IDX(segment_index, picture_height_in_sb, picture_control_set_ptr->pa_segments_total_count) * sequence_control_set_ptr->sb_sz;
+            if ((boundary & 7) && (boundary >> 3) < (uint32_t)(input_picture_ptr->height >> 3)) {
+                statistics_ptr->block_mean_sum += compute_block_mean_row_sum(
+                    sequence_control_set_ptr,
+                    input_picture_ptr,
+                    boundary >> 3,
+                    asm_type);
+            }
+        }
+
+        mean = statistics_ptr->block_mean_sum;
+        mean = ((mean + ((input_picture_ptr->height* input_picture_ptr->width) >> 7)) / ((input_picture_ptr->height* input_picture_ptr->width) >> 6));
+        mean = (mean + (1 << (MEAN_PRECISION - 1))) >> MEAN_PRECISION;
+        picture_control_set_ptr->average_intensity[0] = (uint8_t)mean;
+    }
+    else {
+        picture_control_set_ptr->average_intensity[0] = (uint8_t)((sumAverageIntensityTotalRegionsLuma + ((input_picture_ptr->width*input_picture_ptr->height) >> 1)) / (input_picture_ptr->width*input_picture_ptr->height));
+        picture_control_set_ptr->average_intensity[1] = (uint8_t)((sumAverageIntensityTotalRegionsCb + ((input_picture_ptr->width*input_picture_ptr->height) >> 3)) / ((input_picture_ptr->width*input_picture_ptr->height) >> 2));
+        picture_control_set_ptr->average_intensity[2] = (uint8_t)((sumAverageIntensityTotalRegionsCr + ((input_picture_ptr->width*input_picture_ptr->height) >> 3)) / ((input_picture_ptr->width*input_picture_ptr->height) >> 2));
+    }
+
+    picture_control_set_ptr->pic_avg_variance = (uint16_t)(statistics_ptr->pic_tot_variance / sb_total_count);
+    // Calculate the variance of variance to determine Homogeneous regions. Note: Variance calculation should be on.
+    DetermineHomogeneousRegionInPicture(
+        sequence_control_set_ptr,
+        picture_control_set_ptr);
+
+    EdgeDetectionMeanLumaChroma16x16(
+        sequence_control_set_ptr,
+        picture_control_set_ptr,
+        sequence_control_set_ptr->sb_total_count);
+
+    EdgeDetection(
+        sequence_control_set_ptr,
+        picture_control_set_ptr);
+
+    return;
+}
+
+
 int av1_count_colors(const uint8_t *src, int stride, int rows, int cols,
     int *val_count) {
     const int max_pix_val = 1 << 8;
@@ -4975,14 +5331,15 @@ int av1_count_colors(const uint8_t *src, int stride, int rows, int cols,
 }
 // Estimate if the source frame is screen content, based on the portion of
 // blocks that have no more than 4 (experimentally selected) luma colors.
-static int is_screen_content(const uint8_t *src, int use_hbd,
-    int stride, int width, int height) {
+// Counts these blocks in the rows [row_start, row_end).
+static int count_screen_content_blocks(const uint8_t *src, int use_hbd,
+    int stride, int width, int height, int row_start, int row_end) {
     assert(src != NULL);
     int counts = 0;
     const int blk_w = 16;
     const int blk_h = 16;
     const int limit = 4;
-    for (int r = 0; r + blk_h <= height; r += blk_h) {
+    for (int r = row_start; r < row_end && r + blk_h <= height; r += blk_h) {
         for (int c = 0; c + blk_w <= width; c += blk_w) {
             int count_buf[1 << 12];  // Maximum (1 << 12) color levels.
             const int n_colors =
@@ -4993,8 +5350,7 @@ static int is_screen_content(const uint8_t *src, int use_hbd,
             if (n_colors > 1 && n_colors <= limit) counts++;
         }
     }
-    // The threshold is 10%.
-    return counts * blk_h * blk_w * 10 > width * height;
+    return counts;
 }
 
 
@@ -5028,8 +5384,16 @@ void* picture_analysis_kernel(void *input_ptr)
     uint32_t                          picture_width_in_sb;
     uint32_t                          pictureHeighInLcu;
     uint32_t                          sb_total_count;
+    uint32_t                          sb_row_index;
+    uint32_t                          sb_index;
+    PictureStatistics_t               segment_statistics;
     EbAsm                          asm_type;
 
+    // Segments
+    uint32_t                          segment_index;
+    uint32_t                          sb_row_start;
+    uint32_t                          sb_row_end;
+
     for (;;) {
 
         // Get Input Full Object
@@ -5054,63 +5418,97 @@ void* picture_analysis_kernel(void *input_ptr)
 
         asm_type = sequence_control_set_ptr->encode_context_ptr->asm_type;
 
+        segment_index = inputResultsPtr->segment_index;
+        sb_row_start = SEGMENT_START_IDX(segment_index, pictureHeighInLcu, picture_control_set_ptr->pa_segments_total_count);
+        sb_row_end = SEGMENT_END_IDX(segment_index, pictureHeighInLcu, picture_control_set_ptr->pa_segments_total_count);
+
         // Set picture parameters to account for subpicture, picture scantype, and set regions by resolutions
         SetPictureParametersForStatisticsGathering(
             sequence_control_set_ptr);
 
+        if (segment_index == 0) {
+            // The film grain denoising works on the whole picture (the picture is then a single segment)
+            if (sequence_control_set_ptr->film_grain_denoise_strength) {
+                // Pad pictures to multiple min cu size
+                PadPictureToMultipleOfMinCuSizeDimensions(
+                    sequence_control_set_ptr,
+                    input_picture_ptr,
+                    0,
+                    input_picture_ptr->height);
+            }
 
+            // Pre processing operations performed on the input picture
+            PicturePreProcessingOperations(
+                picture_control_set_ptr,
+                input_picture_ptr,
+                sequence_control_set_ptr,
+                quarter_decimated_picture_ptr,
+                sixteenth_decimated_picture_ptr,
+                sb_total_count,
+                asm_type);
+        }
 
-        // Pad pictures to multiple min cu size
-        PadPictureToMultipleOfMinCuSizeDimensions(
-            sequence_control_set_ptr,
-            input_picture_ptr);
-
-        // Pre processing operations performed on the input picture
-        PicturePreProcessingOperations(
-            picture_control_set_ptr,
-            input_picture_ptr,
+        // Padding, 1/4 & 1/16 decimation and statistics gathering (variance, histogram bins)
+        // done one SB row at a time, so that each row of the input is streamed through the cache once
+        init_segment_statistics(
             sequence_control_set_ptr,
-            quarter_decimated_picture_ptr,
-            sixteenth_decimated_picture_ptr,
-            sb_total_count,
-            asm_type);
+            input_padded_picture_ptr,
+            &segment_statistics,
+            context_ptr->segment_histogram,
+            sb_row_start);
 
-        if (input_picture_ptr->color_format >= EB_YUV422) {
-            // Jing: Do the conversion of 422/444=>420 here since it's multi-threaded kernel
-            //       Reuse the Y, only add cb/cr in the newly created buffer desc
-            //       NOTE: since denoise may change the src, so this part is after PicturePreProcessingOperations()
-            picture_control_set_ptr->chroma_downsampled_picture_ptr->buffer_y = input_picture_ptr->buffer_y;
-            DownSampleChroma(input_picture_ptr, picture_control_set_ptr->chroma_downsampled_picture_ptr);
-        } else {
-            picture_control_set_ptr->chroma_downsampled_picture_ptr = input_picture_ptr;
+        for (sb_row_index = sb_row_start; sb_row_index < sb_row_end; ++sb_row_index) {
+            picture_analysis_sb_row(
+                sequence_control_set_ptr,
+                picture_control_set_ptr,
+                picture_control_set_ptr->chroma_downsampled_picture_ptr, //420 input_picture_ptr
+                input_padded_picture_ptr,
+                quarter_decimated_picture_ptr,
+                sixteenth_decimated_picture_ptr,
+                &segment_statistics,
+                context_ptr->segment_histogram,
+                sb_row_index,
+                picture_width_in_sb,
+                asm_type);
         }
 
-        // Pad input picture to complete border LCUs
-        PadPictureToMultipleOfLcuDimensions(
-            input_padded_picture_ptr);
+        segment_statistics.screen_content_count = count_screen_content_blocks(
+            input_picture_ptr->buffer_y + input_picture_ptr->origin_x + input_picture_ptr->origin_y*input_picture_ptr->stride_y,
+            0,
+            input_picture_ptr->stride_y,
+            sequence_control_set_ptr->luma_width, sequence_control_set_ptr->luma_height,
+            sb_row_start * sequence_control_set_ptr->sb_sz, sb_row_end * sequence_control_set_ptr->sb_sz);
 
-        // 1/4 & 1/16 input picture decimation
-        DecimateInputPicture(
+        // Hold the 64x64 variance and mean in the reference frame
+        for (sb_index = sb_row_start * picture_width_in_sb; sb_index < MIN(sb_row_end * picture_width_in_sb, picture_control_set_ptr->sb_total_count); ++sb_index) {
+            paReferenceObject->variance[sb_index] = picture_control_set_ptr->variance[sb_index][ME_TIER_ZERO_PU_64x64];
+            paReferenceObject->y_mean[sb_index] = picture_control_set_ptr->y_mean[sb_index][ME_TIER_ZERO_PU_64x64];
+
+        }
+
+        if (!merge_picture_statistics(
+            sequence_control_set_ptr,
             picture_control_set_ptr,
-            input_padded_picture_ptr,
-            quarter_decimated_picture_ptr,
-            sixteenth_decimated_picture_ptr);
+            &segment_statistics,
+            context_ptr->segment_histogram,
+            asm_type)) {
+            // Release the Input Results
+            eb_release_object(inputResultsWrapperPtr);
+            continue;
+        }
 
-        // Gathering statistics of input picture, including Variance Calculation, Histogram Bins
-        GatheringPictureStatistics(
+        finalize_picture_statistics(
             sequence_control_set_ptr,
             picture_control_set_ptr,
-			picture_control_set_ptr->chroma_downsampled_picture_ptr, //420 input_picture_ptr
+            picture_control_set_ptr->chroma_downsampled_picture_ptr,
             input_padded_picture_ptr,
             sixteenth_decimated_picture_ptr,
+            pictureHeighInLcu,
             sb_total_count,
             asm_type);
 
-        picture_control_set_ptr->sc_content_detected = is_screen_content(
-            input_picture_ptr->buffer_y + input_picture_ptr->origin_x + input_picture_ptr->origin_y*input_picture_ptr->stride_y,
-            0,
-            input_picture_ptr->stride_y,
-            sequence_control_set_ptr->luma_width, sequence_control_set_ptr->luma_height);       
+        // The threshold is 10%.
+        picture_control_set_ptr->sc_content_detected = picture_control_set_ptr->pa_statistics.screen_content_count * 16 * 16 * 10 > sequence_control_set_ptr->luma_width * sequence_control_set_ptr->luma_height;
         if (picture_control_set_ptr->sc_content_detected) {
             if (picture_control_set_ptr->pic_avg_variance > 1000)
                 picture_control_set_ptr->sc_content_detected = 1;
@@ -5122,13 +5520,6 @@ void* picture_analysis_kernel(void *input_ptr)
 #if HARD_CODE_SC_SETTING
         picture_control_set_ptr->sc_content_detected = EB_TRUE;
 #endif
-        // Hold the 64x64 variance and mean in the reference frame
-        uint32_t sb_index;
-        for (sb_index = 0; sb_index < picture_control_set_ptr->sb_total_count; ++sb_index) {
-            paReferenceObject->variance[sb_index] = picture_control_set_ptr->variance[sb_index][ME_TIER_ZERO_PU_64x64];
-            paReferenceObject->y_mean[sb_index] = picture_control_set_ptr->y_mean[sb_index][ME_TIER_ZERO_PU_64x64];
-
-        }
 
         // Get Empty Results Object
         eb_get_empty_object(
@@ -21,6 +21,7 @@ typedef struct PictureAnalysisContext_s
     EbPictureBufferDesc_t        *denoised_picture_ptr;
     EbPictureBufferDesc_t        *noise_picture_ptr;
     double                          picNoiseVarianceFloat;
+    uint32_t                       *segment_histogram;      // histogram bins of the segment, per region & component
 } PictureAnalysisContext_t;
 
 /***************************************
@@ -165,7 +165,9 @@ EbErrorType picture_control_set_ctor(
         }
     }
 
-    if (is16bit) {
+    // The native 16 bit pipeline uses the input picture in place
+    object_ptr->input_frame16bit = (EbPictureBufferDesc_t *)EB_NULL;
+    if (is16bit && !initDataPtr->native_16bit_pipeline) {
         return_error = eb_picture_buffer_desc_ctor(
             (EbPtr*)&(object_ptr->input_frame16bit),
             (EbPtr)&coeffBufferDescInitData);
@@ -343,7 +345,7 @@ EbErrorType picture_control_set_ctor(
             &object_ptr->md_luma_recon_neighbor_array[depth],
             MAX_PICTURE_WIDTH_SIZE,
             MAX_PICTURE_HEIGHT_SIZE,
-            sizeof(uint8_t),
+            initDataPtr->native_16bit_pipeline ? sizeof(uint16_t) : sizeof(uint8_t),
             SAMPLE_NEIGHBOR_ARRAY_GRANULARITY,
             SAMPLE_NEIGHBOR_ARRAY_GRANULARITY,
             NEIGHBOR_ARRAY_UNIT_FULL_MASK);
@@ -355,7 +357,7 @@ EbErrorType picture_control_set_ctor(
             &object_ptr->md_cb_recon_neighbor_array[depth],
             MAX_PICTURE_WIDTH_SIZE >> subsampling_x,
             MAX_PICTURE_HEIGHT_SIZE >> subsampling_y,
-            sizeof(uint8_t),
+            initDataPtr->native_16bit_pipeline ? sizeof(uint16_t) : sizeof(uint8_t),
             SAMPLE_NEIGHBOR_ARRAY_GRANULARITY,
             SAMPLE_NEIGHBOR_ARRAY_GRANULARITY,
             NEIGHBOR_ARRAY_UNIT_FULL_MASK);
@@ -368,7 +370,7 @@ EbErrorType picture_control_set_ctor(
             &object_ptr->md_cr_recon_neighbor_array[depth],
             MAX_PICTURE_WIDTH_SIZE >> subsampling_x,
             MAX_PICTURE_HEIGHT_SIZE >> subsampling_y,
-            sizeof(uint8_t),
+            initDataPtr->native_16bit_pipeline ? sizeof(uint16_t) : sizeof(uint8_t),
             SAMPLE_NEIGHBOR_ARRAY_GRANULARITY,
             SAMPLE_NEIGHBOR_ARRAY_GRANULARITY,
             NEIGHBOR_ARRAY_UNIT_FULL_MASK);
@@ -950,6 +952,53 @@ EbErrorType picture_parent_control_set_ctor(
         return EB_ErrorBadParameter;
     }
 
+    // The native 16 bit pipeline keeps the input unsplit, the picture analysis
+    // and the motion estimation work on an 8 bit copy of its most significant bits
+    object_ptr->native_input_picture_ptr = (EbPictureBufferDesc_t *)EB_NULL;
+    object_ptr->input_msb_picture_ptr = (EbPictureBufferDesc_t *)EB_NULL;
+    if (initDataPtr->native_16bit_pipeline) {
+        EbPictureBufferDescInitData_t input_msb_picture_desc_init_data;
+        input_msb_picture_desc_init_data.maxWidth = initDataPtr->picture_width;
+        input_msb_picture_desc_init_data.maxHeight = initDataPtr->picture_height;
+        input_msb_picture_desc_init_data.bit_depth = EB_8BIT;
+        input_msb_picture_desc_init_data.color_format = initDataPtr->color_format;
+        input_msb_picture_desc_init_data.bufferEnableMask = PICTURE_BUFFER_DESC_FULL_MASK;
+        input_msb_picture_desc_init_data.left_padding = initDataPtr->left_padding;
+        input_msb_picture_desc_init_data.right_padding = initDataPtr->right_padding;
+        input_msb_picture_desc_init_data.top_padding = initDataPtr->top_padding;
+        input_msb_picture_desc_init_data.bot_padding = initDataPtr->bot_padding;
+        input_msb_picture_desc_init_data.splitMode = EB_FALSE;
+        return_error = eb_picture_buffer_desc_ctor(
+            (EbPtr*)&(object_ptr->input_msb_picture_ptr),
+            (EbPtr)&input_msb_picture_desc_init_data);
+        if (return_error == EB_ErrorInsufficientResources) {
+            return EB_ErrorInsufficientResources;
+        }
+    }
+
+    // The film grain denoise works in place on the input picture, the stat
+    // report keeps its own copy of the source
+    object_ptr->save_source_picture_ptr = (EbPictureBufferDesc_t *)EB_NULL;
+    if (initDataPtr->film_grain_noise_level && (initDataPtr->stat_report || initDataPtr->film_grain_update_period > 1)) {
+        EbPictureBufferDescInitData_t save_source_picture_desc_init_data;
+        save_source_picture_desc_init_data.maxWidth = initDataPtr->picture_width;
+        save_source_picture_desc_init_data.maxHeight = initDataPtr->picture_height;
+        save_source_picture_desc_init_data.bit_depth = initDataPtr->bit_depth > EB_8BIT ? EB_16BIT : EB_8BIT;
+        save_source_picture_desc_init_data.color_format = EB_YUV420;
+        save_source_picture_desc_init_data.bufferEnableMask = PICTURE_BUFFER_DESC_FULL_MASK;
+        save_source_picture_desc_init_data.left_padding = initDataPtr->left_padding;
+        save_source_picture_desc_init_data.right_padding = initDataPtr->right_padding;
+        save_source_picture_desc_init_data.top_padding = initDataPtr->top_padding;
+        save_source_picture_desc_init_data.bot_padding = initDataPtr->bot_padding;
+        save_source_picture_desc_init_data.splitMode = EB_FALSE;
+        return_error = eb_picture_buffer_desc_ctor(
+            (EbPtr*)&(object_ptr->save_source_picture_ptr),
+            (EbPtr)&save_source_picture_desc_init_data);
+        if (return_error == EB_ErrorInsufficientResources) {
+            return EB_ErrorInsufficientResources;
+        }
+    }
+
     // GOP
     object_ptr->pred_struct_index = 0;
     object_ptr->picture_number = 0;
@@ -1012,9 +1061,12 @@ EbErrorType picture_parent_control_set_ctor(
     // Motion Estimation Results
     object_ptr->max_number_of_pus_per_sb = (initDataPtr->ext_block_flag) ? MAX_ME_PU_COUNT : SQUARE_PU_COUNT;
     EB_MALLOC(MeCuResults_t**, object_ptr->me_results, sizeof(MeCuResults_t*) * object_ptr->sb_total_count, EB_N_PTR);
+    // One contiguous block for the whole picture, SBs are consumed in raster order by MD
+    MeCuResults_t *contiguous_me_results;
+    EB_MALLOC(MeCuResults_t*, contiguous_me_results, sizeof(MeCuResults_t) * MAX_ME_PU_COUNT * object_ptr->sb_total_count, EB_N_PTR);
 
     for (sb_index = 0; sb_index < object_ptr->sb_total_count; ++sb_index) {
-        EB_MALLOC(MeCuResults_t*, object_ptr->me_results[sb_index], sizeof(MeCuResults_t) * MAX_ME_PU_COUNT, EB_N_PTR);
+        object_ptr->me_results[sb_index] = &contiguous_me_results[sb_index * MAX_ME_PU_COUNT];
     }
     EB_MALLOC(uint32_t*, object_ptr->rc_me_distortion, sizeof(uint32_t) * object_ptr->sb_total_count, EB_N_PTR);
     // ME and OIS Distortion Histograms
@@ -1066,7 +1118,10 @@ EbErrorType picture_parent_control_set_ctor(
     }
 
     EB_MALLOC(uint8_t*, object_ptr->sb_cmplx_contrast_array, sizeof(uint8_t) * object_ptr->sb_total_count, EB_N_PTR);
+    EB_MALLOC(uint8_t*, object_ptr->sb_high_contrast_array, sizeof(uint8_t) * object_ptr->sb_total_count, EB_N_PTR);
     EB_MALLOC(uint8_t*, object_ptr->sb_high_contrast_array_dialated, sizeof(uint8_t) * object_ptr->sb_total_count, EB_N_PTR);
+    EB_MALLOC(uint8_t*, object_ptr->gm_explained_sb_array[REF_LIST_0], sizeof(uint8_t) * object_ptr->sb_total_count, EB_N_PTR);
+    EB_MALLOC(uint8_t*, object_ptr->gm_explained_sb_array[REF_LIST_1], sizeof(uint8_t) * object_ptr->sb_total_count, EB_N_PTR);
 
     object_ptr->cu32x32_clean_sparse_coeff_map_array_stride = (uint16_t)((initDataPtr->picture_width + 32 - 1) / 32);
     object_ptr->cu32x32_clean_sparse_coeff_map_array_size = (uint16_t)(((initDataPtr->picture_width + 32 - 1) / 32) * ((initDataPtr->picture_height + 32 - 1) / 32));
@@ -1079,6 +1134,12 @@ EbErrorType picture_parent_control_set_ctor(
 
     EB_CREATEMUTEX(EbHandle, object_ptr->rc_distortion_histogram_mutex, sizeof(EbHandle), EB_MUTEX);
 
+    EB_CREATEMUTEX(EbHandle, object_ptr->analysis_segments_mutex, sizeof(EbHandle), EB_MUTEX);
+
+    EB_CREATEMUTEX(EbHandle, object_ptr->gm_estimation_mutex, sizeof(EbHandle), EB_MUTEX);
+
+    EB_CREATESEMAPHORE(EbHandle, object_ptr->stat_done_semaphore, sizeof(EbHandle), EB_SEMAPHORE, 0, 1);
+
     EB_MALLOC(EB_SB_DEPTH_MODE*, object_ptr->sb_depth_mode_array, sizeof(EB_SB_DEPTH_MODE) * object_ptr->sb_total_count, EB_N_PTR);
 
     EB_MALLOC(Av1Common*, object_ptr->av1_cm, sizeof(Av1Common), EB_N_PTR);
@@ -38,7 +38,7 @@ extern "C" {
 #endif
 
 #define SEGMENT_ENTROPY_BUFFER_SIZE         40000000 // Entropy Bitstream Buffer Size
-#define PACKETIZATION_PROCESS_BUFFER_SIZE SEGMENT_ENTROPY_BUFFER_SIZE
+#define PACKETIZATION_PROCESS_BUFFER_SIZE   0x10000  // Sequence and frame headers only, the tile data stays in the entropy buffer
 #define HISTOGRAM_NUMBER_OF_BINS            256
 #define MAX_NUMBER_OF_REGIONS_IN_WIDTH      4
 #define MAX_NUMBER_OF_REGIONS_IN_HEIGHT     4
@@ -13734,6 +13734,7 @@ extern "C" {
         EbHandle                              entropy_coding_mutex;
         EbBool                                entropy_coding_in_progress;
         EbBool                                entropy_coding_pic_done;
+        EbBool                                sb_symbols_dropped;         // A symbol stream could not be recorded, entropy coding runs write_sb
         EbHandle                              intra_mutex;
         uint32_t                              intra_coded_area;
         uint32_t                              tot_seg_searched_cdef;
@@ -13933,6 +13934,44 @@ extern "C" {
 
     } SbStat_t;
 
+    /**************************************
+     * Picture analysis statistics, summed over the PA segments
+     **************************************/
+    typedef struct PictureStatistics_s {
+        uint64_t          region_sum[MAX_NUMBER_OF_REGIONS_IN_WIDTH][MAX_NUMBER_OF_REGIONS_IN_HEIGHT][3];
+        uint64_t          pic_tot_variance;
+        uint64_t          block_mean_sum;           // SCD_MODE_0 sum of the 8x8 block means
+        uint32_t          block_mean_rows;          // 8x8 block rows already in block_mean_sum
+        uint32_t          screen_content_count;     // 16x16 blocks of 2 to 4 luma colors
+    } PictureStatistics_t;
+
+    /**************************************
+     * Source based operations counters, summed over the SBO segments
+     **************************************/
+    typedef struct SourceBasedStatistics_s {
+        uint32_t          picture_num_grass_sb;
+        uint32_t          sb_high_contrast_count;
+        uint32_t          complete_sb_count;
+        uint32_t          sb_cmplx_contrast_count;
+        uint32_t          count_of_moving_sbs;
+        uint32_t          count_of_non_moving_sbs;
+        uint64_t          y_non_moving_mean;
+        uint64_t          y_moving_mean;
+        uint32_t          to_be_intra_coded_probability;
+        uint32_t          depth1_block_num;
+    } SourceBasedStatistics_t;
+
+    // Camera model fitted on the 1/16 decimated pictures, relative to the picture centre
+    typedef struct GlobalMotionEstimate_s {
+        EbBool            valid;
+        int32_t           trans_x;          // quarter-pel
+        int32_t           trans_y;          // quarter-pel
+        int32_t           zoom;             // WARPEDMODEL_PREC_BITS, 0 = no zoom
+        int32_t           rot;              // WARPEDMODEL_PREC_BITS
+        uint32_t          sample_count;
+        uint32_t          inlier_count;
+    } GlobalMotionEstimate_t;
+
     //CHKN
     // Add the concept of PictureParentControlSet which is a subset of the old PictureControlSet.
     // It actually holds only high level Pciture based control data:(GOP management,when to start a picture, when to release the PCS, ....).
@@ -13945,6 +13984,9 @@ extern "C" {
         EbObjectWrapper                    *reference_picture_wrapper_ptr;
         EbObjectWrapper                    *pa_reference_picture_wrapper_ptr;
         EbPictureBufferDesc_t                *enhanced_picture_ptr;
+        EbPictureBufferDesc_t                *native_input_picture_ptr; // native 16 bit pipeline: the unsplit 16 bit input, enhanced_picture_ptr is then input_msb_picture_ptr
+        EbPictureBufferDesc_t                *input_msb_picture_ptr;    // native 16 bit pipeline: 8 bit copy of the input most significant bits, for PA and ME
+        EbPictureBufferDesc_t                *save_source_picture_ptr; // source before the film grain denoise, for the stat report and the scene change grain estimate (16 bit packed if 10 bit)
         EbPictureBufferDesc_t                *chroma_downsampled_picture_ptr; //if 422/444 input, down sample to 420 for MD
         PredictionStructure_t                *pred_struct_ptr;          // need to check
         struct SequenceControlSet          *sequence_control_set_ptr;
@@ -14012,9 +14054,19 @@ extern "C" {
         uint64_t                              last_idr_picture;
         uint64_t                              start_time_seconds;
         uint64_t                              start_time_u_seconds;
-        uint32_t                              luma_sse;
-        uint32_t                              cr_sse;
-        uint32_t                              cb_sse;
+
+        // Deadline Control
+        uint8_t                               dl_me_level;          // ME speed-up steps on top of the preset
+        uint8_t                               dl_md_level;          // MD speed-up steps on top of the preset
+        double                                dl_me_time;           // ME time accumulated over all segments (ms)
+        double                                dl_md_time;           // EncDec time accumulated over all segments (ms)
+        uint64_t                              luma_sse;
+        uint64_t                              cr_sse;
+        uint64_t                              cb_sse;
+        double                                luma_ssim;
+        double                                cr_ssim;
+        double                                cb_ssim;
+        EbHandle                              stat_done_semaphore;  // posted by the Stat process once the above are set
 
         // Pre Analysis
         EbObjectWrapper                    *ref_pa_pic_ptr_array[MAX_NUM_OF_REF_PIC_LIST];
@@ -14052,6 +14104,7 @@ extern "C" {
         EbBool                                logo_pic_flag;                    // used by EncDecProcess()
         uint64_t                            **var_of_var32x32_based_sb_array;    // used by ModeDecisionConfigurationProcess()- the variance of 8x8 block variances for each 32x32 block
         uint8_t                              *sb_cmplx_contrast_array;            // used by EncDecProcess()
+        uint8_t                              *sb_high_contrast_array;
         uint8_t                              *sb_high_contrast_array_dialated;
         uint64_t                            **sb_y_src_energy_cu_array;            // used by ModeDecisionConfigurationProcess()     0- 64x64, 1-4 32x32
         uint64_t                            **sb_y_src_mean_cu_array;            // used by ModeDecisionConfigurationProcess()     0- 64x64, 1-4 32x32
@@ -14096,6 +14149,20 @@ extern "C" {
         uint8_t                               me_segments_column_count;
         uint8_t                               me_segments_row_count;
         uint64_t                              me_segments_completion_mask;
+        uint16_t                              pa_segments_total_count;
+        uint16_t                              pa_segments_completion_count;
+        uint16_t                              sbo_segments_total_count;
+        uint16_t                              sbo_segments_completion_count;
+        EbHandle                              analysis_segments_mutex;
+        PictureStatistics_t                   pa_statistics;
+        SourceBasedStatistics_t               sbo_statistics;
+
+        // Global Motion Estimation
+        uint8_t                               gm_level;
+        GlobalMotionEstimate_t                gm_estimate[MAX_NUM_OF_REF_PIC_LIST];
+        uint8_t                              *gm_explained_sb_array[MAX_NUM_OF_REF_PIC_LIST];
+        EbBool                                gm_estimated;         // set by the first ME segment of the picture
+        EbHandle                              gm_estimation_mutex;
 
         // Motion Estimation Results
         uint8_t                               max_number_of_pus_per_sb;
@@ -14135,6 +14202,7 @@ extern "C" {
         // Multi-modes signal(s) 
         EbPictureDepthMode                    pic_depth_mode;
         uint8_t                               loop_filter_mode;
+        uint8_t                               loop_filter_search_row_step;
         uint8_t                               intra_pred_mode;
 #if M8_SKIP_BLK
         uint8_t                               skip_sub_blks;
@@ -14280,6 +14348,7 @@ extern "C" {
         Macroblock                           *av1x;
         int32_t                               film_grain_params_present; //todo (AN): Do we need this flag at picture level?
         aom_film_grain_t                      film_grain_params;
+        EbBool                                film_grain_params_estimated; // film_grain_params were estimated on this picture
         struct aom_denoise_and_model_t       *denoise_and_model;
         EbBool                                enable_in_loop_motion_estimation_flag;
         RestUnitSearchInfo                   *rusi_picture[3];//for 3 planes
@@ -14316,11 +14385,14 @@ extern "C" {
         //EbBool                             is16bit;
         uint32_t                           ten_bit_format;
         uint32_t                           compressed_ten_bit_format;
+        uint8_t                            native_16bit_pipeline;
         uint16_t                           enc_dec_segment_col;
         uint16_t                           enc_dec_segment_row;
         EbEncMode                          enc_mode;
         uint8_t                            speed_control;
         uint16_t                           film_grain_noise_level;
+        uint32_t                           film_grain_update_period;
+        uint32_t                           stat_report;
         //uint32_t                           encoder_bit_depth;
         EbBool                             ext_block_flag;
         EbBool                             in_loop_me_flag;
@@ -15,6 +15,7 @@
 #include "EbPictureDecisionResults.h"
 #include "EbReferenceObject.h"
 #include "EbSvtAv1ErrorCodes.h"
+#include "noise_model.h"
 
 /************************************************
  * Defines
@@ -82,6 +83,8 @@ EbErrorType picture_decision_context_ctor(
 
     context_ptr->isSceneChangeDetected = EB_FALSE;
 
+    memset(&context_ptr->last_film_grain_params, 0, sizeof(context_ptr->last_film_grain_params));
+
 #if BASE_LAYER_REF
     context_ptr->last_islice_picture_number = 0;
 #endif
@@ -749,6 +752,10 @@ EbErrorType signal_derivation_multi_processes_oq(
     else
         picture_control_set_ptr->nsq_search_level = NSQ_SEARCH_OFF;
 
+    // Deadline Control: lower the NSQ search level by one level per MD speed level (NSQ is kept ON when enabled by the preset)
+    if (picture_control_set_ptr->nsq_search_level != NSQ_SEARCH_OFF && picture_control_set_ptr->dl_md_level)
+        picture_control_set_ptr->nsq_search_level = (uint8_t)MAX(NSQ_SEARCH_LEVEL1, (int32_t)MIN(picture_control_set_ptr->nsq_search_level, NSQ_SEARCH_LEVEL6) - picture_control_set_ptr->dl_md_level);
+
     switch (picture_control_set_ptr->nsq_search_level) {
     case NSQ_SEARCH_OFF:
         picture_control_set_ptr->nsq_max_shapes_md = 0;
@@ -859,6 +866,12 @@ EbErrorType signal_derivation_multi_processes_oq(
     else {
         picture_control_set_ptr->loop_filter_mode = 0;
     }
+
+    // Loop filter search SB row step               Settings
+    // 1                                            Every SB row is filtered and measured
+    // N                                            One SB row out of N (frame-based modes only)
+    picture_control_set_ptr->loop_filter_search_row_step =
+        (picture_control_set_ptr->loop_filter_mode >= 2 && picture_control_set_ptr->sequence_control_set_ptr->input_resolution == INPUT_SIZE_4K_RANGE) ? 2 : 1;
     // CDEF Level                                   Settings
     // 0                                            OFF
     // 1                                            1 step refinement
@@ -994,6 +1007,15 @@ EbErrorType signal_derivation_multi_processes_oq(
     else
         picture_control_set_ptr->skip_tx_search = 1;
 
+    // Global motion estimation Level               Settings
+    // 0                                            OFF
+    // 1                                            ROTZOOM fit on the 1/16 pictures, HME skipped and
+    //                                              full search narrowed for the SBs the model explains
+    if (picture_control_set_ptr->enc_mode <= ENC_M0)
+        picture_control_set_ptr->gm_level = 0;
+    else
+        picture_control_set_ptr->gm_level = 1;
+
     // Intra prediction modes                       Settings
     // 0                                            FULL  
     // 1                                            LIGHT per block : disable_z2_prediction && disable_angle_refinement  for 64/32/4
@@ -1838,7 +1860,9 @@ void* picture_decision_kernel(void *input_ptr)
                 encode_context_ptr->pre_assignment_buffer_idr_count += picture_control_set_ptr->idr_flag;
                 encode_context_ptr->pre_assignment_buffer_count += 1;
 
-                if (sequence_control_set_ptr->static_config.rate_control_mode)
+                // The analysis pass follows the rate control rule so that its per-picture
+                // slice types and temporal layers line up with the rate control pass
+                if (sequence_control_set_ptr->static_config.rate_control_mode || sequence_control_set_ptr->static_config.rc_firstpass_stats_out)
                 {
                     // Increment the Intra Period Position
                     encode_context_ptr->intra_period_position = (encode_context_ptr->intra_period_position == (uint32_t)sequence_control_set_ptr->intra_period_length) ? 0 : encode_context_ptr->intra_period_position + 1;
@@ -2121,6 +2145,23 @@ void* picture_decision_kernel(void *input_ptr)
 
                             preAssignmentBufferFirstPassFlag = EB_FALSE;
 
+                            // Film grain (reusing the last estimated grain between two estimations)
+                            if (sequence_control_set_ptr->film_grain_denoise_strength && sequence_control_set_ptr->film_grain_update_period > 1) {
+                                // A new scene does not keep the grain of the previous one
+                                if (!picture_control_set_ptr->film_grain_params_estimated && picture_control_set_ptr->scene_change_flag && picture_control_set_ptr->save_source_picture_ptr) {
+                                    picture_control_set_ptr->film_grain_params_estimated = (EbBool)aom_denoise_and_model_estimate(
+                                        picture_control_set_ptr->denoise_and_model,
+                                        picture_control_set_ptr->save_source_picture_ptr,
+                                        &picture_control_set_ptr->film_grain_params,
+                                        sequence_control_set_ptr->static_config.encoder_bit_depth > EB_8BIT);
+                                    sequence_control_set_ptr->film_grain_params_present |= picture_control_set_ptr->film_grain_params.apply_grain;
+                                }
+                                if (picture_control_set_ptr->film_grain_params_estimated)
+                                    context_ptr->last_film_grain_params = picture_control_set_ptr->film_grain_params;
+                                else
+                                    picture_control_set_ptr->film_grain_params = context_ptr->last_film_grain_params;
+                            }
+
                             // Film grain (assigning the random-seed)
                             {
                                 uint16_t *fgn_random_seed_ptr = &picture_control_set_ptr->sequence_control_set_ptr->film_grain_random_seed;
@@ -2528,6 +2569,9 @@ void* picture_decision_kernel(void *input_ptr)
                             picture_control_set_ptr->me_segments_total_count = (uint16_t)(picture_control_set_ptr->me_segments_column_count  * picture_control_set_ptr->me_segments_row_count);
                             picture_control_set_ptr->me_segments_completion_mask = 0;
 
+                            // The camera motion model is fitted by the first ME segment
+                            picture_control_set_ptr->gm_estimated = EB_FALSE;
+
                             // Post the results to the ME processes
                             {
                                 uint32_t segment_index;
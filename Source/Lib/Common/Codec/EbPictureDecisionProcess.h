@@ -8,6 +8,7 @@
 
 #include "EbDefinitions.h"
 #include "EbSystemResourceManager.h"
+#include "grainSynthesis.h"
 
 /**************************************
  * Context
@@ -47,6 +48,7 @@ typedef struct PictureDecisionContext_s
     EbBool miniGopToggle;    //mini GOP toggling since last Key Frame  K-0-1-0-1-0-K-0-1-0-1-K-0-1.....
     uint64_t         last_islice_picture_number;
     uint8_t         last_i_picture_sc_detection;
+    aom_film_grain_t last_film_grain_params;  // Grain of the last estimated picture, reused until the next estimation
 } PictureDecisionContext_t;
 
 /***************************************
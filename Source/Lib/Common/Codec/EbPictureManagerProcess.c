@@ -688,6 +688,10 @@ void* picture_manager_kernel(void *input_ptr)
 
                         ChildPictureControlSetPtr->parent_pcs_ptr->childPcs = ChildPictureControlSetPtr;
 
+                        // The native 16 bit pipeline encodes straight from the 16 bit input
+                        if (entryPictureControlSetPtr->native_input_picture_ptr)
+                            ChildPictureControlSetPtr->input_frame16bit = entryPictureControlSetPtr->native_input_picture_ptr;
+
 
                         //2. Have some common information between  ChildPCS and ParentPCS.
                         ChildPictureControlSetPtr->sequence_control_set_wrapper_ptr = entryPictureControlSetPtr->sequence_control_set_wrapper_ptr;
@@ -722,6 +726,7 @@ void* picture_manager_kernel(void *input_ptr)
                             ChildPictureControlSetPtr->entropy_coding_current_available_row = 0;
                             ChildPictureControlSetPtr->entropy_coding_row_count = picture_height_in_sb;
                             ChildPictureControlSetPtr->entropy_coding_in_progress = EB_FALSE;
+                            ChildPictureControlSetPtr->sb_symbols_dropped = EB_FALSE;
 
                             for (row_index = 0; row_index < MAX_LCU_ROWS; ++row_index) {
                                 ChildPictureControlSetPtr->entropy_coding_row_array[row_index] = EB_FALSE;
@@ -313,7 +313,36 @@ void mode_decision_update_neighbor_arrays(
         bheight,
         NEIGHBOR_ARRAY_UNIT_TOP_AND_LEFT_ONLY_MASK);
 
-    if (intraMdOpenLoop == EB_FALSE)
+    if (intraMdOpenLoop == EB_FALSE && context_ptr->hbd_mode_decision) {
+        update_recon_neighbor_array16bit(
+            context_ptr->luma_recon_neighbor_array,
+            (uint16_t*)context_ptr->cu_ptr->neigh_top_recon[0],
+            (uint16_t*)context_ptr->cu_ptr->neigh_left_recon[0],
+            origin_x,
+            origin_y,
+            context_ptr->blk_geom->bwidth,
+            context_ptr->blk_geom->bheight);
+
+        if (context_ptr->blk_geom->has_uv && context_ptr->chroma_level == CHROMA_MODE_0) {
+            update_recon_neighbor_array16bit(
+                context_ptr->cb_recon_neighbor_array,
+                (uint16_t*)context_ptr->cu_ptr->neigh_top_recon[1],
+                (uint16_t*)context_ptr->cu_ptr->neigh_left_recon[1],
+                cu_origin_x_uv,
+                cu_origin_y_uv,
+                bwdith_uv,
+                bwheight_uv);
+            update_recon_neighbor_array16bit(
+                context_ptr->cr_recon_neighbor_array,
+                (uint16_t*)context_ptr->cu_ptr->neigh_top_recon[2],
+                (uint16_t*)context_ptr->cu_ptr->neigh_left_recon[2],
+                cu_origin_x_uv,
+                cu_origin_y_uv,
+                bwdith_uv,
+                bwheight_uv);
+        }
+    }
+    else if (intraMdOpenLoop == EB_FALSE)
     {
         update_recon_neighbor_array(
             context_ptr->luma_recon_neighbor_array,
@@ -324,10 +353,6 @@ void mode_decision_update_neighbor_arrays(
             context_ptr->blk_geom->bwidth,
             context_ptr->blk_geom->bheight);
 
-    }
-
-
-    if (intraMdOpenLoop == EB_FALSE) {
         if (context_ptr->blk_geom->has_uv && context_ptr->chroma_level == CHROMA_MODE_0) {
             update_recon_neighbor_array(
                 context_ptr->cb_recon_neighbor_array,
@@ -352,16 +377,20 @@ void mode_decision_update_neighbor_arrays(
     return;
 }
 
-void copy_neighbour_arrays(
+/*******************************************
+* Save Neighbour Arrays
+*   Logs the units of the MD neighbor arrays that the
+*   update of the block is about to overwrite, so that
+*   neighbor_array_undo() can roll the update back.
+*   Logs MD_NEIGHBOR_UNDO_ARRAYS arrays, keep it in sync.
+*******************************************/
+void save_neighbour_arrays(
     PictureControlSet_t                *picture_control_set_ptr,
     ModeDecisionContext_t               *context_ptr,
-    uint32_t                            src_idx,
-    uint32_t                            dst_idx,
     uint32_t                            blk_mds,
     uint32_t                            sb_org_x,
     uint32_t                            sb_org_y)
 {
-    (void)*context_ptr;
 
     const BlockGeom * blk_geom = get_blk_geom_mds(blk_mds);
 
@@ -372,9 +401,9 @@ void copy_neighbour_arrays(
     uint32_t                            bwidth_uv = blk_geom->bwidth_uv;
     uint32_t                            bheight_uv = blk_geom->bheight_uv;
 
-    copy_neigh_arr(
-        picture_control_set_ptr->md_intra_luma_mode_neighbor_array[src_idx],
-        picture_control_set_ptr->md_intra_luma_mode_neighbor_array[dst_idx],
+    neighbor_array_unit_save(
+        context_ptr->neighbor_undo_log,
+        picture_control_set_ptr->md_intra_luma_mode_neighbor_array[MD_NEIGHBOR_ARRAY_INDEX],
         blk_org_x,
         blk_org_y,
         blk_geom->bwidth,
@@ -382,9 +411,9 @@ void copy_neighbour_arrays(
         NEIGHBOR_ARRAY_UNIT_TOP_AND_LEFT_ONLY_MASK);
 
     //neighbor_array_unit_reset(picture_control_set_ptr->md_intra_chroma_mode_neighbor_array[depth]);
-    copy_neigh_arr(
-        picture_control_set_ptr->md_intra_chroma_mode_neighbor_array[src_idx],
-        picture_control_set_ptr->md_intra_chroma_mode_neighbor_array[dst_idx],
+    neighbor_array_unit_save(
+        context_ptr->neighbor_undo_log,
+        picture_control_set_ptr->md_intra_chroma_mode_neighbor_array[MD_NEIGHBOR_ARRAY_INDEX],
         blk_org_x_uv,
         blk_org_y_uv,
         bwidth_uv,
@@ -392,9 +421,9 @@ void copy_neighbour_arrays(
         NEIGHBOR_ARRAY_UNIT_TOP_AND_LEFT_ONLY_MASK);
 
     //neighbor_array_unit_reset(picture_control_set_ptr->md_skip_flag_neighbor_array[depth]);
-    copy_neigh_arr(
-        picture_control_set_ptr->md_skip_flag_neighbor_array[src_idx],
-        picture_control_set_ptr->md_skip_flag_neighbor_array[dst_idx],
+    neighbor_array_unit_save(
+        context_ptr->neighbor_undo_log,
+        picture_control_set_ptr->md_skip_flag_neighbor_array[MD_NEIGHBOR_ARRAY_INDEX],
         blk_org_x,
         blk_org_y,
         blk_geom->bwidth,
@@ -402,9 +431,9 @@ void copy_neighbour_arrays(
         NEIGHBOR_ARRAY_UNIT_TOP_AND_LEFT_ONLY_MASK);
 
     //neighbor_array_unit_reset(picture_control_set_ptr->md_mode_type_neighbor_array[depth]);
-    copy_neigh_arr(
-        picture_control_set_ptr->md_mode_type_neighbor_array[src_idx],
-        picture_control_set_ptr->md_mode_type_neighbor_array[dst_idx],
+    neighbor_array_unit_save(
+        context_ptr->neighbor_undo_log,
+        picture_control_set_ptr->md_mode_type_neighbor_array[MD_NEIGHBOR_ARRAY_INDEX],
         blk_org_x,
         blk_org_y,
         blk_geom->bwidth,
@@ -412,17 +441,17 @@ void copy_neighbour_arrays(
         NEIGHBOR_ARRAY_UNIT_FULL_MASK);
 
     //neighbor_array_unit_reset(picture_control_set_ptr->md_leaf_depth_neighbor_array[depth]);
-    copy_neigh_arr(
-        picture_control_set_ptr->md_leaf_depth_neighbor_array[src_idx],
-        picture_control_set_ptr->md_leaf_depth_neighbor_array[dst_idx],
+    neighbor_array_unit_save(
+        context_ptr->neighbor_undo_log,
+        picture_control_set_ptr->md_leaf_depth_neighbor_array[MD_NEIGHBOR_ARRAY_INDEX],
         blk_org_x,
         blk_org_y,
         blk_geom->bwidth,
         blk_geom->bheight,
         NEIGHBOR_ARRAY_UNIT_TOP_AND_LEFT_ONLY_MASK);
-    copy_neigh_arr(
-        picture_control_set_ptr->mdleaf_partition_neighbor_array[src_idx],
-        picture_control_set_ptr->mdleaf_partition_neighbor_array[dst_idx],
+    neighbor_array_unit_save(
+        context_ptr->neighbor_undo_log,
+        picture_control_set_ptr->mdleaf_partition_neighbor_array[MD_NEIGHBOR_ARRAY_INDEX],
         blk_org_x,
         blk_org_y,
         blk_geom->bwidth,
@@ -430,9 +459,9 @@ void copy_neighbour_arrays(
         NEIGHBOR_ARRAY_UNIT_TOP_AND_LEFT_ONLY_MASK);
 
     //neighbor_array_unit_reset(picture_control_set_ptr->md_luma_recon_neighbor_array[depth]);
-    copy_neigh_arr(
-        picture_control_set_ptr->md_luma_recon_neighbor_array[src_idx],
-        picture_control_set_ptr->md_luma_recon_neighbor_array[dst_idx],
+    neighbor_array_unit_save(
+        context_ptr->neighbor_undo_log,
+        picture_control_set_ptr->md_luma_recon_neighbor_array[MD_NEIGHBOR_ARRAY_INDEX],
         blk_org_x,
         blk_org_y,
         blk_geom->bwidth,
@@ -443,9 +472,9 @@ void copy_neighbour_arrays(
 
         //neighbor_array_unit_reset(picture_control_set_ptr->md_cb_recon_neighbor_array[depth]);
 
-        copy_neigh_arr(
-            picture_control_set_ptr->md_cb_recon_neighbor_array[src_idx],
-            picture_control_set_ptr->md_cb_recon_neighbor_array[dst_idx],
+        neighbor_array_unit_save(
+            context_ptr->neighbor_undo_log,
+            picture_control_set_ptr->md_cb_recon_neighbor_array[MD_NEIGHBOR_ARRAY_INDEX],
             blk_org_x_uv,
             blk_org_y_uv,
             bwidth_uv,
@@ -453,9 +482,9 @@ void copy_neighbour_arrays(
             NEIGHBOR_ARRAY_UNIT_FULL_MASK);
 
         //neighbor_array_unit_reset(picture_control_set_ptr->md_cr_recon_neighbor_array[depth]);
-        copy_neigh_arr(
-            picture_control_set_ptr->md_cr_recon_neighbor_array[src_idx],
-            picture_control_set_ptr->md_cr_recon_neighbor_array[dst_idx],
+        neighbor_array_unit_save(
+            context_ptr->neighbor_undo_log,
+            picture_control_set_ptr->md_cr_recon_neighbor_array[MD_NEIGHBOR_ARRAY_INDEX],
             blk_org_x_uv,
             blk_org_y_uv,
             bwidth_uv,
@@ -466,18 +495,18 @@ void copy_neighbour_arrays(
     }
 
     //neighbor_array_unit_reset(picture_control_set_ptr->md_skip_coeff_neighbor_array[depth]);
-    copy_neigh_arr(
-        picture_control_set_ptr->md_skip_coeff_neighbor_array[src_idx],
-        picture_control_set_ptr->md_skip_coeff_neighbor_array[dst_idx],
+    neighbor_array_unit_save(
+        context_ptr->neighbor_undo_log,
+        picture_control_set_ptr->md_skip_coeff_neighbor_array[MD_NEIGHBOR_ARRAY_INDEX],
         blk_org_x,
         blk_org_y,
         blk_geom->bwidth,
         blk_geom->bheight,
         NEIGHBOR_ARRAY_UNIT_TOP_AND_LEFT_ONLY_MASK);
     //neighbor_array_unit_reset(picture_control_set_ptr->md_luma_dc_sign_level_coeff_neighbor_array[depth]);
-    copy_neigh_arr(
-        picture_control_set_ptr->md_luma_dc_sign_level_coeff_neighbor_array[src_idx],
-        picture_control_set_ptr->md_luma_dc_sign_level_coeff_neighbor_array[dst_idx],
+    neighbor_array_unit_save(
+        context_ptr->neighbor_undo_log,
+        picture_control_set_ptr->md_luma_dc_sign_level_coeff_neighbor_array[MD_NEIGHBOR_ARRAY_INDEX],
         blk_org_x,
         blk_org_y,
         blk_geom->bwidth,
@@ -485,9 +514,9 @@ void copy_neighbour_arrays(
         NEIGHBOR_ARRAY_UNIT_TOP_AND_LEFT_ONLY_MASK);
 
     if (blk_geom->has_uv && context_ptr->chroma_level == CHROMA_MODE_0) {
-        copy_neigh_arr(
-            picture_control_set_ptr->md_cb_dc_sign_level_coeff_neighbor_array[src_idx],
-            picture_control_set_ptr->md_cb_dc_sign_level_coeff_neighbor_array[dst_idx],
+        neighbor_array_unit_save(
+            context_ptr->neighbor_undo_log,
+            picture_control_set_ptr->md_cb_dc_sign_level_coeff_neighbor_array[MD_NEIGHBOR_ARRAY_INDEX],
             blk_org_x_uv,
             blk_org_y_uv,
             bwidth_uv,
@@ -495,9 +524,9 @@ void copy_neighbour_arrays(
             NEIGHBOR_ARRAY_UNIT_TOP_AND_LEFT_ONLY_MASK);
         //neighbor_array_unit_reset(picture_control_set_ptr->md_cr_dc_sign_level_coeff_neighbor_array[depth]);
 
-        copy_neigh_arr(
-            picture_control_set_ptr->md_cr_dc_sign_level_coeff_neighbor_array[src_idx],
-            picture_control_set_ptr->md_cr_dc_sign_level_coeff_neighbor_array[dst_idx],
+        neighbor_array_unit_save(
+            context_ptr->neighbor_undo_log,
+            picture_control_set_ptr->md_cr_dc_sign_level_coeff_neighbor_array[MD_NEIGHBOR_ARRAY_INDEX],
             blk_org_x_uv,
             blk_org_y_uv,
             bwidth_uv,
@@ -505,27 +534,27 @@ void copy_neighbour_arrays(
             NEIGHBOR_ARRAY_UNIT_TOP_AND_LEFT_ONLY_MASK);
     }
     //neighbor_array_unit_reset(picture_control_set_ptr->md_inter_pred_dir_neighbor_array[depth]);
-    copy_neigh_arr(
-        picture_control_set_ptr->md_inter_pred_dir_neighbor_array[src_idx],
-        picture_control_set_ptr->md_inter_pred_dir_neighbor_array[dst_idx],
+    neighbor_array_unit_save(
+        context_ptr->neighbor_undo_log,
+        picture_control_set_ptr->md_inter_pred_dir_neighbor_array[MD_NEIGHBOR_ARRAY_INDEX],
         blk_org_x,
         blk_org_y,
         blk_geom->bwidth,
         blk_geom->bheight,
         NEIGHBOR_ARRAY_UNIT_TOP_AND_LEFT_ONLY_MASK);
     //neighbor_array_unit_reset(picture_control_set_ptr->md_ref_frame_type_neighbor_array[depth]);
-    copy_neigh_arr(
-        picture_control_set_ptr->md_ref_frame_type_neighbor_array[src_idx],
-        picture_control_set_ptr->md_ref_frame_type_neighbor_array[dst_idx],
+    neighbor_array_unit_save(
+        context_ptr->neighbor_undo_log,
+        picture_control_set_ptr->md_ref_frame_type_neighbor_array[MD_NEIGHBOR_ARRAY_INDEX],
         blk_org_x,
         blk_org_y,
         blk_geom->bwidth,
         blk_geom->bheight,
         NEIGHBOR_ARRAY_UNIT_TOP_AND_LEFT_ONLY_MASK);
 
-    copy_neigh_arr_32(
-        picture_control_set_ptr->md_interpolation_type_neighbor_array[src_idx],
-        picture_control_set_ptr->md_interpolation_type_neighbor_array[dst_idx],
+    neighbor_array_unit_save32(
+        context_ptr->neighbor_undo_log,
+        picture_control_set_ptr->md_interpolation_type_neighbor_array[MD_NEIGHBOR_ARRAY_INDEX],
         blk_org_x,
         blk_org_y,
         blk_geom->bwidth,
@@ -791,6 +820,42 @@ void picture_addition_kernel16_bit(
     return;
 }
 
+/*******************************************
+* 16bit Inverse Transform Recon
+*   Copies the 16bit prediction of the transform block
+*   to the recon and adds the residual when it is coded
+*******************************************/
+static void md_inv_transform_recon16bit(
+    int32_t        *coeff_ptr,
+    uint16_t       *pred_ptr,
+    uint32_t        pred_stride,
+    uint16_t       *recon_ptr,
+    uint32_t        recon_stride,
+    uint32_t        width,
+    uint32_t        height,
+    TxSize          txsize,
+    TxType          tx_type,
+    PLANE_TYPE      plane,
+    uint16_t        eob,
+    EbBool          has_coeff)
+{
+    uint32_t j;
+
+    for (j = 0; j < height; j++)
+        memcpy(recon_ptr + j * recon_stride, pred_ptr + j * pred_stride, width * sizeof(uint16_t));
+
+    if (has_coeff)
+        av1_inv_transform_recon(
+            coeff_ptr,
+            CONVERT_TO_BYTEPTR(recon_ptr),
+            recon_stride,
+            txsize,
+            BIT_INCREMENT_10BIT,
+            tx_type,
+            plane,
+            eob);
+}
+
 void AV1PerformInverseTransformReconLuma(
     PictureControlSet_t               *picture_control_set_ptr,
     ModeDecisionContext_t             *context_ptr,
@@ -824,7 +889,22 @@ void AV1PerformInverseTransformReconLuma(
 
             uint32_t y_has_coeff = (candidateBuffer->candidate_ptr->y_has_coeff & (1 << txb_itr)) > 0;
 
-            if (y_has_coeff) {
+            if (context_ptr->hbd_mode_decision) {
+                md_inv_transform_recon16bit(
+                    &(((int32_t*)candidateBuffer->reconCoeffPtr->buffer_y)[txb_1d_offset]),
+                    ((uint16_t*)candidateBuffer->prediction_ptr->buffer_y) + tuOriginIndex,
+                    candidateBuffer->prediction_ptr->stride_y,
+                    ((uint16_t*)candidateBuffer->recon_ptr->buffer_y) + recLumaOffset,
+                    candidateBuffer->recon_ptr->stride_y,
+                    tu_width,
+                    tu_height,
+                    context_ptr->blk_geom->txsize[txb_itr],
+                    candidateBuffer->candidate_ptr->transform_type[PLANE_TYPE_Y],
+                    PLANE_TYPE_Y,
+                    (uint16_t)candidateBuffer->candidate_ptr->eob[0][txb_itr],
+                    (EbBool)y_has_coeff);
+            }
+            else if (y_has_coeff) {
                 (void)context_ptr;
                 uint8_t     *predBuffer = &(candidateBuffer->prediction_ptr->buffer_y[tuOriginIndex]);
                 uint8_t     *recBuffer = &(candidateBuffer->recon_ptr->buffer_y[recLumaOffset]);
@@ -905,7 +985,22 @@ void AV1PerformInverseTransformRecon(
             recCbOffset = ((((context_ptr->blk_geom->tx_org_x[txb_itr] >> 3) << 3) + ((context_ptr->blk_geom->tx_org_y[txb_itr] >> 3) << 3) * candidateBuffer->recon_ptr->strideCb) >> 1);
             recCrOffset = ((((context_ptr->blk_geom->tx_org_x[txb_itr] >> 3) << 3) + ((context_ptr->blk_geom->tx_org_y[txb_itr] >> 3) << 3) * candidateBuffer->recon_ptr->strideCr) >> 1);
             tuOriginIndex = txb_origin_x + txb_origin_y * candidateBuffer->prediction_ptr->stride_y;
-            if (txb_ptr->y_has_coeff) {
+            if (context_ptr->hbd_mode_decision) {
+                md_inv_transform_recon16bit(
+                    &(((int32_t*)candidateBuffer->reconCoeffPtr->buffer_y)[txb_1d_offset]),
+                    ((uint16_t*)candidateBuffer->prediction_ptr->buffer_y) + tuOriginIndex,
+                    candidateBuffer->prediction_ptr->stride_y,
+                    ((uint16_t*)candidateBuffer->recon_ptr->buffer_y) + recLumaOffset,
+                    candidateBuffer->recon_ptr->stride_y,
+                    tu_width,
+                    tu_height,
+                    context_ptr->blk_geom->txsize[txb_itr],
+                    candidateBuffer->candidate_ptr->transform_type[PLANE_TYPE_Y],
+                    PLANE_TYPE_Y,
+                    (uint16_t)candidateBuffer->candidate_ptr->eob[0][txb_itr],
+                    (EbBool)txb_ptr->y_has_coeff);
+            }
+            else if (txb_ptr->y_has_coeff) {
                 uint8_t     *predBuffer = &(candidateBuffer->prediction_ptr->buffer_y[tuOriginIndex]);
                 uint8_t     *recBuffer = &(candidateBuffer->recon_ptr->buffer_y[recLumaOffset]);
                 uint32_t     j;
@@ -946,7 +1041,22 @@ void AV1PerformInverseTransformRecon(
             uint32_t cbTuChromaOriginIndex = ((((txb_origin_x >> 3) << 3) + ((txb_origin_y >> 3) << 3) * candidateBuffer->reconCoeffPtr->strideCb) >> 1);
             uint32_t crTuChromaOriginIndex = ((((txb_origin_x >> 3) << 3) + ((txb_origin_y >> 3) << 3) * candidateBuffer->reconCoeffPtr->strideCr) >> 1);
 
-            if (context_ptr->blk_geom->has_uv && txb_ptr->u_has_coeff) {
+            if (context_ptr->hbd_mode_decision) {
+                md_inv_transform_recon16bit(
+                    &(((int32_t*)candidateBuffer->reconCoeffPtr->bufferCb)[txb_1d_offset_uv]),
+                    ((uint16_t*)candidateBuffer->prediction_ptr->bufferCb) + cbTuChromaOriginIndex,
+                    candidateBuffer->prediction_ptr->strideCb,
+                    ((uint16_t*)candidateBuffer->recon_ptr->bufferCb) + recCbOffset,
+                    candidateBuffer->recon_ptr->strideCb,
+                    chroma_tu_width,
+                    chroma_tu_height,
+                    context_ptr->blk_geom->txsize_uv[txb_itr],
+                    candidateBuffer->candidate_ptr->transform_type[PLANE_TYPE_UV],
+                    PLANE_TYPE_UV,
+                    (uint16_t)candidateBuffer->candidate_ptr->eob[1][txb_itr],
+                    (EbBool)(context_ptr->blk_geom->has_uv && txb_ptr->u_has_coeff));
+            }
+            else if (context_ptr->blk_geom->has_uv && txb_ptr->u_has_coeff) {
                 
                 uint8_t     *predBuffer = &(candidateBuffer->prediction_ptr->bufferCb[cbTuChromaOriginIndex]);
                 uint8_t     *recBuffer = &(candidateBuffer->recon_ptr->bufferCb[recCbOffset]);
@@ -980,7 +1090,22 @@ void AV1PerformInverseTransformRecon(
                     asm_type);
             }
 
-                if (context_ptr->blk_geom->has_uv && txb_ptr->v_has_coeff) {
+                if (context_ptr->hbd_mode_decision) {
+                    md_inv_transform_recon16bit(
+                        &(((int32_t*)candidateBuffer->reconCoeffPtr->bufferCr)[txb_1d_offset_uv]),
+                        ((uint16_t*)candidateBuffer->prediction_ptr->bufferCr) + crTuChromaOriginIndex,
+                        candidateBuffer->prediction_ptr->strideCr,
+                        ((uint16_t*)candidateBuffer->recon_ptr->bufferCr) + recCrOffset,
+                        candidateBuffer->recon_ptr->strideCr,
+                        chroma_tu_width,
+                        chroma_tu_height,
+                        context_ptr->blk_geom->txsize_uv[txb_itr],
+                        candidateBuffer->candidate_ptr->transform_type[PLANE_TYPE_UV],
+                        PLANE_TYPE_UV,
+                        (uint16_t)candidateBuffer->candidate_ptr->eob[2][txb_itr],
+                        (EbBool)(context_ptr->blk_geom->has_uv && txb_ptr->v_has_coeff));
+                }
+                else if (context_ptr->blk_geom->has_uv && txb_ptr->v_has_coeff) {
                     uint8_t     *predBuffer = &(candidateBuffer->prediction_ptr->bufferCr[crTuChromaOriginIndex]);
                     uint8_t     *recBuffer = &(candidateBuffer->recon_ptr->bufferCr[recCrOffset]);
                     uint32_t j;
@@ -1047,6 +1172,8 @@ void ProductCodingLoopInitFastLoop(
     // Keep track of the SB Ptr
     context_ptr->luma_intra_ref_samples_gen_done = EB_FALSE;
     context_ptr->chroma_intra_ref_samples_gen_done = EB_FALSE;
+    for (uint32_t plane = 0; plane < MAX_MB_PLANE; ++plane)
+        context_ptr->intra_edge_cache[plane].valid = EB_FALSE;
 
     // Generate Split, Skip and intra mode contexts for the rate estimation
     coding_loop_context_generation(
@@ -1190,6 +1317,9 @@ void perform_fast_loop(
 
             // Distortion
             lumaFastDistortion = candidate_ptr->me_distortion;
+            // ME ran on the 8bit MSB copy of the input: bring its SAD to the 10bit domain
+            if (context_ptr->hbd_mode_decision)
+                lumaFastDistortion <<= 2;
 
             // Fast Cost
             *(candidateBuffer->fast_cost_ptr) = Av1ProductFastCostFuncTable[candidate_ptr->type](
@@ -1245,67 +1375,130 @@ void perform_fast_loop(
 
             // Distortion
             // Y
-            if (use_ssd) {
-                candidateBuffer->candidate_ptr->luma_fast_distortion = lumaFastDistortion = spatial_full_distortion_kernel_func_ptr_array[asm_type][Log2f(context_ptr->blk_geom->bwidth) - 2](
-                    input_picture_ptr->buffer_y + inputOriginIndex,
-                    input_picture_ptr->stride_y,
-                    prediction_ptr->buffer_y + cuOriginIndex,
-                    prediction_ptr->stride_y,
-                    context_ptr->blk_geom->bheight,
-                    context_ptr->blk_geom->bwidth);
+            if (context_ptr->hbd_mode_decision) {
+                // The input and the prediction are 16bit
+                if (use_ssd) {
+                    candidateBuffer->candidate_ptr->luma_fast_distortion = lumaFastDistortion = spatial_full_distortion_kernel16bit(
+                        ((uint16_t*)input_picture_ptr->buffer_y) + inputOriginIndex,
+                        input_picture_ptr->stride_y,
+                        ((uint16_t*)prediction_ptr->buffer_y) + cuOriginIndex,
+                        prediction_ptr->stride_y,
+                        context_ptr->blk_geom->bwidth,
+                        context_ptr->blk_geom->bheight);
+                }
+                else {
+                    candidateBuffer->candidate_ptr->luma_fast_distortion = lumaFastDistortion = fast_loop_nx_m_sad_kernel16bit(
+                        ((uint16_t*)input_picture_ptr->buffer_y) + inputOriginIndex,
+                        input_picture_ptr->stride_y,
+                        ((uint16_t*)prediction_ptr->buffer_y) + cuOriginIndex,
+                        prediction_ptr->stride_y,
+                        context_ptr->blk_geom->bheight,
+                        context_ptr->blk_geom->bwidth);
+                }
 
+                if (context_ptr->blk_geom->has_uv && context_ptr->chroma_level == CHROMA_MODE_0) {
+                    if (use_ssd) {
+                        chromaFastDistortion = spatial_full_distortion_kernel16bit(
+                            ((uint16_t*)input_picture_ptr->bufferCb) + inputCbOriginIndex,
+                            input_picture_ptr->strideCb,
+                            ((uint16_t*)prediction_ptr->bufferCb) + cuChromaOriginIndex,
+                            prediction_ptr->strideCb,
+                            context_ptr->blk_geom->bwidth_uv,
+                            context_ptr->blk_geom->bheight_uv);
+
+                        chromaFastDistortion += spatial_full_distortion_kernel16bit(
+                            ((uint16_t*)input_picture_ptr->bufferCr) + inputCrOriginIndex,
+                            input_picture_ptr->strideCr,
+                            ((uint16_t*)prediction_ptr->bufferCr) + cuChromaOriginIndex,
+                            prediction_ptr->strideCr,
+                            context_ptr->blk_geom->bwidth_uv,
+                            context_ptr->blk_geom->bheight_uv);
+                    }
+                    else {
+                        chromaFastDistortion = fast_loop_nx_m_sad_kernel16bit(
+                            ((uint16_t*)input_picture_ptr->bufferCb) + inputCbOriginIndex,
+                            input_picture_ptr->strideCb,
+                            ((uint16_t*)prediction_ptr->bufferCb) + cuChromaOriginIndex,
+                            prediction_ptr->strideCb,
+                            context_ptr->blk_geom->bheight_uv,
+                            context_ptr->blk_geom->bwidth_uv);
+
+                        chromaFastDistortion += fast_loop_nx_m_sad_kernel16bit(
+                            ((uint16_t*)input_picture_ptr->bufferCr) + inputCrOriginIndex,
+                            input_picture_ptr->strideCr,
+                            ((uint16_t*)prediction_ptr->bufferCr) + cuChromaOriginIndex,
+                            prediction_ptr->strideCr,
+                            context_ptr->blk_geom->bheight_uv,
+                            context_ptr->blk_geom->bwidth_uv);
+                    }
+                }
+                else {
+                    chromaFastDistortion = 0;
+                }
             }
             else {
-                candidateBuffer->candidate_ptr->luma_fast_distortion = lumaFastDistortion = (NxMSadKernelSubSampled_funcPtrArray[asm_type][context_ptr->blk_geom->bwidth >> 3](
-                    input_picture_ptr->buffer_y + inputOriginIndex,
-                    input_picture_ptr->stride_y,
-                    prediction_ptr->buffer_y + cuOriginIndex,
-                    prediction_ptr->stride_y,
-                    context_ptr->blk_geom->bheight,
-                    context_ptr->blk_geom->bwidth));
-            }
+                if (use_ssd) {
+                    candidateBuffer->candidate_ptr->luma_fast_distortion = lumaFastDistortion = spatial_full_distortion_kernel_func_ptr_array[asm_type][Log2f(context_ptr->blk_geom->bwidth) - 2](
+                        input_picture_ptr->buffer_y + inputOriginIndex,
+                        input_picture_ptr->stride_y,
+                        prediction_ptr->buffer_y + cuOriginIndex,
+                        prediction_ptr->stride_y,
+                        context_ptr->blk_geom->bheight,
+                        context_ptr->blk_geom->bwidth);
 
+                }
+                else {
+                    candidateBuffer->candidate_ptr->luma_fast_distortion = lumaFastDistortion = (NxMSadKernelSubSampled_funcPtrArray[asm_type][context_ptr->blk_geom->bwidth >> 3](
+                        input_picture_ptr->buffer_y + inputOriginIndex,
+                        input_picture_ptr->stride_y,
+                        prediction_ptr->buffer_y + cuOriginIndex,
+                        prediction_ptr->stride_y,
+                        context_ptr->blk_geom->bheight,
+                        context_ptr->blk_geom->bwidth));
+                }
 
 
-            if (context_ptr->blk_geom->has_uv && context_ptr->chroma_level == CHROMA_MODE_0) {
-                if (use_ssd) {
-                    chromaFastDistortion = spatial_full_distortion_kernel_func_ptr_array[asm_type][Log2f(context_ptr->blk_geom->bwidth_uv) - 2]( //spatial_full_distortion_kernel(
-                        input_picture_ptr->bufferCb + inputCbOriginIndex,
-                        input_picture_ptr->strideCb,
-                        candidateBuffer->prediction_ptr->bufferCb + cuChromaOriginIndex,
-                        prediction_ptr->strideCb,
-                        context_ptr->blk_geom->bheight_uv,
-                        context_ptr->blk_geom->bwidth_uv);
-
-                    chromaFastDistortion += spatial_full_distortion_kernel_func_ptr_array[asm_type][Log2f(context_ptr->blk_geom->bwidth_uv) - 2]( //spatial_full_distortion_kernel(
-                        input_picture_ptr->bufferCr + inputCrOriginIndex,
-                        input_picture_ptr->strideCb,
-                        candidateBuffer->prediction_ptr->bufferCr + cuChromaOriginIndex,
-                        prediction_ptr->strideCr,
-                        context_ptr->blk_geom->bheight_uv,
-                        context_ptr->blk_geom->bwidth_uv);
+
+                if (context_ptr->blk_geom->has_uv && context_ptr->chroma_level == CHROMA_MODE_0) {
+                    if (use_ssd) {
+                        chromaFastDistortion = spatial_full_distortion_kernel_func_ptr_array[asm_type][Log2f(context_ptr->blk_geom->bwidth_uv) - 2]( //spatial_full_distortion_kernel(
+                            input_picture_ptr->bufferCb + inputCbOriginIndex,
+                            input_picture_ptr->strideCb,
+                            candidateBuffer->prediction_ptr->bufferCb + cuChromaOriginIndex,
+                            prediction_ptr->strideCb,
+                            context_ptr->blk_geom->bheight_uv,
+                            context_ptr->blk_geom->bwidth_uv);
+
+                        chromaFastDistortion += spatial_full_distortion_kernel_func_ptr_array[asm_type][Log2f(context_ptr->blk_geom->bwidth_uv) - 2]( //spatial_full_distortion_kernel(
+                            input_picture_ptr->bufferCr + inputCrOriginIndex,
+                            input_picture_ptr->strideCb,
+                            candidateBuffer->prediction_ptr->bufferCr + cuChromaOriginIndex,
+                            prediction_ptr->strideCr,
+                            context_ptr->blk_geom->bheight_uv,
+                            context_ptr->blk_geom->bwidth_uv);
+                    }
+                    else {
+                        chromaFastDistortion = NxMSadKernelSubSampled_funcPtrArray[asm_type][context_ptr->blk_geom->bwidth_uv >> 3](
+                            input_picture_ptr->bufferCb + inputCbOriginIndex,
+                            input_picture_ptr->strideCb,
+                            candidateBuffer->prediction_ptr->bufferCb + cuChromaOriginIndex,
+                            prediction_ptr->strideCb,
+                            context_ptr->blk_geom->bheight_uv,
+                            context_ptr->blk_geom->bwidth_uv);
+
+                        chromaFastDistortion += NxMSadKernelSubSampled_funcPtrArray[asm_type][context_ptr->blk_geom->bwidth_uv >> 3](
+                            input_picture_ptr->bufferCr + inputCrOriginIndex,
+                            input_picture_ptr->strideCb,
+                            candidateBuffer->prediction_ptr->bufferCr + cuChromaOriginIndex,
+                            prediction_ptr->strideCr,
+                            context_ptr->blk_geom->bheight_uv,
+                            context_ptr->blk_geom->bwidth_uv);
+                    }
+
                 }
                 else {
-                    chromaFastDistortion = NxMSadKernelSubSampled_funcPtrArray[asm_type][context_ptr->blk_geom->bwidth_uv >> 3](
-                        input_picture_ptr->bufferCb + inputCbOriginIndex,
-                        input_picture_ptr->strideCb,
-                        candidateBuffer->prediction_ptr->bufferCb + cuChromaOriginIndex,
-                        prediction_ptr->strideCb,
-                        context_ptr->blk_geom->bheight_uv,
-                        context_ptr->blk_geom->bwidth_uv);
-
-                    chromaFastDistortion += NxMSadKernelSubSampled_funcPtrArray[asm_type][context_ptr->blk_geom->bwidth_uv >> 3](
-                        input_picture_ptr->bufferCr + inputCrOriginIndex,
-                        input_picture_ptr->strideCb,
-                        candidateBuffer->prediction_ptr->bufferCr + cuChromaOriginIndex,
-                        prediction_ptr->strideCr,
-                        context_ptr->blk_geom->bheight_uv,
-                        context_ptr->blk_geom->bwidth_uv);
+                    chromaFastDistortion = 0;
                 }
-
-            }
-            else {
-                chromaFastDistortion = 0;
             }
 
 
@@ -1392,6 +1585,82 @@ void ProductDerivePartialFrequencyN2Flag(
 
 }
 #endif
+/*******************************************
+* MD Residual / CFL Prediction
+*   Run on the 16bit planes in hbd mode decision,
+*   the origin indexes are in samples
+*******************************************/
+static void md_residual_kernel(
+    ModeDecisionContext_t   *context_ptr,
+    uint8_t                 *input,
+    uint32_t                 input_origin_index,
+    uint32_t                 input_stride,
+    uint8_t                 *pred,
+    uint32_t                 pred_origin_index,
+    uint32_t                 pred_stride,
+    int16_t                 *residual,
+    uint32_t                 residual_stride,
+    uint32_t                 area_width,
+    uint32_t                 area_height)
+{
+    if (context_ptr->hbd_mode_decision)
+        residual_kernel16bit(
+            ((uint16_t*)input) + input_origin_index,
+            input_stride,
+            ((uint16_t*)pred) + pred_origin_index,
+            pred_stride,
+            residual,
+            residual_stride,
+            area_width,
+            area_height);
+    else
+        ResidualKernel(
+            input + input_origin_index,
+            input_stride,
+            pred + pred_origin_index,
+            pred_stride,
+            residual,
+            residual_stride,
+            area_width,
+            area_height);
+}
+
+static void md_cfl_predict(
+    ModeDecisionContext_t   *context_ptr,
+    uint8_t                 *pred,
+    uint32_t                 pred_origin_index,
+    int32_t                  pred_stride,
+    uint8_t                 *dst,
+    uint32_t                 dst_origin_index,
+    int32_t                  dst_stride,
+    int32_t                  alpha_q3,
+    int32_t                  width,
+    int32_t                  height)
+{
+    if (context_ptr->hbd_mode_decision)
+        cfl_predict_hbd(
+            context_ptr->pred_buf_q3,
+            ((uint16_t*)pred) + pred_origin_index,
+            pred_stride,
+            ((uint16_t*)dst) + dst_origin_index,
+            dst_stride,
+            alpha_q3,
+            EB_10BIT,
+            width,
+            height);
+    else
+        cfl_predict_lbd(
+            context_ptr->pred_buf_q3,
+            pred + pred_origin_index,
+            pred_stride,
+            dst + dst_origin_index,
+            dst_stride,
+            alpha_q3,
+            8,
+            width,
+            height);
+}
+
 void AV1CostCalcCfl(
     PictureControlSet_t                *picture_control_set_ptr,
     ModeDecisionCandidateBuffer_t      *candidateBuffer,
@@ -1439,23 +1708,26 @@ void AV1CostCalcCfl(
         assert(chroma_width * CFL_BUF_LINE + chroma_height <=
             CFL_BUF_SQUARE);
 
-        cfl_predict_lbd(
-            context_ptr->pred_buf_q3,
-            &(candidateBuffer->prediction_ptr->bufferCb[cuChromaOriginIndex]),
+        md_cfl_predict(
+            context_ptr,
+            candidateBuffer->prediction_ptr->bufferCb,
+            cuChromaOriginIndex,
             candidateBuffer->prediction_ptr->strideCb,
-            //dst_16,
-            &(candidateBuffer->cflTempPredictionPtr->bufferCb[cuChromaOriginIndex]),
+            candidateBuffer->cflTempPredictionPtr->bufferCb,
+            cuChromaOriginIndex,
             candidateBuffer->cflTempPredictionPtr->strideCb,
             alpha_q3,
-            8,
             chroma_width,
             chroma_height);
         //Cb Residual
 
-        ResidualKernel(
-            &(input_picture_ptr->bufferCb[inputCbOriginIndex]),
+        md_residual_kernel(
+            context_ptr,
+            input_picture_ptr->bufferCb,
+            inputCbOriginIndex,
             input_picture_ptr->strideCb,
-            &(candidateBuffer->cflTempPredictionPtr->bufferCb[cuChromaOriginIndex]),
+            candidateBuffer->cflTempPredictionPtr->bufferCb,
+            cuChromaOriginIndex,
             candidateBuffer->cflTempPredictionPtr->strideCb,
             &(((int16_t*)candidateBuffer->residual_ptr->bufferCb)[cuChromaOriginIndex]),
             candidateBuffer->residual_ptr->strideCb,
@@ -1514,23 +1786,26 @@ void AV1CostCalcCfl(
         assert(chroma_width * CFL_BUF_LINE + chroma_height <=
             CFL_BUF_SQUARE);
 
-        cfl_predict_lbd(
-            context_ptr->pred_buf_q3,
-            &(candidateBuffer->prediction_ptr->bufferCr[cuChromaOriginIndex]),
+        md_cfl_predict(
+            context_ptr,
+            candidateBuffer->prediction_ptr->bufferCr,
+            cuChromaOriginIndex,
             candidateBuffer->prediction_ptr->strideCr,
-            //dst_16,
-            &(candidateBuffer->cflTempPredictionPtr->bufferCr[cuChromaOriginIndex]),
+            candidateBuffer->cflTempPredictionPtr->bufferCr,
+            cuChromaOriginIndex,
             candidateBuffer->cflTempPredictionPtr->strideCr,
             alpha_q3,
-            8,
             chroma_width,
             chroma_height);
 
         //Cr Residual
-        ResidualKernel(
-            &(input_picture_ptr->bufferCr[inputCbOriginIndex]),
+        md_residual_kernel(
+            context_ptr,
+            input_picture_ptr->bufferCr,
+            inputCbOriginIndex,
             input_picture_ptr->strideCr,
-            &(candidateBuffer->cflTempPredictionPtr->bufferCr[cuChromaOriginIndex]),
+            candidateBuffer->cflTempPredictionPtr->bufferCr,
+            cuChromaOriginIndex,
             candidateBuffer->cflTempPredictionPtr->strideCr,
             &(((int16_t*)candidateBuffer->residual_ptr->bufferCr)[cuChromaOriginIndex]),
             candidateBuffer->residual_ptr->strideCr,
@@ -1771,12 +2046,20 @@ static void CflPrediction(
         (context_ptr->blk_geom->origin_x);
 
     // Down sample Luma
-    cfl_luma_subsampling_420_lbd_c(
-        &(candidateBuffer->recon_ptr->buffer_y[recLumaOffset]),
-        candidateBuffer->recon_ptr->stride_y,
-        context_ptr->pred_buf_q3,
-        context_ptr->blk_geom->bwidth,
-        context_ptr->blk_geom->bheight);
+    if (context_ptr->hbd_mode_decision)
+        cfl_luma_subsampling_420_hbd_c(
+            ((uint16_t*)candidateBuffer->recon_ptr->buffer_y) + recLumaOffset,
+            candidateBuffer->recon_ptr->stride_y,
+            context_ptr->pred_buf_q3,
+            context_ptr->blk_geom->bwidth,
+            context_ptr->blk_geom->bheight);
+    else
+        cfl_luma_subsampling_420_lbd_c(
+            &(candidateBuffer->recon_ptr->buffer_y[recLumaOffset]),
+            candidateBuffer->recon_ptr->stride_y,
+            context_ptr->pred_buf_q3,
+            context_ptr->blk_geom->bwidth,
+            context_ptr->blk_geom->bheight);
 
 
     int32_t round_offset = chroma_width * chroma_height / 2;
@@ -1812,34 +2095,39 @@ static void CflPrediction(
         assert(chroma_height * CFL_BUF_LINE + chroma_width <=
             CFL_BUF_SQUARE);
 
-        cfl_predict_lbd(
-            context_ptr->pred_buf_q3,
-            &(candidateBuffer->prediction_ptr->bufferCb[cuChromaOriginIndex]),
+        md_cfl_predict(
+            context_ptr,
+            candidateBuffer->prediction_ptr->bufferCb,
+            cuChromaOriginIndex,
             candidateBuffer->prediction_ptr->strideCb,
-            &(candidateBuffer->prediction_ptr->bufferCb[cuChromaOriginIndex]),
+            candidateBuffer->prediction_ptr->bufferCb,
+            cuChromaOriginIndex,
             candidateBuffer->prediction_ptr->strideCb,
             alpha_q3_cb,
-            8,
             chroma_width,
             chroma_height);
 
-        cfl_predict_lbd(
-            context_ptr->pred_buf_q3,
-            &(candidateBuffer->prediction_ptr->bufferCr[cuChromaOriginIndex]),
+        md_cfl_predict(
+            context_ptr,
+            candidateBuffer->prediction_ptr->bufferCr,
+            cuChromaOriginIndex,
             candidateBuffer->prediction_ptr->strideCr,
-            &(candidateBuffer->prediction_ptr->bufferCr[cuChromaOriginIndex]),
+            candidateBuffer->prediction_ptr->bufferCr,
+            cuChromaOriginIndex,
             candidateBuffer->prediction_ptr->strideCr,
             alpha_q3_cr,
-            8,
             chroma_width,
             chroma_height);
 
 
         //Cb Residual
-        ResidualKernel(
-            &(input_picture_ptr->bufferCb[inputCbOriginIndex]),
+        md_residual_kernel(
+            context_ptr,
+            input_picture_ptr->bufferCb,
+            inputCbOriginIndex,
             input_picture_ptr->strideCb,
-            &(candidateBuffer->prediction_ptr->bufferCb[cuChromaOriginIndex]),
+            candidateBuffer->prediction_ptr->bufferCb,
+            cuChromaOriginIndex,
             candidateBuffer->prediction_ptr->strideCb,
             &(((int16_t*)candidateBuffer->residual_ptr->bufferCb)[cuChromaOriginIndex]),
             candidateBuffer->residual_ptr->strideCb,
@@ -1848,10 +2136,13 @@ static void CflPrediction(
 
 
         //Cr Residual
-        ResidualKernel(
-            &(input_picture_ptr->bufferCr[inputCbOriginIndex]),
+        md_residual_kernel(
+            context_ptr,
+            input_picture_ptr->bufferCr,
+            inputCbOriginIndex,
             input_picture_ptr->strideCr,
-            &(candidateBuffer->prediction_ptr->bufferCr[cuChromaOriginIndex]),
+            candidateBuffer->prediction_ptr->bufferCr,
+            cuChromaOriginIndex,
             candidateBuffer->prediction_ptr->strideCr,
             &(((int16_t*)candidateBuffer->residual_ptr->bufferCr)[cuChromaOriginIndex]),
             candidateBuffer->residual_ptr->strideCr,
@@ -1966,10 +2257,13 @@ void AV1PerformFullLoop(
         }
 
         //Y Residual
-        ResidualKernel(
-            &(input_picture_ptr->buffer_y[inputOriginIndex]),
+        md_residual_kernel(
+            context_ptr,
+            input_picture_ptr->buffer_y,
+            inputOriginIndex,
             input_picture_ptr->stride_y,
-            &(candidateBuffer->prediction_ptr->buffer_y[cuOriginIndex]),
+            candidateBuffer->prediction_ptr->buffer_y,
+            cuOriginIndex,
             candidateBuffer->prediction_ptr->stride_y/* 64*/,
             &(((int16_t*)candidateBuffer->residual_ptr->buffer_y)[cuOriginIndex]),
             candidateBuffer->residual_ptr->stride_y,
@@ -1981,10 +2275,13 @@ void AV1PerformFullLoop(
         if (context_ptr->blk_geom->has_uv && context_ptr->chroma_level == CHROMA_MODE_0) {
 
 
-            ResidualKernel(
-                &(input_picture_ptr->bufferCb[inputCbOriginIndex]),
+            md_residual_kernel(
+                context_ptr,
+                input_picture_ptr->bufferCb,
+                inputCbOriginIndex,
                 input_picture_ptr->strideCb,
-                &(candidateBuffer->prediction_ptr->bufferCb[cuChromaOriginIndex]),
+                candidateBuffer->prediction_ptr->bufferCb,
+                cuChromaOriginIndex,
                 candidateBuffer->prediction_ptr->strideCb,
                 &(((int16_t*)candidateBuffer->residual_ptr->bufferCb)[cuChromaOriginIndex]),
                 candidateBuffer->residual_ptr->strideCb,
@@ -1992,10 +2289,13 @@ void AV1PerformFullLoop(
                 context_ptr->blk_geom->bheight_uv);
 
             //Cr Residual
-            ResidualKernel(
-                &(input_picture_ptr->bufferCr[inputCbOriginIndex]),
+            md_residual_kernel(
+                context_ptr,
+                input_picture_ptr->bufferCr,
+                inputCbOriginIndex,
                 input_picture_ptr->strideCr,
-                &(candidateBuffer->prediction_ptr->bufferCr[cuChromaOriginIndex]),
+                candidateBuffer->prediction_ptr->bufferCr,
+                cuChromaOriginIndex,
                 candidateBuffer->prediction_ptr->strideCr,
                 &(((int16_t*)candidateBuffer->residual_ptr->bufferCr)[cuChromaOriginIndex]),
                 candidateBuffer->residual_ptr->strideCr,
@@ -2935,6 +3235,73 @@ uint8_t check_skip_sub_blks(
 #endif
 
 
+/*******************************************
+* Keep the final candidate coefficients, EOBs and recon of an inter block
+* so EncDec can commit them instead of re-encoding the block. Blocks MD
+* encodes differently than EncDec are left to EncDec: sub 8x8 (chroma from
+* several blocks), 32x32 TUs coded N2 @ MD, chroma tx types the decoder
+* derives as DCT_DCT from a luma TU without coefficients, and non merge
+* blocks with coded DCT_DCT luma TUs, whose CBF EncDec decides again.
+* A merge block EncDec will code as skip keeps the prediction as recon.
+*******************************************/
+static void store_md_output(
+    PictureControlSet_t               *picture_control_set_ptr,
+    ModeDecisionContext_t             *context_ptr,
+    ModeDecisionCandidateBuffer_t     *candidateBuffer,
+    CodingUnit_t                      *cu_ptr)
+{
+    const BlockGeom         *blk_geom = context_ptr->blk_geom;
+    ModeDecisionCandidate_t *candidate_ptr = candidateBuffer->candidate_ptr;
+    MdEncPassCuData_t       *md_ep_pipe = &context_ptr->md_ep_pipe_sb[cu_ptr->mds_idx];
+    EbBool                   skip = (EbBool)(candidate_ptr->merge_flag && md_ep_pipe->skip_cost <= md_ep_pipe->merge_cost);
+    EbPictureBufferDesc_t   *recon_ptr = skip ? candidateBuffer->prediction_ptr : candidateBuffer->recon_ptr;
+    uint32_t                 txb_itr;
+    uint32_t                 j;
+
+    if (candidate_ptr->type != INTER_MODE || blk_geom->bwidth < 8 || blk_geom->bheight < 8)
+        return;
+
+    for (txb_itr = 0; txb_itr < blk_geom->txb_count; txb_itr++) {
+        const TransformUnit *txb_ptr = &cu_ptr->transform_unit_array[txb_itr];
+
+        if (!skip) {
+            if (blk_geom->txsize_uv[txb_itr] == TX_32X32)
+                return;
+            if (blk_geom->txsize[txb_itr] == TX_32X32 && picture_control_set_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_FALSE)
+                return;
+            if (!txb_ptr->y_has_coeff && (txb_ptr->u_has_coeff || txb_ptr->v_has_coeff) && txb_ptr->transform_type[PLANE_TYPE_UV] != DCT_DCT)
+                return;
+            if (!candidate_ptr->merge_flag && txb_ptr->y_has_coeff && txb_ptr->transform_type[PLANE_TYPE_Y] == DCT_DCT)
+                return;
+        }
+
+        md_ep_pipe->eob[0][txb_itr] = candidate_ptr->eob[0][txb_itr];
+        md_ep_pipe->eob[1][txb_itr] = candidate_ptr->eob[1][txb_itr];
+        md_ep_pipe->eob[2][txb_itr] = candidate_ptr->eob[2][txb_itr];
+    }
+
+    if (!skip) {
+        memcpy(md_ep_pipe->quant_coeff[0], candidateBuffer->residualQuantCoeffPtr->buffer_y, blk_geom->bwidth * blk_geom->bheight * sizeof(int32_t));
+        memcpy(md_ep_pipe->quant_coeff[1], candidateBuffer->residualQuantCoeffPtr->bufferCb, blk_geom->bwidth_uv * blk_geom->bheight_uv * sizeof(int32_t));
+        memcpy(md_ep_pipe->quant_coeff[2], candidateBuffer->residualQuantCoeffPtr->bufferCr, blk_geom->bwidth_uv * blk_geom->bheight_uv * sizeof(int32_t));
+    }
+
+    {
+        uint8_t *src_y = recon_ptr->buffer_y + blk_geom->origin_x + blk_geom->origin_y * recon_ptr->stride_y;
+        uint8_t *src_cb = recon_ptr->bufferCb + (blk_geom->origin_x >> 1) + (blk_geom->origin_y >> 1) * recon_ptr->strideCb;
+        uint8_t *src_cr = recon_ptr->bufferCr + (blk_geom->origin_x >> 1) + (blk_geom->origin_y >> 1) * recon_ptr->strideCr;
+
+        for (j = 0; j < blk_geom->bheight; j++)
+            memcpy(md_ep_pipe->recon[0] + j * blk_geom->bwidth, src_y + j * recon_ptr->stride_y, blk_geom->bwidth);
+        for (j = 0; j < blk_geom->bheight_uv; j++) {
+            memcpy(md_ep_pipe->recon[1] + j * blk_geom->bwidth_uv, src_cb + j * recon_ptr->strideCb, blk_geom->bwidth_uv);
+            memcpy(md_ep_pipe->recon[2] + j * blk_geom->bwidth_uv, src_cr + j * recon_ptr->strideCr, blk_geom->bwidth_uv);
+        }
+    }
+
+    md_ep_pipe->md_output_valid = EB_TRUE;
+}
+
 void md_encode_block(
     SequenceControlSet             *sequence_control_set_ptr,
     PictureControlSet_t              *picture_control_set_ptr,
@@ -2959,7 +3326,10 @@ void md_encode_block(
     EbAsm                                     asm_type = sequence_control_set_ptr->encode_context_ptr->asm_type;
     uint32_t                                  best_intra_mode = EB_INTRA_MODE_INVALID;
 
-    EbPictureBufferDesc_t                    *input_picture_ptr = picture_control_set_ptr->parent_pcs_ptr->enhanced_picture_ptr;
+    // hbd mode decision measures against the native 16bit input
+    EbPictureBufferDesc_t                    *input_picture_ptr = context_ptr->hbd_mode_decision ?
+        picture_control_set_ptr->parent_pcs_ptr->native_input_picture_ptr :
+        picture_control_set_ptr->parent_pcs_ptr->enhanced_picture_ptr;
     const uint32_t                            inputOriginIndex = (context_ptr->cu_origin_y + input_picture_ptr->origin_y) * input_picture_ptr->stride_y + (context_ptr->cu_origin_x + input_picture_ptr->origin_x);
 
     const uint32_t inputCbOriginIndex = ((context_ptr->round_origin_y >> 1) + (input_picture_ptr->origin_y >> 1)) * input_picture_ptr->strideCb + ((context_ptr->round_origin_x >> 1) + (input_picture_ptr->origin_x >> 1));
@@ -2967,6 +3337,7 @@ void md_encode_block(
     const uint32_t cuChromaOriginIndex = ROUND_UV(blk_geom->origin_x) / 2 + ROUND_UV(blk_geom->origin_y) / 2 * SB_STRIDE_UV;
     CodingUnit_t *  cu_ptr = context_ptr->cu_ptr;
     candidate_buffer_ptr_array = &(candidateBufferPtrArrayBase[0]);
+    context_ptr->md_ep_pipe_sb[cu_ptr->mds_idx].md_output_valid = EB_FALSE;
     EbBool is_nsq_table_used = (picture_control_set_ptr->slice_type == !I_SLICE &&
         picture_control_set_ptr->parent_pcs_ptr->pic_depth_mode <= PIC_ALL_C_DEPTH_MODE &&
         picture_control_set_ptr->parent_pcs_ptr->nsq_search_level >= NSQ_SEARCH_LEVEL1 &&
@@ -3219,24 +3590,53 @@ void md_encode_block(
             uint32_t recCbOffset = ((((context_ptr->blk_geom->origin_x >> 3) << 3) + ((context_ptr->blk_geom->origin_y >> 3) << 3) * candidateBuffer->recon_ptr->strideCb) >> 1);
             uint32_t recCrOffset = ((((context_ptr->blk_geom->origin_x >> 3) << 3) + ((context_ptr->blk_geom->origin_y >> 3) << 3) * candidateBuffer->recon_ptr->strideCr) >> 1);
 
-            memcpy(cu_ptr->neigh_top_recon[0], recon_ptr->buffer_y + recLumaOffset + (context_ptr->blk_geom->bheight - 1)*recon_ptr->stride_y, context_ptr->blk_geom->bwidth);
-            if (context_ptr->blk_geom->has_uv && context_ptr->chroma_level == CHROMA_MODE_0)
-            {
-                memcpy(cu_ptr->neigh_top_recon[1], recon_ptr->bufferCb + recCbOffset + (context_ptr->blk_geom->bheight_uv - 1)*recon_ptr->strideCb, context_ptr->blk_geom->bwidth_uv);
-                memcpy(cu_ptr->neigh_top_recon[2], recon_ptr->bufferCr + recCrOffset + (context_ptr->blk_geom->bheight_uv - 1)*recon_ptr->strideCr, context_ptr->blk_geom->bwidth_uv);
+            if (context_ptr->hbd_mode_decision) {
+                uint16_t *recon_y = (uint16_t*)recon_ptr->buffer_y;
+                uint16_t *recon_cb = (uint16_t*)recon_ptr->bufferCb;
+                uint16_t *recon_cr = (uint16_t*)recon_ptr->bufferCr;
+
+                memcpy(cu_ptr->neigh_top_recon[0], recon_y + recLumaOffset + (context_ptr->blk_geom->bheight - 1)*recon_ptr->stride_y, context_ptr->blk_geom->bwidth * sizeof(uint16_t));
+                if (context_ptr->blk_geom->has_uv && context_ptr->chroma_level == CHROMA_MODE_0) {
+                    memcpy(cu_ptr->neigh_top_recon[1], recon_cb + recCbOffset + (context_ptr->blk_geom->bheight_uv - 1)*recon_ptr->strideCb, context_ptr->blk_geom->bwidth_uv * sizeof(uint16_t));
+                    memcpy(cu_ptr->neigh_top_recon[2], recon_cr + recCrOffset + (context_ptr->blk_geom->bheight_uv - 1)*recon_ptr->strideCr, context_ptr->blk_geom->bwidth_uv * sizeof(uint16_t));
+                }
+
+                for (j = 0; j < context_ptr->blk_geom->bheight; ++j)
+                    ((uint16_t*)cu_ptr->neigh_left_recon[0])[j] = recon_y[recLumaOffset + context_ptr->blk_geom->bwidth - 1 + j * recon_ptr->stride_y];
+                if (context_ptr->blk_geom->has_uv && context_ptr->chroma_level == CHROMA_MODE_0) {
+                    for (j = 0; j < context_ptr->blk_geom->bheight_uv; ++j) {
+                        ((uint16_t*)cu_ptr->neigh_left_recon[1])[j] = recon_cb[recCbOffset + context_ptr->blk_geom->bwidth_uv - 1 + j * recon_ptr->strideCb];
+                        ((uint16_t*)cu_ptr->neigh_left_recon[2])[j] = recon_cr[recCrOffset + context_ptr->blk_geom->bwidth_uv - 1 + j * recon_ptr->strideCr];
+                    }
+                }
             }
+            else {
+                memcpy(cu_ptr->neigh_top_recon[0], recon_ptr->buffer_y + recLumaOffset + (context_ptr->blk_geom->bheight - 1)*recon_ptr->stride_y, context_ptr->blk_geom->bwidth);
+                if (context_ptr->blk_geom->has_uv && context_ptr->chroma_level == CHROMA_MODE_0)
+                {
+                    memcpy(cu_ptr->neigh_top_recon[1], recon_ptr->bufferCb + recCbOffset + (context_ptr->blk_geom->bheight_uv - 1)*recon_ptr->strideCb, context_ptr->blk_geom->bwidth_uv);
+                    memcpy(cu_ptr->neigh_top_recon[2], recon_ptr->bufferCr + recCrOffset + (context_ptr->blk_geom->bheight_uv - 1)*recon_ptr->strideCr, context_ptr->blk_geom->bwidth_uv);
+                }
 
-            for (j = 0; j < context_ptr->blk_geom->bheight; ++j)
+                for (j = 0; j < context_ptr->blk_geom->bheight; ++j)
 
-                cu_ptr->neigh_left_recon[0][j] = recon_ptr->buffer_y[recLumaOffset + context_ptr->blk_geom->bwidth - 1 + j * recon_ptr->stride_y];
-            if (context_ptr->blk_geom->has_uv && context_ptr->chroma_level == CHROMA_MODE_0) {
-                for (j = 0; j < context_ptr->blk_geom->bheight_uv; ++j) {
-                    cu_ptr->neigh_left_recon[1][j] = recon_ptr->bufferCb[recCbOffset + context_ptr->blk_geom->bwidth_uv - 1 + j * recon_ptr->strideCb];
-                    cu_ptr->neigh_left_recon[2][j] = recon_ptr->bufferCr[recCrOffset + context_ptr->blk_geom->bwidth_uv - 1 + j * recon_ptr->strideCr];
+                    cu_ptr->neigh_left_recon[0][j] = recon_ptr->buffer_y[recLumaOffset + context_ptr->blk_geom->bwidth - 1 + j * recon_ptr->stride_y];
+                if (context_ptr->blk_geom->has_uv && context_ptr->chroma_level == CHROMA_MODE_0) {
+                    for (j = 0; j < context_ptr->blk_geom->bheight_uv; ++j) {
+                        cu_ptr->neigh_left_recon[1][j] = recon_ptr->bufferCb[recCbOffset + context_ptr->blk_geom->bwidth_uv - 1 + j * recon_ptr->strideCb];
+                        cu_ptr->neigh_left_recon[2][j] = recon_ptr->bufferCr[recCrOffset + context_ptr->blk_geom->bwidth_uv - 1 + j * recon_ptr->strideCr];
+                    }
                 }
             }
         }
 
+        if (context_ptr->md_output_reuse)
+            store_md_output(
+                picture_control_set_ptr,
+                context_ptr,
+                candidateBuffer,
+                cu_ptr);
+
 
 #if NO_ENCDEC
         //copy recon
@@ -3327,6 +3727,7 @@ EB_EXTERN EbErrorType mode_decision_sb(
     UNUSED(lastCuIndex);
 
     context_ptr->sb_ptr = sb_ptr;
+    md_pred_cache_reset(context_ptr);
     context_ptr->group_of8x8_blocks_count = 0;
     context_ptr->group_of16x16_blocks_count = 0;
 
@@ -3402,18 +3803,6 @@ EB_EXTERN EbErrorType mode_decision_sb(
         cu_ptr->qp = context_ptr->qp;
         cu_ptr->best_d1_blk = blk_idx_mds;
 
-            if (leafDataPtr->tot_d1_blocks != 1)
-            {
-                if (blk_geom->shape == PART_N)
-                    copy_neighbour_arrays(      //save a clean neigh in [1], encode uses [0], reload the clean in [0] after done last ns block in a partition
-                        picture_control_set_ptr,
-                        context_ptr,
-                        0, 1,
-                        blk_idx_mds,
-                        sb_origin_x,
-                        sb_origin_y);
-            }
-
         md_encode_block(
             sequence_control_set_ptr,
             picture_control_set_ptr,
@@ -3430,22 +3819,25 @@ EB_EXTERN EbErrorType mode_decision_sb(
         if (blk_geom->nsi + 1 == blk_geom->totns)
             d1_non_square_block_decision(context_ptr);
 
+        // The blocks of a non-square shape update the neighbor arrays for the next ones;
+        // after the last block of the shape the updates are undone
         if (blk_geom->shape != PART_N) {
-            if (blk_geom->nsi + 1 < blk_geom->totns)
-                md_update_all_neighbour_arrays(
+            if (blk_geom->nsi + 1 < blk_geom->totns) {
+                save_neighbour_arrays(
                     picture_control_set_ptr,
                     context_ptr,
                     blk_idx_mds,
                     sb_origin_x,
                     sb_origin_y);
-            else
-                copy_neighbour_arrays(      //restore [1] in [0] after done last ns block
+                md_update_all_neighbour_arrays(
                     picture_control_set_ptr,
                     context_ptr,
-                    1, 0,
-                    blk_geom->sqi_mds,
+                    blk_idx_mds,
                     sb_origin_x,
                     sb_origin_y);
+            }
+            else
+                neighbor_array_undo(context_ptr->neighbor_undo_log);
         }
 
 
@@ -29,10 +29,10 @@ double aom_sse_to_psnr(double samples, double peak, double sse) {
 /* TODO(yaowu): The block_variance calls the unoptimized versions of variance()
  * and highbd_8_variance(). It should not.
  */
-static int32_t encoder_variance(const uint8_t *a, int32_t a_stride, const uint8_t *b,
+static int64_t encoder_variance(const uint8_t *a, int32_t a_stride, const uint8_t *b,
     int32_t b_stride, int32_t w, int32_t h) {
     int32_t i, j;
-    int32_t sse = 0;
+    int64_t sse = 0;
 
     for (i = 0; i < h; i++) {
         for (j = 0; j < w; j++) {
@@ -62,12 +62,6 @@ static int64_t encoder_highbd_variance64(const uint8_t *a8, int32_t a_stride,
     return sse;
 }
 
-static void encoder_highbd_8_variance(const uint8_t *a8, int32_t a_stride,
-    const uint8_t *b8, int32_t b_stride, int32_t w,
-    int32_t h, uint32_t *sse) {
-    *sse = (uint32_t)encoder_highbd_variance64(a8, a_stride, b8, b_stride, w, h);
-}
-
 static void variance(const uint8_t *a, int32_t a_stride, const uint8_t *b,
     int b_stride, int w, int h, uint32_t *sse, int32_t *sum) {
     int i, j;
@@ -95,7 +89,7 @@ uint32_t aom_mse16x16_c(const uint8_t *src_ptr, int32_t  source_stride,
 }
 
 
-static int64_t get_sse(const uint8_t *a, int32_t a_stride, const uint8_t *b,
+int64_t aom_get_sse(const uint8_t *a, int32_t a_stride, const uint8_t *b,
     int32_t b_stride, int32_t width, int32_t height) {
     const int32_t dw = width % 16;
     const int32_t dh = height % 16;
@@ -103,16 +97,15 @@ static int64_t get_sse(const uint8_t *a, int32_t a_stride, const uint8_t *b,
     uint32_t sse = 0;
     int32_t x, y;
 
+    // The remainder strips can be a whole picture long, keep them in 64 bits
     if (dw > 0) {
-        sse = encoder_variance(&a[width - dw], a_stride, &b[width - dw], b_stride, dw,
+        total_sse += encoder_variance(&a[width - dw], a_stride, &b[width - dw], b_stride, dw,
             height);
-        total_sse += sse;
     }
 
     if (dh > 0) {
-        sse = encoder_variance(&a[(height - dh) * a_stride], a_stride,
+        total_sse += encoder_variance(&a[(height - dh) * a_stride], a_stride,
             &b[(height - dh) * b_stride], b_stride, width - dw, dh);
-        total_sse += sse;
     }
 
     for (y = 0; y < height / 16; ++y) {
@@ -135,7 +128,7 @@ static int64_t get_sse(const uint8_t *a, int32_t a_stride, const uint8_t *b,
     return total_sse;
 }
 
-static int64_t highbd_get_sse(const uint8_t *a, int32_t a_stride, const uint8_t *b,
+int64_t aom_highbd_get_sse(const uint8_t *a, int32_t a_stride, const uint8_t *b,
     int32_t b_stride, int32_t width, int32_t height) {
     int64_t total_sse = 0;
     int32_t x, y;
@@ -143,15 +136,13 @@ static int64_t highbd_get_sse(const uint8_t *a, int32_t a_stride, const uint8_t
     const int32_t dh = height % 16;
     uint32_t sse = 0;
     if (dw > 0) {
-        encoder_highbd_8_variance(&a[width - dw], a_stride, &b[width - dw],
-            b_stride, dw, height, &sse);
-        total_sse += sse;
+        total_sse += encoder_highbd_variance64(&a[width - dw], a_stride, &b[width - dw],
+            b_stride, dw, height);
     }
     if (dh > 0) {
-        encoder_highbd_8_variance(&a[(height - dh) * a_stride], a_stride,
+        total_sse += encoder_highbd_variance64(&a[(height - dh) * a_stride], a_stride,
             &b[(height - dh) * b_stride], b_stride,
-            width - dw, dh, &sse);
-        total_sse += sse;
+            width - dw, dh);
     }
     for (y = 0; y < height / 16; ++y) {
         const uint8_t *pa = a;
@@ -172,7 +163,7 @@ static int64_t highbd_get_sse(const uint8_t *a, int32_t a_stride, const uint8_t
 int64_t aom_get_y_sse_part(const Yv12BufferConfig *a,
     const Yv12BufferConfig *b, int32_t hstart, int32_t width,
     int32_t vstart, int32_t height) {
-    return get_sse(a->y_buffer + vstart * a->y_stride + hstart, a->y_stride,
+    return aom_get_sse(a->y_buffer + vstart * a->y_stride + hstart, a->y_stride,
         b->y_buffer + vstart * b->y_stride + hstart, b->y_stride,
         width, height);
 }
@@ -182,14 +173,14 @@ int64_t aom_get_y_sse(const Yv12BufferConfig *a,
     assert(a->y_crop_width == b->y_crop_width);
     assert(a->y_crop_height == b->y_crop_height);
 
-    return get_sse(a->y_buffer, a->y_stride, b->y_buffer, b->y_stride,
+    return aom_get_sse(a->y_buffer, a->y_stride, b->y_buffer, b->y_stride,
         a->y_crop_width, a->y_crop_height);
 }
 
 int64_t aom_get_u_sse_part(const Yv12BufferConfig *a,
     const Yv12BufferConfig *b, int32_t hstart, int32_t width,
     int32_t vstart, int32_t height) {
-    return get_sse(a->u_buffer + vstart * a->uv_stride + hstart, a->uv_stride,
+    return aom_get_sse(a->u_buffer + vstart * a->uv_stride + hstart, a->uv_stride,
         b->u_buffer + vstart * b->uv_stride + hstart, b->uv_stride,
         width, height);
 }
@@ -199,14 +190,14 @@ int64_t aom_get_u_sse(const Yv12BufferConfig *a,
     assert(a->uv_crop_width == b->uv_crop_width);
     assert(a->uv_crop_height == b->uv_crop_height);
 
-    return get_sse(a->u_buffer, a->uv_stride, b->u_buffer, b->uv_stride,
+    return aom_get_sse(a->u_buffer, a->uv_stride, b->u_buffer, b->uv_stride,
         a->uv_crop_width, a->uv_crop_height);
 }
 
 int64_t aom_get_v_sse_part(const Yv12BufferConfig *a,
     const Yv12BufferConfig *b, int32_t hstart, int32_t width,
     int32_t vstart, int32_t height) {
-    return get_sse(a->v_buffer + vstart * a->uv_stride + hstart, a->uv_stride,
+    return aom_get_sse(a->v_buffer + vstart * a->uv_stride + hstart, a->uv_stride,
         b->v_buffer + vstart * b->uv_stride + hstart, b->uv_stride,
         width, height);
 }
@@ -216,14 +207,14 @@ int64_t aom_get_v_sse(const Yv12BufferConfig *a,
     assert(a->uv_crop_width == b->uv_crop_width);
     assert(a->uv_crop_height == b->uv_crop_height);
 
-    return get_sse(a->v_buffer, a->uv_stride, b->v_buffer, b->uv_stride,
+    return aom_get_sse(a->v_buffer, a->uv_stride, b->v_buffer, b->uv_stride,
         a->uv_crop_width, a->uv_crop_height);
 }
 
 int64_t aom_highbd_get_y_sse_part(const Yv12BufferConfig *a,
     const Yv12BufferConfig *b, int32_t hstart,
     int32_t width, int32_t vstart, int32_t height) {
-    return highbd_get_sse(
+    return aom_highbd_get_sse(
         a->y_buffer + vstart * a->y_stride + hstart, a->y_stride,
         b->y_buffer + vstart * b->y_stride + hstart, b->y_stride, width, height);
 }
@@ -235,14 +226,14 @@ int64_t aom_highbd_get_y_sse(const Yv12BufferConfig *a,
     assert((a->flags & YV12_FLAG_HIGHBITDEPTH) != 0);
     assert((b->flags & YV12_FLAG_HIGHBITDEPTH) != 0);
 
-    return highbd_get_sse(a->y_buffer, a->y_stride, b->y_buffer, b->y_stride,
+    return aom_highbd_get_sse(a->y_buffer, a->y_stride, b->y_buffer, b->y_stride,
         a->y_crop_width, a->y_crop_height);
 }
 
 int64_t aom_highbd_get_u_sse_part(const Yv12BufferConfig *a,
     const Yv12BufferConfig *b, int32_t hstart,
     int32_t width, int32_t vstart, int32_t height) {
-    return highbd_get_sse(a->u_buffer + vstart * a->uv_stride + hstart,
+    return aom_highbd_get_sse(a->u_buffer + vstart * a->uv_stride + hstart,
         a->uv_stride,
         b->u_buffer + vstart * b->uv_stride + hstart,
         b->uv_stride, width, height);
@@ -255,14 +246,14 @@ int64_t aom_highbd_get_u_sse(const Yv12BufferConfig *a,
     assert((a->flags & YV12_FLAG_HIGHBITDEPTH) != 0);
     assert((b->flags & YV12_FLAG_HIGHBITDEPTH) != 0);
 
-    return highbd_get_sse(a->u_buffer, a->uv_stride, b->u_buffer, b->uv_stride,
+    return aom_highbd_get_sse(a->u_buffer, a->uv_stride, b->u_buffer, b->uv_stride,
         a->uv_crop_width, a->uv_crop_height);
 }
 
 int64_t aom_highbd_get_v_sse_part(const Yv12BufferConfig *a,
     const Yv12BufferConfig *b, int32_t hstart,
     int32_t width, int32_t vstart, int32_t height) {
-    return highbd_get_sse(a->v_buffer + vstart * a->uv_stride + hstart,
+    return aom_highbd_get_sse(a->v_buffer + vstart * a->uv_stride + hstart,
         a->uv_stride,
         b->v_buffer + vstart * b->uv_stride + hstart,
         b->uv_stride, width, height);
@@ -275,10 +266,100 @@ int64_t aom_highbd_get_v_sse(const Yv12BufferConfig *a,
     assert((a->flags & YV12_FLAG_HIGHBITDEPTH) != 0);
     assert((b->flags & YV12_FLAG_HIGHBITDEPTH) != 0);
 
-    return highbd_get_sse(a->v_buffer, a->uv_stride, b->v_buffer, b->uv_stride,
+    return aom_highbd_get_sse(a->v_buffer, a->uv_stride, b->v_buffer, b->uv_stride,
         a->uv_crop_width, a->uv_crop_height);
 }
 
+void aom_ssim_parms_8x8_c(const uint8_t *s, int32_t sp, const uint8_t *r,
+    int32_t rp, uint32_t *sum_s, uint32_t *sum_r, uint32_t *sum_sq_s,
+    uint32_t *sum_sq_r, uint32_t *sum_sxr) {
+    for (int32_t i = 0; i < 8; i++, s += sp, r += rp) {
+        for (int32_t j = 0; j < 8; j++) {
+            *sum_s += s[j];
+            *sum_r += r[j];
+            *sum_sq_s += s[j] * s[j];
+            *sum_sq_r += r[j] * r[j];
+            *sum_sxr += s[j] * r[j];
+        }
+    }
+}
+
+static void highbd_ssim_parms_8x8(const uint16_t *s, int32_t sp,
+    const uint16_t *r, int32_t rp, uint32_t *sum_s, uint32_t *sum_r,
+    uint32_t *sum_sq_s, uint32_t *sum_sq_r, uint32_t *sum_sxr) {
+    for (int32_t i = 0; i < 8; i++, s += sp, r += rp) {
+        for (int32_t j = 0; j < 8; j++) {
+            *sum_s += s[j];
+            *sum_r += r[j];
+            *sum_sq_s += s[j] * s[j];
+            *sum_sq_r += r[j] * r[j];
+            *sum_sxr += s[j] * r[j];
+        }
+    }
+}
+
+static const int64_t cc1 = 26634;        // (64^2*(.01*255)^2
+static const int64_t cc2 = 239708;       // (64^2*(.03*255)^2
+static const int64_t cc1_10 = 428658;    // (64^2*(.01*1023)^2
+static const int64_t cc2_10 = 3857925;   // (64^2*(.03*1023)^2
+
+static double similarity(uint32_t sum_s, uint32_t sum_r, uint32_t sum_sq_s,
+    uint32_t sum_sq_r, uint32_t sum_sxr, int32_t count, uint32_t bd) {
+    // scale the constants by number of pixels
+    const int64_t c1 = ((bd == 8 ? cc1 : cc1_10) * count * count) >> 12;
+    const int64_t c2 = ((bd == 8 ? cc2 : cc2_10) * count * count) >> 12;
+
+    const double ssim_n = (2.0 * sum_s * sum_r + c1) *
+        (2.0 * count * sum_sxr - 2.0 * sum_s * sum_r + c2);
+    const double ssim_d = ((double)sum_s * sum_s + (double)sum_r * sum_r + c1) *
+        ((double)count * sum_sq_s - (double)sum_s * sum_s +
+        (double)count * sum_sq_r - (double)sum_r * sum_r + c2);
+
+    return ssim_n / ssim_d;
+}
+
+// We are using a 8x8 moving window with starting location of each 8x8 window
+// on the 4x4 pixel grid. Such arrangement allows the windows to overlap
+// block boundaries to penalize blocking artifacts.
+double aom_ssim2(const uint8_t *img1, int32_t stride_img1, const uint8_t *img2,
+    int32_t stride_img2, int32_t width, int32_t height) {
+    int32_t samples = 0;
+    double ssim_total = 0;
+
+    for (int32_t i = 0; i <= height - 8;
+        i += 4, img1 += stride_img1 * 4, img2 += stride_img2 * 4) {
+        for (int32_t j = 0; j <= width - 8; j += 4) {
+            uint32_t sum_s = 0, sum_r = 0, sum_sq_s = 0, sum_sq_r = 0, sum_sxr = 0;
+            aom_ssim_parms_8x8(img1 + j, stride_img1, img2 + j, stride_img2,
+                &sum_s, &sum_r, &sum_sq_s, &sum_sq_r, &sum_sxr);
+            ssim_total += similarity(sum_s, sum_r, sum_sq_s, sum_sq_r, sum_sxr, 64, 8);
+            samples++;
+        }
+    }
+    return samples ? ssim_total / samples : 1.0;
+}
+
+double aom_highbd_ssim2(const uint8_t *img1, int32_t stride_img1,
+    const uint8_t *img2, int32_t stride_img2, int32_t width, int32_t height,
+    uint32_t bd) {
+    const uint16_t *s = CONVERT_TO_SHORTPTR(img1);
+    const uint16_t *r = CONVERT_TO_SHORTPTR(img2);
+    int32_t samples = 0;
+    double ssim_total = 0;
+
+    for (int32_t i = 0; i <= height - 8;
+        i += 4, s += stride_img1 * 4, r += stride_img2 * 4) {
+        for (int32_t j = 0; j <= width - 8; j += 4) {
+            uint32_t sum_s = 0, sum_r = 0, sum_sq_s = 0, sum_sq_r = 0, sum_sxr = 0;
+            highbd_ssim_parms_8x8(s + j, stride_img1, r + j, stride_img2,
+                &sum_s, &sum_r, &sum_sq_s, &sum_sq_r, &sum_sxr);
+            ssim_total += similarity(sum_s, sum_r, sum_sq_s, sum_sq_r, sum_sxr, 64, bd);
+            samples++;
+        }
+    }
+    return samples ? ssim_total / samples : 1.0;
+}
+
 
 
 
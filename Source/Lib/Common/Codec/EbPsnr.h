@@ -42,6 +42,27 @@ extern "C" {
         double peak, 
         double sse);
 
+    /*!\brief Sum of squared errors of a width x height block
+     *
+     * aom_highbd_get_sse takes CONVERT_TO_BYTEPTR pointers and strides in
+     * samples.
+     */
+    int64_t aom_get_sse(
+        const uint8_t *a,
+        int32_t        a_stride,
+        const uint8_t *b,
+        int32_t        b_stride,
+        int32_t        width,
+        int32_t        height);
+
+    int64_t aom_highbd_get_sse(
+        const uint8_t *a,
+        int32_t        a_stride,
+        const uint8_t *b,
+        int32_t        b_stride,
+        int32_t        width,
+        int32_t        height);
+
     int64_t aom_get_y_sse_part(
         const Yv12BufferConfig *a,
         const Yv12BufferConfig *b, 
@@ -114,6 +135,28 @@ extern "C" {
         const Yv12BufferConfig *a,
         const Yv12BufferConfig *b);
 
+    /*!\brief Mean SSIM of 8x8 windows placed on a 4x4 grid
+     *
+     * aom_highbd_ssim2 takes CONVERT_TO_BYTEPTR pointers and strides in
+     * samples; bd is 8 or 10.
+     */
+    double aom_ssim2(
+        const uint8_t *img1,
+        int32_t        stride_img1,
+        const uint8_t *img2,
+        int32_t        stride_img2,
+        int32_t        width,
+        int32_t        height);
+
+    double aom_highbd_ssim2(
+        const uint8_t *img1,
+        int32_t        stride_img1,
+        const uint8_t *img2,
+        int32_t        stride_img2,
+        int32_t        width,
+        int32_t        height,
+        uint32_t       bd);
+
     double aom_psnrhvs(
         const Yv12BufferConfig *source,
         const Yv12BufferConfig *dest, 
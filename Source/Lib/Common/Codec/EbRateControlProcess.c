@@ -415,6 +415,62 @@ uint64_t predict_bits(
     return total_bits;
 }
 
+/*********************************************************************
+ * predict_stats_bits
+ *  Predicted bits of the pictures [first_picture_number, first_picture_number + frame_count)
+ *  at the reference QP, using the histograms of the analysis pass stats.
+ *  Optionally accumulates the predicted bits per temporal layer.
+ *********************************************************************/
+static uint64_t predict_stats_bits(
+    SequenceControlSet              *sequence_control_set_ptr,
+    EncodeContext_t                 *encode_context_ptr,
+    RateControlContext              *context_ptr,
+    uint64_t                         first_picture_number,
+    uint32_t                         frame_count,
+    uint32_t                         ref_qp,
+    uint32_t                         area_in_pixel,
+    uint64_t                        *bits_per_layer)
+{
+    HlRateControlHistogramEntry_t    stats_histogram;
+    RcStatsEntry_t                  *stats_entry_ptr;
+    uint64_t                         picture_number;
+    uint64_t                         last_picture_number = MIN(first_picture_number + frame_count, encode_context_ptr->rc_stats_in_count);
+    uint32_t                         ref_qp_index_temp;
+    uint64_t                         pred_bits;
+    uint64_t                         total_bits = 0;
+
+    stats_histogram.is_coded = EB_FALSE;
+    for (picture_number = first_picture_number; picture_number < last_picture_number; ++picture_number) {
+        stats_entry_ptr = &encode_context_ptr->rc_stats_in[picture_number];
+        stats_histogram.slice_type = (EB_SLICE)stats_entry_ptr->slice_type;
+        stats_histogram.temporal_layer_index = stats_entry_ptr->temporal_layer_index;
+        stats_histogram.full_sb_count = stats_entry_ptr->full_sb_count;
+        stats_histogram.me_distortion_histogram = stats_entry_ptr->me_distortion_histogram;
+        stats_histogram.ois_distortion_histogram = stats_entry_ptr->ois_distortion_histogram;
+
+        if (stats_histogram.slice_type == I_SLICE)
+            ref_qp_index_temp = context_ptr->qp_scaling_map_I_SLICE[ref_qp];
+        else
+            ref_qp_index_temp = context_ptr->qp_scaling_map[stats_histogram.temporal_layer_index][ref_qp];
+
+        ref_qp_index_temp = (uint32_t)CLIP3(
+            sequence_control_set_ptr->static_config.min_qp_allowed,
+            sequence_control_set_ptr->static_config.max_qp_allowed,
+            ref_qp_index_temp);
+
+        pred_bits = stats_histogram.full_sb_count ? predict_bits(
+            encode_context_ptr,
+            &stats_histogram,
+            ref_qp_index_temp,
+            area_in_pixel) : 0;
+
+        total_bits += pred_bits;
+        if (bits_per_layer)
+            bits_per_layer[stats_histogram.temporal_layer_index] += pred_bits;
+    }
+    return total_bits;
+}
+
 void high_level_rc_input_picture_vbr(
     PictureParentControlSet_t     *picture_control_set_ptr,
     SequenceControlSet          *sequence_control_set_ptr,
@@ -455,6 +511,9 @@ void high_level_rc_input_picture_vbr(
     EbBool                      tables_updated;
 
     uint64_t                     bit_constraint_per_sw = 0;
+    // Pictures of the intra period beyond the look ahead, predicted from the analysis pass stats
+    uint32_t                     stats_frames = 0;
+    uint32_t                     frames_in_window;
 
     RateControlTables           *rate_control_tables_ptr;
     EbBitNumber                 *sad_bits_array_ptr;
@@ -468,6 +527,13 @@ void high_level_rc_input_picture_vbr(
 
     area_in_pixel = sequence_control_set_ptr->luma_width * sequence_control_set_ptr->luma_height;;
 
+    if (encode_context_ptr->rc_stats_in && sequence_control_set_ptr->intra_period_length != -1 &&
+        picture_control_set_ptr->picture_number < encode_context_ptr->rc_stats_in_count) {
+        frames_in_window = (uint32_t)MIN((uint64_t)sequence_control_set_ptr->intra_period_length + 1, encode_context_ptr->rc_stats_in_count - picture_control_set_ptr->picture_number);
+        stats_frames = frames_in_window > picture_control_set_ptr->frames_in_sw ? frames_in_window - picture_control_set_ptr->frames_in_sw : 0;
+    }
+    frames_in_window = picture_control_set_ptr->frames_in_sw + stats_frames;
+
     eb_block_on_mutex(sequence_control_set_ptr->encode_context_ptr->rate_table_update_mutex);
 
     tables_updated = sequence_control_set_ptr->encode_context_ptr->rate_control_tables_array_updated;
@@ -608,7 +674,7 @@ void high_level_rc_input_picture_vbr(
                 high_level_rate_control_ptr->pred_bits_ref_qpPerSw[ref_qp_table_index] = 0;
             }
 
-            bit_constraint_per_sw = high_level_rate_control_ptr->bit_constraint_per_sw * picture_control_set_ptr->frames_in_sw / (sequence_control_set_ptr->static_config.look_ahead_distance + 1);
+            bit_constraint_per_sw = high_level_rate_control_ptr->bit_constraint_per_sw * frames_in_window / (sequence_control_set_ptr->static_config.look_ahead_distance + 1);
 
             // Update the target rate for the sliding window based on the status of RC    
             if ((context_ptr->extra_bits_gen > (int64_t)(context_ptr->virtual_buffer_size * 10))) {
@@ -693,6 +759,18 @@ void high_level_rc_input_picture_vbr(
                     queue_entry_index_temp++;
                 }
 
+                if (stats_frames) {
+                    high_level_rate_control_ptr->pred_bits_ref_qpPerSw[ref_qp_index] += predict_stats_bits(
+                        sequence_control_set_ptr,
+                        encode_context_ptr,
+                        context_ptr,
+                        picture_control_set_ptr->picture_number + picture_control_set_ptr->frames_in_sw,
+                        stats_frames,
+                        ref_qp_index,
+                        area_in_pixel,
+                        (uint64_t*)EB_NULL);
+                }
+
                 if (min_la_bit_distance >= (uint64_t)ABS((int64_t)high_level_rate_control_ptr->pred_bits_ref_qpPerSw[ref_qp_index] - (int64_t)bit_constraint_per_sw)) {
                     min_la_bit_distance = (uint64_t)ABS((int64_t)high_level_rate_control_ptr->pred_bits_ref_qpPerSw[ref_qp_index] - (int64_t)bit_constraint_per_sw);
                     selected_ref_qp_table_index = ref_qp_table_index;
@@ -717,7 +795,7 @@ void high_level_rc_input_picture_vbr(
 
         selected_org_ref_qp = selected_ref_qp;
         if (sequence_control_set_ptr->intra_period_length != -1 && picture_control_set_ptr->picture_number % ((sequence_control_set_ptr->intra_period_length + 1)) == 0 &&
-            (int32_t)picture_control_set_ptr->frames_in_sw > sequence_control_set_ptr->intra_period_length) {
+            (int32_t)frames_in_window > sequence_control_set_ptr->intra_period_length) {
             if (picture_control_set_ptr->picture_number > 0) {
                 picture_control_set_ptr->intra_selected_org_qp = (uint8_t)selected_ref_qp;
             }
@@ -778,8 +856,8 @@ void high_level_rc_input_picture_vbr(
         EbBool expensive_i_slice = EB_FALSE;
         // Looping over the window to find the percentage of bit allocation in each layer
         if ((sequence_control_set_ptr->intra_period_length != -1) &&
-            ((int32_t)picture_control_set_ptr->frames_in_sw > sequence_control_set_ptr->intra_period_length) &&
-            ((int32_t)picture_control_set_ptr->frames_in_sw > sequence_control_set_ptr->intra_period_length)) {
+            ((int32_t)frames_in_window > sequence_control_set_ptr->intra_period_length) &&
+            ((int32_t)frames_in_window > sequence_control_set_ptr->intra_period_length)) {
             uint64_t i_slice_bits = 0;
 
             if (picture_control_set_ptr->picture_number % ((sequence_control_set_ptr->intra_period_length + 1)) == 0) {
@@ -821,6 +899,41 @@ void high_level_rc_input_picture_vbr(
                     end_of_sequence_flag = hl_rate_control_histogram_ptr_temp->end_of_sequence_flag;
                     queue_entry_index_temp++;
                 }
+
+                // The look ahead only covers part of the intra period: take the bit allocation per layer,
+                // the number of pictures per layer and the scene changes from the analysis pass stats
+                if (stats_frames) {
+                    uint64_t picture_number;
+
+                    for (temporal_layer_index = 0; temporal_layer_index < EB_MAX_TEMPORAL_LAYERS; temporal_layer_index++) {
+                        picture_control_set_ptr->bits_per_sw_per_layer[temporal_layer_index] = 0;
+                        picture_control_set_ptr->frames_in_interval[temporal_layer_index] = 0;
+                    }
+                    i_slice_bits = predict_stats_bits(
+                        sequence_control_set_ptr,
+                        encode_context_ptr,
+                        context_ptr,
+                        picture_control_set_ptr->picture_number,
+                        1,
+                        selected_ref_qp,
+                        area_in_pixel,
+                        (uint64_t*)EB_NULL);
+                    picture_control_set_ptr->total_bits_per_gop = predict_stats_bits(
+                        sequence_control_set_ptr,
+                        encode_context_ptr,
+                        context_ptr,
+                        picture_control_set_ptr->picture_number,
+                        frames_in_window,
+                        selected_ref_qp,
+                        area_in_pixel,
+                        picture_control_set_ptr->bits_per_sw_per_layer);
+                    for (picture_number = picture_control_set_ptr->picture_number; picture_number < picture_control_set_ptr->picture_number + frames_in_window; ++picture_number) {
+                        picture_control_set_ptr->frames_in_interval[encode_context_ptr->rc_stats_in[picture_number].temporal_layer_index]++;
+                        if (encode_context_ptr->rc_stats_in[picture_number].scene_change_flag)
+                            picture_control_set_ptr->scene_change_in_gop = EB_TRUE;
+                    }
+                    picture_control_set_ptr->percentage_updated = EB_TRUE;
+                }
                 if (i_slice_bits * 100 > 85 * picture_control_set_ptr->total_bits_per_gop) {
                     expensive_i_slice = EB_TRUE;
                 }
@@ -0,0 +1,128 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#include <string.h>
+
+#include "EbRateControlStats.h"
+#include "EbEncodeContext.h"
+#include "EbSequenceControlSet.h"
+#include "EbPictureControlSet.h"
+
+/************************************************
+ * Verify the stats of a previous analysis pass
+ ************************************************/
+static EbErrorType RcStatsVerify(
+    SequenceControlSet              *sequence_control_set_ptr,
+    const EbSvtAv1FixedBuf          *stats)
+{
+    const RcStatsHeader_t  *header_ptr = (const RcStatsHeader_t*)stats->buf;
+    const RcStatsEntry_t   *entry_ptr = (const RcStatsEntry_t*)(header_ptr + 1);
+    uint64_t                picture_index;
+
+    if (stats->sz < sizeof(RcStatsHeader_t) || header_ptr->magic != RC_STATS_MAGIC || header_ptr->version != RC_STATS_VERSION) {
+        SVT_LOG("Error: the input stats are not analysis pass stats (version %d)\n", RC_STATS_VERSION);
+        return EB_ErrorBadParameter;
+    }
+    // Bound the count first, a corrupt one would overflow the size check
+    if (header_ptr->frame_count == 0 || header_ptr->frame_count > (stats->sz - sizeof(RcStatsHeader_t)) / sizeof(RcStatsEntry_t) ||
+        stats->sz != sizeof(RcStatsHeader_t) + header_ptr->frame_count * sizeof(RcStatsEntry_t)) {
+        SVT_LOG("Error: the input stats are truncated\n");
+        return EB_ErrorBadParameter;
+    }
+    if (header_ptr->width != sequence_control_set_ptr->static_config.source_width ||
+        header_ptr->height != sequence_control_set_ptr->static_config.source_height ||
+        header_ptr->intra_period_length != sequence_control_set_ptr->intra_period_length ||
+        header_ptr->hierarchical_levels != sequence_control_set_ptr->static_config.hierarchical_levels) {
+        SVT_LOG("Error: the input stats were produced for a different resolution or prediction structure\n");
+        return EB_ErrorBadParameter;
+    }
+    for (picture_index = 0; picture_index < header_ptr->frame_count; ++picture_index) {
+        if (entry_ptr[picture_index].picture_number != picture_index) {
+            SVT_LOG("Error: the input stats are missing picture %llu\n", (unsigned long long)picture_index);
+            return EB_ErrorBadParameter;
+        }
+    }
+
+    return EB_ErrorNone;
+}
+
+/************************************************
+ * Rate Control Stats Constructor
+ *  Allocates the analysis pass output buffer and
+ *  takes a copy of the stats of a previous pass
+ ************************************************/
+EbErrorType RcStatsCtor(
+    EncodeContext_t                 *encode_context_ptr,
+    SequenceControlSet              *sequence_control_set_ptr)
+{
+    EbSvtAv1EncConfiguration *config = &sequence_control_set_ptr->static_config;
+    EbErrorType               return_error;
+    RcStatsHeader_t          *header_ptr;
+    void                     *stats_copy;
+
+    encode_context_ptr->rc_stats_out = (uint8_t*)EB_NULL;
+    encode_context_ptr->rc_stats_out_size = 0;
+    encode_context_ptr->rc_stats_in = (RcStatsEntry_t*)EB_NULL;
+    encode_context_ptr->rc_stats_in_count = 0;
+
+    if (config->rc_firstpass_stats_out) {
+        encode_context_ptr->rc_stats_out_size = sizeof(RcStatsHeader_t) + config->frames_to_be_encoded * sizeof(RcStatsEntry_t);
+        EB_MALLOC(uint8_t*, encode_context_ptr->rc_stats_out, encode_context_ptr->rc_stats_out_size, EB_N_PTR);
+        EB_MEMSET(encode_context_ptr->rc_stats_out, 0, encode_context_ptr->rc_stats_out_size);
+
+        header_ptr = (RcStatsHeader_t*)encode_context_ptr->rc_stats_out;
+        header_ptr->magic = RC_STATS_MAGIC;
+        header_ptr->version = RC_STATS_VERSION;
+        header_ptr->width = config->source_width;
+        header_ptr->height = config->source_height;
+        header_ptr->intra_period_length = sequence_control_set_ptr->intra_period_length;
+        header_ptr->hierarchical_levels = config->hierarchical_levels;
+        header_ptr->frame_count = 0;
+    }
+
+    if (config->rc_twopass_stats_in.buf) {
+        return_error = RcStatsVerify(sequence_control_set_ptr, &config->rc_twopass_stats_in);
+        if (return_error != EB_ErrorNone)
+            return return_error;
+
+        // The application owns the input buffer, keep a copy for the life of the encoder
+        EB_MALLOC(void*, stats_copy, config->rc_twopass_stats_in.sz, EB_N_PTR);
+        EB_MEMCPY(stats_copy, config->rc_twopass_stats_in.buf, config->rc_twopass_stats_in.sz);
+
+        header_ptr = (RcStatsHeader_t*)stats_copy;
+        encode_context_ptr->rc_stats_in = (RcStatsEntry_t*)(header_ptr + 1);
+        encode_context_ptr->rc_stats_in_count = header_ptr->frame_count;
+    }
+
+    return EB_ErrorNone;
+}
+
+/************************************************
+ * Record the stats of one picture
+ *  Called by the Initial Rate Control process
+ *  once the ME and OIS histograms are final
+ ************************************************/
+void RcStatsRecord(
+    EncodeContext_t                 *encode_context_ptr,
+    PictureParentControlSet_t       *picture_control_set_ptr)
+{
+    RcStatsHeader_t *header_ptr = (RcStatsHeader_t*)encode_context_ptr->rc_stats_out;
+    RcStatsEntry_t  *entry_ptr;
+    uint64_t         max_frame_count = (encode_context_ptr->rc_stats_out_size - sizeof(RcStatsHeader_t)) / sizeof(RcStatsEntry_t);
+
+    if (picture_control_set_ptr->picture_number >= max_frame_count)
+        return;
+
+    entry_ptr = (RcStatsEntry_t*)(header_ptr + 1) + picture_control_set_ptr->picture_number;
+    entry_ptr->picture_number = picture_control_set_ptr->picture_number;
+    entry_ptr->full_sb_count = picture_control_set_ptr->full_sb_count;
+    entry_ptr->slice_type = (uint8_t)picture_control_set_ptr->slice_type;
+    entry_ptr->temporal_layer_index = picture_control_set_ptr->temporal_layer_index;
+    entry_ptr->scene_change_flag = (uint8_t)picture_control_set_ptr->scene_change_flag;
+    EB_MEMCPY(entry_ptr->me_distortion_histogram, picture_control_set_ptr->me_distortion_histogram, sizeof(uint16_t) * NUMBER_OF_SAD_INTERVALS);
+    EB_MEMCPY(entry_ptr->ois_distortion_histogram, picture_control_set_ptr->ois_distortion_histogram, sizeof(uint16_t) * NUMBER_OF_INTRA_SAD_INTERVALS);
+
+    header_ptr->frame_count = MAX(header_ptr->frame_count, picture_control_set_ptr->picture_number + 1);
+}
@@ -0,0 +1,56 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#ifndef EbRateControlStats_h
+#define EbRateControlStats_h
+
+#include "EbDefinitions.h"
+#include "EbSvtAv1Enc.h"
+#include "EbRateControlTables.h"
+
+#define RC_STATS_MAGIC      0x53545653 // "SVTS"
+#define RC_STATS_VERSION    2
+
+/************************************************
+ * Analysis Pass Stats File
+ *
+ * A header followed by one entry per picture in
+ * display order, written in the host byte order.
+ ************************************************/
+typedef struct RcStatsHeader_s {
+    uint32_t                          magic;
+    uint32_t                          version;
+    uint32_t                          width;
+    uint32_t                          height;
+    int32_t                           intra_period_length;
+    uint32_t                          hierarchical_levels;
+    uint64_t                          frame_count;
+} RcStatsHeader_t;
+
+typedef struct RcStatsEntry_s {
+    uint64_t                          picture_number;
+    uint32_t                          full_sb_count;
+    uint8_t                           slice_type;
+    uint8_t                           temporal_layer_index;
+    uint8_t                           scene_change_flag;
+    uint8_t                           reserved;
+    // Motion Estimation Distortion and OIS Historgram
+    uint16_t                          me_distortion_histogram[NUMBER_OF_SAD_INTERVALS];
+    uint16_t                          ois_distortion_histogram[NUMBER_OF_INTRA_SAD_INTERVALS];
+} RcStatsEntry_t;
+
+struct EncodeContext_s;
+struct SequenceControlSet;
+struct PictureParentControlSet_s;
+
+extern EbErrorType RcStatsCtor(
+    struct EncodeContext_s              *encode_context_ptr,
+    struct SequenceControlSet         *sequence_control_set_ptr);
+
+extern void RcStatsRecord(
+    struct EncodeContext_s              *encode_context_ptr,
+    struct PictureParentControlSet_s    *picture_control_set_ptr);
+
+#endif //EbRateControlStats_h
@@ -365,11 +365,10 @@ const int8_t av1_nz_map_ctx_offset[TX_SIZES_ALL][5][5] = {
 
 static INLINE int32_t get_br_ctx(const uint8_t *const levels,
     const int32_t c,  // raster order
-    const int32_t bwl, const TxType tx_type) {
+    const int32_t bwl, const TX_CLASS tx_class) {
     const int32_t row = c >> bwl;
     const int32_t col = c - (row << bwl);
     const int32_t stride = (1 << bwl) + TX_PAD_HOR;
-    const TX_CLASS tx_class = tx_type_to_class[tx_type];
     const int32_t pos = row * stride + col;
     int32_t mag = levels[pos + 1];
     mag += levels[pos + stride];
@@ -398,6 +397,67 @@ static INLINE int32_t get_br_ctx(const uint8_t *const levels,
     return mag + 14;
 }
 
+// Base, sign and range cost of the coefficients of a transform block, in
+// reverse scan order. levels and coeff_contexts come from
+// av1_txb_init_levels() and av1_get_nz_map_contexts().
+int32_t av1_cost_coeffs_levels_c(
+    const tran_low_t                        *const qcoeff,
+    const uint8_t                           *const levels,
+    const int16_t                           *const scan,
+    const int8_t                            *const coeff_contexts,
+    const uint16_t                           eob,
+    const int32_t                            bwl,
+    const TX_CLASS                           tx_class,
+    const int16_t                            dc_sign_ctx,
+    const LV_MAP_COEFF_COST                 *const coeff_costs)
+{
+    int32_t c, cost = 0;
+
+    for (c = eob - 1; c >= 0; --c) {
+
+        const int32_t pos = scan[c];
+        const tran_low_t v = qcoeff[pos];
+        const int32_t is_nz = (v != 0);
+        const int32_t level = abs(v);
+        const int32_t coeff_ctx = coeff_contexts[pos];
+
+        if (c == eob - 1) {
+            ASSERT((AOMMIN(level, 3) - 1) >= 0);
+            cost += coeff_costs->base_eob_cost[coeff_ctx][AOMMIN(level, 3) - 1];
+        }
+        else {
+            cost += coeff_costs->base_cost[coeff_ctx][AOMMIN(level, 3)];
+        }
+        if (is_nz) {
+            const int32_t sign = (v < 0) ? 1 : 0;
+            // sign bit cost
+            if (c == 0) {
+                cost += coeff_costs->dc_sign_cost[dc_sign_ctx][sign];
+            }
+            else {
+                cost += av1_cost_literal(1);
+            }
+            if (level > NUM_BASE_LEVELS) {
+                int32_t ctx;
+                ctx = get_br_ctx(levels, pos, bwl, tx_class);
+
+                const int32_t base_range = level - 1 - NUM_BASE_LEVELS;
+                if (base_range < COEFF_BASE_RANGE) {
+                    cost += coeff_costs->lps_cost[ctx][base_range];
+                }
+                else {
+                    cost += coeff_costs->lps_cost[ctx][COEFF_BASE_RANGE];
+                }
+
+                if (level >= 1 + NUM_BASE_LEVELS + COEFF_BASE_RANGE) {
+                    cost += get_golomb_cost(level);
+                }
+            }
+        }
+    }
+    return cost;
+}
+
 static INLINE int32_t av1_cost_skip_txb(
     struct ModeDecisionCandidateBuffer_s    *candidate_buffer_ptr,
     TxSize                                  transform_size,
@@ -429,7 +489,7 @@ uint64_t av1_cost_coeffs_txb(
     const TxSize txs_ctx = (TxSize)((txsize_sqr_map[transform_size] + txsize_sqr_up_map[transform_size] + 1) >> 1);
     const TxType transform_type = candidate_buffer_ptr->candidate_ptr->transform_type[plane_type];
     const TX_CLASS tx_class = tx_type_to_class[transform_type];
-    int32_t c, cost;
+    int32_t cost;
     const int32_t bwl = get_txb_bwl(transform_size);
     const int32_t width = get_txb_wide(transform_size);
     const int32_t height = get_txb_high(transform_size);
@@ -473,48 +533,17 @@ uint64_t av1_cost_coeffs_txb(
         tx_class,
         coeff_contexts); // NM - Assembly version is available in AOM
 
-    for (c = eob - 1; c >= 0; --c) {
-
-        const int32_t pos = scan[c];
-        const tran_low_t v = qcoeff[pos];
-        const int32_t is_nz = (v != 0);
-        const int32_t level = abs(v);
-        const int32_t coeff_ctx = coeff_contexts[pos];
-
-        if (c == eob - 1) {
-            ASSERT((AOMMIN(level, 3) - 1) >= 0);
-            cost += coeff_costs->base_eob_cost[coeff_ctx][AOMMIN(level, 3) - 1];
-        }
-        else {
-            cost += coeff_costs->base_cost[coeff_ctx][AOMMIN(level, 3)];
-        }
-        if (is_nz) {
-            const int32_t sign = (v < 0) ? 1 : 0;
-            // sign bit cost
-            if (c == 0) {
-                cost += coeff_costs->dc_sign_cost[dc_sign_ctx][sign];
-            }
-            else {
-                cost += av1_cost_literal(1);
-            }
-            if (level > NUM_BASE_LEVELS) {
-                int32_t ctx;
-                ctx = get_br_ctx(levels, pos, bwl, transform_type);
-
-                const int32_t base_range = level - 1 - NUM_BASE_LEVELS;
-                if (base_range < COEFF_BASE_RANGE) {
-                    cost += coeff_costs->lps_cost[ctx][base_range];
-                }
-                else {
-                    cost += coeff_costs->lps_cost[ctx][COEFF_BASE_RANGE];
-                }
+    cost += av1_cost_coeffs_levels(
+        qcoeff,
+        levels,
+        scan,
+        coeff_contexts,
+        eob,
+        bwl,
+        tx_class,
+        dc_sign_ctx,
+        coeff_costs);
 
-                if (level >= 1 + NUM_BASE_LEVELS + COEFF_BASE_RANGE) {
-                    cost += get_golomb_cost(level);
-                }
-            }
-        }
-    }
     return cost;
 }
 /*static*/ void model_rd_from_sse(
@@ -560,6 +560,12 @@ void* resource_coordination_kernel(void *input_ptr)
         // *Note - Assumes 4:2:0 planar
         input_picture_wrapper_ptr = ebInputWrapperPtr;
         picture_control_set_ptr->enhanced_picture_ptr = (EbPictureBufferDesc_t*)ebInputPtr->p_buffer;
+        // The 16 bit input is kept for the mode decision and the encode pass, the picture analysis
+        // derives the 8 bit picture everything before works on
+        if (sequence_control_set_ptr->static_config.native_16bit_pipeline) {
+            picture_control_set_ptr->native_input_picture_ptr = picture_control_set_ptr->enhanced_picture_ptr;
+            picture_control_set_ptr->enhanced_picture_ptr = picture_control_set_ptr->input_msb_picture_ptr;
+        }
         picture_control_set_ptr->input_ptr            = ebInputPtr;
         end_of_sequence_flag = (picture_control_set_ptr->input_ptr->flags & EB_BUFFERFLAG_EOS) ? EB_TRUE : EB_FALSE;
         EbStartTime(&picture_control_set_ptr->start_time_seconds, &picture_control_set_ptr->start_time_u_seconds);
@@ -587,6 +593,20 @@ void* resource_coordination_kernel(void *input_ptr)
             picture_control_set_ptr->enc_mode = (EbEncMode)sequence_control_set_ptr->static_config.enc_mode;
         }
 
+        // Sample the Deadline Control speed levels (updated by the Packetization process)
+        picture_control_set_ptr->dl_me_time = 0;
+        picture_control_set_ptr->dl_md_time = 0;
+        if (sequence_control_set_ptr->static_config.deadline_mode) {
+            eb_block_on_mutex(sequence_control_set_ptr->encode_context_ptr->sc_buffer_mutex);
+            picture_control_set_ptr->dl_me_level = sequence_control_set_ptr->encode_context_ptr->dl_me_level;
+            picture_control_set_ptr->dl_md_level = sequence_control_set_ptr->encode_context_ptr->dl_md_level;
+            eb_release_mutex(sequence_control_set_ptr->encode_context_ptr->sc_buffer_mutex);
+        }
+        else {
+            picture_control_set_ptr->dl_me_level = 0;
+            picture_control_set_ptr->dl_md_level = 0;
+        }
+
         aspectRatio = (sequence_control_set_ptr->luma_width * 10) / sequence_control_set_ptr->luma_height;
         aspectRatio = (aspectRatio <= ASPECT_RATIO_4_3) ? ASPECT_RATIO_CLASS_0 : (aspectRatio <= ASPECT_RATIO_16_9) ? ASPECT_RATIO_CLASS_1 : ASPECT_RATIO_CLASS_2;
 
@@ -605,7 +625,7 @@ void* resource_coordination_kernel(void *input_ptr)
     
         // Rate Control
         // Set the ME Distortion and OIS Historgrams to zero
-        if (sequence_control_set_ptr->static_config.rate_control_mode) {
+        if (sequence_control_set_ptr->static_config.rate_control_mode || sequence_control_set_ptr->static_config.rc_firstpass_stats_out) {
             EB_MEMSET(picture_control_set_ptr->me_distortion_histogram, 0, NUMBER_OF_SAD_INTERVALS * sizeof(uint16_t));
             EB_MEMSET(picture_control_set_ptr->ois_distortion_histogram, 0, NUMBER_OF_INTRA_SAD_INTERVALS * sizeof(uint16_t));
         }
@@ -648,18 +668,37 @@ void* resource_coordination_kernel(void *input_ptr)
             2);
     
         ((EbPaReferenceObject*)picture_control_set_ptr->pa_reference_picture_wrapper_ptr->object_ptr)->input_padded_picture_ptr->buffer_y = picture_control_set_ptr->enhanced_picture_ptr->buffer_y;
+        // 422/444 inputs are converted to 420 in the picture analysis, the luma is shared
+        if (picture_control_set_ptr->enhanced_picture_ptr->color_format >= EB_YUV422)
+            picture_control_set_ptr->chroma_downsampled_picture_ptr->buffer_y = picture_control_set_ptr->enhanced_picture_ptr->buffer_y;
+        else
+            picture_control_set_ptr->chroma_downsampled_picture_ptr = picture_control_set_ptr->enhanced_picture_ptr;
+
+        // Picture analysis segments
+        picture_control_set_ptr->pa_segments_total_count = (uint16_t)MIN(
+            sequence_control_set_ptr->pa_segment_row_count,
+            (uint32_t)((sequence_control_set_ptr->luma_height + sequence_control_set_ptr->sb_sz - 1) / sequence_control_set_ptr->sb_sz));
+        picture_control_set_ptr->pa_segments_completion_count = 0;
+
         // Get Empty Output Results Object
         if (picture_control_set_ptr->picture_number > 0 && (prevPictureControlSetWrapperPtr != NULL))
         {
-            ((PictureParentControlSet_t       *)prevPictureControlSetWrapperPtr->object_ptr)->end_of_sequence_flag = end_of_sequence_flag;
-            eb_get_empty_object(
-                context_ptr->resource_coordination_results_output_fifo_ptr,
-                &outputWrapperPtr);
-            outputResultsPtr = (ResourceCoordinationResults*)outputWrapperPtr->object_ptr;
-            outputResultsPtr->picture_control_set_wrapper_ptr = prevPictureControlSetWrapperPtr;
+            PictureParentControlSet_t *prev_picture_control_set_ptr = (PictureParentControlSet_t*)prevPictureControlSetWrapperPtr->object_ptr;
+            uint32_t                   segment_index;
+
+            prev_picture_control_set_ptr->end_of_sequence_flag = end_of_sequence_flag;
 
-            // Post the finished Results Object
-            eb_post_full_object(outputWrapperPtr);
+            for (segment_index = 0; segment_index < prev_picture_control_set_ptr->pa_segments_total_count; ++segment_index) {
+                eb_get_empty_object(
+                    context_ptr->resource_coordination_results_output_fifo_ptr,
+                    &outputWrapperPtr);
+                outputResultsPtr = (ResourceCoordinationResults*)outputWrapperPtr->object_ptr;
+                outputResultsPtr->picture_control_set_wrapper_ptr = prevPictureControlSetWrapperPtr;
+                outputResultsPtr->segment_index = segment_index;
+
+                // Post the finished Results Object
+                eb_post_full_object(outputWrapperPtr);
+            }
         }
         prevPictureControlSetWrapperPtr = picture_control_set_wrapper_ptr;
     }
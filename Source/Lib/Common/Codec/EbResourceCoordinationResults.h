@@ -16,6 +16,7 @@ extern "C" {
      **************************************/
     typedef struct ResourceCoordinationResults {
         EbObjectWrapper *picture_control_set_wrapper_ptr;
+        uint32_t         segment_index;
     } ResourceCoordinationResults;
 
     typedef struct ResourceCoordinationResultInitData {
@@ -26,15 +26,13 @@
 
 void ReconOutput(
     PictureControlSet_t    *picture_control_set_ptr,
+    EbObjectWrapper        *picture_control_set_wrapper_ptr,
     SequenceControlSet   *sequence_control_set_ptr);
 void av1_loop_restoration_filter_frame(Yv12BufferConfig *frame,
     Av1Common *cm, int32_t optimized_lr);
 void CopyStatisticsToRefObject(
     PictureControlSet_t    *picture_control_set_ptr,
     SequenceControlSet   *sequence_control_set_ptr);
-void PsnrCalculations(
-    PictureControlSet_t    *picture_control_set_ptr,
-    SequenceControlSet   *sequence_control_set_ptr);
 void PadRefAndSetFlags(
     PictureControlSet_t    *picture_control_set_ptr,
     SequenceControlSet   *sequence_control_set_ptr);
@@ -62,6 +60,7 @@ EbErrorType rest_context_ctor(
     EbFifo                *rest_input_fifo_ptr,
     EbFifo                *rest_output_fifo_ptr ,
     EbFifo                *picture_demux_fifo_ptr,
+    EbFifo                *stat_output_fifo_ptr,
     EbBool                  is16bit,
     EbColorFormat           color_format,
     uint32_t                max_input_luma_width,
@@ -77,6 +76,7 @@ EbErrorType rest_context_ctor(
     context_ptr->rest_input_fifo_ptr = rest_input_fifo_ptr;
     context_ptr->rest_output_fifo_ptr = rest_output_fifo_ptr;
     context_ptr->picture_demux_fifo_ptr = picture_demux_fifo_ptr;
+    context_ptr->stat_output_fifo_ptr = stat_output_fifo_ptr;
 
 
     {
@@ -218,6 +218,8 @@ void* rest_kernel(void *input_ptr)
     RestResults_t*                          rest_results_ptr;
     EbObjectWrapper                       *picture_demux_results_wrapper_ptr;
     PictureDemuxResults_t                   *picture_demux_results_rtr;
+    EbObjectWrapper                       *stat_tasks_wrapper_ptr;
+    StatTasks_t                             *stat_tasks_ptr;
     // SB Loop variables
 
 
@@ -309,12 +311,23 @@ void* rest_kernel(void *input_ptr)
                     sequence_control_set_ptr);
             }
 
-            //// PSNR Calculation
-            //if (sequence_control_set_ptr->static_config.stat_report) {
-            //    PsnrCalculations(
-            //        picture_control_set_ptr,
-            //        sequence_control_set_ptr);
-            //}
+            // Hand the final recon to the Stat process
+            if (sequence_control_set_ptr->static_config.stat_report) {
+                eb_get_empty_object(
+                    context_ptr->stat_output_fifo_ptr,
+                    &stat_tasks_wrapper_ptr);
+                stat_tasks_ptr = (StatTasks_t*)stat_tasks_wrapper_ptr->object_ptr;
+                stat_tasks_ptr->picture_control_set_wrapper_ptr = cdef_results_ptr->picture_control_set_wrapper_ptr;
+                stat_tasks_ptr->reference_picture_wrapper_ptr = (EbObjectWrapper*)EB_NULL;
+                if (picture_control_set_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE) {
+                    // Keep the reference alive should Picture Manager drop it first
+                    stat_tasks_ptr->reference_picture_wrapper_ptr = picture_control_set_ptr->parent_pcs_ptr->reference_picture_wrapper_ptr;
+                    eb_object_inc_live_count(
+                        stat_tasks_ptr->reference_picture_wrapper_ptr,
+                        1);
+                }
+                eb_post_full_object(stat_tasks_wrapper_ptr);
+            }
 
             // Pad the reference picture and set up TMVP flag and ref POC
             if (picture_control_set_ptr->parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE)
@@ -382,6 +395,7 @@ void* rest_kernel(void *input_ptr)
             if (sequence_control_set_ptr->static_config.recon_enabled) {
                 ReconOutput(
                     picture_control_set_ptr,
+                    cdef_results_ptr->picture_control_set_wrapper_ptr,
                     sequence_control_set_ptr);
             }
 
@@ -767,35 +767,19 @@ const int32_t one_by_x[MAX_NELEM] = {
   293,  273,  256,  241,  228, 216, 205, 195, 186, 178, 171, 164,
 };
 
-static void selfguided_restoration_fast_internal(
-    int32_t *dgd, int32_t width, int32_t height, int32_t dgd_stride, int32_t *dst,
-    int32_t dst_stride, int32_t bit_depth, int32_t sgr_params_idx, int32_t radius_idx)
+// Turn the radius-r box sums in A[] (squared pixels) and B[] (pixels) into
+// the filter output, evaluating A[] and B[] on every other row only. A and B
+// point at logical position (0, 0) and must hold a 1-pixel border around the
+// width x height block.
+static void selfguided_filter_fast_from_boxsum(int32_t *A, int32_t *B, int32_t buf_stride,
+    const int32_t *dgd, int32_t dgd_stride, int32_t width, int32_t height,
+    int32_t *dst, int32_t dst_stride, int32_t bit_depth,
+    int32_t sgr_params_idx, int32_t radius_idx)
 {
     const sgr_params_type *const params = &sgr_params[sgr_params_idx];
     const int32_t r = params->r[radius_idx];
-    const int32_t width_ext = width + 2 * SGRPROJ_BORDER_HORZ;
-    const int32_t height_ext = height + 2 * SGRPROJ_BORDER_VERT;
-    // Adjusting the stride of A and B here appears to avoid bad cache effects,
-    // leading to a significant speed improvement.
-    // We also align the stride to a multiple of 16 bytes, for consistency
-    // with the SIMD version of this function.
-    int32_t buf_stride = ((width_ext + 3) & ~3) + 16;
-    int32_t A_[RESTORATION_PROC_UNIT_PELS];
-    int32_t B_[RESTORATION_PROC_UNIT_PELS];
-    int32_t *A = A_;
-    int32_t *B = B_;
     int32_t i, j;
 
-    assert(r <= MAX_RADIUS && "Need MAX_RADIUS >= r");
-    assert(r <= SGRPROJ_BORDER_VERT - 1 && r <= SGRPROJ_BORDER_HORZ - 1 &&
-        "Need SGRPROJ_BORDER_* >= r+1");
-
-    boxsum(dgd - dgd_stride * SGRPROJ_BORDER_VERT - SGRPROJ_BORDER_HORZ,
-        width_ext, height_ext, dgd_stride, r, 0, B, buf_stride);
-    boxsum(dgd - dgd_stride * SGRPROJ_BORDER_VERT - SGRPROJ_BORDER_HORZ,
-        width_ext, height_ext, dgd_stride, r, 1, A, buf_stride);
-    A += SGRPROJ_BORDER_VERT * buf_stride + SGRPROJ_BORDER_HORZ;
-    B += SGRPROJ_BORDER_VERT * buf_stride + SGRPROJ_BORDER_HORZ;
     // Calculate the eventual A[] and B[] arrays. Include a 1-pixel border - ie,
     // for a 64x64 processing unit, we calculate 66x66 pixels of A[] and B[].
     for (i = -1; i < height + 1; i += 2) {
@@ -899,11 +883,10 @@ static void selfguided_restoration_fast_internal(
     }
 }
 
-static void selfguided_restoration_internal(int32_t *dgd, int32_t width, int32_t height,
-    int32_t dgd_stride, int32_t *dst,
-    int32_t dst_stride, int32_t bit_depth,
-    int32_t sgr_params_idx,
-    int32_t radius_idx) {
+static void selfguided_restoration_fast_internal(
+    int32_t *dgd, int32_t width, int32_t height, int32_t dgd_stride, int32_t *dst,
+    int32_t dst_stride, int32_t bit_depth, int32_t sgr_params_idx, int32_t radius_idx)
+{
     const sgr_params_type *const params = &sgr_params[sgr_params_idx];
     const int32_t r = params->r[radius_idx];
     const int32_t width_ext = width + 2 * SGRPROJ_BORDER_HORZ;
@@ -917,7 +900,6 @@ static void selfguided_restoration_internal(int32_t *dgd, int32_t width, int32_t
     int32_t B_[RESTORATION_PROC_UNIT_PELS];
     int32_t *A = A_;
     int32_t *B = B_;
-    int32_t i, j;
 
     assert(r <= MAX_RADIUS && "Need MAX_RADIUS >= r");
     assert(r <= SGRPROJ_BORDER_VERT - 1 && r <= SGRPROJ_BORDER_HORZ - 1 &&
@@ -929,6 +911,22 @@ static void selfguided_restoration_internal(int32_t *dgd, int32_t width, int32_t
         width_ext, height_ext, dgd_stride, r, 1, A, buf_stride);
     A += SGRPROJ_BORDER_VERT * buf_stride + SGRPROJ_BORDER_HORZ;
     B += SGRPROJ_BORDER_VERT * buf_stride + SGRPROJ_BORDER_HORZ;
+    selfguided_filter_fast_from_boxsum(A, B, buf_stride, dgd, dgd_stride, width, height, dst,
+        dst_stride, bit_depth, sgr_params_idx, radius_idx);
+}
+
+// Turn the radius-r box sums in A[] (squared pixels) and B[] (pixels) into
+// the filter output. A and B point at logical position (0, 0) and must hold
+// a 1-pixel border around the width x height block.
+static void selfguided_filter_from_boxsum(int32_t *A, int32_t *B, int32_t buf_stride,
+    const int32_t *dgd, int32_t dgd_stride, int32_t width, int32_t height,
+    int32_t *dst, int32_t dst_stride, int32_t bit_depth,
+    int32_t sgr_params_idx, int32_t radius_idx)
+{
+    const sgr_params_type *const params = &sgr_params[sgr_params_idx];
+    const int32_t r = params->r[radius_idx];
+    int32_t i, j;
+
     // Calculate the eventual A[] and B[] arrays. Include a 1-pixel border - ie,
     // for a 64x64 processing unit, we calculate 66x66 pixels of A[] and B[].
     for (i = -1; i < height + 1; ++i) {
@@ -1019,6 +1017,39 @@ static void selfguided_restoration_internal(int32_t *dgd, int32_t width, int32_t
     }
 }
 
+static void selfguided_restoration_internal(int32_t *dgd, int32_t width, int32_t height,
+    int32_t dgd_stride, int32_t *dst,
+    int32_t dst_stride, int32_t bit_depth,
+    int32_t sgr_params_idx,
+    int32_t radius_idx) {
+    const sgr_params_type *const params = &sgr_params[sgr_params_idx];
+    const int32_t r = params->r[radius_idx];
+    const int32_t width_ext = width + 2 * SGRPROJ_BORDER_HORZ;
+    const int32_t height_ext = height + 2 * SGRPROJ_BORDER_VERT;
+    // Adjusting the stride of A and B here appears to avoid bad cache effects,
+    // leading to a significant speed improvement.
+    // We also align the stride to a multiple of 16 bytes, for consistency
+    // with the SIMD version of this function.
+    int32_t buf_stride = ((width_ext + 3) & ~3) + 16;
+    int32_t A_[RESTORATION_PROC_UNIT_PELS];
+    int32_t B_[RESTORATION_PROC_UNIT_PELS];
+    int32_t *A = A_;
+    int32_t *B = B_;
+
+    assert(r <= MAX_RADIUS && "Need MAX_RADIUS >= r");
+    assert(r <= SGRPROJ_BORDER_VERT - 1 && r <= SGRPROJ_BORDER_HORZ - 1 &&
+        "Need SGRPROJ_BORDER_* >= r+1");
+
+    boxsum(dgd - dgd_stride * SGRPROJ_BORDER_VERT - SGRPROJ_BORDER_HORZ,
+        width_ext, height_ext, dgd_stride, r, 0, B, buf_stride);
+    boxsum(dgd - dgd_stride * SGRPROJ_BORDER_VERT - SGRPROJ_BORDER_HORZ,
+        width_ext, height_ext, dgd_stride, r, 1, A, buf_stride);
+    A += SGRPROJ_BORDER_VERT * buf_stride + SGRPROJ_BORDER_HORZ;
+    B += SGRPROJ_BORDER_VERT * buf_stride + SGRPROJ_BORDER_HORZ;
+    selfguided_filter_from_boxsum(A, B, buf_stride, dgd, dgd_stride, width, height, dst,
+        dst_stride, bit_depth, sgr_params_idx, radius_idx);
+}
+
 void av1_selfguided_restoration_c(const uint8_t *dgd8, int32_t width, int32_t height,
     int32_t dgd_stride, int32_t *flt0, int32_t *flt1,
     int32_t flt_stride, int32_t sgr_params_idx,
@@ -1059,6 +1090,86 @@ void av1_selfguided_restoration_c(const uint8_t *dgd8, int32_t width, int32_t he
             flt_stride, bit_depth, sgr_params_idx, 1);
 }
 
+// Build the integral images of the width x height unit at dgd8 extended by
+// the SGRPROJ border. ii_sum and ii_sq point at the zero top-left corner of
+// each image. Sums are accumulated modulo 2^32, which keeps every box sum
+// taken from them exact.
+void av1_selfguided_integral_images_c(const uint8_t *dgd8, int32_t width, int32_t height,
+    int32_t dgd_stride, int32_t *ii_sum, int32_t *ii_sq, int32_t ii_stride, int32_t highbd) {
+    const int32_t width_ext = width + 2 * SGRPROJ_BORDER_HORZ;
+    const int32_t height_ext = height + 2 * SGRPROJ_BORDER_VERT;
+    const int32_t dgd_diag_border =
+        SGRPROJ_BORDER_HORZ + dgd_stride * SGRPROJ_BORDER_VERT;
+    const uint16_t *dgd16 = highbd ? CONVERT_TO_SHORTPTR(dgd8) - dgd_diag_border : NULL;
+    const uint8_t *dgd0 = dgd8 - dgd_diag_border;
+
+    memset(ii_sum, 0, (width_ext + 1) * sizeof(*ii_sum));
+    memset(ii_sq, 0, (width_ext + 1) * sizeof(*ii_sq));
+    for (int32_t i = 0; i < height_ext; ++i) {
+        uint32_t *sum = (uint32_t *)ii_sum + (i + 1) * ii_stride;
+        uint32_t *sq = (uint32_t *)ii_sq + (i + 1) * ii_stride;
+        uint32_t row_sum = 0, row_sq = 0;
+        sum[0] = sq[0] = 0;
+        for (int32_t j = 0; j < width_ext; ++j) {
+            const uint32_t x = highbd ? dgd16[i * dgd_stride + j] : dgd0[i * dgd_stride + j];
+            row_sum += x;
+            row_sq += x * x;
+            sum[j + 1] = sum[j + 1 - ii_stride] + row_sum;
+            sq[j + 1] = sq[j + 1 - ii_stride] + row_sq;
+        }
+    }
+}
+
+// Same output as av1_selfguided_restoration_c, but the box sums are taken from
+// integral images built by av1_selfguided_integral_images. ii_sum and ii_sq
+// point at the entries for logical position (0, 0) of this block.
+void av1_selfguided_restoration_from_ii_c(const uint8_t *dgd8, int32_t width, int32_t height,
+    int32_t dgd_stride, const int32_t *ii_sum, const int32_t *ii_sq, int32_t ii_stride,
+    int32_t *flt0, int32_t *flt1, int32_t flt_stride,
+    int32_t sgr_params_idx, int32_t bit_depth, int32_t highbd) {
+    int32_t dgd32[RESTORATION_PROC_UNIT_SIZE * RESTORATION_PROC_UNIT_SIZE];
+    int32_t A_[RESTORATION_PROC_UNIT_PELS];
+    int32_t B_[RESTORATION_PROC_UNIT_PELS];
+    const int32_t buf_stride = ((width + 2 * SGRPROJ_BORDER_HORZ + 3) & ~3) + 16;
+    int32_t *A = A_ + SGRPROJ_BORDER_VERT * buf_stride + SGRPROJ_BORDER_HORZ;
+    int32_t *B = B_ + SGRPROJ_BORDER_VERT * buf_stride + SGRPROJ_BORDER_HORZ;
+    const sgr_params_type *const params = &sgr_params[sgr_params_idx];
+
+    assert(width <= RESTORATION_PROC_UNIT_SIZE && height <= RESTORATION_PROC_UNIT_SIZE);
+    assert(!(params->r[0] == 0 && params->r[1] == 0));
+
+    for (int32_t i = 0; i < height; ++i) {
+        for (int32_t j = 0; j < width; ++j) {
+            dgd32[i * width + j] = highbd ?
+                CONVERT_TO_SHORTPTR(dgd8)[i * dgd_stride + j] : dgd8[i * dgd_stride + j];
+        }
+    }
+
+    for (int32_t radius_idx = 0; radius_idx < 2; ++radius_idx) {
+        const int32_t r = params->r[radius_idx];
+        if (r == 0) continue;
+        for (int32_t i = -1; i < height + 1; ++i) {
+            for (int32_t j = -1; j < width + 1; ++j) {
+                const int32_t tl = (i - r - 1) * ii_stride + j - r - 1;
+                const int32_t tr = (i - r - 1) * ii_stride + j + r;
+                const int32_t bl = (i + r) * ii_stride + j - r - 1;
+                const int32_t br = (i + r) * ii_stride + j + r;
+                const int32_t k = i * buf_stride + j;
+                B[k] = (int32_t)((uint32_t)ii_sum[br] - (uint32_t)ii_sum[bl] -
+                    (uint32_t)ii_sum[tr] + (uint32_t)ii_sum[tl]);
+                A[k] = (int32_t)((uint32_t)ii_sq[br] - (uint32_t)ii_sq[bl] -
+                    (uint32_t)ii_sq[tr] + (uint32_t)ii_sq[tl]);
+            }
+        }
+        if (radius_idx == 0)
+            selfguided_filter_fast_from_boxsum(A, B, buf_stride, dgd32, width, width, height,
+                flt0, flt_stride, bit_depth, sgr_params_idx, 0);
+        else
+            selfguided_filter_from_boxsum(A, B, buf_stride, dgd32, width, width, height,
+                flt1, flt_stride, bit_depth, sgr_params_idx, 1);
+    }
+}
+
 void apply_selfguided_restoration_c(const uint8_t *dat8, int32_t width, int32_t height,
     int32_t stride, int32_t eps, const int32_t *xqd,
     uint8_t *dst8, int32_t dst_stride,
@@ -92,6 +92,17 @@ extern "C" {
 // on the decoder side.
 #define SGRPROJ_TMPBUF_SIZE (RESTORATION_UNITPELS_MAX * 2 * sizeof(int32_t))
 
+// The self-guided search also keeps the integral images (sums and sums of
+// squares) of the whole restoration unit and its SGRPROJ border, so they are
+// built once per unit rather than once per sgr_params set. Each plane starts
+// with a zero row and column; ii_stride is a multiple of 8 and column 1 of each
+// plane is 32-byte aligned for the AVX2 kernels.
+#define SGRPROJ_II_STRIDE ALIGN_POWER_OF_TWO(RESTORATION_UNITPELS_HORZ_MAX, 3)
+#define SGRPROJ_II_PELS \
+  (SGRPROJ_II_STRIDE * (RESTORATION_UNITPELS_VERT_MAX + 2) + 8)
+#define SGRPROJ_SEARCH_TMPBUF_SIZE \
+  (SGRPROJ_TMPBUF_SIZE + SGRPROJ_II_PELS * 2 * sizeof(int32_t) + 32)
+
 #define SGRPROJ_EXTBUF_SIZE (0)
 #define SGRPROJ_PARAMS_BITS 4
 #define SGRPROJ_PARAMS (1 << SGRPROJ_PARAMS_BITS)
@@ -166,8 +177,8 @@ extern "C" {
 #define WIENER_FILT_TAP1_SUBEXP_K 2
 #define WIENER_FILT_TAP2_SUBEXP_K 3
 
-// Max of SGRPROJ_TMPBUF_SIZE, DOMAINTXFMRF_TMPBUF_SIZE, WIENER_TMPBUF_SIZE
-#define RESTORATION_TMPBUF_SIZE (SGRPROJ_TMPBUF_SIZE)
+// Max of SGRPROJ_SEARCH_TMPBUF_SIZE, DOMAINTXFMRF_TMPBUF_SIZE, WIENER_TMPBUF_SIZE
+#define RESTORATION_TMPBUF_SIZE (SGRPROJ_SEARCH_TMPBUF_SIZE)
 
 // Max of SGRPROJ_EXTBUF_SIZE, WIENER_EXTBUF_SIZE
 #define RESTORATION_EXTBUF_SIZE (WIENER_EXTBUF_SIZE)
@@ -576,11 +576,13 @@ void encode_xq(int32_t *xq, int32_t *xqd, const sgr_params_type *params) {
     }
 }
 
-// Apply the self-guided filter across an entire restoration unit.
+// Apply the self-guided filter across an entire restoration unit. ii_sum and
+// ii_sq are the integral images of the unit, at logical position (0, 0); they
+// do not depend on sgr_params_idx and are shared by every set tried.
 static void apply_sgr(int32_t sgr_params_idx, const uint8_t *dat8, int32_t width,
     int32_t height, int32_t dat_stride, int32_t use_highbd, int32_t bit_depth,
     int32_t pu_width, int32_t pu_height, int32_t *flt0, int32_t *flt1,
-    int32_t flt_stride)
+    int32_t flt_stride, const int32_t *ii_sum, const int32_t *ii_sq)
 {
 
     for (int32_t i = 0; i < height; i += pu_height)
@@ -589,14 +591,16 @@ static void apply_sgr(int32_t sgr_params_idx, const uint8_t *dat8, int32_t width
         int32_t *flt0_row = flt0 + i * flt_stride;
         int32_t *flt1_row = flt1 + i * flt_stride;
         const uint8_t *dat8_row = dat8 + i * dat_stride;
+        const int32_t *ii_sum_row = ii_sum + i * SGRPROJ_II_STRIDE;
+        const int32_t *ii_sq_row = ii_sq + i * SGRPROJ_II_STRIDE;
 
         // Iterate over the stripe in blocks of width pu_width
         for (int32_t j = 0; j < width; j += pu_width) {
             const int32_t w = AOMMIN(pu_width, width - j);
 
-            //CHKN SSE
-            av1_selfguided_restoration(dat8_row + j, w, h, dat_stride, flt0_row + j,
-                flt1_row + j, flt_stride, sgr_params_idx,
+            av1_selfguided_restoration_from_ii(dat8_row + j, w, h, dat_stride,
+                ii_sum_row + j, ii_sq_row + j, SGRPROJ_II_STRIDE,
+                flt0_row + j, flt1_row + j, flt_stride, sgr_params_idx,
                 bit_depth, use_highbd);
         }
     }
@@ -614,6 +618,12 @@ static SgrprojInfo search_selfguided_restoration(
 {
     int32_t *flt0 = rstbuf;
     int32_t *flt1 = flt0 + RESTORATION_UNITPELS_MAX;
+    // Column 1 of each integral image is 32-byte aligned.
+    int32_t *ii_sum_tl = (int32_t *)(((uintptr_t)(flt1 + RESTORATION_UNITPELS_MAX) + 31) &
+        ~(uintptr_t)31) + 7;
+    int32_t *ii_sq_tl = ii_sum_tl + SGRPROJ_II_PELS;
+    const int32_t ii_diag_border =
+        (SGRPROJ_BORDER_VERT + 1) * SGRPROJ_II_STRIDE + SGRPROJ_BORDER_HORZ + 1;
     int32_t ep, bestep = 0;
     int64_t besterr = -1;
     int32_t exqd[2], bestxqd[2] = { 0, 0 };
@@ -630,10 +640,16 @@ static SgrprojInfo search_selfguided_restoration(
     int8_t start_ep = sg_ref_frame_ep[0] < 0 && sg_ref_frame_ep[1] < 0 ? 0 : AOMMAX(0, mid_ep - step);
     int8_t end_ep = sg_ref_frame_ep[0] < 0 && sg_ref_frame_ep[1] < 0 ? SGRPROJ_PARAMS : AOMMIN(SGRPROJ_PARAMS, mid_ep + step);
 
+    assert(width + 2 * SGRPROJ_BORDER_HORZ + 16 <= SGRPROJ_II_STRIDE);
+    assert(height + 2 * SGRPROJ_BORDER_VERT <= RESTORATION_UNITPELS_VERT_MAX);
+    av1_selfguided_integral_images(dat8, width, height, dat_stride, ii_sum_tl,
+        ii_sq_tl, SGRPROJ_II_STRIDE, use_highbitdepth);
+
     for (ep = start_ep; ep < end_ep; ep++) {
         int32_t exq[2];
         apply_sgr(ep, dat8, width, height, dat_stride, use_highbitdepth, bit_depth,
-            pu_width, pu_height, flt0, flt1, flt_stride);
+            pu_width, pu_height, flt0, flt1, flt_stride,
+            ii_sum_tl + ii_diag_border, ii_sq_tl + ii_diag_border);
         aom_clear_system_state();
         const sgr_params_type *const params = &sgr_params[ep];
         get_proj_subspace(src8, width, height, src_stride, dat8, dat_stride,
@@ -197,6 +197,7 @@ EbErrorType eb_sequence_control_set_ctor(
 
     sequence_control_set_ptr->film_grain_params_present = 0;
     sequence_control_set_ptr->film_grain_denoise_strength = 0;
+    sequence_control_set_ptr->film_grain_update_period = 0;
 
     sequence_control_set_ptr->reduced_still_picture_hdr = 0;
     sequence_control_set_ptr->still_picture = 0;
@@ -298,6 +299,7 @@ EbErrorType copy_sequence_control_set(
     dst->enable_tmvp_sps = src->enable_tmvp_sps;                           writeCount += sizeof(uint32_t);
     dst->mv_merge_total_count = src->mv_merge_total_count;                       writeCount += sizeof(uint32_t);
     dst->film_grain_denoise_strength = src->film_grain_denoise_strength;          writeCount += sizeof(int32_t);
+    dst->film_grain_update_period = src->film_grain_update_period;                writeCount += sizeof(uint32_t);
     dst->film_grain_params_present = src->film_grain_params_present;              writeCount += sizeof(int32_t);
     dst->film_grain_params_present = src->film_grain_params_present;              writeCount += sizeof(int32_t);
     dst->picture_control_set_pool_init_count = src->picture_control_set_pool_init_count;            writeCount += sizeof(int32_t);
@@ -324,6 +326,7 @@ EbErrorType copy_sequence_control_set(
     dst->mode_decision_configuration_process_init_count = src->mode_decision_configuration_process_init_count; writeCount += sizeof(int32_t);
     dst->enc_dec_process_init_count = src->enc_dec_process_init_count; writeCount += sizeof(int32_t);
     dst->entropy_coding_process_init_count = src->entropy_coding_process_init_count; writeCount += sizeof(int32_t);
+    dst->worker_pool_process_init_count = src->worker_pool_process_init_count; writeCount += sizeof(int32_t);
     dst->total_process_init_count = src->total_process_init_count; writeCount += sizeof(int32_t);
     dst->left_padding = src->left_padding; writeCount += sizeof(int16_t);
     dst->right_padding = src->right_padding; writeCount += sizeof(int16_t);
@@ -342,6 +345,8 @@ EbErrorType copy_sequence_control_set(
 
     dst->rest_segment_column_count = src->rest_segment_column_count;
     dst->rest_segment_row_count = src->rest_segment_row_count;
+    dst->pa_segment_row_count = src->pa_segment_row_count;
+    dst->sbo_segment_row_count = src->sbo_segment_row_count;
 
 #if BASE_LAYER_REF
     dst->extra_frames_to_ref_islice = src->extra_frames_to_ref_islice;
@@ -372,6 +377,7 @@ EbErrorType eb_sequence_control_set_instance_ctor(
     EbSequenceControlSetInitData scsInitData;
     EbErrorType return_error = EB_ErrorNone;
     EB_MALLOC(EbSequenceControlSetInstance*, *object_dbl_ptr, sizeof(EbSequenceControlSetInstance), EB_N_PTR);
+    (*object_dbl_ptr)->encode_context_ptr = (EncodeContext_t*)EB_NULL;
 
     scsInitData.sb_size = 64;
 
@@ -130,6 +130,8 @@ extern "C" {
 
         uint32_t                                rest_segment_column_count;
         uint32_t                                rest_segment_row_count;
+        uint32_t                                pa_segment_row_count;
+        uint32_t                                sbo_segment_row_count;
 
         // Buffers
         uint32_t                                picture_control_set_pool_init_count;
@@ -163,6 +165,7 @@ extern "C" {
         uint32_t                                dlf_process_init_count;
         uint32_t                                cdef_process_init_count;
         uint32_t                                rest_process_init_count;
+        uint32_t                                worker_pool_process_init_count;
         uint32_t                                total_process_init_count;
         
         uint16_t                                film_grain_random_seed;
@@ -230,6 +233,7 @@ extern "C" {
         int32_t                                 display_model_info_present_flag;
         int32_t                                 film_grain_denoise_strength;
         int32_t                                 film_grain_params_present;  // To turn on/off film grain (on a sequence basis)
+        uint32_t                                film_grain_update_period;   // Pictures between two film grain estimations (0: every picture)
 
         int32_t                                 extra_frames_to_ref_islice;
         int32_t                                 max_frame_window_to_ref_islice;
@@ -65,18 +65,13 @@ EbErrorType source_based_operations_context_ctor(
     SequenceControlSet            *sequence_control_set_ptr)
 {
     SourceBasedOperationsContext *context_ptr;
-
-    uint32_t  pictureLcuWidth = (sequence_control_set_ptr->max_input_luma_width + sequence_control_set_ptr->sb_sz - 1) / sequence_control_set_ptr->sb_sz;
-    uint32_t    pictureLcuHeight = (sequence_control_set_ptr->max_input_luma_height + sequence_control_set_ptr->sb_sz - 1) / sequence_control_set_ptr->sb_sz;
-    uint32_t    sb_total_count = pictureLcuWidth * pictureLcuHeight;
+    UNUSED(sequence_control_set_ptr);
 
     EB_MALLOC(SourceBasedOperationsContext*, context_ptr, sizeof(SourceBasedOperationsContext), EB_N_PTR);
     *context_dbl_ptr = context_ptr;
     context_ptr->initial_rate_control_results_input_fifo_ptr = initialRateControlResultsInputFifoPtr;
     context_ptr->picture_demux_results_output_fifo_ptr = picture_demux_results_output_fifo_ptr;
 
-    EB_MALLOC(uint8_t*, context_ptr->sb_high_contrast_array, sizeof(uint8_t) * sb_total_count, EB_N_PTR);
-
     return EB_ErrorNone;
 }
 
@@ -793,7 +788,7 @@ void DeriveComplexityContrastPicture(
             SbParams_t     *sb_params = &sequence_control_set_ptr->sb_params_array[sb_index];
             EbBool isCentralArea = EB_FALSE;
             isCentralArea = (EbBool)(sb_params->origin_y > 16 * BLOCK_SIZE_64 && sb_params->origin_y < 21 * BLOCK_SIZE_64 && sb_params->origin_x> 12 * BLOCK_SIZE_64 && sb_params->origin_x < 32 * 64);
-            if (context_ptr->sb_high_contrast_array[sb_index] > 0 && isCentralArea) {
+            if (picture_control_set_ptr->sb_high_contrast_array[sb_index] > 0 && isCentralArea) {
                 picture_control_set_ptr->sb_high_contrast_array_dialated[sb_index] = 4;
                 int32_t i, j;
                 uint8_t * ptr = &picture_control_set_ptr->sb_high_contrast_array_dialated[(int32_t)sb_index - (int32_t)sequence_control_set_ptr->picture_width_in_sb * 1 - 1];
@@ -889,8 +884,58 @@ void DetectCu32x32CleanSparsePicture(
     return;
 }
 
+/************************************************
+ * Add the segment counters to the picture ones
+ ** Returns EB_TRUE for the last segment of the picture, whose
+ ** context then holds the picture counters
+ ************************************************/
+static EbBool merge_source_based_statistics(
+    SourceBasedOperationsContext    *context_ptr,
+    PictureParentControlSet_t       *picture_control_set_ptr)
+{
+    SourceBasedStatistics_t *statistics_ptr = &picture_control_set_ptr->sbo_statistics;
+    EbBool                   last_segment;
+
+    eb_block_on_mutex(picture_control_set_ptr->analysis_segments_mutex);
+
+    if (picture_control_set_ptr->sbo_segments_completion_count == 0)
+        EB_MEMSET(statistics_ptr, 0, sizeof(SourceBasedStatistics_t));
+
+    statistics_ptr->picture_num_grass_sb += context_ptr->picture_num_grass_sb;
+    statistics_ptr->sb_high_contrast_count += context_ptr->sb_high_contrast_count;
+    statistics_ptr->complete_sb_count += context_ptr->complete_sb_count;
+    statistics_ptr->sb_cmplx_contrast_count += context_ptr->sb_cmplx_contrast_count;
+    statistics_ptr->count_of_moving_sbs += context_ptr->count_of_moving_sbs;
+    statistics_ptr->count_of_non_moving_sbs += context_ptr->countOfNonMovingLcus;
+    statistics_ptr->y_non_moving_mean += context_ptr->y_non_moving_mean;
+    statistics_ptr->y_moving_mean += context_ptr->y_moving_mean;
+    statistics_ptr->to_be_intra_coded_probability += context_ptr->to_be_intra_coded_probability;
+    statistics_ptr->depth1_block_num += context_ptr->depth1_block_num;
+
+    last_segment = (EbBool)(++picture_control_set_ptr->sbo_segments_completion_count == picture_control_set_ptr->sbo_segments_total_count);
+
+    eb_release_mutex(picture_control_set_ptr->analysis_segments_mutex);
+
+    if (last_segment) {
+        context_ptr->picture_num_grass_sb = statistics_ptr->picture_num_grass_sb;
+        context_ptr->sb_high_contrast_count = statistics_ptr->sb_high_contrast_count;
+        context_ptr->complete_sb_count = statistics_ptr->complete_sb_count;
+        context_ptr->sb_cmplx_contrast_count = statistics_ptr->sb_cmplx_contrast_count;
+        context_ptr->count_of_moving_sbs = statistics_ptr->count_of_moving_sbs;
+        context_ptr->countOfNonMovingLcus = statistics_ptr->count_of_non_moving_sbs;
+        context_ptr->y_non_moving_mean = statistics_ptr->y_non_moving_mean;
+        context_ptr->y_moving_mean = statistics_ptr->y_moving_mean;
+        context_ptr->to_be_intra_coded_probability = statistics_ptr->to_be_intra_coded_probability;
+        context_ptr->depth1_block_num = statistics_ptr->depth1_block_num;
+    }
+
+    return last_segment;
+}
+
 /************************************************
  * Source Based Operations Kernel
+ ** The SB-based operations are split in SB row segments,
+ ** the last segment of a picture runs the picture-based operations
  ************************************************/
 void* source_based_operations_kernel(void *input_ptr)
 {
@@ -901,6 +946,12 @@ void* source_based_operations_kernel(void *input_ptr)
     InitialRateControlResults_t        *inputResultsPtr;
     EbObjectWrapper               *outputResultsWrapperPtr;
     PictureDemuxResults_t           *outputResultsPtr;
+    uint32_t                         segment_index;
+    uint32_t                         sb_row_start;
+    uint32_t                         sb_row_end;
+    EbBool                           last_row;
+    uint32_t                         map_start;
+    uint32_t                         map_end;
 
     for (;;) {
 
@@ -913,7 +964,11 @@ void* source_based_operations_kernel(void *input_ptr)
         picture_control_set_ptr = (PictureParentControlSet_t*)inputResultsPtr->picture_control_set_wrapper_ptr->object_ptr;
         sequence_control_set_ptr = (SequenceControlSet*)picture_control_set_ptr->sequence_control_set_wrapper_ptr->object_ptr;
 
-        picture_control_set_ptr->dark_back_groundlight_fore_ground = EB_FALSE;
+        segment_index = inputResultsPtr->segment_index;
+        sb_row_start = SEGMENT_START_IDX(segment_index, sequence_control_set_ptr->picture_height_in_sb, picture_control_set_ptr->sbo_segments_total_count);
+        sb_row_end = SEGMENT_END_IDX(segment_index, sequence_control_set_ptr->picture_height_in_sb, picture_control_set_ptr->sbo_segments_total_count);
+        last_row = (EbBool)(sb_row_end == sequence_control_set_ptr->picture_height_in_sb);
+
         context_ptr->picture_num_grass_sb = 0;
 
         context_ptr->sb_cmplx_contrast_count = 0;
@@ -927,17 +982,21 @@ void* source_based_operations_kernel(void *input_ptr)
         context_ptr->to_be_intra_coded_probability = 0;
         context_ptr->depth1_block_num = 0;
 
-        // Reset the cu 32x32 array for Clean Sparse flag
-        EB_MEMSET(picture_control_set_ptr->cu32x32_clean_sparse_coeff_map_array, 0, picture_control_set_ptr->cu32x32_clean_sparse_coeff_map_array_size);
+        // Reset the cu 32x32 array for Clean Sparse flag, two 32x32 rows per SB row
+        map_start = MIN(2 * sb_row_start * picture_control_set_ptr->cu32x32_clean_sparse_coeff_map_array_stride, picture_control_set_ptr->cu32x32_clean_sparse_coeff_map_array_size);
+        map_end = last_row ?
+            picture_control_set_ptr->cu32x32_clean_sparse_coeff_map_array_size :
+            MIN(2 * sb_row_end * picture_control_set_ptr->cu32x32_clean_sparse_coeff_map_array_stride, picture_control_set_ptr->cu32x32_clean_sparse_coeff_map_array_size);
+        EB_MEMSET(&picture_control_set_ptr->cu32x32_clean_sparse_coeff_map_array[map_start], 0, map_end - map_start);
 
         uint32_t sb_total_count = picture_control_set_ptr->sb_total_count;
         uint32_t sb_index;
 
         /***********************************************LCU-based operations************************************************************/
-        for (sb_index = 0; sb_index < sb_total_count; ++sb_index) {
+        for (sb_index = sb_row_start * sequence_control_set_ptr->picture_width_in_sb; sb_index < (last_row ? sb_total_count : sb_row_end * sequence_control_set_ptr->picture_width_in_sb); ++sb_index) {
             SbParams_t *sb_params = &sequence_control_set_ptr->sb_params_array[sb_index];
             picture_control_set_ptr->sb_cmplx_contrast_array[sb_index] = 0;
-            context_ptr->sb_high_contrast_array[sb_index] = 0;
+            picture_control_set_ptr->sb_high_contrast_array[sb_index] = 0;
             picture_control_set_ptr->sb_high_contrast_array_dialated[sb_index] = 0;
             EbBool is_complete_sb = sb_params->is_complete_sb;
             uint8_t  *y_mean_ptr = picture_control_set_ptr->y_mean[sb_index];
@@ -1027,7 +1086,7 @@ void* source_based_operations_kernel(void *input_ptr)
                 }
 
                 if ((context_ptr->high_dist == EB_TRUE && context_ptr->high_contrast_num_ii > 0) || picture_control_set_ptr->sb_cmplx_contrast_array[sb_index] == 4) {
-                    context_ptr->sb_high_contrast_array[sb_index] = 4;
+                    picture_control_set_ptr->sb_high_contrast_array[sb_index] = 4;
                     context_ptr->sb_high_contrast_count++;
                 }
 
@@ -1036,7 +1095,15 @@ void* source_based_operations_kernel(void *input_ptr)
 
         }
 
+        if (!merge_source_based_statistics(context_ptr, picture_control_set_ptr)) {
+            // Release the Input Results
+            eb_release_object(inputResultsWrapperPtr);
+            continue;
+        }
+
         /*********************************************Picture-based operations**********************************************************/
+        picture_control_set_ptr->dark_back_groundlight_fore_ground = EB_FALSE;
+
         LumaContrastDetectorPicture(
             context_ptr,
             picture_control_set_ptr);
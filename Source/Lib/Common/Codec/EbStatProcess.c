@@ -0,0 +1,145 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#include <stdlib.h>
+#include "EbDefinitions.h"
+#include "EbStatProcess.h"
+#include "EbEncDecResults.h"
+#include "EbPictureControlSet.h"
+#include "EbSequenceControlSet.h"
+#include "EbReferenceObject.h"
+#include "EbPsnr.h"
+#include "EbThreads.h"
+
+/******************************************************
+ * Stat Context Constructor
+ ******************************************************/
+EbErrorType stat_context_ctor(
+    StatContext **context_dbl_ptr,
+    EbFifo       *stat_input_fifo_ptr)
+{
+    StatContext *context_ptr;
+    EB_MALLOC(StatContext*, context_ptr, sizeof(StatContext), EB_N_PTR);
+    *context_dbl_ptr = context_ptr;
+
+    // Input System Resource Manager FIFO
+    context_ptr->stat_input_fifo_ptr = stat_input_fifo_ptr;
+
+    return EB_ErrorNone;
+}
+
+/******************************************************
+ * Picture quality against the source as input (before
+ * the film grain denoise), over the picture size
+ * without the encoder padding
+ ******************************************************/
+static void picture_stat_calculations(
+    PictureControlSet_t    *picture_control_set_ptr,
+    SequenceControlSet   *sequence_control_set_ptr)
+{
+    PictureParentControlSet_t *parent_pcs_ptr = picture_control_set_ptr->parent_pcs_ptr;
+    const EbBool is16bit = (EbBool)(sequence_control_set_ptr->static_config.encoder_bit_depth > EB_8BIT);
+    const int32_t width = sequence_control_set_ptr->luma_width - sequence_control_set_ptr->pad_right;
+    const int32_t height = sequence_control_set_ptr->luma_height - sequence_control_set_ptr->pad_bottom;
+    const int32_t uv_width = (width + 1) >> 1;
+    const int32_t uv_height = (height + 1) >> 1;
+    EbPictureBufferDesc_t *recon_ptr;
+
+    if (parent_pcs_ptr->is_used_as_reference_flag == EB_TRUE) {
+        EbReferenceObject *reference_object = (EbReferenceObject*)parent_pcs_ptr->reference_picture_wrapper_ptr->object_ptr;
+        recon_ptr = is16bit ? reference_object->reference_picture16bit : reference_object->reference_picture;
+    }
+    else
+        recon_ptr = is16bit ? picture_control_set_ptr->recon_picture16bit_ptr : picture_control_set_ptr->recon_picture_ptr;
+
+    Yv12BufferConfig source;
+    LinkEbToAomBufferDesc(
+        parent_pcs_ptr->save_source_picture_ptr ? parent_pcs_ptr->save_source_picture_ptr :
+        is16bit ? picture_control_set_ptr->input_frame16bit : parent_pcs_ptr->enhanced_picture_ptr,
+        &source);
+
+    Yv12BufferConfig recon;
+    LinkEbToAomBufferDesc(
+        recon_ptr,
+        &recon);
+
+    if (is16bit) {
+        parent_pcs_ptr->luma_sse = aom_highbd_get_y_sse_part(&source, &recon, 0, width, 0, height);
+        parent_pcs_ptr->cb_sse = aom_highbd_get_u_sse_part(&source, &recon, 0, uv_width, 0, uv_height);
+        parent_pcs_ptr->cr_sse = aom_highbd_get_v_sse_part(&source, &recon, 0, uv_width, 0, uv_height);
+    }
+    else {
+        parent_pcs_ptr->luma_sse = aom_get_y_sse_part(&source, &recon, 0, width, 0, height);
+        parent_pcs_ptr->cb_sse = aom_get_u_sse_part(&source, &recon, 0, uv_width, 0, uv_height);
+        parent_pcs_ptr->cr_sse = aom_get_v_sse_part(&source, &recon, 0, uv_width, 0, uv_height);
+    }
+
+    if (sequence_control_set_ptr->static_config.stat_report > 1) {
+        if (is16bit) {
+            const uint32_t bit_depth = sequence_control_set_ptr->static_config.encoder_bit_depth;
+            parent_pcs_ptr->luma_ssim = aom_highbd_ssim2(source.y_buffer, source.y_stride, recon.y_buffer, recon.y_stride, width, height, bit_depth);
+            parent_pcs_ptr->cb_ssim = aom_highbd_ssim2(source.u_buffer, source.uv_stride, recon.u_buffer, recon.uv_stride, uv_width, uv_height, bit_depth);
+            parent_pcs_ptr->cr_ssim = aom_highbd_ssim2(source.v_buffer, source.uv_stride, recon.v_buffer, recon.uv_stride, uv_width, uv_height, bit_depth);
+        }
+        else {
+            parent_pcs_ptr->luma_ssim = aom_ssim2(source.y_buffer, source.y_stride, recon.y_buffer, recon.y_stride, width, height);
+            parent_pcs_ptr->cb_ssim = aom_ssim2(source.u_buffer, source.uv_stride, recon.u_buffer, recon.uv_stride, uv_width, uv_height);
+            parent_pcs_ptr->cr_ssim = aom_ssim2(source.v_buffer, source.uv_stride, recon.v_buffer, recon.uv_stride, uv_width, uv_height);
+        }
+    }
+    else {
+        parent_pcs_ptr->luma_ssim = 0;
+        parent_pcs_ptr->cb_ssim = 0;
+        parent_pcs_ptr->cr_ssim = 0;
+    }
+}
+
+/******************************************************
+ * Stat Kernel
+ *   Runs below the priority of the encoder pipeline;
+ *   the only stage waiting for its results is
+ *   Packetization, which attaches them to the
+ *   output buffer of the picture.
+ ******************************************************/
+void* stat_kernel(void *input_ptr)
+{
+    StatContext                            *context_ptr = (StatContext*)input_ptr;
+    PictureControlSet_t                     *picture_control_set_ptr;
+    SequenceControlSet                    *sequence_control_set_ptr;
+
+    //// Input
+    EbObjectWrapper                       *stat_tasks_wrapper_ptr;
+    StatTasks_t                             *stat_tasks_ptr;
+
+    eb_lower_thread_priority();
+
+    for (;;) {
+
+        // Get Stat Tasks
+        eb_get_full_object(
+            context_ptr->stat_input_fifo_ptr,
+            &stat_tasks_wrapper_ptr);
+
+        stat_tasks_ptr = (StatTasks_t*)stat_tasks_wrapper_ptr->object_ptr;
+        picture_control_set_ptr = (PictureControlSet_t*)stat_tasks_ptr->picture_control_set_wrapper_ptr->object_ptr;
+        sequence_control_set_ptr = (SequenceControlSet*)picture_control_set_ptr->sequence_control_set_wrapper_ptr->object_ptr;
+
+        picture_stat_calculations(
+            picture_control_set_ptr,
+            sequence_control_set_ptr);
+
+        // Release the hold Rest took on the reference picture
+        if (stat_tasks_ptr->reference_picture_wrapper_ptr)
+            eb_release_object(stat_tasks_ptr->reference_picture_wrapper_ptr);
+
+        // The picture may be released by Packetization from here on
+        eb_post_semaphore(picture_control_set_ptr->parent_pcs_ptr->stat_done_semaphore);
+
+        // Release the Stat Tasks
+        eb_release_object(stat_tasks_wrapper_ptr);
+    }
+
+    return EB_NULL;
+}
@@ -0,0 +1,30 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#ifndef EbStatProcess_h
+#define EbStatProcess_h
+
+#include "EbDefinitions.h"
+#include "EbSystemResourceManager.h"
+
+/**************************************
+ * Stat Context
+ **************************************/
+typedef struct StatContext
+{
+    EbFifo                       *stat_input_fifo_ptr;
+
+} StatContext;
+
+/**************************************
+ * Extern Function Declarations
+ **************************************/
+extern EbErrorType stat_context_ctor(
+    StatContext **context_dbl_ptr,
+    EbFifo       *stat_input_fifo_ptr);
+
+extern void* stat_kernel(void *input_ptr);
+
+#endif
@@ -0,0 +1,115 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#include <stdlib.h>
+
+#include "EbSymbolStream.h"
+#include "EbThreads.h"
+
+EbErrorType symbol_chunk_pool_ctor(
+    SymbolChunkPool_t **pool_dbl_ptr)
+{
+    SymbolChunkPool_t *pool_ptr;
+
+    EB_MALLOC(SymbolChunkPool_t*, pool_ptr, sizeof(SymbolChunkPool_t), EB_N_PTR);
+    *pool_dbl_ptr = pool_ptr;
+
+    pool_ptr->free_list = (SymbolChunk_t*)EB_NULL;
+    pool_ptr->alloc_list = (SymbolChunk_t*)EB_NULL;
+    EB_CREATEMUTEX(EbHandle, pool_ptr->mutex, sizeof(EbHandle), EB_MUTEX);
+
+    return EB_ErrorNone;
+}
+
+void symbol_chunk_pool_dtor(
+    SymbolChunkPool_t  *pool_ptr)
+{
+    SymbolChunk_t *chunk_ptr;
+
+    while (pool_ptr->alloc_list != EB_NULL) {
+        chunk_ptr = pool_ptr->alloc_list;
+        pool_ptr->alloc_list = chunk_ptr->alloc_next;
+        free(chunk_ptr);
+    }
+    pool_ptr->free_list = (SymbolChunk_t*)EB_NULL;
+}
+
+// Called with the pool mutex held. Chunks are owned by the pool and freed by
+// symbol_chunk_pool_dtor(), not by the library memory map.
+static EbErrorType symbol_chunk_alloc(
+    SymbolChunkPool_t  *pool_ptr,
+    SymbolChunk_t     **chunk_dbl_ptr)
+{
+    SymbolChunk_t *chunk_ptr;
+
+    chunk_ptr = (SymbolChunk_t*)malloc(sizeof(SymbolChunk_t));
+    if (chunk_ptr == EB_NULL)
+        return EB_ErrorInsufficientResources;
+    chunk_ptr->alloc_next = pool_ptr->alloc_list;
+    pool_ptr->alloc_list = chunk_ptr;
+    *chunk_dbl_ptr = chunk_ptr;
+
+    return EB_ErrorNone;
+}
+
+void symbol_stream_start(
+    SymbolStream_t     *stream_ptr,
+    SymbolChunkPool_t  *pool_ptr,
+    const aom_cdf_prob *cdf_base)
+{
+    stream_ptr->head = (SymbolChunk_t*)EB_NULL;
+    stream_ptr->tail = (SymbolChunk_t*)EB_NULL;
+    stream_ptr->pool = pool_ptr;
+    stream_ptr->cdf_base = cdf_base;
+    stream_ptr->error = EB_ErrorNone;
+}
+
+EbErrorType symbol_stream_grow(
+    SymbolStream_t *stream_ptr)
+{
+    SymbolChunkPool_t *pool_ptr = stream_ptr->pool;
+    SymbolChunk_t     *chunk_ptr;
+    EbErrorType        return_error = EB_ErrorNone;
+
+    eb_block_on_mutex(pool_ptr->mutex);
+    chunk_ptr = pool_ptr->free_list;
+    if (chunk_ptr != EB_NULL)
+        pool_ptr->free_list = chunk_ptr->next;
+    else
+        return_error = symbol_chunk_alloc(pool_ptr, &chunk_ptr);
+    eb_release_mutex(pool_ptr->mutex);
+
+    if (return_error != EB_ErrorNone) {
+        // Checked by the recording process once the SB is written
+        stream_ptr->error = return_error;
+        return return_error;
+    }
+
+    chunk_ptr->next = (SymbolChunk_t*)EB_NULL;
+    chunk_ptr->count = 0;
+    if (stream_ptr->tail)
+        stream_ptr->tail->next = chunk_ptr;
+    else
+        stream_ptr->head = chunk_ptr;
+    stream_ptr->tail = chunk_ptr;
+
+    return EB_ErrorNone;
+}
+
+void symbol_stream_release(
+    SymbolStream_t *stream_ptr)
+{
+    if (stream_ptr->head == EB_NULL)
+        return;
+
+    // The whole chain goes back at once
+    eb_block_on_mutex(stream_ptr->pool->mutex);
+    stream_ptr->tail->next = stream_ptr->pool->free_list;
+    stream_ptr->pool->free_list = stream_ptr->head;
+    eb_release_mutex(stream_ptr->pool->mutex);
+
+    stream_ptr->head = (SymbolChunk_t*)EB_NULL;
+    stream_ptr->tail = (SymbolChunk_t*)EB_NULL;
+}
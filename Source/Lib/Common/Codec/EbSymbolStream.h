@@ -0,0 +1,117 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#ifndef EbSymbolStream_h
+#define EbSymbolStream_h
+
+#include <assert.h>
+
+#include "EbDefinitions.h"
+#include "EbCabacContextModel.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SYMBOL_CHUNK_RECORDS            0x400   // Records per chunk
+
+    // Record kinds, in the two low bits of each record
+#define SYMBOL_RECORD_CDF               0       // [31:10] cdf id, [9:6] nsymbs - 1, [5:2] symbol
+#define SYMBOL_RECORD_BOOL              1       // [10:3] probability, [2] bit
+#define SYMBOL_RECORD_PARTITION         2       // [31:10] cdf id, [8:4] bsize, [3] vert alike, [2] split
+#define SYMBOL_RECORD_MARKER            3       // [18:14] mi_col and [13:9] mi_row in the SB, [8:4] bsize, [3] skip, [2] type
+
+    // Marker types: syntax that depends on decisions taken after EncDec
+#define SYMBOL_MARKER_CDEF              0
+#define SYMBOL_MARKER_LR                1
+
+    typedef struct SymbolChunk_s {
+        struct SymbolChunk_s            *next;
+        struct SymbolChunk_s            *alloc_next;    // Chains every chunk of the pool, free or in use
+        uint32_t                         count;
+        uint32_t                         records[SYMBOL_CHUNK_RECORDS];
+    } SymbolChunk_t;
+
+    /**************************************
+     * Symbol Chunk Pool
+     *   Shared by the EncDec processes (recording) and the Entropy Coding
+     *   process (release after coding). Grows to the number of chunks in flight,
+     *   which are freed by symbol_chunk_pool_dtor() at deinit.
+     **************************************/
+    typedef struct SymbolChunkPool_s {
+        EbHandle                         mutex;
+        SymbolChunk_t                   *free_list;
+        SymbolChunk_t                   *alloc_list;
+    } SymbolChunkPool_t;
+
+    /**************************************
+     * Symbol Stream
+     *   The symbols of one SB as (cdf id, symbol) pairs and raw bools, in
+     *   bitstream order. Cdf ids are offsets from the start of the FRAME_CONTEXT.
+     **************************************/
+    typedef struct SymbolStream_s {
+        SymbolChunk_t                   *head;
+        SymbolChunk_t                   *tail;
+        SymbolChunkPool_t               *pool;
+        const aom_cdf_prob              *cdf_base;
+        EbErrorType                      error;
+    } SymbolStream_t;
+
+    extern EbErrorType symbol_chunk_pool_ctor(
+        SymbolChunkPool_t              **pool_dbl_ptr);
+
+    // Frees every chunk of the pool, including the ones of unreleased streams
+    extern void symbol_chunk_pool_dtor(
+        SymbolChunkPool_t               *pool_ptr);
+
+    extern void symbol_stream_start(
+        SymbolStream_t                  *stream_ptr,
+        SymbolChunkPool_t               *pool_ptr,
+        const aom_cdf_prob              *cdf_base);
+
+    // Chains an empty chunk at the tail of the stream
+    extern EbErrorType symbol_stream_grow(
+        SymbolStream_t                  *stream_ptr);
+
+    // Returns the chunks of the stream to their pool
+    extern void symbol_stream_release(
+        SymbolStream_t                  *stream_ptr);
+
+    static INLINE void symbol_stream_put(SymbolStream_t *stream_ptr, uint32_t record) {
+        if ((stream_ptr->tail == EB_NULL || stream_ptr->tail->count == SYMBOL_CHUNK_RECORDS) &&
+            symbol_stream_grow(stream_ptr) != EB_ErrorNone)
+            return;
+        stream_ptr->tail->records[stream_ptr->tail->count++] = record;
+    }
+
+    static INLINE void symbol_stream_put_cdf(SymbolStream_t *stream_ptr, int32_t symb,
+        const aom_cdf_prob *cdf, int32_t nsymbs) {
+        const uint32_t cdf_id = (uint32_t)(cdf - stream_ptr->cdf_base);
+        assert(cdf_id < sizeof(FRAME_CONTEXT) / sizeof(aom_cdf_prob));
+        symbol_stream_put(stream_ptr,
+            (cdf_id << 10) | ((uint32_t)(nsymbs - 1) << 6) | ((uint32_t)symb << 2) | SYMBOL_RECORD_CDF);
+    }
+
+    static INLINE void symbol_stream_put_bool(SymbolStream_t *stream_ptr, int32_t bit, int32_t prob) {
+        symbol_stream_put(stream_ptr, ((uint32_t)prob << 3) | ((uint32_t)bit << 2) | SYMBOL_RECORD_BOOL);
+    }
+
+    static INLINE void symbol_stream_put_partition(SymbolStream_t *stream_ptr, int32_t split,
+        const aom_cdf_prob *partition_cdf, block_size bsize, int32_t vert_alike) {
+        const uint32_t cdf_id = (uint32_t)(partition_cdf - stream_ptr->cdf_base);
+        symbol_stream_put(stream_ptr,
+            (cdf_id << 10) | ((uint32_t)bsize << 4) | ((uint32_t)vert_alike << 3) | ((uint32_t)split << 2) | SYMBOL_RECORD_PARTITION);
+    }
+
+    static INLINE void symbol_stream_put_marker(SymbolStream_t *stream_ptr, uint32_t type,
+        int32_t mi_row_in_sb, int32_t mi_col_in_sb, block_size bsize, int32_t skip) {
+        symbol_stream_put(stream_ptr,
+            ((uint32_t)mi_col_in_sb << 14) | ((uint32_t)mi_row_in_sb << 9) | ((uint32_t)bsize << 4) |
+            ((uint32_t)skip << 3) | (type << 2) | SYMBOL_RECORD_MARKER);
+    }
+
+#ifdef __cplusplus
+}
+#endif
+#endif // EbSymbolStream_h
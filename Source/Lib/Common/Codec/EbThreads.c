@@ -28,6 +28,10 @@
 #include <semaphore.h>
 #include <time.h>
 #include <unistd.h>
+#include <sys/resource.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
 #else
 #error OS/Platform not supported.
 #endif // _WIN32
@@ -169,6 +173,34 @@ EbErrorType eb_destroy_thread(
 
     return error_return;
 }
+
+/****************************************
+ * eb_lower_thread_priority
+ *   Moves the calling thread below the
+ *   priority of the encoder pipeline
+ ****************************************/
+void eb_lower_thread_priority(void)
+{
+#ifdef _WIN32
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+#elif defined(__linux__)
+    // Nice values are per thread on Linux, and raising one needs no privilege
+    const id_t tid = (id_t)syscall(SYS_gettid);
+    int32_t nice_value;
+    errno = 0;
+    nice_value = getpriority(PRIO_PROCESS, tid);
+    if (errno == 0)
+        setpriority(PRIO_PROCESS, tid, nice_value + 5);
+#elif defined(__APPLE__)
+    // The SCHED_OTHER priority range is not empty on macOS, take its bottom
+    struct sched_param param;
+    int32_t policy;
+    if (pthread_getschedparam(pthread_self(), &policy, &param) == 0) {
+        param.sched_priority = sched_get_priority_min(policy);
+        pthread_setschedparam(pthread_self(), policy, &param);
+    }
+#endif // _WIN32
+}
 #if defined(__APPLE__)
 static int32_t semaphore_id(void)
 {
@@ -35,6 +35,8 @@ extern "C" {
     extern EbErrorType eb_destroy_thread(
         EbHandle thread_handle);
 
+    extern void eb_lower_thread_priority(void);
+
     /**************************************
      * Semaphores
      **************************************/
@@ -8180,7 +8180,7 @@ void av1_get_inv_txfm_cfg(TxType tx_type, TxSize tx_size,
 static INLINE void inv_txfm2d_add_c(const int32_t *input, uint16_t *output,
     int32_t stride, Txfm2DFlipCfg *cfg,
     int32_t *txfm_buf, TxSize tx_size,
-    int32_t bd) {
+    int32_t eob, int32_t bd) {
     // Note when assigning txfm_size_col, we use the txfm_size from the
     // row configuration and vice versa. This is intentionally done to
     // accurately perform rectangular transforms. When the transform is
@@ -8213,9 +8213,12 @@ static INLINE void inv_txfm2d_add_c(const int32_t *input, uint16_t *output,
     int32_t *buf = temp_out + buf_offset;
     int32_t *buf_ptr = buf;
     int32_t c, r;
+    // Whatever the scan, the coefficient at scan index i lies in a row <= i:
+    // the rows from eob on are all zero and so is their transform
+    const int32_t nonzero_rows = AOMMIN(eob, txfm_size_row);
 
     // Rows
-    for (r = 0; r < txfm_size_row; ++r) {
+    for (r = 0; r < nonzero_rows; ++r) {
         if (abs(rect_type) == 1) {
             for (c = 0; c < txfm_size_col; ++c) {
                 temp_in[c] = round_shift((int64_t)input[c] * NewInvSqrt2, NewSqrt2Bits);
@@ -8234,6 +8237,8 @@ static INLINE void inv_txfm2d_add_c(const int32_t *input, uint16_t *output,
         input += txfm_size_col;
         buf_ptr += txfm_size_col;
     }
+    if (nonzero_rows < txfm_size_row)
+        memset(buf_ptr, 0, (txfm_size_row - nonzero_rows) * txfm_size_col * sizeof(*buf_ptr));
 
     // Columns
     for (c = 0; c < txfm_size_col; ++c) {
@@ -8267,37 +8272,42 @@ static INLINE void inv_txfm2d_add_c(const int32_t *input, uint16_t *output,
 static INLINE void inv_txfm2d_add_facade(const int32_t *input, uint16_t *output,
     int32_t stride, int32_t *txfm_buf,
     TxType tx_type, TxSize tx_size,
-    int32_t bd) {
+    int32_t eob, int32_t bd) {
     Txfm2DFlipCfg cfg;
     av1_get_inv_txfm_cfg(tx_type, tx_size, &cfg);
     // Forward shift sum uses larger square size, to be consistent with what
     // av1_gen_inv_stage_range() does for inverse shifts.
-    inv_txfm2d_add_c(input, output, stride, &cfg, txfm_buf, tx_size, bd);
+    inv_txfm2d_add_c(input, output, stride, &cfg, txfm_buf, tx_size, eob, bd);
 }
 void av1_inv_txfm2d_add_4x4_c(const int32_t *input, uint16_t *output,
     int32_t stride, TxType tx_type, int32_t bd) {
     DECLARE_ALIGNED(32, int32_t, txfm_buf[4 * 4 + 4 + 4]);
-    inv_txfm2d_add_facade(input, output, stride, txfm_buf, tx_type, TX_4X4, bd);
+    inv_txfm2d_add_facade(input, output, stride, txfm_buf, tx_type, TX_4X4,
+        av1_get_max_eob(TX_4X4), bd);
 }
 void av1_inv_txfm2d_add_8x8_c(const int32_t *input, uint16_t *output,
-    int32_t stride, TxType tx_type, int32_t bd) {
+    int32_t stride, TxType tx_type, TxSize tx_size, int32_t eob, int32_t bd) {
+    UNUSED(tx_size);
     DECLARE_ALIGNED(32, int32_t, txfm_buf[8 * 8 + 8 + 8]);
-    inv_txfm2d_add_facade(input, output, stride, txfm_buf, tx_type, TX_8X8, bd);
+    inv_txfm2d_add_facade(input, output, stride, txfm_buf, tx_type, TX_8X8, eob, bd);
 }
 void av1_inv_txfm2d_add_16x16_c(const int32_t *input, uint16_t *output,
-    int32_t stride, TxType tx_type, int32_t bd) {
+    int32_t stride, TxType tx_type, TxSize tx_size, int32_t eob, int32_t bd) {
+    UNUSED(tx_size);
     DECLARE_ALIGNED(32, int32_t, txfm_buf[16 * 16 + 16 + 16]);
-    inv_txfm2d_add_facade(input, output, stride, txfm_buf, tx_type, TX_16X16, bd);
+    inv_txfm2d_add_facade(input, output, stride, txfm_buf, tx_type, TX_16X16, eob, bd);
 }
 
 void av1_inv_txfm2d_add_32x32_c(const int32_t *input, uint16_t *output,
-    int32_t stride, TxType tx_type, int32_t bd) {
+    int32_t stride, TxType tx_type, TxSize tx_size, int32_t eob, int32_t bd) {
+    UNUSED(tx_size);
     DECLARE_ALIGNED(32, int32_t, txfm_buf[32 * 32 + 32 + 32]);
-    inv_txfm2d_add_facade(input, output, stride, txfm_buf, tx_type, TX_32X32, bd);
+    inv_txfm2d_add_facade(input, output, stride, txfm_buf, tx_type, TX_32X32, eob, bd);
 }
 
 void av1_inv_txfm2d_add_64x64_c(const int32_t *input, uint16_t *output,
-    int32_t stride, TxType tx_type, int32_t bd) {
+    int32_t stride, TxType tx_type, TxSize tx_size, int32_t eob, int32_t bd) {
+    UNUSED(tx_size);
     // TODO(urvang): Can the same array be reused, instead of using a new array?
     // Remap 32x32 input into a modified 64x64 by:
     // - Copying over these values in top-left 32x32 locations.
@@ -8310,7 +8320,7 @@ void av1_inv_txfm2d_add_64x64_c(const int32_t *input, uint16_t *output,
     memset(mod_input + 32 * 64, 0, 32 * 64 * sizeof(*mod_input));
     DECLARE_ALIGNED(32, int32_t, txfm_buf[64 * 64 + 64 + 64]);
     inv_txfm2d_add_facade(mod_input, output, stride, txfm_buf, tx_type, TX_64X64,
-        bd);
+        eob, bd);
 }
 
 
@@ -8318,53 +8328,50 @@ void av1_inv_txfm2d_add_4x8_c(const int32_t *input, uint16_t *output,
     int32_t stride, TxType tx_type, TxSize tx_size, int32_t bd) {
     (void)tx_size;
     DECLARE_ALIGNED(32, int32_t, txfm_buf[4 * 8 + 8 + 8]);
-    inv_txfm2d_add_facade(input, output, stride, txfm_buf, tx_type, TX_4X8, bd);
+    inv_txfm2d_add_facade(input, output, stride, txfm_buf, tx_type, TX_4X8,
+        av1_get_max_eob(TX_4X8), bd);
 }
 
 void av1_inv_txfm2d_add_8x4_c(const int32_t *input, uint16_t *output,
     int32_t stride, TxType tx_type, TxSize tx_size, int32_t bd) {
     (void)tx_size;
     DECLARE_ALIGNED(32, int32_t, txfm_buf[8 * 4 + 8 + 8]);
-    inv_txfm2d_add_facade(input, output, stride, txfm_buf, tx_type, TX_8X4, bd);
+    inv_txfm2d_add_facade(input, output, stride, txfm_buf, tx_type, TX_8X4,
+        av1_get_max_eob(TX_8X4), bd);
 }
 
 void av1_inv_txfm2d_add_8x16_c(const int32_t *input, uint16_t *output,
     int32_t stride, TxType tx_type, TxSize tx_size, int32_t eob, int32_t bd) {
     UNUSED(tx_size);
-    UNUSED(eob);
     DECLARE_ALIGNED(32, int32_t, txfm_buf[8 * 16 + 16 + 16]);
-    inv_txfm2d_add_facade(input, output, stride, txfm_buf, tx_type, TX_8X16, bd);
+    inv_txfm2d_add_facade(input, output, stride, txfm_buf, tx_type, TX_8X16, eob, bd);
 }
 
 void av1_inv_txfm2d_add_16x8_c(const int32_t *input, uint16_t *output,
     int32_t stride, TxType tx_type, TxSize tx_size, int32_t eob, int32_t bd) {
     UNUSED(tx_size);
-    UNUSED(eob);
     DECLARE_ALIGNED(32, int32_t, txfm_buf[16 * 8 + 16 + 16]);
-    inv_txfm2d_add_facade(input, output, stride, txfm_buf, tx_type, TX_16X8, bd);
+    inv_txfm2d_add_facade(input, output, stride, txfm_buf, tx_type, TX_16X8, eob, bd);
 }
 
 void av1_inv_txfm2d_add_16x32_c(const int32_t *input, uint16_t *output,
     int32_t stride, TxType tx_type, TxSize tx_size, int32_t eob, int32_t bd) {
     UNUSED(tx_size);
-    UNUSED(eob);
     DECLARE_ALIGNED(32, int32_t, txfm_buf[16 * 32 + 32 + 32]);
-    inv_txfm2d_add_facade(input, output, stride, txfm_buf, tx_type, TX_16X32, bd);
+    inv_txfm2d_add_facade(input, output, stride, txfm_buf, tx_type, TX_16X32, eob, bd);
 }
 
 void av1_inv_txfm2d_add_32x16_c(const int32_t *input, uint16_t *output,
     int32_t stride, TxType tx_type, TxSize tx_size, int32_t eob, int32_t bd) {
     UNUSED(tx_size);
-    UNUSED(eob);
     DECLARE_ALIGNED(32, int32_t, txfm_buf[32 * 16 + 32 + 32]);
-    inv_txfm2d_add_facade(input, output, stride, txfm_buf, tx_type, TX_32X16, bd);
+    inv_txfm2d_add_facade(input, output, stride, txfm_buf, tx_type, TX_32X16, eob, bd);
 }
 
 
 void av1_inv_txfm2d_add_64x32_c(const int32_t *input, uint16_t *output,
     int32_t stride, TxType tx_type, TxSize tx_size, int32_t eob, int32_t bd) {
     UNUSED(tx_size);
-    UNUSED(eob);
     // Remap 32x32 input into a modified 64x32 by:
     // - Copying over these values in top-left 32x32 locations.
     // - Setting the rest of the locations to 0.
@@ -8375,13 +8382,12 @@ void av1_inv_txfm2d_add_64x32_c(const int32_t *input, uint16_t *output,
     }
     DECLARE_ALIGNED(32, int32_t, txfm_buf[64 * 32 + 64 + 64]);
     inv_txfm2d_add_facade(mod_input, output, stride, txfm_buf, tx_type, TX_64X32,
-        bd);
+        eob, bd);
 }
 
 void av1_inv_txfm2d_add_32x64_c(const int32_t *input, uint16_t *output,
     int32_t stride, TxType tx_type, TxSize tx_size, int32_t eob, int32_t bd)  {
     UNUSED(tx_size);
-    UNUSED(eob);
     // Remap 32x32 input into a modified 32x64 input by:
     // - Copying over these values in top-left 32x32 locations.
     // - Setting the rest of the locations to 0.
@@ -8390,13 +8396,12 @@ void av1_inv_txfm2d_add_32x64_c(const int32_t *input, uint16_t *output,
     memset(mod_input + 32 * 32, 0, 32 * 32 * sizeof(*mod_input));
     DECLARE_ALIGNED(32, int32_t, txfm_buf[64 * 32 + 64 + 64]);
     inv_txfm2d_add_facade(mod_input, output, stride, txfm_buf, tx_type, TX_32X64,
-        bd);
+        eob, bd);
 }
 
 void av1_inv_txfm2d_add_16x64_c(const int32_t *input, uint16_t *output,
     int32_t stride, TxType tx_type, TxSize tx_size, int32_t eob, int32_t bd)  {
     UNUSED(tx_size);
-    UNUSED(eob);
     // Remap 16x32 input into a modified 16x64 input by:
     // - Copying over these values in top-left 16x32 locations.
     // - Setting the rest of the locations to 0.
@@ -8405,13 +8410,12 @@ void av1_inv_txfm2d_add_16x64_c(const int32_t *input, uint16_t *output,
     memset(mod_input + 16 * 32, 0, 16 * 32 * sizeof(*mod_input));
     DECLARE_ALIGNED(32, int32_t, txfm_buf[16 * 64 + 64 + 64]);
     inv_txfm2d_add_facade(mod_input, output, stride, txfm_buf, tx_type, TX_16X64,
-        bd);
+        eob, bd);
 }
 
 void av1_inv_txfm2d_add_64x16_c(const int32_t *input, uint16_t *output,
     int32_t stride, TxType tx_type, TxSize tx_size, int32_t eob, int32_t bd) {
     UNUSED(tx_size);
-    UNUSED(eob);
     // Remap 32x16 input into a modified 64x16 by:
     // - Copying over these values in top-left 32x16 locations.
     // - Setting the rest of the locations to 0.
@@ -8422,37 +8426,37 @@ void av1_inv_txfm2d_add_64x16_c(const int32_t *input, uint16_t *output,
     }
     DECLARE_ALIGNED(32, int32_t, txfm_buf[16 * 64 + 64 + 64]);
     inv_txfm2d_add_facade(mod_input, output, stride, txfm_buf, tx_type, TX_64X16,
-        bd);
+        eob, bd);
 }
 
 void av1_inv_txfm2d_add_4x16_c(const int32_t *input, uint16_t *output,
     int32_t stride, TxType tx_type, TxSize tx_size, int32_t bd)  {
     UNUSED(tx_size);
     DECLARE_ALIGNED(32, int32_t, txfm_buf[4 * 16 + 16 + 16]);
-    inv_txfm2d_add_facade(input, output, stride, txfm_buf, tx_type, TX_4X16, bd);
+    inv_txfm2d_add_facade(input, output, stride, txfm_buf, tx_type, TX_4X16,
+        av1_get_max_eob(TX_4X16), bd);
 }
 
 void av1_inv_txfm2d_add_16x4_c(const int32_t *input, uint16_t *output,
     int32_t stride, TxType tx_type, TxSize tx_size, int32_t bd)  {
     UNUSED(tx_size);
     DECLARE_ALIGNED(32, int32_t, txfm_buf[4 * 16 + 16 + 16]);
-    inv_txfm2d_add_facade(input, output, stride, txfm_buf, tx_type, TX_16X4, bd);
+    inv_txfm2d_add_facade(input, output, stride, txfm_buf, tx_type, TX_16X4,
+        av1_get_max_eob(TX_16X4), bd);
 }
 
 void av1_inv_txfm2d_add_8x32_c(const int32_t *input, uint16_t *output,
     int32_t stride, TxType tx_type, TxSize tx_size, int32_t eob, int32_t bd)  {
     UNUSED(tx_size);
-    UNUSED(eob);
     DECLARE_ALIGNED(32, int32_t, txfm_buf[8 * 32 + 32 + 32]);
-    inv_txfm2d_add_facade(input, output, stride, txfm_buf, tx_type, TX_8X32, bd);
+    inv_txfm2d_add_facade(input, output, stride, txfm_buf, tx_type, TX_8X32, eob, bd);
 }
 
 void av1_inv_txfm2d_add_32x8_c(const int32_t *input, uint16_t *output,
     int32_t stride, TxType tx_type, TxSize tx_size, int32_t eob, int32_t bd) {
     UNUSED(tx_size);
-    UNUSED(eob);
     DECLARE_ALIGNED(32, int32_t, txfm_buf[8 * 32 + 32 + 32]);
-    inv_txfm2d_add_facade(input, output, stride, txfm_buf, tx_type, TX_32X8, bd);
+    inv_txfm2d_add_facade(input, output, stride, txfm_buf, tx_type, TX_32X8, eob, bd);
 }
 
 
@@ -8616,7 +8620,8 @@ static void highbd_inv_txfm_add_8x8(const tran_low_t *input, uint8_t *dest,
     const TxType tx_type = txfm_param->tx_type;
     const int32_t *src = cast_to_int32(input);
 #if INTRINSIC_OPT_2
-    av1_inv_txfm2d_add_8x8(src, CONVERT_TO_SHORTPTR(dest), stride, tx_type, bd);
+    av1_inv_txfm2d_add_8x8(src, CONVERT_TO_SHORTPTR(dest), stride,
+        tx_type, txfm_param->tx_size, txfm_param->eob, bd);
 #else
     switch (tx_type) {
         // Assembly version doesn't support some transform types, so use C version
@@ -8628,12 +8633,12 @@ static void highbd_inv_txfm_add_8x8(const tran_low_t *input, uint8_t *dest,
     case V_FLIPADST:
     case H_FLIPADST:
     case IDTX:
-        av1_inv_txfm2d_add_8x8_c(src, CONVERT_TO_SHORTPTR(dest), stride, tx_type,
-            bd);
+        av1_inv_txfm2d_add_8x8_c(src, CONVERT_TO_SHORTPTR(dest), stride,
+            tx_type, txfm_param->tx_size, txfm_param->eob, bd);
         break;
     default:
-        av1_inv_txfm2d_add_8x8(src, CONVERT_TO_SHORTPTR(dest), stride, tx_type,
-            bd);
+        av1_inv_txfm2d_add_8x8(src, CONVERT_TO_SHORTPTR(dest), stride,
+            tx_type, txfm_param->tx_size, txfm_param->eob, bd);
         break;
     }
 #endif
@@ -8645,8 +8650,8 @@ static void highbd_inv_txfm_add_16x16(const tran_low_t *input, uint8_t *dest,
     const TxType tx_type = txfm_param->tx_type;
     const int32_t *src = cast_to_int32(input);
 #if INTRINSIC_OPT_2
-    av1_inv_txfm2d_add_16x16(src, CONVERT_TO_SHORTPTR(dest), stride, tx_type,
-        bd);
+    av1_inv_txfm2d_add_16x16(src, CONVERT_TO_SHORTPTR(dest), stride,
+        tx_type, txfm_param->tx_size, txfm_param->eob, bd);
 #else
     switch (tx_type) {
         // Assembly version doesn't support some transform types, so use C version
@@ -8659,11 +8664,11 @@ static void highbd_inv_txfm_add_16x16(const tran_low_t *input, uint8_t *dest,
     case H_FLIPADST:
     case IDTX:
         av1_inv_txfm2d_add_16x16_c(src, CONVERT_TO_SHORTPTR(dest), stride,
-            tx_type, bd);
+            tx_type, txfm_param->tx_size, txfm_param->eob, bd);
         break;
     default:
-        av1_inv_txfm2d_add_16x16(src, CONVERT_TO_SHORTPTR(dest), stride, tx_type,
-            bd);
+        av1_inv_txfm2d_add_16x16(src, CONVERT_TO_SHORTPTR(dest), stride,
+            tx_type, txfm_param->tx_size, txfm_param->eob, bd);
         break;
     }
 #endif
@@ -8678,20 +8683,20 @@ static void highbd_inv_txfm_add_32x32(const tran_low_t *input, uint8_t *dest,
 #if INTRINSIC_OPT_2
     case DCT_DCT:
     case IDTX:
-        av1_inv_txfm2d_add_32x32(src, CONVERT_TO_SHORTPTR(dest), stride, tx_type,
-            bd);
+        av1_inv_txfm2d_add_32x32(src, CONVERT_TO_SHORTPTR(dest), stride,
+            tx_type, txfm_param->tx_size, txfm_param->eob, bd);
         break;
     default:
         assert(0);
 #else
     case DCT_DCT:
-        av1_inv_txfm2d_add_32x32(src, CONVERT_TO_SHORTPTR(dest), stride, tx_type,
-            bd);
+        av1_inv_txfm2d_add_32x32(src, CONVERT_TO_SHORTPTR(dest), stride,
+            tx_type, txfm_param->tx_size, txfm_param->eob, bd);
         break;
         // Assembly version doesn't support IDTX, so use C version for it.
     case IDTX:
         av1_inv_txfm2d_add_32x32_c(src, CONVERT_TO_SHORTPTR(dest), stride,
-            tx_type, bd);
+            tx_type, txfm_param->tx_size, txfm_param->eob, bd);
         break;
 
     default: assert(0);
@@ -8705,7 +8710,8 @@ static void highbd_inv_txfm_add_64x64(const tran_low_t *input, uint8_t *dest,
     const TxType tx_type = txfm_param->tx_type;
     const int32_t *src = cast_to_int32(input);
     assert(tx_type == DCT_DCT);
-    av1_inv_txfm2d_add_64x64(src, CONVERT_TO_SHORTPTR(dest), stride, tx_type, bd);
+    av1_inv_txfm2d_add_64x64(src, CONVERT_TO_SHORTPTR(dest), stride,
+        tx_type, txfm_param->tx_size, txfm_param->eob, bd);
 }
 
 static void highbd_inv_txfm_add_4x8(const tran_low_t *input, uint8_t *dest,
@@ -15,11 +15,12 @@
 #include <math.h>
 #include <assert.h>
 #include "EbWarpedMotion.h"
+#include "aom_dsp_rtcd.h"
 
 #define WARP_ERROR_BLOCK 32
 
 /* clang-format off */
-static const int error_measure_lut[512] = {
+const int error_measure_lut[512] = {
   // pow 0.7
   16384, 16339, 16294, 16249, 16204, 16158, 16113, 16068,
   16022, 15977, 15932, 15886, 15840, 15795, 15749, 15703,
@@ -529,15 +530,15 @@ static void highbd_warp_plane(EbWarpedMotionParams *wm, const uint8_t *const ref
 
   const uint16_t *const ref = CONVERT_TO_SHORTPTR(ref8);
   uint16_t *pred = CONVERT_TO_SHORTPTR(pred8);
-  av1_highbd_warp_affine_c(mat, ref, width, height, stride, pred, p_col, p_row,
+  av1_highbd_warp_affine(mat, ref, width, height, stride, pred, p_col, p_row,
                          p_width, p_height, p_stride, subsampling_x,
                          subsampling_y, bd, conv_params, alpha, beta, gamma,
                          delta);
 }
 
-static int64_t highbd_frame_error(const uint16_t *const ref, int stride,
-                                  const uint16_t *const dst, int p_width,
-                                  int p_height, int p_stride, int bd) {
+int64_t av1_calc_highbd_frame_error_c(const uint16_t *const ref, int stride,
+                                      const uint16_t *const dst, int p_width,
+                                      int p_height, int p_stride, int bd) {
   int64_t sum_error = 0;
   for (int i = 0; i < p_height; ++i) {
     for (int j = 0; j < p_width; ++j) {
@@ -571,7 +572,7 @@ static int64_t highbd_warp_error(
                         WARP_ERROR_BLOCK, subsampling_x, subsampling_y, bd,
                         &conv_params);
 
-      gm_sumerr += highbd_frame_error(
+      gm_sumerr += av1_calc_highbd_frame_error(
           tmp, WARP_ERROR_BLOCK, CONVERT_TO_SHORTPTR(dst8) + j + i * p_stride,
           warp_w, warp_h, p_stride, bd);
       if (gm_sumerr > best_error) return gm_sumerr;
@@ -812,14 +813,14 @@ static void warp_plane(EbWarpedMotionParams *wm, const uint8_t *const ref,
   const int16_t beta = wm->beta;
   const int16_t gamma = wm->gamma;
   const int16_t delta = wm->delta;
-  av1_warp_affine_c(mat, ref, width, height, stride, pred, p_col, p_row, p_width,
+  av1_warp_affine(mat, ref, width, height, stride, pred, p_col, p_row, p_width,
                   p_height, p_stride, subsampling_x, subsampling_y, conv_params,
                   alpha, beta, gamma, delta);
 }
 
-static int64_t frame_error(const uint8_t *const ref, int stride,
-                           const uint8_t *const dst, int p_width, int p_height,
-                           int p_stride) {
+int64_t av1_calc_frame_error_c(const uint8_t *const ref, int stride,
+                               const uint8_t *const dst, int p_width,
+                               int p_height, int p_stride) {
   int64_t sum_error = 0;
   for (int i = 0; i < p_height; ++i) {
     for (int j = 0; j < p_width; ++j) {
@@ -853,8 +854,9 @@ static int64_t warp_error(EbWarpedMotionParams *wm, const uint8_t *const ref,
       warp_plane(wm, ref, width, height, stride, tmp, j, i, warp_w, warp_h,
                  WARP_ERROR_BLOCK, subsampling_x, subsampling_y, &conv_params);
 
-      gm_sumerr += frame_error(tmp, WARP_ERROR_BLOCK, dst + j + i * p_stride,
-                               warp_w, warp_h, p_stride);
+      gm_sumerr += av1_calc_frame_error(tmp, WARP_ERROR_BLOCK,
+                                        dst + j + i * p_stride, warp_w, warp_h,
+                                        p_stride);
       if (gm_sumerr > best_error) return gm_sumerr;
     }
   }
@@ -864,11 +866,11 @@ static int64_t warp_error(EbWarpedMotionParams *wm, const uint8_t *const ref,
 int64_t av1_frame_error(int use_hbd, int bd, const uint8_t *ref, int stride,
                         uint8_t *dst, int p_width, int p_height, int p_stride) {
   if (use_hbd) {
-    return highbd_frame_error(CONVERT_TO_SHORTPTR(ref), stride,
-                              CONVERT_TO_SHORTPTR(dst), p_width, p_height,
-                              p_stride, bd);
+    return av1_calc_highbd_frame_error(CONVERT_TO_SHORTPTR(ref), stride,
+                                       CONVERT_TO_SHORTPTR(dst), p_width,
+                                       p_height, p_stride, bd);
   }
-  return frame_error(ref, stride, dst, p_width, p_height, p_stride);
+  return av1_calc_frame_error(ref, stride, dst, p_width, p_height, p_stride);
 }
 
 int64_t av1_warp_error(EbWarpedMotionParams *wm, int use_hbd, int bd,
@@ -929,7 +931,7 @@ void av1_warp_plane_hbd(
   const int16_t gamma = wm->gamma;
   const int16_t delta = wm->delta;
 
-  av1_highbd_warp_affine_c(
+  av1_highbd_warp_affine(
       mat,
       ref,
       width,
@@ -0,0 +1,97 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "EbWorkerPool.h"
+#include "EbThreads.h"
+
+EbErrorType worker_pool_ctor(
+    WorkerPool_t **pool_dbl_ptr,
+    uint32_t       thread_count)
+{
+    WorkerPool_t *pool_ptr;
+
+    EB_MALLOC(WorkerPool_t*, pool_ptr, sizeof(WorkerPool_t), EB_N_PTR);
+    *pool_dbl_ptr = pool_ptr;
+
+    memset(pool_ptr, 0, sizeof(WorkerPool_t));
+    pool_ptr->thread_count = thread_count;
+    EB_CREATESEMAPHORE(EbHandle, pool_ptr->task_semaphore, sizeof(EbHandle), EB_SEMAPHORE, 0, WORKER_POOL_QUEUE_SIZE);
+    EB_CREATEMUTEX(EbHandle, pool_ptr->queue_mutex, sizeof(EbHandle), EB_MUTEX);
+
+    return EB_ErrorNone;
+}
+
+static WorkerTask_t *worker_pool_pop(
+    WorkerPool_t *pool_ptr)
+{
+    WorkerTask_t *task_ptr = (WorkerTask_t*)EB_NULL;
+
+    eb_block_on_mutex(pool_ptr->queue_mutex);
+    if (pool_ptr->queue_count) {
+        task_ptr = pool_ptr->queue[pool_ptr->queue_head];
+        pool_ptr->queue_head = (pool_ptr->queue_head + 1) % WORKER_POOL_QUEUE_SIZE;
+        pool_ptr->queue_count--;
+    }
+    eb_release_mutex(pool_ptr->queue_mutex);
+
+    return task_ptr;
+}
+
+void *worker_pool_kernel(void *input_ptr)
+{
+    WorkerPool_t *pool_ptr = (WorkerPool_t*)input_ptr;
+    WorkerTask_t *task_ptr;
+
+    for (;;) {
+        eb_block_on_semaphore(pool_ptr->task_semaphore);
+        task_ptr = worker_pool_pop(pool_ptr);
+        // The caller may already have taken the task back
+        if (task_ptr) {
+            task_ptr->run(task_ptr->context_ptr);
+            eb_post_semaphore(task_ptr->done_semaphore);
+        }
+    }
+    return EB_NULL;
+}
+
+void worker_pool_run(
+    WorkerPool_t *pool_ptr,
+    WorkerTask_t *tasks,
+    uint32_t      task_count)
+{
+    WorkerTask_t *task_ptr;
+    uint32_t      queued = 0;
+    uint32_t      task_index;
+
+    if (pool_ptr && task_count > 1) {
+        eb_block_on_mutex(pool_ptr->queue_mutex);
+        for (task_index = 1; task_index < task_count && pool_ptr->queue_count < WORKER_POOL_QUEUE_SIZE; ++task_index, ++queued) {
+            pool_ptr->queue[(pool_ptr->queue_head + pool_ptr->queue_count) % WORKER_POOL_QUEUE_SIZE] = &tasks[task_index];
+            pool_ptr->queue_count++;
+        }
+        eb_release_mutex(pool_ptr->queue_mutex);
+        for (task_index = 0; task_index < queued; ++task_index)
+            eb_post_semaphore(pool_ptr->task_semaphore);
+    }
+
+    tasks[0].run(tasks[0].context_ptr);
+
+    // Help with the queue before running the tasks that did not fit in it, so a
+    // task that waits on the task before it only ever waits on a started task
+    if (queued) {
+        while ((task_ptr = worker_pool_pop(pool_ptr)) != EB_NULL) {
+            task_ptr->run(task_ptr->context_ptr);
+            eb_post_semaphore(task_ptr->done_semaphore);
+        }
+    }
+    for (task_index = queued + 1; task_index < task_count; ++task_index)
+        tasks[task_index].run(tasks[task_index].context_ptr);
+
+    for (task_index = 0; task_index < queued; ++task_index)
+        eb_block_on_semaphore(tasks[0].done_semaphore);
+}
@@ -0,0 +1,61 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#ifndef EbWorkerPool_h
+#define EbWorkerPool_h
+
+#include "EbDefinitions.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define WORKER_POOL_QUEUE_SIZE          256
+
+    /**************************************
+     * Worker Task
+     *   A piece of a kernel's work that may run on another thread. The tasks of
+     *   one worker_pool_run() call share the done semaphore.
+     **************************************/
+    typedef struct WorkerTask_s {
+        void                           (*run)(void *context_ptr);
+        void                            *context_ptr;
+        EbHandle                         done_semaphore;
+    } WorkerTask_t;
+
+    /**************************************
+     * Worker Pool
+     *   Threads shared by the kernels that split a picture in bands (film grain
+     *   denoising, loop filter level search). Tasks are taken in FIFO order, so
+     *   a task may wait on a task that comes before it in the same run.
+     **************************************/
+    typedef struct WorkerPool_s {
+        EbHandle                         task_semaphore;
+        EbHandle                         queue_mutex;
+        WorkerTask_t                    *queue[WORKER_POOL_QUEUE_SIZE];
+        uint32_t                         queue_head;
+        uint32_t                         queue_count;
+        uint32_t                         thread_count;
+    } WorkerPool_t;
+
+    // thread_count threads running worker_pool_kernel must be started on the pool
+    extern EbErrorType worker_pool_ctor(
+        WorkerPool_t                   **pool_dbl_ptr,
+        uint32_t                         thread_count);
+
+    extern void *worker_pool_kernel(void *input_ptr);
+
+    // Runs every task and returns when they are all done. Tasks 1.. are queued,
+    // the calling thread runs task 0 and then helps with whatever is still queued.
+    // task_count must not exceed the done semaphore's maximum count.
+    // With a NULL pool the tasks run in order on the calling thread.
+    extern void worker_pool_run(
+        WorkerPool_t                    *pool_ptr,
+        WorkerTask_t                    *tasks,
+        uint32_t                         task_count);
+
+#ifdef __cplusplus
+}
+#endif
+#endif // EbWorkerPool_h
@@ -49,6 +49,7 @@ extern "C" {
     //to not include convolve.h, just forward declare what's needed.
     struct ConvolveParams;
     struct InterpFilterParams;
+    struct LV_MAP_COEFF_COST;
 
     void apply_selfguided_restoration_c(const uint8_t *dat, int32_t width, int32_t height, int32_t stride, int32_t eps, const int32_t *xqd, uint8_t *dst, int32_t dst_stride, int32_t *tmpbuf, int32_t bit_depth, int32_t highbd);
     void apply_selfguided_restoration_avx2(const uint8_t *dat, int32_t width, int32_t height, int32_t stride, int32_t eps, const int32_t *xqd, uint8_t *dst, int32_t dst_stride, int32_t *tmpbuf, int32_t bit_depth, int32_t highbd);
@@ -74,6 +75,26 @@ extern "C" {
         int32_t dgd_stride, int32_t *flt0, int32_t *flt1, int32_t flt_stride,
         int32_t sgr_params_idx, int32_t bit_depth, int32_t highbd);
 
+    void av1_selfguided_integral_images_c(const uint8_t *dgd8, int32_t width, int32_t height,
+        int32_t dgd_stride, int32_t *ii_sum, int32_t *ii_sq, int32_t ii_stride, int32_t highbd);
+    void av1_selfguided_integral_images_avx2(const uint8_t *dgd8, int32_t width, int32_t height,
+        int32_t dgd_stride, int32_t *ii_sum, int32_t *ii_sq, int32_t ii_stride, int32_t highbd);
+    RTCD_EXTERN void(*av1_selfguided_integral_images)(const uint8_t *dgd8, int32_t width, int32_t height,
+        int32_t dgd_stride, int32_t *ii_sum, int32_t *ii_sq, int32_t ii_stride, int32_t highbd);
+
+    void av1_selfguided_restoration_from_ii_c(const uint8_t *dgd8, int32_t width, int32_t height,
+        int32_t dgd_stride, const int32_t *ii_sum, const int32_t *ii_sq, int32_t ii_stride,
+        int32_t *flt0, int32_t *flt1, int32_t flt_stride,
+        int32_t sgr_params_idx, int32_t bit_depth, int32_t highbd);
+    void av1_selfguided_restoration_from_ii_avx2(const uint8_t *dgd8, int32_t width, int32_t height,
+        int32_t dgd_stride, const int32_t *ii_sum, const int32_t *ii_sq, int32_t ii_stride,
+        int32_t *flt0, int32_t *flt1, int32_t flt_stride,
+        int32_t sgr_params_idx, int32_t bit_depth, int32_t highbd);
+    RTCD_EXTERN void(*av1_selfguided_restoration_from_ii)(const uint8_t *dgd8, int32_t width, int32_t height,
+        int32_t dgd_stride, const int32_t *ii_sum, const int32_t *ii_sq, int32_t ii_stride,
+        int32_t *flt0, int32_t *flt1, int32_t flt_stride,
+        int32_t sgr_params_idx, int32_t bit_depth, int32_t highbd);
+
 
     int32_t cdef_find_dir_c(const uint16_t *img, int32_t stride, int32_t *var, int32_t coeff_shift);
     int32_t cdef_find_dir_avx2(const uint16_t *img, int32_t stride, int32_t *var, int32_t coeff_shift);
@@ -83,6 +104,10 @@ extern "C" {
     void cdef_filter_block_avx2(uint8_t *dst8, uint16_t *dst16, int32_t dstride, const uint16_t *in, int32_t pri_strength, int32_t sec_strength, int32_t dir, int32_t pri_damping, int32_t sec_damping, int32_t bsize, int32_t max, int32_t coeff_shift);
     RTCD_EXTERN void(*cdef_filter_block)(uint8_t *dst8, uint16_t *dst16, int32_t dstride, const uint16_t *in, int32_t pri_strength, int32_t sec_strength, int32_t dir, int32_t pri_damping, int32_t sec_damping, int32_t bsize, int32_t max, int32_t coeff_shift);
 
+    void cdef_filter_block_8x8_16_sec4_c(uint16_t *dst, const uint16_t *in, int32_t pri_strength, const int32_t *sec_strength, int32_t dir, int32_t pri_damping, int32_t sec_damping, int32_t coeff_shift);
+    void cdef_filter_block_8x8_16_sec4_avx2(uint16_t *dst, const uint16_t *in, int32_t pri_strength, const int32_t *sec_strength, int32_t dir, int32_t pri_damping, int32_t sec_damping, int32_t coeff_shift);
+    RTCD_EXTERN void(*cdef_filter_block_8x8_16_sec4)(uint16_t *dst, const uint16_t *in, int32_t pri_strength, const int32_t *sec_strength, int32_t dir, int32_t pri_damping, int32_t sec_damping, int32_t coeff_shift);
+
     void copy_rect8_8bit_to_16bit_c(uint16_t *dst, int32_t dstride, const uint8_t *src, int32_t sstride, int32_t v, int32_t h);
     void copy_rect8_8bit_to_16bit_avx2(uint16_t *dst, int32_t dstride, const uint8_t *src, int32_t sstride, int32_t v, int32_t h);
     RTCD_EXTERN void(*copy_rect8_8bit_to_16bit)(uint16_t *dst, int32_t dstride, const uint8_t *src, int32_t sstride, int32_t v, int32_t h);
@@ -292,6 +317,22 @@ extern "C" {
     void av1_convolve_2d_sr_avx2(const uint8_t *src, int32_t src_stride, uint8_t *dst, int32_t dst_stride, int32_t w, int32_t h, InterpFilterParams *filter_params_x, InterpFilterParams *filter_params_y, const int32_t subpel_x_q4, const int32_t subpel_y_q4, ConvolveParams *conv_params);
     RTCD_EXTERN void(*av1_convolve_2d_sr)(const uint8_t *src, int32_t src_stride, uint8_t *dst, int32_t dst_stride, int32_t w, int32_t h, InterpFilterParams *filter_params_x, InterpFilterParams *filter_params_y, const int32_t subpel_x_q4, const int32_t subpel_y_q4, ConvolveParams *conv_params);
 
+    void av1_warp_affine_c(const int32_t *mat, const uint8_t *ref, int width, int height, int stride, uint8_t *pred, int p_col, int p_row, int p_width, int p_height, int p_stride, int subsampling_x, int subsampling_y, ConvolveParams *conv_params, int16_t alpha, int16_t beta, int16_t gamma, int16_t delta);
+    void av1_warp_affine_sse4_1(const int32_t *mat, const uint8_t *ref, int width, int height, int stride, uint8_t *pred, int p_col, int p_row, int p_width, int p_height, int p_stride, int subsampling_x, int subsampling_y, ConvolveParams *conv_params, int16_t alpha, int16_t beta, int16_t gamma, int16_t delta);
+    RTCD_EXTERN void(*av1_warp_affine)(const int32_t *mat, const uint8_t *ref, int width, int height, int stride, uint8_t *pred, int p_col, int p_row, int p_width, int p_height, int p_stride, int subsampling_x, int subsampling_y, ConvolveParams *conv_params, int16_t alpha, int16_t beta, int16_t gamma, int16_t delta);
+
+    void av1_highbd_warp_affine_c(const int32_t *mat, const uint16_t *ref, int width, int height, int stride, uint16_t *pred, int p_col, int p_row, int p_width, int p_height, int p_stride, int subsampling_x, int subsampling_y, int bd, ConvolveParams *conv_params, int16_t alpha, int16_t beta, int16_t gamma, int16_t delta);
+    void av1_highbd_warp_affine_sse4_1(const int32_t *mat, const uint16_t *ref, int width, int height, int stride, uint16_t *pred, int p_col, int p_row, int p_width, int p_height, int p_stride, int subsampling_x, int subsampling_y, int bd, ConvolveParams *conv_params, int16_t alpha, int16_t beta, int16_t gamma, int16_t delta);
+    RTCD_EXTERN void(*av1_highbd_warp_affine)(const int32_t *mat, const uint16_t *ref, int width, int height, int stride, uint16_t *pred, int p_col, int p_row, int p_width, int p_height, int p_stride, int subsampling_x, int subsampling_y, int bd, ConvolveParams *conv_params, int16_t alpha, int16_t beta, int16_t gamma, int16_t delta);
+
+    int64_t av1_calc_frame_error_c(const uint8_t *const ref, int stride, const uint8_t *const dst, int p_width, int p_height, int p_stride);
+    int64_t av1_calc_frame_error_avx2(const uint8_t *const ref, int stride, const uint8_t *const dst, int p_width, int p_height, int p_stride);
+    RTCD_EXTERN int64_t(*av1_calc_frame_error)(const uint8_t *const ref, int stride, const uint8_t *const dst, int p_width, int p_height, int p_stride);
+
+    int64_t av1_calc_highbd_frame_error_c(const uint16_t *const ref, int stride, const uint16_t *const dst, int p_width, int p_height, int p_stride, int bd);
+    int64_t av1_calc_highbd_frame_error_avx2(const uint16_t *const ref, int stride, const uint16_t *const dst, int p_width, int p_height, int p_stride, int bd);
+    RTCD_EXTERN int64_t(*av1_calc_highbd_frame_error)(const uint16_t *const ref, int stride, const uint16_t *const dst, int p_width, int p_height, int p_stride, int bd);
+
     void av1_jnt_convolve_2d_copy_c(const uint8_t *src, int32_t src_stride, uint8_t *dst, int32_t dst_stride, int32_t w, int32_t h, InterpFilterParams *filter_params_x, InterpFilterParams *filter_params_y, const int32_t subpel_x_q4, const int32_t subpel_y_q4, ConvolveParams *conv_params);
     void av1_jnt_convolve_2d_copy_avx2(const uint8_t *src, int32_t src_stride, uint8_t *dst, int32_t dst_stride, int32_t w, int32_t h, InterpFilterParams *filter_params_x, InterpFilterParams *filter_params_y, const int32_t subpel_x_q4, const int32_t subpel_y_q4, ConvolveParams *conv_params);
     RTCD_EXTERN void(*av1_jnt_convolve_2d_copy)(const uint8_t *src, int32_t src_stride, uint8_t *dst, int32_t dst_stride, int32_t w, int32_t h, InterpFilterParams *filter_params_x, InterpFilterParams *filter_params_y, const int32_t subpel_x_q4, const int32_t subpel_y_q4, ConvolveParams *conv_params);
@@ -349,23 +390,24 @@ extern "C" {
     void av1_inv_txfm2d_add_4x4_avx2(const int32_t *input, uint16_t *output, int32_t stride, TxType tx_type, int32_t bd);
     RTCD_EXTERN void(*av1_inv_txfm2d_add_4x4)(const int32_t *input, uint16_t *output, int32_t stride, TxType tx_type, int32_t bd);
 
-    void av1_inv_txfm2d_add_8x8_c(const int32_t *input, uint16_t *output, int32_t stride, TxType tx_type, int32_t bd);
-    void av1_inv_txfm2d_add_8x8_sse4_1(const int32_t *input, uint16_t *output, int32_t stride, TxType tx_type, int32_t bd);
-    void av1_inv_txfm2d_add_8x8_avx2(const int32_t *input, uint16_t *output, int32_t stride, TxType tx_type, int32_t bd);
-    RTCD_EXTERN void(*av1_inv_txfm2d_add_8x8)(const int32_t *input, uint16_t *output, int32_t stride, TxType tx_type, int32_t bd);
+    void av1_inv_txfm2d_add_8x8_c(const int32_t *input, uint16_t *output, int32_t stride, TxType tx_type, TxSize tx_size, int32_t eob, int32_t bd);
+    void av1_inv_txfm2d_add_8x8_sse4_1(const int32_t *input, uint16_t *output, int32_t stride, TxType tx_type, TxSize tx_size, int32_t eob, int32_t bd);
+    void av1_inv_txfm2d_add_8x8_avx2(const int32_t *input, uint16_t *output, int32_t stride, TxType tx_type, TxSize tx_size, int32_t eob, int32_t bd);
+    RTCD_EXTERN void(*av1_inv_txfm2d_add_8x8)(const int32_t *input, uint16_t *output, int32_t stride, TxType tx_type, TxSize tx_size, int32_t eob, int32_t bd);
 
-    void av1_inv_txfm2d_add_16x16_c(const int32_t *input, uint16_t *output, int32_t stride, TxType tx_type, int32_t bd);
-    void av1_inv_txfm2d_add_16x16_sse4_1(const int32_t *input, uint16_t *output, int32_t stride, TxType tx_type, int32_t bd);
-    void av1_inv_txfm2d_add_16x16_avx2(const int32_t *input, uint16_t *output, int32_t stride, TxType tx_type, int32_t bd);
-    RTCD_EXTERN void(*av1_inv_txfm2d_add_16x16)(const int32_t *input, uint16_t *output, int32_t stride, TxType tx_type, int32_t bd);
+    void av1_inv_txfm2d_add_16x16_c(const int32_t *input, uint16_t *output, int32_t stride, TxType tx_type, TxSize tx_size, int32_t eob, int32_t bd);
+    void av1_inv_txfm2d_add_16x16_sse4_1(const int32_t *input, uint16_t *output, int32_t stride, TxType tx_type, TxSize tx_size, int32_t eob, int32_t bd);
+    void av1_inv_txfm2d_add_16x16_avx2(const int32_t *input, uint16_t *output, int32_t stride, TxType tx_type, TxSize tx_size, int32_t eob, int32_t bd);
+    RTCD_EXTERN void(*av1_inv_txfm2d_add_16x16)(const int32_t *input, uint16_t *output, int32_t stride, TxType tx_type, TxSize tx_size, int32_t eob, int32_t bd);
 
-    void av1_inv_txfm2d_add_32x32_c(const int32_t *input, uint16_t *output, int32_t stride, TxType tx_type, int32_t bd);
-    void av1_inv_txfm2d_add_32x32_avx2(const int32_t *input, uint16_t *output, int32_t stride, TxType tx_type, int32_t bd);
-    RTCD_EXTERN void(*av1_inv_txfm2d_add_32x32)(const int32_t *input, uint16_t *output, int32_t stride, TxType tx_type, int32_t bd);
+    void av1_inv_txfm2d_add_32x32_c(const int32_t *input, uint16_t *output, int32_t stride, TxType tx_type, TxSize tx_size, int32_t eob, int32_t bd);
+    void av1_inv_txfm2d_add_32x32_avx2(const int32_t *input, uint16_t *output, int32_t stride, TxType tx_type, TxSize tx_size, int32_t eob, int32_t bd);
+    RTCD_EXTERN void(*av1_inv_txfm2d_add_32x32)(const int32_t *input, uint16_t *output, int32_t stride, TxType tx_type, TxSize tx_size, int32_t eob, int32_t bd);
 
-    void av1_inv_txfm2d_add_64x64_c(const int32_t *input, uint16_t *output, int32_t stride, TxType tx_type, int32_t bd);
-    void av1_inv_txfm2d_add_64x64_sse4_1(const int32_t *input, uint16_t *output, int32_t stride, TxType tx_type, int32_t bd);
-    RTCD_EXTERN void(*av1_inv_txfm2d_add_64x64)(const int32_t *input, uint16_t *output, int32_t stride, TxType tx_type, int32_t bd);
+    void av1_inv_txfm2d_add_64x64_c(const int32_t *input, uint16_t *output, int32_t stride, TxType tx_type, TxSize tx_size, int32_t eob, int32_t bd);
+    void av1_inv_txfm2d_add_64x64_sse4_1(const int32_t *input, uint16_t *output, int32_t stride, TxType tx_type, TxSize tx_size, int32_t eob, int32_t bd);
+    void av1_inv_txfm2d_add_64x64_avx2(const int32_t *input, uint16_t *output, int32_t stride, TxType tx_type, TxSize tx_size, int32_t eob, int32_t bd);
+    RTCD_EXTERN void(*av1_inv_txfm2d_add_64x64)(const int32_t *input, uint16_t *output, int32_t stride, TxType tx_type, TxSize tx_size, int32_t eob, int32_t bd);
 
 
     void av1_highbd_inv_txfm_add_avx2(const int32_t *input, uint16_t *output, int32_t stride, TxType tx_type, TxSize tx_size, int32_t eob, int32_t bd);
@@ -426,6 +468,10 @@ extern "C" {
     void      aom_highbd_8_mse16x16_sse2(const uint8_t *src_ptr, int32_t  source_stride, const uint8_t *ref_ptr, int32_t  recon_stride, uint32_t *sse);
     RTCD_EXTERN void(*aom_highbd_8_mse16x16)(const uint8_t *src_ptr, int32_t  source_stride, const uint8_t *ref_ptr, int32_t  recon_stride, uint32_t *sse);
 
+    void aom_ssim_parms_8x8_c(const uint8_t *s, int32_t sp, const uint8_t *r, int32_t rp, uint32_t *sum_s, uint32_t *sum_r, uint32_t *sum_sq_s, uint32_t *sum_sq_r, uint32_t *sum_sxr);
+    void aom_ssim_parms_8x8_sse2(const uint8_t *s, int32_t sp, const uint8_t *r, int32_t rp, uint32_t *sum_s, uint32_t *sum_r, uint32_t *sum_sq_s, uint32_t *sum_sq_r, uint32_t *sum_sxr);
+    RTCD_EXTERN void(*aom_ssim_parms_8x8)(const uint8_t *s, int32_t sp, const uint8_t *r, int32_t rp, uint32_t *sum_s, uint32_t *sum_r, uint32_t *sum_sq_s, uint32_t *sum_sq_r, uint32_t *sum_sxr);
+
     void av1_upsample_intra_edge_c(uint8_t *p, int32_t sz);
     void av1_upsample_intra_edge_sse4_1(uint8_t *p, int32_t sz);
     RTCD_EXTERN void(*av1_upsample_intra_edge)(uint8_t *p, int32_t sz);
@@ -2375,6 +2421,10 @@ extern "C" {
     void av1_txb_init_levels_avx2(const tran_low_t *const coeff, const int32_t width, const int32_t height, uint8_t *const levels);
     RTCD_EXTERN void(*av1_txb_init_levels)(const tran_low_t *const coeff, const int32_t width, const int32_t height, uint8_t *const levels);
 
+    int32_t av1_cost_coeffs_levels_c(const tran_low_t *const qcoeff, const uint8_t *const levels, const int16_t *const scan, const int8_t *const coeff_contexts, const uint16_t eob, const int32_t bwl, const TX_CLASS tx_class, const int16_t dc_sign_ctx, const struct LV_MAP_COEFF_COST *const txb_costs);
+    int32_t av1_cost_coeffs_levels_avx2(const tran_low_t *const qcoeff, const uint8_t *const levels, const int16_t *const scan, const int8_t *const coeff_contexts, const uint16_t eob, const int32_t bwl, const TX_CLASS tx_class, const int16_t dc_sign_ctx, const struct LV_MAP_COEFF_COST *const txb_costs);
+    RTCD_EXTERN int32_t(*av1_cost_coeffs_levels)(const tran_low_t *const qcoeff, const uint8_t *const levels, const int16_t *const scan, const int8_t *const coeff_contexts, const uint16_t eob, const int32_t bwl, const TX_CLASS tx_class, const int16_t dc_sign_ctx, const struct LV_MAP_COEFF_COST *const txb_costs);
+
 
 
     void aom_dsp_rtcd(void);
@@ -2405,6 +2455,12 @@ extern "C" {
         av1_selfguided_restoration = av1_selfguided_restoration_c;
         if (flags & HAS_AVX2) av1_selfguided_restoration = av1_selfguided_restoration_avx2;
 
+        av1_selfguided_integral_images = av1_selfguided_integral_images_c;
+        if (flags & HAS_AVX2) av1_selfguided_integral_images = av1_selfguided_integral_images_avx2;
+
+        av1_selfguided_restoration_from_ii = av1_selfguided_restoration_from_ii_c;
+        if (flags & HAS_AVX2) av1_selfguided_restoration_from_ii = av1_selfguided_restoration_from_ii_avx2;
+
 
         cdef_find_dir = cdef_find_dir_c;
         if (flags & HAS_AVX2) cdef_find_dir = cdef_find_dir_avx2;
@@ -2412,6 +2468,9 @@ extern "C" {
         cdef_filter_block = cdef_filter_block_c;
         if (flags & HAS_AVX2) cdef_filter_block = cdef_filter_block_avx2;
 
+        cdef_filter_block_8x8_16_sec4 = cdef_filter_block_8x8_16_sec4_c;
+        if (flags & HAS_AVX2) cdef_filter_block_8x8_16_sec4 = cdef_filter_block_8x8_16_sec4_avx2;
+
         copy_rect8_8bit_to_16bit = copy_rect8_8bit_to_16bit_c;
         if (flags & HAS_AVX2) copy_rect8_8bit_to_16bit = copy_rect8_8bit_to_16bit_avx2;
 
@@ -2477,6 +2536,15 @@ extern "C" {
         av1_convolve_2d_sr = av1_convolve_2d_sr_c;
         if (flags & HAS_AVX2) av1_convolve_2d_sr = av1_convolve_2d_sr_avx2;
 
+        av1_warp_affine = av1_warp_affine_c;
+        if (flags & HAS_SSE4_1) av1_warp_affine = av1_warp_affine_sse4_1;
+        av1_highbd_warp_affine = av1_highbd_warp_affine_c;
+        if (flags & HAS_SSE4_1) av1_highbd_warp_affine = av1_highbd_warp_affine_sse4_1;
+        av1_calc_frame_error = av1_calc_frame_error_c;
+        if (flags & HAS_AVX2) av1_calc_frame_error = av1_calc_frame_error_avx2;
+        av1_calc_highbd_frame_error = av1_calc_highbd_frame_error_c;
+        if (flags & HAS_AVX2) av1_calc_highbd_frame_error = av1_calc_highbd_frame_error_avx2;
+
         av1_jnt_convolve_2d_copy = av1_jnt_convolve_2d_copy_c;
         if (flags & HAS_AVX2) av1_jnt_convolve_2d_copy = av1_jnt_convolve_2d_copy_avx2;
 
@@ -2513,6 +2581,7 @@ extern "C" {
         if (flags & HAS_AVX2) av1_inv_txfm2d_add_4x4 = av1_inv_txfm2d_add_4x4_avx2;
         av1_inv_txfm2d_add_64x64 = av1_inv_txfm2d_add_64x64_c;
         if (flags & HAS_SSE4_1) av1_inv_txfm2d_add_64x64 = av1_inv_txfm2d_add_64x64_sse4_1;
+        if (flags & HAS_AVX2) av1_inv_txfm2d_add_64x64 = av1_inv_txfm2d_add_64x64_avx2;
         av1_inv_txfm2d_add_8x8 = av1_inv_txfm2d_add_8x8_c;
         if (flags & HAS_AVX2) av1_inv_txfm2d_add_8x8 = av1_inv_txfm2d_add_8x8_avx2;
 
@@ -2555,6 +2624,9 @@ extern "C" {
         //aom_highbd_8_mse16x16 = aom_highbd_8_mse16x16_c;
         if (flags & HAS_SSE2) aom_highbd_8_mse16x16 = aom_highbd_8_mse16x16_sse2;
 
+        aom_ssim_parms_8x8 = aom_ssim_parms_8x8_c;
+        if (flags & HAS_SSE2) aom_ssim_parms_8x8 = aom_ssim_parms_8x8_sse2;
+
         av1_upsample_intra_edge = av1_upsample_intra_edge_c;
         if (flags & HAS_SSE4_1) av1_upsample_intra_edge = av1_upsample_intra_edge_sse4_1;
 
@@ -2626,6 +2698,8 @@ extern "C" {
 
         av1_txb_init_levels = av1_txb_init_levels_c;
         if (flags & HAS_AVX2) av1_txb_init_levels = av1_txb_init_levels_avx2;
+        av1_cost_coeffs_levels = av1_cost_coeffs_levels_c;
+        if (flags & HAS_AVX2) av1_cost_coeffs_levels = av1_cost_coeffs_levels_avx2;
     aom_paeth_predictor_16x16 = aom_paeth_predictor_16x16_c;
     if (flags & HAS_SSSE3) aom_paeth_predictor_16x16 = aom_paeth_predictor_16x16_ssse3;
     if (flags & HAS_AVX2) aom_paeth_predictor_16x16 = aom_paeth_predictor_16x16_avx2;
@@ -2762,6 +2836,7 @@ extern "C" {
         ResidualKernel = residual_kernel_c;
 
         av1_txb_init_levels = av1_txb_init_levels_c;
+        av1_cost_coeffs_levels = av1_cost_coeffs_levels_c;
 #endif
         aom_dc_predictor_4x4 = aom_dc_predictor_4x4_c;
         if (flags & HAS_SSE2) aom_dc_predictor_4x4 = aom_dc_predictor_4x4_sse2;
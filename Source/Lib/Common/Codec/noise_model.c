@@ -15,6 +15,7 @@
 #include "noise_model.h"
 #include "noise_util.h"
 #include "mathutils.h"
+#include "EbThreads.h"
 
 #define kLowPolyNumParams 3
 
@@ -1360,17 +1361,89 @@ static float *get_half_cos_window(int32_t block_size) {
 DITHER_AND_QUANTIZE(uint8_t, lowbd);
 DITHER_AND_QUANTIZE(uint16_t, highbd);
 
+// One pass of the half-overlapped block processing of a plane. Blocks of the
+// same pass do not overlap, so block rows of a pass can be filtered
+// concurrently and accumulated into result in any order.
+typedef struct DenoisePass {
+    const uint8_t *data;
+    int32_t w;
+    int32_t h;
+    int32_t stride;
+    int32_t block_w;
+    int32_t block_h;
+    int32_t offsx;
+    int32_t offsy;
+    int32_t num_blocks_w;
+    const aom_flat_block_finder_t *block_finder;
+    const float *window_function;
+    const float *noise_psd;
+    int32_t use_chroma_tx;
+    float *result;
+    int32_t result_stride;
+} DenoisePass;
+
+// A band of block rows of the current pass, with its own transform and block
+// buffers.
+typedef struct DenoiseBand {
+    const DenoisePass *pass;
+    int32_t by_start;
+    int32_t by_end;
+    struct aom_noise_tx_t *tx_full;
+    struct aom_noise_tx_t *tx_chroma;
+    float *plane;
+    float *block;
+    double *plane_d;
+    double *block_d;
+} DenoiseBand;
+
+static void denoise_band_run(void *context_ptr) {
+    DenoiseBand *band = (DenoiseBand *)context_ptr;
+    const DenoisePass *pass = band->pass;
+    const int32_t block_w = pass->block_w;
+    const int32_t block_h = pass->block_h;
+    const int32_t pixels_per_block = block_w * block_h;
+    struct aom_noise_tx_t *tx = pass->use_chroma_tx ? band->tx_chroma : band->tx_full;
+    float *block = band->block;
+    float *plane = band->plane;
+
+    // Pad the boundary when processing each block-set.
+    for (int32_t by = band->by_start; by < band->by_end; ++by) {
+        for (int32_t bx = -1; bx < pass->num_blocks_w; ++bx) {
+            aom_flat_block_finder_extract_block(
+                pass->block_finder, pass->data, pass->w, pass->h,
+                pass->stride, bx * block_w + pass->offsx,
+                by * block_h + pass->offsy, band->plane_d, band->block_d);
+            for (int32_t j = 0; j < pixels_per_block; ++j) {
+                block[j] = (float)band->block_d[j];
+                plane[j] = (float)band->plane_d[j];
+            }
+            pointwise_multiply(pass->window_function, block, pixels_per_block);
+            aom_noise_tx_forward(tx, block);
+            aom_noise_tx_filter(tx, pass->noise_psd);
+            aom_noise_tx_inverse(tx, block);
+
+            // Apply window function to the plane approximation (we will apply
+            // it to the sum of plane + block when composing the results).
+            pointwise_multiply(pass->window_function, plane, pixels_per_block);
+
+            for (int32_t y = 0; y < block_h; ++y) {
+                const int32_t y_result = y + (by + 1) * block_h + pass->offsy;
+                for (int32_t x = 0; x < block_w; ++x) {
+                    const int32_t x_result = x + (bx + 1) * block_w + pass->offsx;
+                    pass->result[y_result * pass->result_stride + x_result] +=
+                        (block[y * block_w + x] + plane[y * block_w + x]) *
+                        pass->window_function[y * block_w + x];
+                }
+            }
+        }
+    }
+}
+
 int32_t aom_wiener_denoise_2d(const uint8_t *const data[3], uint8_t *denoised[3],
     int32_t w, int32_t h, int32_t stride[3], int32_t chroma_sub[2],
     float *noise_psd[3], int32_t block_size, int32_t bit_depth,
-    int32_t use_highbd) {
-    float *plane = NULL, *window_full = NULL,
-        *window_chroma = NULL;
-    DECLARE_ALIGNED(32, float, *block);
-    block = NULL;
-    double *block_d = NULL, *plane_d = NULL;
-    struct aom_noise_tx_t *tx_full = NULL;
-    struct aom_noise_tx_t *tx_chroma = NULL;
+    int32_t use_highbd, WorkerPool_t *workers) {
+    float *window_full = NULL, *window_chroma = NULL;
     const int32_t num_blocks_w = (w + block_size - 1) / block_size;
     const int32_t num_blocks_h = (h + block_size - 1) / block_size;
     const int32_t result_stride = (num_blocks_w + 2) * block_size;
@@ -1380,6 +1453,12 @@ int32_t aom_wiener_denoise_2d(const uint8_t *const data[3], uint8_t *denoised[3]
     aom_flat_block_finder_t block_finder_full;
     aom_flat_block_finder_t block_finder_chroma;
     const float kBlockNormalization = (float)((1 << bit_depth) - 1);
+    // Block rows run from -1 to num_blocks_h - 1
+    const int32_t band_count = workers ?
+        AOMMIN((int32_t)workers->thread_count + 1, num_blocks_h + 1) : 1;
+    DenoiseBand *bands = NULL;
+    WorkerTask_t *tasks = NULL;
+    EbHandle done_semaphore = NULL;
     if (chroma_sub[0] != chroma_sub[1]) {
         fprintf(stderr,
             "aom_wiener_denoise_2d doesn't handle different chroma "
@@ -1390,84 +1469,72 @@ int32_t aom_wiener_denoise_2d(const uint8_t *const data[3], uint8_t *denoised[3]
         bit_depth, use_highbd);
     result = (float *)malloc((num_blocks_h + 2) * block_size * result_stride *
         sizeof(*result));
-    plane = (float *)malloc(block_size * block_size * sizeof(*plane));
-    block =
-        (float *)aom_memalign(32, 2 * block_size * block_size * sizeof(*block));
-    block_d = (double *)malloc(block_size * block_size * sizeof(*block_d));
-    plane_d = (double *)malloc(block_size * block_size * sizeof(*plane_d));
     window_full = get_half_cos_window(block_size);
-    tx_full = aom_noise_tx_malloc(block_size);
-
     if (chroma_sub[0] != 0) {
         init_success &= aom_flat_block_finder_init(&block_finder_chroma,
             block_size >> chroma_sub[0],
             bit_depth, use_highbd);
         window_chroma = get_half_cos_window(block_size >> chroma_sub[0]);
-        tx_chroma = aom_noise_tx_malloc(block_size >> chroma_sub[0]);
     }
-    else {
+    else
         window_chroma = window_full;
-        tx_chroma = tx_full;
-    }
 
-    init_success &= (int32_t)((tx_full != NULL) && (tx_chroma != NULL) && (plane != NULL) &&
-        (plane_d != NULL) && (block != NULL) && (block_d != NULL) &&
-        (window_full != NULL) && (window_chroma != NULL) &&
+    bands = (DenoiseBand *)calloc(band_count, sizeof(*bands));
+    tasks = (WorkerTask_t *)calloc(band_count, sizeof(*tasks));
+    if (band_count > 1)
+        done_semaphore = eb_create_semaphore(0, band_count);
+    init_success &= (int32_t)((bands != NULL) && (tasks != NULL) &&
+        (band_count == 1 || done_semaphore != NULL));
+    for (int32_t b = 0; init_success && b < band_count; ++b) {
+        DenoiseBand *band = &bands[b];
+        tasks[b].run = denoise_band_run;
+        tasks[b].context_ptr = band;
+        tasks[b].done_semaphore = done_semaphore;
+        band->plane = (float *)malloc(block_size * block_size * sizeof(*band->plane));
+        band->block =
+            (float *)aom_memalign(32, 2 * block_size * block_size * sizeof(*band->block));
+        band->block_d = (double *)malloc(block_size * block_size * sizeof(*band->block_d));
+        band->plane_d = (double *)malloc(block_size * block_size * sizeof(*band->plane_d));
+        band->tx_full = aom_noise_tx_malloc(block_size);
+        band->tx_chroma = chroma_sub[0] != 0 ?
+            aom_noise_tx_malloc(block_size >> chroma_sub[0]) : band->tx_full;
+        init_success &= (int32_t)((band->tx_full != NULL) && (band->tx_chroma != NULL) &&
+            (band->plane != NULL) && (band->plane_d != NULL) &&
+            (band->block != NULL) && (band->block_d != NULL));
+    }
+
+    init_success &= (int32_t)((window_full != NULL) && (window_chroma != NULL) &&
         (result != NULL));
     for (int32_t c = init_success ? 0 : 3; c < 3; ++c) {
-        float *window_function = c == 0 ? window_full : window_chroma;
-        aom_flat_block_finder_t *block_finder = &block_finder_full;
         const int32_t chroma_sub_h = c > 0 ? chroma_sub[1] : 0;
         const int32_t chroma_sub_w = c > 0 ? chroma_sub[0] : 0;
-        struct aom_noise_tx_t *tx =
-            (c > 0 && chroma_sub[0] > 0) ? tx_chroma : tx_full;
+        DenoisePass pass;
         if (!data[c] || !denoised[c]) continue;
-        if (c > 0 && chroma_sub[0] != 0) {
-            block_finder = &block_finder_chroma;
-        }
+        pass.data = data[c];
+        pass.w = w >> chroma_sub_w;
+        pass.h = h >> chroma_sub_h;
+        pass.stride = stride[c];
+        pass.block_w = block_size >> chroma_sub_w;
+        pass.block_h = block_size >> chroma_sub_h;
+        pass.num_blocks_w = num_blocks_w;
+        pass.block_finder = (c > 0 && chroma_sub[0] != 0) ?
+            &block_finder_chroma : &block_finder_full;
+        pass.window_function = c == 0 ? window_full : window_chroma;
+        pass.noise_psd = noise_psd[c];
+        pass.use_chroma_tx = c > 0 && chroma_sub[0] > 0;
+        pass.result = result;
+        pass.result_stride = result_stride;
         memset(result, 0, sizeof(*result) * result_stride * result_height);
-        // Do overlapped block processing (half overlapped). The block rows can
-        // easily be done in parallel
-        for (int32_t offsy = 0; offsy < (block_size >> chroma_sub_h);
-            offsy += (block_size >> chroma_sub_h) / 2) {
-            for (int32_t offsx = 0; offsx < (block_size >> chroma_sub_w);
-                offsx += (block_size >> chroma_sub_w) / 2) {
-                // Pad the boundary when processing each block-set.
-                for (int32_t by = -1; by < num_blocks_h; ++by) {
-                    for (int32_t bx = -1; bx < num_blocks_w; ++bx) {
-                        const int32_t pixels_per_block =
-                            (block_size >> chroma_sub_w) * (block_size >> chroma_sub_h);
-                        aom_flat_block_finder_extract_block(
-                            block_finder, data[c], w >> chroma_sub_w, h >> chroma_sub_h,
-                            stride[c], bx * (block_size >> chroma_sub_w) + offsx,
-                            by * (block_size >> chroma_sub_h) + offsy, plane_d, block_d);
-                        for (int32_t j = 0; j < pixels_per_block; ++j) {
-                            block[j] = (float)block_d[j];
-                            plane[j] = (float)plane_d[j];
-                        }
-                        pointwise_multiply(window_function, block, pixels_per_block);
-                        aom_noise_tx_forward(tx, block);
-                        aom_noise_tx_filter(tx, noise_psd[c]);
-                        aom_noise_tx_inverse(tx, block);
-
-                        // Apply window function to the plane approximation (we will apply
-                        // it to the sum of plane + block when composing the results).
-                        pointwise_multiply(window_function, plane, pixels_per_block);
-
-                        for (int32_t y = 0; y < (block_size >> chroma_sub_h); ++y) {
-                            const int32_t y_result =
-                                y + (by + 1) * (block_size >> chroma_sub_h) + offsy;
-                            for (int32_t x = 0; x < (block_size >> chroma_sub_w); ++x) {
-                                const int32_t x_result =
-                                    x + (bx + 1) * (block_size >> chroma_sub_w) + offsx;
-                                result[y_result * result_stride + x_result] +=
-                                    (block[y * (block_size >> chroma_sub_w) + x] +
-                                        plane[y * (block_size >> chroma_sub_w) + x]) *
-                                    window_function[y * (block_size >> chroma_sub_w) + x];
-                            }
-                        }
-                    }
+        // Do overlapped block processing (half overlapped). The block rows of
+        // each block-set are split in bands that are filtered in parallel.
+        for (pass.offsy = 0; pass.offsy < pass.block_h; pass.offsy += pass.block_h / 2) {
+            for (pass.offsx = 0; pass.offsx < pass.block_w; pass.offsx += pass.block_w / 2) {
+                for (int32_t b = 0; b < band_count; ++b) {
+                    bands[b].pass = &pass;
+                    bands[b].by_start = -1 + (num_blocks_h + 1) * b / band_count;
+                    bands[b].by_end = -1 + (num_blocks_h + 1) * (b + 1) / band_count;
                 }
+                worker_pool_run(workers, tasks, band_count);
             }
         }
         if (use_highbd) {
@@ -1481,20 +1548,26 @@ int32_t aom_wiener_denoise_2d(const uint8_t *const data[3], uint8_t *denoised[3]
                 block_size, kBlockNormalization);
         }
     }
+    for (int32_t b = 0; bands && b < band_count; ++b) {
+        free(bands[b].plane);
+        aom_free(bands[b].block);
+        free(bands[b].plane_d);
+        free(bands[b].block_d);
+        if (bands[b].tx_chroma != bands[b].tx_full)
+            aom_noise_tx_free(bands[b].tx_chroma);
+        aom_noise_tx_free(bands[b].tx_full);
+    }
+    free(bands);
+    free(tasks);
+    if (done_semaphore)
+        eb_destroy_semaphore(done_semaphore);
     free(result);
-    free(plane);
-    aom_free(block);
-    free(plane_d);
-    free(block_d);
     free(window_full);
 
-    aom_noise_tx_free(tx_full);
-
     aom_flat_block_finder_free(&block_finder_full);
     if (chroma_sub[0] != 0) {
         aom_flat_block_finder_free(&block_finder_chroma);
         free(window_chroma);
-        aom_noise_tx_free(tx_chroma);
     }
     return init_success;
 }
@@ -1743,10 +1816,42 @@ static void unpack_2d_pic(uint8_t *packed[3],
 
 }
 
+// Models the noise left between the noisy and the denoised picture.
+// Returns 1 with the grain in film_grain, 0 when no model fits, -1 on error.
+static int32_t estimate_film_grain(struct aom_denoise_and_model_t *ctx,
+    const uint8_t *const data[3],
+    int32_t w, int32_t h,
+    int32_t strides[3],
+    int32_t chroma_sub_log2[2],
+    aom_film_grain_t *film_grain) {
+
+    aom_flat_block_finder_run(&ctx->flat_block_finder, data[0], w,
+        h, strides[0], ctx->flat_blocks);
+
+    const aom_noise_status_t status = aom_noise_model_update(
+        &ctx->noise_model, data, (const uint8_t *const *)ctx->denoised,
+        w, h, strides, chroma_sub_log2, ctx->flat_blocks,
+        ctx->block_size);
+
+    if (status != AOM_NOISE_STATUS_OK && status != AOM_NOISE_STATUS_DIFFERENT_NOISE_TYPE)
+        return 0;
+
+    aom_noise_model_save_latest(&ctx->noise_model);
+
+    if (!aom_noise_model_get_grain_parameters(&ctx->noise_model, film_grain)) {
+        fprintf(stderr, "Unable to get grain parameters.\n");
+        return -1;
+    }
+    film_grain->apply_grain = 1;
+    return 1;
+}
+
 int32_t aom_denoise_and_model_run(struct aom_denoise_and_model_t *ctx,
     EbPictureBufferDesc_t *sd,
     aom_film_grain_t *film_grain,
     int32_t use_highbd,
+    int32_t estimate_grain,
+    WorkerPool_t *workers,
     EbAsm asm_type) {
 
     const int32_t block_size = ctx->block_size;
@@ -1776,35 +1881,25 @@ int32_t aom_denoise_and_model_run(struct aom_denoise_and_model_t *ctx,
 
     const uint8_t *const data[3] = { raw_data[0], raw_data[1], raw_data[2] };
 
-    aom_flat_block_finder_run(&ctx->flat_block_finder, data[0], sd->width,
-        sd->height, strides[0], ctx->flat_blocks);
-
     if (!aom_wiener_denoise_2d(data, ctx->denoised, sd->width, sd->height,
         strides, chroma_sub_log2, ctx->noise_psd,
-        block_size, ctx->bit_depth, use_highbd)) {
+        block_size, ctx->bit_depth, use_highbd, workers)) {
         fprintf(stderr, "Unable to denoise image\n");
         return 0;
     }
 
-    const aom_noise_status_t status = aom_noise_model_update(
-        &ctx->noise_model, data, (const uint8_t *const *)ctx->denoised,
-        sd->width, sd->height, strides, chroma_sub_log2, ctx->flat_blocks,
-        block_size);
-
-    int32_t have_noise_estimate = 0;
-    if (status == AOM_NOISE_STATUS_OK || status == AOM_NOISE_STATUS_DIFFERENT_NOISE_TYPE) {
-        aom_noise_model_save_latest(&ctx->noise_model);
-        have_noise_estimate = 1;
-    }
-
+    // Without a new estimate the caller reuses the grain of an earlier picture,
+    // so the picture is always replaced by its denoised version.
+    int32_t have_noise_estimate = !estimate_grain;
     film_grain->apply_grain = 0;
-    if (have_noise_estimate) {
-        if (!aom_noise_model_get_grain_parameters(&ctx->noise_model, film_grain)) {
-            fprintf(stderr, "Unable to get grain parameters.\n");
+    if (estimate_grain) {
+        have_noise_estimate = estimate_film_grain(ctx, data, sd->width, sd->height,
+            strides, chroma_sub_log2, film_grain);
+        if (have_noise_estimate < 0)
             return 0;
-        }
-        film_grain->apply_grain = 1;
+    }
 
+    if (have_noise_estimate) {
         if (!use_highbd) {
             memcpy(raw_data[0], ctx->denoised[0],
                 (strides[0] * sd->height) << use_highbd);
@@ -1820,6 +1915,52 @@ int32_t aom_denoise_and_model_run(struct aom_denoise_and_model_t *ctx,
     aom_flat_block_finder_free(&ctx->flat_block_finder);
     aom_noise_model_free(&ctx->noise_model);
     free(ctx->flat_blocks);
+    ctx->flat_blocks = NULL;
 
     return 1;
 }
+
+int32_t aom_denoise_and_model_estimate(struct aom_denoise_and_model_t *ctx,
+    EbPictureBufferDesc_t *noisy_sd,
+    aom_film_grain_t *film_grain,
+    int32_t use_highbd) {
+
+    int32_t chroma_sub_log2[2] = { 1, 1 };  //todo: send chroma subsampling
+    int32_t strides[3] = { noisy_sd->stride_y, noisy_sd->strideCb, noisy_sd->strideCr };
+    const uint32_t luma_offset = noisy_sd->origin_y * noisy_sd->stride_y + noisy_sd->origin_x;
+    const uint32_t cb_offset = noisy_sd->strideCb * (noisy_sd->origin_y >> chroma_sub_log2[0])
+        + (noisy_sd->origin_x >> chroma_sub_log2[1]);
+    const uint32_t cr_offset = noisy_sd->strideCr * (noisy_sd->origin_y >> chroma_sub_log2[0])
+        + (noisy_sd->origin_x >> chroma_sub_log2[1]);
+    uint8_t *raw_data[3];
+
+    film_grain->apply_grain = 0;
+
+    if (!denoise_and_model_realloc_if_necessary(ctx, noisy_sd, use_highbd)) {
+        fprintf(stderr, "Unable to realloc buffers\n");
+        return 0;
+    }
+
+    if (!use_highbd) {  // 8 bits input
+        raw_data[0] = noisy_sd->buffer_y + luma_offset;
+        raw_data[1] = noisy_sd->bufferCb + cb_offset;
+        raw_data[2] = noisy_sd->bufferCr + cr_offset;
+    }
+    else {          // 16 bits packed input
+        raw_data[0] = (uint8_t *)((uint16_t *)noisy_sd->buffer_y + luma_offset);
+        raw_data[1] = (uint8_t *)((uint16_t *)noisy_sd->bufferCb + cb_offset);
+        raw_data[2] = (uint8_t *)((uint16_t *)noisy_sd->bufferCr + cr_offset);
+    }
+
+    const uint8_t *const data[3] = { raw_data[0], raw_data[1], raw_data[2] };
+
+    const int32_t have_noise_estimate = estimate_film_grain(ctx, data,
+        noisy_sd->width, noisy_sd->height, strides, chroma_sub_log2, film_grain);
+
+    aom_flat_block_finder_free(&ctx->flat_block_finder);
+    aom_noise_model_free(&ctx->noise_model);
+    free(ctx->flat_blocks);
+    ctx->flat_blocks = NULL;
+
+    return have_noise_estimate > 0;
+}
@@ -19,6 +19,7 @@ extern "C" {
 #include <stdint.h>
 #include "grainSynthesis.h"
 #include "EbPictureBufferDesc.h"
+#include "EbWorkerPool.h"
 
 #define DENOISING_BlockSize 32
 
@@ -298,11 +299,13 @@ extern "C" {
      * \param[in]     use_highbd      If true, uint8 pointers are interpreted as
      *                                uint16 and stride is measured in uint16.
      *                                This must be true when bit_depth >= 10.
+     * \param[in]     workers         Worker pool sharing the block rows, or NULL
+     *                                to denoise on the calling thread only.
      */
     int32_t aom_wiener_denoise_2d(const uint8_t *const data[3], uint8_t *denoised[3],
         int32_t w, int32_t h, int32_t stride[3], int32_t chroma_sub_log2[2],
         float *noise_psd[3], int32_t block_size, int32_t bit_depth,
-        int32_t use_highbd);
+        int32_t use_highbd, WorkerPool_t *workers);
 
     struct aom_denoise_and_model_t;
 
@@ -319,13 +322,37 @@ extern "C" {
      *                       noise estimate.
      * \param[in/out]   buf  The raw input buffer to be denoised.
      * \param[out]    grain  Output film grain parameters
+     * \param[in] estimate_grain When 0 the buffer is only denoised and grain is
+     *                       left unset, for the caller to reuse the grain of an
+     *                       earlier picture.
+     * \param[in]   workers  Worker pool, may be NULL.
      */
     int32_t aom_denoise_and_model_run(struct aom_denoise_and_model_t *ctx,
         EbPictureBufferDesc_t *sd,
         aom_film_grain_t *film_grain,
         int32_t use_highbd,
+        int32_t estimate_grain,
+        WorkerPool_t *workers,
         EbAsm asm_type);
 
+    /*!\brief Estimate the grain of a picture aom_denoise_and_model_run has
+     * already denoised.
+     *
+     * Models the noise between noisy_sd and the denoised picture the last
+     * aom_denoise_and_model_run call left in ctx, for a picture that was only
+     * denoised there. Returns true when grain was modelled.
+     *
+     * \param[in]      ctx   The context the picture was denoised with.
+     * \param[in] noisy_sd   The picture before the denoise, 16 bit packed when
+     *                       use_highbd is set, with the strides of the
+     *                       denoised picture.
+     * \param[out]    grain  Output film grain parameters
+     */
+    int32_t aom_denoise_and_model_estimate(struct aom_denoise_and_model_t *ctx,
+        EbPictureBufferDesc_t *noisy_sd,
+        aom_film_grain_t *film_grain,
+        int32_t use_highbd);
+
     /*!\brief Allocates a context that can be used for denoising and noise modeling.
      *
      * \param[in]  bit_depth   Bit depth of buffers this will be run on.
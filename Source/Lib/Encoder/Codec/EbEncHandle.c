@@ -98,6 +98,7 @@
 #include "EbDlfProcess.h"
 #include "EbCdefProcess.h"
 #include "EbRestProcess.h"
+#include "EbStatProcess.h"
 
 
 #ifdef _WIN32
@@ -135,11 +136,9 @@
 #define EB_PacketizationProcessInitCount                1
 
 // Output Buffer Transfer Parameters
-#define EB_OUTPUTSTREAMBUFFERSIZE                                       0x2DC6C0   //0x7D00        // match MTU Size
 #define EB_OUTPUTRECONBUFFERSIZE                                        (MAX_PICTURE_WIDTH_SIZE*MAX_PICTURE_HEIGHT_SIZE*2)   // Recon Slice Size
 #define EB_OUTPUTSTATISTICSBUFFERSIZE                                   0x30            // 6X8 (8 Bytes for Y, U, V, number of bits, picture number, QP)
 #define EOS_NAL_BUFFER_SIZE                                             0x0010 // Bitstream used to code EOS NAL
-#define EB_OUTPUTSTREAMBUFFERSIZE_MACRO(ResolutionSize)                ((ResolutionSize) < (INPUT_SIZE_1080i_TH) ? 0x1E8480 : (ResolutionSize) < (INPUT_SIZE_1080p_TH) ? 0x2DC6C0 : (ResolutionSize) < (INPUT_SIZE_4K_TH) ? 0x2DC6C0 : 0x2DC6C0  )
 
 #define ENCDEC_INPUT_PORT_MDC                                0
 #define ENCDEC_INPUT_PORT_ENCDEC                             1
@@ -577,12 +576,22 @@ EbErrorType LoadDefaultBufferConfigurationSettings(
     sequence_control_set_ptr->total_process_init_count += (sequence_control_set_ptr->entropy_coding_process_init_count               = MAX(MIN(3, coreCount), coreCount / 12));
 #endif
 
+    // Picture analysis & source based operations segments: SB rows split over the processes
+    // Film grain denoising works on the whole picture, and splits it over the worker pool
+    uint32_t saSegH = (sequence_control_set_ptr->max_input_luma_height + BLOCK_SIZE_64 - 1) / BLOCK_SIZE_64;
+    sequence_control_set_ptr->pa_segment_row_count  = sequence_control_set_ptr->film_grain_denoise_strength ? 1 : MIN(saSegH, sequence_control_set_ptr->picture_analysis_process_init_count);
+    sequence_control_set_ptr->sbo_segment_row_count = MIN(saSegH, sequence_control_set_ptr->source_based_operations_process_init_count);
+
     sequence_control_set_ptr->total_process_init_count +=(sequence_control_set_ptr->dlf_process_init_count                           = MAX(MIN(40, coreCount), coreCount));
     sequence_control_set_ptr->total_process_init_count +=(sequence_control_set_ptr->cdef_process_init_count                          = MAX(MIN(40, coreCount), coreCount));
     sequence_control_set_ptr->total_process_init_count +=(sequence_control_set_ptr->rest_process_init_count                          = MAX(MIN(40, coreCount), coreCount));
+    // Band workers: film grain denoising, and the frame-based loop filter level search (M0-M4)
+    sequence_control_set_ptr->total_process_init_count +=(sequence_control_set_ptr->worker_pool_process_init_count                   =
+        (sequence_control_set_ptr->film_grain_denoise_strength || (!sequence_control_set_ptr->static_config.disable_dlf_flag && sequence_control_set_ptr->static_config.enc_mode <= ENC_M4)) ? MAX(MIN(8, coreCount), coreCount / 4) : 0);
 
 
     sequence_control_set_ptr->total_process_init_count += 6; // single processes count
+    sequence_control_set_ptr->total_process_init_count += sequence_control_set_ptr->static_config.stat_report ? 1 : 0; // Stat process
     printf("Number of logical cores available: %u\nNumber of PPCS %u\n", coreCount, inputPic);
 
     return return_error;
@@ -684,6 +693,7 @@ static EbErrorType eb_enc_handle_ctor(
     }
     encHandlePtr->memory_map = (EbMemoryMapEntry*)malloc(sizeof(EbMemoryMapEntry) * MAX_NUM_PTR);
     encHandlePtr->memory_map_index = 0;
+    encHandlePtr->sequence_control_set_instance_array = (EbSequenceControlSetInstance**)EB_NULL;
     encHandlePtr->total_lib_memory = sizeof(EbEncHandle_t) + sizeof(EbMemoryMapEntry) * MAX_NUM_PTR;
 
     // Save Memory Map Pointers
@@ -730,6 +740,7 @@ static EbErrorType eb_enc_handle_ctor(
     // Threads
     encHandlePtr->resourceCoordinationThreadHandle = (EbHandle)EB_NULL;
     encHandlePtr->pictureAnalysisThreadHandleArray = (EbHandle*)EB_NULL;
+    encHandlePtr->workerPoolThreadHandleArray = (EbHandle*)EB_NULL;
     encHandlePtr->pictureDecisionThreadHandle = (EbHandle)EB_NULL;
     encHandlePtr->motionEstimationThreadHandleArray = (EbHandle*)EB_NULL;
     encHandlePtr->initialRateControlThreadHandle = (EbHandle)EB_NULL;
@@ -743,6 +754,7 @@ static EbErrorType eb_enc_handle_ctor(
     encHandlePtr->dlfThreadHandleArray = (EbHandle*)EB_NULL;
     encHandlePtr->cdefThreadHandleArray = (EbHandle*)EB_NULL;
     encHandlePtr->restThreadHandleArray = (EbHandle*)EB_NULL;
+    encHandlePtr->statThreadHandle = (EbHandle)EB_NULL;
 
     // Contexts
     encHandlePtr->resourceCoordinationContextPtr = (EbPtr)EB_NULL;
@@ -760,6 +772,7 @@ static EbErrorType eb_enc_handle_ctor(
     encHandlePtr->cdefContextPtrArray = (EbPtr*)EB_NULL;
     encHandlePtr->restContextPtrArray = (EbPtr*)EB_NULL;
     encHandlePtr->packetizationContextPtr = (EbPtr)EB_NULL;
+    encHandlePtr->statContextPtr = (EbPtr)EB_NULL;
 
     // System Resource Managers
     encHandlePtr->input_buffer_resource_ptr = (EbSystemResource*)EB_NULL;
@@ -775,6 +788,7 @@ static EbErrorType eb_enc_handle_ctor(
     encHandlePtr->encDecTasksResourcePtr = (EbSystemResource*)EB_NULL;
     encHandlePtr->encDecResultsResourcePtr = (EbSystemResource*)EB_NULL;
     encHandlePtr->entropyCodingResultsResourcePtr = (EbSystemResource*)EB_NULL;
+    encHandlePtr->statTasksResourcePtr = (EbSystemResource*)EB_NULL;
 
     // Inter-Process Producer Fifos
     encHandlePtr->input_buffer_producer_fifo_ptr_array = (EbFifo**)EB_NULL;
@@ -790,10 +804,12 @@ static EbErrorType eb_enc_handle_ctor(
     encHandlePtr->dlfResultsProducerFifoPtrArray = (EbFifo**)EB_NULL;
     encHandlePtr->cdefResultsProducerFifoPtrArray = (EbFifo**)EB_NULL;
     encHandlePtr->restResultsProducerFifoPtrArray = (EbFifo**)EB_NULL;
+    encHandlePtr->statTasksProducerFifoPtrArray = (EbFifo**)EB_NULL;
 
     encHandlePtr->dlfResultsConsumerFifoPtrArray = (EbFifo**)EB_NULL;
     encHandlePtr->cdefResultsConsumerFifoPtrArray = (EbFifo**)EB_NULL;
     encHandlePtr->restResultsConsumerFifoPtrArray = (EbFifo**)EB_NULL;
+    encHandlePtr->statTasksConsumerFifoPtrArray = (EbFifo**)EB_NULL;
 
     // Inter-Process Consumer Fifos
     encHandlePtr->input_buffer_consumer_fifo_ptr_array = (EbFifo**)EB_NULL;
@@ -817,6 +833,7 @@ static EbErrorType eb_enc_handle_ctor(
 
     // Initialize Sequence Control Set Instance Array
     EB_MALLOC(EbSequenceControlSetInstance**, encHandlePtr->sequence_control_set_instance_array, sizeof(EbSequenceControlSetInstance*) * encHandlePtr->encodeInstanceTotalCount, EB_N_PTR);
+    memset(encHandlePtr->sequence_control_set_instance_array, 0, sizeof(EbSequenceControlSetInstance*) * encHandlePtr->encodeInstanceTotalCount);
 
     for (instance_index = 0; instance_index < encHandlePtr->encodeInstanceTotalCount; ++instance_index) {
         return_error = eb_sequence_control_set_instance_ctor(&encHandlePtr->sequence_control_set_instance_array[instance_index]);
@@ -882,6 +899,20 @@ EbErrorType RestResultsCtor(
     return EB_ErrorNone;
 }
 
+EbErrorType StatTasksCtor(
+    EbPtr *object_dbl_ptr,
+    EbPtr object_init_data_ptr)
+{
+    StatTasks_t *context_ptr;
+    EB_MALLOC(StatTasks_t*, context_ptr, sizeof(StatTasks_t), EB_N_PTR);
+
+    *object_dbl_ptr = (EbPtr)context_ptr;
+
+    (void)object_init_data_ptr;
+
+    return EB_ErrorNone;
+}
+
 void init_fn_ptr(void);
 
 /**********************************
@@ -979,10 +1010,13 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
         inputData.max_depth = encHandlePtr->sequence_control_set_instance_array[instance_index]->sequence_control_set_ptr->max_sb_depth;
         inputData.ten_bit_format = encHandlePtr->sequence_control_set_instance_array[instance_index]->sequence_control_set_ptr->static_config.ten_bit_format;
         inputData.compressed_ten_bit_format = encHandlePtr->sequence_control_set_instance_array[instance_index]->sequence_control_set_ptr->static_config.compressed_ten_bit_format;
+        inputData.native_16bit_pipeline = (uint8_t)encHandlePtr->sequence_control_set_instance_array[instance_index]->sequence_control_set_ptr->static_config.native_16bit_pipeline;
         encHandlePtr->sequence_control_set_instance_array[instance_index]->sequence_control_set_ptr->picture_control_set_pool_init_count += maxLookAheadDistance;
         inputData.enc_mode = encHandlePtr->sequence_control_set_instance_array[instance_index]->sequence_control_set_ptr->static_config.enc_mode;
         inputData.speed_control = (uint8_t)encHandlePtr->sequence_control_set_instance_array[instance_index]->sequence_control_set_ptr->static_config.speed_control_flag;
         inputData.film_grain_noise_level = encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->static_config.film_grain_denoise_strength;
+        inputData.film_grain_update_period = encHandlePtr->sequence_control_set_instance_array[instance_index]->sequence_control_set_ptr->static_config.film_grain_update_period;
+        inputData.stat_report = encHandlePtr->sequence_control_set_instance_array[instance_index]->sequence_control_set_ptr->static_config.stat_report;
         inputData.bit_depth = encHandlePtr->sequence_control_set_instance_array[instance_index]->sequence_control_set_ptr->static_config.encoder_bit_depth;
 
         inputData.ext_block_flag = (uint8_t)encHandlePtr->sequence_control_set_instance_array[instance_index]->sequence_control_set_ptr->static_config.ext_block_flag;
@@ -1038,6 +1072,7 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
         inputData.sb_sz = encHandlePtr->sequence_control_set_instance_array[instance_index]->sequence_control_set_ptr->sb_sz;
         inputData.sb_size_pix = scs_init.sb_size;
         inputData.max_depth = encHandlePtr->sequence_control_set_instance_array[instance_index]->sequence_control_set_ptr->max_sb_depth;
+        inputData.native_16bit_pipeline = (uint8_t)encHandlePtr->sequence_control_set_instance_array[instance_index]->sequence_control_set_ptr->static_config.native_16bit_pipeline;
         return_error = eb_system_resource_ctor(
             &(encHandlePtr->pictureControlSetPoolPtrArray[instance_index]),
             encHandlePtr->sequence_control_set_instance_array[instance_index]->sequence_control_set_ptr->picture_control_set_pool_init_count_child, //EB_PictureControlSetPoolInitCountChild,
@@ -1494,6 +1529,23 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
         }
     }
 
+    // Stat Tasks
+    if (encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->static_config.stat_report) {
+        return_error = eb_system_resource_ctor(
+            &encHandlePtr->statTasksResourcePtr,
+            encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->rest_fifo_init_count,
+            encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->rest_process_init_count,
+            1,
+            &encHandlePtr->statTasksProducerFifoPtrArray,
+            &encHandlePtr->statTasksConsumerFifoPtrArray,
+            EB_TRUE,
+            StatTasksCtor,
+            EB_NULL);
+        if (return_error == EB_ErrorInsufficientResources) {
+            return EB_ErrorInsufficientResources;
+        }
+    }
+
 
     // Entropy Coding Results
     {
@@ -1528,6 +1580,18 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
             encHandlePtr->sequence_control_set_instance_array[instance_index]->encode_context_ptr->recon_output_fifo_ptr      = (encHandlePtr->output_recon_buffer_producer_fifo_ptr_dbl_array[instance_index])[0];
     }
 
+    /************************************
+    * Rate Control Stats
+    ************************************/
+    for (instance_index = 0; instance_index < encHandlePtr->encodeInstanceTotalCount; ++instance_index) {
+        return_error = RcStatsCtor(
+            encHandlePtr->sequence_control_set_instance_array[instance_index]->encode_context_ptr,
+            encHandlePtr->sequence_control_set_instance_array[instance_index]->sequence_control_set_ptr);
+        if (return_error != EB_ErrorNone) {
+            return return_error;
+        }
+    }
+
     /************************************
     * Contexts
     ************************************/
@@ -1575,6 +1639,17 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
         }
     }
 
+    // Worker Pool
+    if (encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->worker_pool_process_init_count) {
+        return_error = worker_pool_ctor(
+            &encHandlePtr->sequence_control_set_instance_array[0]->encode_context_ptr->worker_pool,
+            encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->worker_pool_process_init_count);
+
+        if (return_error == EB_ErrorInsufficientResources) {
+            return EB_ErrorInsufficientResources;
+        }
+    }
+
     // Picture Decision Context
     {
         // Initialize the various Picture types
@@ -1693,7 +1768,9 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
                 //1 +
                     processIndex], // Add port lookup logic here JMJ
             is16bit,
+            (EbBool)encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->static_config.native_16bit_pipeline,
             color_format,
+            encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->static_config.super_block_size,
             encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->max_input_luma_width,
             encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->max_input_luma_height
         );
@@ -1749,6 +1826,7 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
             encHandlePtr->restResultsProducerFifoPtrArray[processIndex],
             encHandlePtr->pictureDemuxResultsProducerFifoPtrArray[
                 /*encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->source_based_operations_process_init_count*/ 1+ processIndex],
+            encHandlePtr->statTasksProducerFifoPtrArray ? encHandlePtr->statTasksProducerFifoPtrArray[processIndex] : (EbFifo*)EB_NULL,
             is16bit,
             color_format,
             encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->max_input_luma_width,
@@ -1761,6 +1839,17 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
     }
 
 
+    // Stat Context
+    if (encHandlePtr->statTasksConsumerFifoPtrArray) {
+        return_error = stat_context_ctor(
+            (StatContext**)&encHandlePtr->statContextPtr,
+            encHandlePtr->statTasksConsumerFifoPtrArray[0]);
+
+        if (return_error == EB_ErrorInsufficientResources) {
+            return EB_ErrorInsufficientResources;
+        }
+    }
+
     // Entropy Coding Contexts
     EB_MALLOC(EbPtr*, encHandlePtr->entropyCodingContextPtrArray, sizeof(EbPtr) * encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->entropy_coding_process_init_count, EB_N_PTR);
 
@@ -1802,6 +1891,15 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
         EB_CREATETHREAD(EbHandle, encHandlePtr->pictureAnalysisThreadHandleArray[processIndex], sizeof(EbHandle), EB_THREAD, picture_analysis_kernel, encHandlePtr->pictureAnalysisContextPtrArray[processIndex]);
     }
 
+    // Worker Pool
+    if (encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->worker_pool_process_init_count) {
+        EB_MALLOC(EbHandle*, encHandlePtr->workerPoolThreadHandleArray, sizeof(EbHandle) * encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->worker_pool_process_init_count, EB_N_PTR);
+
+        for (processIndex = 0; processIndex < encHandlePtr->sequence_control_set_instance_array[0]->sequence_control_set_ptr->worker_pool_process_init_count; ++processIndex) {
+            EB_CREATETHREAD(EbHandle, encHandlePtr->workerPoolThreadHandleArray[processIndex], sizeof(EbHandle), EB_THREAD, worker_pool_kernel, encHandlePtr->sequence_control_set_instance_array[0]->encode_context_ptr->worker_pool);
+        }
+    }
+
     // Picture Decision
     EB_CREATETHREAD(EbHandle, encHandlePtr->pictureDecisionThreadHandle, sizeof(EbHandle), EB_THREAD, picture_decision_kernel, encHandlePtr->pictureDecisionContextPtr);
 
@@ -1874,6 +1972,11 @@ EB_API EbErrorType eb_init_encoder(EbComponentType *svt_enc_component)
     // Packetization
     EB_CREATETHREAD(EbHandle, encHandlePtr->packetizationThreadHandle, sizeof(EbHandle), EB_THREAD, PacketizationKernel, encHandlePtr->packetizationContextPtr);
 
+    // Stat
+    if (encHandlePtr->statContextPtr) {
+        EB_CREATETHREAD(EbHandle, encHandlePtr->statThreadHandle, sizeof(EbHandle), EB_THREAD, stat_kernel, encHandlePtr->statContextPtr);
+    }
+
 
 #if DISPLAY_MEMORY
     EB_MEMORY();
@@ -1897,6 +2000,18 @@ EB_API EbErrorType eb_deinit_encoder(EbComponentType *svt_enc_component)
     EbMemoryMapEntry*   memoryEntry = (EbMemoryMapEntry*)EB_NULL;
 
     if (encHandlePtr) {
+        // Free the pools that grow at runtime, their items are not in the memory map
+        if (encHandlePtr->sequence_control_set_instance_array) {
+            for (uint32_t instance_index = 0; instance_index < encHandlePtr->encodeInstanceTotalCount; ++instance_index) {
+                EbSequenceControlSetInstance *instance_ptr = encHandlePtr->sequence_control_set_instance_array[instance_index];
+                if (instance_ptr == EB_NULL || instance_ptr->encode_context_ptr == EB_NULL)
+                    continue;
+                if (instance_ptr->encode_context_ptr->output_segment_pool)
+                    output_segment_pool_dtor(instance_ptr->encode_context_ptr->output_segment_pool);
+                if (instance_ptr->encode_context_ptr->symbol_chunk_pool)
+                    symbol_chunk_pool_dtor(instance_ptr->encode_context_ptr->symbol_chunk_pool);
+            }
+        }
         if (encHandlePtr->memory_map_index) {
             // Loop through the ptr table and free all malloc'd pointers per channel
             for (ptrIndex = (encHandlePtr->memory_map_index) - 1; ptrIndex >= 0; --ptrIndex) {
@@ -2149,8 +2264,9 @@ void SetParamBasedOnInput(SequenceControlSet *sequence_control_set_ptr)
         sequence_control_set_ptr->luma_width*sequence_control_set_ptr->luma_height);
     sequence_control_set_ptr->static_config.super_block_size       = (sequence_control_set_ptr->static_config.enc_mode <= ENC_M1 && sequence_control_set_ptr->input_resolution >= INPUT_SIZE_1080i_RANGE) ? 128 : 64;
 #if RC
-    sequence_control_set_ptr->static_config.super_block_size = (sequence_control_set_ptr->static_config.rate_control_mode > 1) ? 64 : sequence_control_set_ptr->static_config.super_block_size;
-    sequence_control_set_ptr->static_config.hierarchical_levels = (sequence_control_set_ptr->static_config.rate_control_mode > 1) ? 3 : sequence_control_set_ptr->static_config.hierarchical_levels;
+    // The analysis pass uses the prediction structure of the rate control pass it feeds
+    sequence_control_set_ptr->static_config.super_block_size = (sequence_control_set_ptr->static_config.rate_control_mode > 1 || sequence_control_set_ptr->static_config.rc_firstpass_stats_out) ? 64 : sequence_control_set_ptr->static_config.super_block_size;
+    sequence_control_set_ptr->static_config.hierarchical_levels = (sequence_control_set_ptr->static_config.rate_control_mode > 1 || sequence_control_set_ptr->static_config.rc_firstpass_stats_out) ? 3 : sequence_control_set_ptr->static_config.hierarchical_levels;
 #endif
 }
 
@@ -2263,6 +2379,8 @@ void CopyApiFromApp(
     //Film Grain
     sequence_control_set_ptr->static_config.film_grain_denoise_strength = ((EbSvtAv1EncConfiguration*)pComponentParameterStructure)->film_grain_denoise_strength;
     sequence_control_set_ptr->film_grain_denoise_strength = sequence_control_set_ptr->static_config.film_grain_denoise_strength;
+    sequence_control_set_ptr->static_config.film_grain_update_period = ((EbSvtAv1EncConfiguration*)pComponentParameterStructure)->film_grain_update_period;
+    sequence_control_set_ptr->film_grain_update_period = sequence_control_set_ptr->static_config.film_grain_update_period;
 
     // MD Parameters
     sequence_control_set_ptr->static_config.constrained_intra = ((EbSvtAv1EncConfiguration*)pComponentParameterStructure)->constrained_intra;
@@ -2282,6 +2400,14 @@ void CopyApiFromApp(
     sequence_control_set_ptr->static_config.frame_rate_numerator = ((EbSvtAv1EncConfiguration*)pComponentParameterStructure)->frame_rate_numerator;
 
     sequence_control_set_ptr->static_config.target_bit_rate = ((EbSvtAv1EncConfiguration*)pComponentParameterStructure)->target_bit_rate;
+    sequence_control_set_ptr->static_config.rc_firstpass_stats_out = ((EbSvtAv1EncConfiguration*)pComponentParameterStructure)->rc_firstpass_stats_out;
+    sequence_control_set_ptr->static_config.rc_twopass_stats_in = ((EbSvtAv1EncConfiguration*)pComponentParameterStructure)->rc_twopass_stats_in;
+
+    // The analysis pass only needs the ME and OIS histograms: run it at the fastest preset in CQP
+    if (sequence_control_set_ptr->static_config.rc_firstpass_stats_out) {
+        sequence_control_set_ptr->static_config.enc_mode = MAX_ENC_PRESET;
+        sequence_control_set_ptr->static_config.rate_control_mode = 0;
+    }
 
     sequence_control_set_ptr->static_config.max_qp_allowed = (sequence_control_set_ptr->static_config.rate_control_mode) ?
         ((EbSvtAv1EncConfiguration*)pComponentParameterStructure)->max_qp_allowed :
@@ -2305,6 +2431,7 @@ void CopyApiFromApp(
     sequence_control_set_ptr->subsampling_y = (sequence_control_set_ptr->chroma_format_idc >= EB_YUV422 ? 1 : 2) - 1;
     sequence_control_set_ptr->static_config.ten_bit_format = ((EbSvtAv1EncConfiguration*)pComponentParameterStructure)->ten_bit_format;
     sequence_control_set_ptr->static_config.compressed_ten_bit_format = ((EbSvtAv1EncConfiguration*)pComponentParameterStructure)->compressed_ten_bit_format;
+    sequence_control_set_ptr->static_config.native_16bit_pipeline = ((EbSvtAv1EncConfiguration*)pComponentParameterStructure)->native_16bit_pipeline;
 
     // Thresholds
     sequence_control_set_ptr->static_config.improve_sharpness = ((EbSvtAv1EncConfiguration*)pComponentParameterStructure)->improve_sharpness;
@@ -2318,6 +2445,7 @@ void CopyApiFromApp(
 
     sequence_control_set_ptr->static_config.injector_frame_rate = ((EbSvtAv1EncConfiguration*)pComponentParameterStructure)->injector_frame_rate;
     sequence_control_set_ptr->static_config.speed_control_flag = ((EbSvtAv1EncConfiguration*)pComponentParameterStructure)->speed_control_flag;
+    sequence_control_set_ptr->static_config.deadline_mode = ((EbSvtAv1EncConfiguration*)pComponentParameterStructure)->deadline_mode;
 
     // Buffers - Hardcoded(Cleanup)
     sequence_control_set_ptr->static_config.asm_type = ((EbSvtAv1EncConfiguration*)pComponentParameterStructure)->asm_type;
@@ -2593,7 +2721,7 @@ static EbErrorType VerifySettings(
     }
 #endif
 #if RC
-    if ((config->rate_control_mode == 3|| config->rate_control_mode == 2) && config->look_ahead_distance != (uint32_t)config->intra_period_length) {
+    if ((config->rate_control_mode == 3 || (config->rate_control_mode == 2 && config->rc_twopass_stats_in.buf == NULL)) && config->look_ahead_distance != (uint32_t)config->intra_period_length) {
         SVT_LOG("Error Instance %u: The rate control mode 2/3 LAD must be equal to intra_period \n", channelNumber + 1);
         return_error = EB_ErrorBadParameter;
     }
@@ -2668,17 +2796,83 @@ static EbErrorType VerifySettings(
         return_error = EB_ErrorBadParameter;
     }
 
+    if (config->native_16bit_pipeline > 1) {
+        SVT_LOG("Error Instance %u: Invalid native_16bit_pipeline [0 - 1], your input: %u\n", channelNumber + 1, config->native_16bit_pipeline);
+        return_error = EB_ErrorBadParameter;
+    }
+
+    if (config->native_16bit_pipeline && config->encoder_bit_depth == EB_8BIT) {
+        SVT_LOG("Error Instance %u: The native 16 bit pipeline requires a bit depth above 8\n", channelNumber + 1);
+        return_error = EB_ErrorBadParameter;
+    }
+
+    if (config->native_16bit_pipeline && config->compressed_ten_bit_format) {
+        SVT_LOG("Error Instance %u: The native 16 bit pipeline requires the unpacked 16 bit input, not the compressed ten bit format\n", channelNumber + 1);
+        return_error = EB_ErrorBadParameter;
+    }
+
+    // The film grain denoising works on the split 8 bit and 2 bit planes
+    if (config->native_16bit_pipeline && config->film_grain_denoise_strength) {
+        SVT_LOG("Error Instance %u: The native 16 bit pipeline does not support film grain\n", channelNumber + 1);
+        return_error = EB_ErrorBadParameter;
+    }
+
     if (config->speed_control_flag > 1) {
         SVT_LOG("Error Instance %u: Invalid Speed Control flag [0 - 1]\n", channelNumber + 1);
         return_error = EB_ErrorBadParameter;
     }
 
+    if (config->deadline_mode > 1) {
+        SVT_LOG("Error Instance %u: Invalid Deadline mode flag [0 - 1]\n", channelNumber + 1);
+        return_error = EB_ErrorBadParameter;
+    }
+
+    if (config->deadline_mode && config->speed_control_flag) {
+        SVT_LOG("Error Instance %u: Deadline mode and Speed Control cannot be used together\n", channelNumber + 1);
+        return_error = EB_ErrorBadParameter;
+    }
+
+    if (config->rc_firstpass_stats_out > 1) {
+        SVT_LOG("Error Instance %u: Invalid RcFirstPassStatsOut flag [0 - 1], your input: %d\n", channelNumber + 1, config->rc_firstpass_stats_out);
+        return_error = EB_ErrorBadParameter;
+    }
+
+    if (config->rc_firstpass_stats_out && config->frames_to_be_encoded == 0) {
+        SVT_LOG("Error Instance %u: The analysis pass requires the number of frames to be encoded\n", channelNumber + 1);
+        return_error = EB_ErrorBadParameter;
+    }
+
+    if (config->rc_twopass_stats_in.buf && (config->rate_control_mode != 2 || config->rc_firstpass_stats_out)) {
+        SVT_LOG("Error Instance %u: The analysis pass stats can only be used with rate control mode 2\n", channelNumber + 1);
+        return_error = EB_ErrorBadParameter;
+    }
+
     if (((int32_t)(config->asm_type) < -1) || ((int32_t)(config->asm_type) != 1)) {
        // SVT_LOG("Error Instance %u: Invalid asm type value [0: C Only, 1: Auto] .\n", channelNumber + 1);
         SVT_LOG("Error Instance %u: Asm 0 is not supported in this build .\n", channelNumber + 1);
         return_error = EB_ErrorBadParameter;
     }
 
+    if (config->stat_report > 2) {
+        SVT_LOG("Error Instance %u: Invalid stat_report [0 - 2], your input: %u\n", channelNumber + 1, config->stat_report);
+        return_error = EB_ErrorBadParameter;
+    }
+
+    if (config->film_grain_denoise_strength > 50) {
+        SVT_LOG("Error Instance %u: Invalid film_grain_denoise_strength [0 - 50], your input: %u\n", channelNumber + 1, config->film_grain_denoise_strength);
+        return_error = EB_ErrorBadParameter;
+    }
+
+    if (config->film_grain_update_period > 255) {
+        SVT_LOG("Error Instance %u: Invalid film_grain_update_period [0 - 255], your input: %u\n", channelNumber + 1, config->film_grain_update_period);
+        return_error = EB_ErrorBadParameter;
+    }
+
+    if (config->recon_enabled > 2) {
+        SVT_LOG("Error Instance %u: Invalid recon_enabled [0 - 2], your input: %u\n", channelNumber + 1, config->recon_enabled);
+        return_error = EB_ErrorBadParameter;
+    }
+
     if (config->target_socket != -1 && config->target_socket != 0 && config->target_socket != 1) {
         SVT_LOG("Error instance %u: Invalid target_socket. target_socket must be [-1 - 1] \n", channelNumber + 1);
         return_error = EB_ErrorBadParameter;
@@ -2706,6 +2900,7 @@ EbErrorType eb_svt_enc_init_parameter(
     config_ptr->encoder_bit_depth = 8;
     config_ptr->ten_bit_format = 0;
     config_ptr->compressed_ten_bit_format = 0;
+    config_ptr->native_16bit_pipeline = 0;
     config_ptr->source_width = 0;
     config_ptr->source_height = 0;
     config_ptr->frames_to_be_encoded = 0;
@@ -2719,6 +2914,9 @@ EbErrorType eb_svt_enc_init_parameter(
     config_ptr->rate_control_mode = 0;
     config_ptr->look_ahead_distance = (uint32_t)~0;
     config_ptr->target_bit_rate = 7000000;
+    config_ptr->rc_firstpass_stats_out = 0;
+    config_ptr->rc_twopass_stats_in.buf = NULL;
+    config_ptr->rc_twopass_stats_in.sz = 0;
     config_ptr->max_qp_allowed = 63;
 #if RC
     config_ptr->min_qp_allowed = 10;
@@ -2775,6 +2973,7 @@ EbErrorType eb_svt_enc_init_parameter(
     // Latency
     config_ptr->injector_frame_rate = 60 << 16;
     config_ptr->speed_control_flag = 0;
+    config_ptr->deadline_mode = 0;
     config_ptr->super_block_size = 128;
 
     config_ptr->sb_sz = 64;
@@ -2782,6 +2981,7 @@ EbErrorType eb_svt_enc_init_parameter(
     //config_ptr->latency_mode = 0;
     config_ptr->speed_control_flag = 0;
     config_ptr->film_grain_denoise_strength = 0;
+    config_ptr->film_grain_update_period = 0;
 
     // ASM Type
     config_ptr->asm_type = 1;
@@ -3092,6 +3292,39 @@ static EbErrorType CopyFrameBuffer(
         }
 
     }
+    else if (config->native_16bit_pipeline) { // 10bit unpacked, kept in 16bit
+
+        uint32_t lumaBufferOffset = (input_picture_ptr->stride_y*sequence_control_set_ptr->top_padding + sequence_control_set_ptr->left_padding);
+        uint32_t chromaBufferOffset = (input_picture_ptr->strideCr*(sequence_control_set_ptr->top_padding >> 1) + (sequence_control_set_ptr->left_padding >> 1));
+        uint16_t lumaWidth = (uint16_t)(input_picture_ptr->width - sequence_control_set_ptr->max_input_pad_right);
+        uint16_t chromaWidth = (lumaWidth >> 1);
+        uint16_t lumaHeight = (uint16_t)(input_picture_ptr->height - sequence_control_set_ptr->max_input_pad_bottom);
+
+        uint16_t sourceLumaStride = (uint16_t)(inputPtr->y_stride);
+        uint16_t sourceCrStride = (uint16_t)(inputPtr->cr_stride);
+        uint16_t sourceCbStride = (uint16_t)(inputPtr->cb_stride);
+
+        // Y
+        for (inputRowIndex = 0; inputRowIndex < lumaHeight; inputRowIndex++) {
+            EB_MEMCPY((uint16_t*)input_picture_ptr->buffer_y + lumaBufferOffset + input_picture_ptr->stride_y * inputRowIndex,
+                (uint16_t*)inputPtr->luma + sourceLumaStride * inputRowIndex,
+                lumaWidth * sizeof(uint16_t));
+        }
+
+        // U
+        for (inputRowIndex = 0; inputRowIndex < lumaHeight >> 1; inputRowIndex++) {
+            EB_MEMCPY((uint16_t*)input_picture_ptr->bufferCb + chromaBufferOffset + input_picture_ptr->strideCb * inputRowIndex,
+                (uint16_t*)inputPtr->cb + sourceCbStride * inputRowIndex,
+                chromaWidth * sizeof(uint16_t));
+        }
+
+        // V
+        for (inputRowIndex = 0; inputRowIndex < lumaHeight >> 1; inputRowIndex++) {
+            EB_MEMCPY((uint16_t*)input_picture_ptr->bufferCr + chromaBufferOffset + input_picture_ptr->strideCr * inputRowIndex,
+                (uint16_t*)inputPtr->cr + sourceCrStride * inputRowIndex,
+                chromaWidth * sizeof(uint16_t));
+        }
+    }
     else { // 10bit packed
 
         uint32_t lumaOffset = 0, chromaOffset = 0;
@@ -3269,9 +3502,11 @@ __attribute__((visibility("default")))
 EB_API void eb_svt_release_out_buffer(
     EbBufferHeaderType  **p_buffer)
 {
-    if (p_buffer&&(*p_buffer)->wrapper_ptr)
-        // Release out put buffer back into the pool
+    if (p_buffer&&(*p_buffer)->wrapper_ptr) {
+        // Release the segments then the output buffer back into their pools
+        output_packet_release(*p_buffer);
         eb_release_object((EbObjectWrapper  *)(*p_buffer)->wrapper_ptr);
+    }
     return;
 }
 
@@ -3289,7 +3524,7 @@ EB_API EbErrorType eb_svt_get_recon(
     EbEncHandle_t          *pEncCompData = (EbEncHandle_t*)svt_enc_component->p_component_private;
     EbObjectWrapper      *ebWrapperPtr = NULL;
 
-    if (pEncCompData->sequence_control_set_instance_array[0]->sequence_control_set_ptr->static_config.recon_enabled) {
+    if (pEncCompData->sequence_control_set_instance_array[0]->sequence_control_set_ptr->static_config.recon_enabled == 1) {
 
         eb_get_full_object_non_blocking(
             (pEncCompData->output_recon_buffer_consumer_fifo_ptr_dbl_array[0])[0],
@@ -3318,6 +3553,101 @@ EB_API EbErrorType eb_svt_get_recon(
     return return_error;
 }
 
+/**********************************
+* Get Recon View
+**********************************/
+#if defined(__linux__) || defined(__APPLE__)
+__attribute__((visibility("default")))
+#endif
+EB_API EbErrorType eb_svt_get_recon_view(
+    EbComponentType      *svt_enc_component,
+    EbBufferHeaderType  **p_buffer)
+{
+    EbErrorType           return_error = EB_ErrorNone;
+    EbEncHandle_t          *pEncCompData = (EbEncHandle_t*)svt_enc_component->p_component_private;
+    EbObjectWrapper      *ebWrapperPtr = NULL;
+
+    if (pEncCompData->sequence_control_set_instance_array[0]->sequence_control_set_ptr->static_config.recon_enabled == 2) {
+
+        eb_get_full_object_non_blocking(
+            (pEncCompData->output_recon_buffer_consumer_fifo_ptr_dbl_array[0])[0],
+            &ebWrapperPtr);
+
+        if (ebWrapperPtr) {
+            *p_buffer = (EbBufferHeaderType*)ebWrapperPtr->object_ptr;
+
+            // save the wrapper pointer for the release
+            (*p_buffer)->wrapper_ptr = (void*)ebWrapperPtr;
+
+            if ((*p_buffer)->flags != EB_BUFFERFLAG_EOS && (*p_buffer)->flags != 0) {
+                return_error = EB_ErrorMax;
+            }
+        }
+        else {
+            return_error = EB_NoErrorEmptyQueue;
+        }
+    }
+    else {
+        // zero-copy recon is not enabled
+        return_error = EB_ErrorMax;
+    }
+
+    return return_error;
+}
+
+#if defined(__linux__) || defined(__APPLE__)
+__attribute__((visibility("default")))
+#endif
+EB_API void eb_svt_release_recon_view(
+    EbBufferHeaderType  **p_buffer)
+{
+    if (p_buffer && *p_buffer && (*p_buffer)->wrapper_ptr) {
+        ReconView_t *recon_view = (ReconView_t*)(*p_buffer)->p_buffer;
+
+        // Drop the hold on the picture, then return the view to the pool
+        if (recon_view->reference_picture_wrapper_ptr)
+            eb_release_object(recon_view->reference_picture_wrapper_ptr);
+        if (recon_view->picture_control_set_wrapper_ptr)
+            eb_release_object(recon_view->picture_control_set_wrapper_ptr);
+        recon_view->reference_picture_wrapper_ptr = (EbObjectWrapper*)EB_NULL;
+        recon_view->picture_control_set_wrapper_ptr = (EbObjectWrapper*)EB_NULL;
+        eb_release_object((EbObjectWrapper  *)(*p_buffer)->wrapper_ptr);
+
+        // The view belongs to the pool again, a second release is a no-op
+        *p_buffer = (EbBufferHeaderType*)EB_NULL;
+    }
+    return;
+}
+
+/**********************************
+* Get Stream Info
+**********************************/
+#if defined(__linux__) || defined(__APPLE__)
+__attribute__((visibility("default")))
+#endif
+EB_API EbErrorType eb_svt_enc_get_stream_info(
+    EbComponentType      *svt_enc_component,
+    uint32_t              stream_info_id,
+    void                 *info)
+{
+    if (svt_enc_component == NULL || info == NULL)
+        return EB_ErrorBadParameter;
+    EbEncHandle_t        *pEncCompData = (EbEncHandle_t*)svt_enc_component->p_component_private;
+    EncodeContext_t      *encode_context_ptr = pEncCompData->sequence_control_set_instance_array[0]->encode_context_ptr;
+
+    if (stream_info_id == EB_STREAM_INFO_FIRST_PASS_STATS_OUT) {
+        EbSvtAv1FixedBuf *stats = (EbSvtAv1FixedBuf*)info;
+        if (encode_context_ptr->rc_stats_out == NULL)
+            return EB_ErrorBadParameter;
+        // Only the recorded pictures are returned, e.g. when the input ended before frames_to_be_encoded
+        stats->buf = encode_context_ptr->rc_stats_out;
+        stats->sz = sizeof(RcStatsHeader_t) + ((RcStatsHeader_t*)encode_context_ptr->rc_stats_out)->frame_count * sizeof(RcStatsEntry_t);
+        return EB_ErrorNone;
+    }
+
+    return EB_ErrorBadParameter;
+}
+
 /**********************************
 * Encoder Error Handling
 **********************************/
@@ -3411,6 +3741,10 @@ static EbErrorType allocate_frame_buffer(
         input_picture_buffer_desc_init_data.splitMode = EB_FALSE;  //do special allocation for 2bit data down below.
     }
 
+    // The native 16 bit pipeline keeps the input unsplit
+    if (config->native_16bit_pipeline)
+        input_picture_buffer_desc_init_data.splitMode = EB_FALSE;
+
     // Enhanced Picture Buffer
     return_error = eb_picture_buffer_desc_ctor(
         (EbPtr*) &(inputBuffer->p_buffer),
@@ -3459,8 +3793,6 @@ EbErrorType EbOutputBufferHeaderCtor(
     EbPtr *objectDblPtr,
     EbPtr objectInitDataPtr)
 {
-    EbSvtAv1EncConfiguration   * config = (EbSvtAv1EncConfiguration*)objectInitDataPtr;
-    uint32_t nStride = (uint32_t)(EB_OUTPUTSTREAMBUFFERSIZE_MACRO(config->source_width * config->source_height));  //TBC
     EbBufferHeaderType* outBufPtr;
 
     EB_MALLOC(EbBufferHeaderType*, outBufPtr, sizeof(EbBufferHeaderType), EB_N_PTR);
@@ -3469,9 +3801,10 @@ EbErrorType EbOutputBufferHeaderCtor(
     // Initialize Header
     outBufPtr->size = sizeof(EbBufferHeaderType);
 
-    EB_MALLOC(uint8_t*, outBufPtr->p_buffer, nStride, EB_N_PTR);
-
-    outBufPtr->n_alloc_len = nStride;
+    // The payload is a chain of output segments, attached by the Packetization process
+    outBufPtr->p_buffer = NULL;
+    outBufPtr->n_filled_len = 0;
+    outBufPtr->n_alloc_len = 0;
     outBufPtr->p_app_private = NULL;
 
     (void)objectInitDataPtr;
@@ -3503,9 +3836,15 @@ EbErrorType EbOutputReconBufferHeaderCtor(
     recon_buffer->size = sizeof(EbBufferHeaderType);
 
     // Assign the variables
-    EB_MALLOC(uint8_t*, recon_buffer->p_buffer, frameSize, EB_N_PTR);
-
-    recon_buffer->n_alloc_len = frameSize;
+    if (sequence_control_set_ptr->static_config.recon_enabled == 2) {
+        // Zero-copy recon, the buffer only describes the planes
+        EB_MALLOC(uint8_t*, recon_buffer->p_buffer, sizeof(ReconView_t), EB_N_PTR);
+        recon_buffer->n_alloc_len = sizeof(ReconView_t);
+    }
+    else {
+        EB_MALLOC(uint8_t*, recon_buffer->p_buffer, frameSize, EB_N_PTR);
+        recon_buffer->n_alloc_len = frameSize;
+    }
     recon_buffer->p_app_private = NULL;
 
     return EB_ErrorNone;
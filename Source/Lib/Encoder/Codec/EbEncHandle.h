@@ -62,6 +62,7 @@ typedef struct EbEncHandle_s
     EbHandle                               resourceCoordinationThreadHandle;
     EbHandle                               pictureEnhancementThreadHandle;
     EbHandle                              *pictureAnalysisThreadHandleArray;
+    EbHandle                              *workerPoolThreadHandleArray;
     EbHandle                               pictureDecisionThreadHandle;
     EbHandle                              *motionEstimationThreadHandleArray;
     EbHandle                               initialRateControlThreadHandle;
@@ -76,6 +77,7 @@ typedef struct EbEncHandle_s
     EbHandle                              *restThreadHandleArray;
 
     EbHandle                               packetizationThreadHandle;
+    EbHandle                               statThreadHandle;
 
     // Contexts
     EbPtr                                  resourceCoordinationContextPtr;
@@ -94,6 +96,7 @@ typedef struct EbEncHandle_s
     EbPtr                                 *cdefContextPtrArray;
     EbPtr                                 *restContextPtrArray;
     EbPtr                                  packetizationContextPtr;
+    EbPtr                                  statContextPtr;
 
     // System Resource Managers
     EbSystemResource                     *input_buffer_resource_ptr;
@@ -114,6 +117,7 @@ typedef struct EbEncHandle_s
     EbSystemResource                     *dlfResultsResourcePtr;
     EbSystemResource                     *cdefResultsResourcePtr;
     EbSystemResource                     *restResultsResourcePtr;
+    EbSystemResource                     *statTasksResourcePtr;
 
     // Inter-Process Producer Fifos
     EbFifo                              **input_buffer_producer_fifo_ptr_array;
@@ -135,6 +139,7 @@ typedef struct EbEncHandle_s
     EbFifo                              **dlfResultsProducerFifoPtrArray;
     EbFifo                              **cdefResultsProducerFifoPtrArray;
     EbFifo                              **restResultsProducerFifoPtrArray;
+    EbFifo                              **statTasksProducerFifoPtrArray;
 
 
     // Inter-Process Consumer Fifos
@@ -156,6 +161,7 @@ typedef struct EbEncHandle_s
     EbFifo                              **dlfResultsConsumerFifoPtrArray;
     EbFifo                              **cdefResultsConsumerFifoPtrArray;
     EbFifo                              **restResultsConsumerFifoPtrArray;
+    EbFifo                              **statTasksConsumerFifoPtrArray;
 
     // Callbacks
     EbCallback_t                          **app_callback_ptr_array;
@@ -22,6 +22,7 @@
 #include <gst/gst.h>
 #include <gst/video/video.h>
 #include <gst/video/gstvideoencoder.h>
+#include <gst/video/gstvideopool.h>
 #include "gstsvtav1enc.h"
 
 GST_DEBUG_CATEGORY_STATIC (gst_svtav1enc_debug_category);
@@ -117,6 +118,14 @@ enum
 #define PROP_CORES_DEFAULT                  0
 #define PROP_SOCKET_DEFAULT                 -1
 
+/* SVT-AV1 sizes its output packet pool 4 entries above its input picture
+ * pool, so at most that many packets can be held downstream without
+ * starving the encoder; past that, packets are copied out as before. */
+#define GST_SVTAV1ENC_MAX_WRAPPED_PACKETS   4
+/* input planes are copied row by row into the encoder's padded pictures,
+ * keep upstream strides aligned for the vectorized copies */
+#define GST_SVTAV1ENC_STRIDE_ALIGN          32
+
 /* pad templates */
 static GstStaticPadTemplate gst_svtav1enc_sink_pad_template =
 GST_STATIC_PAD_TEMPLATE ("sink",
@@ -300,6 +309,12 @@ gst_svtav1enc_class_init (GstSvtAv1EncClass * klass)
 static void
 gst_svtav1enc_init (GstSvtAv1Enc * svtav1enc)
 {
+  g_mutex_init (&svtav1enc->packet_lock);
+  g_cond_init (&svtav1enc->packet_cond);
+  svtav1enc->packets_outstanding = 0;
+  svtav1enc->encoder_refs = 0;
+  svtav1enc->encoder_started = FALSE;
+
   GST_OBJECT_LOCK (svtav1enc);
   svtav1enc->svt_config = g_malloc (sizeof (EbSvtAv1EncConfiguration));
   if (!svtav1enc->svt_config) {
@@ -504,6 +519,9 @@ gst_svtav1enc_finalize (GObject * object)
   g_free (svtav1enc->svt_config);
   GST_OBJECT_UNLOCK (svtav1enc);
 
+  g_mutex_clear (&svtav1enc->packet_lock);
+  g_cond_clear (&svtav1enc->packet_cond);
+
   G_OBJECT_CLASS (gst_svtav1enc_parent_class)->finalize (object);
 }
 
@@ -765,6 +783,124 @@ gst_svtav1enc_flush (GstVideoEncoder * encoder)
   return (ret != GST_FLOW_ERROR);
 }
 
+typedef struct
+{
+  GstSvtAv1Enc *svtav1enc;
+  EbBufferHeaderType *output_buf;
+  gint segments_held;
+} GstSvtAv1EncPacket;
+
+/* Drops a reference on the encoder, the last one tears it down. Called from
+ * stop and from the release of the last wrapped packet, whichever is later. */
+static void
+gst_svtav1enc_encoder_unref (GstSvtAv1Enc * svtav1enc)
+{
+  /* the teardown is done under packet_lock so set_format cannot start a
+   * new encoder before it completes */
+  g_mutex_lock (&svtav1enc->packet_lock);
+  if (--svtav1enc->encoder_refs == 0) {
+    GST_DEBUG_OBJECT (svtav1enc, "releasing encoder");
+    GST_OBJECT_LOCK (svtav1enc);
+    eb_deinit_encoder(svtav1enc->svt_encoder);
+    /* Destruct the buffer memory pool */
+    gst_svthevenc_deallocate_svt_buffers (svtav1enc);
+    GST_OBJECT_UNLOCK (svtav1enc);
+    g_cond_broadcast (&svtav1enc->packet_cond);
+  }
+  g_mutex_unlock (&svtav1enc->packet_lock);
+}
+
+/* Called once per wrapped segment, the packet goes back to the encoder
+ * with the last one. */
+static void
+gst_svtav1enc_release_packet (gpointer data)
+{
+  GstSvtAv1EncPacket *packet = (GstSvtAv1EncPacket *) data;
+  GstSvtAv1Enc *svtav1enc = packet->svtav1enc;
+
+  if (!g_atomic_int_dec_and_test (&packet->segments_held))
+    return;
+
+  eb_svt_release_out_buffer (&packet->output_buf);
+
+  g_mutex_lock (&svtav1enc->packet_lock);
+  svtav1enc->packets_outstanding--;
+  g_mutex_unlock (&svtav1enc->packet_lock);
+
+  gst_svtav1enc_encoder_unref (svtav1enc);
+  gst_object_unref (svtav1enc);
+  g_slice_free (GstSvtAv1EncPacket, packet);
+}
+
+/* Returns a GstBuffer holding the packet payload, one memory per output
+ * segment. When the packet memory is wrapped, ownership of output_buf moves
+ * to the returned buffer and *wrapped is set; otherwise the payload is
+ * copied and the caller still has to release output_buf. */
+static GstBuffer *
+gst_svtav1enc_wrap_output_buffer (GstSvtAv1Enc * svtav1enc,
+    EbBufferHeaderType * output_buf, gboolean * wrapped)
+{
+  GstSvtAv1EncPacket *packet;
+  GstBuffer *buffer;
+  EbOutputSegment *segment;
+  gsize offset = 0;
+
+  g_mutex_lock (&svtav1enc->packet_lock);
+  *wrapped =
+      svtav1enc->packets_outstanding < GST_SVTAV1ENC_MAX_WRAPPED_PACKETS;
+  if (*wrapped) {
+    svtav1enc->packets_outstanding++;
+    svtav1enc->encoder_refs++;
+  }
+  g_mutex_unlock (&svtav1enc->packet_lock);
+
+  if (!*wrapped) {
+    GST_LOG_OBJECT (svtav1enc, "too many packets held downstream, copying");
+    buffer = gst_buffer_new_allocate (NULL, output_buf->n_filled_len, NULL);
+    for (segment = (EbOutputSegment *) output_buf->p_buffer; segment;
+        segment = segment->next) {
+      gst_buffer_fill (buffer, offset, segment->data, segment->filled_len);
+      offset += segment->filled_len;
+    }
+    return buffer;
+  }
+
+  packet = g_slice_new (GstSvtAv1EncPacket);
+  packet->svtav1enc = gst_object_ref (svtav1enc);
+  packet->output_buf = output_buf;
+  /* Held by the loop below until every segment is wrapped */
+  packet->segments_held = 1;
+
+  buffer = gst_buffer_new ();
+  for (segment = (EbOutputSegment *) output_buf->p_buffer; segment;
+      segment = segment->next) {
+    g_atomic_int_inc (&packet->segments_held);
+    gst_buffer_append_memory (buffer,
+        gst_memory_new_wrapped (GST_MEMORY_FLAG_READONLY, segment->data,
+            segment->filled_len, 0, segment->filled_len, packet,
+            gst_svtav1enc_release_packet));
+  }
+  gst_svtav1enc_release_packet (packet);
+
+  return buffer;
+}
+
+/* The wrapped packets point into memory owned by the encoder, a stopped
+ * encoder lives on until downstream gives the last of them back. It must be
+ * gone before the handle is initialized again. */
+static void
+gst_svtav1enc_wait_encoder_released (GstSvtAv1Enc * svtav1enc)
+{
+  g_mutex_lock (&svtav1enc->packet_lock);
+  if (svtav1enc->encoder_refs > 0)
+    GST_INFO_OBJECT (svtav1enc,
+        "waiting for %u encoded buffers held downstream",
+        svtav1enc->packets_outstanding);
+  while (svtav1enc->encoder_refs > 0)
+    g_cond_wait (&svtav1enc->packet_cond, &svtav1enc->packet_lock);
+  g_mutex_unlock (&svtav1enc->packet_lock);
+}
+
 gint
 compare_video_code_frame_and_pts (const void *video_codec_frame_ptr,
     const void *pts_ptr)
@@ -786,6 +922,7 @@ gst_svtav1enc_dequeue_encoded_frames (GstSvtAv1Enc * svtav1enc,
     GList *frame_list_element = NULL;
     GstVideoCodecFrame *frame = NULL;
     EbBufferHeaderType *output_buf = NULL;
+    gboolean wrapped = FALSE;
 
     res =
         eb_svt_get_packet(svtav1enc->svt_encoder, &output_buf,
@@ -822,10 +959,8 @@ gst_svtav1enc_dequeue_encoded_frames (GstSvtAv1Enc * svtav1enc,
       }
 
       frame->output_buffer =
-          gst_buffer_new_allocate (NULL, output_buf->n_filled_len, NULL);
+          gst_svtav1enc_wrap_output_buffer (svtav1enc, output_buf, &wrapped);
       GST_BUFFER_FLAG_SET(frame->output_buffer, GST_BUFFER_FLAG_LIVE);
-      gst_buffer_fill (frame->output_buffer, 0,
-          output_buf->p_buffer, output_buf->n_filled_len);
 
 
       /* SVT-AV1 may return first frames with a negative DTS,
@@ -851,7 +986,8 @@ gst_svtav1enc_dequeue_encoded_frames (GstSvtAv1Enc * svtav1enc,
           G_GINT64_FORMAT " SliceType:%d\n", svtav1enc->frame_count,
            (frame->dts), (frame->pts), output_buf->pic_type);
 
-      eb_svt_release_out_buffer(&output_buf);
+      if (!wrapped)
+        eb_svt_release_out_buffer(&output_buf);
       output_buf = NULL;
 
       ret = gst_video_encoder_finish_frame (GST_VIDEO_ENCODER (svtav1enc), frame);
@@ -924,11 +1060,12 @@ gst_svtav1enc_stop (GstVideoEncoder * encoder)
   svtav1enc->state = NULL;
   GST_OBJECT_UNLOCK (svtav1enc);
 
-  GST_OBJECT_LOCK (svtav1enc);
-  eb_deinit_encoder(svtav1enc->svt_encoder);
-  /* Destruct the buffer memory pool */
-  gst_svthevenc_deallocate_svt_buffers (svtav1enc);
-  GST_OBJECT_UNLOCK (svtav1enc);
+  /* buffers still held downstream keep the encoder alive, the last one
+   * released deinitializes it */
+  if (svtav1enc->encoder_started) {
+    svtav1enc->encoder_started = FALSE;
+    gst_svtav1enc_encoder_unref (svtav1enc);
+  }
 
   return TRUE;
 }
@@ -946,6 +1083,14 @@ gst_svtav1enc_set_format (GstVideoEncoder * encoder,
    * and if there was already a state. */
   svtav1enc->state = gst_video_codec_state_ref (state);
 
+  if (!svtav1enc->encoder_started) {
+    gst_svtav1enc_wait_encoder_released (svtav1enc);
+    g_mutex_lock (&svtav1enc->packet_lock);
+    svtav1enc->encoder_refs++;
+    g_mutex_unlock (&svtav1enc->packet_lock);
+    svtav1enc->encoder_started = TRUE;
+  }
+
   gst_svtav1enc_configure_svt (svtav1enc);
   gst_svtav1enc_allocate_svt_buffers (svtav1enc);
   gst_svtav1enc_start_svt (svtav1enc);
@@ -1081,9 +1226,56 @@ gst_svtav1enc_propose_allocation (GstVideoEncoder * encoder, GstQuery * query)
 {
   GstSvtAv1Enc *svtav1enc = GST_SVTAV1ENC (encoder);
 
+  GstCaps *caps = NULL;
+  gboolean need_pool = FALSE;
+  GstVideoInfo info;
+
   GST_DEBUG_OBJECT (svtav1enc, "propose_allocation");
 
-  return TRUE;
+  gst_query_parse_allocation (query, &caps, &need_pool);
+  if (caps == NULL || !gst_video_info_from_caps (&info, caps))
+    return GST_VIDEO_ENCODER_CLASS (gst_svtav1enc_parent_class)->propose_allocation
+        (encoder, query);
+
+  /* the planes are handed to SVT-AV1 through their strides, so any layout
+   * upstream picks is fine as long as it is described by a GstVideoMeta */
+  gst_query_add_allocation_meta (query, GST_VIDEO_META_API_TYPE, NULL);
+
+  if (need_pool) {
+    GstBufferPool *pool = gst_video_buffer_pool_new ();
+    GstStructure *config = gst_buffer_pool_get_config (pool);
+    GstVideoAlignment align;
+    guint size = info.size;
+    guint i;
+
+    gst_video_alignment_reset (&align);
+    for (i = 0; i < GST_VIDEO_MAX_PLANES; i++)
+      align.stride_align[i] = GST_SVTAV1ENC_STRIDE_ALIGN - 1;
+
+    gst_buffer_pool_config_set_params (config, caps, size, 0, 0);
+    gst_buffer_pool_config_add_option (config,
+        GST_BUFFER_POOL_OPTION_VIDEO_META);
+    gst_buffer_pool_config_add_option (config,
+        GST_BUFFER_POOL_OPTION_VIDEO_ALIGNMENT);
+    gst_buffer_pool_config_set_video_alignment (config, &align);
+
+    if (!gst_buffer_pool_set_config (pool, config)) {
+      GST_WARNING_OBJECT (svtav1enc, "failed to configure buffer pool");
+      gst_object_unref (pool);
+      return FALSE;
+    }
+
+    /* the pool may have grown the size to honour the alignment */
+    config = gst_buffer_pool_get_config (pool);
+    gst_buffer_pool_config_get_params (config, NULL, &size, NULL, NULL);
+    gst_structure_free (config);
+
+    gst_query_add_allocation_pool (query, pool, size, 0, 0);
+    gst_object_unref (pool);
+  }
+
+  return GST_VIDEO_ENCODER_CLASS (gst_svtav1enc_parent_class)->propose_allocation
+      (encoder, query);
 }
 
 static gboolean
@@ -42,6 +42,17 @@ typedef struct _GstSvtAv1Enc
 
   EbBufferHeaderType *input_buf;
 
+  /* output packets handed downstream without a copy; they go back to the
+   * SVT-AV1 output pool once the wrapping GstBuffer is released */
+  GMutex packet_lock;
+  GCond packet_cond;
+  guint packets_outstanding;
+
+  /* references on the initialized encoder: one from set_format until stop,
+   * one per wrapped packet. The last one deinitializes the encoder. */
+  guint encoder_refs;
+  gboolean encoder_started;
+
   long long int frame_count;
   int dts_offset;
 } GstSvtAv1Enc;
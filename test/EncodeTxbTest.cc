@@ -0,0 +1,81 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "EbDefinitions.h"
+#include "aom_dsp_rtcd.h"
+#include "EbMdRateEstimation.h"
+#include "EbTransforms.h"
+
+// av1_cost_coeffs_levels_avx2 must return the cost of its C version for
+// every transform size and class, from DC only blocks to full ones and
+// with levels large enough to reach the Golomb coded range.
+
+static void random_coeff_costs(std::mt19937 &rnd, LV_MAP_COEFF_COST *costs)
+{
+    int32_t *const cost = (int32_t *)costs;
+    for (size_t i = 0; i < sizeof(*costs) / sizeof(int32_t); ++i)
+        cost[i] = (int32_t)(rnd() & ((1 << 14) - 1));
+}
+
+static tran_low_t random_level(std::mt19937 &rnd)
+{
+    // Mostly base levels, then the range and Golomb coded levels
+    const uint32_t kind = rnd() & 15;
+    tran_low_t level = kind < 10 ? (tran_low_t)(rnd() & 3) :
+        kind < 14 ? (tran_low_t)(rnd() % 15) : (tran_low_t)(rnd() & ((1 << 16) - 1));
+    return (rnd() & 1) ? -level : level;
+}
+
+TEST(EncodeTxb, cost_coeffs_levels_avx2_match_c)
+{
+    std::mt19937 rnd(0);
+    LV_MAP_COEFF_COST costs;
+    DECLARE_ALIGNED(32, tran_low_t, qcoeff[MAX_TX_SQUARE]);
+    DECLARE_ALIGNED(16, uint8_t, levels_buf[TX_PAD_2D]);
+    DECLARE_ALIGNED(16, int8_t, coeff_contexts[MAX_TX_SQUARE]);
+
+    for (int size = 0; size < TX_SIZES_ALL; ++size) {
+        const TxSize tx_size = av1_get_adjusted_tx_size((TxSize)size);
+        const int32_t width = tx_size_wide[tx_size];
+        const int32_t height = tx_size_high[tx_size];
+        const int32_t bwl = tx_size_wide_log2[tx_size];
+        const int32_t max_eob = width * height;
+        // The 32 point transforms only have the DCT and the identity
+        const int32_t tx_type_count = AOMMAX(width, height) == 32 ? 2 : TX_TYPES;
+        uint8_t *const levels = levels_buf + TX_PAD_TOP * (width + TX_PAD_HOR);
+
+        for (int32_t type = 0; type < tx_type_count; ++type) {
+            const TxType tx_type = tx_type_count == 2 ? (type ? IDTX : DCT_DCT) : (TxType)type;
+            const TX_CLASS tx_class = tx_type_to_class[tx_type];
+            const int16_t *const scan = av1_scan_orders[tx_size][tx_type].scan;
+
+            for (int iter = 0; iter < 64; ++iter) {
+                // DC only, a single 8 coefficient step and its tail, then random
+                const uint16_t eob = (uint16_t)(iter == 0 ? 1 : iter == 1 ? AOMMIN(9, max_eob) :
+                    iter == 2 ? max_eob : 1 + rnd() % max_eob);
+                const int16_t dc_sign_ctx = (int16_t)(rnd() % DC_SIGN_CONTEXTS);
+
+                memset(qcoeff, 0, sizeof(qcoeff));
+                for (int32_t c = 0; c < eob; ++c)
+                    qcoeff[scan[c]] = random_level(rnd);
+                if (!qcoeff[scan[eob - 1]])
+                    qcoeff[scan[eob - 1]] = (rnd() & 1) ? 1 : -1;
+                random_coeff_costs(rnd, &costs);
+
+                av1_txb_init_levels_c(qcoeff, width, height, levels);
+                av1_get_nz_map_contexts_sse2(levels, scan, eob, tx_size, tx_class, coeff_contexts);
+
+                ASSERT_EQ(av1_cost_coeffs_levels_c(qcoeff, levels, scan, coeff_contexts, eob, bwl,
+                    tx_class, dc_sign_ctx, &costs),
+                    av1_cost_coeffs_levels_avx2(qcoeff, levels, scan, coeff_contexts, eob, bwl,
+                        tx_class, dc_sign_ctx, &costs))
+                    << "tx_size " << size << " tx_type " << tx_type << " eob " << eob;
+            }
+        }
+    }
+}
@@ -0,0 +1,93 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+#include <cstring>
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "EbDefinitions.h"
+#include "aom_dsp_rtcd.h"
+#include "EbTransforms.h"
+
+// The AVX2 square high bit depth inverse transforms pick reduced kernels
+// from the eob. For every eob, from DC only to the full block, they must
+// reconstruct the same pixels as the C version.
+
+typedef void(*InvTxfm2dFunc)(const int32_t *input, uint16_t *output, int32_t stride,
+    TxType tx_type, TxSize tx_size, int32_t eob, int32_t bd);
+typedef void(*FwdTxfm2dFunc)(int16_t *input, int32_t *output, uint32_t input_stride,
+    TxType transform_type, uint8_t bit_depth);
+
+typedef struct InvTxfm2dParam {
+    TxSize        tx_size;
+    int32_t       size;
+    FwdTxfm2dFunc fwd;
+    InvTxfm2dFunc inv_c;
+    InvTxfm2dFunc inv_avx2;
+} InvTxfm2dParam;
+
+static const InvTxfm2dParam kInvTxfm2dParams[] = {
+    { TX_8X8, 8, Av1TransformTwoD_8x8_c, av1_inv_txfm2d_add_8x8_c, av1_inv_txfm2d_add_8x8_avx2 },
+    { TX_16X16, 16, Av1TransformTwoD_16x16_c, av1_inv_txfm2d_add_16x16_c, av1_inv_txfm2d_add_16x16_avx2 },
+    { TX_32X32, 32, Av1TransformTwoD_32x32_c, av1_inv_txfm2d_add_32x32_c, av1_inv_txfm2d_add_32x32_avx2 },
+    { TX_64X64, 64, Av1TransformTwoD_64x64_c, av1_inv_txfm2d_add_64x64_c, av1_inv_txfm2d_add_64x64_avx2 },
+};
+
+// Eobs at the edges of the DC only, 8x8 and 16x16 reduced kernels
+static const int32_t kEobs[] = { 1, 2, 3, 8, 10, 16, 21, 36, 37, 64, 65, 120, 136, 137, 256, 257, 529, 1024 };
+
+TEST(InvTxfm2d, highbd_inv_txfm2d_add_avx2_match_c)
+{
+    std::mt19937 rnd(0);
+    // As in the encoder, the coefficients and the rows of the prediction
+    // are aligned, which the SSE4.1 kernels some of the types fall back to need
+    DECLARE_ALIGNED(32, int32_t, input[32 * 32]);
+    DECLARE_ALIGNED(32, uint16_t, output_c[(64 + 8) * 64]);
+    DECLARE_ALIGNED(32, uint16_t, output_avx2[(64 + 8) * 64]);
+
+    for (const InvTxfm2dParam &param : kInvTxfm2dParams) {
+        const int32_t size = param.size;
+        // Only the top-left 32x32 coefficients of a 64 point transform are coded
+        const int32_t coded = AOMMIN(size, 32);
+        const int32_t stride = size + 8;
+        const int32_t tx_type_count = size >= 32 ? (size == 32 ? 2 : 1) : TX_TYPES;
+        std::vector<int16_t> residual(size * size);
+        std::vector<int32_t> coeff(size * size);
+
+        for (const int32_t bd : { 8, 10 }) {
+            for (int32_t type = 0; type < tx_type_count; ++type) {
+                const TxType tx_type = (size == 32 && type) ? IDTX : (TxType)type;
+                const int16_t *const scan = av1_scan_orders[param.tx_size][tx_type].scan;
+                std::vector<int32_t> eobs(kEobs, kEobs + sizeof(kEobs) / sizeof(kEobs[0]));
+                for (int i = 0; i < 16; ++i)
+                    eobs.push_back(1 + rnd() % (coded * coded));
+
+                for (const int32_t eob : eobs) {
+                    if (eob > coded * coded)
+                        continue;
+                    for (auto &r : residual)
+                        r = (int16_t)((int32_t)(rnd() % (2 << bd)) - (1 << bd) + 1);
+                    param.fwd(residual.data(), coeff.data(), size, tx_type, (uint8_t)bd);
+                    for (int32_t row = 0; row < coded; ++row)
+                        for (int32_t col = 0; col < coded; ++col)
+                            input[row * coded + col] = coeff[row * size + col];
+                    // What the quantizer leaves: nothing from the eob on in scan order
+                    for (int32_t c = eob; c < coded * coded; ++c)
+                        input[scan[c]] = 0;
+
+                    for (int32_t i = 0; i < stride * size; ++i)
+                        output_c[i] = (uint16_t)(rnd() & ((1 << bd) - 1));
+                    memcpy(output_avx2, output_c, stride * size * sizeof(output_c[0]));
+
+                    param.inv_c(input, output_c, stride, tx_type, param.tx_size, eob, bd);
+                    param.inv_avx2(input, output_avx2, stride, tx_type, param.tx_size, eob, bd);
+
+                    ASSERT_EQ(0, memcmp(output_c, output_avx2, stride * size * sizeof(output_c[0])))
+                        << "size " << size << " tx_type " << tx_type << " eob " << eob << " bd " << bd;
+                }
+            }
+        }
+    }
+}
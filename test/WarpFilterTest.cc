@@ -0,0 +1,236 @@
+/*
+* Copyright(c) 2019 Intel Corporation
+* SPDX - License - Identifier: BSD - 2 - Clause - Patent
+*/
+
+/*
+* Copyright (c) 2016, Alliance for Open Media. All rights reserved
+*
+* This source code is subject to the terms of the BSD 2 Clause License and
+* the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+* was not distributed with this source code in the LICENSE file, you can
+* obtain it at www.aomedia.org/license/software. If the Alliance for Open
+* Media Patent License 1.0 was not distributed with this source code in the
+* PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+*/
+
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "EbDefinitions.h"
+#include "aom_dsp_rtcd.h"
+#include "convolve.h"
+#include "EbWarpedMotion.h"
+
+// The SIMD warp filters and warp error kernels must match their C version
+// bit for bit, on frames whose width and height are not multiples of the
+// block size and on blocks whose filter taps fall outside of the frame.
+
+static const int kFrameSizes[][2] = { { 128, 128 }, { 127, 121 }, { 67, 33 }, { 33, 17 } };
+static const int kBlockSizes[] = { 4, 8, 16, 32, 64 };
+static const int kIterations = 16;
+
+static int32_t random_warped_param(std::mt19937 &rnd, int bits)
+{
+    // 1 in 8 chance of a zero parameter
+    if ((rnd() & 7) == 0)
+        return 0;
+    const int32_t v = 1 + (int32_t)(rnd() & ((1 << bits) - 1));
+    return (rnd() & 1) ? -v : v;
+}
+
+// Draws an affine or rotzoom model the warp filter accepts, with a
+// translation that may move the block partly or fully out of the frame
+static void generate_warped_model(std::mt19937 &rnd, EbWarpedMotionParams *wm)
+{
+    do {
+        const int rotzoom = rnd() & 1;
+        wm->wmtype = rotzoom ? ROTZOOM : AFFINE;
+        wm->wmmat[0] = random_warped_param(rnd, WARPEDMODEL_PREC_BITS + 6);
+        wm->wmmat[1] = random_warped_param(rnd, WARPEDMODEL_PREC_BITS + 6);
+        wm->wmmat[2] = random_warped_param(rnd, WARPEDMODEL_PREC_BITS - 3) + (1 << WARPEDMODEL_PREC_BITS);
+        wm->wmmat[3] = random_warped_param(rnd, WARPEDMODEL_PREC_BITS - 3);
+        if (rotzoom) {
+            wm->wmmat[4] = -wm->wmmat[3];
+            wm->wmmat[5] = wm->wmmat[2];
+        }
+        else {
+            wm->wmmat[4] = random_warped_param(rnd, WARPEDMODEL_PREC_BITS - 3);
+            wm->wmmat[5] = random_warped_param(rnd, WARPEDMODEL_PREC_BITS - 3) + (1 << WARPEDMODEL_PREC_BITS);
+        }
+        wm->wmmat[6] = wm->wmmat[7] = 0;
+    } while (!get_shear_params(wm));
+}
+
+// Compound prediction goes through the 16 bit buffer, with or without
+// averaging with (distance weighted or not) what is already there
+static ConvolveParams random_conv_params(std::mt19937 &rnd, CONV_BUF_TYPE *dst,
+    int dst_stride, int bd)
+{
+    const int is_compound = rnd() & 1;
+    ConvolveParams conv_params = get_conv_params_no_round(0, is_compound ? (int32_t)(rnd() & 1) : 0,
+        0, dst, dst_stride, is_compound, bd);
+    static const int quant_dist_lookup[4][2] = { { 9, 7 }, { 11, 5 }, { 12, 4 }, { 13, 3 } };
+    const int dist = rnd() & 3;
+    conv_params.use_jnt_comp_avg = conv_params.do_average ? (int32_t)(rnd() & 1) : 0;
+    conv_params.fwd_offset = quant_dist_lookup[dist][0];
+    conv_params.bck_offset = quant_dist_lookup[dist][1];
+    return conv_params;
+}
+
+TEST(WarpFilter, warp_affine_sse4_1_match_c)
+{
+    std::mt19937 rnd(0);
+
+    for (const auto &frame : kFrameSizes) {
+        const int w = frame[0], h = frame[1];
+        const int stride = w + 13;
+        std::vector<uint8_t> ref(stride * h);
+        for (const int out_w : kBlockSizes) {
+            for (const int out_h : kBlockSizes) {
+                std::vector<uint8_t> pred_c(out_w * out_h), pred_simd(out_w * out_h);
+                std::vector<CONV_BUF_TYPE> dst_c(out_w * out_h), dst_simd(out_w * out_h);
+                for (int iter = 0; iter < kIterations; ++iter) {
+                    for (auto &p : ref)
+                        p = (uint8_t)rnd();
+                    const int sub_x = rnd() & 1;
+                    const int sub_y = rnd() & 1;
+                    // Blocks may cross the right and bottom frame edges
+                    const int p_col = (int)(rnd() % w);
+                    const int p_row = (int)(rnd() % h);
+                    EbWarpedMotionParams wm;
+                    generate_warped_model(rnd, &wm);
+                    ConvolveParams params_c = random_conv_params(rnd, dst_c.data(), out_w, 8);
+                    ConvolveParams params_simd = params_c;
+                    params_simd.dst = dst_simd.data();
+
+                    if (params_c.do_average) {
+                        // The averaged prediction must be a valid one
+                        ConvolveParams first = params_c;
+                        first.do_average = 0;
+                        av1_warp_affine_c(wm.wmmat, ref.data(), w, h, stride, pred_c.data(),
+                            p_col, p_row, out_w, out_h, out_w, sub_x, sub_y, &first,
+                            wm.alpha, wm.beta, wm.gamma, wm.delta);
+                        dst_simd = dst_c;
+                    }
+                    av1_warp_affine_c(wm.wmmat, ref.data(), w, h, stride, pred_c.data(),
+                        p_col, p_row, out_w, out_h, out_w, sub_x, sub_y, &params_c,
+                        wm.alpha, wm.beta, wm.gamma, wm.delta);
+                    av1_warp_affine_sse4_1(wm.wmmat, ref.data(), w, h, stride, pred_simd.data(),
+                        p_col, p_row, out_w, out_h, out_w, sub_x, sub_y, &params_simd,
+                        wm.alpha, wm.beta, wm.gamma, wm.delta);
+
+                    if (params_c.is_compound) {
+                        ASSERT_EQ(dst_c, dst_simd) << "frame " << w << "x" << h << " block " << out_w << "x" << out_h;
+                    }
+                    if (!params_c.is_compound || params_c.do_average) {
+                        ASSERT_EQ(pred_c, pred_simd) << "frame " << w << "x" << h << " block " << out_w << "x" << out_h;
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(WarpFilter, highbd_warp_affine_sse4_1_match_c)
+{
+    std::mt19937 rnd(1);
+
+    for (const int bd : { 8, 10, 12 }) {
+        for (const auto &frame : kFrameSizes) {
+            const int w = frame[0], h = frame[1];
+            const int stride = w + 13;
+            std::vector<uint16_t> ref(stride * h);
+            for (const int out_w : kBlockSizes) {
+                for (const int out_h : kBlockSizes) {
+                    std::vector<uint16_t> pred_c(out_w * out_h), pred_simd(out_w * out_h);
+                    std::vector<CONV_BUF_TYPE> dst_c(out_w * out_h), dst_simd(out_w * out_h);
+                    for (int iter = 0; iter < kIterations; ++iter) {
+                        for (auto &p : ref)
+                            p = (uint16_t)(rnd() & ((1 << bd) - 1));
+                        const int sub_x = rnd() & 1;
+                        const int sub_y = rnd() & 1;
+                        const int p_col = (int)(rnd() % w);
+                        const int p_row = (int)(rnd() % h);
+                        EbWarpedMotionParams wm;
+                        generate_warped_model(rnd, &wm);
+                        ConvolveParams params_c = random_conv_params(rnd, dst_c.data(), out_w, bd);
+                        ConvolveParams params_simd = params_c;
+                        params_simd.dst = dst_simd.data();
+
+                        if (params_c.do_average) {
+                            ConvolveParams first = params_c;
+                            first.do_average = 0;
+                            av1_highbd_warp_affine_c(wm.wmmat, ref.data(), w, h, stride, pred_c.data(),
+                                p_col, p_row, out_w, out_h, out_w, sub_x, sub_y, bd, &first,
+                                wm.alpha, wm.beta, wm.gamma, wm.delta);
+                            dst_simd = dst_c;
+                        }
+                        av1_highbd_warp_affine_c(wm.wmmat, ref.data(), w, h, stride, pred_c.data(),
+                            p_col, p_row, out_w, out_h, out_w, sub_x, sub_y, bd, &params_c,
+                            wm.alpha, wm.beta, wm.gamma, wm.delta);
+                        av1_highbd_warp_affine_sse4_1(wm.wmmat, ref.data(), w, h, stride, pred_simd.data(),
+                            p_col, p_row, out_w, out_h, out_w, sub_x, sub_y, bd, &params_simd,
+                            wm.alpha, wm.beta, wm.gamma, wm.delta);
+
+                        if (params_c.is_compound) {
+                            ASSERT_EQ(dst_c, dst_simd) << "bd " << bd << " frame " << w << "x" << h << " block " << out_w << "x" << out_h;
+                        }
+                        if (!params_c.is_compound || params_c.do_average) {
+                            ASSERT_EQ(pred_c, pred_simd) << "bd " << bd << " frame " << w << "x" << h << " block " << out_w << "x" << out_h;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Widths around the 32 and 16 pixel steps of the AVX2 kernels, and odd ones
+static const int kErrorSizes[] = { 1, 3, 4, 7, 8, 15, 16, 17, 31, 32, 33, 63, 64, 65, 127, 128 };
+
+TEST(WarpFilter, calc_frame_error_avx2_match_c)
+{
+    std::mt19937 rnd(2);
+
+    for (const int w : kErrorSizes) {
+        for (const int h : kErrorSizes) {
+            const int stride = w + 5, p_stride = w + 3;
+            std::vector<uint8_t> ref(stride * h), dst(p_stride * h);
+            for (int iter = 0; iter < 4; ++iter) {
+                // Extreme differences first, then random ones
+                for (auto &p : ref)
+                    p = iter == 0 ? 255 : (uint8_t)rnd();
+                for (auto &p : dst)
+                    p = iter == 0 ? 0 : (uint8_t)rnd();
+                ASSERT_EQ(av1_calc_frame_error_c(ref.data(), stride, dst.data(), w, h, p_stride),
+                    av1_calc_frame_error_avx2(ref.data(), stride, dst.data(), w, h, p_stride))
+                    << "block " << w << "x" << h;
+            }
+        }
+    }
+}
+
+TEST(WarpFilter, calc_highbd_frame_error_avx2_match_c)
+{
+    std::mt19937 rnd(3);
+
+    for (const int bd : { 8, 10, 12 }) {
+        const uint16_t max = (uint16_t)((1 << bd) - 1);
+        for (const int w : kErrorSizes) {
+            for (const int h : kErrorSizes) {
+                const int stride = w + 5, p_stride = w + 3;
+                std::vector<uint16_t> ref(stride * h), dst(p_stride * h);
+                for (int iter = 0; iter < 4; ++iter) {
+                    for (auto &p : ref)
+                        p = iter == 0 ? max : (uint16_t)(rnd() & max);
+                    for (auto &p : dst)
+                        p = iter == 0 ? 0 : (uint16_t)(rnd() & max);
+                    ASSERT_EQ(av1_calc_highbd_frame_error_c(ref.data(), stride, dst.data(), w, h, p_stride, bd),
+                        av1_calc_highbd_frame_error_avx2(ref.data(), stride, dst.data(), w, h, p_stride, bd))
+                        << "bd " << bd << " block " << w << "x" << h;
+                }
+            }
+        }
+    }
+}